@@ -219,6 +219,7 @@ CHECK_INCLUDE_FILES (string.h HAVE_STRING_H)
 CHECK_INCLUDE_FILES (synch.h HAVE_SYNCH_H)
 CHECK_INCLUDE_FILES (sysent.h HAVE_SYSENT_H)
 CHECK_INCLUDE_FILES (sys/cdefs.h HAVE_SYS_CDEFS_H)
+CHECK_INCLUDE_FILES (sys/epoll.h HAVE_SYS_EPOLL_H)
 CHECK_INCLUDE_FILES (sys/file.h HAVE_SYS_FILE_H)
 CHECK_INCLUDE_FILES (sys/fpu.h HAVE_SYS_FPU_H)
 CHECK_INCLUDE_FILES (sys/ioctl.h HAVE_SYS_IOCTL_H)
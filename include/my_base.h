@@ -573,4 +573,16 @@ C_MODE_START
 typedef void (* invalidator_by_filename)(const char * filename);
 C_MODE_END
 
+/* Result of the check of a condition pushed to an index scan */
+enum icp_result {
+  ICP_NO_MATCH,                 /* Condition is false, skip the row */
+  ICP_MATCH,                    /* Condition is true, return the row */
+  ICP_OUT_OF_RANGE,             /* Row is beyond the end of the range */
+  ICP_ERROR                     /* Statement was killed or error */
+};
+
+C_MODE_START
+typedef enum icp_result (*index_cond_func_t)(void *param);
+C_MODE_END
+
 #endif /* _my_base_h */
@@ -861,6 +861,12 @@ struct st_my_thread_var
 };
 
 extern struct st_my_thread_var *_my_thread_var(void) __attribute__ ((const));
+/*
+  The key of the thread-specific st_my_thread_var. Exported for the
+  pool-of-threads scheduler, which moves a connection's st_my_thread_var
+  between worker threads.
+*/
+extern pthread_key(struct st_my_thread_var*, THR_KEY_mysys);
 extern void **my_thread_var_dbug();
 extern uint my_thread_end_wait_time;
 #define my_thread_var (_my_thread_var())
@@ -35,6 +35,43 @@
 #include "opt_range.h"                          // SQL_SELECT
 #include "debug_sync.h"
 #include "sql_base.h"
+#include "mysqld.h"                             // key_thread_filesort_worker
+
+/*
+  With sort_threads > 1, filesort sorts each full sort buffer in chunks,
+  one chunk per thread, and writes each chunk as a separate run. When
+  there are many runs, groups of them are merged to a single run each
+  by a thread of their own, and the runs of the groups are merged to the
+  result as they are read.
+*/
+
+/** Minimum number of keys that one thread of a parallel sort sorts */
+#define SORT_THREAD_MIN_KEYS 1000
+
+/** A chunk of the sort buffer, sorted by one thread */
+struct Sort_chunk
+{
+  uchar **keys;                         /* Pointers to the keys */
+  uint count;                           /* Number of keys */
+  size_t sort_length;                   /* Length of the sorted part */
+  uchar *key;                           /* Current key when merging */
+  pthread_t thread;
+};
+
+/** A group of runs, merged to a single run by one thread */
+struct Merge_group
+{
+  SORTPARAM param;                      /* With the keys of sort_buffer */
+  uchar *sort_buffer;                   /* Part of the sort buffer */
+  BUFFPEK *buffpek;                     /* First run of the group */
+  uint maxbuffer;                       /* Number of runs - 1 */
+  IO_CACHE *from_file;                  /* File with the runs */
+  IO_CACHE file[2];                     /* Files for the merge passes */
+  IO_CACHE *result;                     /* File with the merged run */
+  uchar *key;                           /* Current key when merging */
+  int error;
+  pthread_t thread;
+};
 
 /// How to write record_ref.
 #define WRITE_REF(file,from) \
@@ -49,8 +86,9 @@ static uchar **make_char_array(uchar **old_pos, uint fields,
 static uchar *read_buffpek_from_file(IO_CACHE *buffer_file, uint count,
                                      uchar *buf);
 static ha_rows find_all_keys(SORTPARAM *param,SQL_SELECT *select,
-			     uchar * *sort_keys, IO_CACHE *buffer_file,
-			     IO_CACHE *tempfile);
+			     uchar * *sort_keys, QUEUE *pq,
+			     IO_CACHE *buffer_file, IO_CACHE *tempfile);
+static int pq_key_cmp(void *sort_length, uchar *a, uchar *b);
 static int write_keys(SORTPARAM *param,uchar * *sort_keys,
 		      uint count, IO_CACHE *buffer_file, IO_CACHE *tempfile);
 static void make_sortkey(SORTPARAM *param,uchar *to, uchar *ref_pos);
@@ -68,6 +106,12 @@ static SORT_ADDON_FIELD *get_addon_fields(THD *thd, Field **ptabfield,
                                           uint sortlength, uint *plength);
 static void unpack_addon_fields(struct st_sort_addon_field *addon_field,
                                 uchar *buff);
+static uint sort_keys_in_chunks(SORTPARAM *param, uchar **sort_keys,
+                                uint count, Sort_chunk *chunks);
+static uint merge_group_count(SORTPARAM *param, uint n_runs);
+static int merge_parallel(SORTPARAM *param, uchar *sort_buffer,
+                          BUFFPEK *buffpek, uint maxbuffer, uint n_groups,
+                          IO_CACHE *tempfile, IO_CACHE *outfile);
 /**
   Sort a table.
   Creates a set of pointers that can be used to read the rows
@@ -108,12 +152,14 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
 {
   int error;
   ulong memory_available= thd->variables.sortbuff_size;
-  uint maxbuffer;
+  uint maxbuffer, n_groups;
   BUFFPEK *buffpek;
   ha_rows num_rows= HA_POS_ERROR;
   uchar **sort_keys= 0;
   IO_CACHE tempfile, buffpek_pointers, *outfile; 
   SORTPARAM param;
+  QUEUE pq;
+  bool use_pq= FALSE;
   bool multi_byte_charset;
   DBUG_ENTER("filesort");
   DBUG_EXECUTE("info",TEST_filesort(sortorder,s_length););
@@ -147,6 +193,7 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   my_b_clear(&buffpek_pointers);
   buffpek=0;
   error= 1;
+  bzero((char*) &pq, sizeof(pq));
   bzero((char*) &param,sizeof(param));
   param.sort_length= sortlength(thd, sortorder, s_length, &multi_byte_charset);
   param.ref_length= table->file->ref_length;
@@ -186,6 +233,8 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   }
   param.rec_length= param.sort_length+param.addon_length;
   param.max_rows= max_rows;
+  param.thd= thd;
+  param.sort_threads= (uint) thd->variables.sort_threads;
 
   if (select && select->quick)
     status_var_increment(thd->status_var.filesort_range_count);
@@ -199,6 +248,55 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
       !(param.tmp_buffer= (char*) my_malloc(param.sort_length,MYF(MY_WME))))
     goto err;
 
+  /*
+    With ORDER BY ... LIMIT, when the first max_rows keys fit in the sort
+    buffer, keep only those in a priority queue while reading the rows.
+    The result is then sorted in memory, without any merge passes.
+    One more key is allocated as scratch space for the key of the
+    current row.
+  */
+  if (max_rows > 0 && max_rows < num_rows &&
+      max_rows < (ha_rows) UINT_MAX32 - 1 &&
+      (ulonglong) (max_rows + 1) * (param.rec_length + sizeof(uchar*)) <=
+      (ulonglong) memory_available)
+  {
+    param.keys= (uint) max_rows + 1;
+    if (table_sort.sort_keys &&
+        table_sort.sort_keys_size != char_array_size(param.keys,
+                                                     param.rec_length))
+    {
+      my_free(table_sort.sort_keys);
+      table_sort.sort_keys= NULL;
+      table_sort.sort_keys_size= 0;
+    }
+    if ((table_sort.sort_keys=
+         make_char_array(table_sort.sort_keys,
+                         param.keys, param.rec_length, MYF(0))))
+    {
+      if (!init_queue(&pq, (uint) max_rows, 0, 1, pq_key_cmp,
+                      (void*) &param.sort_length))
+      {
+        table_sort.sort_keys_size=
+          char_array_size(param.keys, param.rec_length);
+        sort_keys= table_sort.sort_keys;
+        use_pq= TRUE;
+        status_var_increment(thd->status_var.filesort_pq_sorts);
+        DBUG_PRINT("info", ("using priority queue for %lu rows",
+                            (ulong) max_rows));
+      }
+      else
+      {
+        /* The merge sort path below allocates a buffer of its own size */
+        my_free(table_sort.sort_keys);
+        table_sort.sort_keys= NULL;
+        table_sort.sort_keys_size= 0;
+      }
+    }
+    else
+      table_sort.sort_keys_size= 0;
+  }
+
+  if (!use_pq)
   {
     const ulong min_sort_memory=
       max(MIN_SORT_MEMORY,
@@ -252,6 +350,7 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   num_rows= find_all_keys(&param,
                           select,
                           sort_keys,
+                          use_pq ? &pq : NULL,
                           &buffpek_pointers,
                           &tempfile);
   if (num_rows == HA_POS_ERROR)
@@ -291,19 +390,28 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
     */
     param.keys= table_sort.sort_keys_size / param.rec_length;
     maxbuffer--;				// Offset from 0
-    if (merge_many_buff(&param,(uchar*) sort_keys,buffpek,&maxbuffer,
-			&tempfile))
-      goto err;
-    if (flush_io_cache(&tempfile) ||
-	reinit_io_cache(&tempfile,READ_CACHE,0L,0,0))
-      goto err;
-    if (merge_index(&param,
-                    (uchar*) sort_keys,
-                    buffpek,
-                    maxbuffer,
-                    &tempfile,
-		    outfile))
-      goto err;
+    if ((n_groups= merge_group_count(&param, maxbuffer + 1)) > 1)
+    {
+      if (merge_parallel(&param, (uchar*) sort_keys, buffpek, maxbuffer,
+                         n_groups, &tempfile, outfile))
+        goto err;
+    }
+    else
+    {
+      if (merge_many_buff(&param,(uchar*) sort_keys,buffpek,&maxbuffer,
+                          &tempfile))
+        goto err;
+      if (flush_io_cache(&tempfile) ||
+          reinit_io_cache(&tempfile,READ_CACHE,0L,0,0))
+        goto err;
+      if (merge_index(&param,
+                      (uchar*) sort_keys,
+                      buffpek,
+                      maxbuffer,
+                      &tempfile,
+                      outfile))
+        goto err;
+    }
   }
 
   if (num_rows > param.max_rows)
@@ -314,6 +422,7 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
   error= 0;
 
  err:
+  delete_queue(&pq);
   my_free(param.tmp_buffer);
   if (!subselect || !subselect->is_uncacheable())
   {
@@ -410,6 +519,17 @@ void filesort_free_buffers(TABLE *table, bool full)
   DBUG_VOID_RETURN;
 }
 
+/**
+  Compare two sort keys in the priority queue used for ORDER BY ... LIMIT.
+  The keys are compared as binary strings, like in save_index().
+*/
+
+static int pq_key_cmp(void *sort_length, uchar *a, uchar *b)
+{
+  return memcmp(a, b, *(uint*) sort_length);
+}
+
+
 /** Make a array of string pointers. */
 
 static size_t char_array_size(uint fields, uint length)
@@ -525,6 +645,10 @@ static void dbug_print_record(TABLE *table, bool print_rowid)
   @param param             Sorting parameter
   @param select            Use this to get source data
   @param sort_keys         Array of pointers to sort key + addon buffers.
+  @param pq                If not NULL, a priority queue in which to keep
+                           only the param->max_rows smallest keys. Nothing
+                           is written to tempfile then, and sort_keys
+                           must have room for param->max_rows + 1 keys.
   @param buffpek_pointers  File to write BUFFPEKs describing sorted segments
                            in tempfile.
   @param tempfile          File to write sorted sequences of sortkeys to.
@@ -555,7 +679,7 @@ static void dbug_print_record(TABLE *table, bool print_rowid)
 */
 
 static ha_rows find_all_keys(SORTPARAM *param, SQL_SELECT *select,
-			     uchar **sort_keys,
+			     uchar **sort_keys, QUEUE *pq,
 			     IO_CACHE *buffpek_pointers,
 			     IO_CACHE *tempfile)
 {
@@ -660,15 +784,41 @@ static ha_rows find_all_keys(SORTPARAM *param, SQL_SELECT *select,
     if (!error && (!select ||
                    (!select->skip_record(thd, &skip_record) && !skip_record)))
     {
-      if (idx == param->keys)
+      if (pq)
       {
-	if (write_keys(param, sort_keys,
-                       idx, buffpek_pointers, tempfile))
-	  DBUG_RETURN(HA_POS_ERROR);
-	idx= 0;
-	indexpos++;
+        if (idx < param->max_rows)
+        {
+          make_sortkey(param, sort_keys[idx], ref_pos);
+          queue_insert(pq, sort_keys[idx++]);
+        }
+        else
+        {
+          /*
+            The queue is full: sort_keys[idx] is scratch space. Replace
+            the largest key in the queue if the new key is smaller.
+          */
+          uchar *key= sort_keys[idx];
+          make_sortkey(param, key, ref_pos);
+          if (memcmp(key, queue_top(pq), param->sort_length) < 0)
+          {
+            sort_keys[idx]= queue_top(pq);
+            queue_top(pq)= key;
+            queue_replaced(pq);
+          }
+        }
+      }
+      else
+      {
+        if (idx == param->keys)
+        {
+          if (write_keys(param, sort_keys,
+                         idx, buffpek_pointers, tempfile))
+            DBUG_RETURN(HA_POS_ERROR);
+          idx= 0;
+          indexpos++;
+        }
+        make_sortkey(param,sort_keys[idx++],ref_pos);
       }
-      make_sortkey(param,sort_keys[idx++],ref_pos);
     }
 
     /*
@@ -700,6 +850,13 @@ static ha_rows find_all_keys(SORTPARAM *param, SQL_SELECT *select,
     file->print_error(error,MYF(ME_ERROR | ME_WAITTANG)); // purecov: inspected
     DBUG_RETURN(HA_POS_ERROR);			/* purecov: inspected */
   }
+  if (pq)
+  {
+    /* Leave the keys in the queue to be sorted by the caller */
+    for (uint i= 0; i < pq->elements; i++)
+      sort_keys[i]= queue_element(pq, i);
+    DBUG_ASSERT(pq->elements == idx);
+  }
   if (indexpos && idx &&
       write_keys(param, sort_keys,
                  idx, buffpek_pointers, tempfile))
@@ -737,34 +894,37 @@ static int
 write_keys(SORTPARAM *param, register uchar **sort_keys, uint count,
            IO_CACHE *buffpek_pointers, IO_CACHE *tempfile)
 {
-  size_t sort_length, rec_length;
+  size_t rec_length;
   uchar **end;
   BUFFPEK buffpek;
+  Sort_chunk chunks[MAX_SORT_THREADS];
+  uint n_chunks;
   DBUG_ENTER("write_keys");
 
-  sort_length= param->sort_length;
   rec_length= param->rec_length;
-#ifdef MC68000
-  quicksort(sort_keys,count,sort_length);
-#else
-  my_string_ptr_sort((uchar*) sort_keys, (uint) count, sort_length);
-#endif
+  n_chunks= sort_keys_in_chunks(param, sort_keys, count, chunks);
   if (!my_b_inited(tempfile) &&
       open_cached_file(tempfile, mysql_tmpdir, TEMP_PREFIX, DISK_BUFFER_SIZE,
                        MYF(MY_WME)))
     goto err;                                   /* purecov: inspected */
-  /* check we won't have more buffpeks than we can possibly keep in memory */
-  if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong)UINT_MAX)
-    goto err;
-  buffpek.file_pos= my_b_tell(tempfile);
-  if ((ha_rows) count > param->max_rows)
-    count=(uint) param->max_rows;               /* purecov: inspected */
-  buffpek.count=(ha_rows) count;
-  for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
-    if (my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
+  /* Each sorted chunk is a run of its own */
+  for (uint i= 0; i < n_chunks; i++)
+  {
+    sort_keys= chunks[i].keys;
+    count= chunks[i].count;
+    /* check we won't have more buffpeks than we can possibly keep in memory */
+    if (my_b_tell(buffpek_pointers) + sizeof(BUFFPEK) > (ulonglong)UINT_MAX)
       goto err;
-  if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
-    goto err;
+    buffpek.file_pos= my_b_tell(tempfile);
+    if ((ha_rows) count > param->max_rows)
+      count=(uint) param->max_rows;             /* purecov: inspected */
+    buffpek.count=(ha_rows) count;
+    for (end=sort_keys+count ; sort_keys != end ; sort_keys++)
+      if (my_b_write(tempfile, (uchar*) *sort_keys, (uint) rec_length))
+        goto err;
+    if (my_b_write(buffpek_pointers, (uchar*) &buffpek, sizeof(buffpek)))
+      goto err;
+  }
   DBUG_RETURN(0);
 
 err:
@@ -1081,9 +1241,12 @@ static bool save_index(SORTPARAM *param, uchar **sort_keys, uint count,
 {
   uint offset,res_length;
   uchar *to;
+  Sort_chunk chunks[MAX_SORT_THREADS];
+  uint n_chunks;
+  QUEUE queue;
   DBUG_ENTER("save_index");
 
-  my_string_ptr_sort((uchar*) sort_keys, (uint) count, param->sort_length);
+  n_chunks= sort_keys_in_chunks(param, sort_keys, count, chunks);
   res_length= param->res_length;
   offset= param->rec_length-res_length;
   if ((ha_rows) count > param->max_rows)
@@ -1091,15 +1254,113 @@ static bool save_index(SORTPARAM *param, uchar **sort_keys, uint count,
   if (!(to= table_sort->record_pointers= 
         (uchar*) my_malloc(res_length*count, MYF(MY_WME))))
     DBUG_RETURN(1);                 /* purecov: inspected */
-  for (uchar **end= sort_keys+count ; sort_keys != end ; sort_keys++)
+  if (n_chunks == 1)
   {
-    memcpy(to, *sort_keys+offset, res_length);
-    to+= res_length;
+    for (uchar **end= sort_keys+count ; sort_keys != end ; sort_keys++)
+    {
+      memcpy(to, *sort_keys+offset, res_length);
+      to+= res_length;
+    }
+    DBUG_RETURN(0);
   }
+
+  /* Merge the sorted chunks */
+  if (init_queue(&queue, n_chunks, offsetof(Sort_chunk, key), 0,
+                 (queue_compare) get_ptr_compare(param->sort_length),
+                 (void*) &chunks[0].sort_length))
+    DBUG_RETURN(1);                 /* purecov: inspected */
+  for (uint i= 0; i < n_chunks; i++)
+  {
+    chunks[i].key= *chunks[i].keys;
+    queue_insert(&queue, (uchar*) &chunks[i]);
+  }
+  for (uchar *end= to + res_length * count; to != end; to+= res_length)
+  {
+    Sort_chunk *chunk= (Sort_chunk*) queue_top(&queue);
+    memcpy(to, chunk->key + offset, res_length);
+    if (--chunk->count)
+    {
+      chunk->key= *++chunk->keys;
+      queue_replaced(&queue);
+    }
+    else
+      queue_remove(&queue, 0);
+  }
+  delete_queue(&queue);
   DBUG_RETURN(0);
 }
 
 
+/**
+  Sort the keys of one chunk of the sort buffer, in a thread of a
+  parallel sort.
+*/
+
+pthread_handler_t sort_chunk_thread(void *arg)
+{
+  Sort_chunk *chunk= (Sort_chunk*) arg;
+
+  my_thread_init();
+  my_string_ptr_sort((uchar*) chunk->keys, chunk->count, chunk->sort_length);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Sort the keys in the sort buffer. With param->sort_threads > 1, the
+  keys are split into chunks of at least SORT_THREAD_MIN_KEYS keys, and
+  each chunk is sorted by a thread of its own. my_string_ptr_sort() uses
+  a radix sort for short keys, which suits the smaller chunks best.
+
+  @param param             Sort parameters
+  @param sort_keys         Array of pointers to keys to sort
+  @param count             Number of elements in sort_keys array
+  @param[out] chunks       The sorted chunks
+
+  @return Number of chunks, each sorted separately
+*/
+
+static uint sort_keys_in_chunks(SORTPARAM *param, uchar **sort_keys,
+                                uint count, Sort_chunk *chunks)
+{
+  uint n_chunks= 1;
+  uint i;
+  DBUG_ENTER("sort_keys_in_chunks");
+
+  if (param->sort_threads > 1)
+    n_chunks= max(1, min(param->sort_threads, count / SORT_THREAD_MIN_KEYS));
+
+  for (i= 0; i < n_chunks; i++)
+  {
+    chunks[i].keys= sort_keys + (ulonglong) count * i / n_chunks;
+    chunks[i].count= (uint) ((ulonglong) count * (i + 1) / n_chunks -
+                             (ulonglong) count * i / n_chunks);
+    chunks[i].sort_length= param->sort_length;
+  }
+
+  /* Sort the first chunk in this thread, and the others in new threads */
+  for (i= 1; i < n_chunks; i++)
+  {
+    if (mysql_thread_create(key_thread_filesort_worker, &chunks[i].thread,
+                            NULL, sort_chunk_thread, (void*) &chunks[i]))
+      break;
+  }
+  my_string_ptr_sort((uchar*) chunks[0].keys, chunks[0].count,
+                     chunks[0].sort_length);
+  for (uint j= 1; j < n_chunks; j++)
+  {
+    if (j < i)
+      pthread_join(chunks[j].thread, NULL);
+    else                                      /* The thread was not created */
+      my_string_ptr_sort((uchar*) chunks[j].keys, chunks[j].count,
+                         chunks[j].sort_length);
+  }
+  DBUG_PRINT("info", ("sorted %u keys in %u chunks", count, n_chunks));
+  DBUG_RETURN(n_chunks);
+}
+
+
 /** Merge buffers to make < MERGEBUFF2 buffers. */
 
 int merge_many_buff(SORTPARAM *param, uchar *sort_buffer,
@@ -1248,11 +1509,13 @@ int merge_buffers(SORTPARAM *param, IO_CACHE *from_file,
   QUEUE queue;
   qsort2_cmp cmp;
   void *first_cmp_arg;
-  volatile THD::killed_state *killed= &current_thd->killed;
+  volatile THD::killed_state *killed= &param->thd->killed;
   THD::killed_state not_killable;
   DBUG_ENTER("merge_buffers");
 
-  status_var_increment(current_thd->status_var.filesort_merge_passes);
+  /* This may run in several threads of a parallel filesort */
+  statistic_increment(param->thd->status_var.filesort_merge_passes,
+                      &LOCK_status);
   if (param->not_killable)
   {
     killed= &not_killable;
@@ -1452,6 +1715,262 @@ static int merge_index(SORTPARAM *param, uchar *sort_buffer,
 } /* merge_index */
 
 
+/**
+  Get the number of groups of runs to merge in parallel.
+
+  The runs are merged in parallel only with param->sort_threads > 1
+  and when they would need several merge passes. Each group has at
+  least MERGEBUFF runs, and the sort buffer is split so that each group
+  can merge up to MERGEBUFF2 runs at a time.
+
+  @param param    Sort parameters
+  @param n_runs   Number of runs in the temporary file
+
+  @return Number of groups, 1 to merge sequentially
+*/
+
+static uint merge_group_count(SORTPARAM *param, uint n_runs)
+{
+  uint n_groups;
+
+  if (param->sort_threads <= 1 || n_runs <= MERGEBUFF2)
+    return 1;
+  n_groups= min(param->sort_threads, n_runs / MERGEBUFF);
+  n_groups= min(n_groups, param->keys / MERGEBUFF2);
+  return max(n_groups, 1);
+}
+
+
+/**
+  Merge the runs of one group to a single run in a file of the group.
+  The merge passes alternate between the two files of the group, as in
+  merge_many_buff().
+
+  @param group    The group to merge; group->error and group->result
+                  are set
+*/
+
+static void merge_group(Merge_group *group)
+{
+  SORTPARAM *param= &group->param;
+  BUFFPEK *buffpek= group->buffpek;
+  BUFFPEK *lastbuff;
+  IO_CACHE *from_file= group->from_file;
+  IO_CACHE *to_file= &group->file[0];
+  uint maxbuffer= group->maxbuffer;
+  uint i;
+  DBUG_ENTER("merge_group");
+
+  group->error= 1;
+  if (open_cached_file(&group->file[0], mysql_tmpdir, TEMP_PREFIX,
+                       DISK_BUFFER_SIZE, MYF(MY_WME)) ||
+      open_cached_file(&group->file[1], mysql_tmpdir, TEMP_PREFIX,
+                       DISK_BUFFER_SIZE, MYF(MY_WME)))
+    DBUG_VOID_RETURN;                           /* purecov: inspected */
+
+  while (maxbuffer >= MERGEBUFF2)
+  {
+    if (reinit_io_cache(to_file, WRITE_CACHE, 0L, 0, 0))
+      DBUG_VOID_RETURN;
+    lastbuff= buffpek;
+    for (i= 0 ; i <= maxbuffer - MERGEBUFF*3/2 ; i+= MERGEBUFF)
+    {
+      if (merge_buffers(param, from_file, to_file, group->sort_buffer,
+                        lastbuff++, buffpek + i, buffpek + i + MERGEBUFF - 1,
+                        0))
+        DBUG_VOID_RETURN;
+    }
+    if (merge_buffers(param, from_file, to_file, group->sort_buffer,
+                      lastbuff++, buffpek + i, buffpek + maxbuffer, 0) ||
+        flush_io_cache(to_file))
+      DBUG_VOID_RETURN;                         /* purecov: inspected */
+    from_file= to_file;
+    to_file= to_file == &group->file[0] ? &group->file[1] : &group->file[0];
+    maxbuffer= (uint) (lastbuff - buffpek) - 1;
+  }
+
+  /* Merge the remaining runs to one run, kept in buffpek */
+  if (reinit_io_cache(to_file, WRITE_CACHE, 0L, 0, 0) ||
+      merge_buffers(param, from_file, to_file, group->sort_buffer,
+                    buffpek, buffpek, buffpek + maxbuffer, 0) ||
+      flush_io_cache(to_file))
+    DBUG_VOID_RETURN;
+  group->result= to_file;
+  group->error= 0;
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Merge the runs of one group, in a thread of a parallel sort.
+*/
+
+pthread_handler_t merge_group_thread(void *arg)
+{
+  my_thread_init();
+  merge_group((Merge_group*) arg);
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Merge the runs that the groups of a parallel merge produced, and
+  write the result to outfile. The runs are read one key at a time
+  through the IO_CACHE of each group, so that only the current key of
+  each group is kept in sort_buffer.
+*/
+
+static int merge_group_results(SORTPARAM *param, uchar *sort_buffer,
+                               Merge_group *groups, uint n_groups,
+                               IO_CACHE *outfile)
+{
+  uint rec_length= param->rec_length;
+  uint res_length= param->res_length;
+  uint offset= rec_length - res_length;
+  size_t sort_length= param->sort_length;
+  ha_rows max_rows= param->max_rows;
+  volatile THD::killed_state *killed= &param->thd->killed;
+  QUEUE queue;
+  int error= 1;
+  DBUG_ENTER("merge_group_results");
+
+  statistic_increment(param->thd->status_var.filesort_merge_passes,
+                      &LOCK_status);
+  if (init_queue(&queue, n_groups, offsetof(Merge_group, key), 0,
+                 (queue_compare) get_ptr_compare(sort_length),
+                 (void*) &sort_length))
+    DBUG_RETURN(1);                             /* purecov: inspected */
+  for (uint i= 0; i < n_groups; i++)
+  {
+    Merge_group *group= &groups[i];
+    group->key= sort_buffer + (size_t) i * rec_length;
+    if (!group->buffpek->count)
+      continue;
+    if (reinit_io_cache(group->result, READ_CACHE, group->buffpek->file_pos,
+                        0, 0) ||
+        my_b_read(group->result, group->key, rec_length))
+      goto err;                                 /* purecov: inspected */
+    queue_insert(&queue, (uchar*) group);
+  }
+
+  while (queue.elements && max_rows)
+  {
+    Merge_group *group= (Merge_group*) queue_top(&queue);
+    if (*killed)
+      goto err;                                 /* purecov: inspected */
+    if (my_b_write(outfile, group->key + offset, res_length))
+      goto err;                                 /* purecov: inspected */
+    max_rows--;
+    if (--group->buffpek->count)
+    {
+      if (my_b_read(group->result, group->key, rec_length))
+        goto err;                               /* purecov: inspected */
+      queue_replaced(&queue);
+    }
+    else
+      queue_remove(&queue, 0);
+  }
+  error= 0;
+
+err:
+  delete_queue(&queue);
+  DBUG_RETURN(error);
+}
+
+
+/**
+  Merge the runs in tempfile with several threads, and write the result
+  to outfile.
+
+  The runs are split in n_groups groups of consecutive runs, each with
+  its own part of the sort buffer and its own temporary files. Each
+  group is merged to a single run by a thread of its own, the first one
+  by the current thread. The runs of the groups are then merged to
+  outfile.
+
+  @param param        Sort parameters
+  @param sort_buffer  The sort buffer, with room for param->keys keys
+  @param buffpek      The runs in tempfile
+  @param maxbuffer    Number of runs - 1
+  @param n_groups     Number of groups, from merge_group_count()
+  @param tempfile     File with the runs
+  @param outfile      File to write the result to
+
+  @retval
+    0    OK
+  @retval
+    1    ERROR
+*/
+
+static int merge_parallel(SORTPARAM *param, uchar *sort_buffer,
+                          BUFFPEK *buffpek, uint maxbuffer, uint n_groups,
+                          IO_CACHE *tempfile, IO_CACHE *outfile)
+{
+  Merge_group groups[MAX_SORT_THREADS];
+  uint n_runs= maxbuffer + 1;
+  uint keys= param->keys / n_groups;
+  uint i, n_started;
+  int error= 0;
+  THD *thd= param->thd;
+  DBUG_ENTER("merge_parallel");
+  DBUG_PRINT("info", ("merging %u runs in %u groups", n_runs, n_groups));
+
+  /* The groups read tempfile with pread(), so it must be on disk */
+  if (flush_io_cache(tempfile))
+    DBUG_RETURN(1);                             /* purecov: inspected */
+
+  for (i= 0; i < n_groups; i++)
+  {
+    Merge_group *group= &groups[i];
+    uint first= (uint) ((ulonglong) n_runs * i / n_groups);
+    uint last= (uint) ((ulonglong) n_runs * (i + 1) / n_groups) - 1;
+
+    group->param= *param;
+    group->param.keys= keys;
+    group->sort_buffer= sort_buffer + (size_t) keys * i * param->rec_length;
+    group->buffpek= buffpek + first;
+    group->maxbuffer= last - first;
+    group->from_file= tempfile;
+    my_b_clear(&group->file[0]);
+    my_b_clear(&group->file[1]);
+    group->result= 0;
+    group->error= 0;
+  }
+
+  for (n_started= 1; n_started < n_groups; n_started++)
+  {
+    if (mysql_thread_create(key_thread_filesort_worker,
+                            &groups[n_started].thread, NULL,
+                            merge_group_thread, (void*) &groups[n_started]))
+      break;
+  }
+  merge_group(&groups[0]);
+  for (i= 1; i < n_groups; i++)
+  {
+    if (i < n_started)
+      pthread_join(groups[i].thread, NULL);
+    else                                      /* The thread was not created */
+      merge_group(&groups[i]);
+  }
+  for (i= 0; i < n_groups; i++)
+    error|= groups[i].error;
+
+  if (!error)
+    error= merge_group_results(param, sort_buffer, groups, n_groups, outfile);
+
+  for (i= 0; i < n_groups; i++)
+  {
+    close_cached_file(&groups[i].file[0]);
+    close_cached_file(&groups[i].file[1]);
+  }
+  /* Errors in the other threads were not reported to the client */
+  if (error && !thd->is_error() && !thd->killed)
+    my_error(ER_FILSORT_ABORT, MYF(0));
+  DBUG_RETURN(error);
+}
+
+
 static uint suffix_length(ulong string_length)
 {
   if (string_length < 256)
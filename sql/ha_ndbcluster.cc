@@ -8983,9 +8983,10 @@ int
 ha_ndbcluster::read_multi_range_first(KEY_MULTI_RANGE **found_range_p,
                                       KEY_MULTI_RANGE *ranges, 
                                       uint range_count,
-                                      bool sorted, 
+                                      uint mode, 
                                       HANDLER_BUFFER *buffer)
 {
+  bool sorted= test(mode & HA_MRR_SORTED);
   m_write_op= FALSE;
   int res;
   KEY* key_info= table->key_info + active_index;
@@ -9008,7 +9009,7 @@ ha_ndbcluster::read_multi_range_first(KEY_MULTI_RANGE **found_range_p,
     DBUG_RETURN(handler::read_multi_range_first(found_range_p, 
                                                 ranges, 
                                                 range_count,
-                                                sorted, 
+                                                mode, 
                                                 buffer));
   }
   MYSQL_INDEX_READ_ROW_START(table_share->db.str, table_share->table_name.str);
@@ -9360,7 +9361,7 @@ close_scan:
   DBUG_RETURN(read_multi_range_first(multi_range_found_p, 
                                      multi_range_curr,
                                      multi_range_end - multi_range_curr, 
-                                     multi_range_sorted,
+                                     multi_range_sorted ? HA_MRR_SORTED : 0,
                                      multi_range_buffer));
   
 found:
@@ -507,7 +507,7 @@ public:
     We don't implement multi read range yet, will do later.
     virtual int read_multi_range_first(KEY_MULTI_RANGE **found_range_p,
     KEY_MULTI_RANGE *ranges, uint range_count,
-    bool sorted, HANDLER_BUFFER *buffer);
+    uint mode, HANDLER_BUFFER *buffer);
     virtual int read_multi_range_next(KEY_MULTI_RANGE **found_range_p);
   */
 
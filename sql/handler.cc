@@ -1417,6 +1417,37 @@ int ha_commit_one_phase(THD *thd, bool all)
 }
 
 
+/**
+  Let the engines of a transaction make its commit visible, in binary
+  log order.
+
+  Called by the binary log group commit for a transaction that is
+  written to the binary log but not yet committed in the engines. The
+  caller serializes the calls, and may call this for a THD that belongs
+  to another thread. ha_commit_one_phase() is still called afterwards
+  by the owning thread.
+
+  Only a 'real' transaction reaches the binary log with an Xid, so the
+  committed transaction is the 'all' one if it has any engine, else the
+  autocommit statement transaction.
+*/
+
+void ha_commit_ordered(THD *thd)
+{
+  bool all= thd->transaction.all.ha_list != NULL;
+  THD_TRANS *trans= all ? &thd->transaction.all : &thd->transaction.stmt;
+  DBUG_ENTER("ha_commit_ordered");
+
+  for (Ha_trx_info *ha_info= trans->ha_list; ha_info; ha_info= ha_info->next())
+  {
+    handlerton *ht= ha_info->ht();
+    if (ht->commit_ordered && ha_info->is_trx_read_write())
+      ht->commit_ordered(ht, thd, all);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 int ha_rollback_trans(THD *thd, bool all)
 {
   int error=0;
@@ -4524,7 +4555,9 @@ void ha_binlog_log_query(THD *thd, handlerton *hton,
                              corresponds to the returned row.
   @param ranges              An array of KEY_MULTI_RANGE range descriptions.
   @param range_count         Number of ranges in 'ranges'.
-  @param sorted	      If result should be sorted per key.
+  @param mode                HA_MRR_SORTED if result should be sorted per key,
+                             HA_MRR_ROWID_ORDER if rows may be read in the
+                             order of their references.
   @param buffer              A HANDLER_BUFFER for internal handler usage.
 
   @note
@@ -4533,6 +4566,11 @@ void ha_binlog_log_query(THD *thd, handlerton *hton,
     returns 0.
     - Sorting is done within each range. If you want an overall sort, enter
     'ranges' with sorted ranges.
+    - With HA_MRR_ROWID_ORDER the references of the rows in the ranges are
+    collected into 'buffer' by an index only scan, sorted, and the rows are
+    then read with rnd_pos(). This is not done if the index covers the
+    columns that are read, if the index is the clustered primary key or
+    if random reads are cheap for the engine.
 
   @retval
     0			OK, found a row
@@ -4543,16 +4581,32 @@ void ha_binlog_log_query(THD *thd, handlerton *hton,
 */
 int handler::read_multi_range_first(KEY_MULTI_RANGE **found_range_p,
                                     KEY_MULTI_RANGE *ranges, uint range_count,
-                                    bool sorted, HANDLER_BUFFER *buffer)
+                                    uint mode, HANDLER_BUFFER *buffer)
 {
   int result= HA_ERR_END_OF_FILE;
   DBUG_ENTER("handler::read_multi_range_first");
-  multi_range_sorted= sorted;
+  multi_range_sorted= test(mode & HA_MRR_SORTED);
   multi_range_buffer= buffer;
+  multi_range_rowid_order=
+    (mode & (HA_MRR_ROWID_ORDER | HA_MRR_SORTED)) == HA_MRR_ROWID_ORDER &&
+    !table->key_read &&
+    !(ha_table_flags() & HA_FAST_KEY_READ) &&
+    !(primary_key_is_clustered() && active_index == table_share->primary_key) &&
+    (size_t) (buffer->buffer_end - buffer->buffer) >=
+      ref_length + sizeof(KEY_MULTI_RANGE*);
 
   table->mark_columns_used_by_index_no_reset(active_index, table->read_set);
   table->column_bitmaps_set(table->read_set, table->write_set);
 
+  if (multi_range_rowid_order)
+  {
+    multi_range_curr= ranges;
+    multi_range_end= ranges + range_count;
+    multi_range_rowid_pos= multi_range_rowid_end= NULL;
+    multi_range_scanned= 0;
+    DBUG_RETURN(read_multi_range_next(found_range_p));
+  }
+
   for (multi_range_curr= ranges, multi_range_end= ranges + range_count;
        multi_range_curr < multi_range_end;
        multi_range_curr++)
@@ -4596,6 +4650,33 @@ int handler::read_multi_range_next(KEY_MULTI_RANGE **found_range_p)
   int UNINIT_VAR(result);
   DBUG_ENTER("handler::read_multi_range_next");
 
+  if (multi_range_rowid_order)
+  {
+    for (;;)
+    {
+      if (multi_range_rowid_pos < multi_range_rowid_end)
+      {
+        uchar *rowid= multi_range_rowid_pos;
+        multi_range_rowid_pos+= ref_length + sizeof(KEY_MULTI_RANGE*);
+        memcpy(found_range_p, rowid + ref_length, sizeof(KEY_MULTI_RANGE*));
+        result= rnd_pos(table->record[0], rowid);
+        /* The row may be gone if it was not locked by the index scan */
+        if (result != HA_ERR_RECORD_DELETED && result != HA_ERR_KEY_NOT_FOUND)
+          break;
+        continue;
+      }
+      if (multi_range_curr >= multi_range_end)
+      {
+        result= HA_ERR_END_OF_FILE;
+        break;
+      }
+      if ((result= read_multi_range_rowids()))
+        break;
+    }
+    DBUG_PRINT("exit",("handler::read_multi_range_next: result %d", result));
+    DBUG_RETURN(result);
+  }
+
   /* We should not be called after the last call returned EOF. */
   DBUG_ASSERT(multi_range_curr < multi_range_end);
 
@@ -4645,6 +4726,90 @@ scan_it_again:
 }
 
 
+static int cmp_multi_range_rowid(void *file, uchar *a, uchar *b)
+{
+  return ((handler*) file)->cmp_ref(a, b);
+}
+
+
+/**
+  Fill the buffer of read_multi_range_first() with the sorted references
+  of the rows in the next ranges.
+
+  The ranges are scanned with an index only read. When the buffer gets
+  full in the middle of a range, the range is scanned again the next
+  time from its beginning, skipping the rows whose references were
+  already collected.
+
+  @retval 0  OK, multi_range_rowid_pos is the first reference
+  @retval #  Error code
+*/
+
+int handler::read_multi_range_rowids()
+{
+  uint entry_size= ref_length + sizeof(KEY_MULTI_RANGE*);
+  uchar *pos= (uchar*) multi_range_buffer->buffer;
+  uchar *end= (uchar*) multi_range_buffer->buffer_end - entry_size;
+  uint keyno= active_index;
+  int result= 0;
+  DBUG_ENTER("handler::read_multi_range_rowids");
+
+  /* Read just the index, and the primary key for position() */
+  table->prepare_for_position();
+  extra(HA_EXTRA_KEYREAD);
+  if ((result= ha_index_end()) || (result= ha_index_init(keyno, FALSE)))
+    goto err;
+
+  for (; multi_range_curr < multi_range_end;
+       multi_range_curr++, multi_range_scanned= 0)
+  {
+    ha_rows rows= 0;
+    for (result= read_range_first(multi_range_curr->start_key.keypart_map ?
+                                  &multi_range_curr->start_key : 0,
+                                  multi_range_curr->end_key.keypart_map ?
+                                  &multi_range_curr->end_key : 0,
+                                  test(multi_range_curr->range_flag &
+                                       EQ_RANGE),
+                                  FALSE);
+         !result;
+         result= read_range_next())
+    {
+      if (rows++ < multi_range_scanned)
+        continue;
+      if (pos > end)
+      {
+        multi_range_scanned= rows - 1;
+        break;
+      }
+      position(table->record[0]);
+      memcpy(pos, ref, ref_length);
+      memcpy(pos + ref_length, &multi_range_curr, sizeof(KEY_MULTI_RANGE*));
+      pos+= entry_size;
+      if (multi_range_curr->range_flag == (UNIQUE_RANGE | EQ_RANGE))
+      {
+        result= HA_ERR_END_OF_FILE;
+        break;
+      }
+    }
+    if (!result)
+      break;                                    // The buffer is full
+    if (result != HA_ERR_END_OF_FILE)
+      goto err;
+  }
+  result= 0;
+
+  multi_range_rowid_pos= (uchar*) multi_range_buffer->buffer;
+  multi_range_rowid_end= pos;
+  my_qsort2(multi_range_rowid_pos,
+            (multi_range_rowid_end - multi_range_rowid_pos) / entry_size,
+            entry_size, (qsort2_cmp) cmp_multi_range_rowid, (void*) this);
+
+err:
+  extra(HA_EXTRA_NO_KEYREAD);
+  DBUG_RETURN(result);
+}
+
+
 /**
   Read first row between two ranges.
   Store ranges for future calls to read_range_next.
@@ -4782,6 +4947,32 @@ int handler::compare_key(key_range *range)
 }
 
 
+/**
+  Check the condition pushed to the index scan of a handler.
+
+  Called by the storage engine for an index entry after it has stored
+  the columns of the index in table->record[0], and before it reads the
+  rest of the row.
+
+  @param h_arg  The handler, see handler::idx_cond_push()
+
+  @retval ICP_NO_MATCH      The condition is false, skip the entry
+  @retval ICP_MATCH         The condition is true, return the row
+  @retval ICP_OUT_OF_RANGE  The entry is beyond the end of the range
+                            scan, or the statement was killed
+*/
+enum icp_result handler_index_cond_check(void* h_arg)
+{
+  handler *h= (handler*) h_arg;
+  THD *thd= h->ha_thd();
+  if (thd->killed)
+    return ICP_OUT_OF_RANGE;
+  if (h->end_range && h->compare_key(h->end_range) > 0)
+    return ICP_OUT_OF_RANGE;
+  return h->pushed_idx_cond->val_int() ? ICP_MATCH : ICP_NO_MATCH;
+}
+
+
 int handler::index_read_idx_map(uchar * buf, uint index, const uchar * key,
                                 key_part_map keypart_map,
                                 enum ha_rkey_function find_flag)
@@ -5182,6 +5373,7 @@ int handler::ha_reset()
   /* reset the bitmaps to point to defaults */
   table->default_column_bitmaps();
   pushed_cond= NULL;
+  cancel_pushed_idx_cond();
   DBUG_RETURN(reset());
 }
 
@@ -241,6 +241,12 @@
 */
 #define HA_KEY_SCAN_NOT_ROR     128 
 
+/*
+  The engine can evaluate a condition on the columns of the index while
+  it scans the index, see handler::idx_cond_push().
+*/
+#define HA_DO_INDEX_COND_PUSHDOWN 256
+
 /* operations for disable/enable indexes */
 #define HA_KEY_SWITCH_NONUNIQ      0
 #define HA_KEY_SWITCH_ALL          1
@@ -764,6 +770,15 @@ struct handlerton
    int  (*commit)(handlerton *hton, THD *thd, bool all);
    int  (*rollback)(handlerton *hton, THD *thd, bool all);
    int  (*prepare)(handlerton *hton, THD *thd, bool all);
+   /*
+     Optional. Called by the binary log group commit, after the
+     transaction has been written to the binary log and before commit(),
+     in the same order as the transactions appear in the binary log.
+     The calls are serialized and may be made by a thread other than
+     the one owning 'thd', so the engine must only make the commit
+     visible here and leave the slow part (log flush) to commit().
+   */
+   void (*commit_ordered)(handlerton *hton, THD *thd, bool all);
    int  (*recover)(handlerton *hton, XID *xid_list, uint len);
    int  (*commit_by_xid)(handlerton *hton, XID *xid);
    int  (*rollback_by_xid)(handlerton *hton, XID *xid);
@@ -1167,6 +1182,19 @@ typedef struct st_handler_buffer
   uchar *end_of_used_area;     /* End of area that was used by handler */
 } HANDLER_BUFFER;
 
+/*
+  Flags for the mode argument of read_multi_range_first()
+*/
+/* Return the rows of each range in index order */
+#define HA_MRR_SORTED           1
+/*
+  The rows may be returned in any order. The handler may first collect
+  the row references of the ranges from the index, sort them and then
+  read the rows in the order of the references, which turns random
+  reads into nearly sequential ones.
+*/
+#define HA_MRR_ROWID_ORDER      2
+
 typedef struct system_status_var SSV;
 
 class ha_statistics
@@ -1237,6 +1265,8 @@ public:
   virtual ~handler_add_index() {}
 };
 
+extern "C" enum icp_result handler_index_cond_check(void* h_arg);
+
 /**
   The handler class is the interface for dynamically loadable
   storage engines. Do not add ifdefs and take care when adding or
@@ -1245,6 +1275,7 @@ public:
 
 class handler :public Sql_alloc
 {
+  friend enum icp_result handler_index_cond_check(void* h_arg);
 public:
   typedef ulonglong Table_flags;
 protected:
@@ -1265,6 +1296,12 @@ public:
   KEY_MULTI_RANGE *multi_range_curr;
   KEY_MULTI_RANGE *multi_range_end;
   HANDLER_BUFFER *multi_range_buffer;
+  /** Row references are read in sorted order, see HA_MRR_ROWID_ORDER */
+  bool multi_range_rowid_order;
+  /** Sorted row references collected from the index but not read yet */
+  uchar *multi_range_rowid_pos, *multi_range_rowid_end;
+  /** Rows of multi_range_curr whose references were already collected */
+  ha_rows multi_range_scanned;
 
   /** The following are for read_range() */
   key_range save_end_range, *end_range;
@@ -1282,6 +1319,10 @@ public:
   bool locked;
   bool implicit_emptied;                /* Can be !=0 only if HEAP */
   const COND *pushed_cond;
+  /** Condition pushed to the index scan, see idx_cond_push() */
+  Item *pushed_idx_cond;
+  /** Index that pushed_idx_cond is pushed to, or MAX_KEY */
+  uint pushed_idx_cond_keyno;
   /**
     next_insert_id is the next value which should be inserted into the
     auto_increment column: in a inserting-multi-row statement (like INSERT
@@ -1329,11 +1370,13 @@ public:
   handler(handlerton *ht_arg, TABLE_SHARE *share_arg)
     :table_share(share_arg), table(0),
     estimation_rows_to_insert(0), ht(ht_arg),
-    ref(0), key_used_on_scan(MAX_KEY), active_index(MAX_KEY),
+    ref(0), multi_range_rowid_order(FALSE),
+    key_used_on_scan(MAX_KEY), active_index(MAX_KEY),
     ref_length(sizeof(my_off_t)),
     ft_handler(0), inited(NONE),
     locked(FALSE), implicit_emptied(0),
-    pushed_cond(0), next_insert_id(0), insert_id_for_cur_row(0),
+    pushed_cond(0), pushed_idx_cond(NULL), pushed_idx_cond_keyno(MAX_KEY),
+    next_insert_id(0), insert_id_for_cur_row(0),
     auto_inc_intervals_count(0),
     m_psi(NULL)
     {}
@@ -1357,6 +1400,7 @@ public:
     int result;
     DBUG_ENTER("ha_index_init");
     DBUG_ASSERT(inited==NONE);
+    end_range= NULL;
     if (!(result= index_init(idx, sorted)))
       inited=INDEX;
     DBUG_RETURN(result);
@@ -1614,7 +1658,7 @@ public:
   }
   virtual int read_multi_range_first(KEY_MULTI_RANGE **found_range_p,
                                      KEY_MULTI_RANGE *ranges, uint range_count,
-                                     bool sorted, HANDLER_BUFFER *buffer);
+                                     uint mode, HANDLER_BUFFER *buffer);
   virtual int read_multi_range_next(KEY_MULTI_RANGE **found_range_p);
   virtual int read_range_first(const key_range *start_key,
                                const key_range *end_key,
@@ -1976,6 +2020,33 @@ public:
    Pops the top if condition stack, if stack is not empty.
  */
  virtual void cond_pop() { return; };
+
+ /**
+   Push an index condition down to the table handler.
+
+   The condition refers only to the columns of the index keyno and,
+   possibly, to the columns of tables that precede this table in the
+   join. The handler evaluates it for each index entry before it reads
+   the rest of the row, see handler_index_cond_check().
+
+   @param  keyno     Index to which the condition applies
+   @param  idx_cond  Condition on the columns of the index
+
+   @return
+     The part of the condition that the handler does not evaluate.
+     NULL means the whole condition is pushed.
+
+   @note
+   The server still evaluates the whole WHERE clause for every row the
+   handler returns. handler->ha_reset() discards the pushed condition.
+ */
+ virtual Item *idx_cond_push(uint keyno, Item *idx_cond) { return idx_cond; }
+ /** Discard the condition pushed with idx_cond_push() */
+ virtual void cancel_pushed_idx_cond()
+ {
+   pushed_idx_cond= NULL;
+   pushed_idx_cond_keyno= MAX_KEY;
+ }
  virtual bool check_if_incompatible_data(HA_CREATE_INFO *create_info,
 					 uint table_changes)
  { return COMPATIBLE_DATA_NO; }
@@ -2048,6 +2119,7 @@ protected:
 private:
   /* Private helpers */
   inline void mark_trx_read_write();
+  int read_multi_range_rowids();
 private:
   /*
     Low-level primitives for storage engines.  These should be
@@ -2313,6 +2385,7 @@ int ha_release_temporary_latches(THD *thd);
 int ha_start_consistent_snapshot(THD *thd);
 int ha_commit_or_rollback_by_xid(XID *xid, bool commit);
 int ha_commit_one_phase(THD *thd, bool all);
+void ha_commit_ordered(THD *thd);
 int ha_commit_trans(THD *thd, bool all);
 int ha_rollback_trans(THD *thd, bool all);
 int ha_prepare(THD *thd);
@@ -605,7 +605,8 @@ Item_ident::Item_ident(Name_resolution_context *context_arg,
 
 Item_ident::Item_ident(TABLE_LIST *view_arg, const char *field_name_arg)
   :orig_db_name(NullS), orig_table_name(view_arg->table_name),
-   orig_field_name(field_name_arg), context(&view_arg->view->select_lex.context),
+   orig_field_name(field_name_arg),
+   context(&view_arg->get_merged_select()->context),
    db_name(NullS), table_name(view_arg->alias),
    field_name(field_name_arg),
    alias_name_used(FALSE), cached_field_index(NO_CACHED_FIELD_INDEX),
@@ -8134,7 +8135,8 @@ void Item_cache_row::bring_value()
 
 
 Item_type_holder::Item_type_holder(THD *thd, Item *item)
-  :Item(thd, item), enum_set_typelib(0), fld_type(get_real_type(item))
+  :Item(thd, item), enum_set_typelib(0), fld_type(get_real_type(item)),
+   result_field(0)
 {
   DBUG_ASSERT(item->fixed);
   maybe_null= item->maybe_null;
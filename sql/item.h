@@ -3560,6 +3560,8 @@ protected:
 
   /* It is used to count decimal precision in join_types */
   int prev_decimal_int_part;
+  /* Field created by create_tmp_field() for a group key, see below */
+  Field *result_field;
 public:
   Item_type_holder(THD*, Item*);
 
@@ -3575,6 +3577,12 @@ public:
   static uint32 display_length(Item *item);
   static enum_field_types get_real_type(Item *);
   Field::geometry_type get_geometry_type() const { return geometry_type; };
+  /*
+    Set when the holder is a GROUP BY column of a temporary table, to find
+    the column of the group key
+  */
+  void set_result_field(Field *field) { result_field= field; }
+  Field *get_tmp_table_field() { return result_field; }
 };
 
 
@@ -684,7 +684,7 @@ bool Item_in_subselect::test_limit(st_select_lex_unit *unit_arg)
 Item_in_subselect::Item_in_subselect(Item * left_exp,
 				     st_select_lex *select_lex):
   Item_exists_subselect(), optimizer(0), transformed(0),
-  pushed_cond_guards(NULL), upper_item(0)
+  pushed_cond_guards(NULL), upper_item(0), exec_method(EXEC_EXISTS)
 {
   DBUG_ENTER("Item_in_subselect::Item_in_subselect");
   left_expr= left_exp;
@@ -1655,7 +1655,10 @@ Item_in_subselect::select_in_like_transformer(JOIN *join, Comp_creator *func)
     of Item, we have to call fix_fields() for it only with original arena to
     avoid memory leack)
   */
-  if (left_expr->cols() == 1)
+  if (func == &eq_creator && materialization_allowed(join) &&
+      materialization_is_cheaper(join))
+    res= materialization_transformer(join);
+  else if (left_expr->cols() == 1)
     res= single_value_transformer(join, func);
   else
   {
@@ -1677,9 +1680,238 @@ err:
 }
 
 
+/**
+  Check if an IN subquery can be executed by materialization
+
+  @param join  JOIN of the subquery
+
+  @details
+    The subquery must be an uncorrelated single select, and each of its
+    columns must compare with the left expression the way the unique key
+    of the temporary table compares values. NULLs are not looked up in the
+    temporary table, so they are allowed only where a NULL result of the
+    predicate can be taken as FALSE.
+
+  @retval TRUE   The subquery can be materialized
+  @retval FALSE  Otherwise
+*/
+
+bool Item_in_subselect::materialization_allowed(JOIN *join)
+{
+  SELECT_LEX *select_lex= join->select_lex;
+  SELECT_LEX_UNIT *master_unit= select_lex->master_unit();
+  uint key_length= 0;
+
+  if (!optimizer_flag(thd, OPTIMIZER_SWITCH_MATERIALIZATION) ||
+      substype() != IN_SUBS ||
+      master_unit->first_select()->next_select() ||
+      master_unit->uncacheable || select_lex->uncacheable ||
+      !select_lex->table_list.elements ||
+      select_lex->item_list.elements != left_expr->cols() ||
+      left_expr->const_item())
+    return FALSE;
+
+  List_iterator_fast<Item> it(select_lex->item_list);
+  Item *inner;
+  for (uint i= 0; (inner= it++); i++)
+  {
+    Item *outer= left_expr->element_index(i);
+    if (outer->cols() != 1 || inner->cols() != 1 ||
+        outer->result_type() != inner->result_type())
+      return FALSE;
+    if (!abort_on_null && (outer->maybe_null || inner->maybe_null))
+      return FALSE;
+    switch (inner->result_type()) {
+    case STRING_RESULT:
+      if (outer->is_datetime() != inner->is_datetime() ||
+          (inner->is_datetime() &&
+           outer->field_type() != inner->field_type()))
+        return FALSE;
+      if (outer->collation.collation != inner->collation.collation ||
+          inner->max_length >= CONVERT_IF_BIGGER_TO_BLOB)
+        return FALSE;
+      switch (inner->field_type()) {
+      case MYSQL_TYPE_TINY_BLOB:
+      case MYSQL_TYPE_MEDIUM_BLOB:
+      case MYSQL_TYPE_LONG_BLOB:
+      case MYSQL_TYPE_BLOB:
+      case MYSQL_TYPE_GEOMETRY:
+        return FALSE;
+      default:
+        break;
+      }
+      key_length+= inner->max_length + HA_KEY_BLOB_LENGTH;
+      break;
+    case INT_RESULT:
+      if (inner->field_type() == MYSQL_TYPE_BIT)
+        return FALSE;
+      /* fall through */
+    case REAL_RESULT:
+    case DECIMAL_RESULT:
+      key_length+= max(inner->max_length, sizeof(longlong));
+      break;
+    default:
+      return FALSE;
+    }
+    key_length+= test(inner->maybe_null);
+  }
+  /* A longer key becomes a unique constraint that can't be looked up */
+  return key_length <= MI_MAX_KEY_LENGTH;
+}
+
+
+/**
+  Compare the costs of executing an IN subquery as EXISTS and by
+  materialization
+
+  @param join  JOIN of the subquery
+
+  @details
+    The costs are counted in rows, with the number of rows of the tables
+    taken from the handlers. Executed as EXISTS the subquery is evaluated
+    for each row of the outer select, with an index lookup when its column
+    starts an index and with a scan of half its rows otherwise.
+    Materialization reads and writes the rows of the subquery once and then
+    does one lookup in the temporary table for each row of the outer
+    select.
+
+  @retval TRUE   Materialization is cheaper
+  @retval FALSE  Otherwise
+*/
+
+bool Item_in_subselect::materialization_is_cheaper(JOIN *join)
+{
+  SELECT_LEX *select_lex= join->select_lex;
+  SELECT_LEX *outer_select= select_lex->outer_select();
+  double outer_rows= 1.0, inner_rows= 1.0, lookup_rows;
+  TABLE_LIST *tl;
+
+  for (tl= outer_select ? outer_select->leaf_tables : NULL; tl;
+       tl= tl->next_leaf)
+  {
+    if (!tl->table)
+      continue;
+    tl->table->file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
+    outer_rows*= max(tl->table->file->stats.records, 1);
+  }
+  for (tl= select_lex->leaf_tables; tl; tl= tl->next_leaf)
+  {
+    if (!tl->table)
+      continue;
+    tl->table->file->info(HA_STATUS_VARIABLE | HA_STATUS_NO_LOCK);
+    inner_rows*= max(tl->table->file->stats.records, 1);
+  }
+
+  lookup_rows= inner_rows / 2;
+  Item *inner= select_lex->item_list.head()->real_item();
+  if (inner->type() == Item::FIELD_ITEM)
+  {
+    Field *field= ((Item_field *) inner)->field;
+    if (!field->key_start.is_clear_all())
+      lookup_rows= inner_rows /
+                   max(field->table->file->stats.records, 1);
+  }
+
+  double exists_cost= outer_rows * lookup_rows;
+  double materialization_cost= 2 * inner_rows + outer_rows;
+  DBUG_PRINT("info", ("exists cost: %g  materialization cost: %g",
+                      exists_cost, materialization_cost));
+  return materialization_cost < exists_cost;
+}
+
+
+/**
+  Set up an IN subquery to be executed by materialization
+
+  @param join  JOIN of the subquery
+
+  @details
+    The subquery stays uncorrelated: no predicates are injected into it,
+    and its LIMIT 1 is not set, see fix_length_and_dec(). The engine that
+    fills and looks up the temporary table replaces the engine of the
+    subquery at the first execution, see setup_materialization().
+*/
+
+Item_subselect::trans_res
+Item_in_subselect::materialization_transformer(JOIN *join)
+{
+  DBUG_ENTER("Item_in_subselect::materialization_transformer");
+  substitution= optimizer;
+
+  SELECT_LEX *current= thd->lex->current_select;
+  thd->lex->current_select= current->return_after_parsing();
+  //optimizer never use Item **ref => we can pass 0 as parameter
+  if (!optimizer || optimizer->fix_left(thd, 0))
+  {
+    thd->lex->current_select= current;
+    DBUG_RETURN(RES_ERROR);
+  }
+  thd->lex->current_select= current;
+
+  /* We will refer to upper level cache array => we have to save it for SP */
+  optimizer->keep_top_level_cache();
+  exec_method= EXEC_MATERIALIZATION;
+  DBUG_RETURN(RES_OK);
+}
+
+
+/**
+  Replace the engine of the subquery with a subselect_materialize_engine
+
+  @retval FALSE  OK
+  @retval TRUE   Error
+*/
+
+bool Item_in_subselect::setup_materialization()
+{
+  DBUG_ENTER("Item_in_subselect::setup_materialization");
+  subselect_materialize_engine *mat_engine;
+
+  if (!(mat_engine= new subselect_materialize_engine(thd, this,
+                    (subselect_single_select_engine *) engine)) ||
+      mat_engine->init())
+    DBUG_RETURN(TRUE);
+  /*
+    Item_subselect::cleanup() puts the old engine back, the subquery is
+    materialized again by the next execution of the statement.
+  */
+  old_engine= engine;
+  engine= mat_engine;
+  DBUG_RETURN(FALSE);
+}
+
+
+bool Item_in_subselect::exec()
+{
+  if (exec_method == EXEC_MATERIALIZATION && !old_engine &&
+      setup_materialization())
+    return TRUE;
+  return Item_subselect::exec();
+}
+
+
+void Item_in_subselect::fix_length_and_dec()
+{
+  if (exec_method == EXEC_MATERIALIZATION)
+  {
+    /* All rows of the subquery are needed, no LIMIT 1 */
+    decimals= 0;
+    max_length= 1;
+    max_columns= engine->cols();
+    return;
+  }
+  Item_exists_subselect::fix_length_and_dec();
+}
+
+
 void Item_in_subselect::print(String *str, enum_query_type query_type)
 {
-  if (transformed)
+  if (exec_method == EXEC_MATERIALIZATION)
+  {
+    left_expr->print(str, query_type);
+    str->append(STRING_WITH_LEN(" in <materialize>"));
+  }
+  else if (transformed)
     str->append(STRING_WITH_LEN("<exists>"));
   else
   {
@@ -2324,7 +2556,8 @@ int subselect_uniquesubquery_engine::exec()
 subselect_uniquesubquery_engine::~subselect_uniquesubquery_engine()
 {
   /* Tell handler we don't need the index anymore */
-  tab->table->file->ha_index_end();
+  if (tab)
+    tab->table->file->ha_index_end();
 }
 
 
@@ -2723,3 +2956,170 @@ bool subselect_uniquesubquery_engine::no_tables()
   /* returning value is correct, but this method should never be called */
   return 0;
 }
+
+
+/**
+  Create the temporary table of the materialized subquery
+
+  @details
+    The table has a column for each column of the subquery, and a unique
+    group key over all of them, so that each distinct row is stored once
+    and the left expression can be looked up with the key. The rows of the
+    subquery are sent to the table instead of to the result of the
+    subquery.
+
+  @retval FALSE  OK
+  @retval TRUE   Error
+*/
+
+bool subselect_materialize_engine::init()
+{
+  SELECT_LEX *select_lex= materialize_engine->select_lex;
+  Item *left= *((Item_in_subselect *) item)->optimizer->get_cache();
+  uint cols_num= select_lex->item_list.elements;
+  List<Item> tmp_columns;
+  List<Item> eq_list;
+  ORDER *group= NULL, **last_group= &group;
+  Item **column_items;
+  TABLE *table;
+  DBUG_ENTER("subselect_materialize_engine::init");
+
+  if (!(column_items= (Item **) thd->alloc(sizeof(Item *) * cols_num)))
+    DBUG_RETURN(TRUE);
+  List_iterator_fast<Item> it(select_lex->item_list);
+  Item *inner;
+  for (uint i= 0; (inner= it++); i++)
+  {
+    ORDER *order;
+    if (!(column_items[i]= new Item_type_holder(thd, inner)) ||
+        tmp_columns.push_back(column_items[i]) ||
+        !(order= (ORDER *) thd->calloc(sizeof(ORDER))))
+      DBUG_RETURN(TRUE);
+    order->item= column_items + i;
+    *last_group= order;
+    last_group= &order->next;
+  }
+
+  if (!(tmp_result= new select_union) ||
+      tmp_result->create_result_table(thd, &tmp_columns, FALSE,
+                                      thd->variables.option_bits |
+                                      TMP_TABLE_ALL_COLUMNS,
+                                      "materialized subselect", group))
+    DBUG_RETURN(TRUE);
+  table= tmp_result->table;
+
+  if (!(tab= (JOIN_TAB *) thd->calloc(sizeof(JOIN_TAB))))
+    DBUG_RETURN(TRUE);
+  tab->table= table;
+
+  /*
+    The key finds the candidate row, the condition checks it as the
+    comparison of the IN predicate would, since the left expression may
+    have been converted when it was stored in the key.
+  */
+  for (uint i= 0; i < cols_num; i++)
+  {
+    Item *eq= new Item_func_eq(left->element_index(i),
+                               new Item_field(table->field[i]));
+    if (!eq || eq_list.push_back(eq))
+      DBUG_RETURN(TRUE);
+  }
+  cond= (cols_num == 1 ? eq_list.head() : new Item_cond_and(eq_list));
+  if (!cond || cond->fix_fields(thd, &cond))
+    DBUG_RETURN(TRUE);
+
+  DBUG_RETURN(materialize_engine->join->change_result(tmp_result));
+}
+
+
+/**
+  Materialize the subquery at the first execution, and look up the left
+  expression in the temporary table
+
+  @retval 0  OK
+  @retval 1  Error
+*/
+
+int subselect_materialize_engine::exec()
+{
+  Item_in_subselect *item_in= (Item_in_subselect *) item;
+  TABLE *table= tab->table;
+  int error;
+  DBUG_ENTER("subselect_materialize_engine::exec");
+
+  if (!is_materialized)
+  {
+    if (materialize_engine->exec() || tmp_result->flush())
+      DBUG_RETURN(1);
+    is_materialized= TRUE;
+  }
+
+  item_in->value= 0;
+  empty_result_set= TRUE;
+  table->status= 0;
+  table->null_row= 0;
+
+  if (table->s->uniques || !table->s->keys)
+  {
+    /* The key was created as a unique constraint, that has no lookups */
+    if (scan_table())
+      DBUG_RETURN(1);
+    item_in->value= !empty_result_set;
+    DBUG_RETURN(0);
+  }
+
+  /* Store the left expression in the group key, as end_update() does */
+  Item *left= *item_in->optimizer->get_cache();
+  enum_check_fields save_count_cuted_fields= thd->count_cuted_fields;
+  ulonglong save_sql_mode= thd->variables.sql_mode;
+  thd->variables.sql_mode&= ~(MODE_NO_ZERO_IN_DATE | MODE_NO_ZERO_DATE);
+  thd->count_cuted_fields= CHECK_FIELD_IGNORE;
+  uint i= 0;
+  for (ORDER *group= table->group; group; group= group->next, i++)
+  {
+    left->element_index(i)->save_in_field(group->field, TRUE);
+    if ((*group->item)->maybe_null)
+      group->buff[-1]= (char) group->field->is_null();
+  }
+  thd->count_cuted_fields= save_count_cuted_fields;
+  thd->variables.sql_mode= save_sql_mode;
+
+  if (!table->file->inited &&
+      (error= table->file->ha_index_init(0, 0)))
+  {
+    (void) report_error(table, error);
+    DBUG_RETURN(1);
+  }
+  error= table->file->index_read_map(table->record[0],
+                                     tmp_result->tmp_table_param.group_buff,
+                                     HA_WHOLE_KEY, HA_READ_KEY_EXACT);
+  if (error &&
+      error != HA_ERR_KEY_NOT_FOUND && error != HA_ERR_END_OF_FILE)
+    DBUG_RETURN(report_error(table, error) != 0);
+  if (!error && cond->val_int())
+  {
+    item_in->value= 1;
+    empty_result_set= FALSE;
+  }
+  DBUG_RETURN(0);
+}
+
+
+void subselect_materialize_engine::cleanup()
+{
+  DBUG_ENTER("subselect_materialize_engine::cleanup");
+  if (tab)
+  {
+    tab->table->file->ha_index_or_rnd_end();
+    free_tmp_table(thd, tab->table);
+    tab= NULL;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void subselect_materialize_engine::print(String *str,
+                                         enum_query_type query_type)
+{
+  materialize_engine->print(str, query_type);
+}
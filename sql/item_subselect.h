@@ -299,10 +299,18 @@ public:
 
   Item_func_not_all *upper_item; // point on NOT/NOP before ALL/SOME subquery
 
+  /* How the subquery is executed, chosen by select_in_like_transformer() */
+  enum enum_exec_method
+  {
+    EXEC_EXISTS,                /* Predicates injected, as EXISTS */
+    EXEC_MATERIALIZATION        /* Result stored once in an indexed table */
+  };
+  enum_exec_method exec_method;
+
   Item_in_subselect(Item * left_expr, st_select_lex *select_lex);
   Item_in_subselect()
     :Item_exists_subselect(), optimizer(0), abort_on_null(0), transformed(0),
-     pushed_cond_guards(NULL), upper_item(0)
+     pushed_cond_guards(NULL), upper_item(0), exec_method(EXEC_EXISTS)
   {}
 
   subs_type substype() { return IN_SUBS; }
@@ -316,6 +324,12 @@ public:
   trans_res select_in_like_transformer(JOIN *join, Comp_creator *func);
   trans_res single_value_transformer(JOIN *join, Comp_creator *func);
   trans_res row_value_transformer(JOIN * join);
+  bool materialization_allowed(JOIN *join);
+  bool materialization_is_cheaper(JOIN *join);
+  trans_res materialization_transformer(JOIN *join);
+  bool setup_materialization();
+  bool exec();
+  void fix_length_and_dec();
   longlong val_int();
   double val_real();
   String *val_str(String*);
@@ -331,6 +345,7 @@ public:
   friend class Item_ref_null_helper;
   friend class Item_is_not_null_test;
   friend class subselect_indexsubquery_engine;
+  friend class subselect_materialize_engine;
 };
 
 
@@ -450,6 +465,8 @@ public:
   bool may_be_null();
   bool is_executed() const { return executed; }
   bool no_rows();
+
+  friend class subselect_materialize_engine;
 };
 
 
@@ -582,6 +599,48 @@ public:
   virtual void print (String *str, enum_query_type query_type);
 };
 
+
+/*
+  A subquery execution engine that evaluates an uncorrelated subquery
+
+    oe IN (SELECT ie FROM ... WHERE subq_where)
+
+  by storing the result of the subquery once in a temporary table with a
+  unique key on all its columns, and by doing one key lookup with the
+  left expression for each evaluation, as subselect_uniquesubquery_engine
+  does on a table of the subquery.
+
+  The engine is set up by Item_in_subselect::setup_materialization() at
+  the first evaluation, over the engine of the single select that is
+  materialized.
+*/
+
+class select_union;
+
+class subselect_materialize_engine: public subselect_uniquesubquery_engine
+{
+  /* The engine of the subquery that is materialized */
+  subselect_single_select_engine *materialize_engine;
+  /* Writes the rows of the subquery to the temporary table */
+  select_union *tmp_result;
+  /* TRUE <=> the temporary table was filled */
+  bool is_materialized;
+public:
+  subselect_materialize_engine(THD *thd_arg, Item_subselect *subs,
+                               subselect_single_select_engine *old_engine)
+    :subselect_uniquesubquery_engine(thd_arg, NULL, subs, NULL),
+     materialize_engine(old_engine), tmp_result(NULL),
+     is_materialized(FALSE)
+  {}
+  bool init();
+  void cleanup();
+  int prepare() { return 0; }
+  int exec();
+  uint cols() { return materialize_engine->cols(); }
+  uint8 uncacheable() { return materialize_engine->uncacheable(); }
+  virtual void print (String *str, enum_query_type query_type);
+};
+
 /*
   This function is actually defined in sql_parse.cc, but it depends on
   chooser_compare_func_creator defined in this file.
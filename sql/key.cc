@@ -506,6 +506,49 @@ int key_cmp(KEY_PART_INFO *key_part, const uchar *key, uint key_length)
 }
 
 
+/**
+  Compare two key tuples in index order.
+
+  @param part          First key part of the index
+  @param key1          First key tuple, in key image format
+  @param key2          Second key tuple
+  @param tuple_length  Length of the tuples
+
+  @return Return value is SIGN(key1 - key2)
+*/
+
+int key_tuple_cmp(KEY_PART_INFO *part, const uchar *key1, const uchar *key2,
+                  uint tuple_length)
+{
+  const uchar *key1_end= key1 + tuple_length;
+  uint store_length;
+
+  for (; key1 < key1_end; key1+= store_length, key2+= store_length, part++)
+  {
+    int cmp;
+    store_length= part->store_length;
+    if (part->null_bit)
+    {
+      /* NULL is lower than everything */
+      if (*key1)
+      {
+        if (!*key2)
+          return -1;
+        continue;
+      }
+      else if (*key2)
+        return 1;
+      key1++;                                   // Skip null byte
+      key2++;
+      store_length--;
+    }
+    if ((cmp= part->field->key_cmp(key1, key2)))
+      return cmp;
+  }
+  return 0;
+}
+
+
 /**
   Compare two records in index order.
 
@@ -36,6 +36,8 @@ void field_unpack(String *to, Field *field, const uchar *rec, uint max_length,
                   bool prefix_key);
 bool is_key_used(TABLE *table, uint idx, const MY_BITMAP *fields);
 int key_cmp(KEY_PART_INFO *key_part, const uchar *key, uint key_length);
+int key_tuple_cmp(KEY_PART_INFO *part, const uchar *key1, const uchar *key2,
+                  uint tuple_length);
 extern "C" int key_rec_cmp(void *key_info, uchar *a, uchar *b);
 
 #endif /* KEY_INCLUDED */
@@ -429,6 +429,8 @@ public:
      trx_cache.set_binlog_cache_info(param_max_binlog_cache_size,
                                      param_ptr_binlog_cache_use,
                                      param_ptr_binlog_cache_disk_use);
+     last_commit_pos_file[0]= 0;
+     last_commit_pos_offset= 0;
   }
 
   void reset_cache(binlog_cache_data* cache_data)
@@ -450,6 +452,15 @@ public:
 
   binlog_cache_data trx_cache;
 
+  /*
+    Binlog position just after the last transaction that this thread
+    wrote in a group commit. Set by the group commit leader and only
+    valid while the leader runs commit_ordered for the transaction, see
+    mysql_bin_log_commit_pos().
+  */
+  char last_commit_pos_file[FN_REFLEN];
+  my_off_t last_commit_pos_offset;
+
 private:
 
   binlog_cache_mngr& operator=(const binlog_cache_mngr& info);
@@ -2920,7 +2931,8 @@ const char *MYSQL_LOG::generate_name(const char *log_name,
 
 
 MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
-  :bytes_written(0), prepared_xids(0), file_id(1), open_count(1),
+  :group_commit_queue(0), group_commit_queue_size(0),
+   bytes_written(0), prepared_xids(0), file_id(1), open_count(1),
    need_start_event(TRUE),
    sync_period_ptr(sync_period), sync_counter(0),
    is_relay_log(0), signal_cnt(0),
@@ -4521,7 +4533,7 @@ err:
   DBUG_RETURN(error);
 }
 
-bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
+bool MYSQL_BIN_LOG::flush_and_sync(bool *synced, uint n_trx)
 {
   int err=0, fd=log_file.file;
   if (synced)
@@ -4530,7 +4542,7 @@ bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
   if (flush_io_cache(&log_file))
     return 1;
   uint sync_period= get_sync_period();
-  if (sync_period && ++sync_counter >= sync_period)
+  if (sync_period && (sync_counter+= n_trx) >= sync_period)
   {
     sync_counter= 0;
     err= mysql_file_sync(fd, MYF(MY_WME));
@@ -5595,6 +5607,14 @@ bool MYSQL_BIN_LOG::write(THD *thd, IO_CACHE *cache, Log_event *commit_event,
   if (likely(is_open()))                       // Should always be true
   {
     bool check_purge;
+
+    /*
+      Transactions that commit with an Xid go through the group commit,
+      which writes and syncs several of them at once.
+    */
+    if (commit_event && commit_event->get_type_code() == XID_EVENT)
+      DBUG_RETURN(write_transaction_to_binlog(thd, cache, commit_event,
+                                              incident));
     
     mysql_mutex_lock(&LOCK_log);
     /*
@@ -5689,6 +5709,318 @@ err:
 }
 
 
+/**
+  Write a transaction that commits with an Xid to the binary log, as
+  part of a group commit.
+
+  The transaction is put in the group commit queue. If the queue was
+  empty the calling thread becomes the leader of the group and writes
+  and syncs the binlog for all queued transactions, see
+  write_transaction_to_binlog_group(). Otherwise the thread waits until
+  the leader is done with its transaction.
+
+  When this function returns without error, the transaction is in the
+  binlog, prepared_xids is increased for it, and the commit_ordered
+  step of its engines has run.
+
+  @param thd        The thread of the transaction
+  @param cache      The transaction cache to copy to the binlog
+  @param end_event  The Xid event to write after the cache
+  @param incident   Write an incident event after the transaction
+
+  @retval FALSE  Success
+  @retval TRUE   Error, the transaction must be rolled back
+*/
+
+bool
+MYSQL_BIN_LOG::write_transaction_to_binlog(THD *thd, IO_CACHE *cache,
+                                           Log_event *end_event,
+                                           bool incident)
+{
+  group_commit_entry entry;
+  DBUG_ENTER("MYSQL_BIN_LOG::write_transaction_to_binlog");
+
+  entry.thd= thd;
+  entry.cache_mngr= (binlog_cache_mngr*) thd_get_ha_data(thd, binlog_hton);
+  entry.cache= cache;
+  entry.end_event= end_event;
+  entry.incident= incident;
+  entry.written= false;
+  entry.flushed= false;
+  entry.error= false;
+  entry.done= false;
+
+  mysql_mutex_lock(&LOCK_group_commit_queue);
+  entry.next= group_commit_queue;
+  group_commit_queue= &entry;
+  group_commit_queue_size++;
+  if (entry.next)
+  {
+    /* Someone else is the leader, wait for it to commit us */
+    if (binlog_group_commit_sync_no_delay_count &&
+        group_commit_queue_size >= binlog_group_commit_sync_no_delay_count)
+      mysql_cond_signal(&COND_group_commit_queue);
+
+    const char *old_msg= thd->enter_cond(&COND_group_commit,
+                                         &LOCK_group_commit_queue,
+                                         "Waiting for binlog group commit");
+    while (!entry.done)
+      mysql_cond_wait(&COND_group_commit, &LOCK_group_commit_queue);
+    thd->exit_cond(old_msg);
+  }
+  else
+  {
+    mysql_mutex_unlock(&LOCK_group_commit_queue);
+    write_transaction_to_binlog_group(&entry);
+  }
+
+  /*
+    The leader ran the after_flush hook for us in its own thread. Save
+    our position in this thread, where the after_commit hook looks for
+    it, so that e.g. semisync waits for this transaction.
+  */
+  if (entry.flushed &&
+      set_trans_binlog_info(entry.cache_mngr->last_commit_pos_file,
+                            entry.cache_mngr->last_commit_pos_offset))
+    sql_print_error("Failed to run 'after_flush' hooks");
+  entry.cache_mngr->last_commit_pos_file[0]= 0;
+  DBUG_RETURN(entry.error);
+}
+
+
+/**
+  Write all transactions in the group commit queue to the binary log.
+
+  Called by the group leader. The stages are:
+
+  - Optionally wait binlog_group_commit_sync_delay microseconds for
+    more transactions to join the group.
+  - Take LOCK_log, which also waits for the previous group, and take
+    the queue. Transactions that arrive from now on form the next group.
+  - Write the transactions in the order they were queued, then flush
+    and sync the binlog once for the whole group.
+  - Switch from LOCK_log to LOCK_commit_ordered, so the next group can
+    start writing, and run commit_ordered of the engines for each
+    transaction in binlog order.
+  - Mark the entries done and wake up the waiting threads.
+
+  @param leader  The entry of the calling thread
+*/
+
+void
+MYSQL_BIN_LOG::write_transaction_to_binlog_group(group_commit_entry *leader)
+{
+  group_commit_entry *queue, *current, *next;
+  ulong group_size= 0, xid_count= 0;
+  uint written_count= 0;
+  bool synced= 0, error= false;
+  DBUG_ENTER("MYSQL_BIN_LOG::write_transaction_to_binlog_group");
+
+  if (binlog_group_commit_sync_delay)
+  {
+    struct timespec abstime;
+    set_timespec_nsec(abstime, binlog_group_commit_sync_delay * 1000ULL);
+    mysql_mutex_lock(&LOCK_group_commit_queue);
+    while (!binlog_group_commit_sync_no_delay_count ||
+           group_commit_queue_size < binlog_group_commit_sync_no_delay_count)
+    {
+      int wait_result= mysql_cond_timedwait(&COND_group_commit_queue,
+                                            &LOCK_group_commit_queue,
+                                            &abstime);
+      if (wait_result == ETIMEDOUT || wait_result == ETIME)
+        break;
+    }
+    mysql_mutex_unlock(&LOCK_group_commit_queue);
+  }
+
+  mysql_mutex_lock(&LOCK_log);
+
+  mysql_mutex_lock(&LOCK_group_commit_queue);
+  current= group_commit_queue;
+  group_commit_queue= NULL;
+  group_commit_queue_size= 0;
+  mysql_mutex_unlock(&LOCK_group_commit_queue);
+
+  /* The queue is in reverse order of arrival, put it in commit order */
+  queue= NULL;
+  for (; current; current= next)
+  {
+    next= current->next;
+    current->next= queue;
+    queue= current;
+    group_size++;
+  }
+  DBUG_ASSERT(queue == leader);
+
+  if (likely(is_open()))
+  {
+    for (current= queue; current; current= current->next)
+    {
+      if (error || write_transaction_entry(current))
+      {
+        current->error= true;
+        error= true;
+      }
+      if (current->written)
+        written_count++;
+    }
+
+    /*
+      Flush the transactions that were written, even if some failed.
+      'sync_binlog' counts transactions, as when each one was flushed
+      on its own, so a group can sync for several of them at once.
+    */
+    if (written_count && flush_and_sync(&synced, written_count))
+    {
+      for (current= queue; current; current= current->next)
+        current->error= true;
+      error= true;
+    }
+    DBUG_EXECUTE_IF("half_binlogged_transaction", DBUG_SUICIDE(););
+
+    for (current= queue; current; current= current->next)
+    {
+      if (current->error)
+        continue;
+      if (current->cache->error)                // Error on read
+      {
+        sql_print_error(ER(ER_ERROR_ON_READ), current->cache->file_name,
+                        errno);
+        write_error= 1;                         // Don't give more errors
+        current->error= true;
+        continue;
+      }
+      if (current->written &&
+          RUN_HOOK(binlog_storage, after_flush,
+                   (current->thd,
+                    current->cache_mngr->last_commit_pos_file,
+                    current->cache_mngr->last_commit_pos_offset, synced)))
+      {
+        sql_print_error("Failed to run 'after_flush' hooks");
+        write_error= 1;
+        current->error= true;
+        continue;
+      }
+      current->flushed= current->written &&
+                        !binlog_storage_delegate->is_empty();
+      xid_count++;
+    }
+
+    if (error && !write_error)
+    {
+      write_error= 1;
+      sql_print_error(ER(ER_ERROR_ON_WRITE), name, errno);
+    }
+
+    if (xid_count)
+    {
+      /*
+        Binlog cannot be rotated while there are prepared xids in it, see
+        the comment in new_file(). The count is decreased in ::unlog().
+      */
+      mysql_mutex_lock(&LOCK_prep_xids);
+      prepared_xids+= xid_count;
+      mysql_mutex_unlock(&LOCK_prep_xids);
+    }
+    if (written_count)
+      signal_update();
+
+    binlog_group_commits++;
+    binlog_group_commit_trx+= group_size;
+    if (synced)
+      binlog_group_commit_syncs++;
+  }
+
+  /*
+    Let the next group write to the binlog while the engines commit this
+    one. LOCK_commit_ordered is taken before LOCK_log is released, so
+    the engines see the groups in binlog order too.
+  */
+  mysql_mutex_lock(&LOCK_commit_ordered);
+  mysql_mutex_unlock(&LOCK_log);
+  for (current= queue; current; current= current->next)
+  {
+    if (!current->error)
+      ha_commit_ordered(current->thd);
+  }
+  mysql_mutex_unlock(&LOCK_commit_ordered);
+
+  /*
+    The entries live on the stack of the waiting threads and may be gone
+    as soon as they are marked done, so read 'next' first.
+  */
+  mysql_mutex_lock(&LOCK_group_commit_queue);
+  for (current= queue; current; current= next)
+  {
+    next= current->next;
+    current->done= true;
+  }
+  mysql_cond_broadcast(&COND_group_commit);
+  mysql_mutex_unlock(&LOCK_group_commit_queue);
+
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Write one transaction of a group commit to the binlog file.
+
+  Like the body of write(THD*, IO_CACHE*, Log_event*, bool), but without
+  the flush and sync, which the leader does once for the group. The
+  position after the transaction is saved for commit_ordered and the
+  after_commit hook.
+
+  @retval 0  Success
+  @retval 1  Error
+*/
+
+bool MYSQL_BIN_LOG::write_transaction_entry(group_commit_entry *entry)
+{
+  THD *thd= entry->thd;
+  IO_CACHE *cache= entry->cache;
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  /*
+    We only bother to write to the binary log if there is anything
+    to write.
+  */
+  if (my_b_tell(cache) > 0)
+  {
+    entry->written= true;
+    /*
+      Log "BEGIN" at the beginning of every transaction.  Here, a
+      transaction is either a BEGIN..COMMIT block or a single
+      statement in autocommit mode.
+    */
+    Query_log_event qinfo(thd, STRING_WITH_LEN("BEGIN"), TRUE, FALSE, TRUE, 0);
+    if (qinfo.write(&log_file))
+      return 1;
+    DBUG_EXECUTE_IF("crash_before_writing_xid",
+                    {
+                      if ((write_error= write_cache(cache, false, true)))
+                        DBUG_PRINT("info", ("error writing binlog cache: %d",
+                                             write_error));
+                      DBUG_PRINT("info", ("crashing before writing xid"));
+                      DBUG_SUICIDE();
+                    });
+
+    if ((write_error= write_cache(cache, false, false)))
+      return 1;
+
+    if (entry->end_event->write(&log_file))
+      return 1;
+
+    if (entry->incident && write_incident(thd, FALSE))
+      return 1;
+  }
+
+  strmake(entry->cache_mngr->last_commit_pos_file, log_file_name,
+          sizeof(entry->cache_mngr->last_commit_pos_file) - 1);
+  entry->cache_mngr->last_commit_pos_offset= my_b_tell(&log_file);
+  return 0;
+}
+
+
 /**
   Wait until we get a signal that the relay log has been updated.
 
@@ -6607,6 +6939,13 @@ int TC_LOG_BINLOG::open(const char *opt_name)
   mysql_mutex_init(key_BINLOG_LOCK_prep_xids,
                    &LOCK_prep_xids, MY_MUTEX_INIT_FAST);
   mysql_cond_init(key_BINLOG_COND_prep_xids, &COND_prep_xids, 0);
+  mysql_mutex_init(key_BINLOG_LOCK_group_commit_queue,
+                   &LOCK_group_commit_queue, MY_MUTEX_INIT_FAST);
+  mysql_mutex_init(key_BINLOG_LOCK_commit_ordered,
+                   &LOCK_commit_ordered, MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_BINLOG_COND_group_commit, &COND_group_commit, 0);
+  mysql_cond_init(key_BINLOG_COND_group_commit_queue,
+                  &COND_group_commit_queue, 0);
 
   if (!my_b_inited(&index_file))
   {
@@ -6686,13 +7025,17 @@ err:
 void TC_LOG_BINLOG::close()
 {
   DBUG_ASSERT(prepared_xids==0);
+  DBUG_ASSERT(group_commit_queue == NULL);
   mysql_mutex_destroy(&LOCK_prep_xids);
   mysql_cond_destroy(&COND_prep_xids);
+  mysql_mutex_destroy(&LOCK_group_commit_queue);
+  mysql_mutex_destroy(&LOCK_commit_ordered);
+  mysql_cond_destroy(&COND_group_commit);
+  mysql_cond_destroy(&COND_group_commit_queue);
 }
 
 /**
-  @todo
-  group commit
+  Write the transaction to the binlog, as part of a group commit.
 
   @retval
     0    error
@@ -6794,6 +7137,36 @@ ulonglong mysql_bin_log_file_pos(void)
 {
   return (ulonglong) mysql_bin_log.get_log_file()->pos_in_file;
 }
+/**
+  Get the binlog position of a transaction that is being committed.
+
+  Inside the commit_ordered step of a group commit this is the position
+  just after the transaction, which the group leader saved when it wrote
+  the transaction. Otherwise it is the current position of the binlog.
+
+  @param      thd       The thread of the committing transaction
+  @param[out] out_pos   Byte offset from the beginning of the binlog
+  @param[out] out_file  The name of the binlog file
+*/
+extern "C"
+void mysql_bin_log_commit_pos(THD *thd, ulonglong *out_pos,
+                              const char **out_file)
+{
+  binlog_cache_mngr *cache_mngr= NULL;
+  /* Without --log-bin the binlog handlerton has no slot in the THD */
+  if (opt_bin_log)
+    cache_mngr= (binlog_cache_mngr*) thd_get_ha_data(thd, binlog_hton);
+  if (cache_mngr && cache_mngr->last_commit_pos_file[0])
+  {
+    *out_file= cache_mngr->last_commit_pos_file;
+    *out_pos= (ulonglong) cache_mngr->last_commit_pos_offset;
+  }
+  else
+  {
+    *out_file= mysql_bin_log_file_name();
+    *out_pos= mysql_bin_log_file_pos();
+  }
+}
 #endif /* INNODB_COMPATIBILITY_HOOKS */
 
 
@@ -20,6 +20,7 @@
 #include "handler.h"                            /* my_xid */
 
 class Relay_log_info;
+class binlog_cache_mngr;
 
 class Format_description_log_event;
 
@@ -294,6 +295,38 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   mysql_mutex_t LOCK_prep_xids;
   mysql_cond_t  COND_prep_xids;
   mysql_cond_t update_cond;
+  /*
+    Group commit. A transaction that commits with an Xid puts itself in
+    group_commit_queue. The thread that finds the queue empty becomes
+    the leader: it writes all queued transactions to the binlog with a
+    single flush and sync, and then runs the commit_ordered step of the
+    engines for them in binlog order under LOCK_commit_ordered. The
+    other threads wait on COND_group_commit until the leader marks
+    their entry done. The queue is protected by LOCK_group_commit_queue,
+    COND_group_commit_queue is used to wake up a leader that waits for
+    binlog_group_commit_sync_no_delay_count transactions.
+    These are inited by TC_LOG_BINLOG::open(), as only the binlog used
+    as transaction coordinator writes Xid events.
+  */
+  mysql_mutex_t LOCK_group_commit_queue;
+  mysql_mutex_t LOCK_commit_ordered;
+  mysql_cond_t COND_group_commit;
+  mysql_cond_t COND_group_commit_queue;
+  struct group_commit_entry
+  {
+    group_commit_entry *next;
+    THD *thd;
+    binlog_cache_mngr *cache_mngr;
+    IO_CACHE *cache;
+    Log_event *end_event;
+    bool incident;
+    bool written;
+    bool flushed;
+    bool error;
+    bool done;
+  };
+  group_commit_entry *group_commit_queue;
+  ulong group_commit_queue_size;
   ulonglong bytes_written;
   IO_CACHE index_file;
   char index_file_name[FN_REFLEN];
@@ -351,6 +384,10 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   */
   int new_file_without_locking();
   int new_file_impl(bool need_lock);
+  bool write_transaction_to_binlog(THD *thd, IO_CACHE *cache,
+                                   Log_event *end_event, bool incident);
+  void write_transaction_to_binlog_group(group_commit_entry *leader);
+  bool write_transaction_entry(group_commit_entry *entry);
 
 public:
   using MYSQL_LOG::generate_name;
@@ -472,11 +509,13 @@ public:
      be set to 1, otherwise 0.
 
      @param[out] synced if not NULL, set to 1 if file is synchronized, otherwise 0
+     @param      n_trx  number of transactions written since the last call,
+                        which all count towards 'sync_binlog'
 
      @retval 0 Success
      @retval other Failure
   */
-  bool flush_and_sync(bool *synced);
+  bool flush_and_sync(bool *synced, uint n_trx= 1);
   int purge_logs(const char *to_log, bool included,
                  bool need_mutex, bool need_update_threads,
                  ulonglong *decrease_log_space);
@@ -8238,6 +8238,13 @@ int Rows_log_event::do_apply_event(Relay_log_info const *rli)
      */
     const_cast<Relay_log_info*>(rli)->set_row_stmt_start_timestamp();
 
+    /*
+      Start with the first row: a slave worker applies the event again
+      when it retries the transaction, see Slave_worker::apply_group().
+    */
+    m_curr_row= m_rows_buf;
+    m_curr_row_end= NULL;
+
     while (error == 0 && m_curr_row < m_rows_end)
     {
       /* in_use can have been set to NULL in close_tables_for_reopen */
@@ -67,6 +67,7 @@
 #include "sql_audit.h"
 #include "probes_mysql.h"
 #include "scheduler.h"
+#include "threadpool.h"
 #include "debug_sync.h"
 #include "sql_callback.h"
 
@@ -464,6 +465,7 @@ ulong what_to_log;
 ulong slow_launch_time, slave_open_temp_tables;
 ulong open_files_limit, max_binlog_size, max_relay_log_size;
 ulong slave_trans_retries;
+ulong opt_slave_parallel_workers;
 uint  slave_net_timeout;
 ulong slave_exec_mode_options;
 ulonglong slave_type_conversions_options;
@@ -485,6 +487,8 @@ ulong delayed_insert_errors,flush_time;
 ulong specialflag=0;
 ulong binlog_cache_use= 0, binlog_cache_disk_use= 0;
 ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
+ulong binlog_group_commits= 0, binlog_group_commit_trx= 0;
+ulong binlog_group_commit_syncs= 0;
 ulong max_connections, max_connect_errors;
 /*
   Maximum length of parameter value which can be set through
@@ -509,6 +513,8 @@ ulong max_prepared_stmt_count;
 ulong prepared_stmt_count=0;
 ulong thread_id=1L,current_pid;
 ulong slow_launch_threads = 0;
+ulong binlog_group_commit_sync_delay= 0;
+ulong binlog_group_commit_sync_no_delay_count= 0;
 uint sync_binlog_period= 0, sync_relaylog_period= 0,
      sync_relayloginfo_period= 0, sync_masterinfo_period= 0;
 ulong expire_logs_days = 0;
@@ -6596,6 +6602,9 @@ SHOW_VAR status_vars[]= {
   {"Aborted_connects",         (char*) &aborted_connects,       SHOW_LONG},
   {"Binlog_cache_disk_use",    (char*) &binlog_cache_disk_use,  SHOW_LONG},
   {"Binlog_cache_use",         (char*) &binlog_cache_use,       SHOW_LONG},
+  {"Binlog_group_commit_syncs",(char*) &binlog_group_commit_syncs, SHOW_LONG},
+  {"Binlog_group_commit_trx",  (char*) &binlog_group_commit_trx, SHOW_LONG},
+  {"Binlog_group_commits",     (char*) &binlog_group_commits,   SHOW_LONG},
   {"Binlog_stmt_cache_disk_use",(char*) &binlog_stmt_cache_disk_use,  SHOW_LONG},
   {"Binlog_stmt_cache_use",    (char*) &binlog_stmt_cache_use,       SHOW_LONG},
   {"Bytes_received",           (char*) offsetof(STATUS_VAR, bytes_received), SHOW_LONGLONG_STATUS},
@@ -6674,6 +6683,7 @@ SHOW_VAR status_vars[]= {
   {"Slow_launch_threads",      (char*) &slow_launch_threads,    SHOW_LONG},
   {"Slow_queries",             (char*) offsetof(STATUS_VAR, long_query_count), SHOW_LONG_STATUS},
   {"Sort_merge_passes",	       (char*) offsetof(STATUS_VAR, filesort_merge_passes), SHOW_LONG_STATUS},
+  {"Sort_priority_queue_sorts", (char*) offsetof(STATUS_VAR, filesort_pq_sorts), SHOW_LONG_STATUS},
   {"Sort_range",	       (char*) offsetof(STATUS_VAR, filesort_range_count), SHOW_LONG_STATUS},
   {"Sort_rows",		       (char*) offsetof(STATUS_VAR, filesort_rows), SHOW_LONG_STATUS},
   {"Sort_scan",		       (char*) offsetof(STATUS_VAR, filesort_scan_count), SHOW_LONG_STATUS},
@@ -6710,6 +6720,11 @@ SHOW_VAR status_vars[]= {
   {"Tc_log_max_pages_used",    (char*) &tc_log_max_pages_used,  SHOW_LONG},
   {"Tc_log_page_size",         (char*) &tc_log_page_size,       SHOW_LONG},
   {"Tc_log_page_waits",        (char*) &tc_log_page_waits,      SHOW_LONG},
+#endif
+#ifdef HAVE_POOL_OF_THREADS
+  {"Threadpool_idle_threads",  (char*) &tp_stat_idle_threads,   SHOW_INT},
+  {"Threadpool_stalls",        (char*) &tp_stat_stalls,         SHOW_LONG_NOFLUSH},
+  {"Threadpool_threads",       (char*) &tp_stat_threads,        SHOW_INT},
 #endif
   {"Threads_cached",           (char*) &cached_thread_count,    SHOW_LONG_NOFLUSH},
   {"Threads_connected",        (char*) &connection_count,       SHOW_INT},
@@ -6878,6 +6893,8 @@ static int mysql_init_variables(void)
   delayed_insert_errors= thread_created= 0;
   specialflag= 0;
   binlog_cache_use=  binlog_cache_disk_use= 0;
+  binlog_group_commits= binlog_group_commit_trx= 0;
+  binlog_group_commit_syncs= 0;
   max_used_connections= slow_launch_threads = 0;
   mysqld_user= mysqld_chroot= opt_init_file= opt_bin_logname = 0;
   prepared_stmt_count= 0;
@@ -7517,6 +7534,17 @@ static int get_options(int *argc_ptr, char ***argv_ptr)
 #else
   if (thread_handling <= SCHEDULER_ONE_THREAD_PER_CONNECTION)
     one_thread_per_connection_scheduler();
+  else if (thread_handling == SCHEDULER_POOL_OF_THREADS)
+  {
+#ifdef HAVE_POOL_OF_THREADS
+    pool_of_threads_scheduler();
+#else
+    sql_print_warning("--thread-handling=pool-of-threads is not supported "
+                      "on this platform, using one-thread-per-connection");
+    thread_handling= SCHEDULER_ONE_THREAD_PER_CONNECTION;
+    one_thread_per_connection_scheduler();
+#endif
+  }
   else                  /* thread_handling == SCHEDULER_NO_THREADS) */
     one_thread_scheduler();
 #endif
@@ -8143,6 +8171,7 @@ PSI_mutex_key key_LOCK_des_key_file;
 #endif /* HAVE_OPENSSL */
 
 PSI_mutex_key key_BINLOG_LOCK_index, key_BINLOG_LOCK_prep_xids,
+  key_BINLOG_LOCK_group_commit_queue, key_BINLOG_LOCK_commit_ordered,
   key_delayed_insert_mutex, key_hash_filo_lock, key_LOCK_active_mi,
   key_LOCK_connection_count, key_LOCK_crypt, key_LOCK_delayed_create,
   key_LOCK_delayed_insert, key_LOCK_delayed_status, key_LOCK_error_log,
@@ -8179,6 +8208,8 @@ static PSI_mutex_info all_server_mutexes[]=
 
   { &key_BINLOG_LOCK_index, "MYSQL_BIN_LOG::LOCK_index", 0},
   { &key_BINLOG_LOCK_prep_xids, "MYSQL_BIN_LOG::LOCK_prep_xids", 0},
+  { &key_BINLOG_LOCK_group_commit_queue, "MYSQL_BIN_LOG::LOCK_group_commit_queue", 0},
+  { &key_BINLOG_LOCK_commit_ordered, "MYSQL_BIN_LOG::LOCK_commit_ordered", 0},
   { &key_RELAYLOG_LOCK_index, "MYSQL_RELAY_LOG::LOCK_index", 0},
   { &key_delayed_insert_mutex, "Delayed_insert::mutex", 0},
   { &key_hash_filo_lock, "hash_filo::lock", 0},
@@ -8242,6 +8273,7 @@ PSI_cond_key key_PAGE_cond, key_COND_active, key_COND_pool;
 #endif /* HAVE_MMAP */
 
 PSI_cond_key key_BINLOG_COND_prep_xids, key_BINLOG_update_cond,
+  key_BINLOG_COND_group_commit, key_BINLOG_COND_group_commit_queue,
   key_COND_cache_status_changed, key_COND_manager,
   key_COND_rpl_status, key_COND_server_started,
   key_delayed_insert_cond, key_delayed_insert_cond_client,
@@ -8267,6 +8299,8 @@ static PSI_cond_info all_server_conds[]=
 #endif /* HAVE_MMAP */
   { &key_BINLOG_COND_prep_xids, "MYSQL_BIN_LOG::COND_prep_xids", 0},
   { &key_BINLOG_update_cond, "MYSQL_BIN_LOG::update_cond", 0},
+  { &key_BINLOG_COND_group_commit, "MYSQL_BIN_LOG::COND_group_commit", 0},
+  { &key_BINLOG_COND_group_commit_queue, "MYSQL_BIN_LOG::COND_group_commit_queue", 0},
   { &key_RELAYLOG_update_cond, "MYSQL_RELAY_LOG::update_cond", 0},
   { &key_COND_cache_status_changed, "Query_cache::COND_cache_status_changed", 0},
   { &key_COND_manager, "COND_manager", PSI_FLAG_GLOBAL},
@@ -8292,7 +8326,7 @@ static PSI_cond_info all_server_conds[]=
 };
 
 PSI_thread_key key_thread_bootstrap, key_thread_delayed_insert,
-  key_thread_handle_manager, key_thread_main,
+  key_thread_filesort_worker, key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand;
 
 static PSI_thread_info all_server_threads[]=
@@ -8315,6 +8349,7 @@ static PSI_thread_info all_server_threads[]=
 
   { &key_thread_bootstrap, "bootstrap", PSI_FLAG_GLOBAL},
   { &key_thread_delayed_insert, "delayed_insert", 0},
+  { &key_thread_filesort_worker, "filesort_worker", 0},
   { &key_thread_handle_manager, "manager", PSI_FLAG_GLOBAL},
   { &key_thread_main, "main", PSI_FLAG_GLOBAL},
   { &key_thread_one_connection, "one_connection", 0},
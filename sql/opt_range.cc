@@ -8845,7 +8845,8 @@ int QUICK_RANGE_SELECT::get_next()
     }
 
     result= file->read_multi_range_first(&mrange, multi_range, count,
-                                         sorted, multi_range_buff);
+                                         sorted ? HA_MRR_SORTED : 0,
+                                         multi_range_buff);
     if (result != HA_ERR_END_OF_FILE)
       goto end;
     in_range= FALSE; /* No matching rows; go to next set of ranges. */
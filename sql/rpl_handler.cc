@@ -282,6 +282,31 @@ int Trans_delegate::after_rollback(THD *thd, bool all)
   return ret;
 }
 
+/**
+  Save the binlog position of the transaction of the calling thread,
+  for Trans_delegate::after_commit() and after_rollback().
+
+  @retval 0  Success
+  @retval 1  Out of memory
+*/
+int set_trans_binlog_info(const char *log_file, my_off_t log_pos)
+{
+  Trans_binlog_info *log_info=
+    my_pthread_getspecific_ptr(Trans_binlog_info*, RPL_TRANS_BINLOG_INFO);
+
+  if (!log_info)
+  {
+    if(!(log_info=
+         (Trans_binlog_info *)my_malloc(sizeof(Trans_binlog_info), MYF(0))))
+      return 1;
+    my_pthread_setspecific_ptr(RPL_TRANS_BINLOG_INFO, log_info);
+  }
+
+  strcpy(log_info->log_file, log_file+dirname_length(log_file));
+  log_info->log_pos = log_pos;
+  return 0;
+}
+
 int Binlog_storage_delegate::after_flush(THD *thd,
                                          const char *log_file,
                                          my_off_t log_pos,
@@ -292,20 +317,27 @@ int Binlog_storage_delegate::after_flush(THD *thd,
   if (synced)
     flags |= BINLOG_STORAGE_IS_SYNCED;
 
-  Trans_binlog_info *log_info=
-    my_pthread_getspecific_ptr(Trans_binlog_info*, RPL_TRANS_BINLOG_INFO);
-    
-  if (!log_info)
+  Trans_binlog_info group_info;
+  Trans_binlog_info *log_info= &group_info;
+
+  /*
+    A group commit leader also runs the hook for the other transactions
+    of its group. Their threads save their position themselves, see
+    MYSQL_BIN_LOG::write_transaction_to_binlog().
+  */
+  if (thd == current_thd)
   {
-    if(!(log_info=
-         (Trans_binlog_info *)my_malloc(sizeof(Trans_binlog_info), MYF(0))))
+    if (set_trans_binlog_info(log_file, log_pos))
       return 1;
-    my_pthread_setspecific_ptr(RPL_TRANS_BINLOG_INFO, log_info);
+    log_info=
+      my_pthread_getspecific_ptr(Trans_binlog_info*, RPL_TRANS_BINLOG_INFO);
   }
-    
-  strcpy(log_info->log_file, log_file+dirname_length(log_file));
-  log_info->log_pos = log_pos;
-  
+  else
+  {
+    strcpy(log_info->log_file, log_file+dirname_length(log_file));
+    log_info->log_pos= log_pos;
+  }
+
   int ret= 0;
   FOREACH_OBSERVER(ret, after_flush, thd,
                    (&param, log_info->log_file, log_info->log_pos, flags));
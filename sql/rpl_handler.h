@@ -197,6 +197,7 @@ private:
 
 int delegates_init();
 void delegates_destroy();
+int set_trans_binlog_info(const char *log_file, my_off_t log_pos);
 
 extern Trans_delegate *transaction_delegate;
 extern Binlog_storage_delegate *binlog_storage_delegate;
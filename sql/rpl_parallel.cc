@@ -0,0 +1,1372 @@
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql_priv.h"
+#include "my_global.h"
+
+#ifdef HAVE_REPLICATION
+
+#include "rpl_parallel.h"
+#include "rpl_mi.h"
+#include "slave.h"
+#include "log_event.h"
+#include "mysqld.h"
+#include "sql_base.h"                           // close_thread_tables
+#include "key.h"                                // key_copy
+#include "transaction.h"                        // trans_commit_stmt
+
+/*
+  LOCKING
+
+  LOCK_parallel protects the queues of the coordinator and of the
+  workers, pending_size and the flags of the workers. When both are
+  needed, Relay_log_info::data_lock is taken before LOCK_parallel.
+  The coordinator never waits for the workers while it holds
+  data_lock, because a worker takes data_lock to move the group
+  coordinates of the slave past the transactions it has committed.
+*/
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_rpl_parallel_LOCK_parallel;
+static PSI_cond_key key_rpl_parallel_COND_parallel,
+  key_slave_worker_COND_worker;
+static PSI_thread_key key_thread_slave_worker;
+
+static PSI_mutex_info all_rpl_parallel_mutexes[]=
+{
+  { &key_rpl_parallel_LOCK_parallel, "Rpl_parallel::LOCK_parallel", 0}
+};
+
+static PSI_cond_info all_rpl_parallel_conds[]=
+{
+  { &key_rpl_parallel_COND_parallel, "Rpl_parallel::COND_parallel", 0},
+  { &key_slave_worker_COND_worker, "Slave_worker::COND_worker", 0}
+};
+
+static PSI_thread_info all_rpl_parallel_threads[]=
+{
+  { &key_thread_slave_worker, "slave_worker", 0}
+};
+
+void init_rpl_parallel_psi_keys()
+{
+  const char* category= "sql";
+  int count;
+
+  if (PSI_server == NULL)
+    return;
+
+  count= array_elements(all_rpl_parallel_mutexes);
+  PSI_server->register_mutex(category, all_rpl_parallel_mutexes, count);
+
+  count= array_elements(all_rpl_parallel_conds);
+  PSI_server->register_cond(category, all_rpl_parallel_conds, count);
+
+  count= array_elements(all_rpl_parallel_threads);
+  PSI_server->register_thread(category, all_rpl_parallel_threads, count);
+}
+#endif /* HAVE_PSI_INTERFACE */
+
+
+/**
+  A worker thread and the state it needs to apply events.
+
+  The worker has a Relay_log_info of its own without storage, like the
+  one BINLOG statements use (see mysql_client_binlog_statement()), so
+  that the table maps and the tables to lock of different workers do
+  not mix.
+*/
+
+class Slave_worker
+{
+public:
+  Slave_worker(Rpl_parallel *pool_arg, uint id_arg);
+  ~Slave_worker();
+
+  bool apply_group(rpl_group *group);
+  bool sleep_before_retry(ulong seconds);
+  bool write_info(const char *log_name, ulonglong log_pos);
+
+  Rpl_parallel *pool;
+  uint id;
+  Relay_log_info rli;
+  THD *thd;
+  mysql_cond_t COND_worker;
+  /* Groups assigned to this worker and not taken yet */
+  rpl_group *queue_head, *queue_tail;
+  /* The thread has been created and has not exited yet */
+  bool running;
+  /* Exit when the queue is empty */
+  bool stop;
+};
+
+
+Slave_worker::Slave_worker(Rpl_parallel *pool_arg, uint id_arg)
+  :pool(pool_arg), id(id_arg), rli(FALSE), thd(NULL),
+   queue_head(NULL), queue_tail(NULL), running(FALSE), stop(FALSE)
+{
+  rli.no_storage= TRUE;
+  rli.mi= pool->rli->mi;
+  rli.deferred_events_collecting= FALSE;
+  mysql_cond_init(key_slave_worker_COND_worker, &COND_worker, NULL);
+}
+
+
+Slave_worker::~Slave_worker()
+{
+  /* Owned by the coordinator, see apply_group() */
+  rli.relay_log.description_event_for_exec= NULL;
+  mysql_cond_destroy(&COND_worker);
+}
+
+
+/*
+  The worker information table, mysql.slave_worker_info, has a row for
+  each worker with the number of workers and the master coordinates of
+  the last transaction the worker committed.
+*/
+
+enum enum_worker_info_field
+{
+  WI_FIELD_ID= 0,
+  WI_FIELD_N_WORKERS,
+  WI_FIELD_MASTER_LOG_NAME,
+  WI_FIELD_MASTER_LOG_POS,
+  WI_FIELD_COUNT
+};
+
+static const
+TABLE_FIELD_TYPE worker_info_table_fields[WI_FIELD_COUNT]=
+{
+  {
+    { C_STRING_WITH_LEN("Id") },
+    { C_STRING_WITH_LEN("int(10) unsigned") },
+    { NULL, 0 }
+  },
+  {
+    { C_STRING_WITH_LEN("Number_of_workers") },
+    { C_STRING_WITH_LEN("int(10) unsigned") },
+    { NULL, 0 }
+  },
+  {
+    { C_STRING_WITH_LEN("Master_log_name") },
+    { C_STRING_WITH_LEN("text") },
+    { C_STRING_WITH_LEN("utf8") }
+  },
+  {
+    { C_STRING_WITH_LEN("Master_log_pos") },
+    { C_STRING_WITH_LEN("bigint(20) unsigned") },
+    { NULL, 0 }
+  }
+};
+
+static const TABLE_FIELD_DEF
+  worker_info_table_def= {WI_FIELD_COUNT, worker_info_table_fields};
+
+class Worker_info_intact : public Table_check_intact
+{
+protected:
+  void report_error(uint, const char *fmt, ...)
+  {
+    va_list args;
+    va_start(args, fmt);
+    error_log_print(ERROR_LEVEL, fmt, args);
+    va_end(args);
+  }
+public:
+  Worker_info_intact() { has_keys= TRUE; }
+};
+
+/** In case of an error, a message is printed to the error log. */
+static Worker_info_intact table_intact;
+
+
+/**
+  Close the worker information table.
+
+  The statement transaction is committed, or rolled back after an
+  error. Outside of a transaction this commits the changes to the
+  table; a worker commits them with the transaction it applies.
+
+  @return TRUE if @c error was set or the commit failed
+*/
+
+static bool close_worker_info_table(THD *thd, bool error)
+{
+  if (error)
+    trans_rollback_stmt(thd);
+  else
+    error= trans_commit_stmt(thd);
+  close_thread_tables(thd);
+  if (thd->in_multi_stmt_transaction_mode())
+    thd->mdl_context.release_statement_locks();
+  else
+    thd->mdl_context.release_transactional_locks();
+  return error;
+}
+
+
+static TABLE *open_worker_info_table(THD *thd, TABLE_LIST *tables,
+                                     thr_lock_type lock_type)
+{
+  uint flags= (MYSQL_OPEN_IGNORE_GLOBAL_READ_LOCK |
+               MYSQL_LOCK_IGNORE_GLOBAL_READ_ONLY |
+               MYSQL_OPEN_IGNORE_FLUSH |
+               MYSQL_LOCK_IGNORE_TIMEOUT);
+  TABLE *table;
+
+  tables->init_one_table("mysql", 5, "slave_worker_info", 17,
+                         "slave_worker_info", lock_type);
+  if (!(table= open_n_lock_single_table(thd, tables, lock_type, flags)))
+    return NULL;
+  if (table_intact.check(table, &worker_info_table_def))
+  {
+    close_worker_info_table(thd, TRUE);
+    my_error(ER_CANNOT_LOAD_FROM_TABLE, MYF(0), "slave_worker_info");
+    return NULL;
+  }
+  table->use_all_columns();
+  return table;
+}
+
+
+static void store_worker_info(TABLE *table, uint id, uint n_workers,
+                              const char *log_name, ulonglong log_pos)
+{
+  Field **field= table->field;
+  field[WI_FIELD_ID]->store((longlong) id, TRUE);
+  field[WI_FIELD_N_WORKERS]->store((longlong) n_workers, TRUE);
+  field[WI_FIELD_MASTER_LOG_NAME]->store(log_name, strlen(log_name),
+                                         system_charset_info);
+  field[WI_FIELD_MASTER_LOG_POS]->store((longlong) log_pos, TRUE);
+}
+
+
+/**
+  Replace the rows of the worker information table by @c n_workers
+  rows without a position. With @c n_workers = 0 the table is emptied.
+*/
+
+static bool reset_worker_info(THD *thd, uint n_workers)
+{
+  TABLE_LIST tables;
+  TABLE *table;
+  int error;
+
+  if (!(table= open_worker_info_table(thd, &tables, TL_WRITE)))
+    return TRUE;
+
+  tmp_disable_binlog(thd);
+  if (!(error= table->file->ha_rnd_init(TRUE)))
+  {
+    while (!(error= table->file->rnd_next(table->record[0])) ||
+           error == HA_ERR_RECORD_DELETED)
+    {
+      if (!error && (error= table->file->ha_delete_row(table->record[0])))
+        break;
+    }
+    table->file->ha_rnd_end();
+    if (error == HA_ERR_END_OF_FILE)
+      error= 0;
+  }
+  for (uint i= 0; !error && i < n_workers; i++)
+  {
+    restore_record(table, s->default_values);
+    store_worker_info(table, i, n_workers, "", 0);
+    error= table->file->ha_write_row(table->record[0]);
+  }
+  reenable_binlog(thd);
+
+  if (error)
+    table->file->print_error(error, MYF(0));
+  return close_worker_info_table(thd, error);
+}
+
+
+/**
+  Forget the positions of the workers of the previous run.
+
+  Used by RESET SLAVE and CHANGE MASTER, which both start the slave
+  from a new position. A server that was not upgraded has no worker
+  information table and nothing to forget.
+*/
+
+bool rpl_parallel_remove_worker_info(THD *thd)
+{
+  No_such_table_error_handler no_such_table_handler;
+  bool error;
+
+  thd->push_internal_handler(&no_such_table_handler);
+  error= reset_worker_info(thd, 0);
+  thd->pop_internal_handler();
+  return error && !no_such_table_handler.safely_trapped_errors();
+}
+
+
+static int compare_log_pos(const char *log_name1, ulonglong log_pos1,
+                           const char *log_name2, ulonglong log_pos2)
+{
+  int cmp= strcmp(log_name1, log_name2);
+  if (cmp)
+    return cmp;
+  return log_pos1 < log_pos2 ? -1 : log_pos1 > log_pos2 ? 1 : 0;
+}
+
+
+/**
+  Record the master coordinates of the transaction that is applied.
+
+  Called before the event that commits the transaction, so that the
+  row of the worker is committed with the changes of the transaction.
+*/
+
+bool Slave_worker::write_info(const char *log_name, ulonglong log_pos)
+{
+  TABLE_LIST tables;
+  TABLE *table;
+  uchar key[MAX_KEY_LENGTH];
+  int error;
+
+  if (!(table= open_worker_info_table(thd, &tables, TL_WRITE)))
+    return TRUE;
+
+  tmp_disable_binlog(thd);
+  table->field[WI_FIELD_ID]->store((longlong) id, TRUE);
+  key_copy(key, table->record[0], table->key_info,
+           table->key_info->key_length);
+  if (!(error= table->file->index_read_idx_map(table->record[0], 0, key,
+                                               HA_WHOLE_KEY,
+                                               HA_READ_KEY_EXACT)))
+  {
+    store_record(table, record[1]);
+    store_worker_info(table, id, pool->workers_count(), log_name, log_pos);
+    if ((error= table->file->ha_update_row(table->record[1],
+                                           table->record[0])) ==
+        HA_ERR_RECORD_IS_THE_SAME)
+      error= 0;
+  }
+  else if (error == HA_ERR_KEY_NOT_FOUND)
+  {
+    restore_record(table, s->default_values);
+    store_worker_info(table, id, pool->workers_count(), log_name, log_pos);
+    error= table->file->ha_write_row(table->record[0]);
+  }
+  reenable_binlog(thd);
+
+  if (error)
+    table->file->print_error(error, MYF(0));
+  return close_worker_info_table(thd, error);
+}
+
+
+/**
+  Give the transaction that a retried transaction conflicted with a
+  chance to finish.
+
+  @retval TRUE  the slave is being stopped
+*/
+
+bool Slave_worker::sleep_before_retry(ulong seconds)
+{
+  struct timespec abstime;
+  const char *old_proc_info;
+  bool killed;
+
+  set_timespec(abstime, seconds);
+  mysql_mutex_lock(&rli.sleep_lock);
+  old_proc_info= thd->enter_cond(&rli.sleep_cond, &rli.sleep_lock,
+                                 thd->proc_info);
+  while (!(killed= thd->killed || pool->rli->abort_slave))
+  {
+    int error= mysql_cond_timedwait(&rli.sleep_cond, &rli.sleep_lock,
+                                    &abstime);
+    if (error == ETIMEDOUT || error == ETIME)
+      break;
+  }
+  thd->exit_cond(old_proc_info);
+  return killed;
+}
+
+
+/**
+  Apply the events of a transaction.
+
+  @retval FALSE  the transaction is committed
+  @retval TRUE   an error occurred, it is reported to the coordinator
+*/
+
+bool Slave_worker::apply_group(rpl_group *group)
+{
+  Relay_log_info *coord_rli= pool->rli;
+  int res= 0;
+
+  /*
+    The coordinator replaces its description event only after the
+    workers are idle, see Rpl_parallel::queue_event().
+  */
+  rli.relay_log.description_event_for_exec=
+    coord_rli->relay_log.description_event_for_exec;
+  strmake(rli.group_master_log_name, group->master_log_name,
+          sizeof(rli.group_master_log_name) - 1);
+
+  /*
+    A transaction that fails with a temporary error is rolled back and
+    applied again from its first event, like the slave SQL thread does
+    it, see exec_relay_log_event().
+  */
+  for (ulong retries= 0; ; retries++)
+  {
+    for (uint i= 0; !res && i < group->events.elements; i++)
+    {
+      Log_event *ev= *dynamic_element(&group->events, i, Log_event**);
+      /* The position is committed with the transaction */
+      if (i == group->events.elements - 1 &&
+          (res= write_info(group->master_log_name, group->master_log_pos)))
+        break;
+      mysql_mutex_lock(&rli.data_lock);
+      res= apply_event_and_update_pos(ev, thd, &rli);
+    }
+    if (!res || res == 2 || !has_temporary_error(thd))
+      break;
+    if (retries >= slave_trans_retries)
+    {
+      sql_print_error("Slave SQL thread retried transaction %lu time(s) "
+                      "in vain, giving up. Consider raising the value of "
+                      "the slave_transaction_retries variable.",
+                      slave_trans_retries);
+      break;
+    }
+    rli.cleanup_context(thd, 1);
+    if (sleep_before_retry(min(retries, MAX_SLAVE_RETRY_PAUSE)))
+      break;
+    res= 0;
+    rli.clear_error();
+    thd->clear_error();
+    mysql_mutex_lock(&coord_rli->data_lock);     // because of SHOW STATUS
+    coord_rli->retried_trans++;
+    mysql_mutex_unlock(&coord_rli->data_lock);
+  }
+
+  for (uint i= 0; i < group->events.elements; i++)
+    delete *dynamic_element(&group->events, i, Log_event**);
+  reset_dynamic(&group->events);
+
+  if (!res)
+    return FALSE;
+
+  uint32 error_no= rli.last_error().number;
+  const char *message= rli.last_error().message;
+  if (!error_no && thd->is_error())
+  {
+    error_no= thd->stmt_da->sql_errno();
+    message= thd->stmt_da->message();
+  }
+  /*
+    Last_SQL_Error shows the error as the serial slave would; the error
+    log tells which worker failed on which transaction.
+  */
+  char llbuff[22];
+  sql_print_information("Slave worker %u failed executing transaction ending at "
+                        "master log '%s', end_log_pos %s",
+                        id, group->master_log_name,
+                        llstr(group->master_log_pos, llbuff));
+  coord_rli->report(ERROR_LEVEL, error_no, "%s", message);
+  rli.cleanup_context(thd, 1);
+  return TRUE;
+}
+
+
+pthread_handler_t handle_slave_worker(void *arg)
+{
+  THD *thd;                     /* needs to be first for thread_stack */
+  Slave_worker *w= (Slave_worker*) arg;
+  Rpl_parallel *pool= w->pool;
+  rpl_group *group;
+
+  my_thread_init();
+  DBUG_ENTER("handle_slave_worker");
+
+  thd= new THD;
+  thd->thread_stack= (char*) &thd;
+  pthread_detach_this_thread();
+  if (init_slave_thread(thd, SLAVE_THD_SQL))
+  {
+    delete thd;
+    mysql_mutex_lock(&pool->LOCK_parallel);
+    w->running= FALSE;
+    mysql_cond_broadcast(&pool->COND_parallel);
+    mysql_mutex_unlock(&pool->LOCK_parallel);
+    DBUG_LEAVE;
+    my_thread_end();
+    pthread_exit(0);
+    return 0;
+  }
+  thd->init_for_queries();
+  thd->rli_slave= &w->rli;
+  w->rli.sql_thd= thd;
+  mysql_mutex_lock(&LOCK_thread_count);
+  threads.append(thd);
+  mysql_mutex_unlock(&LOCK_thread_count);
+
+  mysql_mutex_lock(&pool->LOCK_parallel);
+  w->thd= thd;
+  mysql_cond_broadcast(&pool->COND_parallel);
+  mysql_mutex_unlock(&pool->LOCK_parallel);
+
+  while ((group= pool->wait_for_group(w)))
+  {
+    thd_proc_info(thd, "Executing event");
+    bool failed= w->apply_group(group);
+    pool->group_done(group, failed);
+    if (failed)
+      break;
+  }
+
+  thd->clear_error();
+  w->rli.cleanup_context(thd, 1);
+  thd->catalog= 0;
+  thd->reset_query();
+  thd->reset_db(NULL, 0);
+  net_end(&thd->net);
+  w->rli.sql_thd= 0;
+  mysql_mutex_lock(&LOCK_thd_remove);
+  mysql_mutex_lock(&LOCK_thread_count);
+  delete thd;
+  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_mutex_unlock(&LOCK_thd_remove);
+
+  /* The coordinator may free w as soon as LOCK_parallel is released */
+  mysql_mutex_lock(&pool->LOCK_parallel);
+  w->thd= NULL;
+  w->running= FALSE;
+  mysql_cond_broadcast(&pool->COND_parallel);
+  mysql_mutex_unlock(&pool->LOCK_parallel);
+
+  DBUG_LEAVE;                                   // Must match DBUG_ENTER()
+  my_thread_end();
+  pthread_exit(0);
+  return 0;                                     // Avoid compiler warnings
+}
+
+
+Rpl_parallel::Rpl_parallel(Relay_log_info *rli_arg, uint n_workers_arg)
+  :rli(rli_arg), n_workers(n_workers_arg), workers(NULL), cur(NULL),
+   queue_head(NULL), queue_tail(NULL), pending_size(0), failed(FALSE)
+{
+  recovery.n_workers= recovery.last= 0;
+  recovery.master_log_name= NULL;
+  recovery.master_log_pos= NULL;
+  mysql_mutex_init(key_rpl_parallel_LOCK_parallel, &LOCK_parallel,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_rpl_parallel_COND_parallel, &COND_parallel, NULL);
+}
+
+
+Rpl_parallel::~Rpl_parallel()
+{
+  DBUG_ASSERT(!cur && !queue_head);
+  my_free(recovery.master_log_name);
+  my_free(recovery.master_log_pos);
+  mysql_mutex_destroy(&LOCK_parallel);
+  mysql_cond_destroy(&COND_parallel);
+}
+
+
+/**
+  Read the positions of the workers of the previous run.
+
+  @return TRUE if the worker information table could not be read
+*/
+
+bool Rpl_parallel::read_worker_info(THD *thd)
+{
+  No_such_table_error_handler no_such_table_handler;
+  char buff[FN_REFLEN];
+  String str(buff, sizeof(buff), system_charset_info);
+  TABLE_LIST tables;
+  TABLE *table;
+  bool corrupt= FALSE;
+  int error;
+
+  /* Without the table the slave can only run serially */
+  thd->push_internal_handler(&no_such_table_handler);
+  table= open_worker_info_table(thd, &tables, TL_READ);
+  thd->pop_internal_handler();
+  if (!table)
+    return !no_such_table_handler.safely_trapped_errors();
+
+  if (!(error= table->file->ha_rnd_init(TRUE)))
+  {
+    while (!(error= table->file->rnd_next(table->record[0])) ||
+           error == HA_ERR_RECORD_DELETED)
+    {
+      if (error)
+        continue;
+      uint id= (uint) table->field[WI_FIELD_ID]->val_int();
+      uint n= (uint) table->field[WI_FIELD_N_WORKERS]->val_int();
+      if (!recovery.n_workers)
+      {
+        if (n == 0 || n > RPL_PARALLEL_MAX_WORKERS ||
+            !(recovery.master_log_name= (char (*)[FN_REFLEN])
+              my_malloc(n * FN_REFLEN, MYF(MY_WME | MY_ZEROFILL))) ||
+            !(recovery.master_log_pos= (ulonglong*)
+              my_malloc(n * sizeof(ulonglong), MYF(MY_WME | MY_ZEROFILL))))
+        {
+          corrupt= TRUE;
+          break;
+        }
+        recovery.n_workers= n;
+      }
+      if (n != recovery.n_workers || id >= n)
+      {
+        corrupt= TRUE;
+        break;
+      }
+      table->field[WI_FIELD_MASTER_LOG_NAME]->val_str(&str);
+      strmake(recovery.master_log_name[id], str.ptr(),
+              min(str.length(), FN_REFLEN - 1));
+      recovery.master_log_pos[id]=
+        (ulonglong) table->field[WI_FIELD_MASTER_LOG_POS]->val_int();
+    }
+    table->file->ha_rnd_end();
+    if (error == HA_ERR_END_OF_FILE)
+      error= 0;
+  }
+  if (error)
+    table->file->print_error(error, MYF(0));
+  if (close_worker_info_table(thd, error || corrupt) || corrupt)
+    return TRUE;
+
+  for (uint i= 0; i < recovery.n_workers; i++)
+  {
+    if (compare_log_pos(recovery.master_log_name[i],
+                        recovery.master_log_pos[i],
+                        recovery.master_log_name[recovery.last],
+                        recovery.master_log_pos[recovery.last]) > 0)
+      recovery.last= i;
+  }
+  return FALSE;
+}
+
+
+/**
+  Report that the worker information table could not be used, with
+  the error that the statement on it raised.
+*/
+
+void Rpl_parallel::report_worker_info_error(THD *thd, const char *what)
+{
+  char buff[MYSQL_ERRMSG_SIZE];
+  my_snprintf(buff, sizeof(buff), "Could not %s mysql.slave_worker_info%s%s",
+              what, thd->is_error() ? ": " : "",
+              thd->is_error() ? thd->stmt_da->message() : "");
+  rli->report(ERROR_LEVEL, ER_SLAVE_FATAL_ERROR, ER(ER_SLAVE_FATAL_ERROR),
+              buff);
+}
+
+
+/**
+  Start the worker threads.
+
+  If the previous run of the slave stopped before all transactions
+  after the low-water mark were done, the positions of its workers
+  are read first, see recovery_skip().
+
+  @return TRUE on error, which is reported in rli
+*/
+
+bool Rpl_parallel::start(THD *thd)
+{
+  const char *old_msg;
+  bool error= FALSE;
+  DBUG_ENTER("Rpl_parallel::start");
+
+  lex_start(thd);
+  if (read_worker_info(thd))
+  {
+    report_worker_info_error(thd, "read");
+    DBUG_RETURN(TRUE);
+  }
+  if (recovery.n_workers)
+    sql_print_information("Slave SQL thread: %u workers of the previous "
+                          "run may have applied transactions after the "
+                          "position in the relay log info file; they will "
+                          "be skipped", recovery.n_workers);
+  else if (n_workers && reset_worker_info(thd, n_workers))
+  {
+    report_worker_info_error(thd, "write");
+    DBUG_RETURN(TRUE);
+  }
+
+  if (!n_workers)
+    DBUG_RETURN(FALSE);
+
+  if (!(workers= (Slave_worker**) my_malloc(n_workers * sizeof(Slave_worker*),
+                                            MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(TRUE);
+
+  for (uint i= 0; i < n_workers; i++)
+  {
+    pthread_t th;
+    Slave_worker *w= workers[i]= new Slave_worker(this, i);
+    w->running= TRUE;
+    if (mysql_thread_create(key_thread_slave_worker, &th, &connection_attrib,
+                            handle_slave_worker, (void*) w))
+    {
+      w->running= FALSE;
+      error= TRUE;
+      break;
+    }
+  }
+
+  mysql_mutex_lock(&LOCK_parallel);
+  old_msg= thd->enter_cond(&COND_parallel, &LOCK_parallel,
+                           "Waiting for slave workers to start");
+  for (uint i= 0; i < n_workers && workers[i]; i++)
+  {
+    while (workers[i]->running && !workers[i]->thd)
+      mysql_cond_wait(&COND_parallel, &LOCK_parallel);
+    if (!workers[i]->running)
+      error= TRUE;
+  }
+  thd->exit_cond(old_msg);
+
+  if (error)
+  {
+    rli->report(ERROR_LEVEL, ER_SLAVE_FATAL_ERROR, ER(ER_SLAVE_FATAL_ERROR),
+                "Could not start the slave worker threads");
+    stop(thd);
+  }
+  DBUG_RETURN(error);
+}
+
+
+/**
+  Stop the worker threads.
+
+  The workers apply the transactions that are queued for them before
+  they exit, so after a clean stop the low-water mark is the position
+  of the last transaction read and the rows of the workers are
+  removed from the worker information table. After an error they are
+  kept for the next start.
+*/
+
+void Rpl_parallel::stop(THD *thd)
+{
+  const char *old_msg;
+  bool clean;
+  DBUG_ENTER("Rpl_parallel::stop");
+
+  if (cur)
+  {
+    free_group(cur);
+    cur= NULL;
+  }
+
+  if (workers)
+  {
+    mysql_mutex_lock(&LOCK_parallel);
+    for (uint i= 0; i < n_workers && workers[i]; i++)
+    {
+      workers[i]->stop= TRUE;
+      mysql_cond_signal(&workers[i]->COND_worker);
+    }
+    old_msg= thd->enter_cond(&COND_parallel, &LOCK_parallel,
+                             "Waiting for slave workers to exit");
+    for (uint i= 0; i < n_workers && workers[i]; i++)
+    {
+      while (workers[i]->running)
+        mysql_cond_wait(&COND_parallel, &LOCK_parallel);
+    }
+    thd->exit_cond(old_msg);
+  }
+
+  mysql_mutex_lock(&rli->data_lock);
+  checkpoint();
+  mysql_mutex_unlock(&rli->data_lock);
+
+  clean= !queue_head && !failed && !recovery.n_workers;
+  while (queue_head)
+  {
+    rpl_group *group= queue_head;
+    queue_head= group->next;
+    free_group(group);
+  }
+  queue_tail= NULL;
+  /*
+    Rows that could not be removed do no harm: their positions are not
+    after the low-water mark.
+  */
+  if (clean && n_workers)
+  {
+    lex_start(thd);
+    if (reset_worker_info(thd, 0))
+      thd->clear_error();
+  }
+
+  if (workers)
+  {
+    for (uint i= 0; i < n_workers && workers[i]; i++)
+      delete workers[i];
+    my_free(workers);
+    workers= NULL;
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+void Rpl_parallel::free_group(rpl_group *group)
+{
+  for (uint i= 0; i < group->events.elements; i++)
+    delete *dynamic_element(&group->events, i, Log_event**);
+  delete_dynamic(&group->events);
+  my_free(group);
+}
+
+
+/**
+  Move the group coordinates of the slave past the transactions at
+  the head of the queue that are done, and save them in
+  relay-log.info.
+
+  Called with rli->data_lock held.
+*/
+
+void Rpl_parallel::checkpoint()
+{
+  rpl_group *last= NULL;
+
+  mysql_mutex_assert_owner(&rli->data_lock);
+  mysql_mutex_lock(&LOCK_parallel);
+  while (queue_head && queue_head->done)
+  {
+    if (last)
+      free_group(last);
+    last= queue_head;
+    queue_head= last->next;
+  }
+  if (!queue_head)
+    queue_tail= NULL;
+  if (last)
+    mysql_cond_broadcast(&COND_parallel);
+  mysql_mutex_unlock(&LOCK_parallel);
+
+  if (!last)
+    return;
+
+  rli->group_relay_log_pos= last->relay_log_pos;
+  strmake(rli->group_relay_log_name, last->relay_log_name,
+          sizeof(rli->group_relay_log_name) - 1);
+  rli->notify_group_relay_log_name_update();
+  if (last->master_log_pos)
+    rli->group_master_log_pos= last->master_log_pos;
+  flush_relay_log_info(rli);
+  if (last->when)
+    rli->last_master_timestamp= last->when;
+  mysql_cond_broadcast(&rli->data_cond);
+  free_group(last);
+}
+
+
+/**
+  Wait until all dispatched transactions are done.
+
+  Called and returns with rli->data_lock held.
+
+  @return TRUE if a worker failed
+*/
+
+int Rpl_parallel::drain(THD *thd)
+{
+  const char *old_msg;
+  bool res;
+
+  mysql_mutex_assert_owner(&rli->data_lock);
+  mysql_mutex_lock(&LOCK_parallel);
+  if (!queue_head || failed)
+  {
+    res= failed;
+    mysql_mutex_unlock(&LOCK_parallel);
+    return res;
+  }
+  mysql_mutex_unlock(&LOCK_parallel);
+  mysql_mutex_unlock(&rli->data_lock);
+
+  mysql_mutex_lock(&LOCK_parallel);
+  old_msg= thd->enter_cond(&COND_parallel, &LOCK_parallel,
+                           "Waiting for slave workers to finish");
+  while (queue_head && !failed)
+    mysql_cond_wait(&COND_parallel, &LOCK_parallel);
+  res= failed;
+  thd->exit_cond(old_msg);
+
+  mysql_mutex_lock(&rli->data_lock);
+  return res;
+}
+
+
+/**
+  Apply the events of a group in the coordinator, after the workers
+  are idle.
+
+  Called with rli->data_lock held, returns with it released.
+
+  @return the result of apply_event_and_update_pos() for the event
+  that failed, 0 if all events were applied
+*/
+
+int Rpl_parallel::apply_serially(THD *thd, rpl_group *group)
+{
+  int res= 0;
+
+  if (drain(thd))
+  {
+    mysql_mutex_unlock(&rli->data_lock);
+    free_group(group);
+    return 1;
+  }
+
+  for (uint i= 0; i < group->events.elements; i++)
+  {
+    Log_event *ev= *dynamic_element(&group->events, i, Log_event**);
+    if (!res)
+    {
+      if (i > 0)
+        mysql_mutex_lock(&rli->data_lock);
+      res= apply_event_and_update_pos(ev, thd, rli);
+    }
+    delete ev;
+  }
+  if (!group->events.elements)
+    mysql_mutex_unlock(&rli->data_lock);
+  reset_dynamic(&group->events);
+  free_group(group);
+  return res;
+}
+
+
+/**
+  Check whether a worker of the previous run has committed a group.
+
+  The previous run assigned the group to the worker with the saved
+  number of workers. Each worker commits its groups in relay log
+  order, so the group is committed if it ends at or before the last
+  position the worker recorded.
+*/
+
+bool Rpl_parallel::recovery_skip(rpl_group *group)
+{
+  uint w= group->recovery_worker;
+  if (group->recovery_conflict)
+    return FALSE;
+  return compare_log_pos(group->master_log_name, group->master_log_pos,
+                         recovery.master_log_name[w],
+                         recovery.master_log_pos[w]) <= 0;
+}
+
+
+/**
+  All transactions that the workers of the previous run may have
+  committed are behind us; start recording the positions of the
+  current workers.
+
+  @return TRUE on error, which is reported in rli
+*/
+
+bool Rpl_parallel::end_recovery(THD *thd)
+{
+  recovery.n_workers= 0;
+  lex_start(thd);
+  if (reset_worker_info(thd, n_workers))
+  {
+    report_worker_info_error(thd, "write");
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/**
+  Hand the complete group in @c cur to a worker.
+
+  Called with rli->data_lock held, returns with it released.
+*/
+
+int Rpl_parallel::dispatch(THD *thd)
+{
+  rpl_group *group= cur;
+  const char *old_msg;
+  Slave_worker *w;
+
+  cur= NULL;
+  group->relay_log_pos= rli->event_relay_log_pos;
+  strmake(group->relay_log_name, rli->event_relay_log_name,
+          sizeof(group->relay_log_name) - 1);
+  strmake(group->master_log_name, rli->group_master_log_name,
+          sizeof(group->master_log_name) - 1);
+  /*
+    A group without a table map goes to the first worker. The two are
+    set independently: with slave_parallel_workers = 0 only the worker
+    of the previous run is known.
+  */
+  if (group->worker == UINT_MAX)
+    group->worker= 0;
+  if (group->recovery_worker == UINT_MAX)
+    group->recovery_worker= 0;
+
+  if (recovery.n_workers)
+  {
+    uint last= recovery.last;
+    int cmp= compare_log_pos(group->master_log_name, group->master_log_pos,
+                             recovery.master_log_name[last],
+                             recovery.master_log_pos[last]);
+    if (cmp > 0)
+    {
+      if (end_recovery(thd))
+      {
+        mysql_mutex_unlock(&rli->data_lock);
+        free_group(group);
+        return 1;
+      }
+    }
+    else
+    {
+      int res= 0;
+      if (recovery_skip(group))
+      {
+        for (uint i= 0; i < group->events.elements; i++)
+          delete *dynamic_element(&group->events, i, Log_event**);
+        reset_dynamic(&group->events);
+        group->done= TRUE;
+        group->next= NULL;
+        mysql_mutex_lock(&LOCK_parallel);
+        if (queue_tail)
+          queue_tail->next= group;
+        else
+          queue_head= group;
+        queue_tail= group;
+        mysql_mutex_unlock(&LOCK_parallel);
+        checkpoint();
+      }
+      else
+      {
+        res= apply_serially(thd, group);
+        mysql_mutex_lock(&rli->data_lock);
+      }
+      /* The last group that a worker of the previous run may have done */
+      if (!res && cmp == 0)
+        res= end_recovery(thd);
+      mysql_mutex_unlock(&rli->data_lock);
+      return res;
+    }
+  }
+
+  if (!n_workers || group->conflict)
+    return apply_serially(thd, group);
+
+  mysql_mutex_unlock(&rli->data_lock);
+
+  w= workers[group->worker];
+  mysql_mutex_lock(&LOCK_parallel);
+  if (pending_size + group->size > RPL_PARALLEL_MAX_PENDING_SIZE &&
+      queue_head && !failed)
+  {
+    old_msg= thd->enter_cond(&COND_parallel, &LOCK_parallel,
+                             "Waiting for slave workers to process their "
+                             "queues");
+    while (pending_size + group->size > RPL_PARALLEL_MAX_PENDING_SIZE &&
+           queue_head && !failed)
+      mysql_cond_wait(&COND_parallel, &LOCK_parallel);
+    thd->exit_cond(old_msg);
+    mysql_mutex_lock(&LOCK_parallel);
+  }
+  if (failed)
+  {
+    mysql_mutex_unlock(&LOCK_parallel);
+    free_group(group);
+    return 1;
+  }
+
+  group->next= group->next_in_worker= NULL;
+  if (queue_tail)
+    queue_tail->next= group;
+  else
+    queue_head= group;
+  queue_tail= group;
+  if (w->queue_tail)
+    w->queue_tail->next_in_worker= group;
+  else
+    w->queue_head= group;
+  w->queue_tail= group;
+  pending_size+= group->size;
+  mysql_cond_signal(&w->COND_worker);
+  mysql_mutex_unlock(&LOCK_parallel);
+  return 0;
+}
+
+
+static bool is_row_event(Log_event_type type)
+{
+  return type == TABLE_MAP_EVENT ||
+    (type >= PRE_GA_WRITE_ROWS_EVENT && type <= DELETE_ROWS_EVENT);
+}
+
+
+/**
+  Hash of a database name. The low bits of hash_sort() hardly differ
+  for short names, so they are mixed before the hash is taken modulo
+  the number of workers. The hash must not change between versions:
+  crash recovery maps transactions to the workers of the previous run.
+*/
+
+static uint32 db_hash(const char *db)
+{
+  ulong nr1= 1, nr2= 4;
+  uint32 hash;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (const uchar*) db,
+                                 strlen(db), &nr1, &nr2);
+  hash= (uint32) nr1;
+  hash^= hash >> 16;
+  hash*= 0x85ebca6b;
+  hash^= hash >> 13;
+  hash*= 0xc2b2ae35;
+  hash^= hash >> 16;
+  return hash;
+}
+
+
+/**
+  Schedule an event read by the slave SQL thread.
+
+  Transactions of row events are collected and handed to a worker.
+  For any other event the workers are waited for, so that the caller
+  can apply the event in relay log order.
+
+  Called with rli->data_lock held.
+
+  @retval -1  the caller applies the event, rli->data_lock is held
+  @retval 0   the event was taken over, rli->data_lock is released
+  @retval >0  error, rli->data_lock is released
+*/
+
+int Rpl_parallel::queue_event(THD *thd, Log_event *ev)
+{
+  Log_event_type type= ev->get_type_code();
+  bool group_start= FALSE, group_end= (type == XID_EVENT);
+  int res;
+
+  mysql_mutex_assert_owner(&rli->data_lock);
+
+  if (type == QUERY_EVENT)
+  {
+    Query_log_event *qev= (Query_log_event*) ev;
+    group_start= qev->q_len == 5 && !strncmp(qev->query, "BEGIN", 5);
+    group_end= (qev->q_len == 6 && !strncmp(qev->query, "COMMIT", 6)) ||
+               (qev->q_len == 8 && !strncmp(qev->query, "ROLLBACK", 8));
+  }
+
+  if (cur)
+  {
+    if ((is_row_event(type) || group_end) &&
+        !insert_dynamic(&cur->events, (uchar*) &ev))
+    {
+      if (type == TABLE_MAP_EVENT)
+      {
+        uint32 hash= db_hash(((Table_map_log_event*) ev)->get_db_name());
+        if (n_workers)
+        {
+          uint worker= hash % n_workers;
+          if (cur->worker != UINT_MAX && cur->worker != worker)
+            cur->conflict= TRUE;
+          cur->worker= worker;
+        }
+        if (recovery.n_workers)
+        {
+          uint worker= hash % recovery.n_workers;
+          if (cur->recovery_worker != UINT_MAX &&
+              cur->recovery_worker != worker)
+            cur->recovery_conflict= TRUE;
+          cur->recovery_worker= worker;
+        }
+      }
+      cur->size+= ev->data_written;
+      rli->inc_event_relay_log_pos();
+      if (group_end)
+      {
+        cur->master_log_pos= ev->log_pos;
+        cur->when= ev->when;
+        return dispatch(thd);
+      }
+      if (cur->size > RPL_PARALLEL_MAX_PENDING_SIZE)
+      {
+        rpl_group *group= cur;
+        cur= NULL;
+        return apply_serially(thd, group);
+      }
+      mysql_mutex_unlock(&rli->data_lock);
+      return 0;
+    }
+
+    /*
+      A statement, or an event that describes the relay log, within
+      the transaction: the rest of it is applied by the coordinator.
+    */
+    rpl_group *group= cur;
+    cur= NULL;
+    if ((res= apply_serially(thd, group)))
+    {
+      delete ev;
+      return res;
+    }
+    mysql_mutex_lock(&rli->data_lock);
+    return -1;
+  }
+
+  if (group_start && (n_workers || recovery.n_workers) &&
+      !rli->slave_skip_counter &&
+      rli->until_condition == Relay_log_info::UNTIL_NONE)
+  {
+    if (!(cur= (rpl_group*) my_malloc(sizeof(rpl_group),
+                                      MYF(MY_WME | MY_ZEROFILL))))
+      goto serial;
+    if (my_init_dynamic_array(&cur->events, sizeof(Log_event*), 16, 16) ||
+        insert_dynamic(&cur->events, (uchar*) &ev))
+    {
+      delete_dynamic(&cur->events);
+      my_free(cur);
+      cur= NULL;
+      goto serial;
+    }
+    cur->worker= cur->recovery_worker= UINT_MAX;
+    cur->size= ev->data_written;
+    rli->inc_event_relay_log_pos();
+    mysql_mutex_unlock(&rli->data_lock);
+    return 0;
+  }
+
+serial:
+  if (drain(thd))
+  {
+    mysql_mutex_unlock(&rli->data_lock);
+    delete ev;
+    return 1;
+  }
+  return -1;
+}
+
+
+/**
+  Called by a worker: wait for the next group assigned to it.
+
+  @return the group, or NULL if the worker has to exit
+*/
+
+rpl_group *Rpl_parallel::wait_for_group(Slave_worker *w)
+{
+  const char *old_msg;
+  rpl_group *group;
+
+  mysql_mutex_lock(&LOCK_parallel);
+  old_msg= w->thd->enter_cond(&w->COND_worker, &LOCK_parallel,
+                              "Waiting for an event from the coordinator");
+  while (!(group= w->queue_head) && !w->stop)
+    mysql_cond_wait(&w->COND_worker, &LOCK_parallel);
+  if (group)
+  {
+    w->queue_head= group->next_in_worker;
+    if (!w->queue_head)
+      w->queue_tail= NULL;
+  }
+  w->thd->exit_cond(old_msg);
+  return group;
+}
+
+
+/**
+  Called by a worker when it has applied a group.
+
+  If the worker failed, the coordinator is woken up so that the slave
+  stops with the error the worker reported.
+*/
+
+void Rpl_parallel::group_done(rpl_group *group, bool failed_arg)
+{
+  mysql_mutex_lock(&LOCK_parallel);
+  pending_size-= group->size;
+  if (failed_arg)
+    failed= TRUE;
+  else
+    group->done= TRUE;
+  mysql_cond_broadcast(&COND_parallel);
+  mysql_mutex_unlock(&LOCK_parallel);
+
+  if (failed_arg)
+  {
+    /*
+      The coordinator may wait for the relay log to grow. It checks
+      abort_slave under data_lock and takes the log lock before it
+      releases data_lock to wait, so the signal below is not lost.
+    */
+    mysql_mutex_t *log_lock= rli->relay_log.get_log_lock();
+    mysql_mutex_lock(&rli->data_lock);
+    rli->abort_slave= 1;
+    mysql_mutex_unlock(&rli->data_lock);
+    mysql_mutex_lock(log_lock);
+    rli->relay_log.signal_update();
+    mysql_mutex_unlock(log_lock);
+    return;
+  }
+
+  mysql_mutex_lock(&rli->data_lock);
+  checkpoint();
+  mysql_mutex_unlock(&rli->data_lock);
+}
+
+
+/**
+  Start the workers of the slave SQL thread, if it runs in parallel.
+
+  The coordinator is also needed with slave_parallel_workers = 0 if
+  the workers of the previous run left transactions to be skipped.
+*/
+
+bool rpl_parallel_init(Relay_log_info *rli, THD *thd)
+{
+  uint n_workers= (uint) opt_slave_parallel_workers;
+
+  rli->parallel= new Rpl_parallel(rli, n_workers);
+  if (rli->parallel->start(thd))
+  {
+    delete rli->parallel;
+    rli->parallel= NULL;
+    return TRUE;
+  }
+  if (!n_workers && !rli->parallel->recovering())
+    rpl_parallel_end(rli, thd);
+  return FALSE;
+}
+
+
+void rpl_parallel_end(Relay_log_info *rli, THD *thd)
+{
+  if (rli->parallel)
+  {
+    rli->parallel->stop(thd);
+    delete rli->parallel;
+    rli->parallel= NULL;
+  }
+}
+
+#endif /* HAVE_REPLICATION */
@@ -0,0 +1,194 @@
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef RPL_PARALLEL_H
+#define RPL_PARALLEL_H
+
+/**
+  @addtogroup Replication
+  @{
+
+  @file
+
+  Parallel execution of the replication events by the slave SQL thread.
+
+  With slave_parallel_workers > 0 the slave SQL thread becomes a
+  coordinator. It reads the relay log as before, but instead of
+  applying a transaction itself it buffers the events of the
+  transaction (BEGIN ... COMMIT/XID) and hands them to one of the
+  worker threads. The worker is chosen by the databases of the tables
+  the transaction modifies, so transactions on different databases are
+  applied concurrently while transactions on the same database are
+  applied in the order of the master.
+
+  Only transactions that consist solely of row events can be
+  scheduled this way: a statement in the binary log of a 5.5 master
+  does not tell which databases it modifies. Everything else -
+  statements, DDL, LOAD DATA, the events that describe or rotate the
+  relay log, and transactions that touch databases of more than one
+  worker - is a barrier: the coordinator waits until the workers are
+  idle and then applies the events itself, exactly as the serial slave
+  does.
+
+  The coordinator keeps the dispatched transactions in a queue in
+  relay log order. When the transactions at the head of the queue are
+  done, the group coordinates of Relay_log_info move past them and are
+  written to relay-log.info, so relay-log.info always describes a
+  point before which everything has been applied (the low-water mark).
+
+  A transaction after the low-water mark may already be applied by a
+  worker when the server crashes. Every worker therefore records the
+  master position of the last transaction it committed in its row of
+  the table mysql.slave_worker_info. The worker updates the row just
+  before the event that commits the transaction, so the position is
+  committed together with the changes of the transaction. On restart
+  the coordinator skips those transactions after the low-water mark
+  that the worker they were assigned to has already committed.
+
+  The table is an InnoDB table, so this holds for transactions on
+  transactional tables. Changes to non-transactional tables are not
+  undone by a crash before the commit, and such a transaction is
+  applied again on restart, as by the serial slave.
+*/
+
+#ifdef HAVE_REPLICATION
+
+#include "my_global.h"
+#include "rpl_rli.h"
+
+class Log_event;
+class Slave_worker;
+
+/** Upper limit for slave_parallel_workers */
+#define RPL_PARALLEL_MAX_WORKERS 1024
+
+/**
+  The most memory that the coordinator spends on transactions that
+  are not applied yet. A single transaction that is larger is applied
+  by the coordinator itself.
+*/
+#define RPL_PARALLEL_MAX_PENDING_SIZE (16*1024*1024)
+
+/**
+  A transaction read by the coordinator and applied by a worker.
+*/
+
+struct rpl_group
+{
+  /** Next group in the queue of the worker */
+  rpl_group *next_in_worker;
+  /** Next group in relay log order */
+  rpl_group *next;
+  /** The events of the transaction, Log_event* */
+  DYNAMIC_ARRAY events;
+  /** Bytes in the events */
+  ulong size;
+  /** Worker for slave_parallel_workers, or UINT_MAX if not known yet */
+  uint worker;
+  /** Worker for the saved number of workers, see Rpl_parallel::recovery */
+  uint recovery_worker;
+  /** Modifies databases of more than one worker */
+  bool conflict, recovery_conflict;
+  /** Applied and committed by the worker */
+  bool done;
+  /* Coordinates of the end of the transaction */
+  char relay_log_name[FN_REFLEN];
+  ulonglong relay_log_pos;
+  char master_log_name[FN_REFLEN];
+  ulonglong master_log_pos;
+  /** Timestamp of the last event, for Seconds_Behind_Master */
+  time_t when;
+};
+
+
+/**
+  Coordinator of the worker threads, owned by the slave SQL thread
+  while it runs.
+*/
+
+class Rpl_parallel
+{
+public:
+  Rpl_parallel(Relay_log_info *rli_arg, uint n_workers_arg);
+  ~Rpl_parallel();
+
+  bool start(THD *thd);
+  void stop(THD *thd);
+  int queue_event(THD *thd, Log_event *ev);
+
+  /* Called by the workers */
+  void group_done(rpl_group *group, bool failed_arg);
+  rpl_group *wait_for_group(Slave_worker *w);
+  uint workers_count() const { return n_workers; }
+  bool recovering() const { return recovery.n_workers != 0; }
+
+  Relay_log_info *rli;
+  mysql_mutex_t LOCK_parallel;
+  /** Signalled when a group is done and when a worker starts or stops */
+  mysql_cond_t COND_parallel;
+
+private:
+  uint n_workers;
+  Slave_worker **workers;
+
+  /** The group that is being read, if any */
+  rpl_group *cur;
+  /** Queue of dispatched groups in relay log order */
+  rpl_group *queue_head, *queue_tail;
+  /** Bytes in the dispatched groups that are not done */
+  ulong pending_size;
+  /** A worker failed, the slave stops */
+  bool failed;
+
+  /**
+    Crash recovery state. While recovering, the positions of the last
+    transactions that the workers of the previous run committed are
+    known, and transactions up to those positions are either skipped
+    or applied by the coordinator.
+  */
+  struct recovery_info
+  {
+    uint n_workers;
+    /** The worker with the highest position */
+    uint last;
+    char (*master_log_name)[FN_REFLEN];
+    ulonglong *master_log_pos;
+  } recovery;
+
+  void checkpoint();
+  int drain(THD *thd);
+  int apply_serially(THD *thd, rpl_group *group);
+  int dispatch(THD *thd);
+  bool read_worker_info(THD *thd);
+  void report_worker_info_error(THD *thd, const char *what);
+  bool recovery_skip(rpl_group *group);
+  bool end_recovery(THD *thd);
+  void free_group(rpl_group *group);
+};
+
+#ifdef HAVE_PSI_INTERFACE
+void init_rpl_parallel_psi_keys();
+#endif
+bool rpl_parallel_init(Relay_log_info *rli, THD *thd);
+void rpl_parallel_end(Relay_log_info *rli, THD *thd);
+bool rpl_parallel_remove_worker_info(THD *thd);
+
+#endif /* HAVE_REPLICATION */
+
+/**
+  @} (end of group Replication)
+*/
+
+#endif /* RPL_PARALLEL_H */
@@ -24,6 +24,7 @@
 
 struct RPL_TABLE_LIST;
 class Master_info;
+class Rpl_parallel;
 extern uint sql_slave_skip_counter;
 
 /****************************************************************************
@@ -409,6 +410,12 @@ public:
   */
   bool deferred_events_collecting;
 
+  /*
+    The worker threads while the SQL thread runs with
+    slave_parallel_workers > 0, otherwise NULL.
+  */
+  Rpl_parallel *parallel;
+
   /* 
      Returns true if the argument event resides in the containter;
      more specifically, the checking is done against the last added event.
@@ -66,12 +66,23 @@ enum scheduler_types
   */
   SCHEDULER_ONE_THREAD_PER_CONNECTION=0,
   SCHEDULER_NO_THREADS,
+  SCHEDULER_POOL_OF_THREADS,
   SCHEDULER_TYPES_COUNT
 };
 
+void scheduler_init();
 void one_thread_per_connection_scheduler();
 void one_thread_scheduler();
 
+/*
+  The pool-of-threads scheduler is based on epoll and is not available
+  in the embedded server.
+*/
+#if defined(HAVE_SYS_EPOLL_H) && !defined(EMBEDDED_LIBRARY)
+#define HAVE_POOL_OF_THREADS 1
+void pool_of_threads_scheduler();
+#endif
+
 /*
  To be used for pool-of-threads (implemeneted differently on various OSs)
 */
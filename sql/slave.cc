@@ -31,6 +31,7 @@
 #include "sql_table.h"                         // mysql_rm_table
 #include "rpl_mi.h"
 #include "rpl_rli.h"
+#include "rpl_parallel.h"
 #include "sql_repl.h"
 #include "rpl_filter.h"
 #include "repl_failsafe.h"
@@ -59,7 +60,6 @@
 
 #define FLAGSTR(V,F) ((V)&(F)?#F" ":"")
 
-#define MAX_SLAVE_RETRY_PAUSE 5
 /*
   a parameter of sql_slave_killed() to defer the killed status
 */
@@ -136,14 +136,12 @@ failed read"
 };
  
 
-typedef enum { SLAVE_THD_IO, SLAVE_THD_SQL} SLAVE_THD_TYPE;
 
 static int process_io_rotate(Master_info* mi, Rotate_log_event* rev);
 static int process_io_create_file(Master_info* mi, Create_file_log_event* cev);
 static bool wait_for_relay_log_space(Relay_log_info* rli);
 static inline bool io_slave_killed(THD* thd,Master_info* mi);
 static inline bool sql_slave_killed(THD* thd,Relay_log_info* rli);
-static int init_slave_thread(THD* thd, SLAVE_THD_TYPE thd_type);
 static void print_slave_skip_errors(void);
 static int safe_connect(THD* thd, MYSQL* mysql, Master_info* mi);
 static int safe_reconnect(THD* thd, MYSQL* mysql, Master_info* mi,
@@ -273,6 +271,8 @@ static void init_slave_psi_keys(void)
 
   count= array_elements(all_slave_threads);
   PSI_server->register_thread(category, all_slave_threads, count);
+
+  init_rpl_parallel_psi_keys();
 }
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -2096,7 +2096,7 @@ void set_slave_thread_default_charset(THD* thd, Relay_log_info const *rli)
   init_slave_thread()
 */
 
-static int init_slave_thread(THD* thd, SLAVE_THD_TYPE thd_type)
+int init_slave_thread(THD* thd, SLAVE_THD_TYPE thd_type)
 {
   DBUG_ENTER("init_slave_thread");
 #if !defined(DBUG_OFF)
@@ -2289,7 +2289,7 @@ static ulong read_event(MYSQL* mysql, Master_info *mi, bool* suppress_warnings)
   that the error is temporary by pushing a warning with the error code
   ER_GET_TEMPORARY_ERRMSG, if the originating error is temporary.
 */
-static int has_temporary_error(THD *thd)
+int has_temporary_error(THD *thd)
 {
   DBUG_ENTER("has_temporary_error");
 
@@ -2576,18 +2576,28 @@ static int exec_relay_log_event(THD* thd, Relay_log_info* rli)
                       };);
     }
 
-    exec_res= apply_event_and_update_pos(ev, thd, rli);
-
     /*
-      Format_description_log_event should not be deleted because it will be
-      used to read info about the relay log's format; it will be deleted when
-      the SQL thread does not need it, i.e. when this thread terminates.
+      With slave_parallel_workers the event is either queued for a
+      worker, or the workers are waited for and the event is applied
+      below, see Rpl_parallel::queue_event().
     */
-    if (ev->get_type_code() != FORMAT_DESCRIPTION_EVENT &&
-        !rli->is_deferred_event(ev))
+    if (!rli->parallel ||
+        (exec_res= rli->parallel->queue_event(thd, ev)) < 0)
     {
-      DBUG_PRINT("info", ("Deleting the event after it has been executed"));
-      delete ev;
+      exec_res= apply_event_and_update_pos(ev, thd, rli);
+
+      /*
+        Format_description_log_event should not be deleted because it will
+        be used to read info about the relay log's format; it will be
+        deleted when the SQL thread does not need it, i.e. when this thread
+        terminates.
+      */
+      if (ev->get_type_code() != FORMAT_DESCRIPTION_EVENT &&
+          !rli->is_deferred_event(ev))
+      {
+        DBUG_PRINT("info", ("Deleting the event after it has been executed"));
+        delete ev;
+      }
     }
 
     /*
@@ -3350,6 +3360,10 @@ log '%s' at position %s, relay log '%s' position: %s", RPL_LOG_NAME,
     }
   }
 
+  /* Start the worker threads for slave_parallel_workers */
+  if (rpl_parallel_init(rli, thd))
+    goto err;
+
   /*
     First check until condition - probably there is nothing to execute. We
     do not want to wait for next event in this case.
@@ -3482,6 +3496,12 @@ the slave SQL thread with \"SLAVE START\". We stopped at log \
   */
   thd->clear_error();
   rli->cleanup_context(thd, 1);
+  /*
+    Let the workers finish the transactions queued for them. This comes
+    after the transaction of the SQL thread is rolled back, as the
+    worker information table is updated in a transaction of its own.
+  */
+  rpl_parallel_end(rli, thd);
   /*
     Some extra safety, which should not been needed (normally, event deletion
     should already have done these assignments (each event which sets these
@@ -4302,8 +4322,8 @@ static int connect_to_master(THD* thd, MYSQL* mysql, Master_info* mi,
   mysql_options(mysql, MYSQL_SET_CHARSET_DIR, (char *) charsets_dir);
 
   /* Set MYSQL_PLUGIN_DIR in case master asks for an external authentication plugin */
-  if (opt_plugin_dir_ptr && *opt_plugin_dir_ptr)
-    mysql_options(mysql, MYSQL_PLUGIN_DIR, opt_plugin_dir_ptr);
+  if (opt_plugin_dir_ptr && *opt_plugin_dir_ptr)
+    mysql_options(mysql, MYSQL_PLUGIN_DIR, opt_plugin_dir_ptr);
 
   /* we disallow empty users */
   if (mi->user == NULL || mi->user[0] == 0)
@@ -44,10 +44,15 @@
 
 #define MAX_SLAVE_ERROR    2000
 
+/* Longest pause in seconds before a transaction is retried */
+#define MAX_SLAVE_RETRY_PAUSE 5
+
 // Forward declarations
 class Relay_log_info;
 class Master_info;
 
+typedef enum { SLAVE_THD_IO, SLAVE_THD_SQL} SLAVE_THD_TYPE;
+
 
 /*****************************************************************************
 
@@ -207,6 +212,8 @@ void set_slave_thread_options(THD* thd);
 void set_slave_thread_default_charset(THD *thd, Relay_log_info const *rli);
 int rotate_relay_log(Master_info* mi);
 int apply_event_and_update_pos(Log_event* ev, THD* thd, Relay_log_info* rli);
+int init_slave_thread(THD* thd, SLAVE_THD_TYPE thd_type);
+int has_temporary_error(THD *thd);
 
 pthread_handler_t handle_slave_io(void *arg);
 pthread_handler_t handle_slave_sql(void *arg);
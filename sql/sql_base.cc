@@ -6143,7 +6143,8 @@ find_field_in_view(THD *thd, TABLE_LIST *table_list,
   Query_arena *arena= 0, backup;  
   
   DBUG_ASSERT(table_list->schema_table_reformed ||
-              (ref != 0 && table_list->view != 0));
+              (ref != 0 && (table_list->view != 0 ||
+                            table_list->is_merged_derived())));
   for (; !field_it.end_of_fields(); field_it.next())
   {
     if (!my_strcasecmp(system_charset_info, field_it.name(), name))
@@ -7992,7 +7993,7 @@ TABLE_LIST **make_leaves_list(TABLE_LIST **list, TABLE_LIST *tables)
   {
     if (table->merge_underlying_list)
     {
-      DBUG_ASSERT(table->view &&
+      DBUG_ASSERT((table->view || table->is_merged_derived()) &&
                   table->effective_algorithm == VIEW_ALGORITHM_MERGE);
       list= make_leaves_list(list, table->merge_underlying_list);
     }
@@ -8081,7 +8082,7 @@ bool setup_tables(THD *thd, Name_resolution_context *context,
   {
     if (table_list->merge_underlying_list)
     {
-      DBUG_ASSERT(table_list->view &&
+      DBUG_ASSERT((table_list->view || table_list->is_merged_derived()) &&
                   table_list->effective_algorithm == VIEW_ALGORITHM_MERGE);
       Query_arena *arena= thd->stmt_arena, backup;
       bool res;
@@ -8295,7 +8296,8 @@ insert_fields(THD *thd, Name_resolution_context *context, const char *db_name,
        for TABLE_LIST.
     */
     if (!((table && !tables->view && (table->grant.privilege & SELECT_ACL)) ||
-          (tables->view && (tables->grant.privilege & SELECT_ACL))) &&
+          ((tables->view || tables->is_merged_derived()) &&
+           (tables->grant.privilege & SELECT_ACL))) &&
         !any_privileges)
     {
       field_iterator.set(tables);
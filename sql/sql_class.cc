@@ -3361,6 +3361,7 @@ void TMP_TABLE_PARAM::init()
   quick_group= 1;
   table_charset= 0;
   precomputed_group_by= 0;
+  derived_key_map= 0;
   DBUG_VOID_RETURN;
 }
 
@@ -450,6 +450,7 @@ typedef struct system_variables
   ulong read_rnd_buff_size;
   ulong div_precincrement;
   ulong sortbuff_size;
+  ulong sort_threads;
   ulong max_sp_recursion_depth;
   ulong default_week_format;
   ulong max_seeks_for_key;
@@ -564,6 +565,7 @@ typedef struct system_status_var
   ulong filesort_range_count;
   ulong filesort_rows;
   ulong filesort_scan_count;
+  ulong filesort_pq_sorts;
   /* Prepared statements and binary protocol */
   ulong com_stmt_prepare;
   ulong com_stmt_reprepare;
@@ -3288,11 +3290,17 @@ public:
   */
   bool precomputed_group_by;
   bool force_copy_fields;
+  /*
+    Bitmap of the columns of a materialized derived table that get a
+    non-unique key, in column order (see create_tmp_table)
+  */
+  ulonglong derived_key_map;
 
   TMP_TABLE_PARAM()
     :copy_field(0), group_parts(0),
      group_length(0), group_null_parts(0), convert_blob_length(0),
-     schema_table(0), precomputed_group_by(0), force_copy_fields(0)
+     schema_table(0), precomputed_group_by(0), force_copy_fields(0),
+     derived_key_map(0)
   {}
   ~TMP_TABLE_PARAM()
   {
@@ -3311,8 +3319,8 @@ public:
 
 class select_union :public select_result_interceptor
 {
-  TMP_TABLE_PARAM tmp_table_param;
 public:
+  TMP_TABLE_PARAM tmp_table_param;
   TABLE *table;
 
   select_union() :table(0) {}
@@ -3323,7 +3331,8 @@ public:
 
   bool create_result_table(THD *thd, List<Item> *column_types,
                            bool is_distinct, ulonglong options,
-                           const char *alias);
+                           const char *alias, ORDER *group= NULL,
+                           ulonglong key_map= 0);
 };
 
 /* Base subselect interface class */
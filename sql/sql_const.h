@@ -69,6 +69,7 @@
 
 #define MAX_SORT_MEMORY 2048*1024
 #define MIN_SORT_MEMORY 32*1024
+#define MAX_SORT_THREADS 64
 
 /* Some portable defines */
 
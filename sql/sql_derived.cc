@@ -77,6 +77,262 @@ out:
 }
 
 
+/**
+  Check whether a join tree contains a NATURAL JOIN or a JOIN ... USING.
+*/
+
+static bool join_list_has_natural_join(List<TABLE_LIST> *join_list)
+{
+  List_iterator_fast<TABLE_LIST> li(*join_list);
+  TABLE_LIST *tbl;
+  while ((tbl= li++))
+  {
+    if (tbl->natural_join || tbl->is_natural_join || tbl->join_using_fields)
+      return TRUE;
+    if (tbl->nested_join &&
+        join_list_has_natural_join(&tbl->nested_join->join_list))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+
+/**
+  Check whether a derived table can be merged into the outer query.
+
+  @details
+  Only a plain SELECT of a SELECT statement is merged: no UNION, grouping,
+  aggregates, DISTINCT, ORDER BY or LIMIT, no side effects and no derived
+  tables or subqueries of its own other than in WHERE and ON. A derived
+  table on the inner side of an outer join must return plain columns only,
+  because an expression would not become NULL for the NULL-complemented
+  rows.
+
+  @return TRUE if the derived table can be merged
+*/
+
+static bool derived_can_be_merged(THD *thd, LEX *lex, TABLE_LIST *derived)
+{
+  SELECT_LEX_UNIT *unit= derived->derived;
+  SELECT_LEX *select= unit->first_select();
+
+  if (!optimizer_flag(thd, OPTIMIZER_SWITCH_DERIVED_MERGE) ||
+      lex->sql_command != SQLCOM_SELECT || derived->view ||
+      unit->is_union() || unit->fake_select_lex ||
+      select->group_list.elements || select->having ||
+      select->with_sum_func || select->order_list.elements ||
+      select->select_limit || select->offset_limit ||
+      (select->options & (SELECT_DISTINCT | OPTION_FOUND_ROWS)) ||
+      (select->uncacheable & (UNCACHEABLE_RAND | UNCACHEABLE_SIDEEFFECT)) ||
+      !select->table_list.elements)
+    return FALSE;
+
+  for (SELECT_LEX_UNIT *inner= select->first_inner_unit();
+       inner;
+       inner= inner->next_unit())
+  {
+    if (!inner->item ||
+        (inner->item->place() != IN_WHERE && inner->item->place() != IN_ON))
+      return FALSE;
+  }
+
+  if (join_list_has_natural_join(&select->top_join_list) ||
+      join_list_has_natural_join(&derived->select_lex->top_join_list))
+    return FALSE;
+
+  for (TABLE_LIST *emb= derived; emb; emb= emb->embedding)
+  {
+    if (emb->outer_join)
+    {
+      List_iterator_fast<Item> it(select->item_list);
+      Item *item;
+      while ((item= it++))
+      {
+        if (item->type() != Item::FIELD_ITEM)
+          return FALSE;
+      }
+      for (TABLE_LIST *tbl= select->get_table_list(); tbl;
+           tbl= tbl->next_local)
+      {
+        if (tbl->view || tbl->derived)
+          return FALSE;
+      }
+      break;
+    }
+  }
+  return TRUE;
+}
+
+
+/**
+  Merge a derived table into the SELECT that it belongs to.
+
+  @details
+  This is done the way a view with the MERGE algorithm is merged (see
+  mysql_make_view()): the tables of the derived table become a nested join
+  of the outer SELECT, its WHERE clause is added to the outer one by
+  TABLE_LIST::prep_where() and its columns are resolved through
+  TABLE_LIST::field_translation. The SELECT of the derived table is left in
+  the global SELECT list, so that mysql_handle_derived() still processes
+  its tables, but is no longer executed.
+
+  @return
+    false  OK
+    true   Error
+*/
+
+static bool mysql_derived_merge(THD *thd, TABLE_LIST *derived)
+{
+  SELECT_LEX_UNIT *unit= derived->derived;
+  SELECT_LEX *select= unit->first_select();
+  SELECT_LEX *parent= derived->select_lex;
+  TABLE_LIST *tables= select->get_table_list();
+  Query_arena *arena, backup;
+  NESTED_JOIN *nested_join;
+  DBUG_ENTER("mysql_derived_merge");
+
+  arena= thd->activate_stmt_arena_if_needed(&backup);
+  if (!(nested_join= derived->nested_join=
+        (NESTED_JOIN *) thd->calloc(sizeof(NESTED_JOIN))))
+  {
+    if (arena)
+      thd->restore_active_arena(arena, &backup);
+    DBUG_RETURN(TRUE);
+  }
+  /* re-nest tables of the derived table */
+  nested_join->join_list.empty();
+  List_iterator_fast<TABLE_LIST> ti(select->top_join_list);
+  TABLE_LIST *tbl;
+  while ((tbl= ti++))
+  {
+    if (nested_join->join_list.push_back(tbl))
+    {
+      if (arena)
+        thd->restore_active_arena(arena, &backup);
+      DBUG_RETURN(TRUE);
+    }
+    tbl->join_list= &nested_join->join_list;
+    tbl->embedding= derived;
+  }
+  for (tbl= tables; tbl; tbl= tbl->next_local)
+    tbl->select_lex= parent;
+
+  derived->effective_algorithm= VIEW_ALGORITHM_MERGE;
+  derived->merge_underlying_list= tables;
+  derived->where= select->where;
+  derived->db= (char *)"";
+  derived->db_length= 0;
+  derived->table_name= (char *) derived->alias;
+  derived->table_name_length= strlen(derived->alias);
+#ifndef NO_EMBEDDED_ACCESS_CHECKS
+  derived->grant.privilege= SELECT_ACL;
+#endif
+
+  /* prepare the context of the derived table for the outer SELECT */
+  select->context.resolve_in_table_list_only(tables);
+  select->context.outer_context= 0;
+  select->context.select_lex= parent;
+  parent->select_n_where_fields+= select->select_n_where_fields;
+  parent->n_child_sum_items+= select->n_child_sum_items;
+
+  /* move subqueries to the outer SELECT and drop the derived table unit */
+  unit->exclude_level(TRUE);
+
+  if (arena)
+    thd->restore_active_arena(arena, &backup);
+  DBUG_RETURN(FALSE);
+}
+
+
+/**
+  Mark a column of a derived table that an equality compares to a constant
+  or to a column of another table.
+*/
+
+static void mark_derived_key_column(Item *cond, TABLE_LIST *derived,
+                                    ulonglong *key_map)
+{
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond *) cond)->functype() == Item_func::COND_AND_FUNC)
+  {
+    List_iterator_fast<Item> li(*((Item_cond *) cond)->argument_list());
+    Item *item;
+    while ((item= li++))
+      mark_derived_key_column(item, derived, key_map);
+    return;
+  }
+  if (cond->type() != Item::FUNC_ITEM ||
+      ((Item_func *) cond)->functype() != Item_func::EQ_FUNC)
+    return;
+
+  Item **args= ((Item_func *) cond)->arguments();
+  for (uint i= 0; i < 2; i++)
+  {
+    Item_field *column= (Item_field *) args[i];
+    Item *other= args[1 - i];
+    if (column->type() != Item::FIELD_ITEM || !column->table_name ||
+        my_strcasecmp(table_alias_charset, column->table_name,
+                      derived->alias))
+      continue;
+    if (!other->basic_const_item() &&
+        (other->type() != Item::FIELD_ITEM ||
+         !((Item_field *) other)->table_name ||
+         !my_strcasecmp(table_alias_charset,
+                        ((Item_field *) other)->table_name, derived->alias)))
+      continue;
+
+    List_iterator_fast<Item> it(derived->derived->types);
+    Item *item;
+    for (uint col= 0; (item= it++) && col < 64; col++)
+    {
+      if (item->name &&
+          !my_strcasecmp(system_charset_info, item->name, column->field_name))
+      {
+        *key_map|= 1ULL << col;
+        break;
+      }
+    }
+  }
+}
+
+
+static void mark_derived_key_columns(List<TABLE_LIST> *join_list,
+                                     TABLE_LIST *derived, ulonglong *key_map)
+{
+  List_iterator_fast<TABLE_LIST> li(*join_list);
+  TABLE_LIST *tbl;
+  while ((tbl= li++))
+  {
+    if (tbl->on_expr)
+      mark_derived_key_column(tbl->on_expr, derived, key_map);
+    if (tbl->nested_join)
+      mark_derived_key_columns(&tbl->nested_join->join_list, derived, key_map);
+  }
+}
+
+
+/**
+  Find the columns of a materialized derived table that the outer SELECT
+  compares with '=' to constants or columns of other tables in its WHERE
+  and ON clauses. The temporary table gets a key over these columns.
+
+  @return bitmap of the columns, in the order of the select list
+*/
+
+static ulonglong derived_key_columns(THD *thd, TABLE_LIST *derived)
+{
+  ulonglong key_map= 0;
+  SELECT_LEX *parent= derived->select_lex;
+
+  if (!optimizer_flag(thd, OPTIMIZER_SWITCH_DERIVED_WITH_KEYS) || !parent)
+    return 0;
+  if (parent->where)
+    mark_derived_key_column(parent->where, derived, &key_map);
+  mark_derived_key_columns(&parent->top_join_list, derived, &key_map);
+  return key_map;
+}
+
+
 /**
   @brief Create temporary table structure (but do not fill it).
 
@@ -93,7 +349,11 @@ out:
   - Named derived tables (aka views) with the @c TEMPTABLE algorithm.
    
   The table reference, contained in @c orig_table_list, is updated with the
-  fields of a new temporary table.
+  fields of a new temporary table. If the @c derived_merge optimizer switch
+  allows it, an anonymous derived table is instead merged into the outer
+  query like a view (see mysql_derived_merge()) and no temporary table is
+  created. With the @c derived_with_keys switch, the temporary table gets a
+  key over the columns the outer query looks it up by.
 
   Derived tables are stored in @c thd->derived_tables and closed by
   close_thread_tables().
@@ -144,10 +404,20 @@ bool mysql_derived_prepare(THD *thd, LEX *lex, TABLE_LIST *orig_table_list)
     TABLE *table= 0;
     select_union *derived_result;
 
+    /* A derived table merged at an earlier execution stays merged */
+    if (orig_table_list->is_merged_derived())
+    {
+      orig_table_list->set_underlying_merge();
+      DBUG_RETURN(FALSE);
+    }
+
     /* prevent name resolving out of derived table */
     for (SELECT_LEX *sl= first_select; sl; sl= sl->next_select())
       sl->context.outer_context= 0;
 
+    if (derived_can_be_merged(thd, lex, orig_table_list))
+      DBUG_RETURN(mysql_derived_merge(thd, orig_table_list));
+
     if (!(derived_result= new select_union))
       DBUG_RETURN(TRUE); // out of memory
 
@@ -173,7 +443,10 @@ bool mysql_derived_prepare(THD *thd, LEX *lex, TABLE_LIST *orig_table_list)
     */
     if ((res= derived_result->create_result_table(thd, &unit->types, FALSE,
                                                  create_options,
-                                                 orig_table_list->alias)))
+                                                 orig_table_list->alias,
+                                                 NULL,
+                                                 derived_key_columns(thd,
+                                                   orig_table_list))))
       goto exit;
 
     table= derived_result->table;
@@ -321,7 +594,8 @@ bool mysql_derived_filling(THD *thd, LEX *lex, TABLE_LIST *orig_table_list)
 bool mysql_derived_cleanup(THD *thd, LEX *lex, TABLE_LIST *derived)
 {
   SELECT_LEX_UNIT *unit= derived->derived;
-  if (unit)
+  /* The SELECT of a merged derived table is executed by the outer one */
+  if (unit && !derived->is_merged_derived())
     unit->cleanup();
   return false;
 }
@@ -1903,17 +1903,22 @@ void st_select_lex_node::exclude()
 
   SYNOPSYS
     st_select_lex_unit::exclude_level()
+    keep_global_list    do not unlink the SELECTs of the level from the
+                        global SELECT_LEX list (used for merged derived
+                        tables, whose tables mysql_handle_derived() must
+                        still process)
 
   NOTE: units which belong to current will be brought up on level of
   currernt unit 
 */
-void st_select_lex_unit::exclude_level()
+void st_select_lex_unit::exclude_level(bool keep_global_list)
 {
   SELECT_LEX_UNIT *units= 0, **units_last= &units;
   for (SELECT_LEX *sl= first_select(); sl; sl= sl->next_select())
   {
     // unlink current level from global SELECTs list
-    if (sl->link_prev && (*sl->link_prev= sl->link_next))
+    if (!keep_global_list &&
+        sl->link_prev && (*sl->link_prev= sl->link_next))
       sl->link_next->link_prev= sl->link_prev;
 
     // bring up underlay levels
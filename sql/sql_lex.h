@@ -649,7 +649,7 @@ public:
     return reinterpret_cast<st_select_lex_unit*>(next);
   }
   st_select_lex* return_after_parsing() { return return_to; }
-  void exclude_level();
+  void exclude_level(bool keep_global_list= FALSE);
   void exclude_tree();
 
   /* UNION methods */
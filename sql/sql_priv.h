@@ -227,14 +227,21 @@ template <class T> bool valid_buffer_range(T jump,
 #define OPTIMIZER_SWITCH_INDEX_MERGE_SORT_UNION    (1ULL << 2)
 #define OPTIMIZER_SWITCH_INDEX_MERGE_INTERSECT     (1ULL << 3)
 #define OPTIMIZER_SWITCH_ENGINE_CONDITION_PUSHDOWN (1ULL << 4)
-#define OPTIMIZER_SWITCH_LAST                      (1ULL << 5)
+#define OPTIMIZER_SWITCH_BKA                       (1ULL << 5)
+#define OPTIMIZER_SWITCH_INDEX_CONDITION_PUSHDOWN  (1ULL << 6)
+#define OPTIMIZER_SWITCH_HASH_JOIN                 (1ULL << 7)
+#define OPTIMIZER_SWITCH_MATERIALIZATION           (1ULL << 8)
+#define OPTIMIZER_SWITCH_DERIVED_MERGE             (1ULL << 9)
+#define OPTIMIZER_SWITCH_DERIVED_WITH_KEYS         (1ULL << 10)
+#define OPTIMIZER_SWITCH_LAST                      (1ULL << 11)
 
 /* The following must be kept in sync with optimizer_switch_str in mysqld.cc */
 #define OPTIMIZER_SWITCH_DEFAULT (OPTIMIZER_SWITCH_INDEX_MERGE | \
                                   OPTIMIZER_SWITCH_INDEX_MERGE_UNION | \
                                   OPTIMIZER_SWITCH_INDEX_MERGE_SORT_UNION | \
                                   OPTIMIZER_SWITCH_INDEX_MERGE_INTERSECT | \
-                                  OPTIMIZER_SWITCH_ENGINE_CONDITION_PUSHDOWN)
+                                  OPTIMIZER_SWITCH_ENGINE_CONDITION_PUSHDOWN | \
+                                  OPTIMIZER_SWITCH_INDEX_CONDITION_PUSHDOWN)
 
 
 /*
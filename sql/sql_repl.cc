@@ -19,6 +19,7 @@
 #ifdef HAVE_REPLICATION
 
 #include "rpl_mi.h"
+#include "rpl_parallel.h"
 #include "sql_repl.h"
 #include "sql_acl.h"                            // SUPER_ACL
 #include "log_event.h"
@@ -1330,6 +1331,12 @@ int reset_slave(THD *thd, Master_info* mi)
     error=1;
     goto err;
   }
+  // and the positions of the workers of slave_parallel_workers
+  if (rpl_parallel_remove_worker_info(thd))
+  {
+    error=1;
+    goto err;
+  }
 
   RUN_HOOK(binlog_relay_io, after_reset_slave, (thd, mi));
 err:
@@ -1672,8 +1679,11 @@ bool change_master(THD* thd, Master_info* mi)
     before START SLAVE, then old will remain in relay-log.info, and will be the
     in-memory value at restart (thus causing errors, as the old relay log does
     not exist anymore).
+    The positions that the workers of slave_parallel_workers recorded
+    refer to the old coordinates, so they are removed.
   */
   flush_relay_log_info(&mi->rli);
+  rpl_parallel_remove_worker_info(thd);
   mysql_cond_broadcast(&mi->data_cond);
   mysql_mutex_unlock(&mi->rli.data_lock);
 
@@ -101,6 +101,7 @@ C_MODE_END
 static bool find_best(JOIN *join,table_map rest_tables,uint index,
 		      double record_count,double read_time);
 static uint cache_record_length(JOIN *join,uint index);
+static bool hash_join_can_spill(JOIN *join, JOIN_TAB *s, uint idx);
 static double prev_record_reads(JOIN *join, uint idx, table_map found_ref);
 static bool get_best_combination(JOIN *join);
 static store_key *get_store_key(THD *thd,
@@ -150,6 +151,14 @@ evaluate_null_complemented_join_record(JOIN *join, JOIN_TAB *join_tab);
 static enum_nested_loop_state
 flush_cached_records(JOIN *join, JOIN_TAB *join_tab, bool skip_last);
 static enum_nested_loop_state
+flush_cached_records_bka(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state
+flush_cached_records_hash(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state
+flush_cached_records_grace(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state
+hash_join_spill(JOIN *join, JOIN_TAB *join_tab);
+static enum_nested_loop_state
 end_send(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_send_group(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
@@ -168,6 +177,7 @@ static int join_read_system(JOIN_TAB *tab);
 static int join_read_const(JOIN_TAB *tab);
 static int join_read_key(JOIN_TAB *tab);
 static void join_read_key_unlock_row(st_join_table *tab);
+static void join_bka_unlock_row(st_join_table *tab);
 static int join_read_always_key(JOIN_TAB *tab);
 static int join_read_last_key(JOIN_TAB *tab);
 static int join_no_more_records(READ_RECORD *info);
@@ -216,6 +226,11 @@ static int remove_dup_with_hash_index(THD *thd,TABLE *table,
 
 				      ulong key_length,Item *having);
 static int join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count);
+static int join_init_bka(THD *thd, JOIN_TAB *tab);
+static bool hash_join_allowed(JOIN *join);
+static bool hash_join_fields(JOIN *join, JOIN_TAB *tab, uint idx);
+static int join_init_hash(JOIN *join, JOIN_TAB *tab, uint idx);
+static void update_hash_join_tables(COND *cond);
 static ulong used_blob_length(CACHE_FIELD **ptr);
 static bool store_record_in_cache(JOIN_CACHE *cache);
 static void reset_cache_read(JOIN_CACHE *cache);
@@ -2875,6 +2890,8 @@ make_join_statistics(JOIN *join, TABLE_LIST *tables_arg, COND *conds,
                             conds, join->cond_equal,
                             ~outer_join, join->select_lex, &sargables))
       goto error;
+  if (conds && optimizer_flag(join->thd, OPTIMIZER_SWITCH_HASH_JOIN))
+    update_hash_join_tables(conds);
 
   /* Read tables with 0 or 1 rows (system tables) */
   join->const_table_map= 0;
@@ -4179,6 +4196,116 @@ update_ref_and_keys(THD *thd, DYNAMIC_ARRAY *keyuse,JOIN_TAB *join_tab,
   return FALSE;
 }
 
+/**
+  Check if a hash join can be done on the equality of two items.
+
+  The hash of equal values must be the same. This holds when the items
+  are compared as integers, or as strings in the collation of both
+  items. Temporal values are compared in other ways and are not used.
+*/
+
+static bool hash_join_comparable(Item *a, Item *b, CHARSET_INFO *cmp_cs)
+{
+  Item_result type= item_cmp_type(a->result_type(), b->result_type());
+  Item *items[2]= { a, b };
+
+  for (uint i= 0; i < 2; i++)
+  {
+    if (items[i]->result_type() != type)
+      return FALSE;
+    switch (items[i]->field_type()) {
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_TIME:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_YEAR:
+      return FALSE;
+    default:
+      break;
+    }
+    if (type == STRING_RESULT && items[i]->collation.collation != cmp_cs)
+      return FALSE;
+  }
+  return type == INT_RESULT || type == STRING_RESULT;
+}
+
+
+/**
+  Note that the tables of two fields can be hash joined.
+*/
+
+static void add_hash_join_tables(Item *a, Item *b, CHARSET_INFO *cmp_cs)
+{
+  Item *field= a->real_item();
+  table_map field_map= a->used_tables();
+  table_map other_map= b->used_tables();
+
+  if (field->type() != Item::FIELD_ITEM ||
+      my_count_bits(field_map) != 1 || my_count_bits(other_map) != 1 ||
+      ((field_map | other_map) & PSEUDO_TABLE_BITS) ||
+      field_map == other_map || !hash_join_comparable(a, b, cmp_cs))
+    return;
+  ((Item_field*) field)->field->table->reginfo.join_tab->hash_join_tables|=
+    other_map;
+}
+
+
+/**
+  Find the tables that each table can be hash joined with, for the cost
+  of the join in best_access_path(). These are the tables with a field
+  in an equality with a field of the table, on the top AND level of the
+  WHERE condition.
+
+  @param cond  The WHERE condition, with its multiple equalities
+*/
+
+static void update_hash_join_tables(COND *cond)
+{
+  List<Item> top_items;
+  List<Item> *items= &top_items;
+  Item *item;
+
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+    items= ((Item_cond*) cond)->argument_list();
+  else
+    top_items.push_back(cond);
+
+  List_iterator_fast<Item> it(*items);
+  while ((item= it++))
+  {
+    if (item->type() != Item::FUNC_ITEM)
+      continue;
+    Item_func *func= (Item_func*) item;
+    if (func->functype() == Item_func::EQ_FUNC)
+    {
+      Item **args= func->arguments();
+      CHARSET_INFO *cs= ((Item_bool_func2*) func)->compare_collation();
+      add_hash_join_tables(args[0], args[1], cs);
+      add_hash_join_tables(args[1], args[0], cs);
+    }
+    else if (func->functype() == Item_func::MULT_EQUAL_FUNC &&
+             !((Item_equal*) func)->get_const())
+    {
+      Item_equal *item_equal= (Item_equal*) func;
+      Item_equal_iterator fi(*item_equal);
+      Item_equal_iterator fj(*item_equal);
+      Item_field *f1, *f2;
+      while ((f1= fi++))
+      {
+        fj.rewind();
+        while ((f2= fj++))
+        {
+          if (f1 != f2)
+            add_hash_join_tables(f1, f2, item_equal->compare_collation());
+        }
+      }
+    }
+  }
+}
+
+
 /**
   Update some values in keyuse for faster choose_plan() loop.
 */
@@ -4912,6 +5039,38 @@ best_access_path(JOIN      *join,
           (tmp +
            (s->records - rnd_records)/(double) TIME_FOR_COMPARE);
       }
+      else if ((s->hash_join_tables &
+                ~(remaining_tables | join->const_table_map)) &&
+               hash_join_allowed(join))
+      {
+        /*
+          Hash join: the table is read once if the cached records fit in
+          the join buffer. Otherwise the records and the rows are written
+          to partitions on disk and read back, which costs about two more
+          reads of the table. Records with blobs can't be written to
+          disk, then the table is read once per full join buffer, as for
+          a block nested loop join. Each record is hashed once and each
+          row probes the hash table once.
+        */
+        double cached_size= (double) cache_record_length(join,idx) *
+                            record_count;
+        if (cached_size > (double) thd->variables.join_buff_size)
+        {
+          if (hash_join_can_spill(join, s, idx))
+            tmp*= 3.0;
+          else
+            tmp*= (1.0 + floor(cached_size /
+                               (double) thd->variables.join_buff_size));
+        }
+        tmp+= (s->records - rnd_records)/(double) TIME_FOR_COMPARE;
+        tmp+= (record_count + rnd_records)/(double) TIME_FOR_COMPARE;
+        /*
+          Only the rows with the same values of the join fields are
+          compared with a record. Assume as many matches as for a 'ref'
+          access without index statistics.
+        */
+        rnd_records= max(rnd_records / MATCHING_ROWS_IN_OTHER_TABLE, 1);
+      }
       else
       {
         /* We read the table as many times as join buffer becomes full. */
@@ -5761,6 +5920,30 @@ static void calc_used_field_length(THD *thd, JOIN_TAB *join_tab)
 }
 
 
+/**
+  Whether a hash join of s with the records of the tables before it can
+  write them to disk, see join_init_hash(). cache_record_length() must
+  have been called for idx, which counts the blobs of the tables.
+*/
+
+static bool
+hash_join_can_spill(JOIN *join, JOIN_TAB *s, uint idx)
+{
+  JOIN_TAB **pos, **end;
+
+  if (s->table->s->blob_fields)
+    return FALSE;
+  for (pos= join->best_ref + join->const_tables, end= join->best_ref + idx;
+       pos != end;
+       pos++)
+  {
+    if ((*pos)->used_blobs)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+
 static uint
 cache_record_length(JOIN *join,uint idx)
 {
@@ -6201,6 +6384,11 @@ JOIN::make_simple_join(JOIN *parent, TABLE *temp_table)
   do_send_rows= row_limit ? 1 : 0;
 
   join_tab->cache.buff=0;			/* No caching */
+  join_tab->cache.bka= FALSE;
+  join_tab->cache.bka_keys= 0;
+  join_tab->cache.hash= FALSE;
+  join_tab->cache.hash_entries= 0;
+  join_tab->cache.hash_files= 0;
   join_tab->table=temp_table;
   join_tab->select=0;
   join_tab->select_cond=0;
@@ -6912,6 +7100,199 @@ pick_table_access_method(JOIN_TAB *tab)
 }
 
 
+/**
+  Check if an expression can be evaluated on the columns of an index.
+
+  @param item           Expression to check
+  @param tbl            The table with the index
+  @param keyno          The index
+  @param other_tbls_ok  TRUE if the expression may refer to columns of
+                        other tables
+
+  @return TRUE if the expression refers only to columns of the index,
+          constants and, if other_tbls_ok, columns of other tables, and
+          has no side effects
+*/
+
+static bool
+uses_index_fields_only(Item *item, TABLE *tbl, uint keyno,
+                       bool other_tbls_ok)
+{
+  if (item->used_tables() & RAND_TABLE_BIT)
+    return FALSE;
+  if (item->const_item())
+    return !item->has_subquery();
+
+  switch (item->type()) {
+  case Item::FUNC_ITEM:
+  {
+    Item_func *item_func= (Item_func*) item;
+    switch (item_func->functype()) {
+    case Item_func::TRIG_COND_FUNC:
+    case Item_func::SUSERVAR_FUNC:
+    case Item_func::FUNC_SP:
+    case Item_func::UDF_FUNC:
+    case Item_func::FT_FUNC:
+      return FALSE;
+    default:
+      break;
+    }
+    Item **arg= item_func->arguments();
+    Item **arg_end= arg + item_func->argument_count();
+    for (; arg != arg_end; arg++)
+    {
+      if (!uses_index_fields_only(*arg, tbl, keyno, other_tbls_ok))
+        return FALSE;
+    }
+    return TRUE;
+  }
+  case Item::COND_ITEM:
+  {
+    List_iterator<Item> li(*((Item_cond*) item)->argument_list());
+    Item *arg;
+    while ((arg= li++))
+    {
+      if (!uses_index_fields_only(arg, tbl, keyno, other_tbls_ok))
+        return FALSE;
+    }
+    return TRUE;
+  }
+  case Item::FIELD_ITEM:
+  {
+    Field *field= ((Item_field*) item)->field;
+    if (field->table != tbl)
+      return other_tbls_ok;
+    return (field->part_of_key.is_set(keyno) &&
+            field->type() != MYSQL_TYPE_GEOMETRY &&
+            field->type() != MYSQL_TYPE_BLOB);
+  }
+  case Item::REF_ITEM:
+    return uses_index_fields_only(item->real_item(), tbl, keyno,
+                                  other_tbls_ok);
+  default:
+    return FALSE;                               // Play it safe
+  }
+}
+
+
+/**
+  Extract the part of a condition that can be checked on an index.
+
+  @param cond           The condition of the table
+  @param table          The table
+  @param keyno          The index
+  @param other_tbls_ok  TRUE if the result may refer to columns of
+                        other tables
+
+  @details
+    The AND parts of the condition that refer to the table and can be
+    evaluated by uses_index_fields_only() are kept, the rest is dropped.
+    An OR is kept only as a whole. Equalities that the ref access of the
+    table already guarantees are dropped as well (see test_if_ref(), this
+    does not apply to nullable key parts).
+
+  @return The index condition, or NULL if there is none
+*/
+
+static COND *
+make_cond_for_index(COND *cond, TABLE *table, uint keyno, bool other_tbls_ok)
+{
+  if (cond->type() == Item::COND_ITEM)
+  {
+    if (((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+    {
+      Item_cond_and *new_cond=new Item_cond_and;
+      if (!new_cond)
+        return (COND*) 0;                       // OOM /* purecov: inspected */
+      table_map used_tables= 0;
+      List_iterator<Item> li(*((Item_cond*) cond)->argument_list());
+      Item *item;
+      while ((item=li++))
+      {
+        Item *fix= make_cond_for_index(item, table, keyno, other_tbls_ok);
+        if (fix)
+        {
+          new_cond->argument_list()->push_back(fix);
+          used_tables|= fix->used_tables();
+        }
+      }
+      switch (new_cond->argument_list()->elements) {
+      case 0:
+        return (COND*) 0;
+      case 1:
+        return new_cond->argument_list()->head();
+      default:
+        new_cond->quick_fix_field();
+        new_cond->used_tables_cache= used_tables;
+        return new_cond;
+      }
+    }
+    /* Or list */
+  }
+  if (!(cond->used_tables() & table->map) ||
+      !uses_index_fields_only(cond, table, keyno, other_tbls_ok))
+    return (COND*) 0;
+  if (cond->type() == Item::FUNC_ITEM &&
+      ((Item_func*) cond)->functype() == Item_func::EQ_FUNC)
+  {
+    /* Skip the equalities that the ref access guarantees */
+    Item *left_item= ((Item_func*) cond)->arguments()[0];
+    Item *right_item= ((Item_func*) cond)->arguments()[1];
+    if ((left_item->type() == Item::FIELD_ITEM &&
+         test_if_ref((Item_field*) left_item, right_item)) ||
+        (right_item->type() == Item::FIELD_ITEM &&
+         test_if_ref((Item_field*) right_item, left_item)))
+      return (COND*) 0;
+  }
+  return cond;
+}
+
+
+/**
+  Push the part of the condition of a join table that can be checked on
+  the columns of an index down to the storage engine.
+
+  @param tab            The join table
+  @param keyno          The index that tab is read with
+  @param other_tbls_ok  TRUE if the columns of the preceding tables hold
+                        the current join row while tab is read
+
+  @details
+    The storage engine checks the condition for every index entry and
+    reads the full row only for the entries that match it. The
+    condition stays in tab->select_cond, so the rows are checked again
+    after they are read.
+*/
+
+static void
+push_index_cond(JOIN_TAB *tab, uint keyno, bool other_tbls_ok)
+{
+  TABLE *table= tab->table;
+  THD *thd= tab->join->thd;
+  DBUG_ENTER("push_index_cond");
+
+  if (!tab->select_cond ||
+      !optimizer_flag(thd, OPTIMIZER_SWITCH_INDEX_CONDITION_PUSHDOWN) ||
+      !(table->file->index_flags(keyno, 0, 1) & HA_DO_INDEX_COND_PUSHDOWN) ||
+      thd->lex->sql_command == SQLCOM_UPDATE_MULTI ||
+      thd->lex->sql_command == SQLCOM_DELETE_MULTI ||
+      (keyno == table->s->primary_key &&
+       table->file->primary_key_is_clustered()) ||
+      table->covering_keys.is_set(keyno))
+    DBUG_VOID_RETURN;
+
+  COND *idx_cond= make_cond_for_index(tab->select_cond, table, keyno,
+                                      other_tbls_ok);
+  if (idx_cond)
+  {
+    DBUG_EXECUTE("where", print_where(idx_cond, "index condition",
+                                      QT_ORDINARY););
+    table->file->idx_cond_push(keyno, idx_cond);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
 static void
 make_join_readinfo(JOIN *join, ulonglong options)
 {
@@ -6925,6 +7306,7 @@ make_join_readinfo(JOIN *join, ulonglong options)
   {
     JOIN_TAB *tab=join->join_tab+i;
     TABLE *table=tab->table;
+    bool guarded= FALSE;
     tab->read_record.table= table;
     tab->read_record.file=table->file;
     tab->read_record.unlock_row= rr_unlock_row;
@@ -6962,6 +7344,41 @@ make_join_readinfo(JOIN *join, ulonglong options)
       }
       delete tab->quick;
       tab->quick=0;
+      /*
+        Batched Key Access: cache the records of the previous tables and
+        read the matching rows for all of them with one multi-range read.
+        Like the join cache this changes the order of the result, and
+        it does not handle outer joins.
+      */
+      for (uint part= 0; part < tab->ref.key_parts; part++)
+      {
+        if (tab->ref.cond_guards[part])
+          guarded= TRUE;
+      }
+      if (tab->type != JT_REF_OR_NULL && !guarded &&
+          i != join->const_tables && !(options & SELECT_NO_JOIN_CACHE) &&
+          optimizer_flag(join->thd, OPTIMIZER_SWITCH_BKA) &&
+          tab->use_quick != 2 && !tab->first_inner && !ordered_set &&
+          join->thd->lex->sql_command != SQLCOM_UPDATE_MULTI &&
+          join->thd->lex->sql_command != SQLCOM_DELETE_MULTI)
+      {
+        if ((options & SELECT_DESCRIBE) ||
+            (!join_init_cache(join->thd, join->join_tab+join->const_tables,
+                              i-join->const_tables) &&
+             !join_init_bka(join->thd, tab)))
+        {
+          tab->cache.bka= TRUE;
+          tab[-1].next_select= sub_select_cache; /* Patch previous */
+          tab->read_record.unlock_row= join_bka_unlock_row;
+        }
+      }
+      /*
+        join_read_key() does not read the row again for the same key, so
+        the result must not depend on the other tables for eq_ref. The
+        other tables do not hold the matching row while BKA reads tab.
+      */
+      push_index_cond(tab, tab->ref.key,
+                      tab->type != JT_EQ_REF && !tab->cache.bka);
       /* fall through */
     case JT_CONST:				// Only happens with left join
       if (table->covering_keys.is_set(tab->ref.key) &&
@@ -6981,8 +7398,25 @@ make_join_readinfo(JOIN *join, ulonglong options)
 			     i-join->const_tables))
 	{
 	  tab[-1].next_select=sub_select_cache; /* Patch previous */
+          /*
+            Hash join: only compare the rows with the cached records that
+            have the same values of the join fields. The rows may be
+            restored from disk, so positions can't be taken from them.
+          */
+          if (hash_join_allowed(join) &&
+              hash_join_fields(join, tab, i) &&
+              ((options & SELECT_DESCRIBE) || !join_init_hash(join, tab, i)))
+            tab->cache.hash= TRUE;
 	}
       }
+      if (tab->select && tab->select->quick && tab->use_quick != 2 &&
+          (tab->select->quick->get_type() ==
+           QUICK_SELECT_I::QS_TYPE_RANGE ||
+           tab->select->quick->get_type() ==
+           QUICK_SELECT_I::QS_TYPE_RANGE_DESC))
+        push_index_cond(tab, tab->select->quick->index,
+                        i == join->const_tables ||
+                        tab[-1].next_select != sub_select_cache);
       /* These init changes read_record */
       if (tab->use_quick == 2)
       {
@@ -7110,6 +7544,17 @@ void JOIN_TAB::cleanup()
   quick= 0;
   my_free(cache.buff);
   cache.buff= 0;
+  my_free(cache.bka_keys);
+  cache.bka_keys= 0;
+  my_free(cache.hash_entries);
+  cache.hash_entries= 0;
+  if (cache.hash_files)
+  {
+    for (uint i= 0; i < cache.hash_partitions * 2; i++)
+      close_cached_file(&cache.hash_files[i]);
+    my_free(cache.hash_files);
+    cache.hash_files= 0;
+  }
   limit= 0;
   if (table)
   {
@@ -10256,6 +10701,8 @@ Field *create_tmp_field(THD *thd, TABLE *table,Item *item, Item::Type type,
   case Item::TYPE_HOLDER:  
     result= ((Item_type_holder *)item)->make_field_by_type(table);
     result->set_derivation(item->collation.derivation);
+    if (modify_item)
+      item->set_result_field(result);
     return result;
   default:					// Dosen't have to be stored
     return 0;
@@ -10986,6 +11433,88 @@ create_tmp_table(THD *thd,TMP_TABLE_PARAM *param,List<Item> &fields,
     }
   }
 
+  if (param->derived_key_map && !group && !distinct)
+  {
+    /*
+      Create a non-unique key over the columns of a derived table that
+      the outer query compares to other tables, so that it can be read
+      with ref access instead of being scanned for every outer row.
+      Columns that can't be part of a key are left out.
+    */
+    uint key_parts= 0, key_length= 0;
+    for (i= 0; i < field_count && i < 64; i++)
+    {
+      Field *field= table->field[i];
+      if (!(param->derived_key_map & (1ULL << i)) ||
+          (field->flags & BLOB_FLAG) || field->type() == MYSQL_TYPE_BIT)
+        continue;
+      key_parts++;
+      key_length+= field->key_length() + test(field->null_ptr) +
+        (field->real_type() == MYSQL_TYPE_VARCHAR ? HA_KEY_BLOB_LENGTH : 0);
+    }
+    if (key_parts && key_parts <= MI_MAX_KEY_SEG &&
+        key_length < MI_MAX_KEY_LENGTH)
+    {
+      if (!(key_part_info= (KEY_PART_INFO*)
+            alloc_root(&table->mem_root, key_parts * sizeof(KEY_PART_INFO))) ||
+          !(keyinfo->rec_per_key= (ulong*)
+            alloc_root(&table->mem_root, key_parts * sizeof(ulong))))
+        goto err;
+      bzero((void*) key_part_info, key_parts * sizeof(KEY_PART_INFO));
+      bzero((void*) keyinfo->rec_per_key, key_parts * sizeof(ulong));
+      share->keys= 1;
+      share->key_parts= key_parts;
+      share->keys_in_use.set_bit(0);
+      share->key_info= table->key_info= keyinfo;
+      keyinfo->table= table;
+      keyinfo->key_part= key_part_info;
+      keyinfo->usable_key_parts= keyinfo->key_parts= key_parts;
+      keyinfo->key_length= 0;
+      keyinfo->flags= 0;
+      /* A hash key can only be used with all its parts */
+      keyinfo->algorithm= key_parts == 1 ? HA_KEY_ALG_UNDEF : HA_KEY_ALG_BTREE;
+      keyinfo->name= (char*) "<auto_key>";
+      for (i= 0; i < field_count && i < 64; i++)
+      {
+        Field *field= table->field[i];
+        if (!(param->derived_key_map & (1ULL << i)) ||
+            (field->flags & BLOB_FLAG) || field->type() == MYSQL_TYPE_BIT)
+          continue;
+        if (key_part_info == keyinfo->key_part)
+          field->key_start.set_bit(0);
+        field->part_of_key.set_bit(0);
+        field->flags|= PART_KEY_FLAG;
+        key_part_info->field=  field;
+        key_part_info->fieldnr= i + 1;
+        key_part_info->offset= field->offset(table->record[0]);
+        key_part_info->length= (uint16) field->key_length();
+        key_part_info->store_length= key_part_info->length;
+        key_part_info->type=   (uint8) field->key_type();
+        key_part_info->key_type =
+          ((ha_base_keytype) key_part_info->type == HA_KEYTYPE_TEXT ||
+           (ha_base_keytype) key_part_info->type == HA_KEYTYPE_VARTEXT1 ||
+           (ha_base_keytype) key_part_info->type == HA_KEYTYPE_VARTEXT2) ?
+          0 : FIELDFLAG_BINARY;
+        if (field->null_ptr)
+        {
+          key_part_info->null_bit= field->null_bit;
+          key_part_info->null_offset= (uint) (field->null_ptr -
+                                              (uchar*) table->record[0]);
+          key_part_info->store_length+= HA_KEY_NULL_LENGTH;
+          keyinfo->flags|= HA_NULL_PART_KEY;
+        }
+        if (field->real_type() == MYSQL_TYPE_VARCHAR)
+        {
+          key_part_info->key_part_flag|= HA_VAR_LENGTH_PART;
+          key_part_info->store_length+= HA_KEY_BLOB_LENGTH;
+        }
+        keyinfo->key_length+= key_part_info->store_length;
+        key_part_info++;
+      }
+      share->max_key_length= keyinfo->key_length;
+    }
+  }
+
   if (thd->is_fatal_error)				// If end of memory
     goto err;					 /* purecov: inspected */
   share->db_record_offset= 1;
@@ -11210,9 +11739,10 @@ static bool create_myisam_tmp_table(TABLE *table,TMP_TABLE_PARAM *param,
     }
     else
     {
-      /* Create an unique key */
+      /* Create an unique key, or the non-unique key of a derived table */
       bzero((char*) &keydef,sizeof(keydef));
-      keydef.flag=HA_NOSAME | HA_BINARY_PACK_KEY | HA_PACK_KEY;
+      keydef.flag= ((keyinfo->flags & HA_NOSAME) | HA_BINARY_PACK_KEY |
+                    HA_PACK_KEY);
       keydef.keysegs=  keyinfo->key_parts;
       keydef.seg= seg;
     }
@@ -11696,6 +12226,8 @@ sub_select_cache(JOIN *join,JOIN_TAB *join_tab,bool end_of_records)
   {
     if (!store_record_in_cache(&join_tab->cache))
       return NESTED_LOOP_OK;                     // There is more room in cache
+    if (join_tab->cache.hash_can_spill)
+      return hash_join_spill(join, join_tab);    // Partition to disk
     return flush_cached_records(join,join_tab,FALSE);
   }
   rc= flush_cached_records(join, join_tab, TRUE);
@@ -12112,8 +12644,20 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skip_last)
   READ_RECORD *info;
 
   join_tab->table->null_row= 0;
+  if (join_tab->cache.hash_spilled)
+    return flush_cached_records_grace(join, join_tab);
   if (!join_tab->cache.records)
     return NESTED_LOOP_OK;                      /* Nothing to do */
+  if (join_tab->cache.bka)
+  {
+    DBUG_ASSERT(!skip_last);
+    return flush_cached_records_bka(join, join_tab);
+  }
+  if (join_tab->cache.hash)
+  {
+    DBUG_ASSERT(!skip_last);
+    return flush_cached_records_hash(join, join_tab);
+  }
   if (skip_last)
     (void) store_record_in_cache(&join_tab->cache); // Must save this for later
   if (join_tab->use_quick == 2)
@@ -12194,52 +12738,695 @@ flush_cached_records(JOIN *join,JOIN_TAB *join_tab,bool skip_last)
 }
 
 
-/*****************************************************************************
-  The different ways to read a record
-  Returns -1 if row was not found, 0 if row was found and 1 on errors
-*****************************************************************************/
-
-/** Help function when we get some an error from the table handler. */
+/**
+  A cached record and the key built from it for Batched Key Access.
+  The key of tab->ref follows the struct.
+*/
 
-int report_error(TABLE *table, int error)
+typedef struct st_bka_key
 {
-  if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
-  {
-    table->status= STATUS_GARBAGE;
-    return -1;					// key not found; ok
-  }
-  /*
-    Locking reads can legally return also these errors, do not
-    print them to the .err log
-  */
-  if (error != HA_ERR_LOCK_DEADLOCK && error != HA_ERR_LOCK_WAIT_TIMEOUT
-      && !table->in_use->killed)
-    sql_print_error("Got error %d when reading table '%s'",
-		    error, table->s->path.str);
-  table->file->print_error(error,MYF(0));
-  return 1;
-}
+  uchar *rec_pos;                               /* Position in the cache */
+  uint rec_nr;
+  bool done;                                    /* Needs no more rows */
+} BKA_KEY;
 
+#define BKA_KEY_HEADER ALIGN_SIZE(sizeof(BKA_KEY))
 
-int safe_index_read(JOIN_TAB *tab)
+
+static int cmp_bka_key(void *arg, uchar *a, uchar *b)
 {
-  int error;
-  TABLE *table= tab->table;
-  if ((error=table->file->index_read_map(table->record[0],
-                                         tab->ref.key_buff,
-                                         make_prev_keypart_map(tab->ref.key_parts),
-                                         HA_READ_KEY_EXACT)))
-    return report_error(table, error);
-  return 0;
+  JOIN_TAB *tab= (JOIN_TAB*) arg;
+  int cmp;
+  if ((cmp= key_tuple_cmp(tab->table->key_info[tab->ref.key].key_part,
+                          a + BKA_KEY_HEADER, b + BKA_KEY_HEADER,
+                          tab->ref.key_length)))
+    return cmp;
+  return memcmp(a + BKA_KEY_HEADER, b + BKA_KEY_HEADER, tab->ref.key_length);
 }
 
 
-static int
-join_read_const_table(JOIN_TAB *tab, POSITION *pos)
+/**
+  Join the cached records with the table using Batched Key Access.
+
+    The key of the ref access is built for every cached record. The keys
+    are sorted and the records with equal keys are grouped into one
+    range. All the ranges are then read with one multi-range read,
+    which may read the rows in the order of their references instead
+    of the order of the keys. Every row found is joined with each
+    record of its range.
+
+  @return
+    The state of the nested loop, like flush_cached_records()
+*/
+
+static enum_nested_loop_state
+flush_cached_records_bka(JOIN *join, JOIN_TAB *join_tab)
 {
-  int error;
-  DBUG_ENTER("join_read_const_table");
-  TABLE *table=tab->table;
+  JOIN_CACHE *cache= &join_tab->cache;
+  TABLE *table= join_tab->table;
+  TABLE_REF *ref= &join_tab->ref;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  KEY_MULTI_RANGE *range, *range_end, *found_range;
+  uchar *entry, *keys_end;
+  key_part_map keypart_map= make_prev_keypart_map(ref->key_parts);
+  uint range_flag= EQ_RANGE;
+  int error= 0;
+  DBUG_ENTER("flush_cached_records_bka");
+
+  if (join_tab->type == JT_EQ_REF)
+    range_flag|= UNIQUE_RANGE;
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+
+  /* Build the keys, skipping the records that can't have a match */
+  entry= cache->bka_keys;
+  reset_cache_read(cache);
+  for (uint i= cache->records ; i-- > 0 ;)
+  {
+    BKA_KEY *key= (BKA_KEY*) entry;
+    uint part;
+    key->rec_pos= cache->pos;
+    key->rec_nr= cache->record_nr;
+    key->done= FALSE;
+    read_cached_record(join_tab);
+    for (part= 0 ; part < ref->key_parts ; part++)
+    {
+      if ((ref->null_rejecting & ((key_part_map)1 << part)) &&
+          ref->items[part]->is_null())
+        break;
+    }
+    if (part < ref->key_parts ||
+        cp_buffer_from_ref(join->thd, table, ref))
+      continue;
+    memcpy(entry + BKA_KEY_HEADER, ref->key_buff, ref->key_length);
+    entry+= cache->bka_entry_size;
+  }
+  keys_end= entry;
+  my_qsort2(cache->bka_keys,
+            (keys_end - cache->bka_keys) / cache->bka_entry_size,
+            cache->bka_entry_size, (qsort2_cmp) cmp_bka_key, join_tab);
+
+  /* One range for every distinct key */
+  range= cache->bka_ranges;
+  for (entry= cache->bka_keys ; entry < keys_end ;
+       entry+= cache->bka_entry_size)
+  {
+    uchar *key= entry + BKA_KEY_HEADER;
+    if (range != cache->bka_ranges &&
+        !memcmp(range[-1].start_key.key, key, ref->key_length))
+      continue;
+    range->start_key.key= key;
+    range->start_key.length= ref->key_length;
+    range->start_key.keypart_map= keypart_map;
+    range->start_key.flag= HA_READ_KEY_EXACT;
+    range->end_key= range->start_key;
+    range->end_key.flag= HA_READ_AFTER_KEY;
+    range->ptr= (char*) entry;
+    range->range_flag= range_flag;
+    range++;
+  }
+  range_end= range;
+  if (range_end == cache->bka_ranges)
+    goto end;                                   // No possible matches
+
+  if (!table->file->inited &&
+      (error= table->file->ha_index_init(ref->key, join_tab->sorted)))
+    goto err;
+
+  for (error= table->file->read_multi_range_first(&found_range,
+                                                  cache->bka_ranges,
+                                                  (uint) (range_end -
+                                                          cache->bka_ranges),
+                                                  HA_MRR_ROWID_ORDER,
+                                                  &cache->bka_mrr_buff);
+       !error;
+       error= table->file->read_multi_range_next(&found_range))
+  {
+    uchar *group_end= (found_range + 1 < range_end ?
+                       (uchar*) found_range[1].ptr : keys_end);
+    if (join->thd->killed)
+    {
+      join->thd->send_kill_message();
+      rc= NESTED_LOOP_KILLED;
+      goto end;
+    }
+    for (entry= (uchar*) found_range->ptr ; entry < group_end ;
+         entry+= cache->bka_entry_size)
+    {
+      BKA_KEY *key= (BKA_KEY*) entry;
+      if (key->done)
+        continue;
+      table->status= 0;
+      table->null_row= 0;
+      cache->pos= key->rec_pos;
+      cache->record_nr= key->rec_nr;
+      read_cached_record(join_tab);
+      join->return_tab= join_tab;
+      rc= evaluate_join_record(join, join_tab, 0);
+      if (rc == NESTED_LOOP_NO_MORE_ROWS || join->return_tab < join_tab)
+        key->done= TRUE;                        // Skip its other rows
+      else if (rc != NESTED_LOOP_OK)
+        goto end;
+    }
+  }
+  rc= NESTED_LOOP_OK;
+  if (error == HA_ERR_END_OF_FILE)
+    goto end;
+
+err:
+  table->file->print_error(error, MYF(0));
+  rc= NESTED_LOOP_ERROR;
+
+end:
+  reset_cache_write(cache);
+  if (rc == NESTED_LOOP_OK)
+  {
+    for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+      tmp2->table->status=tmp2->status;
+  }
+  DBUG_RETURN(rc);
+}
+
+
+/**
+  A cached record in the hash table of a hash join.
+*/
+
+typedef struct st_hash_join_entry
+{
+  uchar *rec_pos;                               /* Position in the cache */
+  uint rec_nr;
+  uint32 hash;                                  /* Of the join fields */
+  uint next;                                    /* In the same bucket */
+} HASH_JOIN_ENTRY;
+
+#define HASH_JOIN_NO_ENTRY ((uint) ~0)
+/** Maximum number of partitions of a hash join that spills to disk */
+#define HASH_JOIN_MAX_PARTITIONS 32
+/** Size of the IO_CACHE buffer of each partition file */
+#define HASH_JOIN_FILE_BUFFER (IO_SIZE*4)
+
+
+/**
+  Compute the hash of the join fields of a hash join, for a cached
+  record (the hash_outer items) or a row of the table (hash_inner).
+
+  @retval TRUE   One of the values is NULL, the equality can't be true
+  @retval FALSE  OK, the hash is in *hash
+*/
+
+static bool hash_join_key(Item **items, uint count, uint32 *hash)
+{
+  ulong nr1= 1, nr2= 4;
+  char buff[MAX_FIELD_WIDTH];
+  String tmp(buff, sizeof(buff), &my_charset_bin);
+
+  for (Item **item= items, **end= items + count; item != end; item++)
+  {
+    if ((*item)->result_type() == INT_RESULT)
+    {
+      uchar key[8];
+      longlong value= (*item)->val_int();
+      if ((*item)->null_value)
+        return TRUE;
+      int8store(key, value);
+      my_charset_bin.coll->hash_sort(&my_charset_bin, key, sizeof(key),
+                                     &nr1, &nr2);
+    }
+    else
+    {
+      CHARSET_INFO *cs= (*item)->collation.collation;
+      String *str= (*item)->val_str(&tmp);
+      if (!str)
+        return TRUE;
+      cs->coll->hash_sort(cs, (uchar*) str->ptr(), str->length(),
+                          &nr1, &nr2);
+    }
+  }
+  *hash= (uint32) nr1;
+  return FALSE;
+}
+
+
+/** The partition of a hash join that spills to disk for a hash */
+
+static inline uint hash_join_partition(JOIN_CACHE *cache, uint32 hash)
+{
+  /* Use other bits than the bucket of the hash table */
+  return (uint) ((uint32) (hash * 2654435761U) >> 16) %
+    cache->hash_partitions;
+}
+
+
+/** Empty the hash table of a hash join */
+
+static void hash_join_reset(JOIN_CACHE *cache)
+{
+  for (uint i= 0; i < cache->hash_n_buckets; i++)
+    cache->hash_buckets[i]= HASH_JOIN_NO_ENTRY;
+}
+
+
+/** Add the cached record at rec_pos to the hash table */
+
+static void hash_join_insert(JOIN_CACHE *cache, uint entry_nr,
+                             uchar *rec_pos, uint rec_nr, uint32 hash)
+{
+  HASH_JOIN_ENTRY *entry= cache->hash_entries + entry_nr;
+  uint *bucket= cache->hash_buckets + hash % cache->hash_n_buckets;
+  entry->rec_pos= rec_pos;
+  entry->rec_nr= rec_nr;
+  entry->hash= hash;
+  entry->next= *bucket;
+  *bucket= entry_nr;
+}
+
+
+/**
+  Join the current row of the table with the cached records that have
+  the same hash of the join fields.
+
+  @param hash  Hash of the join fields of the row
+
+  @return
+    The state of the nested loop, like flush_cached_records()
+*/
+
+static enum_nested_loop_state
+hash_join_probe(JOIN *join, JOIN_TAB *join_tab, uint32 hash)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  SQL_SELECT *select= join_tab->select;
+  enum_nested_loop_state rc;
+
+  for (uint nr= cache->hash_buckets[hash % cache->hash_n_buckets];
+       nr != HASH_JOIN_NO_ENTRY;
+       nr= cache->hash_entries[nr].next)
+  {
+    HASH_JOIN_ENTRY *entry= cache->hash_entries + nr;
+    bool skip_record= FALSE;
+    if (entry->hash != hash)
+      continue;
+    cache->pos= entry->rec_pos;
+    cache->record_nr= entry->rec_nr;
+    read_cached_record(join_tab);
+    if (select && select->skip_record(join->thd, &skip_record))
+      return NESTED_LOOP_ERROR;
+    if (!skip_record)
+    {
+      rc= (join_tab->next_select)(join,join_tab+1,0);
+      if (rc != NESTED_LOOP_OK && rc != NESTED_LOOP_NO_MORE_ROWS)
+        return rc;
+    }
+  }
+  return NESTED_LOOP_OK;
+}
+
+
+/**
+  Join the cached records with the table using a hash join.
+
+    The cached records are put in a hash table on the hash of their
+    join fields. The table is read once, and each row is only compared
+    with the records in the bucket of the hash of its join fields,
+    instead of with all the records as flush_cached_records() does.
+
+  @return
+    The state of the nested loop, like flush_cached_records()
+*/
+
+static enum_nested_loop_state
+flush_cached_records_hash(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  enum_nested_loop_state rc= NESTED_LOOP_OK;
+  READ_RECORD *info;
+  uchar *last_pos= 0;
+  uint entries= 0;
+  uint32 hash;
+  int error;
+  DBUG_ENTER("flush_cached_records_hash");
+
+  /* Build the hash table, skipping the records that can't have a match */
+  hash_join_reset(cache);
+  reset_cache_read(cache);
+  for (uint i= cache->records ; i-- > 0 ;)
+  {
+    uchar *rec_pos= cache->pos;
+    uint rec_nr= cache->record_nr;
+    last_pos= rec_pos;
+    read_cached_record(join_tab);
+    if (!hash_join_key(cache->hash_outer, cache->hash_fields, &hash))
+      hash_join_insert(cache, entries++, rec_pos, rec_nr, hash);
+  }
+  if (!entries)
+    goto end;                                   // No possible matches
+
+  if ((error= join_init_read_record(join_tab)))
+  {
+    reset_cache_write(cache);
+    DBUG_RETURN(error < 0 ? NESTED_LOOP_NO_MORE_ROWS : NESTED_LOOP_ERROR);
+  }
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+
+  info= &join_tab->read_record;
+  do
+  {
+    bool skip_record= FALSE;
+    if (join->thd->killed)
+    {
+      join->thd->send_kill_message();
+      rc= NESTED_LOOP_KILLED;
+      goto end;
+    }
+    if (join_tab->cache.select &&
+        join_tab->cache.select->skip_record(join->thd, &skip_record))
+    {
+      rc= NESTED_LOOP_ERROR;
+      goto end;
+    }
+    if (!skip_record &&
+        !hash_join_key(cache->hash_inner, cache->hash_fields, &hash) &&
+        (rc= hash_join_probe(join, join_tab, hash)) != NESTED_LOOP_OK)
+      goto end;
+  } while (!(error=info->read_record(info)));
+
+  if (error > 0)				// Fatal error
+    rc= NESTED_LOOP_ERROR;                      /* purecov: inspected */
+  else
+  {
+    for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+      tmp2->table->status=tmp2->status;
+  }
+
+end:
+  /* Restore the current record, which is the last one */
+  cache->pos= last_pos;
+  cache->record_nr= cache->records - 1;
+  read_cached_record(join_tab);
+  reset_cache_write(cache);
+  DBUG_RETURN(rc);
+}
+
+
+/**
+  Write the cached records of a hash join to the partition files on
+  disk, and empty the cache. This is called instead of
+  flush_cached_records() when the cache is full and there are no blobs,
+  which makes it a grace hash join: the table is then read once for all
+  the records, see flush_cached_records_grace().
+
+    Each record is written with its hash and its length. The records
+    that can't have a match are skipped. The last record, which is the
+    current one, is read last and is also kept in hash_last_record.
+
+  @return
+    NESTED_LOOP_OK or NESTED_LOOP_ERROR
+*/
+
+static enum_nested_loop_state
+hash_join_spill(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  uchar header[8];
+  uint32 hash;
+  DBUG_ENTER("hash_join_spill");
+
+  if (!cache->hash_spilled)
+  {
+    uint n_files= cache->hash_partitions * 2;
+    if (!cache->hash_files)
+    {
+      if (!(cache->hash_files= (IO_CACHE*) my_malloc(sizeof(IO_CACHE) *
+                                                      n_files, MYF(MY_WME))))
+        DBUG_RETURN(NESTED_LOOP_ERROR);         /* purecov: inspected */
+      for (uint i= 0; i < n_files; i++)
+        my_b_clear(&cache->hash_files[i]);
+      for (uint i= 0; i < n_files; i++)
+      {
+        if (open_cached_file(&cache->hash_files[i], mysql_tmpdir, TEMP_PREFIX,
+                             HASH_JOIN_FILE_BUFFER, MYF(MY_WME)))
+          DBUG_RETURN(NESTED_LOOP_ERROR);       /* purecov: inspected */
+      }
+    }
+    else
+    {
+      for (uint i= 0; i < n_files; i++)
+      {
+        if (reinit_io_cache(&cache->hash_files[i], WRITE_CACHE, 0L, 0, 0))
+          DBUG_RETURN(NESTED_LOOP_ERROR);       /* purecov: inspected */
+      }
+    }
+    cache->hash_spilled= TRUE;
+    cache->hash_last_length= 0;
+    DBUG_PRINT("info", ("hash join spills to %u partitions",
+                        cache->hash_partitions));
+  }
+
+  reset_cache_read(cache);
+  for (uint i= cache->records ; i-- > 0 ;)
+  {
+    uchar *rec_pos= cache->pos;
+    uint length;
+    IO_CACHE *file;
+    read_cached_record(join_tab);
+    length= (uint) (cache->pos - rec_pos);
+    if (!i)
+    {
+      memcpy(cache->hash_last_record, rec_pos, length);
+      cache->hash_last_length= length;
+    }
+    if (hash_join_key(cache->hash_outer, cache->hash_fields, &hash))
+      continue;
+    int4store(header, hash);
+    int4store(header + 4, length);
+    file= cache->hash_files + hash_join_partition(cache, hash);
+    if (my_b_write(file, header, sizeof(header)) ||
+        my_b_write(file, rec_pos, length))
+    {
+      reset_cache_write(cache);
+      cache->hash_spilled= FALSE;
+      DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+    }
+  }
+  reset_cache_write(cache);
+  DBUG_RETURN(NESTED_LOOP_OK);
+}
+
+
+/**
+  Join the records of a hash join that were written to disk with the
+  table: a grace hash join.
+
+    The records still in the cache are written to the partition files
+    too. The table is then read once, and each row that may have a
+    match is written to the row file of the partition of its hash. For
+    each partition, the records are read into the cache and put in the
+    hash table, and the rows of the partition are joined with them as
+    in flush_cached_records_hash(). When the records of a partition
+    don't fit in the cache, they are joined in several parts, each of
+    them with all the rows of the partition.
+
+  @return
+    The state of the nested loop, like flush_cached_records()
+*/
+
+static enum_nested_loop_state
+flush_cached_records_grace(JOIN *join, JOIN_TAB *join_tab)
+{
+  JOIN_CACHE *cache= &join_tab->cache;
+  TABLE *table= join_tab->table;
+  uint partitions= cache->hash_partitions;
+  IO_CACHE *record_files= cache->hash_files;
+  IO_CACHE *row_files= cache->hash_files + partitions;
+  uint reclength= table->s->reclength;
+  enum_nested_loop_state rc;
+  READ_RECORD *info;
+  uchar header[8], row_hash[4];
+  uint32 hash;
+  int error;
+  DBUG_ENTER("flush_cached_records_grace");
+
+  if ((rc= hash_join_spill(join, join_tab)) != NESTED_LOOP_OK)
+    goto end;
+
+  /* Write the rows that may have a match to the partitions */
+  if ((error= join_init_read_record(join_tab)))
+  {
+    rc= error < 0 ? NESTED_LOOP_NO_MORE_ROWS : NESTED_LOOP_ERROR;
+    goto end;
+  }
+  info= &join_tab->read_record;
+  do
+  {
+    bool skip_record= FALSE;
+    if (join->thd->killed)
+    {
+      join->thd->send_kill_message();
+      rc= NESTED_LOOP_KILLED;
+      goto end;
+    }
+    if (join_tab->cache.select &&
+        join_tab->cache.select->skip_record(join->thd, &skip_record))
+    {
+      rc= NESTED_LOOP_ERROR;
+      goto end;
+    }
+    if (!skip_record &&
+        !hash_join_key(cache->hash_inner, cache->hash_fields, &hash))
+    {
+      IO_CACHE *file= row_files + hash_join_partition(cache, hash);
+      int4store(row_hash, hash);
+      if (my_b_write(file, row_hash, sizeof(row_hash)) ||
+          my_b_write(file, table->record[0], reclength))
+      {
+        rc= NESTED_LOOP_ERROR;                  /* purecov: inspected */
+        goto end;
+      }
+    }
+  } while (!(error=info->read_record(info)));
+  if (error > 0)
+  {
+    rc= NESTED_LOOP_ERROR;                      /* purecov: inspected */
+    goto end;
+  }
+
+  for (JOIN_TAB *tmp=join->join_tab; tmp != join_tab ; tmp++)
+  {
+    tmp->status=tmp->table->status;
+    tmp->table->status=0;
+  }
+
+  /* Join the records and the rows of each partition */
+  for (uint part= 0; part < partitions; part++)
+  {
+    IO_CACHE *records= record_files + part;
+    IO_CACHE *rows= row_files + part;
+    bool more_records;
+
+    if (reinit_io_cache(records, READ_CACHE, 0L, 0, 0))
+    {
+      rc= NESTED_LOOP_ERROR;                    /* purecov: inspected */
+      goto end;
+    }
+    more_records= !my_b_read(records, header, sizeof(header));
+    while (more_records)
+    {
+      /* Read as many records of the partition as fit in the cache */
+      uint entries= 0;
+      reset_cache_write(cache);
+      hash_join_reset(cache);
+      do
+      {
+        uint length= uint4korr(header + 4);
+        if (entries && (entries == cache->hash_max_records ||
+                        length > (size_t) (cache->end - cache->pos)))
+          break;
+        if (my_b_read(records, cache->pos, length))
+        {
+          rc= NESTED_LOOP_ERROR;                /* purecov: inspected */
+          goto end;
+        }
+        hash_join_insert(cache, entries++, cache->pos, cache->records++,
+                         uint4korr(header));
+        cache->pos+= length;
+      } while ((more_records= !my_b_read(records, header, sizeof(header))));
+
+      if (reinit_io_cache(rows, READ_CACHE, 0L, 0, 0))
+      {
+        rc= NESTED_LOOP_ERROR;                  /* purecov: inspected */
+        goto end;
+      }
+      while (!my_b_read(rows, row_hash, sizeof(row_hash)) &&
+             !my_b_read(rows, table->record[0], reclength))
+      {
+        if (join->thd->killed)
+        {
+          join->thd->send_kill_message();
+          rc= NESTED_LOOP_KILLED;
+          goto end;
+        }
+        table->status= 0;
+        table->null_row= 0;
+        if ((rc= hash_join_probe(join, join_tab, uint4korr(row_hash))) !=
+            NESTED_LOOP_OK)
+          goto end;
+      }
+    }
+  }
+
+  for (JOIN_TAB *tmp2=join->join_tab; tmp2 != join_tab ; tmp2++)
+    tmp2->table->status=tmp2->status;
+
+end:
+  /* Restore the current record, which is the last one */
+  reset_cache_write(cache);
+  if (cache->hash_last_length)
+  {
+    memcpy(cache->buff, cache->hash_last_record, cache->hash_last_length);
+    read_cached_record(join_tab);
+  }
+  reset_cache_write(cache);
+  cache->hash_spilled= FALSE;
+  DBUG_RETURN(rc);
+}
+
+
+/*****************************************************************************
+  The different ways to read a record
+  Returns -1 if row was not found, 0 if row was found and 1 on errors
+*****************************************************************************/
+
+/** Help function when we get some an error from the table handler. */
+
+int report_error(TABLE *table, int error)
+{
+  if (error == HA_ERR_END_OF_FILE || error == HA_ERR_KEY_NOT_FOUND)
+  {
+    table->status= STATUS_GARBAGE;
+    return -1;					// key not found; ok
+  }
+  /*
+    Locking reads can legally return also these errors, do not
+    print them to the .err log
+  */
+  if (error != HA_ERR_LOCK_DEADLOCK && error != HA_ERR_LOCK_WAIT_TIMEOUT
+      && !table->in_use->killed)
+    sql_print_error("Got error %d when reading table '%s'",
+		    error, table->s->path.str);
+  table->file->print_error(error,MYF(0));
+  return 1;
+}
+
+
+int safe_index_read(JOIN_TAB *tab)
+{
+  int error;
+  TABLE *table= tab->table;
+  if ((error=table->file->index_read_map(table->record[0],
+                                         tab->ref.key_buff,
+                                         make_prev_keypart_map(tab->ref.key_parts),
+                                         HA_READ_KEY_EXACT)))
+    return report_error(table, error);
+  return 0;
+}
+
+
+static int
+join_read_const_table(JOIN_TAB *tab, POSITION *pos)
+{
+  int error;
+  DBUG_ENTER("join_read_const_table");
+  TABLE *table=tab->table;
   table->const_table=1;
   table->null_row=0;
   table->status=STATUS_NO_RECORD;
@@ -12457,6 +13644,19 @@ join_read_key_unlock_row(st_join_table *tab)
     tab->ref.use_count--;
 }
 
+
+/**
+  A row read with Batched Key Access is matched with several cached
+  records. It may be rejected for one of them and used for the next,
+  so it is never unlocked.
+  @sa flush_cached_records_bka()
+*/
+
+static void
+join_bka_unlock_row(st_join_table *tab)
+{
+}
+
 /*
   ref access method implementation: "read_first" function
 
@@ -14841,6 +16041,180 @@ join_init_cache(THD *thd,JOIN_TAB *tables,uint table_count)
 }
 
 
+/**
+  Allocate the buffers of Batched Key Access for the join cache of tab,
+  which join_init_cache() has set up.
+
+  @retval 0  OK
+  @retval 1  Out of memory, the cache should not be used
+*/
+
+static int
+join_init_bka(THD *thd, JOIN_TAB *tab)
+{
+  JOIN_CACHE *cache= &tab->cache;
+  size_t keys_size, ranges_size, mrr_size;
+  DBUG_ENTER("join_init_bka");
+
+  cache->bka_entry_size= ALIGN_SIZE(BKA_KEY_HEADER + tab->ref.key_length);
+  cache->bka_max_records=
+    max((uint) (thd->variables.join_buff_size /
+                (cache->length + cache->bka_entry_size +
+                 sizeof(KEY_MULTI_RANGE))), 2);
+  keys_size= (size_t) cache->bka_max_records * cache->bka_entry_size;
+  ranges_size= ALIGN_SIZE((size_t) cache->bka_max_records *
+                          sizeof(KEY_MULTI_RANGE));
+  mrr_size= thd->variables.read_rnd_buff_size;
+  if (!(cache->bka_keys= (uchar*) my_malloc(keys_size + ranges_size +
+                                            mrr_size, MYF(0))))
+    DBUG_RETURN(1);                             /* purecov: inspected */
+  cache->bka_ranges= (KEY_MULTI_RANGE*) (cache->bka_keys + keys_size);
+  cache->bka_mrr_buff.buffer= cache->bka_keys + keys_size + ranges_size;
+  cache->bka_mrr_buff.buffer_end= cache->bka_mrr_buff.buffer + mrr_size;
+  cache->bka_mrr_buff.end_of_used_area= cache->bka_keys + keys_size + ranges_size;
+  DBUG_RETURN(0);
+}
+
+
+/**
+  Whether the join cache may be used for a hash join in this statement.
+  Multi-table UPDATE and DELETE take the positions of the rows, which
+  rows restored from disk don't have.
+*/
+
+static bool
+hash_join_allowed(JOIN *join)
+{
+  THD *thd= join->thd;
+  return (optimizer_flag(thd, OPTIMIZER_SWITCH_HASH_JOIN) &&
+          thd->lex->sql_command != SQLCOM_UPDATE_MULTI &&
+          thd->lex->sql_command != SQLCOM_DELETE_MULTI);
+}
+
+
+/**
+  Find the equalities that a hash join of tab with the previous tables
+  can use: on the top AND level of the condition of tab, between an
+  expression on tab only and one on the previous tables only.
+
+  @param join  The join
+  @param tab   The table read with the join cache
+  @param idx   Position of tab in join->join_tab
+
+  @return TRUE if there are such equalities, which are stored in the
+  hash_outer and hash_inner arrays of the cache
+*/
+
+static bool
+hash_join_fields(JOIN *join, JOIN_TAB *tab, uint idx)
+{
+  JOIN_CACHE *cache= &tab->cache;
+  table_map tab_map= tab->table->map;
+  table_map prefix_map= 0;
+  Item *outer[MAX_REF_PARTS], *inner[MAX_REF_PARTS];
+  List<Item> top_items;
+  List<Item> *items= &top_items;
+  Item *item;
+  uint count= 0;
+  COND *cond;
+
+  if (!tab->select || !(cond= tab->select->cond))
+    return FALSE;
+  for (uint i= 0; i < idx; i++)
+    prefix_map|= join->join_tab[i].table->map;
+  if (cond->type() == Item::COND_ITEM &&
+      ((Item_cond*) cond)->functype() == Item_func::COND_AND_FUNC)
+    items= ((Item_cond*) cond)->argument_list();
+  else
+    top_items.push_back(cond);
+
+  List_iterator_fast<Item> it(*items);
+  while ((item= it++) && count < MAX_REF_PARTS)
+  {
+    if (item->type() != Item::FUNC_ITEM ||
+        ((Item_func*) item)->functype() != Item_func::EQ_FUNC)
+      continue;
+    Item **args= ((Item_func*) item)->arguments();
+    CHARSET_INFO *cs= ((Item_bool_func2*) item)->compare_collation();
+    for (uint i= 0; i < 2; i++)
+    {
+      Item *a= args[i], *b= args[1 - i];
+      if (a->used_tables() == tab_map && b->used_tables() &&
+          !(b->used_tables() & ~prefix_map) &&
+          hash_join_comparable(a, b, cs))
+      {
+        inner[count]= a;
+        outer[count]= b;
+        count++;
+        break;
+      }
+    }
+  }
+  if (!count ||
+      !(cache->hash_inner= (Item**) join->thd->memdup((uchar*) inner,
+                                                      count * sizeof(Item*))) ||
+      !(cache->hash_outer= (Item**) join->thd->memdup((uchar*) outer,
+                                                      count * sizeof(Item*))))
+    return FALSE;
+  cache->hash_fields= count;
+  return TRUE;
+}
+
+
+/**
+  Allocate the hash table of a hash join for the join cache of tab,
+  which join_init_cache() has set up.
+
+  The number of partitions for a spill to disk is chosen from the
+  estimated size of all the records, so that the records of each
+  partition are likely to fit in the join buffer.
+
+  @retval 0  OK
+  @retval 1  Out of memory, the cache should not be used for a hash join
+*/
+
+static int
+join_init_hash(JOIN *join, JOIN_TAB *tab, uint idx)
+{
+  THD *thd= join->thd;
+  JOIN_CACHE *cache= &tab->cache;
+  size_t entries_size, buckets_size;
+  double records= 1.0;
+  double partitions;
+  DBUG_ENTER("join_init_hash");
+
+  cache->hash_max_records=
+    max((uint) (thd->variables.join_buff_size /
+                (cache->length + sizeof(HASH_JOIN_ENTRY))), 2);
+  cache->hash_n_buckets= cache->hash_max_records | 1;
+  entries_size= ALIGN_SIZE((size_t) cache->hash_max_records *
+                           sizeof(HASH_JOIN_ENTRY));
+  buckets_size= ALIGN_SIZE((size_t) cache->hash_n_buckets * sizeof(uint));
+  if (!(cache->hash_entries=
+        (HASH_JOIN_ENTRY*) my_malloc(entries_size + buckets_size +
+                                     cache->length, MYF(0))))
+    DBUG_RETURN(1);                             /* purecov: inspected */
+  cache->hash_buckets= (uint*) ((uchar*) cache->hash_entries + entries_size);
+  cache->hash_last_record= ((uchar*) cache->hash_entries + entries_size +
+                            buckets_size);
+
+  /*
+    The last record in a full cache only has pointers to its blobs, so
+    records with blobs can't be written to disk.
+  */
+  cache->hash_can_spill= !cache->blobs && !tab->table->s->blob_fields;
+  cache->hash_spilled= FALSE;
+  cache->hash_files= 0;
+  for (uint i= join->const_tables; i < idx; i++)
+    records*= join->best_positions[i].records_read;
+  partitions= 2.0 * records * cache->length /
+    (double) thd->variables.join_buff_size;
+  cache->hash_partitions= (uint) min(max(partitions, 2.0),
+                                     (double) HASH_JOIN_MAX_PARTITIONS);
+  DBUG_RETURN(0);
+}
+
+
 static ulong
 used_blob_length(CACHE_FIELD **ptr)
 {
@@ -14870,7 +16244,9 @@ store_record_in_cache(JOIN_CACHE *cache)
   length=cache->length;
   if (cache->blobs)
     length+=used_blob_length(cache->blob_ptr);
-  if ((last_record= (length + cache->length > (size_t) (cache->end - pos))))
+  if ((last_record= (length + cache->length > (size_t) (cache->end - pos)) ||
+       (cache->bka && cache->records + 1 >= cache->bka_max_records) ||
+       (cache->hash && cache->records + 1 >= cache->hash_max_records)))
     cache->ptr_record=cache->records;
 
   /*
@@ -15603,10 +16979,20 @@ get_sort_by_table(ORDER *a,ORDER *b,TABLE_LIST *tables)
 static void
 calc_group_buffer(JOIN *join,ORDER *group)
 {
-  uint key_length=0, parts=0, null_parts=0;
-
   if (group)
     join->group= 1;
+  calc_group_buffer(&join->tmp_table_param, group);
+}
+
+
+/**
+  calc how big buffer a temporary table needs for its group key.
+*/
+
+void calc_group_buffer(TMP_TABLE_PARAM *param, ORDER *group)
+{
+  uint key_length=0, parts=0, null_parts=0;
+
   for (; group ; group=group->next)
   {
     Item *group_item= *group->item;
@@ -15678,9 +17064,9 @@ calc_group_buffer(JOIN *join,ORDER *group)
     if (group_item->maybe_null)
       null_parts++;
   }
-  join->tmp_table_param.group_length=key_length+null_parts;
-  join->tmp_table_param.group_parts=parts;
-  join->tmp_table_param.group_null_parts=null_parts;
+  param->group_length=key_length+null_parts;
+  param->group_parts=parts;
+  param->group_null_parts=null_parts;
 }
 
 
@@ -17240,6 +18626,16 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
           extra.append(STRING_WITH_LEN("; Using "));
           tab->select->quick->add_info_string(&extra);
         }
+        if (table->file->pushed_idx_cond)
+        {
+          uint keyno= MAX_KEY;
+          if (tab->ref.key_parts)
+            keyno= tab->ref.key;
+          else if (tab->select && tab->select->quick)
+            keyno= tab->select->quick->index;
+          if (keyno == table->file->pushed_idx_cond_keyno)
+            extra.append(STRING_WITH_LEN("; Using index condition"));
+        }
 	if (tab->select)
 	{
 	  if (tab->use_quick == 2)
@@ -17324,7 +18720,13 @@ static void select_describe(JOIN *join, bool need_tmp_table, bool need_order,
           }
         }
         if (i > 0 && tab[-1].next_select == sub_select_cache)
+        {
           extra.append(STRING_WITH_LEN("; Using join buffer"));
+          if (tab->cache.bka)
+            extra.append(STRING_WITH_LEN(" (Batched Key Access)"));
+          else if (tab->cache.hash)
+            extra.append(STRING_WITH_LEN(" (Hash Join)"));
+        }
         
         /* Skip initial "; "*/
         const char *str= extra.ptr();
@@ -17359,6 +18761,12 @@ bool mysql_explain_union(THD *thd, SELECT_LEX_UNIT *unit, select_result *result)
   bool res= 0;
   SELECT_LEX *first= unit->first_select();
 
+  /* An IN subquery that is materialized, see Item_in_subselect */
+  bool materialized= (unit->item &&
+                      unit->item->substype() == Item_subselect::IN_SUBS &&
+                      ((Item_in_subselect *) unit->item)->exec_method ==
+                      Item_in_subselect::EXEC_MATERIALIZATION);
+
   for (SELECT_LEX *sl= first;
        sl;
        sl= sl->next_select())
@@ -17374,6 +18782,7 @@ bool mysql_explain_union(THD *thd, SELECT_LEX_UNIT *unit, select_result *result)
 		 ((uncacheable & UNCACHEABLE_DEPENDENT) ?
 		  "DEPENDENT SUBQUERY":
 		  (uncacheable?"UNCACHEABLE SUBQUERY":
+		   materialized?"MATERIALIZED":
 		   "SUBQUERY"))):
 		((uncacheable & UNCACHEABLE_DEPENDENT) ?
 		 "DEPENDENT UNION":
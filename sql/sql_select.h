@@ -124,6 +124,35 @@ typedef struct st_join_cache {
   uint records,record_nr,ptr_record,fields,length,blobs;
   CACHE_FIELD *field,**blob_ptr;
   SQL_SELECT *select;
+  /*
+    Batched Key Access: the table is read with ref access for all the
+    cached records at once, see flush_cached_records_bka()
+  */
+  bool bka;
+  uint bka_max_records;                 /* Flush when this many are cached */
+  uint bka_entry_size;                  /* BKA_KEY and the key of a record */
+  uchar *bka_keys;
+  KEY_MULTI_RANGE *bka_ranges;
+  HANDLER_BUFFER bka_mrr_buff;          /* For read_multi_range_first() */
+  /*
+    Hash join: the cached records are put in a hash table on the values
+    of the equalities between the table and the cached tables, see
+    flush_cached_records_hash()
+  */
+  bool hash;
+  bool hash_can_spill;                  /* Partitions may go to disk */
+  bool hash_spilled;                    /* Records are in hash_files */
+  uint hash_fields;                     /* Number of equalities */
+  Item **hash_outer;                    /* Sides on the cached tables */
+  Item **hash_inner;                    /* Sides on the table */
+  uint hash_max_records;                /* Flush when this many are cached */
+  uint hash_n_buckets;
+  uint *hash_buckets;
+  struct st_hash_join_entry *hash_entries;
+  uint hash_partitions;
+  IO_CACHE *hash_files;                 /* Cached records, then rows */
+  uchar *hash_last_record;              /* Copy of the last spilled record */
+  uint hash_last_length;
 } JOIN_CACHE;
 
 
@@ -224,6 +253,8 @@ typedef struct st_join_table {
   ha_rows       read_time;
   
   table_map	dependent,key_dependent;
+  /** Tables that have a field in an equality with a field of this table */
+  table_map     hash_join_tables;
   uint		use_quick,index;
   uint		status;				///< Save status for cache
   uint		used_fields,used_fieldlength,used_blobs;
@@ -638,6 +669,7 @@ TABLE *create_tmp_table(THD *thd,TMP_TABLE_PARAM *param,List<Item> &fields,
 			ulonglong select_options, ha_rows rows_limit,
 			const char* alias);
 void free_tmp_table(THD *thd, TABLE *entry);
+void calc_group_buffer(TMP_TABLE_PARAM *param, ORDER *group);
 void count_field_types(SELECT_LEX *select_lex, TMP_TABLE_PARAM *param, 
                        List<Item> &fields, bool reset_with_sum_func);
 bool setup_copy_fields(THD *thd, TMP_TABLE_PARAM *param,
@@ -25,6 +25,7 @@ typedef struct st_queue QUEUE;
 typedef struct st_sort_field SORT_FIELD;
 
 class Field;
+class THD;
 struct TABLE;
 
 
@@ -78,7 +79,9 @@ typedef struct st_sort_param {
   uint addon_length;        /* Length of added packed fields */
   uint res_length;          /* Length of records in final sorted file/buffer */
   uint keys;				/* Max keys / buffer */
+  uint sort_threads;        /* Threads to sort and merge with */
   ha_rows max_rows,examined_rows;
+  THD *thd;                 /* Thread that does the sort */
   TABLE *sort_form;			/* For quicker make_sortkey */
   SORT_FIELD *local_sortorder;
   SORT_FIELD *end;
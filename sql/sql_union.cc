@@ -103,10 +103,15 @@ bool select_union::flush()
       is_union_distinct  if set, the temporary table will eliminate
                          duplicates on insert
       options            create options
+      group              if set, the temporary table gets a unique key
+                         over these columns that can be used for lookups,
+                         see subselect_materialize_engine
+      key_map            bitmap of the columns that get a non-unique key,
+                         see mysql_derived_prepare
 
   DESCRIPTION
     Create a temporary table that is used to store the result of a UNION,
-    derived table, or a materialized cursor.
+    derived table, materialized subquery or a materialized cursor.
 
   RETURN VALUE
     0                    The table has been created successfully.
@@ -116,14 +121,18 @@ bool select_union::flush()
 bool
 select_union::create_result_table(THD *thd_arg, List<Item> *column_types,
                                   bool is_union_distinct, ulonglong options,
-                                  const char *alias)
+                                  const char *alias, ORDER *group,
+                                  ulonglong key_map)
 {
   DBUG_ASSERT(table == 0);
   tmp_table_param.init();
   tmp_table_param.field_count= column_types->elements;
+  tmp_table_param.derived_key_map= key_map;
+  if (group)
+    calc_group_buffer(&tmp_table_param, group);
 
   if (! (table= create_tmp_table(thd_arg, &tmp_table_param, *column_types,
-                                 (ORDER*) 0, is_union_distinct, 1,
+                                 group, is_union_distinct, 1,
                                  options, HA_POS_ERROR, alias)))
     return TRUE;
   table->file->extra(HA_EXTRA_WRITE_CACHE);
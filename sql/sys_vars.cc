@@ -36,6 +36,7 @@
 #include <thr_alarm.h>
 #include "slave.h"
 #include "rpl_mi.h"
+#include "rpl_parallel.h"                       // RPL_PARALLEL_MAX_WORKERS
 #include "transaction.h"
 #include "mysqld.h"
 #include "lock.h"
@@ -46,6 +47,7 @@
 #include "sql_base.h"                           // close_cached_tables
 
 #include "log_event.h"
+#include "threadpool.h"
 #ifdef WITH_PERFSCHEMA_STORAGE_ENGINE
 #include "../storage/perfschema/pfs_server.h"
 #endif /* WITH_PERFSCHEMA_STORAGE_ENGINE */
@@ -1519,7 +1521,8 @@ static const char *optimizer_switch_names[]=
 {
   "index_merge", "index_merge_union", "index_merge_sort_union",
   "index_merge_intersection", "engine_condition_pushdown",
-  "default", NullS
+  "batched_key_access", "index_condition_pushdown", "hash_join",
+  "materialization", "derived_merge", "derived_with_keys", "default", NullS
 };
 /** propagates changes to @@engine_condition_pushdown */
 static bool fix_optimizer_switch(sys_var *self, THD *thd,
@@ -1534,7 +1537,9 @@ static Sys_var_flagset Sys_optimizer_switch(
        "optimizer_switch",
        "optimizer_switch=option=val[,option=val...], where option is one of "
        "{index_merge, index_merge_union, index_merge_sort_union, "
-       "index_merge_intersection, engine_condition_pushdown}"
+       "index_merge_intersection, engine_condition_pushdown, "
+       "batched_key_access, index_condition_pushdown, hash_join, "
+       "materialization, derived_merge, derived_with_keys}"
        " and val is one of {on, off, default}",
        SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
        optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT),
@@ -1850,16 +1855,65 @@ static Sys_var_ulong Sys_trans_prealloc_size(
 
 static const char *thread_handling_names[]=
 {
-  "one-thread-per-connection", "no-threads", "loaded-dynamically",
+  "one-thread-per-connection", "no-threads", "pool-of-threads",
+  "loaded-dynamically",
   0
 };
 static Sys_var_enum Sys_thread_handling(
        "thread_handling",
        "Define threads usage for handling queries, one of "
-       "one-thread-per-connection, no-threads, loaded-dynamically"
+       "one-thread-per-connection, no-threads, pool-of-threads, "
+       "loaded-dynamically"
        , READ_ONLY GLOBAL_VAR(thread_handling), CMD_LINE(REQUIRED_ARG),
        thread_handling_names, DEFAULT(0));
 
+#ifdef HAVE_POOL_OF_THREADS
+static Sys_var_uint Sys_threadpool_size(
+       "thread_pool_size",
+       "Number of thread groups in the pool. Each group has its own "
+       "listener and work queue and tries to keep one thread running. "
+       "0 means the number of CPUs. Only used with "
+       "thread_handling=pool-of-threads",
+       READ_ONLY GLOBAL_VAR(threadpool_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, MAX_THREAD_GROUPS), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_threadpool_stall_limit(
+       "thread_pool_stall_limit",
+       "Maximum time in milliseconds a thread group may go without "
+       "picking up new requests before the pool wakes or creates "
+       "another thread in the group",
+       GLOBAL_VAR(threadpool_stall_limit), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(10, UINT_MAX), DEFAULT(500), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_threadpool_max_threads(
+       "thread_pool_max_threads",
+       "Maximum number of worker threads in the pool",
+       READ_ONLY GLOBAL_VAR(threadpool_max_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 65536), DEFAULT(500), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_threadpool_idle_timeout(
+       "thread_pool_idle_timeout",
+       "Time in seconds an idle worker thread waits for work before it exits",
+       GLOBAL_VAR(threadpool_idle_timeout), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, UINT_MAX), DEFAULT(60), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_threadpool_oversubscribe(
+       "thread_pool_oversubscribe",
+       "Number of additional threads per group that may run queries "
+       "at the same time. Higher values give more concurrency at the "
+       "cost of more context switches",
+       GLOBAL_VAR(threadpool_oversubscribe), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1000), DEFAULT(3), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_threadpool_high_prio_tickets(
+       "thread_pool_high_prio_tickets",
+       "Number of times in a row a connection inside a transaction is "
+       "put into the high priority queue of its thread group. 0 disables "
+       "the high priority queue",
+       GLOBAL_VAR(threadpool_high_prio_tickets), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, UINT_MAX), DEFAULT(10), BLOCK_SIZE(1));
+#endif /* HAVE_POOL_OF_THREADS */
+
 #ifdef HAVE_QUERY_CACHE
 static bool fix_query_cache_size(sys_var *self, THD *thd, enum_var_type type)
 {
@@ -2007,6 +2061,13 @@ static Sys_var_ulong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, ULONG_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_sort_threads(
+       "sort_threads",
+       "Number of threads that a sort uses to sort the sort buffer and to "
+       "merge the sorted runs. 1 sorts in the thread of the connection only",
+       SESSION_VAR(sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
 export ulong expand_sql_mode(ulonglong sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -3210,6 +3271,23 @@ static Sys_var_uint Sys_sync_binlog_period(
        GLOBAL_VAR(sync_binlog_period), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, UINT_MAX), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_binlog_group_commit_sync_delay(
+       "binlog_group_commit_sync_delay", "Number of microseconds the "
+       "leader of a binary log group commit waits for more transactions "
+       "to join the group before writing it. Trades commit latency for "
+       "fewer binary log syncs. Use 0 (default) to disable the wait",
+       GLOBAL_VAR(binlog_group_commit_sync_delay), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1000000), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_binlog_group_commit_sync_no_delay_count(
+       "binlog_group_commit_sync_no_delay_count", "Stop waiting for "
+       "binlog_group_commit_sync_delay as soon as this many transactions "
+       "are queued for the group commit. Use 0 (default) to always wait "
+       "the full delay",
+       GLOBAL_VAR(binlog_group_commit_sync_no_delay_count),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 100000), DEFAULT(0),
+       BLOCK_SIZE(1));
+
 static Sys_var_uint Sys_sync_masterinfo_period(
        "sync_master_info", "Synchronously flush master info to disk "
        "after every #th event. Use 0 (default) to disable synchronous flushing",
@@ -3223,6 +3301,14 @@ static Sys_var_ulong Sys_slave_trans_retries(
        "or elapsed lock wait timeout, before giving up and stopping",
        GLOBAL_VAR(slave_trans_retries), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, ULONG_MAX), DEFAULT(10), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_slave_parallel_workers(
+       "slave_parallel_workers", "Number of worker threads that apply "
+       "row-based transactions in parallel, choosing the worker by the "
+       "databases a transaction modifies. 0 (default) applies all events "
+       "in the slave SQL thread. Takes effect at the next START SLAVE",
+       GLOBAL_VAR(opt_slave_parallel_workers), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, RPL_PARALLEL_MAX_WORKERS), DEFAULT(0), BLOCK_SIZE(1));
 #endif
 
 static bool check_locale(sys_var *self, THD *thd, set_var *var)
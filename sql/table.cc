@@ -35,6 +35,7 @@
 #include <m_ctype.h>
 #include "my_md5.h"
 #include "sql_select.h"
+#include "sql_view.h"            // check_duplicate_names
 #include "mdl.h"                 // MDL_wait_for_graph_visitor
 
 /* INFORMATION_SCHEMA name */
@@ -3499,12 +3500,13 @@ void TABLE_LIST::set_underlying_merge()
   if ((tbl= merge_underlying_list))
   {
     /* This is a view. Process all tables of view */
-    DBUG_ASSERT(view && effective_algorithm == VIEW_ALGORITHM_MERGE);
+    DBUG_ASSERT((view || is_merged_derived()) &&
+                effective_algorithm == VIEW_ALGORITHM_MERGE);
     do
     {
       if (tbl->merge_underlying_list)          // This is a view
       {
-        DBUG_ASSERT(tbl->view &&
+        DBUG_ASSERT((tbl->view || tbl->is_merged_derived()) &&
                     tbl->effective_algorithm == VIEW_ALGORITHM_MERGE);
         /*
           This is the only case where set_ancestor is called on an object
@@ -3514,7 +3516,8 @@ void TABLE_LIST::set_underlying_merge()
       }
     } while ((tbl= tbl->next_local));
 
-    if (!multitable_view)
+    /* A merged subquery is never updated, so it has no TABLE of its own */
+    if (!multitable_view && view)
     {
       table= merge_underlying_list->table;
       schema_table= merge_underlying_list->schema_table;
@@ -3523,6 +3526,18 @@ void TABLE_LIST::set_underlying_merge()
 }
 
 
+/**
+  Return the SELECT that a merged view or a merged subquery of the FROM
+  clause is made of.
+*/
+
+st_select_lex *TABLE_LIST::get_merged_select()
+{
+  DBUG_ASSERT(view || is_merged_derived());
+  return view ? &view->select_lex : derived->first_select();
+}
+
+
 /*
   setup fields of placeholder of merged VIEW
 
@@ -3547,7 +3562,7 @@ bool TABLE_LIST::setup_underlying(THD *thd)
   if (!field_translation && merge_underlying_list)
   {
     Field_translator *transl;
-    SELECT_LEX *select= &view->select_lex;
+    SELECT_LEX *select= get_merged_select();
     Item *item;
     TABLE_LIST *tbl;
     List_iterator_fast<Item> it(select->item_list);
@@ -3567,6 +3582,31 @@ bool TABLE_LIST::setup_underlying(THD *thd)
       }
     }
 
+    if (!view)
+    {
+      /*
+        Unlike the one of a view, the select list of a merged subquery
+        may still contain '*', has not been checked for duplicate column
+        names and has not been resolved yet.
+      */
+      SELECT_LEX *save_current_select= thd->lex->current_select;
+      thd->lex->current_select= select;
+      bool res= setup_wild(thd, 0, select->item_list, 0, select->with_wild);
+      thd->lex->current_select= save_current_select;
+      if (res || check_duplicate_names(select->item_list, 0))
+        DBUG_RETURN(TRUE);
+
+      const char *save_where= thd->where;
+      thd->where= "field list";
+      List_iterator<Item> li(select->item_list);
+      while ((item= li++))
+      {
+        if (!item->fixed && item->fix_fields(thd, li.ref()))
+          DBUG_RETURN(TRUE);
+      }
+      thd->where= save_where;
+    }
+
     /* Create view fields translation table */
 
     if (!(transl=
@@ -3587,12 +3627,12 @@ bool TABLE_LIST::setup_underlying(THD *thd)
     /* TODO: use hash for big number of fields */
 
     /* full text function moving to current select */
-    if (view->select_lex.ftfunc_list->elements)
+    if (select->ftfunc_list->elements)
     {
       Item_func_match *ifm;
       SELECT_LEX *current_select= thd->lex->current_select;
       List_iterator_fast<Item_func_match>
-        li(*(view->select_lex.ftfunc_list));
+        li(*(select->ftfunc_list));
       while ((ifm= li++))
         current_select->ftfunc_list->push_front(ifm);
     }
@@ -3626,12 +3666,33 @@ bool TABLE_LIST::prep_where(THD *thd, Item **conds,
 
   for (TABLE_LIST *tbl= merge_underlying_list; tbl; tbl= tbl->next_local)
   {
-    if (tbl->view && tbl->prep_where(thd, conds, no_where_clause))
+    if ((tbl->view || tbl->is_merged_derived()) &&
+        tbl->prep_where(thd, conds, no_where_clause))
     {
       DBUG_RETURN(TRUE);
     }
   }
 
+  if (is_merged_derived())
+  {
+    /*
+      Resolve the columns of a merged subquery that the outer query does
+      not refer to, so that errors in them are reported as they are when
+      the subquery is materialized.
+    */
+    const char *save_where= thd->where;
+    thd->where= "field list";
+    for (Field_translator *transl= field_translation;
+         transl < field_translation_end;
+         transl++)
+    {
+      if (!transl->item->fixed &&
+          transl->item->fix_fields(thd, &transl->item))
+        DBUG_RETURN(TRUE);
+    }
+    thd->where= save_where;
+  }
+
   if (where)
   {
     if (!where->fixed && where->fix_fields(thd, &where))
@@ -4015,8 +4076,8 @@ bool TABLE_LIST::set_insert_values(MEM_ROOT *mem_root)
 */
 bool TABLE_LIST::is_leaf_for_name_resolution()
 {
-  return (view || is_natural_join || is_join_columns_complete ||
-          !nested_join);
+  return (view || is_merged_derived() || is_natural_join ||
+          is_join_columns_complete || !nested_join);
 }
 
 
@@ -4378,7 +4439,7 @@ const char *Natural_join_column::table_name()
 const char *Natural_join_column::db_name()
 {
   if (view_field)
-    return table_ref->view_db.str;
+    return table_ref->view ? table_ref->view_db.str : table_ref->db;
 
   /*
     Test that TABLE_LIST::db is the same as TABLE_SHARE::db to
@@ -4532,7 +4593,7 @@ void Field_iterator_table_ref::set_field_iterator()
   /* This is a merge view, so use field_translation. */
   else if (table_ref->field_translation)
   {
-    DBUG_ASSERT(table_ref->view &&
+    DBUG_ASSERT((table_ref->view || table_ref->is_merged_derived()) &&
                 table_ref->effective_algorithm == VIEW_ALGORITHM_MERGE);
     field_it= &view_field_it;
     DBUG_PRINT("info", ("field_it for '%s' is Field_iterator_view",
@@ -4583,6 +4644,8 @@ const char *Field_iterator_table_ref::get_table_name()
 {
   if (table_ref->view)
     return table_ref->view_name.str;
+  else if (table_ref->is_merged_derived())
+    return table_ref->alias;
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->table_name();
 
@@ -4596,6 +4659,8 @@ const char *Field_iterator_table_ref::get_db_name()
 {
   if (table_ref->view)
     return table_ref->view_db.str;
+  else if (table_ref->is_merged_derived())
+    return table_ref->db;
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->db_name();
 
@@ -4615,7 +4680,7 @@ const char *Field_iterator_table_ref::get_db_name()
 
 GRANT_INFO *Field_iterator_table_ref::grant()
 {
-  if (table_ref->view)
+  if (table_ref->view || table_ref->is_merged_derived())
     return &(table_ref->grant);
   else if (table_ref->is_natural_join)
     return natural_join_it.column_ref()->grant();
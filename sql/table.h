@@ -1354,6 +1354,9 @@ enum enum_open_type
        (TABLE_LIST::derived == NULL)
      - subquery - TABLE_LIST::table is a temp table
        (TABLE_LIST::derived != NULL)
+     - merged subquery - underlying tables are joined as for a merge view
+       (TABLE_LIST::derived != NULL and
+        TABLE_LIST::effective_algorithm == VIEW_ALGORITHM_MERGE)
      - information schema table
        (TABLE_LIST::schema_table != NULL)
        NOTICE: for schema tables TABLE_LIST::field_translation may be != NULL
@@ -1574,7 +1577,8 @@ struct TABLE_LIST
   */
   uint8         effective_with_check;
   /** 
-      @brief The view algorithm that is actually used, if this is a view.
+      @brief The view algorithm that is actually used, if this is a view,
+      or VIEW_ALGORITHM_MERGE for a merged subquery in the FROM clause.
       @details One of
       - VIEW_ALGORITHM_UNDEFINED
       - VIEW_ALGORITHM_TMPTABLE
@@ -1787,6 +1791,15 @@ struct TABLE_LIST
   */
   bool is_anonymous_derived_table() const { return derived && !view; }
 
+  /**
+     @brief True if this TABLE_LIST is a subquery in the FROM clause that
+     is merged into the outer SELECT instead of being materialized.
+  */
+  bool is_merged_derived() const
+  { return derived && effective_algorithm == VIEW_ALGORITHM_MERGE; }
+
+  st_select_lex *get_merged_select();
+
   /**
      @brief Returns the name of the database that the referenced table belongs
      to.
@@ -0,0 +1,59 @@
+#ifndef THREADPOOL_INCLUDED
+#define THREADPOOL_INCLUDED
+
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Interface between the generic connection handling code and the
+  pool-of-threads scheduler (--thread-handling=pool-of-threads).
+
+  The scheduler itself (thread groups, the epoll based listener, the
+  timer thread) lives in threadpool_unix.cc. The functions that run a
+  connection's work in the context of a pool worker live in
+  threadpool_common.cc.
+*/
+
+#include "scheduler.h"
+
+#ifdef HAVE_POOL_OF_THREADS
+
+class THD;
+
+#define MAX_THREAD_GROUPS 128
+
+/* Pool sizing and tuning, see the thread_pool_* system variables */
+extern uint threadpool_size;           /* Number of thread groups */
+extern uint threadpool_stall_limit;    /* Stall detection interval, ms */
+extern uint threadpool_max_threads;    /* Maximum number of worker threads */
+extern uint threadpool_idle_timeout;   /* Idle worker lifetime, seconds */
+extern uint threadpool_oversubscribe;  /* Active threads per group limit */
+extern uint threadpool_high_prio_tickets; /* High priority slots in a row */
+
+/* Counters exported as status variables */
+extern int32 tp_stat_threads;          /* Worker threads alive */
+extern int32 tp_stat_idle_threads;     /* Workers waiting for work */
+extern ulong tp_stat_stalls;           /* Stalls resolved by the timer */
+
+/* Run connection work in the context of the current worker thread */
+int  threadpool_add_connection(THD *thd);
+int  threadpool_process_request(THD *thd);
+void threadpool_remove_connection(THD *thd);
+ulonglong threadpool_get_wait_timeout(THD *thd);
+bool threadpool_in_transaction(THD *thd);
+
+#endif /* HAVE_POOL_OF_THREADS */
+
+#endif /* THREADPOOL_INCLUDED */
@@ -0,0 +1,288 @@
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Connection handling for the pool-of-threads scheduler.
+
+  With one-thread-per-connection a connection owns its thread for its
+  whole lifetime, see do_handle_one_connection(). In the thread pool a
+  worker thread runs a single request of a connection and then goes
+  back to the pool, so every request has to attach the THD to the
+  current worker (THR_THD, THR_MALLOC, mysys thread var, PSI thread)
+  and detach it afterwards. The functions in this file do exactly the
+  work of do_handle_one_connection(), split into login, one request,
+  and logout.
+*/
+
+#include "sql_priv.h"
+#include "unireg.h"
+#include "sql_class.h"
+#include "sql_parse.h"                          // do_command
+#include "sql_connect.h"                        // login_connection
+#include "sql_audit.h"                          // mysql_audit_release
+#include "mysqld.h"
+#include "threadpool.h"
+
+#ifdef HAVE_POOL_OF_THREADS
+
+uint threadpool_size;
+uint threadpool_stall_limit;
+uint threadpool_max_threads;
+uint threadpool_idle_timeout;
+uint threadpool_oversubscribe;
+uint threadpool_high_prio_tickets;
+
+/*
+  Thread-specific state of a worker thread that is overwritten while
+  the worker runs a connection's request. The connection brings its
+  own mysys thread var and PSI thread, the worker's own ones are put
+  back when the request is done.
+*/
+
+struct Worker_thread_context
+{
+  PSI_thread *psi_thread;
+  st_my_thread_var *mysys_var;
+
+  void save()
+  {
+#ifdef HAVE_PSI_INTERFACE
+    psi_thread= PSI_server ? PSI_server->get_thread() : NULL;
+#endif
+    mysys_var= my_pthread_getspecific(st_my_thread_var*, THR_KEY_mysys);
+  }
+
+  void restore()
+  {
+#ifdef HAVE_PSI_INTERFACE
+    if (PSI_server)
+      PSI_server->set_thread(psi_thread);
+#endif
+    pthread_setspecific(THR_KEY_mysys, mysys_var);
+    pthread_setspecific(THR_THD, 0);
+    pthread_setspecific(THR_MALLOC, 0);
+  }
+};
+
+
+/**
+  Attach a THD to the current worker thread.
+
+  The stack of the worker is used from here on, so the stack limits of
+  the connection are reset too.
+*/
+
+static bool thread_attach(THD *thd)
+{
+  pthread_setspecific(THR_KEY_mysys, thd->mysys_var);
+  thd->thread_stack= (char*) &thd;
+  thd->mysys_var->stack_ends_here= thd->thread_stack +
+    STACK_DIRECTION * (long) my_thread_stack_size;
+  if (thd->store_globals())
+    return 1;
+#ifdef HAVE_PSI_INTERFACE
+  if (PSI_server)
+    PSI_server->set_thread(thd_get_psi(thd));
+#endif
+  return 0;
+}
+
+
+/**
+  Log in a new connection.
+
+  Creates the per-connection mysys thread var and PSI thread, which
+  stay with the THD when it moves between worker threads.
+
+  @retval 0  the connection is logged in and waits for its first query
+  @retval 1  the connection failed and has to be removed
+*/
+
+int threadpool_add_connection(THD *thd)
+{
+  int retval= 1;
+  Worker_thread_context worker_context;
+  worker_context.save();
+
+  pthread_setspecific(THR_KEY_mysys, 0);
+  my_thread_init();
+  thd->mysys_var= my_pthread_getspecific(st_my_thread_var*, THR_KEY_mysys);
+  if (!thd->mysys_var)
+  {
+    /* Out of memory */
+    worker_context.restore();
+    return 1;
+  }
+
+#ifdef HAVE_PSI_INTERFACE
+  if (PSI_server)
+    thd_set_psi(thd, PSI_server->new_thread(key_thread_one_connection,
+                                            thd, thd->thread_id));
+#endif
+
+  if (thread_attach(thd))
+  {
+    worker_context.restore();
+    return 1;
+  }
+
+  ulonglong now= my_micro_time();
+  thd->prior_thr_create_utime= now;
+  thd->start_utime= now;
+  thd->thr_create_utime= now;
+
+  if (!thd_prepare_connection(thd) && thd_is_connection_alive(thd))
+  {
+    retval= 0;
+    thd->net.reading_or_writing= 1;
+  }
+#ifdef SIGNAL_WITH_VIO_CLOSE
+  /* Set by check_connection(), the connection is idle from now on */
+  thd->clear_active_vio();
+#endif
+
+  worker_context.restore();
+  return retval;
+}
+
+
+/**
+  Process all requests that are available on the connection.
+
+  Normally this is exactly one query. With SSL or buffered reads more
+  data can already be available in the Vio without the socket being
+  readable, so loop until the Vio is drained.
+
+  @retval 0  the connection is alive and waits for the next query
+  @retval 1  the connection has to be removed
+*/
+
+int threadpool_process_request(THD *thd)
+{
+  int retval= 0;
+  Worker_thread_context worker_context;
+  worker_context.save();
+
+  if (thread_attach(thd))
+  {
+    retval= 1;
+    goto end;
+  }
+
+  if (thd->killed == THD::KILL_CONNECTION)
+  {
+    /* Killed by KILL or by the wait_timeout check of the timer thread */
+    retval= 1;
+    goto end;
+  }
+
+  for (;;)
+  {
+    Vio *vio;
+    thd->net.reading_or_writing= 0;
+    mysql_audit_release(thd);
+
+#ifdef SIGNAL_WITH_VIO_CLOSE
+    /*
+      THD::awake() closes the active vio of a running connection. An
+      idle connection has none: closing its socket would silently drop
+      it from the poll descriptor, so tp_post_kill_notification() wakes
+      it up instead.
+    */
+    thd->set_active_vio(thd->net.vio);
+#endif
+    retval= do_command(thd);
+#ifdef SIGNAL_WITH_VIO_CLOSE
+    thd->clear_active_vio();
+#endif
+    if (retval)
+      goto end;
+
+    if (!thd_is_connection_alive(thd))
+    {
+      retval= 1;
+      goto end;
+    }
+
+    vio= thd->net.vio;
+    if (!vio->has_data(vio))
+    {
+      thd->net.reading_or_writing= 1;
+      goto end;
+    }
+  }
+
+end:
+  worker_context.restore();
+  return retval;
+}
+
+
+/**
+  Log out a connection and free the THD.
+
+  Mirrors the end of do_handle_one_connection() and
+  one_thread_per_connection_end(), except that the worker thread
+  continues to live.
+*/
+
+void threadpool_remove_connection(THD *thd)
+{
+  Worker_thread_context worker_context;
+  worker_context.save();
+
+  thread_attach(thd);
+  thd->killed= THD::KILL_CONNECTION;
+  thd->net.reading_or_writing= 0;
+
+  end_connection(thd);
+  close_connection(thd, 0);
+
+  unlink_thd(thd);
+  mysql_mutex_unlock(&LOCK_thd_remove);
+  mysql_mutex_unlock(&LOCK_thread_count);
+  mysql_cond_broadcast(&COND_thread_count);
+
+  /* Frees the connection's mysys thread var and PSI thread */
+  my_thread_end();
+
+  worker_context.restore();
+}
+
+
+/**
+  Absolute time, in microseconds, at which an idle connection is
+  disconnected.
+*/
+
+ulonglong threadpool_get_wait_timeout(THD *thd)
+{
+  return my_micro_time() +
+    1000000ULL * thd->variables.net_wait_timeout;
+}
+
+
+/**
+  Connections inside a multi-statement transaction hold row locks, so
+  the pool prefers them over connections that would start new work.
+*/
+
+bool threadpool_in_transaction(THD *thd)
+{
+  return thd->in_active_multi_stmt_transaction() ||
+         thd->locked_tables_mode != LTM_NONE;
+}
+
+#endif /* HAVE_POOL_OF_THREADS */
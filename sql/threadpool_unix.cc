@@ -0,0 +1,1206 @@
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/*
+  Pool-of-threads scheduler, --thread-handling=pool-of-threads
+
+  Connections are distributed over thread_pool_size thread groups
+  (thread_id modulo number of groups). Each group has
+
+  - an epoll descriptor all idle connections of the group are
+    registered with (EPOLLONESHOT, so an event is delivered once and
+    the connection is re-armed after its request is done),
+  - a work queue of connections with pending requests, split in a high
+    priority part for connections inside a transaction and a normal
+    part,
+  - a set of worker threads. One of the workers at a time acts as the
+    listener: it waits in epoll_wait() and moves network events to the
+    queue. The other workers take connections off the queue, or sleep
+    on their own condition variable when there is nothing to do.
+
+  The goal is to have one active (i.e. not waiting) thread per group.
+  A worker that blocks inside the server (row lock, table lock, MDL,
+  disk I/O, sleep) reports this through thd_wait_begin() and
+  thd_wait_end(), and the group wakes or creates another worker so the
+  CPU is not left idle while the queue is non-empty.
+
+  A timer thread runs every thread_pool_stall_limit milliseconds. It
+  detects stalled groups (no listener and no network events polled, or
+  queued requests not being picked up, e.g. because a long query does
+  not report any waits) and wakes or creates a worker for them. The
+  timer also disconnects connections that exceeded wait_timeout,
+  because idle connections do not sit in a blocking read anymore.
+*/
+
+#include "sql_priv.h"
+#include "unireg.h"
+#include "sql_class.h"
+#include "mysqld.h"
+#include "sql_plist.h"
+#include "threadpool.h"
+
+#ifdef HAVE_POOL_OF_THREADS
+
+#include <sys/epoll.h>
+
+#define MAX_EVENTS 1024
+
+int32 tp_stat_threads;
+int32 tp_stat_idle_threads;
+ulong tp_stat_stalls;
+
+my_atomic_rwlock_t tp_stat_lock;
+
+struct thread_group_t;
+
+/* Per-thread structure of a worker */
+struct worker_thread_t
+{
+  ulonglong event_count;                /* Requests handled */
+  thread_group_t *thread_group;
+  worker_thread_t *next_in_list;
+  worker_thread_t **prev_in_list;
+
+  mysql_cond_t cond;
+  bool woken;
+};
+
+typedef I_P_List<worker_thread_t,
+                 I_P_List_adapter<worker_thread_t,
+                                  &worker_thread_t::next_in_list,
+                                  &worker_thread_t::prev_in_list> >
+worker_list_t;
+
+/* Per-connection structure, stored in thd->scheduler.data */
+struct connection_t
+{
+  THD *thd;
+  thread_group_t *thread_group;
+  connection_t *next_in_queue;
+  connection_t **prev_in_queue;
+  ulonglong abs_wait_timeout;
+  uint tickets;                         /* High priority slots left */
+  bool logged_in;
+  bool bound_to_poll_descriptor;
+  bool waiting;                         /* Between thd_wait_begin/end */
+};
+
+typedef I_P_List<connection_t,
+                 I_P_List_adapter<connection_t,
+                                  &connection_t::next_in_queue,
+                                  &connection_t::prev_in_queue>,
+                 I_P_List_null_counter,
+                 I_P_List_fast_push_back<connection_t> >
+connection_queue_t;
+
+struct thread_group_t
+{
+  mysql_mutex_t mutex;
+  /* Signalled when the last worker exits after shutdown */
+  mysql_cond_t shutdown_cond;
+  connection_queue_t queue;
+  connection_queue_t high_prio_queue;
+  worker_list_t waiting_threads;
+  worker_thread_t *listener;
+  int pollfd;
+  int shutdown_pipe[2];
+  uint thread_count;
+  uint active_thread_count;
+  uint connection_count;
+  /* Network events polled since the last timer tick */
+  uint io_event_count;
+  /* Connections taken off the queue since the last timer tick */
+  uint queue_event_count;
+  ulonglong last_thread_creation_time;
+  bool shutdown;
+  bool stalled;
+};
+
+static thread_group_t all_groups[MAX_THREAD_GROUPS];
+static uint group_count;
+
+/* The timer thread */
+struct pool_timer_t
+{
+  mysql_mutex_t mutex;
+  mysql_cond_t cond;
+  volatile uint64 current_microtime;
+  volatile uint64 next_timeout_check;
+  bool shutdown;
+  pthread_t thread_id;
+};
+
+static pool_timer_t pool_timer;
+static bool threadpool_started= false;
+
+static void queue_put(thread_group_t *thread_group, connection_t *connection);
+static int  wake_thread(thread_group_t *thread_group);
+static void handle_event(connection_t *connection);
+static int  wake_or_create_thread(thread_group_t *thread_group);
+static int  create_worker(thread_group_t *thread_group);
+static void *worker_main(void *param);
+static void check_stall(thread_group_t *thread_group);
+static void connection_abort(connection_t *connection);
+static void set_wait_timeout(connection_t *connection);
+static void set_next_timeout_check(ulonglong abstime);
+static void tp_post_kill_notification(THD *thd);
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_mutex_key key_group_mutex;
+static PSI_mutex_key key_timer_mutex;
+
+static PSI_mutex_info all_threadpool_mutexes[]=
+{
+  { &key_group_mutex, "thread_group_t::mutex", 0},
+  { &key_timer_mutex, "pool_timer_t::mutex", PSI_FLAG_GLOBAL}
+};
+
+static PSI_cond_key key_worker_cond;
+static PSI_cond_key key_group_shutdown_cond;
+static PSI_cond_key key_timer_cond;
+
+static PSI_cond_info all_threadpool_conds[]=
+{
+  { &key_worker_cond, "worker_thread_t::cond", 0},
+  { &key_group_shutdown_cond, "thread_group_t::shutdown_cond", 0},
+  { &key_timer_cond, "pool_timer_t::cond", PSI_FLAG_GLOBAL}
+};
+
+static PSI_thread_key key_worker_thread;
+static PSI_thread_key key_timer_thread;
+
+static PSI_thread_info all_threadpool_threads[]=
+{
+  { &key_worker_thread, "worker_thread", 0},
+  { &key_timer_thread, "timer_thread", PSI_FLAG_GLOBAL}
+};
+
+/**
+  Initialise the performance schema instrumentation points
+  used by the thread pool.
+*/
+static void init_threadpool_psi_keys(void)
+{
+  const char *category= "sql";
+  int count;
+
+  if (PSI_server == NULL)
+    return;
+
+  count= array_elements(all_threadpool_mutexes);
+  PSI_server->register_mutex(category, all_threadpool_mutexes, count);
+
+  count= array_elements(all_threadpool_conds);
+  PSI_server->register_cond(category, all_threadpool_conds, count);
+
+  count= array_elements(all_threadpool_threads);
+  PSI_server->register_thread(category, all_threadpool_threads, count);
+}
+#endif /* HAVE_PSI_INTERFACE */
+
+
+static inline void tp_stat_add(int32 *counter, int32 value)
+{
+  my_atomic_rwlock_wrlock(&tp_stat_lock);
+  my_atomic_add32(counter, value);
+  my_atomic_rwlock_wrunlock(&tp_stat_lock);
+}
+
+
+/*
+  Thin wrappers around epoll.
+
+  Connection descriptors are registered with EPOLLONESHOT: after an
+  event was delivered, the descriptor is disabled until it is re-armed
+  by io_poll_start_read() once the request has been processed. This
+  guarantees that only one worker at a time handles a connection.
+*/
+
+static int io_poll_create()
+{
+  return epoll_create(1);
+}
+
+
+static int io_poll_associate_fd(int pollfd, int fd, void *data)
+{
+  struct epoll_event ev;
+  ev.data.u64= 0;
+  ev.data.ptr= data;
+  ev.events= EPOLLIN | EPOLLET | EPOLLERR | EPOLLRDHUP | EPOLLONESHOT;
+  return epoll_ctl(pollfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+
+static int io_poll_start_read(int pollfd, int fd, void *data)
+{
+  struct epoll_event ev;
+  ev.data.u64= 0;
+  ev.data.ptr= data;
+  ev.events= EPOLLIN | EPOLLET | EPOLLERR | EPOLLRDHUP | EPOLLONESHOT;
+  return epoll_ctl(pollfd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+
+/**
+  Wait for network events.
+
+  @return number of events, 0 on timeout, -1 on error. EINTR is
+  retried.
+*/
+
+static int io_poll_wait(int pollfd, struct epoll_event *events,
+                        int maxevents, int timeout_ms)
+{
+  int ret;
+  do
+  {
+    ret= epoll_wait(pollfd, events, maxevents, timeout_ms);
+  }
+  while (ret == -1 && errno == EINTR);
+  return ret;
+}
+
+
+/* Connection of an event, NULL for the shutdown pipe */
+static inline connection_t *event_get_connection(struct epoll_event *ev)
+{
+  return (connection_t *) ev->data.ptr;
+}
+
+
+/*
+  Work queue handling. All functions expect thread_group->mutex to be
+  held.
+*/
+
+static inline bool queue_is_empty(thread_group_t *thread_group)
+{
+  return thread_group->queue.is_empty() &&
+         thread_group->high_prio_queue.is_empty();
+}
+
+
+/**
+  Put a connection to the high or low priority queue.
+
+  Connections holding row or table locks inside a transaction go to
+  the high priority queue, so they release their locks as soon as
+  possible. To avoid starving other connections, a connection may use
+  at most thread_pool_high_prio_tickets high priority slots in a row.
+*/
+
+static void queue_push(thread_group_t *thread_group, connection_t *connection)
+{
+  if (connection->logged_in && connection->tickets > 0 &&
+      threadpool_in_transaction(connection->thd))
+  {
+    connection->tickets--;
+    thread_group->high_prio_queue.push_back(connection);
+  }
+  else
+  {
+    connection->tickets= threadpool_high_prio_tickets;
+    thread_group->queue.push_back(connection);
+  }
+}
+
+
+static connection_t *queue_get(thread_group_t *thread_group)
+{
+  connection_t *connection;
+
+  if ((connection= thread_group->high_prio_queue.front()))
+    thread_group->high_prio_queue.remove(connection);
+  else if ((connection= thread_group->queue.front()))
+    thread_group->queue.remove(connection);
+  else
+    return NULL;
+
+  thread_group->queue_event_count++;
+  return connection;
+}
+
+
+/**
+  Check whether the group already has enough active threads.
+
+  A stalled group is allowed to go over the limit, otherwise the
+  worker that was woken by the timer could not take the next request.
+*/
+
+static inline bool too_many_threads(thread_group_t *thread_group)
+{
+  return (thread_group->active_thread_count >= 1 + threadpool_oversubscribe
+          && !thread_group->stalled);
+}
+
+
+/**
+  Listener loop of a thread group.
+
+  Waits for network events and either handles the first event itself
+  (if the queue was empty, the listener is the best candidate to run
+  it, its time slice is not used up yet) or puts all events to the
+  queue and wakes a worker if no thread of the group is active.
+
+  @return connection to handle, or NULL on shutdown
+*/
+
+static connection_t *listener(worker_thread_t *current_thread,
+                              thread_group_t *thread_group)
+{
+  connection_t *retval= NULL;
+
+  for (;;)
+  {
+    struct epoll_event ev[MAX_EVENTS];
+    int cnt;
+
+    if (thread_group->shutdown)
+      break;
+
+    cnt= io_poll_wait(thread_group->pollfd, ev, MAX_EVENTS, -1);
+
+    if (cnt <= 0)
+    {
+      DBUG_ASSERT(thread_group->shutdown);
+      break;
+    }
+
+    mysql_mutex_lock(&thread_group->mutex);
+
+    if (thread_group->shutdown)
+    {
+      mysql_mutex_unlock(&thread_group->mutex);
+      break;
+    }
+
+    thread_group->io_event_count+= cnt;
+
+    bool listener_picks_event= queue_is_empty(thread_group);
+
+    for (int i= 0; i < cnt; i++)
+    {
+      connection_t *connection= event_get_connection(&ev[i]);
+      if (!connection)
+        continue;                               // Shutdown pipe
+      if (listener_picks_event && !retval)
+        retval= connection;
+      else
+        queue_push(thread_group, connection);
+    }
+
+    if (retval)
+    {
+      mysql_mutex_unlock(&thread_group->mutex);
+      break;
+    }
+
+    /*
+      Events were queued. Wake a worker only if no thread of the group
+      is running; otherwise the active threads will get to the queue
+      soon, and if they do not, the timer detects the stall.
+    */
+    if (thread_group->active_thread_count == 0 &&
+        !queue_is_empty(thread_group))
+    {
+      if (wake_thread(thread_group) && thread_group->thread_count == 1)
+        create_worker(thread_group);
+    }
+    mysql_mutex_unlock(&thread_group->mutex);
+  }
+
+  return retval;
+}
+
+
+/**
+  Minimum interval between creating threads in a group, in
+  microseconds.
+
+  Threads are created freely while the group is small. Bigger groups
+  throttle thread creation, otherwise a burst of lock waits could
+  quickly create thread_pool_max_threads threads that are never
+  needed again.
+*/
+
+static ulonglong throttling_interval_usec(uint thread_count)
+{
+  if (thread_count < 4)
+    return 0;
+  if (thread_count < 8)
+    return 50 * 1000;
+  if (thread_count < 16)
+    return 100 * 1000;
+  return 200 * 1000;
+}
+
+
+/**
+  Create a new worker thread in the group.
+
+  Must be called with thread_group->mutex held.
+
+  @retval 0   thread created
+  @retval -1  thread_pool_max_threads reached or pthread_create failed
+*/
+
+static int create_worker(thread_group_t *thread_group)
+{
+  pthread_t thread_id;
+  int err;
+
+  if ((uint) tp_stat_threads >= threadpool_max_threads)
+    return -1;
+
+  err= mysql_thread_create(key_worker_thread, &thread_id,
+                           &connection_attrib, worker_main, thread_group);
+  if (err)
+  {
+    sql_print_error("Thread pool: can't create worker thread (errno= %d)",
+                    err);
+    return -1;
+  }
+
+  thread_group->thread_count++;
+  thread_group->active_thread_count++;
+  thread_group->last_thread_creation_time= my_micro_time();
+  tp_stat_add(&tp_stat_threads, 1);
+  return 0;
+}
+
+
+/**
+  Wake a sleeping worker, or create a new one if there is none.
+
+  Must be called with thread_group->mutex held.
+*/
+
+static int wake_or_create_thread(thread_group_t *thread_group)
+{
+  if (thread_group->shutdown)
+    return 0;
+
+  if (wake_thread(thread_group) == 0)
+    return 0;
+
+  if (thread_group->thread_count > thread_group->connection_count)
+    return -1;
+
+  if (thread_group->active_thread_count == 0)
+  {
+    /*
+      Nobody runs in the group: all threads are waiting for locks or
+      I/O. Create a thread right away, one of the waiters might be
+      blocked by a connection that is still in the queue.
+    */
+    return create_worker(thread_group);
+  }
+
+  if (my_micro_time() - thread_group->last_thread_creation_time <
+      throttling_interval_usec(thread_group->thread_count))
+  {
+    /* Throttled, the timer will retry if the group is still stalled */
+    return 0;
+  }
+
+  return create_worker(thread_group);
+}
+
+
+/**
+  Wake the most recently parked worker of the group.
+
+  Waiting threads form a LIFO list: waking the thread that slept the
+  shortest time keeps caches warm and lets the others run into the
+  idle timeout.
+
+  @retval 0  a thread was woken
+  @retval 1  no thread is waiting
+*/
+
+static int wake_thread(thread_group_t *thread_group)
+{
+  worker_thread_t *thread= thread_group->waiting_threads.front();
+  if (thread)
+  {
+    thread->woken= true;
+    thread_group->waiting_threads.remove(thread);
+    mysql_cond_signal(&thread->cond);
+    return 0;
+  }
+  return 1;
+}
+
+
+/**
+  Get the next connection to handle for a worker.
+
+  In order of preference: take a queued connection, become the
+  listener if the group has none, poll one event without waiting, or
+  go to sleep until woken or until thread_pool_idle_timeout expires.
+
+  @return connection to handle, NULL if the thread should exit
+*/
+
+static connection_t *get_event(worker_thread_t *current_thread,
+                               thread_group_t *thread_group,
+                               struct timespec *abstime)
+{
+  connection_t *connection= NULL;
+  int err= 0;
+
+  mysql_mutex_lock(&thread_group->mutex);
+
+  for (;;)
+  {
+    bool oversubscribed= too_many_threads(thread_group);
+
+    if (thread_group->shutdown)
+      break;
+
+    if (!oversubscribed && (connection= queue_get(thread_group)))
+      break;
+
+    if (!thread_group->listener)
+    {
+      thread_group->listener= current_thread;
+      thread_group->active_thread_count--;
+      mysql_mutex_unlock(&thread_group->mutex);
+
+      connection= listener(current_thread, thread_group);
+
+      mysql_mutex_lock(&thread_group->mutex);
+      thread_group->active_thread_count++;
+      thread_group->listener= NULL;
+      break;
+    }
+
+    if (!oversubscribed)
+    {
+      struct epoll_event ev;
+      if (io_poll_wait(thread_group->pollfd, &ev, 1, 0) == 1 &&
+          (connection= event_get_connection(&ev)))
+      {
+        thread_group->io_event_count++;
+        break;
+      }
+    }
+
+    current_thread->woken= false;
+    thread_group->waiting_threads.push_front(current_thread);
+
+    thread_group->active_thread_count--;
+    tp_stat_add(&tp_stat_idle_threads, 1);
+    err= mysql_cond_timedwait(&current_thread->cond, &thread_group->mutex,
+                              abstime);
+    tp_stat_add(&tp_stat_idle_threads, -1);
+    thread_group->active_thread_count++;
+
+    if (!current_thread->woken)
+    {
+      /*
+        Timeout or spurious wakeup. A thread woken by wake_thread() was
+        already removed from the list by the waker.
+      */
+      thread_group->waiting_threads.remove(current_thread);
+    }
+
+    if (err)
+      break;
+  }
+
+  thread_group->stalled= false;
+  mysql_mutex_unlock(&thread_group->mutex);
+
+  return connection;
+}
+
+
+/**
+  Main function of a worker thread.
+*/
+
+static void *worker_main(void *param)
+{
+  worker_thread_t this_thread;
+  thread_group_t *thread_group= (thread_group_t *) param;
+
+  my_thread_init();
+
+  mysql_cond_init(key_worker_cond, &this_thread.cond, NULL);
+  this_thread.thread_group= thread_group;
+  this_thread.event_count= 0;
+
+  for (;;)
+  {
+    connection_t *connection;
+    struct timespec ts;
+    set_timespec(ts, threadpool_idle_timeout);
+    connection= get_event(&this_thread, thread_group, &ts);
+    if (!connection)
+      break;
+    this_thread.event_count++;
+    handle_event(connection);
+  }
+
+  mysql_cond_destroy(&this_thread.cond);
+
+  tp_stat_add(&tp_stat_threads, -1);
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->thread_count--;
+  thread_group->active_thread_count--;
+  if (thread_group->thread_count == 0 && thread_group->shutdown)
+  {
+    /* thread_group_close() waits for this to free the group */
+    mysql_cond_signal(&thread_group->shutdown_cond);
+  }
+  mysql_mutex_unlock(&thread_group->mutex);
+
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Run the login or the next request of a connection and re-arm its
+  descriptor, or remove the connection if it ended.
+*/
+
+static void handle_event(connection_t *connection)
+{
+  int err;
+  THD *thd= connection->thd;
+
+  /* Do not let the timer kill a connection that is running */
+  connection->abs_wait_timeout= ULONGLONG_MAX;
+
+  if (!connection->logged_in)
+  {
+    err= threadpool_add_connection(thd);
+    connection->logged_in= true;
+  }
+  else
+    err= threadpool_process_request(thd);
+
+  if (!err)
+  {
+    int fd= vio_fd(thd->net.vio);
+    set_wait_timeout(connection);
+    if (!connection->bound_to_poll_descriptor)
+    {
+      connection->bound_to_poll_descriptor= true;
+      err= io_poll_associate_fd(connection->thread_group->pollfd, fd,
+                                connection);
+    }
+    else
+      err= io_poll_start_read(connection->thread_group->pollfd, fd,
+                              connection);
+  }
+
+  if (err)
+    connection_abort(connection);
+}
+
+
+static void connection_abort(connection_t *connection)
+{
+  thread_group_t *thread_group= connection->thread_group;
+
+  threadpool_remove_connection(connection->thd);
+
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->connection_count--;
+  mysql_mutex_unlock(&thread_group->mutex);
+
+  my_free(connection);
+}
+
+
+static void set_wait_timeout(connection_t *connection)
+{
+  connection->abs_wait_timeout=
+    threadpool_get_wait_timeout(connection->thd);
+  set_next_timeout_check(connection->abs_wait_timeout);
+}
+
+
+/**
+  Lower the time of the next wait_timeout check, if needed.
+*/
+
+static void set_next_timeout_check(ulonglong abstime)
+{
+  my_atomic_rwlock_wrlock(&tp_stat_lock);
+  for (;;)
+  {
+    uint64 old= my_atomic_load64((volatile int64 *)
+                                 &pool_timer.next_timeout_check);
+    if (abstime >= old)
+      break;
+    if (my_atomic_cas64((volatile int64 *) &pool_timer.next_timeout_check,
+                        (int64 *) &old, (int64) abstime))
+      break;
+  }
+  my_atomic_rwlock_wrunlock(&tp_stat_lock);
+}
+
+
+/**
+  Disconnect idle connections that exceeded wait_timeout.
+
+  Called by the timer thread.
+*/
+
+static void timeout_check(pool_timer_t *timer)
+{
+  THD *thd;
+
+  mysql_mutex_lock(&LOCK_thread_count);
+  I_List_iterator<THD> it(threads);
+
+  timer->next_timeout_check= ULONGLONG_MAX;
+
+  while ((thd= it++))
+  {
+    if (thd->net.reading_or_writing != 1)
+      continue;
+
+    connection_t *connection= (connection_t *) thd_get_scheduler_data(thd);
+    if (!connection)
+      continue;                   // Not a pool connection, e.g. a slave
+
+    if (connection->abs_wait_timeout < timer->current_microtime)
+    {
+      mysql_mutex_lock(&thd->LOCK_thd_data);
+      thd->killed= THD::KILL_CONNECTION;
+      tp_post_kill_notification(thd);
+      mysql_mutex_unlock(&thd->LOCK_thd_data);
+    }
+    else
+      set_next_timeout_check(connection->abs_wait_timeout);
+  }
+  mysql_mutex_unlock(&LOCK_thread_count);
+}
+
+
+/**
+  Main function of the timer thread.
+
+  Checks every thread_pool_stall_limit milliseconds for stalled
+  groups and for connections that exceeded wait_timeout.
+*/
+
+static void *timer_thread(void *param)
+{
+  pool_timer_t *timer= (pool_timer_t *) param;
+
+  my_thread_init();
+
+  timer->next_timeout_check= ULONGLONG_MAX;
+  timer->current_microtime= my_micro_time();
+
+  for (;;)
+  {
+    struct timespec ts;
+    int err;
+
+    set_timespec_nsec(ts, threadpool_stall_limit * 1000000ULL);
+    mysql_mutex_lock(&timer->mutex);
+    err= mysql_cond_timedwait(&timer->cond, &timer->mutex, &ts);
+    if (timer->shutdown)
+    {
+      mysql_mutex_unlock(&timer->mutex);
+      break;
+    }
+    if (err == ETIMEDOUT)
+    {
+      timer->current_microtime= my_micro_time();
+
+      for (uint i= 0; i < group_count; i++)
+      {
+        if (all_groups[i].connection_count)
+          check_stall(&all_groups[i]);
+      }
+
+      if (timer->next_timeout_check <= timer->current_microtime)
+        timeout_check(timer);
+    }
+    mysql_mutex_unlock(&timer->mutex);
+  }
+
+  my_thread_end();
+  return NULL;
+}
+
+
+/**
+  Detect and resolve a stall in a thread group.
+
+  A group is stalled when it has no listener and did not poll any
+  event since the last tick (all threads are busy running queries), or
+  when queued requests were not picked up since the last tick. In both
+  cases another worker is woken or created; a stalled group is also
+  allowed to exceed thread_pool_oversubscribe.
+*/
+
+static void check_stall(thread_group_t *thread_group)
+{
+  if (mysql_mutex_trylock(&thread_group->mutex) != 0)
+  {
+    /* Something happens in the group, no need to disturb it */
+    return;
+  }
+
+  if (!thread_group->listener && !thread_group->io_event_count)
+    wake_or_create_thread(thread_group);
+
+  thread_group->io_event_count= 0;
+
+  if (!queue_is_empty(thread_group) && !thread_group->queue_event_count)
+  {
+    thread_group->stalled= true;
+    tp_stat_stalls++;
+    wake_or_create_thread(thread_group);
+  }
+
+  thread_group->queue_event_count= 0;
+
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+static bool start_timer(pool_timer_t *timer)
+{
+  mysql_mutex_init(key_timer_mutex, &timer->mutex, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_timer_cond, &timer->cond, NULL);
+  timer->shutdown= false;
+  if (mysql_thread_create(key_timer_thread, &timer->thread_id, NULL,
+                          timer_thread, timer))
+  {
+    mysql_cond_destroy(&timer->cond);
+    mysql_mutex_destroy(&timer->mutex);
+    return 1;
+  }
+  return 0;
+}
+
+
+static void stop_timer(pool_timer_t *timer)
+{
+  mysql_mutex_lock(&timer->mutex);
+  timer->shutdown= true;
+  mysql_cond_signal(&timer->cond);
+  mysql_mutex_unlock(&timer->mutex);
+  pthread_join(timer->thread_id, NULL);
+  mysql_cond_destroy(&timer->cond);
+  mysql_mutex_destroy(&timer->mutex);
+}
+
+
+static int thread_group_init(thread_group_t *thread_group)
+{
+  mysql_mutex_init(key_group_mutex, &thread_group->mutex, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_group_shutdown_cond, &thread_group->shutdown_cond, NULL);
+  thread_group->queue.empty();
+  thread_group->high_prio_queue.empty();
+  thread_group->waiting_threads.empty();
+  thread_group->listener= NULL;
+  thread_group->thread_count= 0;
+  thread_group->active_thread_count= 0;
+  thread_group->connection_count= 0;
+  thread_group->io_event_count= 0;
+  thread_group->queue_event_count= 0;
+  thread_group->last_thread_creation_time= 0;
+  thread_group->shutdown= false;
+  thread_group->stalled= false;
+  thread_group->shutdown_pipe[0]= thread_group->shutdown_pipe[1]= -1;
+
+  if ((thread_group->pollfd= io_poll_create()) < 0)
+    goto err;
+  if (pipe(thread_group->shutdown_pipe))
+    goto err;
+  if (io_poll_associate_fd(thread_group->pollfd,
+                           thread_group->shutdown_pipe[0], NULL))
+    goto err;
+  return 0;
+
+err:
+  sql_print_error("Thread pool: can't create poll descriptor (errno= %d)",
+                  errno);
+  if (thread_group->pollfd >= 0)
+    close(thread_group->pollfd);
+  if (thread_group->shutdown_pipe[0] >= 0)
+  {
+    close(thread_group->shutdown_pipe[0]);
+    close(thread_group->shutdown_pipe[1]);
+  }
+  mysql_cond_destroy(&thread_group->shutdown_cond);
+  mysql_mutex_destroy(&thread_group->mutex);
+  return 1;
+}
+
+
+/**
+  Shut down a thread group: wake the listener through the shutdown
+  pipe and all sleeping workers, wait until every worker has exited
+  and free the group's resources.
+*/
+
+static void thread_group_close(thread_group_t *thread_group)
+{
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->shutdown= true;
+  thread_group->listener= NULL;
+
+  if (thread_group->thread_count > 0)
+  {
+    char c= 0;
+    if (write(thread_group->shutdown_pipe[1], &c, 1) < 0)
+      sql_print_warning("Thread pool: can't wake listener (errno= %d)",
+                        errno);
+
+    while (wake_thread(thread_group) == 0)
+    { }
+
+    while (thread_group->thread_count > 0)
+      mysql_cond_wait(&thread_group->shutdown_cond, &thread_group->mutex);
+  }
+  mysql_mutex_unlock(&thread_group->mutex);
+
+  close(thread_group->pollfd);
+  close(thread_group->shutdown_pipe[0]);
+  close(thread_group->shutdown_pipe[1]);
+  thread_group->pollfd= -1;
+  mysql_cond_destroy(&thread_group->shutdown_cond);
+  mysql_mutex_destroy(&thread_group->mutex);
+}
+
+
+/**
+  Queue a new or readable connection and make sure somebody handles
+  it.
+*/
+
+static void queue_put(thread_group_t *thread_group, connection_t *connection)
+{
+  mysql_mutex_lock(&thread_group->mutex);
+  queue_push(thread_group, connection);
+  if (thread_group->active_thread_count == 0)
+    wake_or_create_thread(thread_group);
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+/*
+  scheduler_functions callbacks
+*/
+
+static bool tp_init()
+{
+#ifdef HAVE_PSI_INTERFACE
+  init_threadpool_psi_keys();
+#endif
+
+  my_atomic_rwlock_init(&tp_stat_lock);
+
+  if (threadpool_size == 0)
+    threadpool_size= my_getncpus();
+  group_count= min(threadpool_size, MAX_THREAD_GROUPS);
+
+  for (uint i= 0; i < group_count; i++)
+  {
+    if (thread_group_init(&all_groups[i]))
+    {
+      while (i--)
+        thread_group_close(&all_groups[i]);
+      return 1;
+    }
+  }
+
+  if (start_timer(&pool_timer))
+  {
+    sql_print_error("Thread pool: can't create timer thread");
+    for (uint i= 0; i < group_count; i++)
+      thread_group_close(&all_groups[i]);
+    return 1;
+  }
+
+  threadpool_started= true;
+  return 0;
+}
+
+
+static void tp_end()
+{
+  if (!threadpool_started)
+    return;
+
+  stop_timer(&pool_timer);
+  for (uint i= 0; i < group_count; i++)
+    thread_group_close(&all_groups[i]);
+  my_atomic_rwlock_destroy(&tp_stat_lock);
+  threadpool_started= false;
+}
+
+
+/**
+  Add a new connection to the pool.
+
+  Called by the acceptor with LOCK_thread_count held. Login is done
+  by a worker, so the acceptor is free to accept the next connection.
+*/
+
+static void tp_add_connection(THD *thd)
+{
+  connection_t *connection;
+
+  mysql_mutex_assert_owner(&LOCK_thread_count);
+
+  if (!(connection= (connection_t *) my_malloc(sizeof(connection_t),
+                                               MYF(MY_ZEROFILL))))
+  {
+    thread_count--;
+    thd->killed= THD::KILL_CONNECTION;
+    mysql_mutex_unlock(&LOCK_thread_count);
+
+    mysql_mutex_lock(&LOCK_connection_count);
+    --connection_count;
+    mysql_mutex_unlock(&LOCK_connection_count);
+
+    statistic_increment(aborted_connects, &LOCK_status);
+    close_connection(thd, ER_OUT_OF_RESOURCES);
+    mysql_mutex_lock(&LOCK_thd_remove);
+    mysql_mutex_lock(&LOCK_thread_count);
+    delete thd;
+    mysql_mutex_unlock(&LOCK_thread_count);
+    mysql_mutex_unlock(&LOCK_thd_remove);
+    return;
+  }
+
+  connection->thd= thd;
+  connection->abs_wait_timeout= ULONGLONG_MAX;
+  connection->tickets= threadpool_high_prio_tickets;
+  thd_set_scheduler_data(thd, connection);
+
+  threads.append(thd);
+  mysql_mutex_unlock(&LOCK_thread_count);
+
+  thread_group_t *thread_group= &all_groups[thd->thread_id % group_count];
+  connection->thread_group= thread_group;
+
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->connection_count++;
+  mysql_mutex_unlock(&thread_group->mutex);
+
+  queue_put(thread_group, connection);
+}
+
+
+/**
+  Make a killed idle connection visible to the pool.
+
+  Shutting down the read side of the socket makes epoll report the
+  descriptor as readable; the worker then sees the killed flag and
+  removes the connection. A running connection had its socket closed
+  by THD::awake() already, it notices the kill when its request ends.
+*/
+
+static void tp_post_kill_notification(THD *thd)
+{
+  if (current_thd == thd || thd->system_thread ||
+      !thd_get_scheduler_data(thd) || !thd->net.vio ||
+      vio_fd(thd->net.vio) < 0)
+    return;
+  shutdown(vio_fd(thd->net.vio), SHUT_RD);
+}
+
+
+/**
+  A worker is about to block inside the server.
+
+  If this was the last active thread of the group, wake or create
+  another one so queued requests and network events keep being
+  served.
+*/
+
+static void tp_wait_begin(THD *thd, int type)
+{
+  connection_t *connection;
+
+  if (!thd || !(connection= (connection_t *) thd_get_scheduler_data(thd)))
+    return;
+
+  if (connection->waiting)
+    return;                                     // Nested wait
+
+  connection->waiting= true;
+
+  thread_group_t *thread_group= connection->thread_group;
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->active_thread_count--;
+  if (thread_group->active_thread_count == 0 &&
+      (!queue_is_empty(thread_group) || !thread_group->listener))
+    wake_or_create_thread(thread_group);
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+static void tp_wait_end(THD *thd)
+{
+  connection_t *connection;
+
+  if (!thd || !(connection= (connection_t *) thd_get_scheduler_data(thd)))
+    return;
+
+  if (!connection->waiting)
+    return;
+
+  connection->waiting= false;
+
+  thread_group_t *thread_group= connection->thread_group;
+  mysql_mutex_lock(&thread_group->mutex);
+  thread_group->active_thread_count++;
+  mysql_mutex_unlock(&thread_group->mutex);
+}
+
+
+static scheduler_functions pool_of_threads_scheduler_functions=
+{
+  0,                                     // max_threads
+  tp_init,                               // init
+  NULL,                                  // init_new_connection_thread
+  tp_add_connection,                     // add_connection
+  tp_wait_begin,                         // thd_wait_begin
+  tp_wait_end,                           // thd_wait_end
+  tp_post_kill_notification,             // post_kill_notification
+  NULL,                                  // end_thread
+  tp_end                                 // end
+};
+
+
+/*
+  Initialize scheduler for --thread-handling=pool-of-threads
+*/
+
+void pool_of_threads_scheduler()
+{
+  scheduler_init();
+  pool_of_threads_scheduler_functions.max_threads= threadpool_max_threads;
+  thread_scheduler= &pool_of_threads_scheduler_functions;
+}
+
+#endif /* HAVE_POOL_OF_THREADS */
@@ -624,6 +624,7 @@ bool Unique::get(TABLE *table)
     size;
   sort_param.keys= (uint) (max_in_memory_size / sort_param.sort_length);
   sort_param.not_killable=1;
+  sort_param.thd= current_thd;
 
   if (!(sort_buffer=(uchar*) my_malloc((sort_param.keys+1) *
 				       sort_param.sort_length,
@@ -875,7 +875,7 @@ btr_get_next_user_rec(
 /**************************************************************//**
 Creates a new index page (not the root, and also not
 used in page reorganization).  @see btr_page_empty(). */
-static
+UNIV_INTERN
 void
 btr_page_create(
 /*============*/
@@ -1604,6 +1604,12 @@ btr_page_reorganize_low(
 	ulint		max_ins_size1;
 	ulint		max_ins_size2;
 	ibool		success		= FALSE;
+	/* Read innodb_compression_level once: the image is logged below
+	if the page was compressed at another level than the one that
+	crash recovery redoes MLOG_COMP_PAGE_REORGANIZE at. */
+	ulint		z_level		= recovery
+					  ? DEFAULT_COMPRESSION_LEVEL
+					  : page_zip_level;
 
 	ut_ad(mtr_memo_contains(mtr, block, MTR_MEMO_PAGE_X_FIX));
 	btr_assert_not_corrupted(block, index);
@@ -1667,7 +1673,7 @@ btr_page_reorganize_low(
 
 	if (UNIV_LIKELY_NULL(page_zip)
 	    && UNIV_UNLIKELY
-	    (!page_zip_compress(page_zip, page, index, NULL))) {
+	    (!page_zip_compress(page_zip, page, index, z_level, NULL))) {
 
 		/* Restore the old page and exit. */
 		btr_blob_dbg_restore(page, temp_page, index,
@@ -1736,6 +1742,16 @@ func_exit:
 	/* Restore logging mode */
 	mtr_set_log_mode(mtr, log_mode);
 
+#ifndef UNIV_HOTBACKUP
+	if (success && page_zip && z_level != DEFAULT_COMPRESSION_LEVEL) {
+		/* Crash recovery would redo the MLOG_COMP_PAGE_REORGANIZE
+		record at the default compression level, which may yield a
+		different compressed page.  Log the compressed page image,
+		so that recovery ends up with the same page. */
+		page_zip_compress_write_log(page_zip, page, index, mtr);
+	}
+#endif /* !UNIV_HOTBACKUP */
+
 	return(success);
 }
 
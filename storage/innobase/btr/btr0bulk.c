@@ -0,0 +1,507 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.c
+Bottom-up bulk load of an empty B-tree from sorted index entries
+
+Instead of searching the tree for every entry, the load keeps the
+rightmost page of each level x-latched and appends the records to it.
+When a page has been filled up to the fill factor, a new page is
+allocated to its right and a node pointer to the full page is appended
+to the level above. Finally, the single page of the top level is copied
+to the root page, whose page number is stored in the data dictionary.
+
+Each page is modified in a mini-transaction of its own, which is
+committed when the page is full. New pages are allocated and created in
+a separate mini-transaction, so that no page is modified by two
+uncommitted mini-transactions. All latches are released when the redo
+log needs a checkpoint, so that log_free_check() can be called.
+
+*******************************************************/
+
+#include "btr0bulk.h"
+
+#include "btr0btr.h"
+#include "dict0dict.h"
+#include "fsp0fsp.h"
+#include "log0log.h"
+#include "mtr0log.h"
+#include "mtr0mtr.h"
+#include "page0cur.h"
+#include "page0page.h"
+#include "rem0rec.h"
+
+/** The rightmost page of a level of a bulk loaded B-tree */
+typedef struct btr_bulk_level_struct {
+	mtr_t		mtr;	/*!< mini-transaction that x-latches
+				the page and the index tree */
+	buf_block_t*	block;	/*!< the page */
+	ulint		page_no;/*!< page number of block */
+	page_cur_t	cur;	/*!< cursor on the last record */
+	ulint		n_recs;	/*!< number of user records */
+	mem_heap_t*	heap;	/*!< memory heap for the node pointer
+				to the page */
+} btr_bulk_level_t;
+
+/** State of a B-tree bulk load */
+struct btr_bulk_struct {
+	dict_index_t*	index;		/*!< the index */
+	trx_id_t	trx_id;		/*!< PAGE_MAX_TRX_ID of the
+					leaf pages */
+	ulint		reserved;	/*!< bytes that are left free on
+					each page, for the fill factor */
+	ulint		n_levels;	/*!< number of levels so far */
+	btr_bulk_level_t levels[BTR_MAX_LEVELS];
+					/*!< the rightmost page of each
+					level, leaf level first */
+};
+
+/*********************************************************************//**
+Checks if an index can be built with btr_bulk_insert().
+@return	TRUE if the index can be bulk loaded */
+UNIV_INTERN
+ibool
+btr_bulk_is_supported(
+/*==================*/
+	const dict_index_t*	index)	/*!< in: index */
+{
+	/* Clustered index records can contain externally stored
+	columns, and records on compressed pages would have to be
+	compressed one by one, which page_cur_tuple_insert() does
+	not do efficiently. */
+	return(!dict_index_is_clust(index)
+	       && !dict_index_is_ibuf(index)
+	       && !dict_table_zip_size(index->table));
+}
+
+/*********************************************************************//**
+Starts a bulk load of an empty index. The index must not be accessed by
+other threads until btr_bulk_finish() has been called.
+@return	bulk load state, to be freed by btr_bulk_finish() */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,		/*!< in: empty index,
+					btr_bulk_is_supported() */
+	trx_id_t	trx_id,		/*!< in: PAGE_MAX_TRX_ID of the
+					leaf pages */
+	ulint		fill_factor)	/*!< in: percentage of each page that
+					is filled, 10..100 */
+{
+	btr_bulk_t*	bulk;
+
+	ut_ad(btr_bulk_is_supported(index));
+	ut_ad(fill_factor >= 10 && fill_factor <= 100);
+
+	bulk = mem_alloc(sizeof *bulk);
+
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->reserved = UNIV_PAGE_SIZE * (100 - fill_factor) / 100;
+	bulk->n_levels = 0;
+
+	return(bulk);
+}
+
+/*********************************************************************//**
+Allocates and creates a page to the right of the current page of a level,
+in a mini-transaction that is committed before returning.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_page_alloc(
+/*================*/
+	btr_bulk_t*	bulk,		/*!< in/out: bulk load */
+	ulint		level,		/*!< in: B-tree level */
+	ulint		prev_page_no,	/*!< in: the current page of the
+					level, or FIL_NULL */
+	ulint*		page_no)	/*!< out: the new page */
+{
+	dict_index_t*	index = bulk->index;
+	buf_block_t*	block;
+	page_t*		page;
+	ulint		n_reserved;
+	mtr_t		mtr;
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, index->space, 1,
+				      FSP_NORMAL, &mtr)) {
+		mtr_commit(&mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	block = btr_page_alloc(index, prev_page_no == FIL_NULL
+			       ? 0 : prev_page_no + 1,
+			       FSP_UP, level, &mtr, &mtr);
+
+	fil_space_release_free_extents(index->space, n_reserved);
+
+	if (UNIV_UNLIKELY(block == NULL)) {
+		mtr_commit(&mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	btr_page_create(block, NULL, index, level, &mtr);
+
+	page = buf_block_get_frame(block);
+
+	btr_page_set_prev(page, NULL, prev_page_no, &mtr);
+	btr_page_set_next(page, NULL, FIL_NULL, &mtr);
+
+	if (level == 0) {
+		page_update_max_trx_id(block, NULL, bulk->trx_id, &mtr);
+	}
+
+	*page_no = buf_block_get_page_no(block);
+
+	mtr_commit(&mtr);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Starts the mini-transaction of a level and x-latches its page. The cursor
+is positioned on the last record of the page. */
+static
+void
+btr_bulk_level_latch(
+/*=================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint		level)	/*!< in: B-tree level */
+{
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	dict_index_t*		index = bulk->index;
+	page_t*			page;
+
+	mtr_start(&lvl->mtr);
+	mtr_x_lock(dict_index_get_lock(index), &lvl->mtr);
+
+	lvl->block = btr_block_get(index->space, 0, lvl->page_no,
+				   RW_X_LATCH, index, &lvl->mtr);
+
+	page = buf_block_get_frame(lvl->block);
+
+	ut_ad(btr_page_get_level(page, &lvl->mtr) == level);
+	ut_ad(btr_page_get_next(page, &lvl->mtr) == FIL_NULL);
+
+	page_cur_position(page_rec_get_prev(page_get_supremum_rec(page)),
+			  lvl->block, &lvl->cur);
+}
+
+/*********************************************************************//**
+Commits the mini-transactions of the levels above a level, so that
+log_free_check() can be called, which needs that no page latches are
+held. */
+static
+void
+btr_bulk_log_free_check(
+/*====================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint		level)	/*!< in: the mini-transaction of this level
+				and the ones below have been committed */
+{
+	ulint	i;
+
+	if (!log_sys->check_flush_or_checkpoint) {
+
+		return;
+	}
+
+	for (i = level + 1; i < bulk->n_levels; i++) {
+		mtr_commit(&bulk->levels[i].mtr);
+	}
+
+	log_free_check();
+
+	for (i = level + 1; i < bulk->n_levels; i++) {
+		btr_bulk_level_latch(bulk, i);
+	}
+}
+
+static
+ulint
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,
+	const dtuple_t*	tuple,
+	ulint		level);
+
+/*********************************************************************//**
+Appends the node pointer to the current page of a level to the level
+above.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_node_ptr_insert(
+/*=====================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint		level)	/*!< in: B-tree level of the child page */
+{
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	const page_t*		page = buf_block_get_frame(lvl->block);
+	dtuple_t*		node_ptr;
+	ulint			err;
+
+	ut_ad(lvl->n_recs > 0);
+
+	node_ptr = dict_index_build_node_ptr(
+		bulk->index, page_rec_get_next_const(
+			page_get_infimum_rec(page)),
+		lvl->page_no, lvl->heap, level);
+
+	err = btr_bulk_insert_low(bulk, node_ptr, level + 1);
+
+	mem_heap_empty(lvl->heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Finishes the current page of a level, and continues on a new page to
+its right.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_page_next(
+/*===============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	ulint		level)	/*!< in: B-tree level */
+{
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	ulint			page_no;
+	ulint			err;
+
+	err = btr_bulk_page_alloc(bulk, level, lvl->page_no, &page_no);
+
+	if (err != DB_SUCCESS) {
+
+		return(err);
+	}
+
+	btr_page_set_next(buf_block_get_frame(lvl->block), NULL,
+			  page_no, &lvl->mtr);
+
+	err = btr_bulk_node_ptr_insert(bulk, level);
+
+	mtr_commit(&lvl->mtr);
+
+	if (level == 0) {
+		btr_bulk_log_free_check(bulk, level);
+	}
+
+	lvl->page_no = page_no;
+	lvl->n_recs = 0;
+	btr_bulk_level_latch(bulk, level);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Appends a record to a level of the B-tree, starting the level if it
+does not exist yet.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+static
+ulint
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	tuple,	/*!< in: index entry or node pointer */
+	ulint		level)	/*!< in: B-tree level */
+{
+	btr_bulk_level_t*	lvl = &bulk->levels[level];
+	dict_index_t*		index = bulk->index;
+	rec_t*			rec;
+	ulint			err;
+
+	ut_ad(level <= bulk->n_levels);
+
+	if (level == bulk->n_levels) {
+		if (UNIV_UNLIKELY(level >= BTR_MAX_LEVELS - 1)) {
+			/* This cannot happen unless the fill factor
+			leaves room for only two records per page and
+			the index has trillions of records. */
+			return(DB_OUT_OF_FILE_SPACE);
+		}
+
+		err = btr_bulk_page_alloc(bulk, level, FIL_NULL,
+					  &lvl->page_no);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		lvl->n_recs = 0;
+		lvl->heap = mem_heap_create(1024);
+		btr_bulk_level_latch(bulk, level);
+		bulk->n_levels++;
+	} else if (lvl->n_recs >= 2 && bulk->reserved
+		   && page_get_max_insert_size(
+			   buf_block_get_frame(lvl->block), 1)
+		   < rec_get_converted_size(index, tuple, 0)
+		   + bulk->reserved) {
+
+		/* Leave the rest of the page free. At least two
+		records are kept on each page, so that the tree does
+		not grow too high. */
+		err = btr_bulk_page_next(bulk, level);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+	}
+
+	rec = page_cur_tuple_insert(&lvl->cur, tuple, index, 0, &lvl->mtr);
+
+	if (UNIV_UNLIKELY(rec == NULL)) {
+		/* The page is full. */
+		ut_a(lvl->n_recs > 0);
+
+		err = btr_bulk_page_next(bulk, level);
+
+		if (err != DB_SUCCESS) {
+
+			return(err);
+		}
+
+		rec = page_cur_tuple_insert(&lvl->cur, tuple, index, 0,
+					    &lvl->mtr);
+
+		/* An empty page always has room for a record. */
+		ut_a(rec);
+	}
+
+	if (level > 0 && lvl->n_recs == 0
+	    && btr_page_get_prev(buf_block_get_frame(lvl->block),
+				 &lvl->mtr) == FIL_NULL) {
+
+		/* The first node pointer on the leftmost page of
+		each non-leaf level must be marked. */
+		btr_set_min_rec_mark(rec, &lvl->mtr);
+	}
+
+	page_cur_position(rec, lvl->block, &lvl->cur);
+	lvl->n_recs++;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Appends an index entry to the B-tree. The entries must be passed in
+ascending order. Leaf pages are filled up to the fill factor; when a page
+is full, a node pointer to it is appended to the level above.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	tuple)	/*!< in: index entry, without
+				externally stored columns */
+{
+	ut_ad(!dtuple_get_n_ext(tuple));
+
+	return(btr_bulk_insert_low(bulk, tuple, 0));
+}
+
+/*********************************************************************//**
+Copies the single page of the top level to the root page, and frees it.
+The mini-transactions of all levels must have been committed. */
+static
+void
+btr_bulk_copy_to_root(
+/*==================*/
+	btr_bulk_t*	bulk)	/*!< in/out: bulk load */
+{
+	dict_index_t*	index = bulk->index;
+	ulint		level = bulk->n_levels - 1;
+	buf_block_t*	root_block;
+	buf_block_t*	block;
+	mtr_t		mtr;
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_block_get(index->space, 0, dict_index_get_page(index),
+				   RW_X_LATCH, index, &mtr);
+	block = btr_block_get(index->space, 0, bulk->levels[level].page_no,
+			      RW_X_LATCH, index, &mtr);
+
+	ut_ad(page_get_n_recs(buf_block_get_frame(root_block)) == 0);
+	ut_ad(btr_page_get_prev(buf_block_get_frame(block), &mtr)
+	      == FIL_NULL);
+
+	btr_page_set_level(buf_block_get_frame(root_block), NULL, level, &mtr);
+
+	page_copy_rec_list_end(root_block, block,
+			       page_get_infimum_rec(buf_block_get_frame(block)),
+			       index, &mtr);
+
+	btr_page_free(index, block, &mtr);
+
+	/* The records now live in the root page. Do not let the freed
+	page pass for a page of the index while it stays in the buffer
+	pool; page_create() will set the type again if it is reused. */
+	mlog_write_ulint(buf_block_get_frame(block) + FIL_PAGE_TYPE,
+			 FIL_PAGE_TYPE_ALLOCATED, MLOG_2BYTES, &mtr);
+
+	mtr_commit(&mtr);
+}
+
+/*********************************************************************//**
+Completes a bulk load: appends the node pointers to the last page of each
+level and copies the top page of the tree to the root page. The pages of
+a failed load are left to be freed when the index is dropped.
+@return	err, or an error that occurred while completing the load */
+UNIV_INTERN
+ulint
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: bulk load */
+	ulint		err)	/*!< in: DB_SUCCESS, or the error that
+				made the caller stop inserting */
+{
+	ulint	level;
+
+	/* A node pointer insert can add a level, so the number of
+	levels must be checked in every iteration. */
+	for (level = 0;
+	     err == DB_SUCCESS && level + 1 < bulk->n_levels;
+	     level++) {
+
+		err = btr_bulk_node_ptr_insert(bulk, level);
+	}
+
+	for (level = 0; level < bulk->n_levels; level++) {
+		mtr_commit(&bulk->levels[level].mtr);
+		mem_heap_free(bulk->levels[level].heap);
+	}
+
+	if (err == DB_SUCCESS && bulk->n_levels > 0) {
+		btr_bulk_copy_to_root(bulk);
+	}
+
+	mem_free(bulk);
+
+	return(err);
+}
@@ -55,6 +55,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "rem0rec.h"
 #include "rem0cmp.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "row0purge.h"
@@ -374,7 +375,7 @@ btr_cur_search_to_nth_level(
 	btr_cur_t*	cursor, /*!< in/out: tree cursor; the cursor page is
 				s- or x-latched, but see also above! */
 	ulint		has_search_latch,/*!< in: info on the latch mode the
-				caller currently has on btr_search_latch:
+				caller currently has on btr_search_get_latch():
 				RW_S_LATCH, or 0 */
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line where called */
@@ -481,7 +482,8 @@ btr_cur_search_to_nth_level(
 #ifdef UNIV_SEARCH_PERF_STAT
 	info->n_searches++;
 #endif
-	if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_NOT_LOCKED
+	if (rw_lock_get_writer(btr_search_get_latch(index))
+	    == RW_LOCK_NOT_LOCKED
 	    && latch_mode <= BTR_MODIFY_LEAF
 	    && info->last_hash_succ
 	    && !estimate
@@ -517,7 +519,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(index));
 	}
 
 	/* Store the position of the tree latch we push to mtr so that we
@@ -783,7 +785,7 @@ retry_page_get:
 		/* We do a dirty read of btr_search_enabled here.  We
 		will properly check btr_search_enabled again in
 		btr_search_build_page_hash_index() before building a
-		page hash index, while holding btr_search_latch. */
+		page hash index, while holding btr_search_get_latch(). */
 		if (UNIV_LIKELY(btr_search_enabled)) {
 
 			btr_search_info_update(index, cursor);
@@ -805,7 +807,7 @@ func_exit:
 
 	if (has_search_latch) {
 
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(btr_search_get_latch(index));
 	}
 }
 
@@ -1024,6 +1026,142 @@ btr_cur_open_at_rnd_pos_func(
 	}
 }
 
+/**********************************************************************//**
+Issues asynchronous read requests for the leaf pages that follow the
+leaf page on which tuple would be positioned, in key order. The page
+numbers are taken from the node pointers on the level above the leaves,
+so that the read-ahead works also when the leaf pages are not
+physically adjacent. The caller must not hold latches on the index
+tree.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+btr_cur_read_ahead_leaves(
+/*======================*/
+	dict_index_t*	index,	/*!< in: index */
+	const dtuple_t*	tuple,	/*!< in: search tuple of the current
+				position of the scan */
+	ulint		n_pages)/*!< in: number of leaf pages to read
+				ahead; at most BTR_CUR_READ_AHEAD_MAX */
+{
+	page_cur_t	page_cursor;
+	mtr_t		mtr;
+	ulint		page_nos[BTR_CUR_READ_AHEAD_MAX];
+	ulint		n_stored	= 0;
+	ulint		page_no;
+	ulint		space;
+	ulint		zip_size;
+	ulint		height;
+	const rec_t*	rec;
+	const page_t*	page;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+	rec_offs_init(offsets_);
+
+	ut_ad(n_pages <= BTR_CUR_READ_AHEAD_MAX);
+
+	space = dict_index_get_space(index);
+	zip_size = dict_table_zip_size(index->table);
+	page_no = dict_index_get_page(index);
+
+	mtr_start(&mtr);
+
+	/* The s-latch on the index tree prevents changes to the non-leaf
+	levels, which are therefore accessed without page latches, like in
+	btr_cur_search_to_nth_level(). */
+	mtr_s_lock(dict_index_get_lock(index), &mtr);
+
+	height = ULINT_UNDEFINED;
+
+	for (;;) {
+		buf_block_t*	block;
+
+		block = buf_page_get_gen(space, zip_size, page_no,
+					 RW_NO_LATCH, NULL, BUF_GET,
+					 __FILE__, __LINE__, &mtr);
+		page = buf_block_get_frame(block);
+		ut_ad(index->id == btr_page_get_index_id(page));
+
+		if (height == ULINT_UNDEFINED) {
+			/* We are in the root node */
+
+			height = btr_page_get_level(page, &mtr);
+
+			if (height == 0) {
+				/* The whole index fits in the root */
+
+				goto func_exit;
+			}
+		}
+
+		page_cur_search(block, index, tuple, PAGE_CUR_LE,
+				&page_cursor);
+
+		if (height == 1) {
+
+			break;
+		}
+
+		height--;
+
+		rec = page_cur_get_rec(&page_cursor);
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+		/* Go to the child node */
+		page_no = btr_node_ptr_get_child_page_no(rec, offsets);
+	}
+
+	/* The cursor is on the node pointer of the current leaf page.
+	Collect the child page numbers of the following node pointers,
+	moving to the right siblings on this level as needed. */
+
+	rec = page_cur_get_rec(&page_cursor);
+
+	while (n_stored < n_pages) {
+		rec = page_rec_get_next_const(rec);
+
+		if (page_rec_is_supremum(rec)) {
+			buf_block_t*	block;
+
+			page_no = btr_page_get_next(page, &mtr);
+
+			if (page_no == FIL_NULL) {
+
+				break;
+			}
+
+			block = buf_page_get_gen(space, zip_size, page_no,
+						 RW_NO_LATCH, NULL, BUF_GET,
+						 __FILE__, __LINE__, &mtr);
+			page = buf_block_get_frame(block);
+			ut_ad(index->id == btr_page_get_index_id(page));
+
+			rec = page_get_infimum_rec(page);
+			continue;
+		}
+
+		offsets = rec_get_offsets(rec, index, offsets,
+					  ULINT_UNDEFINED, &heap);
+		page_nos[n_stored++] = btr_node_ptr_get_child_page_no(
+			rec, offsets);
+	}
+
+func_exit:
+	mtr_commit(&mtr);
+
+	if (UNIV_LIKELY_NULL(heap)) {
+		mem_heap_free(heap);
+	}
+
+	if (n_stored == 0) {
+
+		return(0);
+	}
+
+	return(buf_read_ahead_logical(space, zip_size, page_nos, n_stored));
+}
+
 /*==================== B-TREE INSERT =========================*/
 
 /*************************************************************//**
@@ -1318,6 +1456,17 @@ fail_err:
 		goto fail;
 	}
 
+	/* If the padding of a compressed index tells that the leaf
+	page would become so full that it is likely to fail to compress,
+	split it instead. */
+	if (UNIV_UNLIKELY(zip_size)
+	    && leaf
+	    && page_get_data_size(page) + rec_size
+	    >= dict_index_zip_pad_optimal_page_size(index)) {
+
+		goto fail;
+	}
+
 	/* Check locks and write to the undo log, if specified */
 	err = btr_cur_ins_lock_and_undo(flags, cursor, entry,
 					thr, mtr, &inherit);
@@ -1751,7 +1900,7 @@ btr_cur_parse_update_in_place(
 	ut_a((ibool)!!page_is_comp(page) == dict_table_is_comp(index->table));
 	rec = page + rec_offset;
 
-	/* We do not need to reserve btr_search_latch, as the page is only
+	/* We do not need to reserve btr_search_get_latch(), as the page is only
 	being recovered, and there cannot be a hash index to it. */
 
 	offsets = rec_get_offsets(rec, index, NULL, ULINT_UNDEFINED, &heap);
@@ -1802,7 +1951,7 @@ btr_cur_update_alloc_zip(
 	}
 
 	if (!page_zip_compress(page_zip, buf_block_get_frame(block),
-			       index, mtr)) {
+			       index, page_zip_level, mtr)) {
 		/* Unable to compress the page */
 		return(FALSE);
 	}
@@ -1926,13 +2075,13 @@ btr_cur_update_in_place(
 			btr_search_update_hash_on_delete(cursor);
 		}
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_search_get_latch(index));
 	}
 
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
 	if (is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(index));
 	}
 
 	if (page_zip && !dict_index_is_clust(index)
@@ -2689,7 +2838,7 @@ btr_cur_parse_del_mark_set_clust_rec(
 	if (page) {
 		rec = page + offset;
 
-		/* We do not need to reserve btr_search_latch, as the page
+		/* We do not need to reserve btr_search_get_latch(), as the page
 		is only being recovered, and there cannot be a hash index to
 		it. Besides, these fields are being updated in place
 		and the adaptive hash index does not depend on them. */
@@ -2772,7 +2921,7 @@ btr_cur_del_mark_set_clust_rec(
 		return(err);
 	}
 
-	/* The btr_search_latch is not needed here, because
+	/* The btr_search_get_latch() is not needed here, because
 	the adaptive hash index does not depend on the delete-mark
 	and the delete-mark is being updated in place. */
 
@@ -2861,7 +3010,7 @@ btr_cur_parse_del_mark_set_sec_rec(
 	if (page) {
 		rec = page + offset;
 
-		/* We do not need to reserve btr_search_latch, as the page
+		/* We do not need to reserve btr_search_get_latch(), as the page
 		is only being recovered, and there cannot be a hash index to
 		it. Besides, the delete-mark flag is being updated in place
 		and the adaptive hash index does not depend on it. */
@@ -2912,7 +3061,7 @@ btr_cur_del_mark_set_sec_rec(
 	ut_ad(!!page_rec_is_comp(rec)
 	      == dict_table_is_comp(cursor->index->table));
 
-	/* We do not need to reserve btr_search_latch, as the
+	/* We do not need to reserve btr_search_get_latch(), as the
 	delete-mark flag is being updated in place and the adaptive
 	hash index does not depend on it. */
 	btr_rec_set_deleted_flag(rec, buf_block_get_page_zip(block), val);
@@ -2937,7 +3086,7 @@ btr_cur_set_deleted_flag_for_ibuf(
 	ibool		val,		/*!< in: value to set */
 	mtr_t*		mtr)		/*!< in/out: mini-transaction */
 {
-	/* We do not need to reserve btr_search_latch, as the page
+	/* We do not need to reserve btr_search_get_latch(), as the page
 	has just been read to the buffer pool and there cannot be
 	a hash index to it.  Besides, the delete-mark flag is being
 	updated in place and the adaptive hash index does not depend
@@ -3695,16 +3844,20 @@ btr_estimate_number_of_different_key_vals(
 		ut_error;
         }
 
+	/* Statistics that are saved in SYS_STATS are used for longer,
+	so that they can afford a bigger sample. */
+	n_sample_pages = srv_stats_persistent
+		? srv_stats_persistent_sample_pages
+		: srv_stats_sample_pages;
+
 	/* It makes no sense to test more pages than are contained
 	in the index, thus we lower the number if it is too high */
-	if (srv_stats_sample_pages > index->stat_index_size) {
+	if (n_sample_pages > index->stat_index_size) {
 		if (index->stat_index_size > 0) {
 			n_sample_pages = index->stat_index_size;
 		} else {
 			n_sample_pages = 1;
 		}
-	} else {
-		n_sample_pages = srv_stats_sample_pages;
 	}
 
 	/* We sample some pages in the index to get an estimate */
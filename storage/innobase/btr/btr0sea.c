@@ -44,7 +44,7 @@ Created 2/17/1996 Heikki Tuuri
 #include "ha0ha.h"
 
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by the latches of all adaptive hash index partitions. */
 UNIV_INTERN char		btr_search_enabled	= TRUE;
 
 #ifdef UNIV_PFS_MUTEX
@@ -64,18 +64,23 @@ UNIV_INTERN ulint		btr_search_n_hash_fail	= 0;
 
 /** padding to prevent other memory update
 hotspots from residing on the same memory
-cache line as btr_search_latch */
+cache line as btr_search_latch_arr */
 UNIV_INTERN byte		btr_sea_pad1[64];
 
-/** The latch protecting the adaptive search system: this latch protects the
-(1) positions of records on those pages where a hash index has been built.
+/** The latches protecting the adaptive hash index partitions: the latch
+of a partition protects the
+(1) positions of records on those pages where a hash index has been built
+for an index mapped to the partition.
 NOTE: It does not protect values of non-ordering fields within a record from
 being updated in-place! We can use fact (1) to perform unique searches to
 indexes. */
 
-/* We will allocate the latch from dynamic memory to get it to the
+/* We will allocate the latches from dynamic memory to get them to the
 same DRAM page as other hotspot semaphores */
-UNIV_INTERN rw_lock_t*		btr_search_latch_temp;
+UNIV_INTERN rw_lock_t*		btr_search_latch_arr;
+
+/** Number of partitions of the adaptive hash index */
+UNIV_INTERN ulint		btr_search_n_parts	= 1;
 
 /** padding to prevent other memory update hotspots from residing on
 the same memory cache line */
@@ -85,7 +90,8 @@ UNIV_INTERN byte		btr_sea_pad2[64];
 UNIV_INTERN btr_search_sys_t*	btr_search_sys;
 
 #ifdef UNIV_PFS_RWLOCK
-/* Key to register btr_search_sys with performance schema */
+/* Key to register the adaptive hash index partition latches
+with performance schema */
 UNIV_INTERN mysql_pfs_key_t	btr_search_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
@@ -127,18 +133,21 @@ allocate a new node to the hash table, it will succeed. However, the check
 will not guarantee success. */
 static
 void
-btr_search_check_free_space_in_heap(void)
-/*=====================================*/
+btr_search_check_free_space_in_heap(
+/*================================*/
+	dict_index_t*	index)	/*!< in: index whose adaptive hash
+				index partition is checked */
 {
 	hash_table_t*	table;
 	mem_heap_t*	heap;
+	rw_lock_t*	latch	= btr_search_get_latch(index);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(index);
 
 	heap = table->heap;
 
@@ -149,7 +158,7 @@ btr_search_check_free_space_in_heap(void)
 	if (heap->free_block == NULL) {
 		buf_block_t*	block = buf_block_alloc(NULL);
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		if (heap->free_block == NULL) {
 			heap->free_block = block;
@@ -157,7 +166,7 @@ btr_search_check_free_space_in_heap(void)
 			buf_block_free(block);
 		}
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 }
 
@@ -167,19 +176,32 @@ UNIV_INTERN
 void
 btr_search_sys_create(
 /*==================*/
-	ulint	hash_size)	/*!< in: hash index hash table size */
+	ulint	hash_size,	/*!< in: hash index hash table size */
+	ulint	n_parts)	/*!< in: number of partitions */
 {
-	/* We allocate the search latch from dynamic memory:
-	see above at the global variable definition */
+	ulint	i;
+
+	ut_a(n_parts > 0);
+
+	btr_search_n_parts = n_parts;
 
-	btr_search_latch_temp = mem_alloc(sizeof(rw_lock_t));
+	/* We allocate the search latches from dynamic memory:
+	see above at the global variable definition */
 
-	rw_lock_create(btr_search_latch_key, &btr_search_latch,
-		       SYNC_SEARCH_SYS);
+	btr_search_latch_arr = mem_alloc(n_parts * sizeof(rw_lock_t));
 
 	btr_search_sys = mem_alloc(sizeof(btr_search_sys_t));
 
-	btr_search_sys->hash_index = ha_create(hash_size, 0, 0);
+	btr_search_sys->hash_index = mem_alloc(
+		n_parts * sizeof(*btr_search_sys->hash_index));
+
+	for (i = 0; i < n_parts; i++) {
+		rw_lock_create(btr_search_latch_key, &btr_search_latch_arr[i],
+			       SYNC_SEARCH_SYS);
+
+		btr_search_sys->hash_index[i] = ha_create(
+			hash_size / n_parts, 0, 0);
+	}
 }
 
 /*****************************************************************//**
@@ -189,15 +211,122 @@ void
 btr_search_sys_free(void)
 /*=====================*/
 {
-	rw_lock_free(&btr_search_latch);
-	mem_free(btr_search_latch_temp);
-	btr_search_latch_temp = NULL;
-	mem_heap_free(btr_search_sys->hash_index->heap);
-	hash_table_free(btr_search_sys->hash_index);
+	ulint	i;
+
+	for (i = 0; i < btr_search_n_parts; i++) {
+		hash_table_t*	table = btr_search_sys->hash_index[i];
+
+		rw_lock_free(&btr_search_latch_arr[i]);
+		mem_heap_free(table->heap);
+		hash_table_free(table);
+	}
+
+	mem_free(btr_search_latch_arr);
+	btr_search_latch_arr = NULL;
+	mem_free(btr_search_sys->hash_index);
 	mem_free(btr_search_sys);
 	btr_search_sys = NULL;
 }
 
+/********************************************************************//**
+X-latches the latches of all adaptive hash index partitions. */
+UNIV_INTERN
+void
+btr_search_x_lock_all(void)
+/*=======================*/
+{
+	ulint	i;
+
+	/* Always acquire the partitions in ascending order, so that
+	two threads latching all of them cannot deadlock. */
+	for (i = 0; i < btr_search_n_parts; i++) {
+		rw_lock_x_lock(&btr_search_latch_arr[i]);
+	}
+}
+
+/********************************************************************//**
+Releases the latches of all adaptive hash index partitions. */
+UNIV_INTERN
+void
+btr_search_x_unlock_all(void)
+/*=========================*/
+{
+	ulint	i;
+
+	for (i = btr_search_n_parts; i--; ) {
+		rw_lock_x_unlock(&btr_search_latch_arr[i]);
+	}
+}
+
+#ifdef UNIV_SYNC_DEBUG
+/********************************************************************//**
+Returns the latch protecting an adaptive hash index partition.
+@return	latch of the partition whose hash table is table */
+UNIV_INTERN
+rw_lock_t*
+btr_search_get_latch_for_table(
+/*===========================*/
+	const hash_table_t*	table)	/*!< in: hash table of an adaptive
+					hash index partition */
+{
+	ulint	i;
+
+	for (i = 0; i < btr_search_n_parts; i++) {
+		if (btr_search_sys->hash_index[i] == table) {
+
+			return(&btr_search_latch_arr[i]);
+		}
+	}
+
+	ut_error;
+
+	return(NULL);
+}
+
+/********************************************************************//**
+Checks if the current thread holds all adaptive hash index latches
+in the given mode.
+@return	TRUE if all partitions are latched */
+UNIV_INTERN
+ibool
+btr_search_own_all(
+/*===============*/
+	ulint	lock_type)	/*!< in: RW_LOCK_SHARED or RW_LOCK_EX */
+{
+	ulint	i;
+
+	for (i = 0; i < btr_search_n_parts; i++) {
+		if (!rw_lock_own(&btr_search_latch_arr[i], lock_type)) {
+
+			return(FALSE);
+		}
+	}
+
+	return(TRUE);
+}
+
+/********************************************************************//**
+Checks if the current thread holds any adaptive hash index latch.
+@return	TRUE if some partition is latched */
+UNIV_INTERN
+ibool
+btr_search_own_any(void)
+/*====================*/
+{
+	ulint	i;
+
+	for (i = 0; i < btr_search_n_parts; i++) {
+		if (rw_lock_own(&btr_search_latch_arr[i], RW_LOCK_SHARED)
+		    || rw_lock_own(&btr_search_latch_arr[i], RW_LOCK_EX)) {
+
+			return(TRUE);
+		}
+	}
+
+	return(FALSE);
+}
+#endif /* UNIV_SYNC_DEBUG */
+
 /********************************************************************//**
 Disable the adaptive hash search system and empty the index. */
 UNIV_INTERN
@@ -206,9 +335,10 @@ btr_search_disable(void)
 /*====================*/
 {
 	dict_table_t*	table;
+	ulint		i;
 
 	mutex_enter(&dict_sys->mutex);
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	btr_search_enabled = FALSE;
 
@@ -231,11 +361,13 @@ btr_search_disable(void)
 	/* Set all block->index = NULL. */
 	buf_pool_clear_hash_index();
 
-	/* Clear the adaptive hash index. */
-	hash_table_clear(btr_search_sys->hash_index);
-	mem_heap_empty(btr_search_sys->hash_index->heap);
+	/* Clear the adaptive hash index partitions. */
+	for (i = 0; i < btr_search_n_parts; i++) {
+		hash_table_clear(btr_search_sys->hash_index[i]);
+		mem_heap_empty(btr_search_sys->hash_index[i]->heap);
+	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /********************************************************************//**
@@ -245,11 +377,11 @@ void
 btr_search_enable(void)
 /*====================*/
 {
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
 
 	btr_search_enabled = TRUE;
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 }
 
 /*****************************************************************//**
@@ -295,26 +427,28 @@ btr_search_info_create(
 
 /*****************************************************************//**
 Returns the value of ref_count. The value is protected by
-btr_search_latch.
+the adaptive hash index latch of the index.
 @return	ref_count value. */
 UNIV_INTERN
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info)	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index)	/*!< in: index */
 {
-	ulint ret;
+	ulint		ret;
+	rw_lock_t*	latch	= btr_search_get_latch(index);
 
 	ut_ad(info);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 	ret = info->ref_count;
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	return(ret);
 }
@@ -334,13 +468,13 @@ btr_search_info_update_hash(
 	ulint		n_unique;
 	int		cmp;
 
+	index = cursor->index;
+
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	index = cursor->index;
-
 	if (dict_index_is_ibuf(index)) {
 		/* So many deletes are performed on an insert buffer tree
 		that we do not consider a hash index useful on it: */
@@ -454,8 +588,10 @@ btr_search_update_block_hash_info(
 				/*!< in: cursor */
 {
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(btr_search_get_latch(cursor->index),
+			   RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(btr_search_get_latch(cursor->index),
+			   RW_LOCK_EX));
 	ut_ad(rw_lock_own(&block->lock, RW_LOCK_SHARED)
 	      || rw_lock_own(&block->lock, RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
@@ -539,7 +675,7 @@ btr_search_update_hash_ref(
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(rw_lock_own(btr_search_get_latch(cursor->index), RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 	      || rw_lock_own(&(block->lock), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
@@ -580,10 +716,10 @@ btr_search_update_hash_ref(
 			mem_heap_free(heap);
 		}
 #ifdef UNIV_SYNC_DEBUG
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+		ut_ad(rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-		ha_insert_for_fold(btr_search_sys->hash_index, fold,
+		ha_insert_for_fold(btr_search_get_hash_index(index), fold,
 				   block, rec);
 	}
 }
@@ -601,10 +737,11 @@ btr_search_info_update_slow(
 	ibool		build_index;
 	ulint*		params;
 	ulint*		params2;
+	rw_lock_t*	latch	= btr_search_get_latch(cursor->index);
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
 	block = btr_cur_get_block(cursor);
@@ -620,7 +757,7 @@ btr_search_info_update_slow(
 
 	if (build_index || (cursor->flag == BTR_CUR_HASH_FAIL)) {
 
-		btr_search_check_free_space_in_heap();
+		btr_search_check_free_space_in_heap(cursor->index);
 	}
 
 	if (cursor->flag == BTR_CUR_HASH_FAIL) {
@@ -630,11 +767,11 @@ btr_search_info_update_slow(
 		btr_search_n_hash_fail++;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 
 	if (build_index) {
@@ -678,7 +815,8 @@ btr_search_check_guess(
 	ibool		can_only_compare_to_cursor_rec,
 				/*!< in: if we do not have a latch on the page
 				of cursor, but only a latch on
-				btr_search_latch, then ONLY the columns
+				the adaptive hash index latch, then ONLY
+				the columns
 				of the record UNDER the cursor are
 				protected, not the next or previous record
 				in the chain: we cannot look at the next or
@@ -833,10 +971,12 @@ btr_search_guess_on_hash(
 					to protect the record! */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive
+					hash index latch of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr)		/*!< in: mtr */
 {
+	rw_lock_t*	latch	= btr_search_get_latch(index);
 	buf_pool_t*	buf_pool;
 	buf_block_t*	block;
 	const rec_t*	rec;
@@ -879,17 +1019,17 @@ btr_search_guess_on_hash(
 	cursor->flag = BTR_CUR_HASH;
 
 	if (UNIV_LIKELY(!has_search_latch)) {
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(latch);
 
 		if (UNIV_UNLIKELY(!btr_search_enabled)) {
 			goto failure_unlock;
 		}
 	}
 
-	ut_ad(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_EX);
-	ut_ad(rw_lock_get_reader_count(&btr_search_latch) > 0);
+	ut_ad(rw_lock_get_writer(latch) != RW_LOCK_EX);
+	ut_ad(rw_lock_get_reader_count(latch) > 0);
 
-	rec = ha_search_and_get_data(btr_search_sys->hash_index, fold);
+	rec = ha_search_and_get_data(btr_search_get_hash_index(index), fold);
 
 	if (UNIV_UNLIKELY(!rec)) {
 		goto failure_unlock;
@@ -907,7 +1047,7 @@ btr_search_guess_on_hash(
 			goto failure_unlock;
 		}
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		buf_block_dbg_add_level(block, SYNC_TREE_NODE_FROM_HASH);
 	}
@@ -929,7 +1069,7 @@ btr_search_guess_on_hash(
 
 	/* Check the validity of the guess within the page */
 
-	/* If we only have the latch on btr_search_latch, not on the
+	/* If we only have the adaptive hash index latch, not on the
 	page, it only protects the columns of the record the cursor
 	is positioned on. We cannot look at the next of the previous
 	record to determine if our guess for the cursor position is
@@ -1004,7 +1144,7 @@ btr_search_guess_on_hash(
 	/*-------------------------------------------*/
 failure_unlock:
 	if (UNIV_LIKELY(!has_search_latch)) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 	}
 failure:
 	cursor->flag = BTR_CUR_HASH_FAIL;
@@ -1047,25 +1187,38 @@ btr_search_drop_page_hash_index(
 	mem_heap_t*		heap;
 	const dict_index_t*	index;
 	ulint*			offsets;
-
-#ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
-#endif /* UNIV_SYNC_DEBUG */
+	rw_lock_t*		latch;
 
 retry:
-	rw_lock_s_lock(&btr_search_latch);
+	/* Peek block->index without a latch in order to find the
+	partition to latch. It can only change between NULL and the
+	index that the page belongs to, and we check it again below
+	while holding the latch of the partition. */
 	index = block->index;
 
 	if (UNIV_LIKELY(!index)) {
 
-		rw_lock_s_unlock(&btr_search_latch);
-
 		return;
 	}
 
+	latch = btr_search_get_latch(index);
+
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
+#endif /* UNIV_SYNC_DEBUG */
+
+	rw_lock_s_lock(latch);
+
+	if (UNIV_UNLIKELY(block->index != index)) {
+
+		rw_lock_s_unlock(latch);
+
+		goto retry;
+	}
+
 	ut_a(!dict_index_is_ibuf(index));
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(index);
 
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
@@ -1077,10 +1230,10 @@ retry:
 	n_bytes = block->curr_n_bytes;
 
 	/* NOTE: The fields of block must not be accessed after
-	releasing btr_search_latch, as the index page might only
-	be s-latched! */
+	releasing the adaptive hash index latch, as the index page
+	might only be s-latched! */
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	ut_a(n_fields + n_bytes > 0);
 
@@ -1131,7 +1284,7 @@ next_rec:
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (UNIV_UNLIKELY(!block->index)) {
 		/* Someone else has meanwhile dropped the hash index */
@@ -1147,7 +1300,7 @@ next_rec:
 		/* Someone else has meanwhile built a new hash index on the
 		page, with different parameters */
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		mem_free(folds);
 		goto retry;
@@ -1174,14 +1327,14 @@ cleanup:
 			"InnoDB: the hash index to a page of %s,"
 			" still %lu hash nodes remain.\n",
 			index->name, (ulong) block->n_pointers);
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		ut_ad(btr_search_validate());
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 #else /* UNIV_AHI_DEBUG || UNIV_DEBUG */
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 #endif /* UNIV_AHI_DEBUG || UNIV_DEBUG */
 
 	mem_free(folds);
@@ -1254,36 +1407,39 @@ btr_search_build_page_hash_index(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rw_lock_t*	latch;
 	rec_offs_init(offsets_);
 
 	ut_ad(index);
 	ut_a(!dict_index_is_ibuf(index));
 
+	latch = btr_search_get_latch(index);
+
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED)
 	      || rw_lock_own(&(block->lock), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	if (!btr_search_enabled) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 		return;
 	}
 
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(index);
 	page = buf_block_get_frame(block);
 
 	if (block->index && ((block->curr_n_fields != n_fields)
 			     || (block->curr_n_bytes != n_bytes)
 			     || (block->curr_left_side != left_side))) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		btr_search_drop_page_hash_index(block);
 	} else {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 	}
 
 	n_recs = page_get_n_recs(page);
@@ -1377,9 +1533,9 @@ btr_search_build_page_hash_index(
 		fold = next_fold;
 	}
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(index);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (UNIV_UNLIKELY(!btr_search_enabled)) {
 		goto exit_func;
@@ -1413,7 +1569,7 @@ btr_search_build_page_hash_index(
 	}
 
 exit_func:
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 
 	mem_free(folds);
 	mem_free(recs);
@@ -1439,16 +1595,17 @@ btr_search_move_or_delete_hash_entries(
 					from this page */
 	dict_index_t*	index)		/*!< in: record descriptor */
 {
-	ulint	n_fields;
-	ulint	n_bytes;
-	ibool	left_side;
+	ulint		n_fields;
+	ulint		n_bytes;
+	ibool		left_side;
+	rw_lock_t*	latch	= btr_search_get_latch(index);
 
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(new_block->lock), RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	ut_a(!new_block->index || new_block->index == index);
 	ut_a(!block->index || block->index == index);
@@ -1457,7 +1614,7 @@ btr_search_move_or_delete_hash_entries(
 
 	if (new_block->index) {
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		btr_search_drop_page_hash_index(block);
 
@@ -1474,7 +1631,7 @@ btr_search_move_or_delete_hash_entries(
 		new_block->n_bytes = block->curr_n_bytes;
 		new_block->left_side = left_side;
 
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 		ut_a(n_fields + n_bytes > 0);
 
@@ -1486,7 +1643,7 @@ btr_search_move_or_delete_hash_entries(
 		return;
 	}
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 }
 
 /********************************************************************//**
@@ -1504,6 +1661,7 @@ btr_search_update_hash_on_delete(
 	const rec_t*	rec;
 	ulint		fold;
 	dict_index_t*	index;
+	rw_lock_t*	latch;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	mem_heap_t*	heap		= NULL;
 	rec_offs_init(offsets_);
@@ -1525,7 +1683,8 @@ btr_search_update_hash_on_delete(
 	ut_a(block->curr_n_fields + block->curr_n_bytes > 0);
 	ut_a(!dict_index_is_ibuf(index));
 
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(index);
+	latch = btr_search_get_latch(index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1536,7 +1695,7 @@ btr_search_update_hash_on_delete(
 		mem_heap_free(heap);
 	}
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	if (block->index) {
 		ut_a(block->index == index);
@@ -1544,7 +1703,7 @@ btr_search_update_hash_on_delete(
 		ha_search_and_delete_if_found(table, fold, rec);
 	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 }
 
 /********************************************************************//**
@@ -1562,6 +1721,7 @@ btr_search_update_hash_node_on_insert(
 	buf_block_t*	block;
 	dict_index_t*	index;
 	rec_t*		rec;
+	rw_lock_t*	latch;
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1581,7 +1741,9 @@ btr_search_update_hash_node_on_insert(
 	ut_a(cursor->index == index);
 	ut_a(!dict_index_is_ibuf(index));
 
-	rw_lock_x_lock(&btr_search_latch);
+	latch = btr_search_get_latch(index);
+
+	rw_lock_x_lock(latch);
 
 	if (!block->index) {
 
@@ -1595,15 +1757,15 @@ btr_search_update_hash_node_on_insert(
 	    && (cursor->n_bytes == block->curr_n_bytes)
 	    && !block->curr_left_side) {
 
-		table = btr_search_sys->hash_index;
+		table = btr_search_get_hash_index(index);
 
 		ha_search_and_update_if_found(table, cursor->fold, rec,
 					      block, page_rec_get_next(rec));
 
 func_exit:
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	} else {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -1636,11 +1798,13 @@ btr_search_update_hash_on_insert(
 	mem_heap_t*	heap		= NULL;
 	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
 	ulint*		offsets		= offsets_;
+	rw_lock_t*	latch;
 	rec_offs_init(offsets_);
 
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(cursor->index);
+	latch = btr_search_get_latch(cursor->index);
 
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(cursor->index);
 
 	rec = btr_cur_get_rec(cursor);
 
@@ -1685,7 +1849,7 @@ btr_search_update_hash_on_insert(
 	} else {
 		if (left_side) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1703,7 +1867,7 @@ btr_search_update_hash_on_insert(
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1725,7 +1889,7 @@ check_next_rec:
 		if (!left_side) {
 
 			if (!locked) {
-				rw_lock_x_lock(&btr_search_latch);
+				rw_lock_x_lock(latch);
 
 				locked = TRUE;
 
@@ -1744,7 +1908,7 @@ check_next_rec:
 
 		if (!locked) {
 
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 
 			locked = TRUE;
 
@@ -1771,19 +1935,22 @@ function_exit:
 		mem_heap_free(heap);
 	}
 	if (locked) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 }
 
 #if defined UNIV_AHI_DEBUG || defined UNIV_DEBUG
 /********************************************************************//**
-Validates the search system.
+Validates one partition of the search system.
 @return	TRUE if ok */
-UNIV_INTERN
+static
 ibool
-btr_search_validate(void)
+btr_search_validate_part(
 /*=====================*/
+	ulint	part)	/*!< in: partition number */
 {
+	hash_table_t*	table		= btr_search_sys->hash_index[part];
+	rw_lock_t*	latch		= &btr_search_latch_arr[part];
 	ha_node_t*	node;
 	ulint		n_page_dumps	= 0;
 	ibool		ok		= TRUE;
@@ -1794,28 +1961,28 @@ btr_search_validate(void)
 	ulint*		offsets		= offsets_;
 
 	/* How many cells to check before temporarily releasing
-	btr_search_latch. */
+	the partition latch. */
 	ulint		chunk_size = 10000;
 
 	rec_offs_init(offsets_);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 	buf_pool_mutex_enter_all();
 
-	cell_count = hash_get_n_cells(btr_search_sys->hash_index);
+	cell_count = hash_get_n_cells(table);
 
 	for (i = 0; i < cell_count; i++) {
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if ((i != 0) && ((i % chunk_size) == 0)) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			buf_pool_mutex_enter_all();
 		}
 
-		node = hash_get_nth_cell(btr_search_sys->hash_index, i)->node;
+		node = hash_get_nth_cell(table, i)->node;
 
 		for (; node != NULL; node = node->next) {
 			const buf_block_t*	block
@@ -1852,8 +2019,8 @@ btr_search_validate(void)
 				buf_LRU_block_remove_hashed_page().
 				After that, it invokes
 				btr_search_drop_page_hash_index() to
-				remove the block from
-				btr_search_sys->hash_index. */
+				remove the block from its
+				btr_search_sys->hash_index partition. */
 
 				ut_a(buf_block_get_state(block)
 				     == BUF_BLOCK_REMOVE_HASH);
@@ -1920,27 +2087,47 @@ btr_search_validate(void)
 	for (i = 0; i < cell_count; i += chunk_size) {
 		ulint end_index = ut_min(i + chunk_size - 1, cell_count - 1);
 
-		/* We release btr_search_latch every once in a while to
+		/* We release the partition latch every once in a while to
 		give other queries a chance to run. */
 		if (i != 0) {
 			buf_pool_mutex_exit_all();
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 			os_thread_yield();
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			buf_pool_mutex_enter_all();
 		}
 
-		if (!ha_validate(btr_search_sys->hash_index, i, end_index)) {
+		if (!ha_validate(table, i, end_index)) {
 			ok = FALSE;
 		}
 	}
 
 	buf_pool_mutex_exit_all();
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
 	}
 
 	return(ok);
 }
+
+/********************************************************************//**
+Validates the search system.
+@return	TRUE if ok */
+UNIV_INTERN
+ibool
+btr_search_validate(void)
+/*=====================*/
+{
+	ibool	ok	= TRUE;
+	ulint	i;
+
+	for (i = 0; i < btr_search_n_parts; i++) {
+		if (!btr_search_validate_part(i)) {
+			ok = FALSE;
+		}
+	}
+
+	return(ok);
+}
 #endif /* defined UNIV_AHI_DEBUG || defined UNIV_DEBUG */
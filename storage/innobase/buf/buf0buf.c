@@ -51,6 +51,8 @@ Created 11/5/1995 Heikki Tuuri
 #include "dict0dict.h"
 #include "log0recv.h"
 #include "page0zip.h"
+#include "ut0crc32.h"
+#include "buf0dump.h"
 
 /*
 		IMPLEMENTATION OF THE BUFFER POOL
@@ -422,6 +424,12 @@ buf_get_total_stat(
 		tot_stat->n_ra_pages_read_rnd += buf_stat->n_ra_pages_read_rnd;
 		tot_stat->n_ra_pages_read += buf_stat->n_ra_pages_read;
 		tot_stat->n_ra_pages_evicted += buf_stat->n_ra_pages_evicted;
+		tot_stat->n_ra_pages_read_logical
+			+= buf_stat->n_ra_pages_read_logical;
+		tot_stat->n_ra_pages_logical_used
+			+= buf_stat->n_ra_pages_logical_used;
+		tot_stat->n_ra_pages_logical_evicted
+			+= buf_stat->n_ra_pages_logical_evicted;
 		tot_stat->n_pages_made_young += buf_stat->n_pages_made_young;
 
 		tot_stat->n_pages_not_made_young +=
@@ -513,6 +521,121 @@ buf_calc_page_old_checksum(
 	return(checksum);
 }
 
+/********************************************************************//**
+Calculates the CRC32C checksum of a page, over the same fields as
+buf_calc_page_new_checksum(). It is stored to both checksum fields of the
+page when innodb_checksum_algorithm is crc32 or strict_crc32.
+@return	checksum */
+UNIV_INTERN
+ib_uint32_t
+buf_calc_page_crc32(
+/*================*/
+	const byte*	page)	/*!< in: buffer page */
+{
+	ib_uint32_t	checksum;
+
+	/* Skip the fields that buf_calc_page_new_checksum() skips, and
+	for the same reasons. */
+
+	checksum = ut_crc32(page + FIL_PAGE_OFFSET,
+			    FIL_PAGE_FILE_FLUSH_LSN - FIL_PAGE_OFFSET)
+		^ ut_crc32(page + FIL_PAGE_DATA,
+			   UNIV_PAGE_SIZE - FIL_PAGE_DATA
+			   - FIL_PAGE_END_LSN_OLD_CHKSUM);
+
+	return(checksum);
+}
+
+/********************************************************************//**
+Returns the name of a page checksum algorithm.
+@return	name of the algorithm, as used by innodb_checksum_algorithm */
+UNIV_INTERN
+const char*
+buf_checksum_algorithm_name(
+/*========================*/
+	ulint	algo)	/*!< in: srv_checksum_algorithm_t */
+{
+	switch ((srv_checksum_algorithm_t) algo) {
+	case SRV_CHECKSUM_ALGORITHM_CRC32:
+		return("crc32");
+	case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+		return("strict_crc32");
+	case SRV_CHECKSUM_ALGORITHM_INNODB:
+		return("innodb");
+	case SRV_CHECKSUM_ALGORITHM_STRICT_INNODB:
+		return("strict_innodb");
+	case SRV_CHECKSUM_ALGORITHM_NONE:
+		return("none");
+	case SRV_CHECKSUM_ALGORITHM_STRICT_NONE:
+		return("strict_none");
+	}
+
+	ut_error;
+	return(NULL);
+}
+
+/********************************************************************//**
+Checks if the checksum fields of an uncompressed page hold the CRC32C
+checksum of the page.
+@return	TRUE if the checksum is valid */
+static
+ibool
+buf_page_is_checksum_valid_crc32(
+/*=============================*/
+	const byte*	read_buf,	/*!< in: a database page */
+	ulint		checksum_field1,/*!< in: new formula checksum
+					field */
+	ulint		checksum_field2)/*!< in: old formula checksum
+					field */
+{
+	return(checksum_field1 == checksum_field2
+	       && checksum_field1 == buf_calc_page_crc32(read_buf));
+}
+
+/********************************************************************//**
+Checks if the checksum fields of an uncompressed page hold the checksums
+written by innodb_checksum_algorithm=innodb, or by older InnoDB versions.
+A field holding BUF_NO_CHECKSUM_MAGIC is accepted too, because older
+versions wrote it when innodb_checksums was disabled.
+@return	TRUE if the checksums are valid */
+static
+ibool
+buf_page_is_checksum_valid_innodb(
+/*==============================*/
+	const byte*	read_buf,	/*!< in: a database page */
+	ulint		checksum_field1,/*!< in: new formula checksum
+					field */
+	ulint		checksum_field2)/*!< in: old formula checksum
+					field */
+{
+	/* There are 2 valid formulas for checksum_field2:
+
+	1. Very old versions of InnoDB only stored 8 byte lsn to the
+	start and the end of the page.
+
+	2. Newer InnoDB versions store the old formula checksum
+	there. */
+
+	if (checksum_field2 != mach_read_from_4(read_buf + FIL_PAGE_LSN)
+	    && checksum_field2 != BUF_NO_CHECKSUM_MAGIC
+	    && checksum_field2 != buf_calc_page_old_checksum(read_buf)) {
+
+		return(FALSE);
+	}
+
+	/* InnoDB versions < 4.0.14 and < 4.1.1 stored the space id
+	(always equal to 0), to FIL_PAGE_SPACE_OR_CHKSUM */
+
+	if (checksum_field1 != 0
+	    && checksum_field1 != BUF_NO_CHECKSUM_MAGIC
+	    && checksum_field1 != buf_calc_page_new_checksum(read_buf)) {
+
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
 /********************************************************************//**
 Checks if a page is corrupt.
 @return	TRUE if corrupted */
@@ -526,8 +649,8 @@ buf_page_is_corrupted(
 	ulint		zip_size)	/*!< in: size of compressed page;
 					0 for uncompressed pages */
 {
-	ulint		checksum_field;
-	ulint		old_checksum_field;
+	ulint		checksum_field1;
+	ulint		checksum_field2;
 
 	if (UNIV_LIKELY(!zip_size)
 	    && memcmp(read_buf + FIL_PAGE_LSN + 4,
@@ -569,54 +692,70 @@ buf_page_is_corrupted(
 	}
 #endif
 
-	/* If we use checksums validation, make additional check before
-	returning TRUE to ensure that the checksum is not equal to
-	BUF_NO_CHECKSUM_MAGIC which might be stored by InnoDB with checksums
-	disabled. Otherwise, skip checksum calculation and return FALSE */
+	/* If checksum validation is disabled, skip the checksum
+	calculation and return FALSE */
 
-	if (UNIV_LIKELY(srv_use_checksums)) {
-		checksum_field = mach_read_from_4(read_buf
-						  + FIL_PAGE_SPACE_OR_CHKSUM);
+	if (UNIV_UNLIKELY(!srv_use_checksums)) {
 
-		if (UNIV_UNLIKELY(zip_size)) {
-			return(checksum_field != BUF_NO_CHECKSUM_MAGIC
-			       && checksum_field
-			       != page_zip_calc_checksum(read_buf, zip_size));
-		}
+		return(FALSE);
+	}
 
-		old_checksum_field = mach_read_from_4(
-			read_buf + UNIV_PAGE_SIZE
-			- FIL_PAGE_END_LSN_OLD_CHKSUM);
+	if (UNIV_UNLIKELY(zip_size)) {
 
-		/* There are 2 valid formulas for old_checksum_field:
+		return(!page_zip_verify_checksum(read_buf, zip_size));
+	}
 
-		1. Very old versions of InnoDB only stored 8 byte lsn to the
-		start and the end of the page.
+	checksum_field1 = mach_read_from_4(
+		read_buf + FIL_PAGE_SPACE_OR_CHKSUM);
 
-		2. Newer InnoDB versions store the old formula checksum
-		there. */
+	checksum_field2 = mach_read_from_4(
+		read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM);
 
-		if (old_checksum_field != mach_read_from_4(read_buf
-							   + FIL_PAGE_LSN)
-		    && old_checksum_field != BUF_NO_CHECKSUM_MAGIC
-		    && old_checksum_field
-		    != buf_calc_page_old_checksum(read_buf)) {
+	/* A page that has never been written, for example when the data
+	file was extended, is all zeroes and valid with any algorithm */
 
-			return(TRUE);
-		}
-
-		/* InnoDB versions < 4.0.14 and < 4.1.1 stored the space id
-		(always equal to 0), to FIL_PAGE_SPACE_OR_CHKSUM */
+	if (checksum_field1 == 0 && checksum_field2 == 0
+	    && mach_read_from_4(read_buf + FIL_PAGE_LSN) == 0) {
 
-		if (checksum_field != 0
-		    && checksum_field != BUF_NO_CHECKSUM_MAGIC
-		    && checksum_field
-		    != buf_calc_page_new_checksum(read_buf)) {
+		return(FALSE);
+	}
 
-			return(TRUE);
-		}
+	/* The page is accepted with any of the algorithms, unless a strict
+	one is configured. The configured algorithm is tried first, as it
+	is the one that most pages are likely to use. */
+
+	switch ((srv_checksum_algorithm_t) srv_checksum_algorithm) {
+	case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+		return(!buf_page_is_checksum_valid_crc32(
+			       read_buf, checksum_field1, checksum_field2));
+
+	case SRV_CHECKSUM_ALGORITHM_STRICT_INNODB:
+		return(checksum_field1 == BUF_NO_CHECKSUM_MAGIC
+		       || checksum_field2 == BUF_NO_CHECKSUM_MAGIC
+		       || !buf_page_is_checksum_valid_innodb(
+			       read_buf, checksum_field1, checksum_field2));
+
+	case SRV_CHECKSUM_ALGORITHM_STRICT_NONE:
+		return(checksum_field1 != BUF_NO_CHECKSUM_MAGIC
+		       || checksum_field2 != BUF_NO_CHECKSUM_MAGIC);
+
+	case SRV_CHECKSUM_ALGORITHM_CRC32:
+		return(!buf_page_is_checksum_valid_crc32(
+			       read_buf, checksum_field1, checksum_field2)
+		       && !buf_page_is_checksum_valid_innodb(
+			       read_buf, checksum_field1, checksum_field2));
+
+	case SRV_CHECKSUM_ALGORITHM_INNODB:
+	case SRV_CHECKSUM_ALGORITHM_NONE:
+		/* buf_page_is_checksum_valid_innodb() also accepts
+		BUF_NO_CHECKSUM_MAGIC */
+		return(!buf_page_is_checksum_valid_innodb(
+			       read_buf, checksum_field1, checksum_field2)
+		       && !buf_page_is_checksum_valid_crc32(
+			       read_buf, checksum_field1, checksum_field2));
 	}
 
+	ut_error;
 	return(FALSE);
 }
 
@@ -660,9 +799,8 @@ buf_page_print(
 		switch (fil_page_get_type(read_buf)) {
 		case FIL_PAGE_TYPE_ZBLOB:
 		case FIL_PAGE_TYPE_ZBLOB2:
-			checksum = srv_use_checksums
-				? page_zip_calc_checksum(read_buf, zip_size)
-				: BUF_NO_CHECKSUM_MAGIC;
+			checksum = page_zip_calc_checksum(
+				read_buf, zip_size, srv_checksum_algorithm);
 			ut_print_timestamp(stderr);
 			fprintf(stderr,
 				"  InnoDB: Compressed BLOB page"
@@ -693,9 +831,8 @@ buf_page_print(
 				fil_page_get_type(read_buf));
 			/* fall through */
 		case FIL_PAGE_INDEX:
-			checksum = srv_use_checksums
-				? page_zip_calc_checksum(read_buf, zip_size)
-				: BUF_NO_CHECKSUM_MAGIC;
+			checksum = page_zip_calc_checksum(
+				read_buf, zip_size, srv_checksum_algorithm);
 
 			ut_print_timestamp(stderr);
 			fprintf(stderr,
@@ -753,6 +890,14 @@ buf_page_print(
 		(ulong) mach_read_from_4(read_buf
 					 + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID));
 
+	fprintf(stderr,
+		"InnoDB: Page crc32 checksum %lu,"
+		" innodb_checksum_algorithm=%s\n",
+		(ulong) (srv_use_checksums
+			 ? buf_calc_page_crc32(read_buf)
+			 : BUF_NO_CHECKSUM_MAGIC),
+		buf_checksum_algorithm_name(srv_checksum_algorithm));
+
 #ifndef UNIV_HOTBACKUP
 	if (mach_read_from_2(read_buf + TRX_UNDO_PAGE_HDR + TRX_UNDO_PAGE_TYPE)
 	    == TRX_UNDO_INSERT) {
@@ -1302,6 +1447,9 @@ buf_pool_init(
 	the buffer pools and also used as a waiting object during flushing. */
 	buf_pool_ptr = mem_zalloc(n_instances * sizeof *buf_pool_ptr);
 
+	buf_flush_page_cleaner_init();
+	buf_dump_init();
+
 	for (i = 0; i < n_instances; i++) {
 		buf_pool_t*	ptr	= &buf_pool_ptr[i];
 
@@ -1317,7 +1465,8 @@ buf_pool_init(
 	buf_pool_set_sizes();
 	buf_LRU_old_ratio_update(100 * 3/ 8, FALSE);
 
-	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64);
+	btr_search_sys_create(buf_pool_get_curr_size() / sizeof(void*) / 64,
+			      srv_adaptive_hash_index_parts);
 
 	return(DB_SUCCESS);
 }
@@ -1351,7 +1500,7 @@ buf_pool_clear_hash_index(void)
 	ulint	p;
 
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(btr_search_own_all(RW_LOCK_EX));
 #endif /* UNIV_SYNC_DEBUG */
 	ut_ad(!btr_search_enabled);
 
@@ -1368,7 +1517,8 @@ buf_pool_clear_hash_index(void)
 				dict_index_t*	index	= block->index;
 
 				/* We can set block->index = NULL
-				when we have an x-latch on btr_search_latch;
+				when we have an x-latch on the latches of
+				all adaptive hash index partitions;
 				see the comment in buf0buf.h */
 
 				if (!index) {
@@ -1967,19 +2117,21 @@ buf_zip_decompress(
 	ut_ad(buf_block_get_zip_size(block));
 	ut_a(buf_block_get_space(block) != 0);
 
-	if (UNIV_LIKELY(check && stamp_checksum != BUF_NO_CHECKSUM_MAGIC)) {
-		ulint	calc_checksum	= page_zip_calc_checksum(
-			frame, page_zip_get_size(&block->page.zip));
-
-		if (UNIV_UNLIKELY(stamp_checksum != calc_checksum)) {
-			ut_print_timestamp(stderr);
-			fprintf(stderr,
-				"  InnoDB: compressed page checksum mismatch"
-				" (space %u page %u): %lu != %lu\n",
-				block->page.space, block->page.offset,
-				stamp_checksum, calc_checksum);
-			return(FALSE);
-		}
+	if (UNIV_LIKELY(check)
+	    && !page_zip_verify_checksum(
+		    frame, page_zip_get_size(&block->page.zip))) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr,
+			"  InnoDB: compressed page checksum mismatch"
+			" (space %u page %u): stored %lu, calculated %lu"
+			" (innodb_checksum_algorithm=%s)\n",
+			block->page.space, block->page.offset,
+			stamp_checksum,
+			(ulong) page_zip_calc_checksum(
+				frame, page_zip_get_size(&block->page.zip),
+				srv_checksum_algorithm),
+			buf_checksum_algorithm_name(srv_checksum_algorithm));
+		return(FALSE);
 	}
 
 	switch (fil_page_get_type(frame)) {
@@ -2965,6 +3117,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->read_ahead_logical = FALSE;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	HASH_INVALIDATE(bpage, hash);
@@ -0,0 +1,573 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file buf/buf0dump.c
+Dumps the page ids of the buffer pool LRU lists to a file, and loads
+them back after a restart, so that the buffer pool is warm sooner.
+
+The file holds one "space_id,page_no" line per page, the most recently
+used pages of each buffer pool instance first. The load sorts the page
+ids, so that the pages are read in file order, and issues asynchronous
+reads for them in batches.
+
+*******************************************************/
+
+#include "buf0dump.h"
+
+#include "buf0buf.h"
+#include "buf0rea.h"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "ut0sort.h"
+#include "ut0ut.h"
+
+#include <stdarg.h>
+
+/** Number of pages whose reads buf_load() issues at a time */
+#define BUF_LOAD_BATCH_SIZE	64
+
+/** Event that wakes up the buf_dump thread */
+UNIV_INTERN os_event_t	buf_dump_event;
+
+/** TRUE while the buf_dump thread is running */
+UNIV_INTERN ibool	buf_dump_thread_active = FALSE;
+
+/** Set by buf_dump_start() and cleared by the buf_dump thread */
+static volatile ibool	buf_dump_should_start = FALSE;
+
+/** Set by buf_load_start() and cleared by the buf_dump thread */
+static volatile ibool	buf_load_should_start = FALSE;
+
+/** Set by buf_load_abort() and cleared when a load starts */
+static volatile ibool	buf_load_should_abort = FALSE;
+
+/** A page id in a dump, (space id << 32) | page number */
+#define BUF_DUMP_CREATE(space, page)	\
+	(((ib_uint64_t) (space) << 32) | (ib_uint64_t) (page))
+#define BUF_DUMP_SPACE(a)	((ulint) ((a) >> 32))
+#define BUF_DUMP_PAGE(a)	((ulint) ((a) & 0xFFFFFFFFUL))
+
+/*****************************************************************//**
+Creates the event that wakes up the buf_dump thread. It is freed in
+os_sync_free(). */
+UNIV_INTERN
+void
+buf_dump_init(void)
+/*===============*/
+{
+	buf_dump_event = os_event_create(NULL);
+}
+
+/*****************************************************************//**
+Wakes up the buf_dump thread to dump the page ids of the buffer pool
+into innodb_buffer_pool_filename. Does not wait for the dump to finish. */
+UNIV_INTERN
+void
+buf_dump_start(void)
+/*================*/
+{
+	buf_dump_should_start = TRUE;
+	os_event_set(buf_dump_event);
+}
+
+/*****************************************************************//**
+Wakes up the buf_dump thread to load the pages listed in
+innodb_buffer_pool_filename into the buffer pool. Does not wait for the
+load to finish. */
+UNIV_INTERN
+void
+buf_load_start(void)
+/*================*/
+{
+	buf_load_should_start = TRUE;
+	os_event_set(buf_dump_event);
+}
+
+/*****************************************************************//**
+Aborts a buffer pool load that is in progress. The pages whose reads
+were already issued stay in the buffer pool. */
+UNIV_INTERN
+void
+buf_load_abort(void)
+/*================*/
+{
+	buf_load_should_abort = TRUE;
+}
+
+/*****************************************************************//**
+Formats a message into a status variable, and also prints it to the
+error log if it is an error or the end of a dump or load. */
+static
+void
+buf_dump_status_low(
+/*================*/
+	char*		status,	/*!< out: status variable */
+	ibool		print,	/*!< in: TRUE=print to the error log */
+	const char*	fmt,	/*!< in: format */
+	va_list		ap)	/*!< in: arguments */
+{
+	ut_vsnprintf(status, sizeof export_vars.innodb_buffer_pool_dump_status,
+		     fmt, ap);
+
+	if (print) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, " InnoDB: %s\n", status);
+	}
+}
+
+/*****************************************************************//**
+Sets Innodb_buffer_pool_dump_status. */
+static
+void
+buf_dump_status(
+/*============*/
+	ibool		print,	/*!< in: TRUE=print to the error log */
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: arguments */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+	buf_dump_status_low(export_vars.innodb_buffer_pool_dump_status,
+			    print, fmt, ap);
+	va_end(ap);
+}
+
+/*****************************************************************//**
+Sets Innodb_buffer_pool_load_status. */
+static
+void
+buf_load_status(
+/*============*/
+	ibool		print,	/*!< in: TRUE=print to the error log */
+	const char*	fmt,	/*!< in: format */
+	...)			/*!< in: arguments */
+{
+	va_list	ap;
+
+	va_start(ap, fmt);
+	buf_dump_status_low(export_vars.innodb_buffer_pool_load_status,
+			    print, fmt, ap);
+	va_end(ap);
+}
+
+/*****************************************************************//**
+Builds the full name of the dump file from innodb_buffer_pool_filename,
+which is relative to the InnoDB data home directory. */
+static
+void
+buf_dump_get_filename(
+/*==================*/
+	char*	name,	/*!< out: file name */
+	ulint	size)	/*!< in: size of name */
+{
+	ulint	dirnamelen = strlen(srv_data_home);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && srv_data_home[dirnamelen - 1] != SRV_PATH_SEPARATOR
+	    && srv_data_home[dirnamelen - 1] != '/') {
+		ut_snprintf(name, size, "%s%c%s", srv_data_home,
+			    SRV_PATH_SEPARATOR, srv_buf_dump_filename);
+	} else {
+		ut_snprintf(name, size, "%s%s", srv_data_home,
+			    srv_buf_dump_filename);
+	}
+
+	srv_normalize_path_for_win(name);
+}
+
+/*****************************************************************//**
+Writes the page ids of the LRU lists of all buffer pool instances into
+the dump file. The ids are first written into a temporary file, which is
+renamed over the dump file when it is complete, so that a dump that fails
+half way does not destroy the previous one. */
+static
+void
+buf_dump(
+/*=====*/
+	ibool	obey_shutdown)	/*!< in: TRUE=stop when the server is
+				shutting down */
+{
+	char	full_filename[OS_FILE_MAX_PATH];
+	char	tmp_filename[OS_FILE_MAX_PATH + 16];
+	FILE*	f;
+	ulint	i;
+	ulint	n_total = 0;
+
+	buf_dump_get_filename(full_filename, sizeof full_filename);
+	ut_snprintf(tmp_filename, sizeof tmp_filename,
+		    "%s.incomplete", full_filename);
+
+	buf_dump_status(FALSE, "Dumping buffer pool(s) to %s", full_filename);
+
+	f = fopen(tmp_filename, "w");
+	if (f == NULL) {
+		buf_dump_status(TRUE, "Cannot open '%s' for writing: %s",
+				tmp_filename, strerror(errno));
+		return;
+	}
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*		buf_pool;
+		const buf_page_t*	bpage;
+		ib_uint64_t*		dump;
+		ulint			n_pages;
+		ulint			j;
+
+		buf_pool = buf_pool_from_array(i);
+
+		/* Allocate the array outside of the buffer pool mutex.
+		The LRU list may grow meanwhile; the pages that do not fit
+		are left out. */
+		n_pages = UT_LIST_GET_LEN(buf_pool->LRU);
+
+		if (n_pages == 0) {
+			continue;
+		}
+
+		dump = ut_malloc(n_pages * sizeof(*dump));
+
+		if (dump == NULL) {
+			fclose(f);
+			buf_dump_status(TRUE, "Cannot allocate %lu bytes: %s",
+					(ulong) (n_pages * sizeof(*dump)),
+					strerror(errno));
+			return;
+		}
+
+		buf_pool_mutex_enter(buf_pool);
+
+		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
+		     bpage != NULL && j < n_pages;
+		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
+
+			ut_a(buf_page_in_file(bpage));
+
+			dump[j] = BUF_DUMP_CREATE(buf_page_get_space(bpage),
+						  buf_page_get_page_no(bpage));
+		}
+
+		buf_pool_mutex_exit(buf_pool);
+
+		n_pages = j;
+
+		for (j = 0; j < n_pages; j++) {
+			if (fprintf(f, "%lu,%lu\n",
+				    (ulong) BUF_DUMP_SPACE(dump[j]),
+				    (ulong) BUF_DUMP_PAGE(dump[j])) < 0) {
+
+				ut_free(dump);
+				fclose(f);
+				buf_dump_status(TRUE, "Cannot write to '%s': %s",
+						tmp_filename,
+						strerror(errno));
+				return;
+			}
+
+			if (j % 1024 == 0) {
+				buf_dump_status(FALSE, "Dumping buffer pool"
+						" %lu/%lu, page %lu/%lu",
+						(ulong) i + 1,
+						(ulong) srv_buf_pool_instances,
+						(ulong) j, (ulong) n_pages);
+			}
+
+			if (obey_shutdown && srv_shutdown_state
+			    != SRV_SHUTDOWN_NONE) {
+
+				ut_free(dump);
+				fclose(f);
+				unlink(tmp_filename);
+				buf_dump_status(TRUE, "Buffer pool dump aborted"
+						" due to shutdown");
+				return;
+			}
+		}
+
+		ut_free(dump);
+
+		n_total += n_pages;
+	}
+
+	if (fclose(f) != 0) {
+		buf_dump_status(TRUE, "Cannot close '%s': %s",
+				tmp_filename, strerror(errno));
+		return;
+	}
+
+	/* Remove the old dump first, for the platforms where rename()
+	does not replace an existing file. */
+	unlink(full_filename);
+
+	if (rename(tmp_filename, full_filename) != 0) {
+		buf_dump_status(TRUE, "Cannot rename '%s' to '%s': %s",
+				tmp_filename, full_filename,
+				strerror(errno));
+		return;
+	}
+
+	buf_dump_status(TRUE, "Buffer pool(s) dump completed:"
+			" %lu pages written to %s",
+			(ulong) n_total, full_filename);
+}
+
+/*****************************************************************//**
+Compares two page ids of a dump.
+@return 1, 0, -1, if a is greater, equal, less, respectively, than b */
+UNIV_INLINE
+int
+buf_load_cmp(
+/*=========*/
+	ib_uint64_t	a,	/*!< in: page id */
+	ib_uint64_t	b)	/*!< in: page id */
+{
+	if (a == b) {
+		return(0);
+	}
+
+	return(a > b ? 1 : -1);
+}
+
+/*****************************************************************//**
+Sorts the page ids of a dump by (space id, page number). */
+static
+void
+buf_load_sort(
+/*==========*/
+	ib_uint64_t*	arr,	/*!< in/out: array to sort */
+	ib_uint64_t*	aux_arr,/*!< in/out: work area */
+	ulint		low,	/*!< in: lower bound of the sorting area,
+				inclusive */
+	ulint		high)	/*!< in: upper bound of the sorting area,
+				exclusive */
+{
+	UT_SORT_FUNCTION_BODY(buf_load_sort, arr, aux_arr, low, high,
+			      buf_load_cmp);
+}
+
+/*****************************************************************//**
+Reads the dump file and issues asynchronous reads for the pages listed
+in it, sorted by (space id, page number). At most as many pages are
+loaded as the buffer pool has blocks; those are the most recently used
+ones of the dump. */
+static
+void
+buf_load(void)
+/*==========*/
+{
+	char		full_filename[OS_FILE_MAX_PATH];
+	FILE*		f;
+	ib_uint64_t*	dump;
+	ulint		dump_n;
+	ulint		total_pages;
+	ulong		space_id;
+	ulong		page_no;
+	ulint		space_ids[BUF_LOAD_BATCH_SIZE];
+	ulint		page_nos[BUF_LOAD_BATCH_SIZE];
+	ulint		n_read = 0;
+	ulint		start_time;
+	ulint		i;
+	int		fscanf_ret;
+
+	buf_load_should_abort = FALSE;
+
+	buf_dump_get_filename(full_filename, sizeof full_filename);
+
+	buf_load_status(FALSE, "Loading buffer pool(s) from %s",
+			full_filename);
+
+	f = fopen(full_filename, "r");
+	if (f == NULL) {
+		buf_load_status(TRUE, "Cannot open '%s' for reading: %s",
+				full_filename, strerror(errno));
+		return;
+	}
+
+	/* Count the lines, so that the array can be allocated at once.
+	Do not load more pages than fit in the buffer pool. */
+	total_pages = 0;
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		total_pages += buf_pool_from_array(i)->curr_size;
+	}
+
+	dump_n = 0;
+	while (fscanf(f, "%lu,%lu", &space_id, &page_no) == 2
+	       && dump_n < total_pages) {
+		dump_n++;
+	}
+
+	if (!feof(f) && dump_n < total_pages) {
+		fclose(f);
+		buf_load_status(TRUE, "Error parsing '%s', unable to load"
+				" buffer pool (stage 1)", full_filename);
+		return;
+	}
+
+	if (dump_n == 0) {
+		fclose(f);
+		buf_load_status(TRUE, "Buffer pool(s) load completed:"
+				" %s is empty", full_filename);
+		return;
+	}
+
+	/* Twice the size, for the work area of the sort */
+	dump = ut_malloc(2 * dump_n * sizeof(*dump));
+
+	if (dump == NULL) {
+		fclose(f);
+		buf_load_status(TRUE, "Cannot allocate %lu bytes: %s",
+				(ulong) (2 * dump_n * sizeof(*dump)),
+				strerror(errno));
+		return;
+	}
+
+	rewind(f);
+
+	for (i = 0; i < dump_n; i++) {
+		fscanf_ret = fscanf(f, "%lu,%lu", &space_id, &page_no);
+
+		if (fscanf_ret != 2
+		    || space_id > ULINT32_UNDEFINED
+		    || page_no > ULINT32_UNDEFINED) {
+
+			ut_free(dump);
+			fclose(f);
+			buf_load_status(TRUE, "Error parsing '%s', unable to"
+					" load buffer pool (stage 2)",
+					full_filename);
+			return;
+		}
+
+		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+	}
+
+	fclose(f);
+
+	/* Read the pages in the order in which they are in the data
+	files, so that the reads are mostly sequential. */
+	buf_load_sort(dump, dump + dump_n, 0, dump_n);
+
+	start_time = ut_time_ms();
+
+	for (i = 0; i < dump_n; i += BUF_LOAD_BATCH_SIZE) {
+		ulint	n = ut_min(dump_n - i, BUF_LOAD_BATCH_SIZE);
+		ulint	j;
+
+		for (j = 0; j < n; j++) {
+			space_ids[j] = BUF_DUMP_SPACE(dump[i + j]);
+			page_nos[j] = BUF_DUMP_PAGE(dump[i + j]);
+		}
+
+		n_read += buf_read_load_pages(space_ids, page_nos, n);
+
+		buf_load_status(FALSE, "Loaded %lu/%lu pages",
+				(ulong) (i + n), (ulong) dump_n);
+
+		if (buf_load_should_abort) {
+			ut_free(dump);
+			buf_load_status(TRUE, "Buffer pool(s) load aborted"
+					" on request after %lu/%lu pages",
+					(ulong) (i + n), (ulong) dump_n);
+			return;
+		}
+
+		if (srv_shutdown_state != SRV_SHUTDOWN_NONE) {
+			ut_free(dump);
+			buf_load_status(TRUE, "Buffer pool(s) load aborted"
+					" due to shutdown after %lu/%lu pages",
+					(ulong) (i + n), (ulong) dump_n);
+			return;
+		}
+	}
+
+	ut_free(dump);
+
+	buf_load_status(TRUE, "Buffer pool(s) load completed: read %lu of"
+			" the %lu pages listed in %s in %lu ms",
+			(ulong) n_read, (ulong) dump_n, full_filename,
+			(ulong) (ut_time_ms() - start_time));
+}
+
+/*****************************************************************//**
+The buf_dump thread. It loads the buffer pool at startup if
+innodb_buffer_pool_load_at_startup is set, serves the dump and load
+requests made through buf_dump_start() and buf_load_start(), and dumps
+the buffer pool at shutdown if innodb_buffer_pool_dump_at_shutdown is
+set.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_dump_thread(
+/*============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: buf_dump thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(buf_dump_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	buf_dump_thread_active = TRUE;
+
+	buf_dump_status(FALSE, "not started");
+	buf_load_status(FALSE, "not started");
+
+	if (srv_buffer_pool_load_at_startup) {
+		buf_load();
+	}
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ib_int64_t	sig_count;
+
+		sig_count = os_event_reset(buf_dump_event);
+
+		if (buf_dump_should_start) {
+			buf_dump_should_start = FALSE;
+			buf_dump(TRUE);
+		}
+
+		if (buf_load_should_start) {
+			buf_load_should_start = FALSE;
+			buf_load();
+		}
+
+		if (!buf_dump_should_start && !buf_load_should_start) {
+			os_event_wait_low(buf_dump_event, sig_count);
+		}
+	}
+
+	if (srv_buffer_pool_dump_at_shutdown && srv_fast_shutdown != 2) {
+		buf_dump(FALSE);
+	}
+
+	buf_dump_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
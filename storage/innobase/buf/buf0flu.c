@@ -31,6 +31,7 @@ Created 11/11/1995 Heikki Tuuri
 
 #include "buf0buf.h"
 #include "srv0srv.h"
+#include "srv0start.h"
 #include "page0zip.h"
 #ifndef UNIV_HOTBACKUP
 #include "ut0byte.h"
@@ -79,6 +80,28 @@ static ulint buf_lru_flush_page_count = 0;
 
 /* @} */
 
+/** Event to wake up the page cleaner thread ahead of its one second
+schedule */
+UNIV_INTERN os_event_t	buf_flush_event;
+
+/** Event set by the page cleaner thread after each pass over the LRU
+lists. User threads that ran out of free blocks wait on it. */
+static os_event_t	buf_flush_lru_event;
+
+/** TRUE while the page cleaner thread is running */
+UNIV_INTERN ibool	buf_page_cleaner_is_active = FALSE;
+
+/** Number of i/os at the last ten second flush of the page cleaner */
+static ulint		buf_flush_n_ios_old;
+
+/** How long a user thread that found no free block waits for the page
+cleaner to flush the LRU lists before doing it itself, in microseconds */
+#define BUF_FLUSH_LRU_WAIT_TIME		500000
+
+/** Percentage of max_modified_age_async above which the page cleaner
+starts to flush more than the adaptive flushing heuristic asks for */
+#define BUF_FLUSH_AGE_LWM		50
+
 /******************************************************************//**
 Increases flush_list size in bytes with zip_size for compressed page,
 UNIV_PAGE_SIZE for uncompressed page in inline function */
@@ -715,45 +738,75 @@ buf_flush_sync_datafiles(void)
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
+Checks that the lsn fields of the pages that were copied to the write
+buffer of a doublewrite area match. */
 static
 void
-buf_flush_buffered_writes(void)
-/*===========================*/
+buf_flush_doublewrite_check_lsn(
+/*============================*/
+	const trx_doublewrite_area_t*	area,	/*!< in: doublewrite area */
+	ulint				first,	/*!< in: first page to check */
+	ulint				n,	/*!< in: number of pages */
+	const char*			where)	/*!< in: "block1", "block2"
+						or "file" */
 {
-	byte*		write_buf;
-	ulint		len;
-	ulint		len2;
-	ulint		i;
+	ulint	i;
 
-	if (!srv_use_doublewrite_buf || trx_doublewrite == NULL) {
-		/* Sync the writes to the disk. */
-		buf_flush_sync_datafiles();
-		return;
+	for (i = first; i < first + n; i++) {
+		const buf_block_t*	block = (buf_block_t*)
+			area->buf_block_arr[i];
+		const byte*		page = area->write_buf
+			+ i * UNIV_PAGE_SIZE;
+
+		if (UNIV_LIKELY(!block->page.zip.data)
+		    && UNIV_LIKELY(buf_block_get_state(block)
+				   == BUF_BLOCK_FILE_PAGE)
+		    && UNIV_UNLIKELY
+		    (memcmp(page + (FIL_PAGE_LSN + 4),
+			    page + (UNIV_PAGE_SIZE
+				    - FIL_PAGE_END_LSN_OLD_CHKSUM + 4), 4))) {
+			ut_print_timestamp(stderr);
+			fprintf(stderr,
+				"  InnoDB: ERROR: The page to be written"
+				" seems corrupt!\n"
+				"InnoDB: The lsn fields do not match!"
+				" Noticed in the doublewrite %s.\n",
+				where);
+		}
 	}
+}
 
-	mutex_enter(&(trx_doublewrite->mutex));
+/********************************************************************//**
+Writes the pages that have been posted to a doublewrite area first to the
+doublewrite buffer or file and then to their intended positions, and
+waits for the writes to complete. */
+static
+void
+buf_flush_write_doublewrite_area(
+/*=============================*/
+	trx_doublewrite_area_t*	area)	/*!< in/out: doublewrite area */
+{
+	ulint		len;
+	ulint		i;
+
+	mutex_enter(&(area->mutex));
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (trx_doublewrite->first_free == 0) {
+	if (area->first_free == 0) {
 
-		mutex_exit(&(trx_doublewrite->mutex));
+		mutex_exit(&(area->mutex));
 
 		return;
 	}
 
-	for (i = 0; i < trx_doublewrite->first_free; i++) {
+	for (i = 0; i < area->first_free; i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) trx_doublewrite->buf_block_arr[i];
+		block = (buf_block_t*) area->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -806,91 +859,76 @@ corrupted_page:
 	}
 
 	/* increment the doublewrite flushed pages counter */
-	srv_dblwr_pages_written+= trx_doublewrite->first_free;
+	srv_dblwr_pages_written+= area->first_free;
 	srv_dblwr_writes++;
 
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     trx_doublewrite->first_free) * UNIV_PAGE_SIZE;
-
-	write_buf = trx_doublewrite->write_buf;
-	i = 0;
-
-	fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE, 0,
-	       trx_doublewrite->block1, 0, len,
-	       (void*) write_buf, NULL);
+	if (trx_doublewrite->file_name) {
+		/* Write the whole batch to the area of the doublewrite
+		file with one write. */
 
-	for (len2 = 0; len2 + UNIV_PAGE_SIZE <= len;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
+		len = area->first_free * UNIV_PAGE_SIZE;
 
-		if (UNIV_LIKELY(!block->page.zip.data)
-		    && UNIV_LIKELY(buf_block_get_state(block)
-				   == BUF_BLOCK_FILE_PAGE)
-		    && UNIV_UNLIKELY
-		    (memcmp(write_buf + len2 + (FIL_PAGE_LSN + 4),
-			    write_buf + len2
-			    + (UNIV_PAGE_SIZE
-			       - FIL_PAGE_END_LSN_OLD_CHKSUM + 4), 4))) {
+		if (!os_file_write(trx_doublewrite->file_name,
+				   trx_doublewrite->file, area->write_buf,
+				   (ulint) (area->offset & 0xFFFFFFFFUL),
+				   (ulint) (area->offset >> 32), len)) {
 			ut_print_timestamp(stderr);
 			fprintf(stderr,
-				"  InnoDB: ERROR: The page to be written"
-				" seems corrupt!\n"
-				"InnoDB: The lsn fields do not match!"
-				" Noticed in the doublewrite block1.\n");
+				"  InnoDB: Error: cannot write to"
+				" the doublewrite file %s\n",
+				trx_doublewrite->file_name);
+			ut_error;
 		}
-	}
 
-	if (trx_doublewrite->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		goto flush;
-	}
+		buf_flush_doublewrite_check_lsn(area, 0, area->first_free,
+						"file");
+
+		/* Now flush the doublewrite file data to disk */
+
+		os_file_flush(trx_doublewrite->file);
 
-	len = (trx_doublewrite->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-		* UNIV_PAGE_SIZE;
+		goto write_pages;
+	}
 
-	write_buf = trx_doublewrite->write_buf
-		+ TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-	ut_ad(i == TRX_SYS_DOUBLEWRITE_BLOCK_SIZE);
+	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
+		     area->first_free) * UNIV_PAGE_SIZE;
 
 	fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE, 0,
-	       trx_doublewrite->block2, 0, len,
-	       (void*) write_buf, NULL);
+	       trx_doublewrite->block1, 0, len,
+	       (void*) area->write_buf, NULL);
 
-	for (len2 = 0; len2 + UNIV_PAGE_SIZE <= len;
-	     len2 += UNIV_PAGE_SIZE, i++) {
-		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
+	buf_flush_doublewrite_check_lsn(area, 0, len / UNIV_PAGE_SIZE,
+					"block1");
 
-		if (UNIV_LIKELY(!block->page.zip.data)
-		    && UNIV_LIKELY(buf_block_get_state(block)
-				   == BUF_BLOCK_FILE_PAGE)
-		    && UNIV_UNLIKELY
-		    (memcmp(write_buf + len2 + (FIL_PAGE_LSN + 4),
-			    write_buf + len2
-			    + (UNIV_PAGE_SIZE
-			       - FIL_PAGE_END_LSN_OLD_CHKSUM + 4), 4))) {
-			ut_print_timestamp(stderr);
-			fprintf(stderr,
-				"  InnoDB: ERROR: The page to be"
-				" written seems corrupt!\n"
-				"InnoDB: The lsn fields do not match!"
-				" Noticed in"
-				" the doublewrite block2.\n");
-		}
+	if (area->first_free > TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+
+		len = (area->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+			* UNIV_PAGE_SIZE;
+
+		fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE, 0,
+		       trx_doublewrite->block2, 0, len,
+		       (void*) (area->write_buf
+				+ TRX_SYS_DOUBLEWRITE_BLOCK_SIZE
+				* UNIV_PAGE_SIZE),
+		       NULL);
+
+		buf_flush_doublewrite_check_lsn(
+			area, TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
+			len / UNIV_PAGE_SIZE, "block2");
 	}
 
-flush:
 	/* Now flush the doublewrite buffer data to disk */
 
 	fil_flush(TRX_SYS_SPACE);
 
+write_pages:
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	for (i = 0; i < trx_doublewrite->first_free; i++) {
+	for (i = 0; i < area->first_free; i++) {
 		const buf_block_t* block = (buf_block_t*)
-			trx_doublewrite->buf_block_arr[i];
+			area->buf_block_arr[i];
 
 		ut_a(buf_page_in_file(&block->page));
 		if (UNIV_LIKELY_NULL(block->page.zip.data)) {
@@ -945,32 +983,83 @@ flush:
 	buf_flush_sync_datafiles();
 
 	/* We can now reuse the doublewrite memory buffer: */
-	trx_doublewrite->first_free = 0;
+	area->first_free = 0;
+
+	mutex_exit(&(area->mutex));
+}
+
+/********************************************************************//**
+Flushes possible buffered writes from all doublewrite areas to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+static
+void
+buf_flush_buffered_writes(void)
+/*===========================*/
+{
+	ulint	i;
+
+	if (!srv_use_doublewrite_buf || trx_doublewrite == NULL) {
+		/* Sync the writes to the disk. */
+		buf_flush_sync_datafiles();
+		return;
+	}
+
+	for (i = 0; i < trx_doublewrite->n_areas; i++) {
+		buf_flush_write_doublewrite_area(&trx_doublewrite->areas[i]);
+	}
+}
+
+/********************************************************************//**
+Flushes possible buffered writes of a flush batch to disk. Unlike
+buf_flush_buffered_writes(), this only writes the doublewrite area of
+the batch, so that batches that use different areas do not wait for
+each other. */
+static
+void
+buf_flush_buffered_writes_batch(
+/*============================*/
+	buf_pool_t*	buf_pool,	/*!< in: buffer pool instance */
+	enum buf_flush	flush_type)	/*!< in: BUF_FLUSH_LRU
+					or BUF_FLUSH_LIST */
+{
+	if (!srv_use_doublewrite_buf || trx_doublewrite == NULL) {
+		/* Sync the writes to the disk. */
+		buf_flush_sync_datafiles();
+		return;
+	}
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	buf_flush_write_doublewrite_area(
+		trx_doublewrite_get_area(buf_pool_index(buf_pool),
+					 flush_type));
 }
 
 /********************************************************************//**
-Posts a buffer page for writing. If the doublewrite memory buffer is
-full, calls buf_flush_buffered_writes and waits for for free space to
-appear. */
+Posts a buffer page for writing. If the doublewrite area of the page is
+full, writes the area and waits for for free space to appear. */
 static
 void
 buf_flush_post_to_doublewrite_buf(
 /*==============================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
+	ulint			zip_size;
+	trx_doublewrite_area_t*	area;
+
+	area = trx_doublewrite_get_area(
+		buf_pool_index(buf_pool_from_bpage(bpage)),
+		buf_page_get_flush_type(bpage));
 try_again:
-	mutex_enter(&(trx_doublewrite->mutex));
+	mutex_enter(&(area->mutex));
 
 	ut_a(buf_page_in_file(bpage));
 
-	if (trx_doublewrite->first_free
-	    >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		mutex_exit(&(trx_doublewrite->mutex));
+	if (area->first_free >= TRX_DOUBLEWRITE_AREA_SIZE) {
+		mutex_exit(&(area->mutex));
 
-		buf_flush_buffered_writes();
+		buf_flush_write_doublewrite_area(area);
 
 		goto try_again;
 	}
@@ -980,36 +1069,35 @@ try_again:
 	if (UNIV_UNLIKELY(zip_size)) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
 		/* Copy the compressed page and clear the rest. */
-		memcpy(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free,
+		memcpy(area->write_buf
+		       + UNIV_PAGE_SIZE * area->first_free,
 		       bpage->zip.data, zip_size);
-		memset(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free
+		memset(area->write_buf
+		       + UNIV_PAGE_SIZE * area->first_free
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 	} else {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
 		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
 				   UNIV_PAGE_SIZE);
 
-		memcpy(trx_doublewrite->write_buf
-		       + UNIV_PAGE_SIZE * trx_doublewrite->first_free,
+		memcpy(area->write_buf
+		       + UNIV_PAGE_SIZE * area->first_free,
 		       ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
 	}
 
-	trx_doublewrite->buf_block_arr[trx_doublewrite->first_free] = bpage;
+	area->buf_block_arr[area->first_free] = bpage;
 
-	trx_doublewrite->first_free++;
+	area->first_free++;
 
-	if (trx_doublewrite->first_free
-	    >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		mutex_exit(&(trx_doublewrite->mutex));
+	if (area->first_free >= TRX_DOUBLEWRITE_AREA_SIZE) {
+		mutex_exit(&(area->mutex));
 
-		buf_flush_buffered_writes();
+		buf_flush_write_doublewrite_area(area);
 
 		return;
 	}
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	mutex_exit(&(area->mutex));
 }
 #endif /* !UNIV_HOTBACKUP */
 
@@ -1024,6 +1112,8 @@ buf_flush_init_for_writing(
 	ib_uint64_t	newest_lsn)	/*!< in: newest modification lsn
 					to the page */
 {
+	ib_uint32_t	checksum;
+
 	ut_ad(page);
 
 	if (page_zip_) {
@@ -1050,10 +1140,9 @@ buf_flush_init_for_writing(
 			memset(page_zip->data + FIL_PAGE_FILE_FLUSH_LSN, 0, 8);
 			mach_write_to_4(page_zip->data
 					+ FIL_PAGE_SPACE_OR_CHKSUM,
-					srv_use_checksums
-					? page_zip_calc_checksum(
-						page_zip->data, zip_size)
-					: BUF_NO_CHECKSUM_MAGIC);
+					page_zip_calc_checksum(
+						page_zip->data, zip_size,
+						srv_checksum_algorithm));
 			return;
 		}
 
@@ -1075,20 +1164,40 @@ buf_flush_init_for_writing(
 
 	/* Store the new formula checksum */
 
-	mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM,
-			srv_use_checksums
-			? buf_calc_page_new_checksum(page)
-			: BUF_NO_CHECKSUM_MAGIC);
+	switch ((srv_checksum_algorithm_t) srv_checksum_algorithm) {
+	case SRV_CHECKSUM_ALGORITHM_CRC32:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+		checksum = buf_calc_page_crc32(page);
+		break;
+	case SRV_CHECKSUM_ALGORITHM_INNODB:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_INNODB:
+		checksum = (ib_uint32_t) buf_calc_page_new_checksum(page);
+		break;
+	case SRV_CHECKSUM_ALGORITHM_NONE:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_NONE:
+		checksum = BUF_NO_CHECKSUM_MAGIC;
+		break;
+	default:
+		ut_error;
+	}
+
+	mach_write_to_4(page + FIL_PAGE_SPACE_OR_CHKSUM, checksum);
 
 	/* We overwrite the first 4 bytes of the end lsn field to store
 	the old formula checksum. Since it depends also on the field
 	FIL_PAGE_SPACE_OR_CHKSUM, it has to be calculated after storing the
-	new formula checksum. */
+	new formula checksum. With crc32 and none, the same value is stored
+	in both fields. */
+
+	if (srv_checksum_algorithm == SRV_CHECKSUM_ALGORITHM_INNODB
+	    || srv_checksum_algorithm
+	    == SRV_CHECKSUM_ALGORITHM_STRICT_INNODB) {
+
+		checksum = (ib_uint32_t) buf_calc_page_old_checksum(page);
+	}
 
 	mach_write_to_4(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN_OLD_CHKSUM,
-			srv_use_checksums
-			? buf_calc_page_old_checksum(page)
-			: BUF_NO_CHECKSUM_MAGIC);
+			checksum);
 }
 
 #ifndef UNIV_HOTBACKUP
@@ -1156,8 +1265,7 @@ buf_flush_write_block_low(
 	case BUF_BLOCK_ZIP_DIRTY:
 		frame = bpage->zip.data;
 		if (UNIV_LIKELY(srv_use_checksums)) {
-			ut_a(mach_read_from_4(frame + FIL_PAGE_SPACE_OR_CHKSUM)
-			     == page_zip_calc_checksum(frame, zip_size));
+			ut_a(page_zip_verify_checksum(frame, zip_size));
 		}
 		mach_write_to_8(frame + FIL_PAGE_LSN,
 				bpage->newest_modification);
@@ -1258,7 +1366,7 @@ buf_flush_page_try(
 	}
 
 	buf_pool_mutex_exit(buf_pool);
-	buf_flush_buffered_writes();
+	buf_flush_buffered_writes_batch(buf_pool, BUF_FLUSH_LRU);
 
 	return(TRUE);
 }
@@ -1763,7 +1871,7 @@ buf_flush_batch(
 
 	buf_pool_mutex_exit(buf_pool);
 
-	buf_flush_buffered_writes();
+	buf_flush_buffered_writes_batch(buf_pool, flush_type);
 
 #ifdef UNIV_DEBUG
 	if (buf_debug_prints && count > 0) {
@@ -1786,7 +1894,8 @@ buf_flush_common(
 	enum buf_flush	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_flush_buffered_writes();
+	/* buf_flush_batch() has already written the doublewrite area
+	of the batch. */
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -2045,33 +2154,65 @@ Flushes pages from the end of the LRU list if there is too small a margin
 of replaceable pages there or in the free list. VERY IMPORTANT: this function
 is called also by threads which have locks on pages. To avoid deadlocks, we
 flush only pages such that the s-lock required for flushing can be acquired
-immediately, without waiting. */
-UNIV_INTERN
-void
-buf_flush_free_margin(
-/*==================*/
-	buf_pool_t*	buf_pool)		/*!< in: Buffer pool instance */
+immediately, without waiting.
+@return number of pages for which the write request was queued */
+static
+ulint
+buf_flush_free_margin_low(
+/*======================*/
+	buf_pool_t*	buf_pool,	/*!< in: Buffer pool instance */
+	ibool		wait)		/*!< in: TRUE if we should wait for
+					an LRU flush batch that is already
+					running to end */
 {
 	ulint	n_to_flush;
+	ulint	n_flushed;
 
 	n_to_flush = buf_flush_LRU_recommendation(buf_pool);
 
-	if (n_to_flush > 0) {
-		ulint	n_flushed;
+	if (n_to_flush == 0) {
 
-		n_flushed = buf_flush_LRU(buf_pool, n_to_flush);
+		return(0);
+	}
 
-		if (n_flushed == ULINT_UNDEFINED) {
-			/* There was an LRU type flush batch already running;
-			let us wait for it to end */
+	n_flushed = buf_flush_LRU(buf_pool, n_to_flush);
 
+	if (n_flushed == ULINT_UNDEFINED) {
+		/* There was an LRU type flush batch already running;
+		let us wait for it to end */
+
+		if (wait) {
 			buf_flush_wait_batch_end(buf_pool, BUF_FLUSH_LRU);
 		}
+
+		return(0);
+	}
+
+	return(n_flushed);
+}
+
+/*********************************************************************//**
+Makes sure that there is a big enough margin of replaceable pages at the
+end of the LRU list of buf_pool. If the page cleaner thread is running,
+it is only woken up; otherwise the pages are flushed by the calling
+thread. */
+UNIV_INTERN
+void
+buf_flush_free_margin(
+/*==================*/
+	buf_pool_t*	buf_pool)		/*!< in: Buffer pool instance */
+{
+	if (!buf_page_cleaner_is_active) {
+		srv_buf_pool_flushed_lru_foreground
+			+= buf_flush_free_margin_low(buf_pool, TRUE);
+	} else if (buf_flush_LRU_recommendation(buf_pool) > 0) {
+		os_event_set(buf_flush_event);
 	}
 }
 
 /*********************************************************************//**
-Flushes pages from the end of all the LRU lists. */
+Makes sure that there is a big enough margin of replaceable pages at the
+end of all the LRU lists. */
 UNIV_INTERN
 void
 buf_flush_free_margins(void)
@@ -2088,6 +2229,46 @@ buf_flush_free_margins(void)
 	}
 }
 
+/*********************************************************************//**
+Called by a thread that found no free block in buf_pool. Wakes up the
+page cleaner thread and waits for it to flush the LRU list tails. If the
+page cleaner is not running, or it does not get to the LRU lists in
+time, the LRU list of buf_pool is flushed by the calling thread. */
+UNIV_INTERN
+void
+buf_flush_wait_free_margin(
+/*=======================*/
+	buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	if (buf_page_cleaner_is_active) {
+		ib_int64_t	sig_count;
+		ulint		ret;
+
+		sig_count = os_event_reset(buf_flush_lru_event);
+
+		os_event_set(buf_flush_event);
+
+		thd_wait_begin(NULL, THD_WAIT_DISKIO);
+		ret = os_event_wait_time_low(buf_flush_lru_event,
+					     BUF_FLUSH_LRU_WAIT_TIME,
+					     sig_count);
+		thd_wait_end(NULL);
+
+		if (ret != OS_SYNC_TIME_EXCEEDED) {
+
+			return;
+		}
+
+		/* The page cleaner is stuck in a flush list batch,
+		possibly waiting for a latch on a page that this thread
+		holds. buf_flush_LRU() does not wait for page latches,
+		so it is safe for us to flush the LRU list ourselves. */
+	}
+
+	srv_buf_pool_flushed_lru_foreground
+		+= buf_flush_free_margin_low(buf_pool, TRUE);
+}
+
 /*********************************************************************
 Update the historical stats that we are collecting for flush rate
 heuristics at the end of each interval.
@@ -2208,6 +2389,235 @@ buf_flush_get_desired_flush_rate(void)
 	return(rate > 0 ? (ulint) rate : 0);
 }
 
+/********************************************************************//**
+Creates the events used to talk to the page cleaner thread. They are
+freed in os_sync_free(). */
+UNIV_INTERN
+void
+buf_flush_page_cleaner_init(void)
+/*=============================*/
+{
+	buf_flush_event = os_event_create(NULL);
+	buf_flush_lru_event = os_event_create(NULL);
+}
+
+/*********************************************************************//**
+Flushes the tails of the LRU lists of all buffer pool instances, so that
+user threads find replaceable blocks there.
+@return number of pages for which the write request was queued */
+static
+ulint
+buf_flush_LRU_tail(void)
+/*====================*/
+{
+	ulint	i;
+	ulint	total_flushed = 0;
+
+	for (i = 0; i < srv_buf_pool_instances; i++) {
+		buf_pool_t*	buf_pool;
+
+		buf_pool = buf_pool_from_array(i);
+
+		total_flushed += buf_flush_free_margin_low(buf_pool, FALSE);
+	}
+
+	srv_buf_pool_flushed_lru += total_flushed;
+
+	return(total_flushed);
+}
+
+/*********************************************************************//**
+Flushes the flush lists of all buffer pool instances. If the checkpoint
+age is past the point where user threads would do an asynchronous preflush
+in log_checkpoint_margin(), enough pages are flushed to get it back under
+that point. Otherwise, once per second, a batch is flushed whose size
+depends on the number of dirty pages, the redo generation rate and how
+close the checkpoint age is to that point. */
+static
+void
+buf_flush_page_cleaner_flush_list(
+/*==============================*/
+	ibool	one_second)	/*!< in: TRUE if a second has passed since
+				the last batch that was not driven by the
+				checkpoint age */
+{
+	ib_uint64_t	oldest_lsn;
+	ib_uint64_t	age;
+	ib_uint64_t	age_async;
+	ulint		n_flushed;
+
+	age = log_get_modified_age(&oldest_lsn, &age_async);
+
+	if (age > age_async) {
+
+		log_preflush_pool_modified_pages(
+			oldest_lsn + (age - age_async), FALSE);
+
+		return;
+	}
+
+	if (!one_second) {
+
+		return;
+	}
+
+	if (UNIV_UNLIKELY(buf_get_modified_ratio_pct()
+			  > srv_max_buf_pool_modified_pct)) {
+
+		/* Try to keep the number of modified pages in the
+		buffer pool under the limit wished by the user */
+
+		n_flushed = buf_flush_list(PCT_IO(100), IB_ULONGLONG_MAX);
+
+		srv_buf_pool_flushed_max_dirty += n_flushed;
+
+	} else if (srv_adaptive_flushing) {
+
+		/* Try to keep the rate of flushing of dirty pages such
+		that redo log generation does not produce bursts of IO at
+		checkpoint time. The closer the checkpoint age gets to
+		the asynchronous preflush point, the harder we flush,
+		up to srv_io_capacity pages when we get there. */
+
+		ulint	n_flush	= buf_flush_get_desired_flush_rate();
+		ulint	age_pct	= (ulint) (age * 100 / age_async);
+
+		if (age_pct > BUF_FLUSH_AGE_LWM) {
+			n_flush = ut_max(n_flush,
+					 PCT_IO((age_pct - BUF_FLUSH_AGE_LWM)
+						* 100
+						/ (100 - BUF_FLUSH_AGE_LWM)));
+		}
+
+		if (n_flush) {
+			n_flush = ut_min(PCT_IO(100), n_flush);
+			n_flushed = buf_flush_list(n_flush, IB_ULONGLONG_MAX);
+
+			srv_buf_pool_flushed_adaptive += n_flushed;
+		}
+	}
+}
+
+/*********************************************************************//**
+Flushes a batch of the flush lists to make a new checkpoint younger. This
+is done once per ten seconds regardless of the fraction of dirty pages
+relative to the max requested by the user. If there are lots of modified
+pages in the buffer pool (> 70 %), or if the i/os during the last ten
+seconds were less than 200% of capacity, we assume we can afford
+reserving the disk(s) for srv_io_capacity pages. Otherwise we only flush
+a small number of pages so that we do not unnecessarily use much disk i/o
+capacity from other work. */
+static
+void
+buf_flush_page_cleaner_background(void)
+/*===================================*/
+{
+	buf_pool_stat_t	buf_stat;
+	ulint		n_pend_ios;
+	ulint		n_ios;
+	ulint		n_flush;
+	ulint		n_flushed;
+
+	buf_get_total_stat(&buf_stat);
+	n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
+	n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
+		+ buf_stat.n_pages_written;
+
+	if (buf_get_modified_ratio_pct() > 70
+	    || (n_pend_ios < SRV_PEND_IO_THRESHOLD
+		&& n_ios - buf_flush_n_ios_old < SRV_PAST_IO_ACTIVITY)) {
+
+		n_flush = PCT_IO(100);
+	} else {
+		n_flush = PCT_IO(10);
+	}
+
+	buf_flush_n_ios_old = n_ios;
+
+	n_flushed = buf_flush_list(n_flush, IB_ULONGLONG_MAX);
+
+	srv_buf_pool_flushed_background += n_flushed;
+}
+
+/******************************************************************//**
+The page cleaner thread. Once per second, and whenever it is woken up
+through buf_flush_event, it flushes the tails of the LRU lists and a batch
+of the flush lists, sized after the redo generation rate and the
+checkpoint age, of all buffer pool instances.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_flush_page_cleaner_thread(
+/*==========================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ulint		next_loop_time	= ut_time_ms() + 1000;
+	ulint		n_loops		= 0;
+	ib_int64_t	sig_count;
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: page_cleaner thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(buf_page_cleaner_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	buf_page_cleaner_is_active = TRUE;
+
+	while (srv_shutdown_state < SRV_SHUTDOWN_CLEANUP) {
+		ulint	cur_time;
+		ibool	one_second;
+
+		/* Reset the event before looking for work, so that a
+		wakeup that arrives while we are flushing is not lost. */
+		sig_count = os_event_reset(buf_flush_event);
+
+		buf_flush_LRU_tail();
+
+		/* Let the user threads waiting in
+		buf_flush_wait_free_margin() retry. */
+		os_event_set(buf_flush_lru_event);
+
+		cur_time = ut_time_ms();
+		one_second = cur_time >= next_loop_time;
+
+		buf_flush_page_cleaner_flush_list(one_second);
+
+		if (one_second) {
+			if (++n_loops % 10 == 0) {
+				buf_flush_page_cleaner_background();
+			}
+
+			next_loop_time = cur_time + 1000;
+		}
+
+		cur_time = ut_time_ms();
+
+		if (cur_time < next_loop_time) {
+			os_event_wait_time_low(
+				buf_flush_event,
+				(next_loop_time - cur_time) * 1000,
+				sig_count);
+		}
+	}
+
+	buf_page_cleaner_is_active = FALSE;
+
+	/* Do not keep user threads waiting for an LRU flush that this
+	thread is not going to do. */
+	os_event_set(buf_flush_lru_event);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 #if defined UNIV_DEBUG || defined UNIV_BUF_DEBUG
 /******************************************************************//**
 Validates the flush list.
@@ -891,6 +891,7 @@ buf_LRU_free_from_common_LRU_list(
 
 		ibool		freed;
 		unsigned	accessed;
+		ibool		read_ahead_logical;
 		mutex_t*	block_mutex = buf_page_get_mutex(bpage);
 
 		ut_ad(buf_page_in_file(bpage));
@@ -898,6 +899,7 @@ buf_LRU_free_from_common_LRU_list(
 
 		mutex_enter(block_mutex);
 		accessed = buf_page_is_accessed(bpage);
+		read_ahead_logical = bpage->read_ahead_logical;
 		freed = buf_LRU_free_block(bpage, TRUE);
 		mutex_exit(block_mutex);
 
@@ -907,6 +909,11 @@ buf_LRU_free_from_common_LRU_list(
 			the effectiveness of readahead */
 			if (!accessed) {
 				++buf_pool->stat.n_ra_pages_evicted;
+
+				if (read_ahead_logical) {
+					++buf_pool->stat
+						.n_ra_pages_logical_evicted;
+				}
 			}
 			return(TRUE);
 		}
@@ -1207,9 +1214,10 @@ loop:
 		os_event_set(srv_lock_timeout_thread_event);
 	}
 
-	/* No free block was found: try to flush the LRU list */
+	/* No free block was found: have the page cleaner flush the
+	LRU list, and wait for it */
 
-	buf_flush_free_margin(buf_pool);
+	buf_flush_wait_free_margin(buf_pool);
 	++srv_buf_pool_wait_free;
 
 	os_aio_simulated_wake_handler_threads();
@@ -1867,11 +1875,10 @@ alloc:
 
 			mach_write_to_4(
 				b->zip.data + FIL_PAGE_SPACE_OR_CHKSUM,
-				UNIV_LIKELY(srv_use_checksums)
-				? page_zip_calc_checksum(
+				page_zip_calc_checksum(
 					b->zip.data,
-					page_zip_get_size(&b->zip))
-				: BUF_NO_CHECKSUM_MAGIC);
+					page_zip_get_size(&b->zip),
+					srv_checksum_algorithm));
 		}
 
 		buf_pool_mutex_enter(buf_pool);
@@ -707,6 +707,118 @@ buf_read_ahead_linear(
 	return(count);
 }
 
+/********************************************************************//**
+Issues asynchronous read requests for index pages that an ascending
+index scan is going to visit next, in the order the scan visits them.
+Unlike buf_read_ahead_linear() this does not require the pages to be
+physically adjacent. Pages that are already in the buffer pool are
+skipped. The pages that are read in are marked, so that the buffer pool
+can count how many of them were accessed or evicted unused.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_logical(
+/*===================*/
+	ulint		space,		/*!< in: space id */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes, or 0 */
+	const ulint*	page_nos,	/*!< in: array of page numbers,
+					in scan order */
+	ulint		n_stored)	/*!< in: number of page numbers
+					in the array */
+{
+	ib_int64_t	tablespace_version;
+	ulint		space_size;
+	ulint		count		= 0;
+	ulint		i;
+
+	if (UNIV_UNLIKELY(srv_startup_is_before_trx_rollback_phase)) {
+		/* No read-ahead to avoid thread deadlocks */
+		return(0);
+	}
+
+	/* Remember the tablespace version before we ask the tablespace
+	size below: if DISCARD + IMPORT changes the actual .ibd file
+	meanwhile, we do not try to read outside the bounds of the
+	tablespace! */
+
+	tablespace_version = fil_space_get_version(space);
+	space_size = fil_space_get_size(space);
+
+	for (i = 0; i < n_stored; i++) {
+		buf_pool_t*	buf_pool = buf_pool_get(space, page_nos[i]);
+		buf_page_t*	bpage;
+		ulint		err;
+
+		if (page_nos[i] >= space_size
+		    || buf_page_peek(space, page_nos[i])) {
+
+			continue;
+		}
+
+		if (buf_pool->n_pend_reads
+		    > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+
+			break;
+		}
+
+		if (!buf_read_page_low(
+			    &err, FALSE,
+			    BUF_READ_ANY_PAGE | OS_AIO_SIMULATED_WAKE_LATER,
+			    space, zip_size, FALSE, tablespace_version,
+			    page_nos[i])) {
+
+			continue;
+		}
+
+		count++;
+
+		buf_pool_mutex_enter(buf_pool);
+
+		bpage = buf_page_hash_get(buf_pool, space, page_nos[i]);
+
+		if (bpage) {
+			mutex_t*	block_mutex = buf_page_get_mutex(bpage);
+
+			mutex_enter(block_mutex);
+
+			/* The scan may already have reached the page
+			while the read was in progress. */
+			if (!buf_page_is_accessed(bpage)) {
+				bpage->read_ahead_logical = TRUE;
+			}
+
+			mutex_exit(block_mutex);
+		}
+
+		buf_pool->stat.n_ra_pages_read_logical++;
+
+		buf_pool_mutex_exit(buf_pool);
+	}
+
+	/* In simulated aio we wake the aio handler threads only after
+	queuing all aio requests, in native aio the following call does
+	nothing: */
+
+	os_aio_simulated_wake_handler_threads();
+
+#ifdef UNIV_DEBUG
+	if (buf_debug_prints && (count > 0)) {
+		fprintf(stderr,
+			"LOGICAL read-ahead space %lu pages %lu\n",
+			(ulong) space, (ulong) count);
+	}
+#endif /* UNIV_DEBUG */
+
+	if (count > 0) {
+		/* Read ahead is considered one I/O operation for the
+		purpose of LRU policy decision. */
+		buf_LRU_stat_inc_io();
+	}
+
+	return(count);
+}
+
 /********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
@@ -788,6 +900,76 @@ tablespace_deleted:
 #endif /* UNIV_DEBUG */
 }
 
+/********************************************************************//**
+Issues asynchronous read requests for the pages of a buffer pool dump.
+Pages that are already in the buffer pool, pages of tablespaces that no
+longer exist or have shrunk, and pages of buffer pool instances that
+have no free blocks left are skipped.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_load_pages(
+/*================*/
+	const ulint*	space_ids,	/*!< in: array of space ids */
+	const ulint*	page_nos,	/*!< in: array of page numbers,
+					sorted by (space id, page number)
+					together with space_ids */
+	ulint		n_stored)	/*!< in: number of elements
+					in the arrays */
+{
+	ulint		space		= ULINT_UNDEFINED;
+	ulint		zip_size	= ULINT_UNDEFINED;
+	ulint		space_size	= 0;
+	ib_int64_t	tablespace_version = -1;
+	ulint		count		= 0;
+	ulint		i;
+
+	for (i = 0; i < n_stored; i++) {
+		ulint		err;
+		buf_pool_t*	buf_pool;
+
+		if (space_ids[i] != space) {
+			/* The array is sorted, so the tablespace is
+			looked up once per run of its pages. */
+			space = space_ids[i];
+			zip_size = fil_space_get_zip_size(space);
+			space_size = fil_space_get_size(space);
+			tablespace_version = fil_space_get_version(space);
+		}
+
+		if (zip_size == ULINT_UNDEFINED
+		    || page_nos[i] >= space_size) {
+
+			continue;
+		}
+
+		buf_pool = buf_pool_get(space, page_nos[i]);
+
+		/* Do not evict the pages that the workload has read
+		since the startup. This is a dirty read. */
+		if (UT_LIST_GET_LEN(buf_pool->free) == 0) {
+
+			continue;
+		}
+
+		while (buf_pool->n_pend_reads
+		       > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+			os_aio_simulated_wake_handler_threads();
+			os_thread_sleep(10000);
+		}
+
+		count += buf_read_page_low(
+			&err, FALSE,
+			BUF_READ_ANY_PAGE | OS_AIO_SIMULATED_WAKE_LATER,
+			space, zip_size, TRUE, tablespace_version,
+			page_nos[i]);
+	}
+
+	os_aio_simulated_wake_handler_threads();
+
+	return(count);
+}
+
 /********************************************************************//**
 Issues read requests for pages which recovery wants to read in. */
 UNIV_INTERN
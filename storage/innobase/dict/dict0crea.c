@@ -1319,6 +1319,98 @@ dict_create_or_check_foreign_constraint_tables(void)
 	return(error);
 }
 
+/****************************************************************//**
+Creates the SYS_STATS system table, which holds the persistent index
+statistics, at database creation or database start if it is not found
+or is not of the right form.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_create_or_check_stats_table(void)
+/*==================================*/
+{
+	dict_table_t*	table;
+	ulint		error;
+	trx_t*		trx;
+
+	mutex_enter(&(dict_sys->mutex));
+
+	table = dict_table_get_low("SYS_STATS", DICT_ERR_IGNORE_NONE);
+
+	if (table && UT_LIST_GET_LEN(table->indexes) == 1) {
+
+		/* The statistics system table has already been
+		created, and it is ok */
+
+		mutex_exit(&(dict_sys->mutex));
+
+		return(DB_SUCCESS);
+	}
+
+	mutex_exit(&(dict_sys->mutex));
+
+	trx = trx_allocate_for_mysql();
+
+	trx->op_info = "creating statistics sys table";
+
+	row_mysql_lock_data_dictionary(trx);
+
+	if (table) {
+		fprintf(stderr,
+			"InnoDB: dropping incompletely created"
+			" SYS_STATS table\n");
+		row_drop_table_for_mysql("SYS_STATS", trx, TRUE);
+	}
+
+	fprintf(stderr, "InnoDB: Creating statistics system table\n");
+
+	/* NOTE: dict_stats_fetch_index() reads the fields of the
+	clustered index records of SYS_STATS, which are defined just
+	like below */
+
+	error = que_eval_sql(NULL,
+			     "PROCEDURE CREATE_STATS_SYS_TABLE_PROC () IS\n"
+			     "BEGIN\n"
+			     "CREATE TABLE\n"
+			     "SYS_STATS(INDEX_ID BINARY(8), KEY_COLS INT,"
+			     " DIFF_VALS BINARY(8), NON_NULL_VALS BINARY(8));\n"
+			     "CREATE UNIQUE CLUSTERED INDEX ID_IND"
+			     " ON SYS_STATS (INDEX_ID, KEY_COLS);\n"
+			     "END;\n"
+			     , FALSE, trx);
+
+	if (error != DB_SUCCESS) {
+		fprintf(stderr, "InnoDB: error %lu in creation\n",
+			(ulong) error);
+
+		ut_a(error == DB_OUT_OF_FILE_SPACE
+		     || error == DB_TOO_MANY_CONCURRENT_TRXS);
+
+		fprintf(stderr,
+			"InnoDB: creation failed\n"
+			"InnoDB: tablespace is full\n"
+			"InnoDB: dropping incompletely created"
+			" SYS_STATS table\n");
+
+		row_drop_table_for_mysql("SYS_STATS", trx, TRUE);
+
+		error = DB_MUST_GET_MORE_FILE_SPACE;
+	}
+
+	trx_commit_for_mysql(trx);
+
+	row_mysql_unlock_data_dictionary(trx);
+
+	trx_free_for_mysql(trx);
+
+	if (error == DB_SUCCESS) {
+		fprintf(stderr,
+			"InnoDB: Statistics system table created\n");
+	}
+
+	return(error);
+}
+
 /****************************************************************//**
 Evaluate the given foreign key SQL statement.
 @return	error code or DB_SUCCESS */
@@ -55,6 +55,7 @@ ib_warn_row_too_big(const dict_table_t*	table);
 #include "dict0boot.h"
 #include "dict0mem.h"
 #include "dict0crea.h"
+#include "dict0stats.h"
 #include "trx0undo.h"
 #include "btr0btr.h"
 #include "btr0cur.h"
@@ -87,6 +88,23 @@ we need this; NOTE: a transaction which reserves this must keep book
 on the mode in trx_struct::dict_operation_lock_mode */
 UNIV_INTERN rw_lock_t	dict_operation_lock;
 
+/** Percentage of compression failures that are allowed in a single
+round before padding is added to the leaf pages of a compressed index
+(innodb_compression_failure_threshold_pct); 0 disables the padding */
+UNIV_INTERN ulong	zip_failure_threshold_pct = 5;
+
+/** Maximum percentage of a compressed page that may be reserved as
+padding (innodb_compression_pad_pct_max) */
+UNIV_INTERN ulong	zip_pad_max = 50;
+
+/** Number of compressions in a round of zip_pad_info_t */
+#define ZIP_PAD_ROUND_LEN	128
+/** Number of consecutive rounds without too many compression failures
+after which the padding is decreased */
+#define ZIP_PAD_SUCCESSFUL_ROUND_LIMIT	5
+/** Amount by which the padding is increased or decreased */
+#define ZIP_PAD_INCR		128
+
 /* Keys to register rwlocks and mutexes with performance schema */
 #ifdef UNIV_PFS_RWLOCK
 UNIV_INTERN mysql_pfs_key_t	dict_operation_lock_key;
@@ -753,6 +771,8 @@ dict_init(void)
 		rw_lock_create(dict_table_stats_latch_key,
 			       &dict_table_stats_latches[i], SYNC_INDEX_TREE);
 	}
+
+	dict_stats_init();
 }
 
 /**********************************************************************//**
@@ -784,7 +804,11 @@ dict_table_get(
 
 	mutex_exit(&(dict_sys->mutex));
 
-	if (table != NULL) {
+	if (table != NULL && srv_stats_persistent) {
+		/* Load the statistics from SYS_STATS, or calculate
+		and save them if they are not there. */
+		dict_stats_update(table, FALSE);
+	} else if (table != NULL) {
 		/* If table->ibd_file_missing == TRUE, this will
 		print an error message and return without doing
 		anything. */
@@ -1877,6 +1901,7 @@ undo_size_ok:
 	rw_lock_create(index_tree_rw_lock_key, &new_index->lock,
 		       dict_index_is_ibuf(index)
 		       ? SYNC_IBUF_INDEX_TREE : SYNC_INDEX_TREE);
+	os_fast_mutex_init(&new_index->zip_pad.mutex);
 
 	DBUG_EXECUTE_IF(
 		"index_partially_created_should_kick",
@@ -1944,7 +1969,8 @@ dict_index_remove_from_cache(
 	zero. */
 
 	for (;;) {
-		ulint ref_count = btr_search_info_get_ref_count(info);
+		ulint ref_count = btr_search_info_get_ref_count(info,
+								  index);
 		if (ref_count == 0) {
 			break;
 		}
@@ -1975,6 +2001,7 @@ dict_index_remove_from_cache(
 	}
 
 	rw_lock_free(&index->lock);
+	os_fast_mutex_free(&index->zip_pad.mutex);
 
 	/* Remove the index from the list of indexes of the table */
 	UT_LIST_REMOVE(indexes, table->indexes, index);
@@ -4781,10 +4808,14 @@ dict_table_print_low(
 
 	ut_ad(mutex_own(&(dict_sys->mutex)));
 
-	dict_update_statistics(
-		table,
-		FALSE, /* update even if initialized */
-		FALSE /* update even if not changed too much */);
+	/* Print the persistent statistics as they are, rather than
+	replace them with a new sample that would not be saved. */
+	if (!srv_stats_persistent) {
+		dict_update_statistics(
+			table,
+			FALSE, /* update even if initialized */
+			FALSE /* update even if not changed too much */);
+	}
 
 	dict_table_stats_lock(table, RW_S_LATCH);
 
@@ -5391,6 +5422,8 @@ dict_close(void)
 	for (i = 0; i < DICT_TABLE_STATS_LATCHES_SIZE; i++) {
 		rw_lock_free(&dict_table_stats_latches[i]);
 	}
+
+	dict_stats_close();
 }
 
 /**********************************************************************//**
@@ -5580,4 +5613,107 @@ dict_set_corrupted_index_cache_only(
 
 	index->type |= DICT_CORRUPT;
 }
+
+/*********************************************************************//**
+Ends a round of compressions of an index once it is ZIP_PAD_ROUND_LEN
+long, adjusting the padding of its leaf pages to the failure rate of
+the round. */
+static
+void
+dict_index_zip_pad_update(
+/*======================*/
+	zip_pad_info_t*	info)	/*!< in/out: padding information,
+				protected by info->mutex */
+{
+	ulint	total = info->success + info->failure;
+	ulint	fail_pct;
+
+	if (total < ZIP_PAD_ROUND_LEN) {
+		return;
+	}
+
+	fail_pct = (info->failure * 100) / total;
+
+	info->failure = 0;
+	info->success = 0;
+
+	if (fail_pct > zip_failure_threshold_pct) {
+		/* Too many compression failures: leave more space
+		empty on the leaf pages, up to zip_pad_max percent. */
+		if (info->pad + ZIP_PAD_INCR
+		    < (UNIV_PAGE_SIZE * zip_pad_max) / 100) {
+			info->pad += ZIP_PAD_INCR;
+		}
+
+		info->n_rounds = 0;
+	} else if (++info->n_rounds >= ZIP_PAD_SUCCESSFUL_ROUND_LIMIT
+		   && info->pad > 0) {
+		/* The failure rate has stayed low for a while: try
+		packing the leaf pages more densely again. */
+		info->pad -= ZIP_PAD_INCR;
+		info->n_rounds = 0;
+	}
+}
+
+/*********************************************************************//**
+Accounts a successful compression of a leaf page of an index. */
+UNIV_INTERN
+void
+dict_index_zip_success(
+/*===================*/
+	dict_index_t*	index)	/*!< in/out: index */
+{
+	if (!zip_failure_threshold_pct || !index->cached) {
+		return;
+	}
+
+	os_fast_mutex_lock(&index->zip_pad.mutex);
+	++index->zip_pad.success;
+	dict_index_zip_pad_update(&index->zip_pad);
+	os_fast_mutex_unlock(&index->zip_pad.mutex);
+}
+
+/*********************************************************************//**
+Accounts a failed compression of a leaf page of an index. */
+UNIV_INTERN
+void
+dict_index_zip_failure(
+/*===================*/
+	dict_index_t*	index)	/*!< in/out: index */
+{
+	if (!zip_failure_threshold_pct || !index->cached) {
+		return;
+	}
+
+	os_fast_mutex_lock(&index->zip_pad.mutex);
+	++index->zip_pad.failure;
+	dict_index_zip_pad_update(&index->zip_pad);
+	os_fast_mutex_unlock(&index->zip_pad.mutex);
+}
+
+/*********************************************************************//**
+Computes how many bytes of records an uncompressed leaf page of a
+compressed index should be filled with, leaving room for the padding.
+@return	optimal data size of a leaf page, in bytes */
+UNIV_INTERN
+ulint
+dict_index_zip_pad_optimal_page_size(
+/*=================================*/
+	dict_index_t*	index)	/*!< in: index */
+{
+	ulint	pad;
+	ulint	min_sz;
+
+	if (!zip_failure_threshold_pct || !index->cached) {
+		return(UNIV_PAGE_SIZE);
+	}
+
+	/* A dirty read is fine here: the padding is only a hint. */
+	pad = index->zip_pad.pad;
+
+	ut_ad(pad < UNIV_PAGE_SIZE);
+	min_sz = (UNIV_PAGE_SIZE * (100 - zip_pad_max)) / 100;
+
+	return(ut_max(UNIV_PAGE_SIZE - pad, min_sz));
+}
 #endif /* !UNIV_HOTBACKUP */
@@ -349,10 +349,13 @@ dict_process_sys_tables_rec(
 	}
 
 	if ((status & DICT_TABLE_UPDATE_STATS)
+	    && !srv_stats_persistent
 	    && dict_table_get_first_index(*table)) {
 
 		/* Update statistics if DICT_TABLE_UPDATE_STATS
-		is set */
+		is set. The persistent statistics are only
+		calculated again by ANALYZE TABLE and the
+		dict_stats thread. */
 		dict_update_statistics(
 			*table,
 			FALSE, /* update even if initialized */
@@ -0,0 +1,697 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file dict/dict0stats.c
+Persistent index statistics, kept in the SYS_STATS system table
+
+When innodb_stats_persistent is set, the statistics that
+dict_update_statistics() calculates are saved in SYS_STATS, and loaded
+from there when a table is opened, so that the query plans do not change
+at every restart. They are only calculated again by ANALYZE TABLE, and by
+the dict_stats thread when a table has been changed too much.
+
+SYS_STATS has a row for each index and each n-column prefix of its
+unique key, with KEY_COLS = n, DIFF_VALS = stat_n_diff_key_vals[n] and
+NON_NULL_VALS = stat_n_non_null_key_vals[n]. The row with KEY_COLS = 0
+holds the size of the index: DIFF_VALS = stat_index_size and
+NON_NULL_VALS = stat_n_leaf_pages.
+
+*******************************************************/
+
+#include "dict0stats.h"
+
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "mach0data.h"
+#include "pars0pars.h"
+#include "que0que.h"
+#include "row0mysql.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "trx0roll.h"
+#include "trx0trx.h"
+
+/** Maximum number of tables waiting for the dict_stats thread */
+#define DICT_STATS_QUEUE_SIZE	128
+
+/** Fields of the clustered index records of SYS_STATS */
+#define DICT_STATS_INDEX_ID		0
+#define DICT_STATS_KEY_COLS		1
+#define DICT_STATS_DIFF_VALS		4
+#define DICT_STATS_NON_NULL_VALS	5
+
+/** Event that wakes up the dict_stats thread */
+UNIV_INTERN os_event_t	dict_stats_event;
+
+/** TRUE while the dict_stats thread is running */
+UNIV_INTERN ibool	dict_stats_thread_active = FALSE;
+
+#ifdef UNIV_PFS_MUTEX
+/* Key to register dict_stats_mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	dict_stats_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
+/** Protects dict_stats_queue and dict_stats_queue_len */
+static mutex_t		dict_stats_mutex;
+
+/** Ids of the tables whose statistics the dict_stats thread should
+recalculate, in the order of the requests */
+static table_id_t	dict_stats_queue[DICT_STATS_QUEUE_SIZE];
+
+/** Number of tables in dict_stats_queue */
+static ulint		dict_stats_queue_len;
+
+/*********************************************************************//**
+Creates the mutex and the event of the dict_stats thread. */
+UNIV_INTERN
+void
+dict_stats_init(void)
+/*=================*/
+{
+	mutex_create(dict_stats_mutex_key, &dict_stats_mutex, SYNC_ANY_LATCH);
+
+	dict_stats_event = os_event_create(NULL);
+
+	dict_stats_queue_len = 0;
+}
+
+/*********************************************************************//**
+Frees the mutex of the dict_stats thread. */
+UNIV_INTERN
+void
+dict_stats_close(void)
+/*==================*/
+{
+	mutex_free(&dict_stats_mutex);
+}
+
+/*********************************************************************//**
+Gets SYS_STATS from the dictionary cache. The caller must hold
+dict_sys->mutex.
+@return	SYS_STATS, or NULL if it does not exist */
+static
+dict_table_t*
+dict_stats_get_sys_stats(void)
+/*==========================*/
+{
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	return(dict_table_get_low("SYS_STATS", DICT_ERR_IGNORE_NONE));
+}
+
+/*********************************************************************//**
+Reads the statistics of an index from SYS_STATS. The caller must hold
+dict_sys->mutex.
+@return	TRUE if SYS_STATS has a row for every n-column prefix of the
+unique key of the index */
+static
+ibool
+dict_stats_fetch_index(
+/*===================*/
+	dict_table_t*		sys_stats,	/*!< in: SYS_STATS */
+	const dict_index_t*	index,		/*!< in: index */
+	ib_uint64_t*		vals,		/*!< out: DIFF_VALS and
+						NON_NULL_VALS of each
+						KEY_COLS, in pairs */
+	mem_heap_t*		heap)		/*!< in: memory heap */
+{
+	dict_index_t*	sys_index;
+	btr_pcur_t	pcur;
+	dtuple_t*	tuple;
+	dfield_t*	dfield;
+	byte*		buf;
+	ulint		n_uniq;
+	ulint		n_found	= 0;
+	mtr_t		mtr;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	n_uniq = dict_index_get_n_unique(index);
+
+	sys_index = dict_table_get_first_index(sys_stats);
+	ut_a(!dict_table_is_comp(sys_stats));
+
+	buf = mem_heap_alloc(heap, 8);
+	mach_write_to_8(buf, index->id);
+
+	tuple = dtuple_create(heap, 1);
+	dfield = dtuple_get_nth_field(tuple, 0);
+	dfield_set_data(dfield, buf, 8);
+	dict_index_copy_types(tuple, sys_index, 1);
+
+	mtr_start(&mtr);
+
+	btr_pcur_open_on_user_rec(sys_index, tuple, PAGE_CUR_GE,
+				  BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	for (; btr_pcur_is_on_user_rec(&pcur);
+	     btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+		const rec_t*	rec	= btr_pcur_get_rec(&pcur);
+		const byte*	field;
+		ulint		len;
+		ulint		key_cols;
+
+		field = rec_get_nth_field_old(rec, DICT_STATS_INDEX_ID, &len);
+
+		if (len != 8 || ut_memcmp(field, buf, 8)) {
+			break;
+		}
+
+		if (rec_get_deleted_flag(rec, 0)) {
+			continue;
+		}
+
+		field = rec_get_nth_field_old(rec, DICT_STATS_KEY_COLS, &len);
+
+		if (len != 4) {
+			continue;
+		}
+
+		key_cols = mach_read_from_4(field);
+
+		if (key_cols > n_uniq) {
+			continue;
+		}
+
+		field = rec_get_nth_field_old(rec, DICT_STATS_DIFF_VALS, &len);
+
+		if (len != 8) {
+			continue;
+		}
+
+		vals[2 * key_cols] = mach_read_from_8(field);
+
+		field = rec_get_nth_field_old(rec, DICT_STATS_NON_NULL_VALS,
+					      &len);
+
+		if (len != 8) {
+			continue;
+		}
+
+		vals[2 * key_cols + 1] = mach_read_from_8(field);
+
+		n_found++;
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	/* The records are unique on (INDEX_ID, KEY_COLS). */
+	return(n_found == n_uniq + 1);
+}
+
+/*********************************************************************//**
+Loads the statistics of a table from SYS_STATS.
+@return	TRUE if SYS_STATS had the statistics of every index */
+static
+ibool
+dict_stats_fetch(
+/*=============*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	dict_table_t*	sys_stats;
+	dict_index_t*	index;
+	mem_heap_t*	heap;
+	ib_uint64_t**	vals;
+	ulint		sum_of_index_sizes	= 0;
+	ulint		i;
+	ibool		found			= TRUE;
+
+	mutex_enter(&dict_sys->mutex);
+
+	sys_stats = dict_stats_get_sys_stats();
+
+	if (sys_stats == NULL) {
+		mutex_exit(&dict_sys->mutex);
+
+		return(FALSE);
+	}
+
+	heap = mem_heap_create(256);
+
+	vals = mem_heap_zalloc(heap, UT_LIST_GET_LEN(table->indexes)
+			       * sizeof *vals);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && found;
+	     index = dict_table_get_next_index(index), i++) {
+
+		/* Skip incomplete indexes. */
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		vals[i] = mem_heap_alloc(
+			heap, 2 * (1 + dict_index_get_n_unique(index))
+			* sizeof **vals);
+
+		found = dict_stats_fetch_index(sys_stats, index, vals[i],
+					       heap);
+	}
+
+	if (found) {
+		dict_table_stats_lock(table, RW_X_LATCH);
+
+		for (index = dict_table_get_first_index(table), i = 0;
+		     index != NULL;
+		     index = dict_table_get_next_index(index), i++) {
+
+			ulint	n;
+
+			if (vals[i] == NULL) {
+				continue;
+			}
+
+			index->stat_index_size = (ulint) vals[i][0];
+			index->stat_n_leaf_pages = (ulint) vals[i][1];
+
+			for (n = 1; n <= dict_index_get_n_unique(index); n++) {
+				index->stat_n_diff_key_vals[n]
+					= (ib_int64_t) vals[i][2 * n];
+				index->stat_n_non_null_key_vals[n]
+					= (ib_int64_t) vals[i][2 * n + 1];
+			}
+
+			sum_of_index_sizes += index->stat_index_size;
+		}
+
+		index = dict_table_get_first_index(table);
+
+		table->stat_n_rows = index->stat_n_diff_key_vals[
+			dict_index_get_n_unique(index)];
+
+		table->stat_clustered_index_size = index->stat_index_size;
+
+		table->stat_sum_of_other_index_sizes = sum_of_index_sizes
+			- index->stat_index_size;
+
+		table->stat_initialized = TRUE;
+
+		table->stat_modified_counter = 0;
+
+		dict_table_stats_unlock(table, RW_X_LATCH);
+	}
+
+	mutex_exit(&dict_sys->mutex);
+
+	mem_heap_free(heap);
+
+	return(found);
+}
+
+/*********************************************************************//**
+Deletes the statistics of an index from SYS_STATS. The caller must hold
+dict_sys->mutex.
+@return	DB_SUCCESS or error code */
+static
+ulint
+dict_stats_delete_low(
+/*==================*/
+	index_id_t	index_id,	/*!< in: index id */
+	trx_t*		trx)		/*!< in/out: transaction */
+{
+	pars_info_t*	info	= pars_info_create();
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	pars_info_add_ull_literal(info, "index_id", index_id);
+
+	return(que_eval_sql(info,
+			    "PROCEDURE DELETE_INDEX_STATS_PROC () IS\n"
+			    "BEGIN\n"
+			    "DELETE FROM SYS_STATS"
+			    " WHERE INDEX_ID = :index_id;\n"
+			    "END;\n", FALSE, trx));
+}
+
+/*********************************************************************//**
+Replaces the statistics of an index in SYS_STATS. The caller must hold
+dict_sys->mutex.
+@return	DB_SUCCESS or error code */
+static
+ulint
+dict_stats_save_index(
+/*==================*/
+	index_id_t		index_id,	/*!< in: index id */
+	ulint			n_uniq,		/*!< in: number of
+						key columns */
+	const ib_uint64_t*	vals,		/*!< in: DIFF_VALS and
+						NON_NULL_VALS of each
+						KEY_COLS, in pairs */
+	trx_t*			trx)		/*!< in/out: transaction */
+{
+	ulint	err;
+	ulint	n;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	err = dict_stats_delete_low(index_id, trx);
+
+	for (n = 0; err == DB_SUCCESS && n <= n_uniq; n++) {
+		pars_info_t*	info	= pars_info_create();
+
+		pars_info_add_ull_literal(info, "index_id", index_id);
+		pars_info_add_int4_literal(info, "key_cols", (lint) n);
+		pars_info_add_ull_literal(info, "diff_vals", vals[2 * n]);
+		pars_info_add_ull_literal(info, "non_null_vals",
+					  vals[2 * n + 1]);
+
+		err = que_eval_sql(info,
+				   "PROCEDURE INSERT_INDEX_STATS_PROC () IS\n"
+				   "BEGIN\n"
+				   "INSERT INTO SYS_STATS VALUES"
+				   " (:index_id, :key_cols,"
+				   " :diff_vals, :non_null_vals);\n"
+				   "END;\n", FALSE, trx);
+	}
+
+	return(err);
+}
+
+/*********************************************************************//**
+Saves the statistics of a table in SYS_STATS, in a transaction of its
+own. */
+static
+void
+dict_stats_save(
+/*============*/
+	dict_table_t*	table)	/*!< in: table */
+{
+	dict_index_t*	index;
+	mem_heap_t*	heap;
+	ib_uint64_t**	vals;
+	trx_t*		trx;
+	ulint		i;
+	ulint		err	= DB_SUCCESS;
+
+	trx = trx_allocate_for_background();
+
+	trx->op_info = "saving table statistics";
+
+	/* The rows of other indexes are never read, so that gap locks
+	would only make the writers wait for each other. */
+	trx->isolation_level = TRX_ISO_READ_COMMITTED;
+
+	/* The transaction is committed before dict_sys->mutex is
+	released, like the other transactions that modify SYS_STATS, so
+	that it cannot wait for their locks while holding the mutex. */
+	mutex_enter(&dict_sys->mutex);
+
+	if (dict_stats_get_sys_stats() == NULL) {
+		goto func_exit;
+	}
+
+	heap = mem_heap_create(256);
+
+	vals = mem_heap_zalloc(heap, UT_LIST_GET_LEN(table->indexes)
+			       * sizeof *vals);
+
+	dict_table_stats_lock(table, RW_S_LATCH);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL;
+	     index = dict_table_get_next_index(index), i++) {
+
+		ulint	n;
+
+		if (index->name[0] == TEMP_INDEX_PREFIX) {
+			continue;
+		}
+
+		vals[i] = mem_heap_alloc(
+			heap, 2 * (1 + dict_index_get_n_unique(index))
+			* sizeof **vals);
+
+		vals[i][0] = index->stat_index_size;
+		vals[i][1] = index->stat_n_leaf_pages;
+
+		for (n = 1; n <= dict_index_get_n_unique(index); n++) {
+			vals[i][2 * n] = index->stat_n_diff_key_vals[n];
+			vals[i][2 * n + 1] = index->stat_n_non_null_key_vals[n];
+		}
+	}
+
+	dict_table_stats_unlock(table, RW_S_LATCH);
+
+	trx_start_if_not_started(trx);
+
+	for (index = dict_table_get_first_index(table), i = 0;
+	     index != NULL && err == DB_SUCCESS;
+	     index = dict_table_get_next_index(index), i++) {
+
+		if (vals[i] != NULL) {
+			err = dict_stats_save_index(
+				index->id, dict_index_get_n_unique(index),
+				vals[i], trx);
+		}
+	}
+
+	mem_heap_free(heap);
+
+	if (err != DB_SUCCESS) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: Warning: cannot save statistics of table ",
+		      stderr);
+		ut_print_name(stderr, trx, TRUE, table->name);
+		fprintf(stderr, ": error %lu\n", (ulong) err);
+
+		trx->error_state = DB_SUCCESS;
+		trx_general_rollback_for_mysql(trx, NULL);
+		trx->error_state = DB_SUCCESS;
+	} else {
+		trx_commit_for_mysql(trx);
+	}
+
+func_exit:
+	mutex_exit(&dict_sys->mutex);
+
+	trx_free_for_background(trx);
+}
+
+/*********************************************************************//**
+Updates the statistics of a table when innodb_stats_persistent is set.
+The statistics are loaded from SYS_STATS when the table is opened, and
+only calculated and saved if SYS_STATS does not have them for every
+index. The caller must not hold dict_sys->mutex. */
+UNIV_INTERN
+void
+dict_stats_update(
+/*==============*/
+	dict_table_t*	table,	/*!< in/out: table */
+	ibool		recalc)	/*!< in: TRUE=calculate the statistics
+				and save them, as ANALYZE TABLE does;
+				FALSE=only load them if they have not
+				been initialized yet */
+{
+	if (!recalc) {
+		if (table->stat_initialized || dict_stats_fetch(table)) {
+
+			return;
+		}
+	}
+
+	dict_update_statistics(
+		table,
+		!recalc, /* only update if not initialized, unless
+			 ANALYZE */
+		FALSE /* update even if not changed too much */);
+
+	/* dict_update_statistics() does not initialize the statistics
+	of a table whose .ibd file is missing. */
+	if (table->stat_initialized) {
+		dict_stats_save(table);
+	}
+}
+
+/*********************************************************************//**
+Deletes the statistics of an index from SYS_STATS. Index ids are never
+reused, so this only keeps SYS_STATS from growing, and a failure is
+reported but not returned. The caller must hold dict_sys->mutex. */
+UNIV_INTERN
+void
+dict_stats_delete_index_stats(
+/*==========================*/
+	const dict_index_t*	index,	/*!< in: index being dropped */
+	trx_t*			trx)	/*!< in/out: dictionary
+					transaction */
+{
+	ulint	err;
+
+	ut_ad(mutex_own(&dict_sys->mutex));
+
+	if (index->name[0] == TEMP_INDEX_PREFIX
+	    || !strcmp(index->table_name, "SYS_STATS")
+	    || dict_stats_get_sys_stats() == NULL) {
+
+		return;
+	}
+
+	err = dict_stats_delete_low(index->id, trx);
+
+	if (err != DB_SUCCESS) {
+		ut_print_timestamp(stderr);
+		fputs("  InnoDB: Warning: cannot delete statistics of index ",
+		      stderr);
+		ut_print_name(stderr, trx, FALSE, index->name);
+		fprintf(stderr, ": error %lu\n", (ulong) err);
+
+		trx->error_state = DB_SUCCESS;
+	}
+}
+
+/*********************************************************************//**
+Asks the dict_stats thread to recalculate and save the statistics of a
+table, because it has been changed too much since the last calculation.
+If the queue is full, the request is dropped and made again when the
+table has been changed too much once more. */
+UNIV_INTERN
+void
+dict_stats_enqueue(
+/*===============*/
+	dict_table_t*	table)	/*!< in/out: table */
+{
+	ulint	i;
+
+	/* Count the changes anew, so that the table is not queued
+	again by every change until the dict_stats thread gets to it. */
+	table->stat_modified_counter = 0;
+
+	mutex_enter(&dict_stats_mutex);
+
+	for (i = 0; i < dict_stats_queue_len; i++) {
+		if (dict_stats_queue[i] == table->id) {
+			mutex_exit(&dict_stats_mutex);
+
+			return;
+		}
+	}
+
+	if (dict_stats_queue_len < DICT_STATS_QUEUE_SIZE) {
+		dict_stats_queue[dict_stats_queue_len++] = table->id;
+	}
+
+	mutex_exit(&dict_stats_mutex);
+
+	os_event_set(dict_stats_event);
+}
+
+/*********************************************************************//**
+Takes the first table from the queue of the dict_stats thread.
+@return	TRUE if a table was queued */
+static
+ibool
+dict_stats_dequeue(
+/*===============*/
+	table_id_t*	id)	/*!< out: table id */
+{
+	ibool	found;
+
+	mutex_enter(&dict_stats_mutex);
+
+	found = dict_stats_queue_len > 0;
+
+	if (found) {
+		*id = dict_stats_queue[0];
+
+		dict_stats_queue_len--;
+
+		memmove(dict_stats_queue, dict_stats_queue + 1,
+			dict_stats_queue_len * sizeof *dict_stats_queue);
+	}
+
+	mutex_exit(&dict_stats_mutex);
+
+	return(found);
+}
+
+/*********************************************************************//**
+Recalculates and saves the statistics of a queued table. */
+static
+void
+dict_stats_process(
+/*===============*/
+	table_id_t	id)	/*!< in: table id */
+{
+	dict_table_t*	table;
+	trx_t*		trx;
+
+	trx = trx_allocate_for_background();
+
+	/* Keep the table from being dropped or altered while its
+	statistics are calculated, as purge does. */
+	row_mysql_freeze_data_dictionary(trx);
+
+	table = dict_table_get_on_id(id, trx);
+
+	/* The table may have been dropped, or innodb_stats_persistent
+	switched off, after it was queued. */
+	if (table != NULL && srv_stats_persistent) {
+		dict_stats_update(table, TRUE);
+	}
+
+	row_mysql_unfreeze_data_dictionary(trx);
+
+	trx_free_for_background(trx);
+}
+
+/*********************************************************************//**
+The dict_stats thread. It recalculates and saves the statistics of the
+tables queued by dict_stats_enqueue().
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+dict_stats_thread(
+/*==============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: dict_stats thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(dict_stats_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	dict_stats_thread_active = TRUE;
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ib_int64_t	sig_count;
+		table_id_t	id;
+
+		sig_count = os_event_reset(dict_stats_event);
+
+		if (dict_stats_dequeue(&id)) {
+			dict_stats_process(id);
+		} else {
+			os_event_wait_low(dict_stats_event, sig_count);
+		}
+	}
+
+	dict_stats_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
@@ -60,6 +60,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 /* Include necessary InnoDB headers */
 extern "C" {
 #include "univ.i"
+#include "buf0dump.h"
 #include "buf0lru.h"
 #include "btr0sea.h"
 #include "os0file.h"
@@ -77,6 +78,7 @@ extern "C" {
 #include "log0log.h"
 #include "lock0lock.h"
 #include "dict0crea.h"
+#include "dict0stats.h"
 #include "btr0cur.h"
 #include "btr0btr.h"
 #include "fsp0fsp.h"
@@ -88,6 +90,7 @@ extern "C" {
 #include "ha_prototypes.h"
 #include "ut0mem.h"
 #include "ibuf0ibuf.h"
+#include "page0zip.h"
 
 enum_tx_isolation thd_get_trx_isolation(const THD* thd);
 
@@ -102,8 +105,6 @@ enum_tx_isolation thd_get_trx_isolation(const THD* thd);
 
 /** to protect innobase_open_files */
 static mysql_mutex_t innobase_share_mutex;
-/** to force correct commit order in binlog */
-static mysql_mutex_t prepare_commit_mutex;
 static ulong commit_threads = 0;
 static mysql_cond_t commit_cond;
 static mysql_mutex_t commit_cond_m;
@@ -196,6 +197,27 @@ static TYPELIB innodb_stats_method_typelib = {
 	NULL
 };
 
+/** Possible values for system variable "innodb_checksum_algorithm",
+in the order of srv_checksum_algorithm_t */
+static const char* innodb_checksum_algorithm_names[] = {
+	"crc32",
+	"strict_crc32",
+	"innodb",
+	"strict_innodb",
+	"none",
+	"strict_none",
+	NullS
+};
+
+/** Used to define an enumerate type of the system variable
+innodb_checksum_algorithm. */
+static TYPELIB innodb_checksum_algorithm_typelib = {
+	array_elements(innodb_checksum_algorithm_names) - 1,
+	"innodb_checksum_algorithm_typelib",
+	innodb_checksum_algorithm_names,
+	NULL
+};
+
 /* The following counter is used to convey information to InnoDB
 about server activity: in selects it is not sensible to call
 srv_active_wake_master_thread after each fetch or search, we only do
@@ -220,14 +242,12 @@ static const char* innobase_change_buffering_values[IBUF_USE_COUNT] = {
 /* Keys to register pthread mutexes/cond in the current file with
 performance schema */
 static mysql_pfs_key_t	innobase_share_mutex_key;
-static mysql_pfs_key_t	prepare_commit_mutex_key;
 static mysql_pfs_key_t	commit_cond_mutex_key;
 static mysql_pfs_key_t	commit_cond_key;
 
 static PSI_mutex_info	all_pthread_mutexes[] = {
         {&commit_cond_mutex_key, "commit_cond_mutex", 0},
-        {&innobase_share_mutex_key, "innobase_share_mutex", 0},
-        {&prepare_commit_mutex_key, "prepare_commit_mutex", 0}
+        {&innobase_share_mutex_key, "innobase_share_mutex", 0}
 };
 
 static PSI_cond_info	all_innodb_conds[] = {
@@ -248,6 +268,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&buf_pool_zip_mutex_key, "buf_pool_zip_mutex", 0},
 	{&cache_last_read_mutex_key, "cache_last_read_mutex", 0},
 	{&dict_foreign_err_mutex_key, "dict_foreign_err_mutex", 0},
+	{&dict_stats_mutex_key, "dict_stats_mutex", 0},
 	{&dict_sys_mutex_key, "dict_sys_mutex", 0},
 	{&file_format_max_mutex_key, "file_format_max_mutex", 0},
 	{&fil_system_mutex_key, "fil_system_mutex", 0},
@@ -259,20 +280,26 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&ibuf_pessimistic_insert_mutex_key,
 		 "ibuf_pessimistic_insert_mutex", 0},
 	{&kernel_mutex_key, "kernel_mutex", 0},
+	{&lock_rec_mutex_key, "lock_rec_mutex", 0},
 	{&log_sys_mutex_key, "log_sys_mutex", 0},
 #  ifdef UNIV_MEM_DEBUG
 	{&mem_hash_mutex_key, "mem_hash_mutex", 0},
 #  endif /* UNIV_MEM_DEBUG */
 	{&mem_pool_mutex_key, "mem_pool_mutex", 0},
 	{&mutex_list_mutex_key, "mutex_list_mutex", 0},
+	{&page_zip_stat_per_index_mutex_key,
+		 "page_zip_stat_per_index_mutex", 0},
 	{&purge_sys_bh_mutex_key, "purge_sys_bh_mutex", 0},
+	{&read_view_mutex_key, "read_view_mutex", 0},
 	{&recv_sys_mutex_key, "recv_sys_mutex", 0},
+	{&row_merge_mutex_key, "row_merge_mutex", 0},
 	{&rseg_mutex_key, "rseg_mutex", 0},
 #  ifdef UNIV_SYNC_DEBUG
 	{&rw_lock_debug_mutex_key, "rw_lock_debug_mutex", 0},
 #  endif /* UNIV_SYNC_DEBUG */
 	{&rw_lock_list_mutex_key, "rw_lock_list_mutex", 0},
 	{&rw_lock_mutex_key, "rw_lock_mutex", 0},
+	{&srv_conc_mutex_key, "srv_conc_mutex", 0},
 	{&srv_dict_tmpfile_mutex_key, "srv_dict_tmpfile_mutex", 0},
 	{&srv_innodb_monitor_mutex_key, "srv_innodb_monitor_mutex", 0},
 	{&srv_misc_tmpfile_mutex_key, "srv_misc_tmpfile_mutex", 0},
@@ -282,6 +309,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&sync_thread_mutex_key, "sync_thread_mutex", 0},
 #  endif /* UNIV_SYNC_DEBUG */
 	{&trx_doublewrite_mutex_key, "trx_doublewrite_mutex", 0},
+	{&trx_sys_mutex_key, "trx_sys_mutex", 0},
 	{&trx_undo_mutex_key, "trx_undo_mutex", 0}
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -307,7 +335,8 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	{&trx_i_s_cache_lock_key, "trx_i_s_cache_lock", 0},
 	{&trx_purge_latch_key, "trx_purge_latch", 0},
 	{&index_tree_rw_lock_key, "index_tree_rw_lock", 0},
-	{&dict_table_stats_latch_key, "dict_table_stats", 0}
+	{&dict_table_stats_latch_key, "dict_table_stats", 0},
+	{&lock_sys_latch_key, "lock_sys_latch", 0}
 };
 # endif /* UNIV_PFS_RWLOCK */
 
@@ -322,7 +351,14 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&srv_error_monitor_thread_key, "srv_error_monitor_thread", 0},
 	{&srv_monitor_thread_key, "srv_monitor_thread", 0},
 	{&srv_master_thread_key, "srv_master_thread", 0},
-	{&srv_purge_thread_key, "srv_purge_thread", 0}
+	{&srv_purge_thread_key, "srv_purge_thread", 0},
+	{&srv_purge_worker_thread_key, "srv_purge_worker_thread", 0},
+	{&buf_page_cleaner_thread_key, "page_cleaner_thread", 0},
+	{&buf_dump_thread_key, "buf_dump_thread", 0},
+	{&recv_apply_thread_key, "recv_apply_thread", 0},
+	{&row_merge_thread_key, "row_merge_thread", 0},
+	{&dict_stats_thread_key, "dict_stats_thread", 0},
+	{&ibuf_merge_thread_key, "ibuf_merge_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -478,6 +514,19 @@ innobase_xa_prepare(
 	bool		all);	/*!< in: TRUE - commit transaction
 				FALSE - the current SQL statement
 				ended */
+/*****************************************************************//**
+Commits a transaction in binlog order, called by the binlog group
+commit before innobase_commit(). */
+static
+void
+innobase_commit_ordered(
+/*====================*/
+	handlerton*	hton,	/*!< in: InnoDB handlerton */
+	THD*		thd,	/*!< in: MySQL thread handle of the user
+				for whom the transaction is committed */
+	bool		all);	/*!< in: TRUE - commit transaction
+				FALSE - the current SQL statement
+				ended */
 /*******************************************************************//**
 This function is used to recover X/Open XA distributed transactions.
 @return	number of prepared transactions stored in xid_list */
@@ -609,6 +658,10 @@ innobase_commit_low(
 	trx_t*	trx);	/*!< in: transaction handle */
 
 static SHOW_VAR innodb_status_variables[]= {
+  {"buffer_pool_dump_status",
+  (char*) &export_vars.innodb_buffer_pool_dump_status,	  SHOW_CHAR},
+  {"buffer_pool_load_status",
+  (char*) &export_vars.innodb_buffer_pool_load_status,	  SHOW_CHAR},
   {"buffer_pool_pages_data",
   (char*) &export_vars.innodb_buffer_pool_pages_data,	  SHOW_LONG},
   {"buffer_pool_bytes_data",
@@ -619,6 +672,22 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_bytes_dirty,	  SHOW_LONG},
   {"buffer_pool_pages_flushed",
   (char*) &export_vars.innodb_buffer_pool_pages_flushed,  SHOW_LONG},
+  {"buffer_pool_pages_flushed_adaptive",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_adaptive, SHOW_LONG},
+  {"buffer_pool_pages_flushed_async",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_async, SHOW_LONG},
+  {"buffer_pool_pages_flushed_background",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_background,
+  SHOW_LONG},
+  {"buffer_pool_pages_flushed_lru",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_lru, SHOW_LONG},
+  {"buffer_pool_pages_flushed_lru_foreground",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_lru_foreground,
+  SHOW_LONG},
+  {"buffer_pool_pages_flushed_max_dirty",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_max_dirty, SHOW_LONG},
+  {"buffer_pool_pages_flushed_sync",
+  (char*) &export_vars.innodb_buffer_pool_pages_flushed_sync, SHOW_LONG},
   {"buffer_pool_pages_free",
   (char*) &export_vars.innodb_buffer_pool_pages_free,	  SHOW_LONG},
 #ifdef UNIV_DEBUG
@@ -635,6 +704,13 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_buffer_pool_read_ahead,	  SHOW_LONG},
   {"buffer_pool_read_ahead_evicted",
   (char*) &export_vars.innodb_buffer_pool_read_ahead_evicted, SHOW_LONG},
+  {"buffer_pool_read_ahead_logical",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical, SHOW_LONG},
+  {"buffer_pool_read_ahead_logical_used",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical_used, SHOW_LONG},
+  {"buffer_pool_read_ahead_logical_evicted",
+  (char*) &export_vars.innodb_buffer_pool_read_ahead_logical_evicted,
+  SHOW_LONG},
   {"buffer_pool_read_requests",
   (char*) &export_vars.innodb_buffer_pool_read_requests,  SHOW_LONG},
   {"buffer_pool_reads",
@@ -665,6 +741,14 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_dblwr_writes,		  SHOW_LONG},
   {"have_atomic_builtins",
   (char*) &export_vars.innodb_have_atomic_builtins,	  SHOW_BOOL},
+  {"history_list_length",
+  (char*) &export_vars.innodb_history_list_length,	  SHOW_LONG},
+  {"kernel_mutex_os_waits",
+  (char*) &export_vars.innodb_kernel_mutex_os_waits,	  SHOW_LONG},
+  {"lock_rec_mutex_os_waits",
+  (char*) &export_vars.innodb_lock_rec_mutex_os_waits,	  SHOW_LONG},
+  {"lock_sys_latch_os_waits",
+  (char*) &export_vars.innodb_lock_sys_latch_os_waits,	  SHOW_LONG},
   {"log_waits",
   (char*) &export_vars.innodb_log_waits,		  SHOW_LONG},
   {"log_write_requests",
@@ -687,6 +771,12 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_pages_read,		  SHOW_LONG},
   {"pages_written",
   (char*) &export_vars.innodb_pages_written,		  SHOW_LONG},
+  {"purge_lag_per_sec",
+  (char*) &export_vars.innodb_purge_lag_per_sec,	  SHOW_LONG},
+  {"purge_undo_records_per_sec",
+  (char*) &export_vars.innodb_purge_undo_records_per_sec, SHOW_LONG},
+  {"read_view_mutex_os_waits",
+  (char*) &export_vars.innodb_read_view_mutex_os_waits,	  SHOW_LONG},
   {"row_lock_current_waits",
   (char*) &export_vars.innodb_row_lock_current_waits,	  SHOW_LONG},
   {"row_lock_time",
@@ -705,8 +795,12 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_rows_read,		  SHOW_LONG},
   {"rows_updated",
   (char*) &export_vars.innodb_rows_updated,		  SHOW_LONG},
+  {"srv_conc_mutex_os_waits",
+  (char*) &export_vars.innodb_srv_conc_mutex_os_waits,	  SHOW_LONG},
   {"truncated_status_writes",
   (char*) &export_vars.innodb_truncated_status_writes,	SHOW_LONG},
+  {"trx_sys_mutex_os_waits",
+  (char*) &export_vars.innodb_trx_sys_mutex_os_waits,	  SHOW_LONG},
 #ifdef UNIV_DEBUG
   {"purge_trx_id_age",
   (char*) &export_vars.innodb_purge_trx_id_age,		  SHOW_LONG},
@@ -1612,15 +1706,16 @@ trx_is_registered_for_2pc(
 }
 
 /*********************************************************************//**
-Note that a transaction owns the prepare_commit_mutex. */
+Note that the commit of a transaction was done by
+innobase_commit_ordered(). */
 static inline
 void
-trx_owns_prepare_commit_mutex_set(
-/*==============================*/
+trx_set_active_commit_ordered(
+/*==========================*/
 	trx_t*	trx)	/* in: transaction */
 {
 	ut_a(trx_is_registered_for_2pc(trx));
-	trx->owns_prepare_mutex = 1;
+	trx->active_commit_ordered = 1;
 }
 
 /*********************************************************************//**
@@ -1632,7 +1727,7 @@ trx_register_for_2pc(
 	trx_t*	trx)	/* in: transaction */
 {
 	trx->is_registered = 1;
-	ut_ad(trx->owns_prepare_mutex == 0);
+	ut_ad(trx->active_commit_ordered == 0);
 }
 
 /*********************************************************************//**
@@ -1644,19 +1739,20 @@ trx_deregister_from_2pc(
 	trx_t*	trx)	/* in: transaction */
 {
 	trx->is_registered = 0;
-	trx->owns_prepare_mutex = 0;
+	trx->active_commit_ordered = 0;
 }
 
 /*********************************************************************//**
-Check whether atransaction owns the prepare_commit_mutex.
-@return true if transaction owns the prepare commit mutex */
+Check whether the commit of a transaction was done by
+innobase_commit_ordered().
+@return true if innobase_commit_ordered() committed the transaction */
 static inline
 bool
-trx_has_prepare_commit_mutex(
+trx_is_active_commit_ordered(
 /*=========================*/
 	const trx_t*	trx)	/* in: transaction */
 {
-	return(trx->owns_prepare_mutex == 1);
+	return(trx->active_commit_ordered == 1);
 }
 
 /*********************************************************************//**
@@ -1686,6 +1782,7 @@ ha_innobase::ha_innobase(handlerton *hton, TABLE_SHARE *table_arg)
 		  HA_CAN_GEOMETRY | HA_PARTIAL_COLUMN_READ |
 		  HA_TABLE_SCAN_ON_INDEX),
   start_of_scan(0),
+  in_range_read(false),
   num_write_row(0)
 {}
 
@@ -2152,6 +2249,7 @@ reset_template(
 {
 	prebuilt->keep_other_fields_on_keyread = 0;
 	prebuilt->read_just_key = 0;
+	prebuilt->idx_cond = NULL;
 }
 
 /*****************************************************************//**
@@ -2239,6 +2337,7 @@ innobase_init(
         innobase_hton->commit=innobase_commit;
         innobase_hton->rollback=innobase_rollback;
         innobase_hton->prepare=innobase_xa_prepare;
+        innobase_hton->commit_ordered=innobase_commit_ordered;
         innobase_hton->recover=innobase_xa_recover;
         innobase_hton->commit_by_xid=innobase_commit_by_xid;
         innobase_hton->rollback_by_xid=innobase_rollback_by_xid;
@@ -2487,6 +2586,12 @@ innobase_change_buffering_inited_ok:
 	srv_use_doublewrite_buf = (ibool) innobase_use_doublewrite;
 	srv_use_checksums = (ibool) innobase_use_checksums;
 
+	if (!innobase_use_checksums) {
+		/* --skip-innodb-checksums implies that no checksums are
+		written either. */
+		srv_checksum_algorithm = SRV_CHECKSUM_ALGORITHM_NONE;
+	}
+
 #ifdef HAVE_LARGE_PAGES
         if ((os_use_large_pages = (ibool) my_use_large_pages))
 		os_large_page_size = (ulint) opt_large_page_size;
@@ -2578,8 +2683,6 @@ innobase_change_buffering_inited_ok:
 	mysql_mutex_init(innobase_share_mutex_key,
 			 &innobase_share_mutex,
 			 MY_MUTEX_INIT_FAST);
-	mysql_mutex_init(prepare_commit_mutex_key,
-			 &prepare_commit_mutex, MY_MUTEX_INIT_FAST);
 	mysql_mutex_init(commit_cond_mutex_key,
 			 &commit_cond_m, MY_MUTEX_INIT_FAST);
 	mysql_cond_init(commit_cond_key, &commit_cond, NULL);
@@ -2627,7 +2730,6 @@ innobase_end(
 		srv_free_paths_and_sizes();
 		my_free(internal_innobase_data_file_path);
 		mysql_mutex_destroy(&innobase_share_mutex);
-		mysql_mutex_destroy(&prepare_commit_mutex);
 		mysql_mutex_destroy(&commit_cond_m);
 		mysql_cond_destroy(&commit_cond);
 	}
@@ -2744,6 +2846,113 @@ innobase_start_trx_and_assign_read_view(
 	DBUG_RETURN(0);
 }
 
+/*****************************************************************//**
+Commits a transaction, but leaves the write and flush of the log to
+trx_commit_complete_for_mysql(), so that the slow part of the commit
+can be done in parallel by the committing threads. */
+static
+void
+innobase_commit_ordered_2(
+/*======================*/
+	trx_t*	trx,	/*!< in: InnoDB transaction */
+	THD*	thd)	/*!< in: MySQL thread handle of the user for whom
+			the transaction is committed */
+{
+	ulonglong	pos;
+
+	DBUG_ENTER("innobase_commit_ordered_2");
+
+retry:
+	if (innobase_commit_concurrency > 0) {
+		mysql_mutex_lock(&commit_cond_m);
+		commit_threads++;
+
+		if (commit_threads > innobase_commit_concurrency) {
+			commit_threads--;
+			mysql_cond_wait(&commit_cond,
+				&commit_cond_m);
+			mysql_mutex_unlock(&commit_cond_m);
+			goto retry;
+		}
+		else {
+			mysql_mutex_unlock(&commit_cond_m);
+		}
+	}
+
+	/* We need the binlog position of the transaction for ibbackup
+	to work. The position is consistent with the commit order in
+	InnoDB:
+	1) When called from innobase_commit_ordered(), the binlog group
+	commit calls us in binlog order and passes the position just
+	after this transaction.
+	2) Binary logging of other engines is not relevant
+	to InnoDB as all InnoDB requires is that committing
+	InnoDB transactions appear in the same order in the
+	MySQL binary log as they appear in InnoDB logs.
+	3) A MySQL log file rotation cannot happen because
+	MySQL protects against this by having a counter of
+	transactions in prepared state and it only allows
+	a rotation when the counter drops to zero. See
+	LOCK_prep_xids and COND_prep_xids in log.cc. */
+	mysql_bin_log_commit_pos(thd, &pos, &trx->mysql_log_file_name);
+	trx->mysql_log_offset = (ib_int64_t) pos;
+
+	/* Don't do write + flush right now. For group commit
+	to work we want to do the flush later, in
+	trx_commit_complete_for_mysql(), outside of the binlog
+	commit order. */
+	trx->flush_log_later = TRUE;
+	innobase_commit_low(trx);
+	trx->flush_log_later = FALSE;
+
+	if (innobase_commit_concurrency > 0) {
+		mysql_mutex_lock(&commit_cond_m);
+		commit_threads--;
+		mysql_cond_signal(&commit_cond);
+		mysql_mutex_unlock(&commit_cond_m);
+	}
+
+	DBUG_VOID_RETURN;
+}
+
+/*****************************************************************//**
+Commits a transaction in binlog order. Called by the binlog group
+commit, possibly from another thread than the one of the transaction,
+after the transaction was written to the binlog and before
+innobase_commit(). innobase_commit() then only flushes the log. */
+static
+void
+innobase_commit_ordered(
+/*====================*/
+	handlerton*	hton,	/*!< in: InnoDB handlerton */
+	THD*		thd,	/*!< in: MySQL thread handle of the user
+				for whom the transaction is committed */
+	bool		all)	/*!< in: TRUE - commit transaction
+				FALSE - the current SQL statement
+				ended */
+{
+	trx_t*	trx;
+
+	DBUG_ENTER("innobase_commit_ordered");
+	DBUG_ASSERT(hton == innodb_hton_ptr);
+
+	trx = thd_to_trx(thd);
+
+	if (trx == NULL || !trx_is_registered_for_2pc(trx)) {
+		/* Nothing to commit, innobase_commit() will sort it out */
+		DBUG_VOID_RETURN;
+	}
+
+	if (all
+	    || (!thd_test_options(thd, OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN))) {
+
+		innobase_commit_ordered_2(trx, thd);
+		trx_set_active_commit_ordered(trx);
+	}
+
+	DBUG_VOID_RETURN;
+}
+
 /*****************************************************************//**
 Commits a transaction in an InnoDB database or marks an SQL statement
 ended.
@@ -2790,61 +2999,14 @@ innobase_commit(
 		/* We were instructed to commit the whole transaction, or
 		this is an SQL statement end and autocommit is on */
 
-		/* We need current binlog position for ibbackup to work.
-		Note, the position is current because of
-		prepare_commit_mutex */
-retry:
-		if (innobase_commit_concurrency > 0) {
-			mysql_mutex_lock(&commit_cond_m);
-			commit_threads++;
-
-			if (commit_threads > innobase_commit_concurrency) {
-				commit_threads--;
-				mysql_cond_wait(&commit_cond,
-					&commit_cond_m);
-				mysql_mutex_unlock(&commit_cond_m);
-				goto retry;
-			}
-			else {
-				mysql_mutex_unlock(&commit_cond_m);
-			}
+		/* If the binlog group commit did not already commit the
+		transaction in innobase_commit_ordered(), do it now. This
+		is the case when the binlog is not the transaction
+		coordinator, or the transaction wrote nothing to it. */
+		if (!trx_is_active_commit_ordered(trx)) {
+			innobase_commit_ordered_2(trx, thd);
 		}
 
-		/* The following calls to read the MySQL binary log
-		file name and the position return consistent results:
-		1) Other InnoDB transactions cannot intervene between
-		these calls as we are holding prepare_commit_mutex.
-		2) Binary logging of other engines is not relevant
-		to InnoDB as all InnoDB requires is that committing
-		InnoDB transactions appear in the same order in the
-		MySQL binary log as they appear in InnoDB logs.
-		3) A MySQL log file rotation cannot happen because
-		MySQL protects against this by having a counter of
-		transactions in prepared state and it only allows
-		a rotation when the counter drops to zero. See
-		LOCK_prep_xids and COND_prep_xids in log.cc. */
-		trx->mysql_log_file_name = mysql_bin_log_file_name();
-		trx->mysql_log_offset = (ib_int64_t) mysql_bin_log_file_pos();
-
-		/* Don't do write + flush right now. For group commit
-		to work we want to do the flush after releasing the
-		prepare_commit_mutex. */
-		trx->flush_log_later = TRUE;
-		innobase_commit_low(trx);
-		trx->flush_log_later = FALSE;
-
-		if (innobase_commit_concurrency > 0) {
-			mysql_mutex_lock(&commit_cond_m);
-			commit_threads--;
-			mysql_cond_signal(&commit_cond);
-			mysql_mutex_unlock(&commit_cond_m);
-		}
-
-		if (trx_has_prepare_commit_mutex(trx)) {
-  
-			mysql_mutex_unlock(&prepare_commit_mutex);
-  		}
-  
 		trx_deregister_from_2pc(trx);
 
 		/* Now do a write + flush of logs. */
@@ -2921,9 +3083,6 @@ innobase_rollback(
 	    || !thd_test_options(thd, OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN)) {
 
 		error = trx_rollback_for_mysql(trx);
-                if (trx_has_prepare_commit_mutex(trx)) {
-                  mysql_mutex_unlock(&prepare_commit_mutex);
-                }
 		trx_deregister_from_2pc(trx);
 	} else {
 		error = trx_rollback_last_sql_stat_for_mysql(trx);
@@ -3237,7 +3396,8 @@ ha_innobase::index_flags(
 const
 {
 	return(HA_READ_NEXT | HA_READ_PREV | HA_READ_ORDER
-	       | HA_READ_RANGE | HA_KEYREAD_ONLY);
+	       | HA_READ_RANGE | HA_KEYREAD_ONLY
+	       | HA_DO_INDEX_COND_PUSHDOWN);
 }
 
 /****************************************************************//**
@@ -3843,8 +4003,8 @@ ha_innobase::open(
 	thd = ha_thd();
 
 	/* Under some cases MySQL seems to call this function while
-	holding btr_search_latch. This breaks the latching order as
-	we acquire dict_sys->mutex below and leads to a deadlock. */
+	holding an adaptive hash index latch. This breaks the latching
+	order as we acquire dict_sys->mutex below and leads to a deadlock. */
 	if (thd != NULL) {
 		innobase_release_temporary_latches(ht, thd);
 	}
@@ -4780,8 +4940,11 @@ build_template(
 					only if templ_type is
 					ROW_MYSQL_REC_FIELDS */
 	TABLE*		table,		/*!< in: MySQL table */
-	uint		templ_type)	/*!< in: ROW_MYSQL_WHOLE_ROW or
+	uint		templ_type,	/*!< in: ROW_MYSQL_WHOLE_ROW or
 					ROW_MYSQL_REC_FIELDS */
+	handler*	file)		/*!< in: the handler if an index
+					condition is pushed down to
+					prebuilt->index, or NULL */
 {
 	dict_index_t*	index;
 	dict_index_t*	clust_index;
@@ -4845,12 +5008,18 @@ build_template(
 
 	if (index == clust_index) {
 		prebuilt->need_to_access_clustered = TRUE;
+		file = NULL;
 	} else {
 		prebuilt->need_to_access_clustered = FALSE;
 		/* Below we check column by column if we need to access
 		the clustered index */
 	}
 
+	/* The index condition is checked on the secondary index record
+	before the clustered index record is fetched, see
+	row_search_idx_cond_check() */
+	prebuilt->idx_cond = file;
+
 	n_fields = (ulint)table->s->fields; /* number of columns */
 
 	if (!prebuilt->mysql_template) {
@@ -4926,6 +5095,9 @@ include_field:
 			}
 		}
 
+		templ->icp_rec_field_no = file
+			? templ->rec_field_no : ULINT_UNDEFINED;
+
 		if (field->null_ptr) {
 			templ->mysql_null_byte_offset =
 				(ulint) ((char*) field->null_ptr
@@ -5231,7 +5403,7 @@ no_commit:
 		/* Build the template used in converting quickly between
 		the two database formats */
 
-		build_template(prebuilt, NULL, table, ROW_MYSQL_WHOLE_ROW);
+		build_template(prebuilt, NULL, table, ROW_MYSQL_WHOLE_ROW, NULL);
 	}
 
 	innodb_srv_conc_enter_innodb(prebuilt->trx);
@@ -5912,7 +6084,10 @@ ha_innobase::index_read(
 	necessarily prebuilt->index, but can also be the clustered index */
 
 	if (prebuilt->sql_stat_start) {
-		build_template(prebuilt, user_thd, table, ROW_MYSQL_REC_FIELDS);
+		build_template(prebuilt, user_thd, table, ROW_MYSQL_REC_FIELDS,
+			       pushed_idx_cond
+			       && active_index == pushed_idx_cond_keyno
+			       ? this : NULL);
 	}
 
 	if (key_ptr) {
@@ -5950,6 +6125,11 @@ ha_innobase::index_read(
 
 	last_match_mode = (uint) match_mode;
 
+	/* A scan of the whole index or of a key range may cache
+	more rows per batch */
+
+	prebuilt->large_scan = key_ptr == NULL || in_range_read;
+
 	if (mode != PAGE_CUR_UNSUPP) {
 
 		innodb_srv_conc_enter_innodb(prebuilt->trx);
@@ -6135,7 +6315,9 @@ ha_innobase::change_active_index(
 	the flag ROW_MYSQL_WHOLE_ROW below, but that caused unnecessary
 	copying. Starting from MySQL-4.1 we use a more efficient flag here. */
 
-	build_template(prebuilt, user_thd, table, ROW_MYSQL_REC_FIELDS);
+	build_template(prebuilt, user_thd, table, ROW_MYSQL_REC_FIELDS,
+		       pushed_idx_cond && keynr == pushed_idx_cond_keyno
+		       ? this : NULL);
 
 	DBUG_RETURN(0);
 }
@@ -6316,6 +6498,38 @@ ha_innobase::index_last(
 	DBUG_RETURN(error);
 }
 
+/**********************************************************************//**
+Positions a cursor on the first record of a key range and reads the
+corresponding row to table->record[0].
+@return	0, HA_ERR_END_OF_FILE, or error code */
+UNIV_INTERN
+int
+ha_innobase::read_range_first(
+/*==========================*/
+	const key_range*	start_key,	/*!< in: range start key, or
+						NULL to start from the first
+						record of the index */
+	const key_range*	end_key,	/*!< in: range end key,
+						or NULL */
+	bool			eq_range_arg,	/*!< in: whether this is an
+						equality range */
+	bool			sorted)		/*!< in: whether the rows
+						must be returned in order */
+{
+	int	error;
+
+	DBUG_ENTER("ha_innobase::read_range_first");
+
+	in_range_read = !eq_range_arg;
+
+	error = handler::read_range_first(start_key, end_key,
+					  eq_range_arg, sorted);
+
+	in_range_read = false;
+
+	DBUG_RETURN(error);
+}
+
 /****************************************************************//**
 Initialize a table scan.
 @return	0 or error number */
@@ -8166,9 +8380,24 @@ ha_innobase::info_low(
 	ib_table = prebuilt->table;
 
 	if (flag & HA_STATUS_TIME) {
-		if (called_from_analyze || innobase_stats_on_metadata) {
+		if (srv_stats_persistent && called_from_analyze) {
+			/* Recalculate the persistent statistics and
+			save them to SYS_STATS */
+
+			prebuilt->trx->op_info = "updating table statistics";
+
+			DEBUG_SYNC_C("info_before_stats_update");
+
+			dict_stats_update(ib_table, TRUE);
+
+			prebuilt->trx->op_info = "returning various info to MySQL";
+		} else if (called_from_analyze
+			   || (innobase_stats_on_metadata
+			       && !srv_stats_persistent)) {
 			/* In sql_show we call with this flag: update
-			then statistics so that they are up-to-date */
+			then statistics so that they are up-to-date.
+			Persistent statistics are only changed by
+			ANALYZE TABLE and by the dict_stats thread. */
 
 			prebuilt->trx->op_info = "updating table statistics";
 
@@ -8497,7 +8726,7 @@ ha_innobase::check(
 		/* Build the template; we will use a dummy template
 		in index scans done in checking */
 
-		build_template(prebuilt, NULL, table, ROW_MYSQL_WHOLE_ROW);
+		build_template(prebuilt, NULL, table, ROW_MYSQL_WHOLE_ROW, NULL);
 	}
 
 	if (prebuilt->table->ibd_file_missing) {
@@ -9162,6 +9391,10 @@ ha_innobase::reset()
 		row_mysql_prebuilt_free_blob_heap(prebuilt);
 	}
 
+	/* Give back the row buffers that a large scan of this
+	statement added to the fetch cache. */
+	row_mysql_prebuilt_shrink_fetch_cache(prebuilt);
+
 	reset_template(prebuilt);
 
 	/* TODO: This should really be reset in reset_template() but for now
@@ -10631,32 +10864,11 @@ innobase_xa_prepare(
 
 	srv_active_wake_master_thread();
 
-	if (thd_sql_command(thd) != SQLCOM_XA_PREPARE
-	    && (all
-		|| !thd_test_options(
-			thd, OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN))) {
-
-		/* For ibbackup to work the order of transactions in binlog
-		and InnoDB must be the same. Consider the situation
-
-		  thread1> prepare; write to binlog; ...
-			  <context switch>
-		  thread2> prepare; write to binlog; commit
-		  thread1>			     ... commit
-
-		To ensure this will not happen we're taking the mutex on
-		prepare, and releasing it on commit.
-
-		Note: only do it for normal commits, done via ha_commit_trans.
-		If 2pc protocol is executed by external transaction
-		coordinator, it will be just a regular MySQL client
-		executing XA PREPARE and XA COMMIT commands.
-		In this case we cannot know how many minutes or hours
-		will be between XA PREPARE and XA COMMIT, and we don't want
-		to block for undefined period of time. */
-		mysql_mutex_lock(&prepare_commit_mutex);
-		trx_owns_prepare_commit_mutex_set(trx);
-	}
+	/* For ibbackup to work the order of transactions in binlog and
+	InnoDB must be the same. No mutex is held from prepare to commit
+	for that: the binlog group commit calls innobase_commit_ordered()
+	for the transactions of a group in binlog order, and for the
+	groups in binlog order too. */
 
 	return(error);
 }
@@ -10959,6 +11171,42 @@ ha_innobase::check_if_incompatible_data(
 	return(COMPATIBLE_DATA_YES);
 }
 
+/********************************************************************//**
+Attempt to push down an index condition.
+@return the part of the condition that is not pushed down (always NULL) */
+UNIV_INTERN
+Item*
+ha_innobase::idx_cond_push(
+/*=======================*/
+	uint	keyno,		/*!< in: index number */
+	Item*	idx_cond)	/*!< in: condition on the columns of
+				the index */
+{
+	DBUG_ENTER("ha_innobase::idx_cond_push");
+	DBUG_ASSERT(keyno != MAX_KEY);
+	DBUG_ASSERT(idx_cond != NULL);
+
+	pushed_idx_cond = idx_cond;
+	pushed_idx_cond_keyno = keyno;
+
+	/* The whole condition is evaluated by InnoDB before the clustered
+	index record is fetched. */
+	DBUG_RETURN(NULL);
+}
+
+/*********************************************************************//**
+Checks the condition pushed down to the index that is being scanned, after
+the columns of the index have been stored in the MySQL record buffer.
+@return result of the check, see handler_index_cond_check() */
+extern "C" UNIV_INTERN
+enum icp_result
+innobase_index_cond(
+/*================*/
+	void*	file)	/*!< in/out: pointer to ha_innobase */
+{
+	return(handler_index_cond_check(file));
+}
+
 /************************************************************//**
 Validate the file format name and return its corresponding id.
 @return	valid file format id */
@@ -11233,6 +11481,89 @@ innodb_adaptive_hash_index_update(
 	}
 }
 
+/****************************************************************//**
+Update the system variable innodb_cmp_per_index_enabled using the "saved"
+value. Enabling it discards the statistics collected while it was last
+enabled. This function is registered as a callback with MySQL. */
+static
+void
+innodb_cmp_per_index_update(
+/*========================*/
+	THD*				thd,		/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,		/*!< in: pointer to
+							system variable */
+	void*				var_ptr,	/*!< out: where the
+							formal string goes */
+	const void*			save)		/*!< in: immediate result
+							from check function */
+{
+	if (!srv_cmp_per_index_enabled && *(my_bool*) save) {
+		page_zip_stat_per_index_reset();
+	}
+
+	srv_cmp_per_index_enabled = *(my_bool*) save;
+}
+
+/****************************************************************//**
+Trigger a dump of the buffer pool if innodb_buffer_pool_dump_now is set
+to ON. This function is registered as a callback with MySQL. */
+static
+void
+buffer_pool_dump_now(
+/*=================*/
+	THD*				thd,		/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,		/*!< in: pointer to
+							system variable */
+	void*				var_ptr,	/*!< out: where the
+							formal string goes */
+	const void*			save)		/*!< in: immediate result
+							from check function */
+{
+	if (*(my_bool*) save) {
+		buf_dump_start();
+	}
+}
+
+/****************************************************************//**
+Trigger a load of the buffer pool if innodb_buffer_pool_load_now is set
+to ON. This function is registered as a callback with MySQL. */
+static
+void
+buffer_pool_load_now(
+/*=================*/
+	THD*				thd,		/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,		/*!< in: pointer to
+							system variable */
+	void*				var_ptr,	/*!< out: where the
+							formal string goes */
+	const void*			save)		/*!< in: immediate result
+							from check function */
+{
+	if (*(my_bool*) save) {
+		buf_load_start();
+	}
+}
+
+/****************************************************************//**
+Abort a load of the buffer pool if innodb_buffer_pool_load_abort is set
+to ON. This function is registered as a callback with MySQL. */
+static
+void
+buffer_pool_load_abort(
+/*===================*/
+	THD*				thd,		/*!< in: thread handle */
+	struct st_mysql_sys_var*	var,		/*!< in: pointer to
+							system variable */
+	void*				var_ptr,	/*!< out: where the
+							formal string goes */
+	const void*			save)		/*!< in: immediate result
+							from check function */
+{
+	if (*(my_bool*) save) {
+		buf_load_abort();
+	}
+}
+
 /****************************************************************//**
 Update the system variable innodb_old_blocks_pct using the "saved"
 value. This function is registered as a callback with MySQL. */
@@ -11475,6 +11806,30 @@ static MYSQL_SYSVAR_BOOL(checksums, innobase_use_checksums,
   "Disable with --skip-innodb-checksums.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ENUM(checksum_algorithm, srv_checksum_algorithm,
+  PLUGIN_VAR_RQCMDARG,
+  "The algorithm InnoDB uses for page checksumming. Possible values are "
+  "CRC32 (hardware accelerated if the CPU supports it) "
+    "write crc32, allow any of the other checksums to match when reading; "
+  "STRICT_CRC32 "
+    "write crc32, do not allow other algorithms to match when reading; "
+  "INNODB "
+    "write a software calculated checksum, allow any other checksums "
+    "to match when reading; "
+  "STRICT_INNODB "
+    "write a software calculated checksum, do not allow other algorithms "
+    "to match when reading; "
+  "NONE "
+    "write a constant magic number, allow any of the other checksums "
+    "to match when reading; "
+  "STRICT_NONE "
+    "write a constant magic number, do not allow values other than that "
+    "magic number when reading; "
+  "Files updated when this option is set to crc32 or strict_crc32 are "
+  "not readable by servers that do not support this option",
+  NULL, NULL, SRV_CHECKSUM_ALGORITHM_INNODB,
+  &innodb_checksum_algorithm_typelib);
+
 static MYSQL_SYSVAR_STR(data_home_dir, innobase_data_home_dir,
   PLUGIN_VAR_READONLY,
   "The common part for InnoDB table spaces.",
@@ -11486,6 +11841,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_STR(doublewrite_file, srv_doublewrite_file,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "File, relative to innodb_data_home_dir, that holds the doublewrite "
+  "buffer in separate areas for each buffer pool instance and flush type, "
+  "so that flushes can write their batches concurrently. If not set, the "
+  "doublewrite buffer in the system tablespace is used.",
+  NULL, NULL, NULL);
+
 static MYSQL_SYSVAR_ULONG(io_capacity, srv_io_capacity,
   PLUGIN_VAR_RQCMDARG,
   "Number of IOPs the server can do. Tunes the background IO rate",
@@ -11509,11 +11872,34 @@ static MYSQL_SYSVAR_ULONG(rollback_segments, srv_rollback_segments,
 
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
   PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
-  "Purge threads can be either 0 or 1.",
+  "Number of purge threads. 0 means that the master thread does the purge; "
+  "otherwise a purge coordinator thread splits each purge batch by table "
+  "among itself and the remaining purge worker threads.",
   NULL, NULL,
   0,			/* Default setting */
   0,			/* Minimum value */
-  1, 0);		/* Maximum value */
+  32, 0);		/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(merge_threads, srv_merge_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that sort and load the secondary indexes of a fast "
+  "index creation in parallel. The threads that are not needed for "
+  "building separate indexes execute the merge passes of an index in "
+  "parallel.",
+  NULL, NULL,
+  4,			/* Default setting */
+  1,			/* Minimum value */
+  64, 0);		/* Maximum value */
+
+static MYSQL_SYSVAR_ULONG(fill_factor, srv_fill_factor,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of each B-tree page that is filled when fast index creation "
+  "loads a secondary index bottom-up. The rest is left free for later "
+  "inserts.",
+  NULL, NULL,
+  100,			/* Default setting */
+  10,			/* Minimum value */
+  100, 0);		/* Maximum value */
 
 static MYSQL_SYSVAR_ULONG(fast_shutdown, innobase_fast_shutdown,
   PLUGIN_VAR_OPCMDARG,
@@ -11628,12 +12014,59 @@ static MYSQL_SYSVAR_ULONGLONG(stats_sample_pages, srv_stats_sample_pages,
   "The number of index pages to sample when calculating statistics (default 8)",
   NULL, NULL, 8, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_BOOL(stats_persistent, srv_stats_persistent,
+  PLUGIN_VAR_OPCMDARG,
+  "Keep the index statistics of InnoDB tables in the SYS_STATS system table, "
+  "so that they survive a restart and only change on ANALYZE TABLE or after "
+  "10% of the rows of a table have changed (off by default)",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_ULONGLONG(stats_persistent_sample_pages,
+  srv_stats_persistent_sample_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "The number of index pages to sample when calculating persistent "
+  "statistics (default 20)",
+  NULL, NULL, 20, 1, ~0ULL, 0);
+
+static MYSQL_SYSVAR_UINT(compression_level, page_zip_level,
+  PLUGIN_VAR_RQCMDARG,
+  "Compression level used for compressed row format. 0 is no compression"
+  ", 1 is fastest, 9 is best compression and default is 6.",
+  NULL, NULL, DEFAULT_COMPRESSION_LEVEL, 0, 9, 0);
+
+static MYSQL_SYSVAR_ULONG(compression_failure_threshold_pct,
+  zip_failure_threshold_pct, PLUGIN_VAR_OPCMDARG,
+  "If the compression failure rate of an index exceeds this percentage, "
+  "padding is added to its leaf pages to avoid compression failures. "
+  "0 disables the padding.",
+  NULL, NULL, 5, 0, 100, 0);
+
+static MYSQL_SYSVAR_ULONG(compression_pad_pct_max, zip_pad_max,
+  PLUGIN_VAR_OPCMDARG,
+  "Maximum percentage of a compressed leaf page that may be reserved as "
+  "padding to avoid compression failures.",
+  NULL, NULL, 50, 0, 75, 0);
+
+static MYSQL_SYSVAR_BOOL(cmp_per_index_enabled, srv_cmp_per_index_enabled,
+  PLUGIN_VAR_OPCMDARG,
+  "Collect the compression statistics of each index in "
+  "INFORMATION_SCHEMA.INNODB_CMP_PER_INDEX (off by default, "
+  "because it slows down compression).",
+  NULL, innodb_cmp_per_index_update, FALSE);
+
 static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   PLUGIN_VAR_OPCMDARG,
   "Enable InnoDB adaptive hash index (enabled by default).  "
   "Disable with --skip-innodb-adaptive-hash-index.",
   NULL, innodb_adaptive_hash_index_update, TRUE);
 
+static MYSQL_SYSVAR_ULONG(adaptive_hash_index_partitions,
+  srv_adaptive_hash_index_parts,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of InnoDB adaptive hash index partitions. Each partition has "
+  "its own latch, and an index is assigned to a partition by its index id.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if "
@@ -11657,6 +12090,48 @@ static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   NULL, innodb_buffer_pool_evict_update, "");
 #endif /* !DBUG_OFF */
 
+static MYSQL_SYSVAR_STR(buffer_pool_filename, srv_buf_dump_filename,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_MEMALLOC,
+  "Filename to/from which to dump/load the InnoDB buffer pool, "
+  "relative to innodb_data_home_dir",
+  NULL, NULL, "ib_buffer_pool");
+
+static my_bool	innodb_buffer_pool_dump_now = FALSE;
+static my_bool	innodb_buffer_pool_load_now = FALSE;
+static my_bool	innodb_buffer_pool_load_abort = FALSE;
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_dump_now, innodb_buffer_pool_dump_now,
+  PLUGIN_VAR_RQCMDARG,
+  "Trigger an immediate dump of the buffer pool into a file named "
+  "@@innodb_buffer_pool_filename",
+  NULL, buffer_pool_dump_now, FALSE);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_dump_at_shutdown,
+  srv_buffer_pool_dump_at_shutdown,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool into a file named @@innodb_buffer_pool_filename "
+  "at shutdown",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_load_now, innodb_buffer_pool_load_now,
+  PLUGIN_VAR_RQCMDARG,
+  "Trigger an immediate load of the buffer pool from a file named "
+  "@@innodb_buffer_pool_filename",
+  NULL, buffer_pool_load_now, FALSE);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_load_abort,
+  innodb_buffer_pool_load_abort,
+  PLUGIN_VAR_RQCMDARG,
+  "Abort a currently running load of the buffer pool",
+  NULL, buffer_pool_load_abort, FALSE);
+
+static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup,
+  srv_buffer_pool_load_at_startup,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Load the buffer pool from a file named @@innodb_buffer_pool_filename "
+  "at startup",
+  NULL, NULL, FALSE);
+
 static MYSQL_SYSVAR_LONGLONG(buffer_pool_size, innobase_buffer_pool_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "The size of the memory buffer InnoDB uses to cache data and indexes of its tables.",
@@ -11817,6 +12292,13 @@ static MYSQL_SYSVAR_ULONG(read_ahead_threshold, srv_read_ahead_threshold,
   "trigger a readahead.",
   NULL, NULL, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(read_ahead_logical_pages,
+  srv_read_ahead_logical_pages,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of leaf pages that a long ascending index scan reads ahead "
+  "by following the node pointers of the parent level (0 = disabled).",
+  NULL, NULL, 0, 0, 64, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_UINT(trx_rseg_n_slots_debug, trx_rseg_n_slots_debug,
   PLUGIN_VAR_RQCMDARG,
@@ -11848,13 +12330,21 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* !DBUG_OFF */
   MYSQL_SYSVAR(buffer_pool_size),
+  MYSQL_SYSVAR(buffer_pool_filename),
+  MYSQL_SYSVAR(buffer_pool_dump_now),
+  MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
+  MYSQL_SYSVAR(buffer_pool_load_now),
+  MYSQL_SYSVAR(buffer_pool_load_abort),
+  MYSQL_SYSVAR(buffer_pool_load_at_startup),
   MYSQL_SYSVAR(buffer_pool_instances),
   MYSQL_SYSVAR(checksums),
+  MYSQL_SYSVAR(checksum_algorithm),
   MYSQL_SYSVAR(commit_concurrency),
   MYSQL_SYSVAR(concurrency_tickets),
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_file),
   MYSQL_SYSVAR(fast_shutdown),
   MYSQL_SYSVAR(file_io_threads),
   MYSQL_SYSVAR(read_io_threads),
@@ -11888,7 +12378,14 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(rollback_on_timeout),
   MYSQL_SYSVAR(stats_on_metadata),
   MYSQL_SYSVAR(stats_sample_pages),
+  MYSQL_SYSVAR(stats_persistent),
+  MYSQL_SYSVAR(stats_persistent_sample_pages),
+  MYSQL_SYSVAR(compression_level),
+  MYSQL_SYSVAR(compression_failure_threshold_pct),
+  MYSQL_SYSVAR(compression_pad_pct_max),
+  MYSQL_SYSVAR(cmp_per_index_enabled),
   MYSQL_SYSVAR(adaptive_hash_index),
+  MYSQL_SYSVAR(adaptive_hash_index_partitions),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
@@ -11909,8 +12406,11 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
   MYSQL_SYSVAR(random_read_ahead),
   MYSQL_SYSVAR(read_ahead_threshold),
+  MYSQL_SYSVAR(read_ahead_logical_pages),
   MYSQL_SYSVAR(io_capacity),
   MYSQL_SYSVAR(purge_threads),
+  MYSQL_SYSVAR(merge_threads),
+  MYSQL_SYSVAR(fill_factor),
   MYSQL_SYSVAR(purge_batch_size),
   MYSQL_SYSVAR(rollback_segments),
 #ifdef UNIV_DEBUG
@@ -11945,9 +12445,12 @@ i_s_innodb_cmp,
 i_s_innodb_cmp_reset,
 i_s_innodb_cmpmem,
 i_s_innodb_cmpmem_reset,
+i_s_innodb_cmp_per_index,
+i_s_innodb_cmp_per_index_reset,
 i_s_innodb_buffer_page,
 i_s_innodb_buffer_page_lru,
-i_s_innodb_buffer_stats
+i_s_innodb_buffer_stats,
+i_s_innodb_ibuf_pending_merges
 mysql_declare_plugin_end;
 
 /** @brief Initialize the default value of innodb_commit_concurrency.
@@ -93,6 +93,9 @@ class ha_innobase: public handler
 	ulong		start_of_scan;	/*!< this is set to 1 when we are
 					starting a table scan but have not
 					yet fetched any row, else 0 */
+	bool		in_range_read;	/*!< TRUE while read_range_first()
+					positions the cursor on a key
+					range that is not an equality */
 	uint		last_match_mode;/* match mode of the latest search:
 					ROW_SEL_EXACT, ROW_SEL_EXACT_PREFIX,
 					or undefined */
@@ -159,6 +162,9 @@ class ha_innobase: public handler
 	int index_prev(uchar * buf);
 	int index_first(uchar * buf);
 	int index_last(uchar * buf);
+	int read_range_first(const key_range *start_key,
+			     const key_range *end_key,
+			     bool eq_range_arg, bool sorted);
 
 	int rnd_init(bool scan);
 	int rnd_end();
@@ -228,6 +234,7 @@ class ha_innobase: public handler
 	/** @} */
 	bool check_if_incompatible_data(HA_CREATE_INFO *info,
 					uint table_changes);
+	Item* idx_cond_push(uint keyno, Item* idx_cond);
 };
 
 /* Some accessor functions which the InnoDB plugin needs, but which
@@ -252,6 +259,14 @@ const char* mysql_bin_log_file_name(void);
  */
 ulonglong mysql_bin_log_file_pos(void);
 
+/** Get the binlog position of a transaction that is being committed.
+ * @param thd       the thread of the transaction
+ * @param out_pos   byte offset from the beginning of the binlog
+ * @param out_file  the name of the binlog file
+ */
+void mysql_bin_log_commit_pos(MYSQL_THD thd, ulonglong *out_pos,
+                              const char **out_file);
+
 /**
   Check if a user thread is a replication slave thread
   @param thd  user thread
@@ -35,8 +35,11 @@ extern struct st_mysql_plugin	i_s_innodb_cmp;
 extern struct st_mysql_plugin	i_s_innodb_cmp_reset;
 extern struct st_mysql_plugin	i_s_innodb_cmpmem;
 extern struct st_mysql_plugin	i_s_innodb_cmpmem_reset;
+extern struct st_mysql_plugin	i_s_innodb_cmp_per_index;
+extern struct st_mysql_plugin	i_s_innodb_cmp_per_index_reset;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page;
 extern struct st_mysql_plugin	i_s_innodb_buffer_page_lru;
 extern struct st_mysql_plugin	i_s_innodb_buffer_stats;;
+extern struct st_mysql_plugin	i_s_innodb_ibuf_pending_merges;
 
 #endif /* i_s_h */
@@ -57,6 +57,9 @@ Created 7/19/1997 Heikki Tuuri
 #include "que0que.h"
 #include "srv0start.h" /* srv_shutdown_state */
 #include "rem0cmp.h"
+#include "srv0srv.h"
+#include "log0log.h"
+#include "ut0sort.h"
 
 /*	STRUCTURE OF AN INSERT BUFFER RECORD
 
@@ -321,6 +324,31 @@ this many pages, we start to contract it synchronous contract, but do
 not insert */
 #define IBUF_CONTRACT_DO_NOT_INSERT		10
 
+/** Maximum number of pages that the ibuf merge thread reads in one batch */
+#define IBUF_MERGE_BATCH_MAX		64
+
+/** Maximum number of pages with buffered changes among which the ibuf
+merge thread picks the ones with the most changes for a batch */
+#define IBUF_MERGE_N_CANDIDATES		512
+
+/** Maximum number of insert buffer leaf pages that the ibuf merge thread
+scans for the pages of a batch */
+#define IBUF_MERGE_SCAN_LEAVES		8
+
+/** Event that wakes up the ibuf merge thread ahead of its one second
+schedule */
+UNIV_INTERN os_event_t	ibuf_merge_event;
+
+/** TRUE while the ibuf merge thread is running */
+UNIV_INTERN ibool	ibuf_merge_thread_active	= FALSE;
+
+/** A page with buffered changes that the ibuf merge thread may read */
+typedef struct {
+	ulint	space;		/*!< tablespace id */
+	ulint	page_no;	/*!< page number */
+	ulint	volume;		/*!< combined size of the buffered changes */
+} ibuf_merge_cand_t;
+
 /* TODO: how to cope with drop table if there are records in the insert
 buffer for the indexes of the table? Is there actually any problem,
 because ibuf merge is done to a page when it is read in, and it is
@@ -532,6 +560,9 @@ ibuf_init_at_db_start(void)
 	mutex_create(ibuf_bitmap_mutex_key,
 		     &ibuf_bitmap_mutex, SYNC_IBUF_BITMAP_MUTEX);
 
+	/* This is freed in os_sync_free() */
+	ibuf_merge_event = os_event_create(NULL);
+
 	mtr_start(&mtr);
 
 	mutex_enter(&ibuf_mutex);
@@ -2745,6 +2776,321 @@ ibuf_contract_for_n_pages(
 	return(sum_bytes);
 }
 
+/*********************************************************************//**
+Compares two merge candidates by the volume of their buffered changes.
+@return 1, 0, -1, if a has less, as much, more changes than b */
+UNIV_INLINE
+int
+ibuf_merge_cand_cmp_volume(
+/*=======================*/
+	const ibuf_merge_cand_t	a,	/*!< in: merge candidate */
+	const ibuf_merge_cand_t	b)	/*!< in: merge candidate */
+{
+	if (a.volume == b.volume) {
+		return(0);
+	}
+
+	return(a.volume < b.volume ? 1 : -1);
+}
+
+/*********************************************************************//**
+Sorts merge candidates by descending volume of buffered changes. */
+static
+void
+ibuf_merge_sort_by_volume(
+/*======================*/
+	ibuf_merge_cand_t*	arr,	/*!< in/out: array to sort */
+	ibuf_merge_cand_t*	aux_arr,/*!< in/out: work area */
+	ulint			low,	/*!< in: lower bound of the sorting
+					area, inclusive */
+	ulint			high)	/*!< in: upper bound of the sorting
+					area, exclusive */
+{
+	UT_SORT_FUNCTION_BODY(ibuf_merge_sort_by_volume, arr, aux_arr,
+			      low, high, ibuf_merge_cand_cmp_volume);
+}
+
+/*********************************************************************//**
+Compares two merge candidates by (space id, page number).
+@return 1, 0, -1, if a is greater, equal, less, respectively, than b */
+UNIV_INLINE
+int
+ibuf_merge_cand_cmp_addr(
+/*=====================*/
+	const ibuf_merge_cand_t	a,	/*!< in: merge candidate */
+	const ibuf_merge_cand_t	b)	/*!< in: merge candidate */
+{
+	if (a.space != b.space) {
+		return(a.space > b.space ? 1 : -1);
+	}
+
+	if (a.page_no == b.page_no) {
+		return(0);
+	}
+
+	return(a.page_no > b.page_no ? 1 : -1);
+}
+
+/*********************************************************************//**
+Sorts merge candidates by (space id, page number). */
+static
+void
+ibuf_merge_sort_by_addr(
+/*====================*/
+	ibuf_merge_cand_t*	arr,	/*!< in/out: array to sort */
+	ibuf_merge_cand_t*	aux_arr,/*!< in/out: work area */
+	ulint			low,	/*!< in: lower bound of the sorting
+					area, inclusive */
+	ulint			high)	/*!< in: upper bound of the sorting
+					area, exclusive */
+{
+	UT_SORT_FUNCTION_BODY(ibuf_merge_sort_by_addr, arr, aux_arr,
+			      low, high, ibuf_merge_cand_cmp_addr);
+}
+
+/*********************************************************************//**
+Scans up to IBUF_MERGE_SCAN_LEAVES leaf pages of the insert buffer tree,
+starting from a random position, and issues asynchronous reads for the
+pages found there that have the most buffered changes, in ascending
+order of their addresses. The changes are merged to the pages when the
+reads complete.
+@return a lower limit for the combined size in bytes of entries which
+will be merged from ibuf trees to the pages read, 0 if no buffered
+changes were found */
+static
+ulint
+ibuf_merge_pages_by_volume(
+/*=======================*/
+	ulint	n_max,	/*!< in: maximum number of pages to read,
+			at most IBUF_MERGE_BATCH_MAX */
+	ulint*	n_pages)/*!< out: number of pages read */
+{
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+	ibuf_merge_cand_t	cands[IBUF_MERGE_N_CANDIDATES];
+	ibuf_merge_cand_t	aux[IBUF_MERGE_N_CANDIDATES];
+	ulint			space_ids[IBUF_MERGE_BATCH_MAX];
+	ib_int64_t		space_versions[IBUF_MERGE_BATCH_MAX];
+	ulint			page_nos[IBUF_MERGE_BATCH_MAX];
+	const buf_block_t*	block;
+	ulint			n_cands		= 0;
+	ulint			n_leaves	= 1;
+	ulint			sum_volumes	= 0;
+	ulint			i;
+
+	ut_ad(n_max > 0);
+	ut_ad(n_max <= IBUF_MERGE_BATCH_MAX);
+
+	*n_pages = 0;
+
+	/* A dirty read of ibuf->empty is good enough here: the master
+	thread completes the merge in a slow shutdown. */
+	if (ibuf->empty) {
+		return(0);
+	}
+
+#if defined UNIV_DEBUG || defined UNIV_IBUF_DEBUG
+	if (ibuf_debug) {
+		return(0);
+	}
+#endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
+
+	ibuf_mtr_start(&mtr);
+
+	btr_pcur_open_at_rnd_pos(ibuf->index, BTR_SEARCH_LEAF, &pcur, &mtr);
+
+	block = btr_pcur_get_block(&pcur);
+
+	if (!btr_pcur_is_on_user_rec(&pcur)
+	    && !btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+
+		goto scanned;
+	}
+
+	do {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+		ulint		space;
+		ulint		page_no;
+
+		if (btr_pcur_get_block(&pcur) != block) {
+			block = btr_pcur_get_block(&pcur);
+
+			if (++n_leaves > IBUF_MERGE_SCAN_LEAVES) {
+				break;
+			}
+		}
+
+		space = ibuf_rec_get_space(&mtr, rec);
+		page_no = ibuf_rec_get_page_no(&mtr, rec);
+
+		/* The records for a page are adjacent in the tree */
+		if (n_cands == 0
+		    || cands[n_cands - 1].page_no != page_no
+		    || cands[n_cands - 1].space != space) {
+
+			if (n_cands == IBUF_MERGE_N_CANDIDATES) {
+				break;
+			}
+
+			cands[n_cands].space = space;
+			cands[n_cands].page_no = page_no;
+			cands[n_cands].volume = 0;
+			n_cands++;
+		}
+
+		cands[n_cands - 1].volume += ibuf_rec_get_volume(&mtr, rec);
+	} while (btr_pcur_move_to_next_user_rec(&pcur, &mtr));
+
+scanned:
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	if (n_cands == 0) {
+		return(0);
+	}
+
+	if (n_cands > n_max) {
+		/* Merge the changes of the pages that have the most of
+		them: that frees the most insert buffer space per read. */
+		ibuf_merge_sort_by_volume(cands, aux, 0, n_cands);
+		n_cands = n_max;
+	}
+
+	ibuf_merge_sort_by_addr(cands, aux, 0, n_cands);
+
+	for (i = 0; i < n_cands; i++) {
+		space_ids[i] = cands[i].space;
+		space_versions[i] = fil_space_get_version(cands[i].space);
+		page_nos[i] = cands[i].page_no;
+		sum_volumes += cands[i].volume;
+	}
+
+	buf_read_ibuf_merge_pages(FALSE, space_ids, space_versions, page_nos,
+				  n_cands);
+
+	*n_pages = n_cands;
+
+	return(sum_volumes + 1);
+}
+
+/*********************************************************************//**
+Computes the number of pages that the ibuf merge thread should read in
+the next second. That is 5% of innodb_io_capacity when the insert buffer
+is empty, growing linearly with its size up to all of innodb_io_capacity
+when it reaches ibuf->max_size. If the server has done little other I/O
+during the last second, all of innodb_io_capacity is used.
+@return number of pages */
+static
+ulint
+ibuf_merge_get_n_pages(
+/*===================*/
+	ulint*	n_ios_old)	/*!< in/out: number of I/Os done by the
+				server at the previous call */
+{
+	buf_pool_stat_t	buf_stat;
+	ulint		n_pend_ios;
+	ulint		n_ios;
+	ulint		pct;
+
+	buf_get_total_stat(&buf_stat);
+	n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
+	n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
+		+ buf_stat.n_pages_written;
+
+	if (n_pend_ios < SRV_PEND_IO_THRESHOLD
+	    && n_ios - *n_ios_old < SRV_RECENT_IO_ACTIVITY) {
+
+		pct = 100;
+	} else {
+		/* Dirty reads of the sizes are good enough here */
+		pct = 5 + 95 * ut_min(ibuf->size, ibuf->max_size)
+			/ ut_max(ibuf->max_size, 1);
+	}
+
+	/* Do not count our own reads as other I/O activity. They are
+	accounted for at the next call. */
+	*n_ios_old = n_ios;
+
+	return(ut_max(PCT_IO(pct), 1));
+}
+
+/******************************************************************//**
+The ibuf merge thread. Once per second, and whenever it is woken up
+through ibuf_merge_event, it merges the changes buffered for a number of
+pages that grows with the size of the insert buffer and with
+innodb_io_capacity, preferring the pages with the most buffered changes.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+ibuf_merge_thread(
+/*==============*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+	ulint		n_ios_old	= 0;
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: ibuf merge thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(ibuf_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	ibuf_merge_thread_active = TRUE;
+
+	ibuf_merge_get_n_pages(&n_ios_old);
+
+	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		ulint		next_loop_time	= ut_time_ms() + 1000;
+		ulint		n_pages;
+		ulint		n_done		= 0;
+		ulint		cur_time;
+		ib_int64_t	sig_count;
+
+		/* Reset the event before looking for work, so that a
+		wakeup that arrives while we are merging is not lost. */
+		sig_count = os_event_reset(ibuf_merge_event);
+
+		n_pages = ibuf_merge_get_n_pages(&n_ios_old);
+
+		while (n_done < n_pages
+		       && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+			ulint	n_batch;
+
+			if (!ibuf_merge_pages_by_volume(
+				    ut_min(n_pages - n_done,
+					   IBUF_MERGE_BATCH_MAX),
+				    &n_batch)) {
+				break;
+			}
+
+			n_done += n_batch;
+		}
+
+		ibuf->n_merge_thread_reads += n_done;
+
+		cur_time = ut_time_ms();
+
+		if (cur_time < next_loop_time) {
+			os_event_wait_time_low(
+				ibuf_merge_event,
+				(next_loop_time - cur_time) * 1000,
+				sig_count);
+		}
+	}
+
+	ibuf_merge_thread_active = FALSE;
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*********************************************************************//**
 Contract insert buffer trees after insert if they are too big. */
 UNIV_INLINE
@@ -2775,6 +3121,17 @@ ibuf_contract_after_insert(
 
 	sync = (size >= max_size + IBUF_CONTRACT_ON_INSERT_SYNC);
 
+	if (ibuf_merge_thread_active) {
+		/* The ibuf merge thread merges at full innodb_io_capacity
+		now. Only contract in this thread when the insert buffer
+		keeps growing in spite of it. */
+		os_event_set(ibuf_merge_event);
+
+		if (!sync) {
+			return;
+		}
+	}
+
 	/* Contract at least entry_size many bytes */
 	sum_sizes = 0;
 	size = 1;
@@ -4956,6 +5313,85 @@ ibuf_is_empty(void)
 	return(is_empty);
 }
 
+/******************************************************************//**
+Counts the changes buffered for the pages of each tablespace.
+@return	array of *n_spaces elements ordered by space id, allocated
+from heap */
+UNIV_INTERN
+ibuf_pending_t*
+ibuf_get_pending(
+/*=============*/
+	mem_heap_t*	heap,		/*!< in: memory heap for the array */
+	ulint*		n_spaces)	/*!< out: number of tablespaces */
+{
+	ibuf_pending_t*	pending;
+	ulint		n_alloc		= 16;
+	ulint		prev_page_no	= ULINT_UNDEFINED;
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+
+	*n_spaces = 0;
+	pending = mem_heap_alloc(heap, n_alloc * sizeof *pending);
+
+	ibuf_mtr_start(&mtr);
+
+	btr_pcur_open_at_index_side(
+		TRUE, ibuf->index, BTR_SEARCH_LEAF, &pcur, TRUE, &mtr);
+
+	while (btr_pcur_move_to_next_user_rec(&pcur, &mtr)) {
+		const rec_t*	rec = btr_pcur_get_rec(&pcur);
+		ulint		space = ibuf_rec_get_space(&mtr, rec);
+		ulint		page_no = ibuf_rec_get_page_no(&mtr, rec);
+		ibuf_pending_t*	p;
+
+		if (*n_spaces == 0 || pending[*n_spaces - 1].space != space) {
+
+			if (*n_spaces == n_alloc) {
+				ibuf_pending_t*	old = pending;
+
+				n_alloc *= 2;
+				pending = mem_heap_alloc(
+					heap, n_alloc * sizeof *pending);
+				memcpy(pending, old,
+				       *n_spaces * sizeof *pending);
+			}
+
+			p = &pending[(*n_spaces)++];
+			memset(p, 0, sizeof *p);
+			p->space = space;
+			prev_page_no = ULINT_UNDEFINED;
+		} else {
+			p = &pending[*n_spaces - 1];
+		}
+
+		if (page_no != prev_page_no) {
+			p->n_pages++;
+			prev_page_no = page_no;
+		}
+
+		p->n_recs++;
+		p->volume += ibuf_rec_get_volume(&mtr, rec);
+
+		if (btr_pcur_is_on_user_rec(&pcur)
+		    && page_rec_get_next_const(rec)
+		    == page_get_supremum_rec(btr_pcur_get_page(&pcur))) {
+			/* Do not keep the mini-transaction open for the
+			whole scan: restart it at each page boundary. */
+			btr_pcur_store_position(&pcur, &mtr);
+			ibuf_mtr_commit(&mtr);
+
+			ibuf_mtr_start(&mtr);
+			btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur,
+						  &mtr);
+		}
+	}
+
+	ibuf_mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+
+	return(pending);
+}
+
 /******************************************************************//**
 Prints info of ibuf. */
 UNIV_INTERN
@@ -4979,6 +5415,9 @@ ibuf_print(
 		(ulong) ibuf->seg_size,
 		(ulong) ibuf->n_merges);
 
+	fprintf(file, "%lu pages read by the merge thread\n",
+		(ulong) ibuf->n_merge_thread_reads);
+
 	fputs("merged operations:\n ", file);
 	ibuf_print_ops(ibuf->n_merged_ops, file);
 
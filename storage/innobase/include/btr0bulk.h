@@ -0,0 +1,86 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up bulk load of an empty B-tree from sorted index entries
+
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+#include "data0data.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/** State of a B-tree bulk load */
+typedef struct btr_bulk_struct	btr_bulk_t;
+
+/*********************************************************************//**
+Checks if an index can be built with btr_bulk_insert().
+@return	TRUE if the index can be bulk loaded */
+UNIV_INTERN
+ibool
+btr_bulk_is_supported(
+/*==================*/
+	const dict_index_t*	index);	/*!< in: index */
+
+/*********************************************************************//**
+Starts a bulk load of an empty index. The index must not be accessed by
+other threads until btr_bulk_finish() has been called.
+@return	bulk load state, to be freed by btr_bulk_finish() */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,		/*!< in: empty index,
+					btr_bulk_is_supported() */
+	trx_id_t	trx_id,		/*!< in: PAGE_MAX_TRX_ID of the
+					leaf pages */
+	ulint		fill_factor);	/*!< in: percentage of each page that
+					is filled, 10..100 */
+
+/*********************************************************************//**
+Appends an index entry to the B-tree. The entries must be passed in
+ascending order. Leaf pages are filled up to the fill factor; when a page
+is full, a node pointer to it is appended to the level above.
+@return	DB_SUCCESS or DB_OUT_OF_FILE_SPACE */
+UNIV_INTERN
+ulint
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: bulk load */
+	const dtuple_t*	tuple);	/*!< in: index entry, without
+				externally stored columns */
+
+/*********************************************************************//**
+Completes a bulk load: appends the node pointers to the last page of each
+level and copies the top page of the tree to the root page. The pages of
+a failed load are left to be freed when the index is dropped.
+@return	err, or an error that occurred while completing the load */
+UNIV_INTERN
+ulint
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: bulk load */
+	ulint		err);	/*!< in: DB_SUCCESS, or the error that
+				made the caller stop inserting */
+
+#endif /* btr0bulk_h */
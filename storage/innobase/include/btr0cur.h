@@ -154,7 +154,7 @@ btr_cur_search_to_nth_level(
 	btr_cur_t*	cursor, /*!< in/out: tree cursor; the cursor page is
 				s- or x-latched, but see also above! */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-				currently has on btr_search_latch:
+				currently has on btr_search_get_latch():
 				RW_S_LATCH, or 0 */
 	const char*	file,	/*!< in: file name */
 	ulint		line,	/*!< in: line where called */
@@ -189,6 +189,21 @@ btr_cur_open_at_rnd_pos_func(
 	mtr_t*		mtr);		/*!< in: mtr */
 #define btr_cur_open_at_rnd_pos(i,l,c,m)				\
 	btr_cur_open_at_rnd_pos_func(i,l,c,__FILE__,__LINE__,m)
+/**********************************************************************//**
+Issues asynchronous read requests for the leaf pages that follow the
+leaf page on which tuple would be positioned, in key order, by following
+the node pointers on the level above the leaves. The caller must not
+hold latches on the index tree.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+btr_cur_read_ahead_leaves(
+/*======================*/
+	dict_index_t*	index,	/*!< in: index */
+	const dtuple_t*	tuple,	/*!< in: search tuple of the current
+				position of the scan */
+	ulint		n_pages);/*!< in: number of leaf pages to read
+				ahead; at most BTR_CUR_READ_AHEAD_MAX */
 /*************************************************************//**
 Tries to perform an insert to a page in an index tree, next to cursor.
 It is assumed that mtr holds an x-latch on the page. The operation does
@@ -774,6 +789,10 @@ is still a good change of success a little later.  Sleep this many
 microseconds between retries. */
 #define BTR_CUR_RETRY_SLEEP_TIME	50000
 
+/** Maximum number of leaf pages that btr_cur_read_ahead_leaves() reads
+ahead in one call; the maximum value of innodb_read_ahead_logical_pages */
+#define BTR_CUR_READ_AHEAD_MAX		64
+
 /** The reference in a field for which data is stored on a different page.
 The reference is at the end of the 'locally' stored part of the field.
 'Locally' means storage in the index record.
@@ -40,7 +40,8 @@ UNIV_INTERN
 void
 btr_search_sys_create(
 /*==================*/
-	ulint	hash_size);	/*!< in: hash index hash table size */
+	ulint	hash_size,	/*!< in: hash index hash table size */
+	ulint	n_parts);	/*!< in: number of partitions */
 /*****************************************************************//**
 Frees the adaptive search system at a database shutdown. */
 UNIV_INTERN
@@ -60,6 +61,42 @@ UNIV_INTERN
 void
 btr_search_enable(void);
 /*====================*/
+/********************************************************************//**
+X-latches the latches of all adaptive hash index partitions. */
+UNIV_INTERN
+void
+btr_search_x_lock_all(void);
+/*========================*/
+/********************************************************************//**
+Releases the latches of all adaptive hash index partitions. */
+UNIV_INTERN
+void
+btr_search_x_unlock_all(void);
+/*==========================*/
+/********************************************************************//**
+Returns the number of the adaptive hash index partition of an index.
+@return	partition number, less than btr_search_n_parts */
+UNIV_INLINE
+ulint
+btr_search_get_part(
+/*================*/
+	const dict_index_t*	index);	/*!< in: index */
+/********************************************************************//**
+Returns the latch protecting the adaptive hash index partition of an index.
+@return	latch of the partition */
+UNIV_INLINE
+rw_lock_t*
+btr_search_get_latch(
+/*=================*/
+	const dict_index_t*	index);	/*!< in: index */
+/********************************************************************//**
+Returns the hash table of the adaptive hash index partition of an index.
+@return	hash table of the partition */
+UNIV_INLINE
+hash_table_t*
+btr_search_get_hash_index(
+/*======================*/
+	const dict_index_t*	index);	/*!< in: index */
 
 /********************************************************************//**
 Returns search info for an index.
@@ -79,13 +116,14 @@ btr_search_info_create(
 	mem_heap_t*	heap);	/*!< in: heap where created */
 /*****************************************************************//**
 Returns the value of ref_count. The value is protected by
-btr_search_latch.
+the adaptive hash index latch of the index.
 @return	ref_count value. */
 UNIV_INTERN
 ulint
 btr_search_info_get_ref_count(
 /*==========================*/
-	btr_search_t*   info);	/*!< in: search info. */
+	btr_search_t*   info,	/*!< in: search info. */
+	dict_index_t*	index);	/*!< in: index */
 /*********************************************************************//**
 Updates the search info. */
 UNIV_INLINE
@@ -111,7 +149,8 @@ btr_search_guess_on_hash(
 	ulint		latch_mode,	/*!< in: BTR_SEARCH_LEAF, ... */
 	btr_cur_t*	cursor,		/*!< out: tree cursor */
 	ulint		has_search_latch,/*!< in: latch mode the caller
-					currently has on btr_search_latch:
+					currently has on the adaptive
+					hash index latch of index:
 					RW_S_LATCH, RW_X_LATCH, or 0 */
 	mtr_t*		mtr);		/*!< in: mtr */
 /********************************************************************//**
@@ -195,7 +234,8 @@ struct btr_search_struct{
 	ulint	ref_count;	/*!< Number of blocks in this index tree
 				that have search index built
 				i.e. block->index points to this index.
-				Protected by btr_search_latch except
+				Protected by btr_search_get_latch()
+				of the index except
 				when during initialization in
 				btr_search_info_create(). */
 
@@ -250,9 +290,11 @@ typedef struct btr_search_sys_struct	btr_search_sys_t;
 
 /** The hash index system */
 struct btr_search_sys_struct{
-	hash_table_t*	hash_index;	/*!< the adaptive hash index,
-					mapping dtuple_fold values
-					to rec_t pointers on index pages */
+	hash_table_t**	hash_index;	/*!< the adaptive hash index
+					partitions, mapping dtuple_fold
+					values to rec_t pointers on index
+					pages; an array of
+					btr_search_n_parts hash tables */
 };
 
 /** The adaptive hash index */
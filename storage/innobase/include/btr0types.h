@@ -41,11 +41,14 @@ typedef struct btr_search_struct	btr_search_t;
 
 #ifndef UNIV_HOTBACKUP
 
-/** @brief The latch protecting the adaptive search system
+/** @brief The latches protecting the adaptive search system
 
-This latch protects the
-(1) hash index;
-(2) columns of a record to which we have a pointer in the hash index;
+The adaptive hash index is split into btr_search_n_parts partitions.
+Each partition has a hash table of its own and a latch, and an index is
+mapped to a partition by its index id: see btr_search_get_latch().
+The latch of a partition protects the
+(1) hash table of the partition;
+(2) columns of a record to which we have a pointer in that hash table;
 
 but does NOT protect:
 
@@ -54,15 +57,46 @@ but does NOT protect:
 
 Bear in mind (3) and (4) when using the hash index.
 */
-extern rw_lock_t*	btr_search_latch_temp;
+extern rw_lock_t*	btr_search_latch_arr;
 
-#endif /* UNIV_HOTBACKUP */
+/** Number of partitions of the adaptive hash index */
+extern ulint		btr_search_n_parts;
+
+# ifdef UNIV_SYNC_DEBUG
+struct hash_table_struct;
+
+/********************************************************************//**
+Returns the latch protecting an adaptive hash index partition.
+@return	latch of the partition whose hash table is table */
+UNIV_INTERN
+rw_lock_t*
+btr_search_get_latch_for_table(
+/*===========================*/
+	const struct hash_table_struct*	table);	/*!< in: hash table of
+						an adaptive hash index
+						partition */
+/********************************************************************//**
+Checks if the current thread holds all adaptive hash index latches
+in the given mode.
+@return	TRUE if all partitions are latched */
+UNIV_INTERN
+ibool
+btr_search_own_all(
+/*===============*/
+	ulint	lock_type);	/*!< in: RW_LOCK_SHARED or RW_LOCK_EX */
+/********************************************************************//**
+Checks if the current thread holds any adaptive hash index latch.
+@return	TRUE if some partition is latched */
+UNIV_INTERN
+ibool
+btr_search_own_any(void);
+/*=====================*/
+# endif /* UNIV_SYNC_DEBUG */
 
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
+#endif /* UNIV_HOTBACKUP */
 
 /** Flag: has the search system been enabled?
-Protected by btr_search_latch. */
+Protected by the latches of all adaptive hash index partitions. */
 extern char	btr_search_enabled;
 
 #ifdef UNIV_BLOB_DEBUG
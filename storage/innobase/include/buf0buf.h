@@ -657,6 +657,24 @@ buf_calc_page_old_checksum(
 /*=======================*/
 	const byte*	 page);	/*!< in: buffer page */
 /********************************************************************//**
+Calculates the CRC32C checksum of a page, over the same fields as
+buf_calc_page_new_checksum(). It is stored to both checksum fields of the
+page when innodb_checksum_algorithm is crc32 or strict_crc32.
+@return	checksum */
+UNIV_INTERN
+ib_uint32_t
+buf_calc_page_crc32(
+/*================*/
+	const byte*	page);	/*!< in: buffer page */
+/********************************************************************//**
+Returns the name of a page checksum algorithm.
+@return	name of the algorithm, as used by innodb_checksum_algorithm */
+UNIV_INTERN
+const char*
+buf_checksum_algorithm_name(
+/*========================*/
+	ulint	algo);	/*!< in: srv_checksum_algorithm_t */
+/********************************************************************//**
 Checks if a page is corrupt.
 @return	TRUE if corrupted */
 UNIV_INTERN
@@ -1528,6 +1546,11 @@ struct buf_page_struct{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	unsigned	read_ahead_logical:1;
+					/*!< TRUE if the page was read in
+					by buf_read_ahead_logical() and
+					has not been accessed since.
+					Protected by block mutex */
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
 					/*!< this is set to TRUE when fsp
@@ -1620,7 +1643,8 @@ struct buf_block_struct{
 
 	/** @name Hash search fields
 	These 5 fields may only be modified when we have
-	an x-latch on btr_search_latch AND
+	an x-latch on the adaptive hash index latch of the index
+	(btr_search_get_latch()) AND
 	- we are holding an s-latch or x-latch on buf_block_struct::lock or
 	- we know that buf_block_struct::buf_fix_count == 0.
 
@@ -1628,7 +1652,8 @@ struct buf_block_struct{
 	in the buffer pool in buf0buf.c.
 
 	Another exception is that assigning block->index = NULL
-	is allowed whenever holding an x-latch on btr_search_latch. */
+	is allowed whenever holding an x-latch on the latches of
+	all adaptive hash index partitions. */
 
 	/* @{ */
 
@@ -1699,6 +1724,13 @@ struct buf_pool_stat_struct{
 	ulint	n_ra_pages_evicted;/*!< number of read ahead
 				pages that are evicted without
 				being accessed */
+	ulint	n_ra_pages_read_logical;/*!< number of pages read in
+				as part of logical read ahead */
+	ulint	n_ra_pages_logical_used;/*!< number of logical read
+				ahead pages that were accessed */
+	ulint	n_ra_pages_logical_evicted;/*!< number of logical read
+				ahead pages that are evicted
+				without being accessed */
 	ulint	n_pages_made_young; /*!< number of pages made young, in
 				calls to buf_LRU_make_block_young() */
 	ulint	n_pages_not_made_young; /*!< number of pages not made
@@ -0,0 +1,85 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/buf0dump.h
+Dumps the page ids of the buffer pool LRU lists to a file, and loads
+them back after a restart, so that the buffer pool is warm sooner.
+
+*******************************************************/
+
+#ifndef buf0dump_h
+#define buf0dump_h
+
+#include "univ.i"
+#include "os0sync.h"
+
+/*****************************************************************//**
+Creates the event that wakes up the buf_dump thread. It is freed in
+os_sync_free(). */
+UNIV_INTERN
+void
+buf_dump_init(void);
+/*===============*/
+
+/*****************************************************************//**
+Wakes up the buf_dump thread to dump the page ids of the buffer pool
+into innodb_buffer_pool_filename. Does not wait for the dump to finish. */
+UNIV_INTERN
+void
+buf_dump_start(void);
+/*================*/
+
+/*****************************************************************//**
+Wakes up the buf_dump thread to load the pages listed in
+innodb_buffer_pool_filename into the buffer pool. Does not wait for the
+load to finish. */
+UNIV_INTERN
+void
+buf_load_start(void);
+/*================*/
+
+/*****************************************************************//**
+Aborts a buffer pool load that is in progress. The pages whose reads
+were already issued stay in the buffer pool. */
+UNIV_INTERN
+void
+buf_load_abort(void);
+/*================*/
+
+/*****************************************************************//**
+The buf_dump thread. It loads the buffer pool at startup if
+innodb_buffer_pool_load_at_startup is set, serves the dump and load
+requests made through buf_dump_start() and buf_load_start(), and dumps
+the buffer pool at shutdown if innodb_buffer_pool_dump_at_shutdown is
+set.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_dump_thread(
+/*============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/** Event that wakes up the buf_dump thread */
+extern os_event_t	buf_dump_event;
+
+/** TRUE while the buf_dump thread is running */
+extern ibool		buf_dump_thread_active;
+
+#endif /* buf0dump_h */
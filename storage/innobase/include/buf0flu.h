@@ -32,6 +32,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "mtr0types.h"
 #include "buf0types.h"
 #include "log0log.h"
+#include "os0thread.h"
 
 /********************************************************************//**
 Remove a block from the flush list of modified blocks. */
@@ -57,21 +58,58 @@ void
 buf_flush_write_complete(
 /*=====================*/
 	buf_page_t*	bpage);	/*!< in: pointer to the block in question */
+/** Event to wake up the page cleaner thread ahead of its one second
+schedule */
+extern os_event_t	buf_flush_event;
+/** TRUE while the page cleaner thread is running */
+extern ibool		buf_page_cleaner_is_active;
+
 /*********************************************************************//**
-Flushes pages from the end of the LRU list if there is too small
-a margin of replaceable pages there. If buffer pool is NULL it
-means flush free margin on all buffer pool instances. */
+Makes sure that there is a big enough margin of replaceable pages at the
+end of the LRU list of buf_pool. If the page cleaner thread is running,
+it is only woken up; otherwise the pages are flushed by the calling
+thread. */
 UNIV_INTERN
 void
 buf_flush_free_margin(
 /*==================*/
 	 buf_pool_t*	buf_pool);
 /*********************************************************************//**
-Flushes pages from the end of all the LRU lists. */
+Makes sure that there is a big enough margin of replaceable pages at the
+end of all the LRU lists. */
 UNIV_INTERN
 void
 buf_flush_free_margins(void);
 /*=========================*/
+/*********************************************************************//**
+Called by a thread that found no free block in buf_pool. Wakes up the
+page cleaner thread and waits for it to flush the LRU list tails. If the
+page cleaner is not running, or it does not get to the LRU lists in
+time, the LRU list of buf_pool is flushed by the calling thread. */
+UNIV_INTERN
+void
+buf_flush_wait_free_margin(
+/*=======================*/
+	buf_pool_t*	buf_pool);	/*!< in: buffer pool instance */
+/********************************************************************//**
+Creates the events used to talk to the page cleaner thread. They are
+freed in os_sync_free(). */
+UNIV_INTERN
+void
+buf_flush_page_cleaner_init(void);
+/*=============================*/
+/******************************************************************//**
+The page cleaner thread. Once per second, and whenever it is woken up
+through buf_flush_event, it flushes the tails of the LRU lists and a batch
+of the flush lists, sized after the redo generation rate and the
+checkpoint age, of all buffer pool instances.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+buf_flush_page_cleaner_thread(
+/*==========================*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
 #endif /* !UNIV_HOTBACKUP */
 /********************************************************************//**
 Initializes a page for writing to the tablespace. */
@@ -100,6 +100,22 @@ buf_read_ahead_linear(
 	ulint	offset,		/*!< in: page number; see NOTE 3 above */
 	ibool	inside_ibuf);	/*!< in: TRUE if we are inside ibuf routine */
 /********************************************************************//**
+Issues asynchronous read requests for index pages that an ascending
+index scan is going to visit next, in the order the scan visits them.
+Pages that are already in the buffer pool are skipped.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_ahead_logical(
+/*===================*/
+	ulint		space,		/*!< in: space id */
+	ulint		zip_size,	/*!< in: compressed page size in
+					bytes, or 0 */
+	const ulint*	page_nos,	/*!< in: array of page numbers,
+					in scan order */
+	ulint		n_stored);	/*!< in: number of page numbers
+					in the array */
+/********************************************************************//**
 Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
 a read-ahead function. */
@@ -127,6 +143,22 @@ buf_read_ibuf_merge_pages(
 	ulint		n_stored);	/*!< in: number of elements
 					in the arrays */
 /********************************************************************//**
+Issues asynchronous read requests for the pages of a buffer pool dump.
+Pages that are already in the buffer pool, pages of tablespaces that no
+longer exist or have shrunk, and pages of buffer pool instances that
+have no free blocks left are skipped.
+@return	number of page read requests issued */
+UNIV_INTERN
+ulint
+buf_read_load_pages(
+/*================*/
+	const ulint*	space_ids,	/*!< in: array of space ids */
+	const ulint*	page_nos,	/*!< in: array of page numbers,
+					sorted by (space id, page number)
+					together with space_ids */
+	ulint		n_stored);	/*!< in: number of elements
+					in the arrays */
+/********************************************************************//**
 Issues read requests for pages which recovery wants to read in. */
 UNIV_INTERN
 void
@@ -106,6 +106,15 @@ UNIV_INTERN
 ulint
 dict_create_or_check_foreign_constraint_tables(void);
 /*================================================*/
+/****************************************************************//**
+Creates the SYS_STATS system table, which holds the persistent index
+statistics, at database creation or database start if it is not found
+or is not of the right form.
+@return	DB_SUCCESS or error code */
+UNIV_INTERN
+ulint
+dict_create_or_check_stats_table(void);
+/*==================================*/
 /********************************************************************//**
 Adds foreign key definitions to data dictionary tables in the database. We
 look at table->foreign_list, and also generate names to constraints that were
@@ -1230,6 +1230,13 @@ extern dict_sys_t*	dict_sys;
 /** the data dictionary rw-latch protecting dict_sys */
 extern rw_lock_t	dict_operation_lock;
 
+/** Percentage of compression failures that are allowed in a single
+round before padding is added to compressed leaf pages */
+extern ulong	zip_failure_threshold_pct;
+/** Maximum percentage of a compressed page that may be reserved as
+padding */
+extern ulong	zip_pad_max;
+
 /* Dictionary system struct */
 struct dict_sys_struct{
 	mutex_t		mutex;		/*!< mutex protecting the data
@@ -1332,6 +1339,33 @@ dict_set_corrupted_by_space(
 /*========================*/
 	ulint		space_id);	/*!< in: space ID */
 
+/*********************************************************************//**
+Accounts a successful compression of a leaf page of an index. */
+UNIV_INTERN
+void
+dict_index_zip_success(
+/*===================*/
+	dict_index_t*	index)	/*!< in/out: index */
+	__attribute__((nonnull));
+/*********************************************************************//**
+Accounts a failed compression of a leaf page of an index. */
+UNIV_INTERN
+void
+dict_index_zip_failure(
+/*===================*/
+	dict_index_t*	index)	/*!< in/out: index */
+	__attribute__((nonnull));
+/*********************************************************************//**
+Computes how many bytes of records an uncompressed leaf page of a
+compressed index should be filled with, leaving room for the padding.
+@return	optimal data size of a leaf page, in bytes */
+UNIV_INTERN
+ulint
+dict_index_zip_pad_optimal_page_size(
+/*=================================*/
+	dict_index_t*	index)	/*!< in: index */
+	__attribute__((nonnull, warn_unused_result));
+
 /**********************************************************************//**
 Compares the given foreign key identifier (the key in rb-tree) and the
 foreign key identifier in the given fk object (value in rb-tree).
@@ -362,6 +362,27 @@ struct dict_field_struct{
 					DICT_ANTELOPE_MAX_INDEX_COL_LEN */
 };
 
+#ifndef UNIV_HOTBACKUP
+/** Compression failure statistics of a compressed index, used for
+deciding how much free space to leave on its leaf pages so that
+changes to them do not keep failing to compress. */
+struct zip_pad_info_struct {
+	os_fast_mutex_t	mutex;	/*!< mutex protecting the fields below */
+	ulint		pad;	/*!< number of bytes to leave empty on
+				leaf pages */
+	ulint		success;/*!< successful compressions in the
+				current round */
+	ulint		failure;/*!< failed compressions in the
+				current round */
+	ulint		n_rounds;/*!< number of consecutive rounds in
+				which the failure rate stayed below
+				zip_failure_threshold_pct */
+};
+
+/** Compression failure statistics of a compressed index */
+typedef struct zip_pad_info_struct	zip_pad_info_t;
+#endif /* !UNIV_HOTBACKUP */
+
 /** Data structure for an index.  Most fields will be
 initialized to 0, NULL or FALSE in dict_mem_index_create(). */
 struct dict_index_struct{
@@ -435,6 +456,9 @@ struct dict_index_struct{
 	/* @} */
 	rw_lock_t	lock;	/*!< read-write lock protecting the
 				upper levels of the index tree */
+	zip_pad_info_t	zip_pad;/*!< compression failure statistics,
+				used only on compressed indexes that
+				are in the dictionary cache */
 	trx_id_t	trx_id; /*!< id of the transaction that created this
 				index, or 0 if the index existed
 				when InnoDB was started up */
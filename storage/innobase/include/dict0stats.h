@@ -0,0 +1,103 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/dict0stats.h
+Persistent index statistics, kept in the SYS_STATS system table
+
+*******************************************************/
+
+#ifndef dict0stats_h
+#define dict0stats_h
+
+#include "univ.i"
+#include "dict0types.h"
+#include "os0sync.h"
+#include "os0thread.h"
+#include "trx0types.h"
+
+/*********************************************************************//**
+Creates the mutex and the event of the dict_stats thread. */
+UNIV_INTERN
+void
+dict_stats_init(void);
+/*==================*/
+
+/*********************************************************************//**
+Frees the mutex of the dict_stats thread. */
+UNIV_INTERN
+void
+dict_stats_close(void);
+/*===================*/
+
+/*********************************************************************//**
+Updates the statistics of a table when innodb_stats_persistent is set.
+The statistics are loaded from SYS_STATS when the table is opened, and
+only calculated and saved if SYS_STATS does not have them for every
+index. The caller must not hold dict_sys->mutex. */
+UNIV_INTERN
+void
+dict_stats_update(
+/*==============*/
+	dict_table_t*	table,	/*!< in/out: table */
+	ibool		recalc);/*!< in: TRUE=calculate the statistics
+				and save them, as ANALYZE TABLE does;
+				FALSE=only load them if they have not
+				been initialized yet */
+
+/*********************************************************************//**
+Deletes the statistics of an index from SYS_STATS. Index ids are never
+reused, so this only keeps SYS_STATS from growing, and a failure is
+reported but not returned. The caller must hold dict_sys->mutex. */
+UNIV_INTERN
+void
+dict_stats_delete_index_stats(
+/*==========================*/
+	const dict_index_t*	index,	/*!< in: index being dropped */
+	trx_t*			trx);	/*!< in/out: dictionary
+					transaction */
+
+/*********************************************************************//**
+Asks the dict_stats thread to recalculate and save the statistics of a
+table, because it has been changed too much since the last calculation.
+If the queue is full, the request is dropped and made again when the
+table has been changed too much once more. */
+UNIV_INTERN
+void
+dict_stats_enqueue(
+/*===============*/
+	dict_table_t*	table);	/*!< in/out: table */
+
+/*********************************************************************//**
+The dict_stats thread. It recalculates and saves the statistics of the
+tables queued by dict_stats_enqueue().
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+dict_stats_thread(
+/*==============*/
+	void*	arg);	/*!< in: a dummy parameter required by
+			os_thread_create */
+
+/** Event that wakes up the dict_stats thread */
+extern os_event_t	dict_stats_event;
+
+/** TRUE while the dict_stats thread is running */
+extern ibool		dict_stats_thread_active;
+
+#endif /* dict0stats_h */
@@ -34,6 +34,8 @@ Created 7/19/1997 Heikki Tuuri
 
 #ifndef UNIV_HOTBACKUP
 # include "ibuf0types.h"
+# include "os0sync.h"
+# include "os0thread.h"
 
 /* Possible operations buffered in the insert/whatever buffer. See
 ibuf_insert(). DO NOT CHANGE THE VALUES OF THESE, THEY ARE STORED ON DISK. */
@@ -66,6 +68,24 @@ extern ibuf_use_t	ibuf_use;
 /** The insert buffer control structure */
 extern ibuf_t*		ibuf;
 
+/** Event that wakes up the ibuf merge thread ahead of its one second
+schedule */
+extern os_event_t	ibuf_merge_event;
+/** TRUE while the ibuf merge thread is running */
+extern ibool		ibuf_merge_thread_active;
+
+/** Changes buffered for the pages of a tablespace, see ibuf_get_pending() */
+typedef struct ibuf_pending_struct	ibuf_pending_t;
+
+/** Changes buffered for the pages of a tablespace */
+struct ibuf_pending_struct {
+	ulint	space;		/*!< tablespace id */
+	ulint	n_pages;	/*!< number of pages with buffered changes */
+	ulint	n_recs;		/*!< number of buffered changes */
+	ulint	volume;		/*!< combined size of the buffered changes
+				when applied to the pages, in bytes */
+};
+
 /* The purpose of the insert buffer is to reduce random disk access.
 When we wish to insert a record into a non-unique secondary index and
 the B-tree leaf page where the record belongs to is not in the buffer
@@ -379,6 +399,28 @@ ibuf_contract_for_n_pages(
 	ulint	n_pages);/*!< in: try to read at least this many pages to
 			the buffer pool and merge the ibuf contents to
 			them */
+/******************************************************************//**
+The ibuf merge thread. Once per second, and whenever it is woken up
+through ibuf_merge_event, it merges the changes buffered for a number of
+pages that grows with the size of the insert buffer and with
+innodb_io_capacity, preferring the pages with the most buffered changes.
+@return a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+ibuf_merge_thread(
+/*==============*/
+	void*	arg);		/*!< in: a dummy parameter required by
+				os_thread_create */
+/******************************************************************//**
+Counts the changes buffered for the pages of each tablespace.
+@return	array of *n_spaces elements ordered by space id, allocated
+from heap */
+UNIV_INTERN
+ibuf_pending_t*
+ibuf_get_pending(
+/*=============*/
+	mem_heap_t*	heap,		/*!< in: memory heap for the array */
+	ulint*		n_spaces);	/*!< out: number of tablespaces */
 #endif /* !UNIV_HOTBACKUP */
 /*********************************************************************//**
 Parses a redo log record of an ibuf bitmap page init.
@@ -36,6 +36,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "lock0types.h"
 #include "read0types.h"
 #include "hash0hash.h"
+#include "sync0rw.h"
 #include "ut0vec.h"
 
 #ifdef UNIV_DEBUG
@@ -598,7 +599,8 @@ lock_check_trx_id_sanity(
 	dict_index_t*	index,		/*!< in: clustered index */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec, index) */
 	ibool		has_kernel_mutex);/*!< in: TRUE if the caller owns the
-					kernel mutex */
+					kernel mutex; otherwise
+					trx_sys->mutex is reserved here */
 /*********************************************************************//**
 Prints info of a table lock. */
 UNIV_INTERN
@@ -821,14 +823,55 @@ struct lock_op_struct{
 	enum lock_mode	mode;	/*!< lock mode */
 };
 
+/** Number of mutexes protecting the record lock hash table cells on
+the fast path of lock_rec_lock(); a power of 2 */
+#define LOCK_REC_N_MUTEXES	64
+
 /** The lock system struct */
 struct lock_sys_struct{
+	rw_lock_t	latch;		/*!< X-latched together with the
+					kernel mutex, see
+					lock_mutex_enter_kernel(), for
+					all changes of the lock queues and
+					the lock wait state. A thread that
+					holds it in S mode and the mutex of
+					a record lock hash cell may add a
+					granted record lock of its own
+					transaction on a page in the cell */
+	mutex_t		rec_mutexes[LOCK_REC_N_MUTEXES];
+					/*!< mutexes for the S-latched
+					access to the cells of rec_hash */
 	hash_table_t*	rec_hash;	/*!< hash table of the record locks */
 };
 
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
+/** Reserves the kernel mutex and the lock system latch in exclusive
+mode. Needed for creating, granting, releasing or moving locks, and for
+looking at the lock queues or at the locks of other transactions. */
+#define lock_mutex_enter_kernel()		\
+do {						\
+	mutex_enter(&kernel_mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
+} while (0)
+
+/** Releases the latches reserved by lock_mutex_enter_kernel(). */
+#define lock_mutex_exit_kernel()		\
+do {						\
+	rw_lock_x_unlock(&lock_sys->latch);	\
+	mutex_exit(&kernel_mutex);		\
+} while (0)
+
+#ifdef UNIV_SYNC_DEBUG
+/** Tests if the thread has called lock_mutex_enter_kernel(). */
+# define lock_mutex_own()					\
+	(mutex_own(&kernel_mutex)				\
+	 && rw_lock_own(&lock_sys->latch, RW_LOCK_EX))
+#else /* UNIV_SYNC_DEBUG */
+# define lock_mutex_own()	mutex_own(&kernel_mutex)
+#endif /* UNIV_SYNC_DEBUG */
+
 
 #ifndef UNIV_NONINL
 #include "lock0lock.ic"
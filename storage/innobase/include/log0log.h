@@ -98,7 +98,8 @@ log_calc_where_lsn_is(
 #ifndef UNIV_HOTBACKUP
 /************************************************************//**
 Writes to the log the string given. The log must be released with
-log_release.
+log_release, and the record closed with log_flush_order_wait() and
+log_flush_order_close().
 @return	end lsn of the log record, zero if did not succeed */
 UNIV_INLINE
 ib_uint64_t
@@ -123,8 +124,8 @@ void
 log_free_check(void);
 /*================*/
 /************************************************************//**
-Opens the log for log_write_low. The log must be closed with log_close and
-released with log_release.
+Opens the log for log_reserve_low or log_write_low. The log must be closed
+with log_close and released with log_release.
 @return	start lsn of the log record */
 UNIV_INTERN
 ib_uint64_t
@@ -132,6 +133,31 @@ log_reserve_and_open(
 /*=================*/
 	ulint	len);	/*!< in: length of data to be catenated */
 /************************************************************//**
+Reserves space for a string in the log buffer, and advances the lsn past
+it. The headers of the log blocks that the string spans are written, but
+the string itself is not: that is done by log_write_reserved(), which
+does not need the log mutex. It is assumed that the caller holds the log
+mutex.
+@return	offset of the reserved space in the log buffer */
+UNIV_INTERN
+ulint
+log_reserve_low(
+/*============*/
+	ulint	str_len);	/*!< in: string length */
+/************************************************************//**
+Copies a string to space reserved with log_reserve_low(), skipping the
+log block headers and trailers. The caller need not hold the log mutex:
+the log buffer is not written or moved before log_flush_order_close() has
+been called for the reservation.
+@return	offset in the log buffer after the string */
+UNIV_INTERN
+ulint
+log_write_reserved(
+/*===============*/
+	ulint		offset,	/*!< in: offset in the log buffer */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len);/*!< in: string length */
+/************************************************************//**
 Writes to the log the string given. It is assumed that the caller holds the
 log mutex. */
 UNIV_INTERN
@@ -141,6 +167,28 @@ log_write_low(
 	byte*	str,		/*!< in: string */
 	ulint	str_len);	/*!< in: string length */
 /************************************************************//**
+Waits until the log records of all the mini-transactions that reserved
+log before start_lsn have been copied to the log buffer, and their pages
+have been added to the flush lists, and acquires log_flush_order_mutex.
+This keeps the flush lists ordered by oldest_modification, although the
+log records are copied concurrently. */
+UNIV_INTERN
+void
+log_flush_order_wait(
+/*=================*/
+	ib_uint64_t	start_lsn);	/*!< in: start lsn of the log
+					records of the mini-transaction */
+/************************************************************//**
+Marks the log records up to end_lsn as copied to the log buffer, after
+the pages that they modified have been added to the flush lists, and
+releases log_flush_order_mutex. */
+UNIV_INTERN
+void
+log_flush_order_close(
+/*==================*/
+	ib_uint64_t	end_lsn);	/*!< in: end lsn of the log
+					records of the mini-transaction */
+/************************************************************//**
 Closes the log.
 @return	lsn */
 UNIV_INTERN
@@ -240,6 +288,19 @@ log_preflush_pool_modified_pages(
 					to this lsn */
 	ibool		sync);		/*!< in: TRUE if synchronous
 					operation is desired */
+/****************************************************************//**
+Returns the age of the oldest modification in the buffer pool, that is, how
+far log_checkpoint_margin() is from having to preflush pages.
+@return	log_sys->lsn minus the oldest modification lsn in the buffer pool */
+UNIV_INTERN
+ib_uint64_t
+log_get_modified_age(
+/*=================*/
+	ib_uint64_t*	oldest_lsn,	/*!< out: oldest modification lsn in
+					the buffer pool, or log_sys->lsn if
+					there are no dirty pages */
+	ib_uint64_t*	age_async);	/*!< out: age above which user threads
+					do an asynchronous preflush */
 /******************************************************//**
 Makes a checkpoint. Note that this function does not flush dirty
 blocks from the buffer pool: it only checks what is lsn of the oldest
@@ -763,6 +824,15 @@ struct log_struct{
 	ib_uint64_t	lsn;		/*!< log sequence number */
 	ulint		buf_free;	/*!< first free offset within the log
 					buffer */
+	ib_uint64_t	closed_lsn;	/*!< the log records up to this lsn
+					have been copied to the log buffer,
+					and the pages that they modified
+					added to the flush lists; the
+					mini-transactions copy their log
+					records after releasing
+					log_sys->mutex, and close in the
+					lsn order; protected by
+					log_flush_order_mutex */
 #ifndef UNIV_HOTBACKUP
 	mutex_t		mutex;		/*!< mutex protecting the log */
 
@@ -774,6 +844,12 @@ struct log_struct{
 					mtr_commit and still ensure that
 					insertions in the flush_list happen
 					in the LSN order. */
+	os_event_t	closed_event;	/*!< set when closed_lsn advances
+					while n_closed_waiters > 0 */
+	ulint		n_closed_waiters;/*!< number of threads that wait
+					in log_closed_lsn_wait() for
+					closed_lsn to advance; protected by
+					log_flush_order_mutex */
 #endif /* !UNIV_HOTBACKUP */
 	byte*		buf_ptr;	/* unaligned log buffer */
 	byte*		buf;		/*!< log buffer */
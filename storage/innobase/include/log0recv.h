@@ -438,6 +438,20 @@ struct recv_sys_struct{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+#ifndef UNIV_HOTBACKUP
+	recv_addr_t**	apply_addrs;
+				/*!< during an apply batch, the file
+				addresses of the pages that were in the
+				buffer pool, sorted by (space, page_no) */
+	ulint		n_apply_addrs;
+				/*!< number of elements in apply_addrs */
+	ulint		n_apply_threads;
+				/*!< number of threads applying the log
+				records to the pages in apply_addrs */
+	ulint		n_apply_threads_active;
+				/*!< number of those threads that have
+				not finished yet; protected by mutex */
+#endif /* !UNIV_HOTBACKUP */
 };
 
 /** The recovery system */
@@ -38,6 +38,21 @@ Created June 2005 by Marko Makela
 #include "trx0types.h"
 #include "mem0mem.h"
 
+/** Default zlib compression level, see page_zip_level */
+#define DEFAULT_COMPRESSION_LEVEL	6
+
+/** zlib compression level of compressed pages (innodb_compression_level) */
+extern uint	page_zip_level;
+
+/** Compression statistics of an index, in page_zip_stat_per_index */
+struct page_zip_stat_per_index_struct {
+	index_id_t	index_id;	/*!< id of the index */
+	page_zip_stat_t	stat;		/*!< compression statistics */
+};
+
+/** Compression statistics of an index */
+typedef struct page_zip_stat_per_index_struct page_zip_stat_per_index_t;
+
 /**********************************************************************//**
 Determine the size of a compressed page in bytes.
 @return	size in bytes */
@@ -101,6 +116,47 @@ page_zip_set_alloc(
 	void*		stream,		/*!< in/out: zlib stream */
 	mem_heap_t*	heap);		/*!< in: memory heap to use */
 
+#ifndef UNIV_HOTBACKUP
+/**********************************************************************//**
+Creates the per-index compression statistics. */
+UNIV_INTERN
+void
+page_zip_stat_per_index_init(void);
+/*==============================*/
+/**********************************************************************//**
+Frees the per-index compression statistics. */
+UNIV_INTERN
+void
+page_zip_stat_per_index_free(void);
+/*==============================*/
+/**********************************************************************//**
+Forgets the per-index compression statistics of all indexes. */
+UNIV_INTERN
+void
+page_zip_stat_per_index_reset(void);
+/*===============================*/
+/**********************************************************************//**
+Copies the per-index compression statistics, ordered by index id.
+@return	array of *n_stats elements, allocated from heap */
+UNIV_INTERN
+page_zip_stat_per_index_t*
+page_zip_stat_per_index_copy(
+/*=========================*/
+	mem_heap_t*	heap,		/*!< in: memory heap for the copy */
+	ibool		reset,		/*!< in: TRUE=reset the statistics */
+	ulint*		n_stats);	/*!< out: number of indexes */
+/**********************************************************************//**
+Write a log record of compressing an index page. */
+UNIV_INTERN
+void
+page_zip_compress_write_log(
+/*========================*/
+	const page_zip_des_t*	page_zip,/*!< in: compressed page */
+	const page_t*		page,	/*!< in: uncompressed page */
+	dict_index_t*		index,	/*!< in: index of the B-tree node */
+	mtr_t*			mtr);	/*!< in: mini-transaction */
+#endif /* !UNIV_HOTBACKUP */
+
 /**********************************************************************//**
 Compress a page.
 @return TRUE on success, FALSE on failure; page_zip will be left
@@ -113,6 +169,7 @@ page_zip_compress(
 				m_start, m_end, m_nonempty */
 	const page_t*	page,	/*!< in: uncompressed page */
 	dict_index_t*	index,	/*!< in: index of the B-tree node */
+	ulint		level,	/*!< in: zlib compression level */
 	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
 	__attribute__((nonnull(1,2,3)));
 
@@ -446,7 +503,21 @@ ulint
 page_zip_calc_checksum(
 /*===================*/
         const void*     data,   /*!< in: compressed page */
-        ulint           size)   /*!< in: size of compressed page */
+        ulint           size,   /*!< in: size of compressed page */
+	ulint		algo)	/*!< in: srv_checksum_algorithm_t */
+	__attribute__((nonnull));
+
+/**********************************************************************//**
+Verify a compressed page's checksum. Unless innodb_checksum_algorithm
+is one of the strict variants, a checksum written by any of the
+algorithms is accepted.
+@return	TRUE if the stored checksum is valid */
+UNIV_INTERN
+ibool
+page_zip_verify_checksum(
+/*=====================*/
+	const void*	data,	/*!< in: compressed page */
+	ulint		size)	/*!< in: size of compressed page */
 	__attribute__((nonnull));
 
 #ifndef UNIV_HOTBACKUP
@@ -59,7 +59,7 @@ read_view_oldest_copy_or_open_new(
 	mem_heap_t*	heap);		/*!< in: memory heap from which
 					allocated */
 /*********************************************************************//**
-Closes a read view. */
+Closes a read view. The caller does not need to hold the kernel mutex. */
 UNIV_INTERN
 void
 read_view_close(
@@ -49,6 +49,17 @@ row_mysql_prebuilt_free_blob_heap(
 	row_prebuilt_t*	prebuilt);	/*!< in: prebuilt struct of a
 					ha_innobase:: table handle */
 /*******************************************************************//**
+Shrinks the fetch cache of prebuilt back to MYSQL_FETCH_CACHE_SIZE row
+buffers after a large scan has grown it, and discards the rows that
+are still cached for the cursor. Must only be called when the cursor
+will not be continued, e.g. at the end of a statement. */
+UNIV_INTERN
+void
+row_mysql_prebuilt_shrink_fetch_cache(
+/*==================================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct of a
+					ha_innobase:: table handle */
+/*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
 @return pointer to the data, we skip the 1 or 2 bytes at the start
@@ -573,11 +584,20 @@ struct mysql_row_templ_struct {
 	ulint	is_unsigned;		/*!< if a column type is an integer
 					type and this field is != 0, then
 					it is an unsigned integer type */
+	ulint	icp_rec_field_no;	/*!< field number of the column in an
+					Innobase record in the current index;
+					ULINT_UNDEFINED if the column is not
+					in the index or no index condition
+					is pushed down */
 };
 
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
+/* The fetch cache of a large scan doubles after each full batch, up to
+this many rows and MYSQL_FETCH_CACHE_MAX_BYTES bytes of row buffers */
+#define MYSQL_FETCH_CACHE_MAX_SIZE	512
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(256 * 1024)
 
 #define ROW_PREBUILT_ALLOCATED	78540783
 #define ROW_PREBUILT_FREED	26423527
@@ -644,6 +664,10 @@ struct row_prebuilt_struct {
 					not to be confused with InnoDB
 					externally stored columns
 					(VARCHAR can be off-page too) */
+	unsigned	large_scan:1;	/*!< TRUE if MySQL is reading the
+					whole index or a key range: then
+					fetch_cache may grow beyond
+					MYSQL_FETCH_CACHE_SIZE rows */
 	mysql_row_templ_t* mysql_template;/*!< template used to transform
 					rows fast between MySQL and Innobase
 					formats; memory for this template
@@ -740,8 +764,7 @@ struct row_prebuilt_struct {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
-					/*!< a cache for fetched rows if we
+	byte**		fetch_cache;	/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
 					batch; we reserve mysql_row_len
@@ -750,6 +773,12 @@ struct row_prebuilt_struct {
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
 					start and at the end */
+	ulint		fetch_cache_alloc;/*!< number of row buffers
+					allocated in fetch_cache */
+	ulint		fetch_cache_size;/*!< number of rows to fetch in
+					the current batch; starts at
+					MYSQL_FETCH_CACHE_SIZE and grows
+					in a large_scan */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -758,6 +787,14 @@ struct row_prebuilt_struct {
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
 					in fetch_cache */
+	ulint		ra_page_no;	/*!< leaf page on which the last row
+					of an ascending scan was found, or
+					FIL_NULL */
+	ulint		ra_n_pages;	/*!< number of leaf pages visited by
+					the ascending scan so far */
+	ulint		ra_next;	/*!< value of ra_n_pages at which the
+					next logical read-ahead is issued,
+					see btr_cur_read_ahead_leaves() */
 	mem_heap_t*	blob_heap;	/*!< in SELECTS BLOB fields are copied
 					to this heap */
 	mem_heap_t*	old_vers_heap;	/*!< memory heap where a previous
@@ -778,6 +815,12 @@ struct row_prebuilt_struct {
 					store it here so that we can return
 					it to MySQL */
 	/*----------------------*/
+	void*		idx_cond;	/*!< the MySQL handler when an index
+					condition is pushed down to the
+					secondary index that is scanned,
+					see row_search_idx_cond_check();
+					NULL otherwise */
+	/*----------------------*/
 	ulint		magic_n2;	/*!< this should be the same as
 					magic_n */
 };
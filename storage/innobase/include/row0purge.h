@@ -34,6 +34,7 @@ Created 3/14/1997 Heikki Tuuri
 #include "trx0types.h"
 #include "que0types.h"
 #include "row0types.h"
+#include "ut0vec.h"
 
 /********************************************************************//**
 Creates a purge node to a query graph.
@@ -82,10 +83,12 @@ struct purge_node_struct{
 	que_common_t	common;	/*!< node type: QUE_NODE_PURGE */
 	/*----------------------*/
 	/* Local storage for this graph node */
+	ib_vector_t*	undo_recs;/*!< the trx_purge_rec_t of the current
+				purge batch handed to this node */
+	ulint		next_undo_rec;/*!< index of the next record to purge
+				in undo_recs */
 	roll_ptr_t	roll_ptr;/* roll pointer to undo log record */
 	trx_undo_rec_t*	undo_rec;/* undo log record */
-	trx_undo_inf_t*	reservation;/* reservation for the undo log record in
-				the purge array */
 	undo_no_t	undo_no;/* undo number of the record */
 	ulint		rec_type;/* undo log record type: TRX_UNDO_INSERT_REC,
 				... */
@@ -37,8 +37,8 @@ Created 2/6/1997 Heikki Tuuri
 
 /*****************************************************************//**
 Finds out if an active transaction has inserted or modified a secondary
-index record. NOTE: the kernel mutex is temporarily released in this
-function!
+index record. NOTE: the kernel mutex and lock_sys->latch are temporarily
+released in this function!
 @return NULL if committed, else the active transaction */
 UNIV_INTERN
 trx_t*
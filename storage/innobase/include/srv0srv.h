@@ -158,12 +158,21 @@ extern ulint	srv_buf_pool_size;	/*!< requested size in bytes */
 extern ulint    srv_buf_pool_instances; /*!< requested number of buffer pool instances */
 extern ulint	srv_buf_pool_old_size;	/*!< previously requested size */
 extern ulint	srv_buf_pool_curr_size;	/*!< current size in bytes */
+extern char*	srv_buf_dump_filename;	/*!< name of the buffer pool dump
+					file, relative to srv_data_home */
+extern my_bool	srv_buffer_pool_dump_at_shutdown;/*!< dump the buffer pool
+					at shutdown */
+extern my_bool	srv_buffer_pool_load_at_startup;/*!< load the buffer pool
+					at startup */
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
+extern ulint	srv_adaptive_hash_index_parts;	/*!< number of adaptive
+						hash index partitions */
 
 extern ulint	srv_n_file_io_threads;
 extern my_bool	srv_random_read_ahead;
 extern ulong	srv_read_ahead_threshold;
+extern ulong	srv_read_ahead_logical_pages;
 extern ulint	srv_n_read_io_threads;
 extern ulint	srv_n_write_io_threads;
 
@@ -174,6 +183,13 @@ capacity. PCT_IO(5) -> returns the number of IO operations that
 is 5% of the max where max is srv_io_capacity.  */
 #define PCT_IO(p) ((ulong) (srv_io_capacity * ((double) p / 100.0)))
 
+/* The background threads perform various tasks based on the current
+state of IO activity and the level of IO utilization is past
+intervals. Following macros define thresholds for these conditions. */
+#define SRV_PEND_IO_THRESHOLD	(PCT_IO(3))
+#define SRV_RECENT_IO_ACTIVITY	(PCT_IO(5))
+#define SRV_PAST_IO_ACTIVITY	(PCT_IO(200))
+
 /* The "innodb_stats_method" setting, decides how InnoDB is going
 to treat NULL value when collecting statistics. It is not defined
 as enum type because the configure option takes unsigned integer type. */
@@ -210,14 +226,31 @@ extern ulint	srv_fast_shutdown;	 /* If this is 1, do not do a
 extern ibool	srv_innodb_status;
 
 extern unsigned long long	srv_stats_sample_pages;
+extern my_bool	srv_stats_persistent;	/*!< keep the index statistics
+					in SYS_STATS */
+extern unsigned long long	srv_stats_persistent_sample_pages;
+extern my_bool	srv_cmp_per_index_enabled;/*!< collect compression
+					statistics of each index */
 
 extern ibool	srv_use_doublewrite_buf;
+extern char*	srv_doublewrite_file;	/*!< file of the doublewrite
+					areas, or NULL */
 extern ibool	srv_use_checksums;
+/* The algorithm used for the page checksums, one of
+srv_checksum_algorithm_t. It is not defined as enum type because the
+configure option takes unsigned integer type. */
+extern ulong	srv_checksum_algorithm;
 
 extern ulong	srv_max_buf_pool_modified_pct;
 extern ulong	srv_max_purge_lag;
 
 extern ulong	srv_replication_delay;
+
+extern ulong	srv_merge_threads;	/*!< number of threads that sort and
+					load the indexes of a fast index
+					creation */
+extern ulong	srv_fill_factor;	/*!< percentage of each page that
+					a bulk load of an index fills */
 /*-------------------------------------------*/
 
 extern ulint	srv_n_rows_inserted;
@@ -333,6 +366,26 @@ extern ulint srv_buf_pool_wait_free;
 buffer pool to disk */
 extern ulint srv_buf_pool_flushed;
 
+/** Number of pages written from the buffer pool, by the reason for the
+flush */
+/* @{ */
+/** LRU list tail flushed by the page cleaner */
+extern ulint srv_buf_pool_flushed_lru;
+/** LRU list tail flushed by user threads, when the page cleaner was not
+running or did not get to it in time */
+extern ulint srv_buf_pool_flushed_lru_foreground;
+/** adaptive flushing, driven by redo generation rate and checkpoint age */
+extern ulint srv_buf_pool_flushed_adaptive;
+/** dirty pages above innodb_max_dirty_pages_pct */
+extern ulint srv_buf_pool_flushed_max_dirty;
+/** asynchronous preflush, checkpoint age above max_modified_age_async */
+extern ulint srv_buf_pool_flushed_async;
+/** synchronous preflush by user threads or at a checkpoint */
+extern ulint srv_buf_pool_flushed_sync;
+/** background flushing every ten seconds, when idle and at shutdown */
+extern ulint srv_buf_pool_flushed_background;
+/* @} */
+
 /** Number of buffer pool reads that led to the
 reading of a disk page */
 extern ulint srv_buf_pool_reads;
@@ -361,6 +414,13 @@ extern mysql_pfs_key_t	srv_error_monitor_thread_key;
 extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
+extern mysql_pfs_key_t	srv_purge_worker_thread_key;
+extern mysql_pfs_key_t	buf_page_cleaner_thread_key;
+extern mysql_pfs_key_t	buf_dump_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
+extern mysql_pfs_key_t	row_merge_thread_key;
+extern mysql_pfs_key_t	dict_stats_thread_key;
+extern mysql_pfs_key_t	ibuf_merge_thread_key;
 
 /* This macro register the current thread and its key with performance
 schema */
@@ -449,6 +509,27 @@ enum srv_stats_method_name_enum {
 
 typedef enum srv_stats_method_name_enum		srv_stats_method_name_t;
 
+/* Alternatives for srv_checksum_algorithm, which could be changed by
+setting innodb_checksum_algorithm */
+enum srv_checksum_algorithm_enum {
+	SRV_CHECKSUM_ALGORITHM_CRC32,		/* Write crc32, allow crc32,
+						innodb or none when reading */
+	SRV_CHECKSUM_ALGORITHM_STRICT_CRC32,	/* Write crc32, allow crc32
+						when reading */
+	SRV_CHECKSUM_ALGORITHM_INNODB,		/* Write innodb, allow crc32,
+						innodb or none when reading.
+						This is the default setting
+						for innodb_checksum_algorithm */
+	SRV_CHECKSUM_ALGORITHM_STRICT_INNODB,	/* Write innodb, allow
+						innodb when reading */
+	SRV_CHECKSUM_ALGORITHM_NONE,		/* Write none, allow crc32,
+						innodb or none when reading */
+	SRV_CHECKSUM_ALGORITHM_STRICT_NONE	/* Write none, allow none
+						when reading */
+};
+
+typedef enum srv_checksum_algorithm_enum	srv_checksum_algorithm_t;
+
 #ifndef UNIV_HOTBACKUP
 /** Types of threads existing in the system. */
 enum srv_thread_type {
@@ -667,7 +748,8 @@ srv_export_innodb_status(void);
 /*==========================*/
 
 /*********************************************************************//**
-Asynchronous purge thread.
+Asynchronous purge thread. It coordinates the purge: it runs the purge
+batches, and hands parts of them to the purge worker threads.
 @return	a dummy parameter */
 UNIV_INTERN
 os_thread_ret_t
@@ -675,6 +757,15 @@ srv_purge_thread(
 /*=============*/
 	void*	arg __attribute__((unused))); /*!< in: a dummy parameter
 					      required by os_thread_create */
+/*********************************************************************//**
+Purge worker thread: purges the parts of the purge batches that
+srv_purge_thread() hands to it.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+srv_purge_worker_thread(
+/*====================*/
+	void*	arg);	/*!< in: trx_purge_worker_t of this thread */
 
 /**********************************************************************//**
 Enqueues a task to server task queue and releases a worker thread, if there
@@ -697,6 +788,8 @@ srv_get_active_thread_type(void);
 
 /** Status variables to be passed to MySQL */
 struct export_var_struct{
+	char  innodb_buffer_pool_dump_status[512];/*!< Buf pool dump status */
+	char  innodb_buffer_pool_load_status[512];/*!< Buf pool load status */
 	ulint innodb_data_pending_reads;	/*!< Pending reads */
 	ulint innodb_data_pending_writes;	/*!< Pending writes */
 	ulint innodb_data_pending_fsyncs;	/*!< Pending fsyncs */
@@ -719,10 +812,32 @@ struct export_var_struct{
 	ulint innodb_buffer_pool_reads;		/*!< srv_buf_pool_reads */
 	ulint innodb_buffer_pool_wait_free;	/*!< srv_buf_pool_wait_free */
 	ulint innodb_buffer_pool_pages_flushed;	/*!< srv_buf_pool_flushed */
+	ulint innodb_buffer_pool_pages_flushed_lru;
+					/*!< srv_buf_pool_flushed_lru */
+	ulint innodb_buffer_pool_pages_flushed_lru_foreground;
+					/*!< srv_buf_pool_flushed_lru_foreground */
+	ulint innodb_buffer_pool_pages_flushed_adaptive;
+					/*!< srv_buf_pool_flushed_adaptive */
+	ulint innodb_buffer_pool_pages_flushed_max_dirty;
+					/*!< srv_buf_pool_flushed_max_dirty */
+	ulint innodb_buffer_pool_pages_flushed_async;
+					/*!< srv_buf_pool_flushed_async */
+	ulint innodb_buffer_pool_pages_flushed_sync;
+					/*!< srv_buf_pool_flushed_sync */
+	ulint innodb_buffer_pool_pages_flushed_background;
+					/*!< srv_buf_pool_flushed_background */
 	ulint innodb_buffer_pool_write_requests;/*!< srv_buf_pool_write_requests */
 	ulint innodb_buffer_pool_read_ahead_rnd;/*!< srv_read_ahead_rnd */
 	ulint innodb_buffer_pool_read_ahead;	/*!< srv_read_ahead */
 	ulint innodb_buffer_pool_read_ahead_evicted;/*!< srv_read_ahead evicted*/
+	ulint innodb_buffer_pool_read_ahead_logical;
+					/*!< logical read-ahead pages */
+	ulint innodb_buffer_pool_read_ahead_logical_used;
+					/*!< logical read-ahead pages
+					that were accessed */
+	ulint innodb_buffer_pool_read_ahead_logical_evicted;
+					/*!< logical read-ahead pages
+					evicted without access */
 	ulint innodb_dblwr_pages_written;	/*!< srv_dblwr_pages_written */
 	ulint innodb_dblwr_writes;		/*!< srv_dblwr_writes */
 	ibool innodb_have_atomic_builtins;	/*!< HAVE_ATOMIC_BUILTINS */
@@ -749,8 +864,19 @@ struct export_var_struct{
 	ulint innodb_rows_read;			/*!< srv_n_rows_read */
 	ulint innodb_rows_inserted;		/*!< srv_n_rows_inserted */
 	ulint innodb_rows_updated;		/*!< srv_n_rows_updated */
+	ulint innodb_history_list_length;	/*!< trx_sys->rseg_history_len */
+	lint innodb_purge_lag_per_sec;		/*!< purge_sys->lag_per_sec */
+	ulint innodb_purge_undo_records_per_sec;/*!< purge_sys->recs_per_sec */
 	ulint innodb_rows_deleted;		/*!< srv_n_rows_deleted */
 	ulint innodb_truncated_status_writes;	/*!< srv_truncated_status_writes */
+	ulint innodb_kernel_mutex_os_waits;	/*!< kernel_mutex.count_os_wait */
+	ulint innodb_lock_sys_latch_os_waits;	/*!< lock_sys->latch.count_os_wait */
+	ulint innodb_lock_rec_mutex_os_waits;	/*!< count_os_wait of all
+						lock_sys->rec_mutexes */
+	ulint innodb_trx_sys_mutex_os_waits;	/*!< trx_sys->mutex.count_os_wait */
+	ulint innodb_read_view_mutex_os_waits;	/*!< trx_sys->read_view_mutex
+						.count_os_wait */
+	ulint innodb_srv_conc_mutex_os_waits;	/*!< srv_conc_mutex.count_os_wait */
 #ifdef UNIV_DEBUG
 	ulint innodb_purge_trx_id_age;		/*!< max_trx_id - purged trx_id */
 	ulint innodb_purge_view_trx_id_age;	/*!< rw_max_trx_id
@@ -775,6 +901,7 @@ extern ulint	srv_n_threads_active[];
 #else /* !UNIV_HOTBACKUP */
 # define srv_use_adaptive_hash_indexes		FALSE
 # define srv_use_checksums			TRUE
+# define srv_checksum_algorithm			SRV_CHECKSUM_ALGORITHM_INNODB
 # define srv_use_native_aio			FALSE
 # define srv_force_recovery			0UL
 # define srv_set_io_thread_op_info(t,info)	((void) 0)
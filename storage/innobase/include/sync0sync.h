@@ -70,6 +70,7 @@ extern mysql_pfs_key_t	buf_pool_mutex_key;
 extern mysql_pfs_key_t	buf_pool_zip_mutex_key;
 extern mysql_pfs_key_t	cache_last_read_mutex_key;
 extern mysql_pfs_key_t	dict_foreign_err_mutex_key;
+extern mysql_pfs_key_t	dict_stats_mutex_key;
 extern mysql_pfs_key_t	dict_sys_mutex_key;
 extern mysql_pfs_key_t	file_format_max_mutex_key;
 extern mysql_pfs_key_t	fil_system_mutex_key;
@@ -81,19 +82,24 @@ extern mysql_pfs_key_t	ibuf_pessimistic_insert_mutex_key;
 extern mysql_pfs_key_t	log_sys_mutex_key;
 extern mysql_pfs_key_t	log_flush_order_mutex_key;
 extern mysql_pfs_key_t	kernel_mutex_key;
+extern mysql_pfs_key_t	lock_rec_mutex_key;
 # ifdef UNIV_MEM_DEBUG
 extern mysql_pfs_key_t	mem_hash_mutex_key;
 # endif /* UNIV_MEM_DEBUG */
 extern mysql_pfs_key_t	mem_pool_mutex_key;
 extern mysql_pfs_key_t	mutex_list_mutex_key;
+extern mysql_pfs_key_t	page_zip_stat_per_index_mutex_key;
 extern mysql_pfs_key_t	purge_sys_bh_mutex_key;
+extern mysql_pfs_key_t	read_view_mutex_key;
 extern mysql_pfs_key_t	recv_sys_mutex_key;
+extern mysql_pfs_key_t	row_merge_mutex_key;
 extern mysql_pfs_key_t	rseg_mutex_key;
 # ifdef UNIV_SYNC_DEBUG
 extern mysql_pfs_key_t	rw_lock_debug_mutex_key;
 # endif /* UNIV_SYNC_DEBUG */
 extern mysql_pfs_key_t	rw_lock_list_mutex_key;
 extern mysql_pfs_key_t	rw_lock_mutex_key;
+extern mysql_pfs_key_t	srv_conc_mutex_key;
 extern mysql_pfs_key_t	srv_dict_tmpfile_mutex_key;
 extern mysql_pfs_key_t	srv_innodb_monitor_mutex_key;
 extern mysql_pfs_key_t	srv_misc_tmpfile_mutex_key;
@@ -103,6 +109,7 @@ extern mysql_pfs_key_t	syn_arr_mutex_key;
 extern mysql_pfs_key_t	sync_thread_mutex_key;
 # endif /* UNIV_SYNC_DEBUG */
 extern mysql_pfs_key_t	trx_doublewrite_mutex_key;
+extern mysql_pfs_key_t	trx_sys_mutex_key;
 extern mysql_pfs_key_t	trx_undo_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
@@ -434,7 +441,7 @@ except for data dictionary latches. */
 	(!sync_thread_levels_nonempty_gen(TRUE))
 /******************************************************************//**
 Checks if the level array for the current thread is empty,
-except for the btr_search_latch.
+except for an adaptive hash index latch.
 @return	a latch, or NULL if empty except the exceptions specified below */
 UNIV_INTERN
 void*
@@ -442,7 +449,8 @@ sync_thread_levels_nonempty_trx(
 /*============================*/
 	ibool	has_search_latch)
 				/*!< in: TRUE if and only if the thread
-				is supposed to hold btr_search_latch */
+				is supposed to hold an adaptive hash
+				index latch */
 	__attribute__((warn_unused_result));
 
 /******************************************************************//**
@@ -589,9 +597,33 @@ Kernel mutex				If a kernel operation needs a file
 |					fsp x-latch before acquiring the kernel
 |					mutex.
 V
+Lock system latch			X-latched together with the kernel
+|					mutex to change the lock queues, see
+|					lock_mutex_enter_kernel(). A thread
+|					holding it in S mode must not reserve
+|					the kernel mutex.
+V
+Record lock hash cell mutexes		Only reserved while holding the lock
+|					system latch in S mode, one at a time.
+V
+Transaction system mutex		Protects trx_sys->trx_list and the
+|					transaction ids together with the
+|					kernel mutex: they are changed while
+|					holding both and can be read while
+|					holding either.
+V
+Read view mutex				Protects trx_sys->view_list. Views are
+|					opened with the transaction system
+|					mutex reserved, but they can be closed
+|					without it.
+V
 Search system mutex
 |
 V
+Thread concurrency mutex		Protects the srv_conc queue. It can be
+|					reserved while holding the kernel
+|					mutex or the search system latch.
+V
 Buffer pool mutex
 |
 V
@@ -657,8 +689,11 @@ or row lock! */
 /*------------------------------------- MySQL binlog mutex */
 /*-------------------------------*/
 #define	SYNC_KERNEL		300
-#define SYNC_REC_LOCK		299
-#define	SYNC_TRX_LOCK_HEAP	298
+#define	SYNC_LOCK_SYS		299	/* lock_sys->latch */
+#define SYNC_REC_LOCK		298	/* lock_sys->rec_mutexes */
+#define	SYNC_TRX_LOCK_HEAP	297
+#define	SYNC_TRX_SYS		296	/* trx_sys->mutex */
+#define	SYNC_READ_VIEW		295
 #define SYNC_TRX_SYS_HEADER	290
 #define	SYNC_PURGE_QUEUE	200
 #define SYNC_LOG		170
@@ -671,6 +706,7 @@ or row lock! */
 					SYNC_SEARCH_SYS, as memory allocation
 					can call routines there! Otherwise
 					the level is SYNC_MEM_HASH. */
+#define	SYNC_SRV_CONC		155	/* srv_conc_mutex */
 #define	SYNC_BUF_POOL		150	/* Buffer pool mutex */
 #define	SYNC_BUF_BLOCK		146	/* Block mutex */
 #define	SYNC_BUF_FLUSH_LIST	145	/* Buffer flush list mutex */
@@ -34,6 +34,8 @@ Created 3/26/1996 Heikki Tuuri
 #include "page0page.h"
 #include "usr0sess.h"
 #include "fil0fil.h"
+#include "row0types.h"
+#include "ut0vec.h"
 
 /** The global data structure coordinating a purge */
 extern trx_purge_t*	purge_sys;
@@ -88,28 +90,10 @@ trx_purge_add_update_undo_to_history(
 	page_t*	undo_page,	/*!< in: update undo log header page,
 				x-latched */
 	mtr_t*	mtr);		/*!< in: mtr */
-/********************************************************************//**
-Fetches the next undo log record from the history list to purge. It must be
-released with the corresponding release function.
-@return copy of an undo log record or pointer to trx_purge_dummy_rec,
-if the whole undo log can skipped in purge; NULL if none left */
-UNIV_INTERN
-trx_undo_rec_t*
-trx_purge_fetch_next_rec(
-/*=====================*/
-	roll_ptr_t*	roll_ptr,/*!< out: roll pointer to undo record */
-	trx_undo_inf_t** cell,	/*!< out: storage cell for the record in the
-				purge array */
-	mem_heap_t*	heap);	/*!< in: memory heap where copied */
-/*******************************************************************//**
-Releases a reserved purge undo record. */
-UNIV_INTERN
-void
-trx_purge_rec_release(
-/*==================*/
-	trx_undo_inf_t*	cell);	/*!< in: storage cell */
 /*******************************************************************//**
-This function runs a purge batch.
+This function runs a purge batch. The undo log records of the batch are
+split by table among the purge workers, the first of which is run by the
+calling thread.
 @return	number of undo log pages handled in the batch */
 UNIV_INTERN
 ulint
@@ -117,6 +101,30 @@ trx_purge(
 /*======*/
 	ulint	limit);		/*!< in: the maximum number of records to
 				purge in one batch */
+/*******************************************************************//**
+Waits for the purge coordinator to hand a part of a purge batch to the
+worker, and purges it.
+@return	FALSE if the worker should exit */
+UNIV_INTERN
+ibool
+trx_purge_worker_wait_and_run(
+/*==========================*/
+	trx_purge_worker_t*	worker);	/*!< in: purge worker */
+/*******************************************************************//**
+Tells the purge worker threads to exit, and waits until they have seen
+it. Called by the purge coordinator thread when it exits. */
+UNIV_INTERN
+void
+trx_purge_stop_workers(void);
+/*=========================*/
+/*******************************************************************//**
+Samples the history list length and the number of purged undo log
+records, to compute the purge rate and the purge lag. Called once per
+second by srv_error_monitor_thread(). */
+UNIV_INTERN
+void
+trx_purge_stat_update(void);
+/*=======================*/
 /******************************************************************//**
 Prints information of the purge system to stderr. */
 UNIV_INTERN
@@ -124,6 +132,32 @@ void
 trx_purge_sys_print(void);
 /*======================*/
 
+/** An undo log record fetched for purge */
+struct trx_purge_rec_struct{
+	trx_undo_rec_t*	undo_rec;	/*!< copy of the undo log record, or
+					&trx_purge_dummy_rec */
+	roll_ptr_t	roll_ptr;	/*!< roll pointer to the undo log
+					record */
+};
+
+/** A purge worker. The records of each purge batch are split by table
+among the workers, so that all the records of a table are purged in order
+by one worker, and different tables are purged in parallel. The first
+worker is run by the thread that runs the batch, the others by
+srv_purge_worker_thread(). */
+struct trx_purge_worker_struct{
+	sess_t*		sess;		/*!< System session running the purge
+					query of this worker */
+	que_t*		query;		/*!< The query graph of this worker */
+	purge_node_t*	node;		/*!< The purge node of query */
+	os_event_t	event;		/*!< Set by the coordinator when it has
+					handed a part of a batch to this
+					worker, or when the worker should
+					exit */
+	os_event_t	done_event;	/*!< Set by the worker when it has
+					purged its part of the batch */
+};
+
 /** The control structure used in the purge operation */
 struct trx_purge_struct{
 	ulint		state;		/*!< Purge system state */
@@ -189,6 +223,30 @@ struct trx_purge_struct{
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
 	mutex_t		bh_mutex;	/*!< Mutex protecting ib_bh */
+	/*-----------------------------*/
+	ulint		n_workers;	/*!< Number of purge workers: at least
+					one, otherwise innodb_purge_threads */
+	trx_purge_worker_t* workers;	/*!< Array of n_workers purge workers;
+					the first one uses the sess, trx and
+					query above */
+	ibool		workers_exit;	/*!< TRUE if the purge worker threads
+					should exit */
+	mem_heap_t*	rec_heap;	/*!< Memory heap for the undo log
+					records of the current batch */
+	/*-----------------------------*/
+	ulint		n_recs_purged;	/*!< Number of undo log records
+					purged since startup */
+	ulint		stat_n_recs_purged;
+					/*!< n_recs_purged at the last call of
+					trx_purge_stat_update() */
+	ulint		stat_history_len;
+					/*!< trx_sys->rseg_history_len at the
+					last call of trx_purge_stat_update() */
+	ulint		recs_per_sec;	/*!< Undo log records purged during the
+					last second */
+	lint		lag_per_sec;	/*!< Growth of the history list length
+					during the last second; negative if
+					purge is catching up */
 };
 
 #define TRX_PURGE_ON		1	/* purge operation is running */
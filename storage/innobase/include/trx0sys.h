@@ -66,6 +66,16 @@ extern ib_int64_t	trx_sys_mysql_bin_log_pos;
 /** The transaction system */
 extern trx_sys_t*	trx_sys;
 
+#ifdef UNIV_DEBUG
+/** Test if trx_sys->trx_list may be read: it is modified while holding
+both trx_sys->mutex and the kernel mutex. */
+# define trx_sys_list_own()					\
+	(mutex_own(&trx_sys->mutex) || mutex_own(&kernel_mutex))
+/** Test if trx_sys->trx_list may be modified. */
+# define trx_sys_list_x_own()					\
+	(mutex_own(&trx_sys->mutex) && mutex_own(&kernel_mutex))
+#endif /* UNIV_DEBUG */
+
 /** Doublewrite system */
 extern trx_doublewrite_t*	trx_doublewrite;
 /** The following is set to TRUE when we are upgrading from pre-4.1
@@ -113,6 +123,19 @@ ibool
 trx_doublewrite_page_inside(
 /*========================*/
 	ulint	page_no);	/*!< in: page number */
+/****************************************************************//**
+Gets the doublewrite area to which the pages of a flush batch are posted.
+With innodb_doublewrite_file, each buffer pool instance has its own areas
+for LRU and flush list flushing, so that the batches can be written
+concurrently.
+@return	doublewrite area */
+UNIV_INLINE
+trx_doublewrite_area_t*
+trx_doublewrite_get_area(
+/*=====================*/
+	ulint		buf_pool_index,	/*!< in: buffer pool instance */
+	enum buf_flush	flush_type);	/*!< in: BUF_FLUSH_LRU or
+					BUF_FLUSH_LIST */
 /***************************************************************//**
 Checks if a page address is the trx sys header page.
 @return	TRUE if trx sys header page */
@@ -568,6 +591,10 @@ FIL_PAGE_ARCH_LOG_NO_OR_SPACE_NO. */
 
 /** Size of the doublewrite block in pages */
 #define TRX_SYS_DOUBLEWRITE_BLOCK_SIZE	FSP_EXTENT_SIZE
+
+/** Size of a doublewrite area in pages: the maximum number of pages
+that are written to the doublewrite buffer or file in one batch */
+#define TRX_DOUBLEWRITE_AREA_SIZE	(2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
 /* @} */
 
 /** File format tag */
@@ -589,15 +616,18 @@ identifier is added to this 64-bit constant. */
 /* @} */
 
 #ifndef UNIV_HOTBACKUP
-/** Doublewrite control struct */
-struct trx_doublewrite_struct{
+/** Doublewrite area: a batch of at most TRX_DOUBLEWRITE_AREA_SIZE pages
+that is written to the doublewrite buffer or file with one write and
+one flush before the pages are written to their tablespaces */
+struct trx_doublewrite_area_struct{
 	mutex_t	mutex;		/*!< mutex protecting the first_free field and
 				write_buf */
-	ulint	block1;		/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint	block2;		/*!< page number of the second block */
 	ulint	first_free;	/*!< first free position in write_buf measured
 				in units of UNIV_PAGE_SIZE */
+	ib_uint64_t offset;	/*!< byte offset of the area in
+				trx_doublewrite->file; unused if the
+				doublewrite buffer is in the system
+				tablespace */
 	byte*	write_buf;	/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by UNIV_PAGE_SIZE
@@ -609,9 +639,33 @@ struct trx_doublewrite_struct{
 				blocks which have been cached to write_buf */
 };
 
+/** Doublewrite control struct */
+struct trx_doublewrite_struct{
+	ulint	block1;		/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint	block2;		/*!< page number of the second block */
+	char*	file_name;	/*!< path of innodb_doublewrite_file,
+				or NULL if the doublewrite buffer in the
+				system tablespace is used */
+	os_file_t file;		/*!< handle to file_name */
+	ulint	n_areas;	/*!< number of elements in areas: 1 if
+				the doublewrite buffer in the system
+				tablespace is used, otherwise one for
+				each buffer pool instance and flush type,
+				see trx_doublewrite_get_area() */
+	trx_doublewrite_area_t*
+		areas;		/*!< the doublewrite areas */
+};
+
 /** The transaction system central memory data structure; protected by the
-kernel mutex */
+kernel mutex. The fields that a read view is built from are modified
+while holding both the kernel mutex and trx_sys->mutex, so that they
+can be read while holding either of them. */
 struct trx_sys_struct{
+	mutex_t		mutex;		/*!< mutex protecting max_trx_id,
+					trx_list and the trx->id, trx->no
+					and trx->conc_state of the
+					transactions in it; see above */
 	trx_id_t	max_trx_id;	/*!< The smallest number not yet
 					assigned as a transaction id or
 					transaction number */
@@ -635,9 +689,14 @@ struct trx_sys_struct{
 					list (update undo logs for committed
 					transactions), protected by
 					rseg->mutex */
+	mutex_t		read_view_mutex;/*!< mutex protecting view_list;
+					a view is opened while also holding
+					trx_sys->mutex, but it can be
+					closed without it */
 	UT_LIST_BASE_NODE_T(read_view_t) view_list;
 					/*!< List of read views sorted
-					on trx no, biggest first */
+					on trx no, biggest first; protected
+					by read_view_mutex */
 };
 
 /** When a trx id which is zero modulo this number (which must be a power of
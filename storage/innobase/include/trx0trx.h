@@ -34,6 +34,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "usr0types.h"
 #include "que0types.h"
 #include "mem0mem.h"
+#include "sync0rw.h"
 #include "read0types.h"
 #include "trx0xa.h"
 #include "ut0vec.h"
@@ -349,7 +350,8 @@ trx_commit_step(
 
 /**********************************************************************//**
 Prints info about a transaction to the given file. The caller must own the
-kernel mutex. */
+kernel mutex, and lock_sys->latch in exclusive mode if trx is not its own
+transaction, see lock_mutex_enter_kernel(). */
 UNIV_INTERN
 void
 trx_print(
@@ -490,10 +492,12 @@ struct trx_struct{
 				       	transaction has been registered with
 				       	the coordinator using the XA API, and
 				       	is set to 0 after commit or rollback. */
-	unsigned	owns_prepare_mutex:1;/* 1 if owns prepare mutex, if
-					this is set to 1 then registered should
-					also be set to 1. This is used in the
-					XA code */
+	unsigned	active_commit_ordered:1;/* 1 if the binlog group
+					commit committed the transaction in
+					innobase_commit_ordered(), if this is
+					set to 1 then registered should also
+					be set to 1. This is used in the XA
+					code */
 	/*------------------------------*/
 	ulint		isolation_level;/* TRX_ISO_REPEATABLE_READ, ... */
 	ulint		check_foreigns;	/* normally TRUE, but if the user
@@ -528,6 +532,9 @@ struct trx_struct{
 	ulint		has_search_latch;
 					/* TRUE if this trx has latched the
 					search system latch in S-mode */
+	rw_lock_t*	search_latch;	/*!< if has_search_latch, the
+					adaptive hash index partition
+					latch that this trx holds */
 	ulint		deadlock_mark;	/*!< a mark field used in deadlock
 					checking algorithm.  */
 	trx_dict_op_t	dict_operation;	/**< @see enum trx_dict_op */
@@ -0,0 +1,65 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/ut0crc32.h
+CRC32C implementation, using the SSE4.2 crc32 instruction when the CPU
+has it and a slicing-by-8 table lookup otherwise.
+
+*******************************************************/
+
+#ifndef ut0crc32_h
+#define ut0crc32_h
+
+#include "univ.i"
+
+/********************************************************************//**
+Initializes the data structures used by ut_crc32(), and chooses the
+implementation. Must be called once before ut_crc32() is used. */
+UNIV_INTERN
+void
+ut_crc32_init(void);
+/*===============*/
+
+/********************************************************************//**
+Calculates CRC32C.
+@param ptr	data over which to calculate CRC32C
+@param len	data length in bytes
+@return		CRC32C (CRC-32C, using the GF(2) primitive polynomial
+0x11EDC6F41, or 0x1EDC6F41 without the high-order bit) */
+typedef ib_uint32_t (*ib_ut_crc32_t)(const byte* ptr, ulint len);
+
+/** Pointer to the CRC32C implementation chosen by ut_crc32_init() */
+extern ib_ut_crc32_t	ut_crc32;
+
+/** TRUE if ut_crc32() uses the SSE4.2 crc32 instruction */
+extern ibool		ut_crc32_sse42_enabled;
+
+/********************************************************************//**
+Calculates CRC32C with the slicing-by-8 table lookup, without using any
+special CPU instructions. This is what ut_crc32() uses when the CPU does
+not have the SSE4.2 crc32 instruction.
+@return	CRC32C */
+UNIV_INTERN
+ib_uint32_t
+ut_crc32_slice8(
+/*============*/
+	const byte*	buf,	/*!< in: data */
+	ulint		len);	/*!< in: data length in bytes */
+
+#endif /* ut0crc32_h */
@@ -186,6 +186,20 @@ notices that the result set is complete. If the biggest record was removed,
 lock wait can occur because the next record only inherits a gap type lock,
 and a wait may be needed. Q.E.D. */
 
+/* LATCHING: the lock queues, the locks of the transactions and the lock
+wait state are changed while holding the kernel mutex and lock_sys->latch
+in exclusive mode, see lock_mutex_enter_kernel(). The only exception is
+the fast path of lock_rec_lock() and lock_rec_insert_check_and_lock():
+holding lock_sys->latch in shared mode and the mutex of the rec_hash cell
+of a page, see lock_rec_get_mutex(), a thread may look at the record
+locks on the page and add a granted lock of its own transaction, or set
+a bit in such a lock. The page latch held by the caller keeps the record
+from getting an implicit lock in the meantime. As the S-latch holders
+only touch the queues of their own cells and the trx_locks of their own
+transaction, a thread holding the kernel mutex may still read anything
+else, such as the table lock queues or the wait state of the
+transactions. */
+
 /* If an index record should be changed or a new inserted, we must check
 the lock on the record or the next. When a read cursor starts reading,
 we will set a record level s-lock on each record it passes, except on the
@@ -367,6 +381,16 @@ lock_rec_validate_page(
 /* The lock system */
 UNIV_INTERN lock_sys_t*	lock_sys	= NULL;
 
+#ifdef UNIV_PFS_RWLOCK
+/* Key to register lock_sys->latch with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_sys_latch_key;
+#endif /* UNIV_PFS_RWLOCK */
+
+#ifdef UNIV_PFS_MUTEX
+/* Key to register lock_sys->rec_mutexes with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_rec_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
 /* We store info on the latest deadlock error to this buffer. InnoDB
 Monitor will then fetch it and print */
 UNIV_INTERN ibool	lock_deadlock_found = FALSE;
@@ -437,11 +461,6 @@ lock_rec_get_nth_bit(
 	return(1 & ((const byte*) &lock[1])[byte_index] >> bit_index);
 }
 
-/*************************************************************************/
-
-#define lock_mutex_enter_kernel()	mutex_enter(&kernel_mutex)
-#define lock_mutex_exit_kernel()	mutex_exit(&kernel_mutex)
-
 /*********************************************************************//**
 Checks that a transaction id is sensible, i.e., not in the future.
 @return	TRUE if ok */
@@ -454,14 +473,15 @@ lock_check_trx_id_sanity(
 	dict_index_t*	index,		/*!< in: index */
 	const ulint*	offsets,	/*!< in: rec_get_offsets(rec, index) */
 	ibool		has_kernel_mutex)/*!< in: TRUE if the caller owns the
-					kernel mutex */
+					kernel mutex; otherwise
+					trx_sys->mutex is reserved here */
 {
 	ibool	is_ok		= TRUE;
 
 	ut_ad(rec_offs_validate(rec, index, offsets));
 
 	if (!has_kernel_mutex) {
-		mutex_enter(&kernel_mutex);
+		mutex_enter(&trx_sys->mutex);
 	}
 
 	/* A sanity check: the trx_id in rec must be smaller than the global
@@ -486,7 +506,7 @@ lock_check_trx_id_sanity(
 	}
 
 	if (!has_kernel_mutex) {
-		mutex_exit(&kernel_mutex);
+		mutex_exit(&trx_sys->mutex);
 	}
 
 	return(is_ok);
@@ -567,11 +587,18 @@ lock_sys_create(
 /*============*/
 	ulint	n_cells)	/*!< in: number of slots in lock hash table */
 {
+	ulint	i;
+
 	lock_sys = mem_alloc(sizeof(lock_sys_t));
 
-	lock_sys->rec_hash = hash_create(n_cells);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
 
-	/* hash_create_mutexes(lock_sys->rec_hash, 2, SYNC_REC_LOCK); */
+	for (i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_create(lock_rec_mutex_key,
+			     &lock_sys->rec_mutexes[i], SYNC_REC_LOCK);
+	}
+
+	lock_sys->rec_hash = hash_create(n_cells);
 
 	lock_latest_err_file = os_file_create_tmpfile();
 	ut_a(lock_latest_err_file);
@@ -584,12 +611,20 @@ void
 lock_sys_close(void)
 /*================*/
 {
+	ulint	i;
+
 	if (lock_latest_err_file != NULL) {
 		fclose(lock_latest_err_file);
 		lock_latest_err_file = NULL;
 	}
 
 	hash_table_free(lock_sys->rec_hash);
+
+	for (i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_free(&lock_sys->rec_mutexes[i]);
+	}
+
+	rw_lock_free(&lock_sys->latch);
 	mem_free(lock_sys);
 	lock_sys = NULL;
 }
@@ -1099,6 +1134,36 @@ lock_rec_reset_nth_bit(
 	((byte*) &lock[1])[byte_index] &= ~(1 << bit_index);
 }
 
+/*********************************************************************//**
+Gets the mutex of a record lock hash cell. The lock queues of the pages
+hashed to the cell can be read and granted locks of the own transaction
+added to them while holding the mutex and lock_sys->latch in S mode.
+@return	record lock hash cell mutex */
+UNIV_INLINE
+mutex_t*
+lock_rec_get_mutex(
+/*===============*/
+	ulint	hash)	/*!< in: cell of the page in lock_sys->rec_hash,
+			see lock_rec_hash() */
+{
+	return(&lock_sys->rec_mutexes[hash % LOCK_REC_N_MUTEXES]);
+}
+
+#ifdef UNIV_DEBUG
+/*********************************************************************//**
+Checks if the current thread may access the record lock queues of
+a rec_hash cell.
+@return	TRUE if the thread owns the lock system or the cell mutex */
+static
+ibool
+lock_rec_queue_own(
+/*===============*/
+	ulint	hash)	/*!< in: cell in lock_sys->rec_hash */
+{
+	return(lock_mutex_own() || mutex_own(lock_rec_get_mutex(hash)));
+}
+#endif /* UNIV_DEBUG */
+
 /*********************************************************************//**
 Gets the first or next record lock on a page.
 @return	next lock, NULL if none exists */
@@ -1111,7 +1176,9 @@ lock_rec_get_next_on_page_const(
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(lock_rec_hash(
+		      lock->un_member.rec_lock.space,
+		      lock->un_member.rec_lock.page_no)));
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 
 	space = lock->un_member.rec_lock.space;
@@ -1160,7 +1227,7 @@ lock_rec_get_first_on_page_addr(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(lock_rec_hash(space, page_no)));
 
 	lock = HASH_GET_FIRST(lock_sys->rec_hash,
 			      lock_rec_hash(space, page_no));
@@ -1187,9 +1254,12 @@ lock_rec_expl_exist_on_page(
 	ulint	space,	/*!< in: space id */
 	ulint	page_no)/*!< in: page number */
 {
-	ibool	ret;
+	ibool		ret;
+	mutex_t*	mutex	= lock_rec_get_mutex(lock_rec_hash(space,
+								   page_no));
 
-	mutex_enter(&kernel_mutex);
+	rw_lock_s_lock(&lock_sys->latch);
+	mutex_enter(mutex);
 
 	if (lock_rec_get_first_on_page_addr(space, page_no)) {
 		ret = TRUE;
@@ -1197,7 +1267,8 @@ lock_rec_expl_exist_on_page(
 		ret = FALSE;
 	}
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(mutex);
+	rw_lock_s_unlock(&lock_sys->latch);
 
 	return(ret);
 }
@@ -1217,7 +1288,7 @@ lock_rec_get_first_on_page(
 	ulint	space	= buf_block_get_space(block);
 	ulint	page_no	= buf_block_get_page_no(block);
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 
 	hash = buf_block_get_lock_hash_val(block);
 
@@ -1246,7 +1317,9 @@ lock_rec_get_next(
 	ulint	heap_no,/*!< in: heap number of the record */
 	lock_t*	lock)	/*!< in: lock */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(lock_rec_hash(
+		      lock->un_member.rec_lock.space,
+		      lock->un_member.rec_lock.page_no)));
 
 	do {
 		ut_ad(lock_get_type_low(lock) == LOCK_REC);
@@ -1268,7 +1341,7 @@ lock_rec_get_first(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 
 	for (lock = lock_rec_get_first_on_page(block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -1338,7 +1411,7 @@ lock_rec_get_prev(
 	ulint	page_no;
 	lock_t*	found_lock	= NULL;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 
 	space = in_lock->un_member.rec_lock.space;
@@ -1378,7 +1451,12 @@ lock_table_has(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	/* The table lock queues are only modified while holding
+	lock_sys->latch in exclusive mode. */
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(mutex_own(&kernel_mutex)
+	      || rw_lock_own(&lock_sys->latch, RW_LOCK_SHARED));
+#endif /* UNIV_SYNC_DEBUG */
 
 	/* Look for stronger locks the same trx already has on the table */
 
@@ -1425,7 +1503,7 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1478,7 +1556,7 @@ lock_rec_other_has_expl_req(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 	ut_ad(gap == 0 || gap == LOCK_GAP);
 	ut_ad(wait == 0 || wait == LOCK_WAIT);
@@ -1522,7 +1600,7 @@ lock_rec_other_has_conflicting(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = lock_rec_get_first(block, heap_no);
 
@@ -1567,7 +1645,7 @@ lock_rec_find_similar_on_page(
 	lock_t*		lock,		/*!< in: lock_rec_get_first_on_page() */
 	const trx_t*	trx)		/*!< in: transaction */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	while (lock != NULL) {
 		if (lock->trx == trx
@@ -1597,7 +1675,7 @@ lock_sec_rec_some_has_impl_off_kernel(
 {
 	const page_t*	page = page_align(rec);
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(!dict_index_is_clust(index));
 	ut_ad(page_rec_is_user_rec(rec));
 	ut_ad(rec_offs_validate(rec, index, offsets));
@@ -1689,7 +1767,7 @@ lock_rec_create(
 	ulint		n_bytes;
 	const page_t*	page;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 
 	space = buf_block_get_space(block);
 	page_no	= buf_block_get_page_no(block);
@@ -1772,7 +1850,7 @@ lock_rec_enqueue_waiting(
 {
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	/* Test if there already is some other reason to suspend thread:
 	we do not enqueue a lock request if the query thread should be
@@ -1875,7 +1953,7 @@ lock_rec_add_to_queue(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 #ifdef UNIV_DEBUG
 	switch (type_mode & LOCK_MODE_MASK) {
 	case LOCK_X:
@@ -1986,7 +2064,7 @@ lock_rec_lock_fast(
 	lock_t*	lock;
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_rec_queue_own(buf_block_get_lock_hash_val(block)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2063,7 +2141,7 @@ lock_rec_lock_slow(
 	trx_t*	trx;
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2148,11 +2226,11 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(mutex_own(&kernel_mutex));
-	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
-	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
+	mutex_t*		mutex;
+	enum lock_rec_req_status	status;
+	enum db_err		err;
+
+	ut_ad(!mutex_own(&kernel_mutex));
 	ut_ad((LOCK_MODE_MASK & mode) == LOCK_S
 	      || (LOCK_MODE_MASK & mode) == LOCK_X);
 	ut_ad(mode - (LOCK_MODE_MASK & mode) == LOCK_GAP
@@ -2160,15 +2238,33 @@ lock_rec_lock(
 	      || mode - (LOCK_MODE_MASK & mode) == 0);
 
 	/* We try a simplified and faster subroutine for the most
-	common cases */
-	switch (lock_rec_lock_fast(impl, mode, block, heap_no, index, thr)) {
+	common cases. It only needs the lock system in shared mode
+	and the mutex of the rec_hash cell of the page. */
+
+	mutex = lock_rec_get_mutex(buf_block_get_lock_hash_val(block));
+
+	rw_lock_s_lock(&lock_sys->latch);
+	mutex_enter(mutex);
+
+	status = lock_rec_lock_fast(impl, mode, block, heap_no, index, thr);
+
+	mutex_exit(mutex);
+	rw_lock_s_unlock(&lock_sys->latch);
+
+	switch (status) {
 	case LOCK_REC_SUCCESS:
 		return(DB_SUCCESS);
 	case LOCK_REC_SUCCESS_CREATED:
 		return(DB_SUCCESS_LOCKED_REC);
 	case LOCK_REC_FAIL:
-		return(lock_rec_lock_slow(impl, mode, block,
-					  heap_no, index, thr));
+		lock_mutex_enter_kernel();
+
+		err = lock_rec_lock_slow(impl, mode, block,
+					 heap_no, index, thr);
+
+		lock_mutex_exit_kernel();
+
+		return(err);
 	}
 
 	ut_error;
@@ -2189,7 +2285,7 @@ lock_rec_has_to_wait_in_queue(
 	ulint	page_no;
 	ulint	heap_no;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
@@ -2222,7 +2318,7 @@ lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2269,7 +2365,7 @@ lock_rec_cancel(
 /*============*/
 	lock_t*	lock)	/*!< in: waiting record lock request */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 	ut_ad(!(lock->type_mode & LOCK_CONV_BY_OTHER));
 
@@ -2303,7 +2399,7 @@ lock_rec_dequeue_from_page(
 	lock_t*	lock;
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 
 	trx = in_lock->trx;
@@ -2346,7 +2442,7 @@ lock_rec_discard(
 	ulint	page_no;
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 
 	trx = in_lock->trx;
@@ -2375,7 +2471,7 @@ lock_rec_free_all_from_discard_page(
 	lock_t*	lock;
 	lock_t*	next_lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	space = buf_block_get_space(block);
 	page_no = buf_block_get_page_no(block);
@@ -2409,7 +2505,7 @@ lock_rec_reset_and_release_wait(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = lock_rec_get_first(block, heap_no);
 
@@ -2450,7 +2546,7 @@ lock_rec_inherit_to_gap(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = lock_rec_get_first(block, heap_no);
 
@@ -2495,7 +2591,7 @@ lock_rec_inherit_to_gap_if_gap_lock(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = lock_rec_get_first(block, heap_no);
 
@@ -2534,7 +2630,7 @@ lock_rec_move(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = lock_rec_get_first(donator, donator_heap_no);
 
@@ -3106,13 +3202,13 @@ lock_rec_reset_and_inherit_gap_locks(
 	ulint			heap_no)	/*!< in: heap_no of the
 						donating record */
 {
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	lock_rec_reset_and_release_wait(heir_block, heir_heap_no);
 
 	lock_rec_inherit_to_gap(heir_block, block, heir_heap_no, heap_no);
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 }
 
 /*************************************************************//**
@@ -3399,7 +3495,7 @@ lock_deadlock_occurs(
 
 	ut_ad(trx);
 	ut_ad(lock);
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 retry:
 	/* We check that adding this trx to the waits-for graph
 	does not produce a cycle. First mark all active transactions
@@ -3485,7 +3581,7 @@ lock_deadlock_recursive(
 	ut_a(trx);
 	ut_a(start);
 	ut_a(wait_lock);
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	if (trx->deadlock_mark == 1) {
 		/* We have already exhaustively searched the subtree starting
@@ -3691,7 +3787,7 @@ lock_table_create(
 	lock_t*	lock;
 
 	ut_ad(table && trx);
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(!(type_mode & LOCK_CONV_BY_OTHER));
 
 	if ((type_mode & LOCK_MODE_MASK) == LOCK_AUTO_INC) {
@@ -3739,7 +3835,7 @@ lock_table_pop_autoinc_locks(
 /*=========================*/
 	trx_t*	trx)	/*!< in/out: transaction that owns the AUTOINC locks */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(!ib_vector_is_empty(trx->autoinc_locks));
 
 	/* Skip any gaps, gaps are NULL lock entries in the
@@ -3767,7 +3863,7 @@ lock_table_remove_autoinc_lock(
 	lock_t*	autoinc_lock;
 	lint	i = ib_vector_size(trx->autoinc_locks) - 1;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_mode(lock) == LOCK_AUTO_INC);
 	ut_ad(lock_get_type_low(lock) & LOCK_TABLE);
 	ut_ad(!ib_vector_is_empty(trx->autoinc_locks));
@@ -3816,7 +3912,7 @@ lock_table_remove_low(
 	trx_t*		trx;
 	dict_table_t*	table;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	trx = lock->trx;
 	table = lock->un_member.tab_lock.table;
@@ -3873,7 +3969,7 @@ lock_table_enqueue_waiting(
 	lock_t*	lock;
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	/* Test if there already is some other reason to suspend thread:
 	we do not enqueue a lock request if the query thread should be
@@ -3955,7 +4051,7 @@ lock_table_other_has_incompatible(
 {
 	const lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = UT_LIST_GET_LAST(table->locks);
 
@@ -3990,6 +4086,7 @@ lock_table(
 {
 	trx_t*	trx;
 	ulint	err;
+	lock_t*	lock;
 
 	ut_ad(table && thr);
 
@@ -4002,17 +4099,21 @@ lock_table(
 
 	trx = thr_get_trx(thr);
 
-	lock_mutex_enter_kernel();
-
-	/* Look for stronger locks the same trx already has on the table */
+	/* Look for stronger locks the same trx already has on the table.
+	Only this thread can add table locks for trx, so the answer cannot
+	change after the latch is released. */
 
-	if (lock_table_has(trx, table, mode)) {
+	rw_lock_s_lock(&lock_sys->latch);
+	lock = lock_table_has(trx, table, mode);
+	rw_lock_s_unlock(&lock_sys->latch);
 
-		lock_mutex_exit_kernel();
+	if (lock) {
 
 		return(DB_SUCCESS);
 	}
 
+	lock_mutex_enter_kernel();
+
 	/* We have to check if the new lock is compatible with any locks
 	other transactions have in the table lock queue. */
 
@@ -4049,7 +4150,7 @@ lock_table_has_to_wait_in_queue(
 	const dict_table_t*	table;
 	const lock_t*		lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(lock_get_wait(wait_lock));
 
 	table = wait_lock->un_member.tab_lock.table;
@@ -4083,7 +4184,7 @@ lock_table_dequeue(
 {
 	lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_a(lock_get_type_low(in_lock) == LOCK_TABLE);
 
 	lock = UT_LIST_GET_NEXT(un_member.tab_lock.locks, in_lock);
@@ -4132,7 +4233,7 @@ lock_rec_unlock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	first_lock = lock_rec_get_first(block, heap_no);
 
@@ -4148,7 +4249,7 @@ lock_rec_unlock(
 		}
 	}
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 	ut_print_timestamp(stderr);
 	fprintf(stderr,
 		"  InnoDB: Error: unlock row could not"
@@ -4170,7 +4271,7 @@ released:
 		}
 	}
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 }
 
 /*********************************************************************//**
@@ -4186,7 +4287,7 @@ lock_release_off_kernel(
 	ulint		count;
 	lock_t*		lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = UT_LIST_GET_LAST(trx->trx_locks);
 
@@ -4246,7 +4347,7 @@ lock_cancel_waiting_and_release(
 /*============================*/
 	lock_t*	lock)	/*!< in: waiting lock request */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_ad(!(lock->type_mode & LOCK_CONV_BY_OTHER));
 
 	if (lock_get_type_low(lock) == LOCK_REC) {
@@ -4295,7 +4396,7 @@ lock_remove_all_on_table_for_trx(
 	lock_t*	lock;
 	lock_t*	prev_lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = UT_LIST_GET_LAST(trx->trx_locks);
 
@@ -4338,7 +4439,7 @@ lock_remove_all_on_table(
 	lock_t*	lock;
 	lock_t*	prev_lock;
 
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	lock = UT_LIST_GET_FIRST(table->locks);
 
@@ -4383,7 +4484,7 @@ lock_remove_all_on_table(
 		}
 	}
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 }
 
 /*===================== VALIDATION AND DEBUGGING  ====================*/
@@ -4397,7 +4498,7 @@ lock_table_print(
 	FILE*		file,	/*!< in: file where to print */
 	const lock_t*	lock)	/*!< in: table type lock */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_a(lock_get_type_low(lock) == LOCK_TABLE);
 
 	fputs("TABLE LOCK table ", file);
@@ -4446,7 +4547,7 @@ lock_rec_print(
 	ulint*			offsets		= offsets_;
 	rec_offs_init(offsets_);
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_a(lock_get_type_low(lock) == LOCK_REC);
 
 	space = lock->un_member.rec_lock.space;
@@ -4539,7 +4640,7 @@ lock_get_n_rec_locks(void)
 	ulint	n_locks	= 0;
 	ulint	i;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	for (i = 0; i < hash_get_n_cells(lock_sys->rec_hash); i++) {
 
@@ -4576,6 +4677,8 @@ lock_print_info_summary(
 		fputs("FAIL TO OBTAIN KERNEL MUTEX, "
 		      "SKIP LOCK INFO PRINTING\n", file);
 		return(FALSE);
+	} else {
+		rw_lock_x_lock(&lock_sys->latch);
 	}
 
 	if (lock_deadlock_found) {
@@ -4603,6 +4706,13 @@ lock_print_info_summary(
 		"History list length %lu\n",
 		(ulong) trx_sys->rseg_history_len);
 
+	fprintf(file,
+		"Purge lag %ld/s, %lu undo log records purged/s,"
+		" %lu purge threads\n",
+		(long) purge_sys->lag_per_sec,
+		(ulong) purge_sys->recs_per_sec,
+		(ulong) srv_n_purge_threads);
+
 #ifdef PRINT_NUM_OF_LOCK_STRUCTS
 	fprintf(file,
 		"Total number of lock structs in row lock hash table %lu\n",
@@ -4669,6 +4779,10 @@ loop:
 		fputs("---", file);
 		trx_print(file, trx, 600);
 
+		/* The read view of a transaction can be closed without
+		the kernel mutex, see read_view_close_for_mysql() */
+		mutex_enter(&trx_sys->read_view_mutex);
+
 		if (trx->read_view) {
 			fprintf(file,
 				"Trx read view will not see trx with"
@@ -4678,6 +4792,8 @@ loop:
 				(ullint) trx->read_view->up_limit_id);
 		}
 
+		mutex_exit(&trx_sys->read_view_mutex);
+
 		if (trx->que_state == TRX_QUE_LOCK_WAIT) {
 			fprintf(file,
 				"------- TRX HAS BEEN WAITING %lu SEC"
@@ -4793,7 +4909,7 @@ lock_table_queue_validate(
 {
 	const lock_t*	lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	lock = UT_LIST_GET_FIRST(table->locks);
 
@@ -5085,7 +5201,7 @@ lock_rec_validate(
 					(space, page_no) */
 {
 	lock_t*		lock;
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	for (lock = HASH_GET_FIRST(lock_sys->rec_hash, start);
 	     lock != NULL;
@@ -5231,6 +5347,7 @@ lock_rec_insert_check_and_lock(
 	lock_t*		lock;
 	ulint		err;
 	ulint		next_rec_heap_no;
+	mutex_t*	mutex;
 
 	ut_ad(block->frame == page_align(rec));
 
@@ -5242,8 +5359,10 @@ lock_rec_insert_check_and_lock(
 	trx = thr_get_trx(thr);
 	next_rec = page_rec_get_next_const(rec);
 	next_rec_heap_no = page_rec_get_heap_no(next_rec);
+	mutex = lock_rec_get_mutex(buf_block_get_lock_hash_val(block));
 
-	lock_mutex_enter_kernel();
+	rw_lock_s_lock(&lock_sys->latch);
+	mutex_enter(mutex);
 
 	/* When inserting a record into an index, the table must be at
 	least IX-locked or we must be building an index, in which case
@@ -5254,10 +5373,12 @@ lock_rec_insert_check_and_lock(
 
 	lock = lock_rec_get_first(block, next_rec_heap_no);
 
-	if (UNIV_LIKELY(lock == NULL)) {
-		/* We optimize CPU time usage in the simplest case */
+	mutex_exit(mutex);
+	rw_lock_s_unlock(&lock_sys->latch);
 
-		lock_mutex_exit_kernel();
+	if (UNIV_LIKELY(lock == NULL)) {
+		/* We optimize CPU time usage in the simplest case. No
+		lock can be set on next_rec while we hold the page latch. */
 
 		if (!dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -5283,6 +5404,8 @@ lock_rec_insert_check_and_lock(
 	had to wait for their insert. Both had waiting gap type lock requests
 	on the successor, which produced an unnecessary deadlock. */
 
+	lock_mutex_enter_kernel();
+
 	if (lock_rec_other_has_conflicting(
 		    LOCK_X | LOCK_GAP | LOCK_INSERT_INTENTION,
 		    block, next_rec_heap_no, trx)) {
@@ -5334,8 +5457,8 @@ lock_rec_insert_check_and_lock(
 
 /*********************************************************************//**
 If a transaction has an implicit x-lock on a record, but no explicit x-lock
-set on the record, sets one for it. NOTE that in the case of a secondary
-index, the kernel mutex may get temporarily released. */
+set on the record, sets one for it. The lock system is only reserved if
+an active transaction may have modified the record. */
 static
 void
 lock_rec_convert_impl_to_expl(
@@ -5346,12 +5469,38 @@ lock_rec_convert_impl_to_expl(
 	const ulint*		offsets)/*!< in: rec_get_offsets(rec, index) */
 {
 	trx_t*	impl_trx;
+	ibool	may_have_impl;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(!mutex_own(&kernel_mutex));
 	ut_ad(page_rec_is_user_rec(rec));
 	ut_ad(rec_offs_validate(rec, index, offsets));
 	ut_ad(!page_rec_is_comp(rec) == !rec_offs_comp(offsets));
 
+	/* No transaction can get an implicit lock on the record while
+	the caller holds the page latch: if no active transaction may
+	have modified it, there is nothing to convert. See also
+	lock_sec_rec_some_has_impl_off_kernel(). */
+
+	mutex_enter(&trx_sys->mutex);
+
+	if (dict_index_is_clust(index)) {
+		may_have_impl = trx_is_active(
+			row_get_rec_trx_id(rec, index, offsets));
+	} else {
+		may_have_impl = page_get_max_trx_id(page_align(rec))
+			>= trx_list_get_min_trx_id()
+			|| recv_recovery_is_on();
+	}
+
+	mutex_exit(&trx_sys->mutex);
+
+	if (!may_have_impl) {
+
+		return;
+	}
+
+	lock_mutex_enter_kernel();
+
 	if (dict_index_is_clust(index)) {
 		impl_trx = lock_clust_rec_some_has_impl(rec, index, offsets);
 	} else {
@@ -5386,6 +5535,8 @@ lock_rec_convert_impl_to_expl(
 				type_mode, block, heap_no, index, impl_trx);
 		}
 	}
+
+	lock_mutex_exit_kernel();
 }
 
 /*********************************************************************//**
@@ -5425,10 +5576,6 @@ lock_clust_rec_modify_check_and_lock(
 		? rec_get_heap_no_new(rec)
 		: rec_get_heap_no_old(rec);
 
-	lock_mutex_enter_kernel();
-
-	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
-
 	/* If a transaction has no explicit x-lock set on the record, set one
 	for it */
 
@@ -5437,8 +5584,6 @@ lock_clust_rec_modify_check_and_lock(
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	lock_mutex_exit_kernel();
-
 	ut_ad(lock_rec_queue_validate(block, rec, index, offsets));
 
 	if (UNIV_UNLIKELY(err == DB_SUCCESS_LOCKED_REC)) {
@@ -5486,15 +5631,9 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter_kernel();
-
-	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
-
 	err = lock_rec_lock(TRUE, LOCK_X | LOCK_REC_NOT_GAP,
 			    block, heap_no, index, thr);
 
-	lock_mutex_exit_kernel();
-
 #ifdef UNIV_DEBUG
 	{
 		mem_heap_t*	heap		= NULL;
@@ -5568,20 +5707,7 @@ lock_sec_rec_read_check_and_lock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter_kernel();
-
-	ut_ad(mode != LOCK_X
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
-	ut_ad(mode != LOCK_S
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
-
-	/* Some transaction may have an implicit x-lock on the record only
-	if the max trx id for the page >= min trx id for the trx list or a
-	database recovery is running. */
-
-	if ((page_get_max_trx_id(block->frame) >= trx_list_get_min_trx_id()
-	     || recv_recovery_is_on())
-	    && !page_rec_is_supremum(rec)) {
+	if (!page_rec_is_supremum(rec)) {
 
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
@@ -5589,8 +5715,6 @@ lock_sec_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	lock_mutex_exit_kernel();
-
 	ut_ad(lock_rec_queue_validate(block, rec, index, offsets));
 
 	return(err);
@@ -5644,13 +5768,6 @@ lock_clust_rec_read_check_and_lock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter_kernel();
-
-	ut_ad(mode != LOCK_X
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
-	ut_ad(mode != LOCK_S
-	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
-
 	if (UNIV_LIKELY(heap_no != PAGE_HEAP_NO_SUPREMUM)) {
 
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
@@ -5659,8 +5776,6 @@ lock_clust_rec_read_check_and_lock(
 	err = lock_rec_lock(FALSE, mode | gap_mode,
 			    block, heap_no, index, thr);
 
-	lock_mutex_exit_kernel();
-
 	ut_ad(lock_rec_queue_validate(block, rec, index, offsets));
 
 	return(err);
@@ -5728,7 +5843,7 @@ lock_release_autoinc_last_lock(
 	ulint		last;
 	lock_t*		lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 	ut_a(!ib_vector_is_empty(autoinc_locks));
 
 	/* The lock to be release must be the last lock acquired. */
@@ -5767,7 +5882,7 @@ lock_release_autoinc_locks(
 /*=======================*/
 	trx_t*		trx)		/*!< in/out: transaction */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 
 	ut_a(trx->autoinc_locks != NULL);
 
@@ -40,6 +40,9 @@ Created 12/9/1995 Heikki Tuuri
 #include "mem0mem.h"
 #include "buf0buf.h"
 #include "buf0flu.h"
+#include "buf0dump.h"
+#include "dict0stats.h"
+#include "ibuf0ibuf.h"
 #include "srv0srv.h"
 #include "log0recv.h"
 #include "fil0fil.h"
@@ -191,8 +194,8 @@ log_fsp_current_free_limit_set_and_checkpoint(
 }
 
 /****************************************************************//**
-Returns the oldest modified block lsn in the pool, or log_sys->lsn if none
-exists.
+Returns the oldest modified block lsn in the pool, or log_sys->closed_lsn if
+none exists or it is older.
 @return	LSN of oldest modification */
 static
 ib_uint64_t
@@ -200,19 +203,127 @@ log_buf_pool_get_oldest_modification(void)
 /*======================================*/
 {
 	ib_uint64_t	lsn;
+	ib_uint64_t	closed_lsn;
 
 	ut_ad(mutex_own(&(log_sys->mutex)));
 
+	/* The mini-transactions that have reserved log but not yet
+	added their pages to the flush lists start at closed_lsn or
+	later. Read it first, so that it cannot include pages that were
+	added after the flush lists were scanned. */
+	log_flush_order_mutex_enter();
+	closed_lsn = log_sys->closed_lsn;
+	log_flush_order_mutex_exit();
+
 	lsn = buf_pool_get_oldest_modification();
 
-	if (!lsn) {
+	if (!lsn || lsn > closed_lsn) {
 
-		lsn = log_sys->lsn;
+		lsn = closed_lsn;
 	}
 
 	return(lsn);
 }
 
+/****************************************************************//**
+Waits until the log records of all the mini-transactions that reserved
+space in the log buffer before lsn have been copied there, and their pages
+have been added to the flush lists. Spins for a while, as the wait is
+normally for a copy that is in progress, and then sleeps on
+log_sys->closed_event. Returns with log_flush_order_mutex held. */
+static
+void
+log_closed_lsn_wait(
+/*================*/
+	ib_uint64_t	lsn)	/*!< in: lsn to wait for */
+{
+	ulint		i;
+	ib_int64_t	sig_count;
+
+	for (;;) {
+		for (i = 0; i < SYNC_SPIN_ROUNDS; i++) {
+			/* A dirty read, to keep the spinning threads from
+			competing for the mutex with the one that they
+			wait for. */
+			if (log_sys->closed_lsn >= lsn) {
+
+				break;
+			}
+
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		}
+
+		log_flush_order_mutex_enter();
+
+		if (log_sys->closed_lsn >= lsn) {
+
+			return;
+		}
+
+		/* The event is reset while holding the mutex under which
+		log_flush_order_close() sets it, so no wakeup is lost. */
+		sig_count = os_event_reset(log_sys->closed_event);
+		log_sys->n_closed_waiters++;
+		log_flush_order_mutex_exit();
+
+		os_event_wait_low(log_sys->closed_event, sig_count);
+
+		log_flush_order_mutex_enter();
+		log_sys->n_closed_waiters--;
+
+		if (log_sys->closed_lsn >= lsn) {
+
+			return;
+		}
+
+		log_flush_order_mutex_exit();
+	}
+}
+
+/****************************************************************//**
+Waits until the log records of every reservation in the log buffer have
+been copied there. The caller must hold the log mutex, which keeps new
+reservations out, before it writes or moves the log buffer up to
+buf_free. */
+static
+void
+log_wait_for_closed(void)
+/*=====================*/
+{
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	log_closed_lsn_wait(log_sys->lsn);
+	log_flush_order_mutex_exit();
+}
+
+/****************************************************************//**
+Returns the age of the oldest modification in the buffer pool, that is, how
+far log_checkpoint_margin() is from having to preflush pages.
+@return	log_sys->lsn minus the oldest modification lsn in the buffer pool */
+UNIV_INTERN
+ib_uint64_t
+log_get_modified_age(
+/*=================*/
+	ib_uint64_t*	oldest_lsn,	/*!< out: oldest modification lsn in
+					the buffer pool, or log_sys->lsn if
+					there are no dirty pages */
+	ib_uint64_t*	age_async)	/*!< out: age above which user threads
+					do an asynchronous preflush */
+{
+	ib_uint64_t	age;
+
+	mutex_enter(&(log_sys->mutex));
+
+	*oldest_lsn = log_buf_pool_get_oldest_modification();
+	*age_async = log_sys->max_modified_age_async;
+
+	age = log_sys->lsn - *oldest_lsn;
+
+	mutex_exit(&(log_sys->mutex));
+
+	return(age);
+}
+
 /** Extends the log buffer.
 @param[in] len	requested minimum size in bytes */
 static
@@ -257,6 +368,8 @@ log_buffer_extend(
 		mutex_enter(&(log_sys->mutex));
 	}
 
+	log_wait_for_closed();
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -293,8 +406,8 @@ log_buffer_extend(
 }
 
 /************************************************************//**
-Opens the log for log_write_low. The log must be closed with log_close and
-released with log_release.
+Opens the log for log_reserve_low or log_write_low. The log must be closed
+with log_close and released with log_release.
 @return	start lsn of the log record */
 UNIV_INTERN
 ib_uint64_t
@@ -396,21 +509,27 @@ loop:
 }
 
 /************************************************************//**
-Writes to the log the string given. It is assumed that the caller holds the
-log mutex. */
+Reserves space for a string in the log buffer, and advances the lsn past
+it. The headers of the log blocks that the string spans are written, but
+the string itself is not: that is done by log_write_reserved(), which
+does not need the log mutex. It is assumed that the caller holds the log
+mutex.
+@return	offset of the reserved space in the log buffer */
 UNIV_INTERN
-void
-log_write_low(
-/*==========*/
-	byte*	str,		/*!< in: string */
+ulint
+log_reserve_low(
+/*============*/
 	ulint	str_len)	/*!< in: string length */
 {
 	log_t*	log	= log_sys;
+	ulint	offset;
 	ulint	len;
 	ulint	data_len;
 	byte*	log_block;
 
 	ut_ad(mutex_own(&(log->mutex)));
+
+	offset = log->buf_free;
 part_loop:
 	ut_ad(!recv_no_log_write);
 	/* Calculate a part length */
@@ -430,10 +549,7 @@ part_loop:
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
-
 	str_len -= len;
-	str = str + len;
 
 	log_block = ut_align_down(log->buf + log->buf_free,
 				  OS_FILE_LOG_BLOCK_SIZE);
@@ -463,6 +579,107 @@ part_loop:
 	}
 
 	srv_log_write_requests++;
+
+	return(offset);
+}
+
+/************************************************************//**
+Copies a string to space reserved with log_reserve_low(), skipping the
+log block headers and trailers. The caller need not hold the log mutex:
+the log buffer is not written or moved before log_flush_order_close() has
+been called for the reservation.
+@return	offset in the log buffer after the string */
+UNIV_INTERN
+ulint
+log_write_reserved(
+/*===============*/
+	ulint		offset,	/*!< in: offset in the log buffer */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len)/*!< in: string length */
+{
+	while (str_len > 0) {
+		ulint	len;
+
+		len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (len > str_len) {
+			len = str_len;
+		}
+
+		ut_memcpy(log_sys->buf + offset, str, len);
+
+		str += len;
+		str_len -= len;
+		offset += len;
+
+		if (offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip to the data of the next block */
+			offset += LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		}
+	}
+
+	ut_ad(offset <= log_sys->buf_size);
+
+	return(offset);
+}
+
+/************************************************************//**
+Writes to the log the string given. It is assumed that the caller holds the
+log mutex. */
+UNIV_INTERN
+void
+log_write_low(
+/*==========*/
+	byte*	str,		/*!< in: string */
+	ulint	str_len)	/*!< in: string length */
+{
+	log_write_reserved(log_reserve_low(str_len), str, str_len);
+}
+
+/************************************************************//**
+Waits until the log records of all the mini-transactions that reserved
+log before start_lsn have been copied to the log buffer, and their pages
+have been added to the flush lists, and acquires log_flush_order_mutex.
+This keeps the flush lists ordered by oldest_modification, although the
+log records are copied concurrently. */
+UNIV_INTERN
+void
+log_flush_order_wait(
+/*=================*/
+	ib_uint64_t	start_lsn)	/*!< in: start lsn of the log
+					records of the mini-transaction */
+{
+	ut_ad(!mutex_own(&(log_sys->mutex)));
+
+	log_closed_lsn_wait(start_lsn);
+}
+
+/************************************************************//**
+Marks the log records up to end_lsn as copied to the log buffer, after
+the pages that they modified have been added to the flush lists, and
+releases log_flush_order_mutex. */
+UNIV_INTERN
+void
+log_flush_order_close(
+/*==================*/
+	ib_uint64_t	end_lsn)	/*!< in: end lsn of the log
+					records of the mini-transaction */
+{
+	ut_ad(log_flush_order_mutex_own());
+
+	/* Mini-transactions that wrote no log end where they start,
+	and may close after the one that follows them. */
+	if (end_lsn > log_sys->closed_lsn) {
+		log_sys->closed_lsn = end_lsn;
+
+		if (log_sys->n_closed_waiters) {
+			os_event_set(log_sys->closed_event);
+		}
+	}
+
+	log_flush_order_mutex_exit();
 }
 
 /************************************************************//**
@@ -548,12 +765,6 @@ log_close(void)
 		log->check_flush_or_checkpoint = TRUE;
 	}
 function_exit:
-
-#ifdef UNIV_LOG_DEBUG
-	log_check_log_recs(log->buf + log->old_buf_free,
-			   log->buf_free - log->old_buf_free, log->old_lsn);
-#endif
-
 	return(lsn);
 }
 
@@ -569,10 +780,10 @@ log_pad_current_log_block(void)
 	byte		b		= MLOG_DUMMY_RECORD;
 	ulint		pad_length;
 	ulint		i;
+	ib_uint64_t	start_lsn;
 	ib_uint64_t	lsn;
 
-	/* We retrieve lsn only because otherwise gcc crashed on HP-UX */
-	lsn = log_reserve_and_open(OS_FILE_LOG_BLOCK_SIZE);
+	start_lsn = log_reserve_and_open(OS_FILE_LOG_BLOCK_SIZE);
 
 	pad_length = OS_FILE_LOG_BLOCK_SIZE
 		- (log_sys->buf_free % OS_FILE_LOG_BLOCK_SIZE)
@@ -587,6 +798,11 @@ log_pad_current_log_block(void)
 	log_close();
 	log_release();
 
+	/* The padding modifies no pages, but it must be closed in order,
+	like any reservation in the log buffer. */
+	log_flush_order_wait(start_lsn);
+	log_flush_order_close(lsn);
+
 	ut_a(lsn % OS_FILE_LOG_BLOCK_SIZE == LOG_BLOCK_HDR_SIZE);
 }
 #endif /* UNIV_LOG_ARCHIVE */
@@ -881,6 +1097,9 @@ log_init(void)
 		     &log_sys->log_flush_order_mutex,
 		     SYNC_LOG_FLUSH_ORDER);
 
+	log_sys->closed_event = os_event_create(NULL);
+	log_sys->n_closed_waiters = 0;
+
 	mutex_enter(&(log_sys->mutex));
 
 	/* Start the lsn from one log block from zero: this way every
@@ -976,6 +1195,7 @@ log_init(void)
 
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = LOG_START_LSN + LOG_BLOCK_HDR_SIZE;
+	log_sys->closed_lsn = log_sys->lsn;
 
 	mutex_exit(&(log_sys->mutex));
 
@@ -1164,6 +1384,8 @@ log_sys_check_flush_completion(void)
 			/* Move the log buffer content to the start of the
 			buffer */
 
+			log_wait_for_closed();
+
 			move_start = ut_calc_align_down(
 				log_sys->write_end_offset,
 				OS_FILE_LOG_BLOCK_SIZE);
@@ -1532,6 +1754,10 @@ loop:
 		goto loop;
 	}
 
+	/* The mini-transactions that have reserved space in the log
+	buffer may still be copying their log records there. */
+	log_wait_for_closed();
+
 	if (!flush_to_disk
 	    && log_sys->buf_free == log_sys->buf_next_to_write) {
 		/* Nothing to write and no flush to disk requested */
@@ -1774,6 +2000,12 @@ log_preflush_pool_modified_pages(
 		return(FALSE);
 	}
 
+	if (sync) {
+		srv_buf_pool_flushed_sync += n_pages;
+	} else {
+		srv_buf_pool_flushed_async += n_pages;
+	}
+
 	return(TRUE);
 }
 
@@ -2257,7 +2489,12 @@ loop:
 
 	mutex_exit(&(log->mutex));
 
-	if (advance) {
+	if (advance && !sync && buf_page_cleaner_is_active) {
+
+		/* A flush is not urgent: leave it to the page cleaner */
+		os_event_set(buf_flush_event);
+
+	} else if (advance) {
 		ib_uint64_t	new_oldest = oldest_lsn + advance;
 
 		success = log_preflush_pool_modified_pages(new_oldest, sync);
@@ -3211,7 +3448,11 @@ loop:
 
 	if (srv_error_monitor_active
 	    || srv_lock_timeout_active
-	    || srv_monitor_active) {
+	    || srv_monitor_active
+	    || buf_page_cleaner_is_active
+	    || buf_dump_thread_active
+	    || dict_stats_thread_active
+	    || ibuf_merge_thread_active) {
 		const char*	thread_active = NULL;
 
 		/* Print a message every 60 seconds if we are waiting
@@ -3225,6 +3466,14 @@ loop:
 			       thread_active = "srv_lock_timeout thread";
 		       } else if (srv_monitor_active) {
 			       thread_active = "srv_monitor_thread";
+		       } else if (buf_page_cleaner_is_active) {
+			       thread_active = "page_cleaner thread";
+		       } else if (buf_dump_thread_active) {
+			       thread_active = "buf_dump thread";
+		       } else if (dict_stats_thread_active) {
+			       thread_active = "dict_stats thread";
+		       } else if (ibuf_merge_thread_active) {
+			       thread_active = "ibuf_merge thread";
 		       }
 		}
 
@@ -3233,6 +3482,10 @@ loop:
 		os_event_set(srv_error_event);
 		os_event_set(srv_monitor_event);
 		os_event_set(srv_timeout_event);
+		os_event_set(buf_flush_event);
+		os_event_set(buf_dump_event);
+		os_event_set(dict_stats_event);
+		os_event_set(ibuf_merge_event);
 
 		if (thread_active) {
 			ut_print_timestamp(stderr);
@@ -3650,6 +3903,7 @@ log_shutdown(void)
 
 	os_event_free(log_sys->no_flush_event);
 	os_event_free(log_sys->one_flushed_event);
+	os_event_free(log_sys->closed_event);
 
 	rw_lock_free(&log_sys->checkpoint_lock);
 
@@ -49,6 +49,7 @@ Created 9/20/1997 Heikki Tuuri
 # include "trx0roll.h"
 # include "row0merge.h"
 # include "sync0sync.h"
+# include "ut0sort.h"
 #else /* !UNIV_HOTBACKUP */
 
 /** This is set to FALSE if the backup was originally taken with the
@@ -61,8 +62,9 @@ UNIV_INTERN ibool	recv_replay_file_ops	= TRUE;
 this must be less than UNIV_PAGE_SIZE as it is stored in the buffer pool */
 #define RECV_DATA_BLOCK_SIZE	(MEM_MAX_ALLOC_IN_BUF - sizeof(recv_data_t))
 
-/** Read-ahead area in applying log records to file pages */
-#define RECV_READ_AHEAD_AREA	32
+/** Maximum number of pages read in one batch in applying log records to
+file pages */
+#define RECV_READ_BATCH_SIZE	256
 
 /** The recovery system */
 UNIV_INTERN recv_sys_t*	recv_sys = NULL;
@@ -1685,57 +1687,177 @@ recv_recover_page_func(
 }
 
 #ifndef UNIV_HOTBACKUP
+/*********************************************************************//**
+Compares two hashed file addresses by (space, page_no).
+@return	1 if a is bigger, 0 if equal, -1 if b is bigger */
+UNIV_INLINE
+int
+recv_addr_cmp(
+/*==========*/
+	const recv_addr_t*	a,	/*!< in: file address */
+	const recv_addr_t*	b)	/*!< in: file address */
+{
+	if (a->space != b->space) {
+		return(a->space > b->space ? 1 : -1);
+	}
+
+	if (a->page_no != b->page_no) {
+		return(a->page_no > b->page_no ? 1 : -1);
+	}
+
+	return(0);
+}
+
+/*********************************************************************//**
+Sorts an array of hashed file addresses by (space, page_no). */
+static
+void
+recv_addr_sort(
+/*===========*/
+	recv_addr_t**	arr,	/*!< in/out: array to sort */
+	recv_addr_t**	aux_arr,/*!< in/out: work area */
+	ulint		low,	/*!< in: lower bound of the sorting area,
+				inclusive */
+	ulint		high)	/*!< in: upper bound of the sorting area,
+				exclusive */
+{
+	UT_SORT_FUNCTION_BODY(recv_addr_sort, arr, aux_arr, low, high,
+			      recv_addr_cmp);
+}
+
 /*******************************************************************//**
-Reads in pages which have hashed log records, from an area around a given
-page number.
-@return	number of pages found */
+Applies the hashed log records to the pages of an apply batch that were
+in the buffer pool when the batch started. The pages are partitioned
+among the recv_apply_thread() threads by (space, page_no), so that each
+page is applied by one thread only.
+@return	a dummy parameter */
 static
-ulint
-recv_read_in_area(
+os_thread_ret_t
+recv_apply_thread(
 /*==============*/
-	ulint	space,	/*!< in: space */
-	ulint	zip_size,/*!< in: compressed page size in bytes, or 0 */
-	ulint	page_no)/*!< in: page number */
+	void*	arg)	/*!< in: pointer to the number of this thread */
 {
-	recv_addr_t* recv_addr;
-	ulint	page_nos[RECV_READ_AHEAD_AREA];
-	ulint	low_limit;
-	ulint	n;
+	ulint	thread_no	= *(ulint*) arg;
+	ulint	i;
 
-	low_limit = page_no - (page_no % RECV_READ_AHEAD_AREA);
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
 
-	n = 0;
+	for (i = 0; i < recv_sys->n_apply_addrs; i++) {
+		recv_addr_t*	recv_addr = recv_sys->apply_addrs[i];
+		ulint		space = recv_addr->space;
+		ulint		page_no = recv_addr->page_no;
+		ulint		state;
+		buf_block_t*	block;
+		mtr_t		mtr;
 
-	for (page_no = low_limit; page_no < low_limit + RECV_READ_AHEAD_AREA;
-	     page_no++) {
-		recv_addr = recv_get_fil_addr_struct(space, page_no);
+		if (recv_fold(space, page_no) % recv_sys->n_apply_threads
+		    != thread_no) {
 
-		if (recv_addr && !buf_page_peek(space, page_no)) {
+			continue;
+		}
 
-			mutex_enter(&(recv_sys->mutex));
+		mutex_enter(&(recv_sys->mutex));
+		state = recv_addr->state;
+		mutex_exit(&(recv_sys->mutex));
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				recv_addr->state = RECV_BEING_READ;
+		if (state != RECV_NOT_PROCESSED) {
+			/* The page was evicted and read in again, and
+			the log records were applied by the i/o-handler */
 
-				page_nos[n] = page_no;
+			continue;
+		}
 
-				n++;
-			}
+		mtr_start(&mtr);
+
+		block = buf_page_get(space, fil_space_get_zip_size(space),
+				     page_no, RW_X_LATCH, &mtr);
+		buf_block_dbg_add_level(block, SYNC_NO_ORDER_CHECK);
+
+		recv_recover_page(FALSE, block);
+		mtr_commit(&mtr);
+	}
+
+	mutex_enter(&(recv_sys->mutex));
+	ut_a(recv_sys->n_apply_threads_active > 0);
+	recv_sys->n_apply_threads_active--;
+	mutex_exit(&(recv_sys->mutex));
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Issues reads for the pages of an apply batch which are not in the buffer
+pool, in batches of consecutive entries of the sorted array. The log
+records are applied by the i/o-handler threads when the reads complete.
+@return	number of pages read */
+static
+ulint
+recv_read_in_batches(
+/*=================*/
+	recv_addr_t**	addrs,	/*!< in: file addresses, sorted by
+				(space, page_no) */
+	ulint		n_addrs)/*!< in: number of elements in addrs */
+{
+	ulint	page_nos[RECV_READ_BATCH_SIZE];
+	ulint	space	= ULINT_UNDEFINED;
+	ulint	zip_size = 0;
+	ulint	n	= 0;
+	ulint	n_read	= 0;
+	ulint	i;
+
+	for (i = 0; i < n_addrs; i++) {
+		recv_addr_t*	recv_addr = addrs[i];
+
+		if (n > 0 && (recv_addr->space != space
+			      || n == RECV_READ_BATCH_SIZE)) {
+
+			buf_read_recv_pages(FALSE, space, zip_size,
+					    page_nos, n);
+			n_read += n;
+			n = 0;
+		}
+
+		if (recv_addr->space != space) {
+			space = recv_addr->space;
+			zip_size = fil_space_get_zip_size(space);
+		}
+
+		if (buf_page_peek(space, recv_addr->page_no)) {
+
+			continue;
+		}
+
+		mutex_enter(&(recv_sys->mutex));
+
+		if (recv_addr->state == RECV_NOT_PROCESSED) {
+			recv_addr->state = RECV_BEING_READ;
 
-			mutex_exit(&(recv_sys->mutex));
+			page_nos[n++] = recv_addr->page_no;
 		}
+
+		mutex_exit(&(recv_sys->mutex));
 	}
 
-	buf_read_recv_pages(FALSE, space, zip_size, page_nos, n);
-	/*
-	fprintf(stderr, "Recv pages at %lu n %lu\n", page_nos[0], n);
-	*/
-	return(n);
+	if (n > 0) {
+		buf_read_recv_pages(FALSE, space, zip_size, page_nos, n);
+		n_read += n;
+	}
+
+	return(n_read);
 }
 
 /*******************************************************************//**
 Empties the hash table of stored log records, applying them to appropriate
-pages. */
+pages. The pages are read in sorted batches, and the log records are
+applied by the i/o-handler threads as the reads complete. The pages that
+already are in the buffer pool are applied by recv_apply_thread()
+threads, partitioned by (space, page_no). */
 UNIV_INTERN
 void
 recv_apply_hashed_log_recs(
@@ -1750,11 +1872,18 @@ recv_apply_hashed_log_recs(
 				the caller must in this case own the log
 				mutex */
 {
-	recv_addr_t* recv_addr;
-	ulint	i;
-	ulint	n_pages;
-	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
+	recv_addr_t*	recv_addr;
+	recv_addr_t**	addrs;
+	ulint		thread_nos[SRV_MAX_N_IO_THREADS];
+	ulint		n_total;
+	ulint		n_in_pool;
+	ulint		n_read;
+	ulint		n_done;
+	ulint		percent;
+	ulint		start_time;
+	ulint		elapsed;
+	ulint		i;
+	ulint		n_pages;
 loop:
 	mutex_enter(&(recv_sys->mutex));
 
@@ -1776,79 +1905,121 @@ loop:
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	n_total = recv_sys->n_addrs;
 
-		recv_addr = HASH_GET_FIRST(recv_sys->addr_hash, i);
+	if (n_total == 0) {
 
-		while (recv_addr) {
-			ulint	space = recv_addr->space;
-			ulint	zip_size = fil_space_get_zip_size(space);
-			ulint	page_no = recv_addr->page_no;
+		goto batch_done;
+	}
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ut_print_timestamp(stderr);
-					fputs("  InnoDB: Starting an"
-					      " apply batch of log records"
-					      " to the database...\n"
-					      "InnoDB: Progress in percents: ",
-					      stderr);
-					has_printed = TRUE;
-				}
+	start_time = ut_time_ms();
 
-				mutex_exit(&(recv_sys->mutex));
+	ut_print_timestamp(stderr);
+	fprintf(stderr,
+		"  InnoDB: Starting an apply batch of log records"
+		" to %lu pages of the database...\n",
+		(ulong) n_total);
 
-				if (buf_page_peek(space, page_no)) {
-					buf_block_t*	block;
+	/* Collect the pages of the batch, sorted by (space, page_no) */
 
-					mtr_start(&mtr);
+	addrs = ut_malloc(2 * n_total * sizeof *addrs);
 
-					block = buf_page_get(
-						space, zip_size, page_no,
-						RW_X_LATCH, &mtr);
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+	n_pages = 0;
 
-					recv_recover_page(FALSE, block);
-					mtr_commit(&mtr);
-				} else {
-					recv_read_in_area(space, zip_size,
-							  page_no);
-				}
+	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
 
-				mutex_enter(&(recv_sys->mutex));
-			}
+		for (recv_addr = HASH_GET_FIRST(recv_sys->addr_hash, i);
+		     recv_addr != NULL;
+		     recv_addr = HASH_GET_NEXT(addr_hash, recv_addr)) {
 
-			recv_addr = HASH_GET_NEXT(addr_hash, recv_addr);
+			if (recv_addr->state == RECV_NOT_PROCESSED) {
+				ut_a(n_pages < n_total);
+				addrs[n_pages++] = recv_addr;
+			}
 		}
+	}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
+	mutex_exit(&(recv_sys->mutex));
+
+	if (n_pages > 0) {
+		recv_addr_sort(addrs, addrs + n_total, 0, n_pages);
+	}
+
+	/* Hand the pages that are in the buffer pool to the apply
+	threads. They are put after the end of addrs, in the work area
+	of the sort. */
 
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
+	n_in_pool = 0;
+
+	for (i = 0; i < n_pages; i++) {
+		if (buf_page_peek(addrs[i]->space, addrs[i]->page_no)) {
+			addrs[n_total + n_in_pool++] = addrs[i];
 		}
 	}
 
+	recv_sys->apply_addrs = addrs + n_total;
+	recv_sys->n_apply_addrs = n_in_pool;
+	recv_sys->n_apply_threads = ut_min(srv_n_read_io_threads, n_in_pool);
+	recv_sys->n_apply_threads_active = recv_sys->n_apply_threads;
+
+	for (i = 0; i < recv_sys->n_apply_threads; i++) {
+		thread_nos[i] = i;
+		os_thread_create(recv_apply_thread, thread_nos + i, NULL);
+	}
+
+	/* Read in the other pages */
+
+	n_read = recv_read_in_batches(addrs, n_pages);
+
+	fprintf(stderr,
+		"InnoDB: %lu pages were read in, %lu pages are applied"
+		" by %lu threads\n"
+		"InnoDB: Progress in percents:",
+		(ulong) n_read, (ulong) n_in_pool,
+		(ulong) recv_sys->n_apply_threads);
+
 	/* Wait until all the pages have been processed */
 
-	while (recv_sys->n_addrs != 0) {
+	percent = 0;
+
+	mutex_enter(&(recv_sys->mutex));
+
+	while (recv_sys->n_addrs != 0
+	       || recv_sys->n_apply_threads_active != 0) {
+
+		n_done = n_total - recv_sys->n_addrs;
 
 		mutex_exit(&(recv_sys->mutex));
 
-		os_thread_sleep(500000);
+		for (; percent < (n_done * 100) / n_total; percent++) {
+			fprintf(stderr, " %lu", (ulong) percent);
+		}
+
+		os_thread_sleep(10000);
 
 		mutex_enter(&(recv_sys->mutex));
 	}
 
-	if (has_printed) {
-
-		fprintf(stderr, "\n");
+	for (; percent < 100; percent++) {
+		fprintf(stderr, " %lu", (ulong) percent);
 	}
 
+	recv_sys->apply_addrs = NULL;
+	recv_sys->n_apply_addrs = 0;
+	recv_sys->n_apply_threads = 0;
+
+	ut_free(addrs);
+
+	elapsed = ut_time_ms() - start_time;
+
+	fprintf(stderr,
+		"\nInnoDB: Applied log records to %lu pages"
+		" in %lu.%03lu seconds, %lu pages/s\n",
+		(ulong) n_total, (ulong) (elapsed / 1000),
+		(ulong) (elapsed % 1000),
+		(ulong) (n_total * 1000 / ut_max(elapsed, 1)));
+
+batch_done:
 	if (!allow_ibuf) {
 		/* Flush all the file pages to disk and invalidate them in
 		the buffer pool */
@@ -1857,10 +2028,10 @@ loop:
 		mutex_exit(&(recv_sys->mutex));
 		mutex_exit(&(log_sys->mutex));
 
- 		n_pages = buf_flush_list(ULINT_MAX, IB_ULONGLONG_MAX);
-  		ut_a(n_pages != ULINT_UNDEFINED);
-  
- 		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
+		n_pages = buf_flush_list(ULINT_MAX, IB_ULONGLONG_MAX);
+		ut_a(n_pages != ULINT_UNDEFINED);
+
+		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 
 		buf_pool_invalidate();
 
@@ -1876,7 +2047,7 @@ loop:
 
 	recv_sys_empty_hash();
 
-	if (has_printed) {
+	if (n_total > 0) {
 		fprintf(stderr, "InnoDB: Apply batch completed\n");
 	}
 
@@ -3218,6 +3389,7 @@ recv_recovery_from_checkpoint_start_func(
 	}
 
 	log_sys->lsn = recv_sys->recovered_lsn;
+	log_sys->closed_lsn = log_sys->lsn;
 
 	ut_memcpy(log_sys->buf, recv_sys->last_block, OS_FILE_LOG_BLOCK_SIZE);
 
@@ -3403,6 +3575,7 @@ recv_reset_logs(
 
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn += LOG_BLOCK_HDR_SIZE;
+	log_sys->closed_lsn = log_sys->lsn;
 
 	mutex_exit(&(log_sys->mutex));
 
@@ -185,6 +185,7 @@ mtr_log_reserve_and_write(
 	dyn_array_t*	mlog;
 	dyn_block_t*	block;
 	ulint		data_size;
+	ulint		offset		= 0;
 	byte*		first_data;
 
 	ut_ad(mtr);
@@ -206,26 +207,22 @@ mtr_log_reserve_and_write(
 			&mtr->start_lsn);
 		if (mtr->end_lsn) {
 
-			/* Success. We have the log mutex.
-			Add pages to flush list and exit */
+			/* Success. We have the log mutex, and the log
+			records are in the log buffer already. */
+			log_release();
+
 			goto func_exit;
 		}
 	}
 
 	data_size = dyn_array_get_data_size(mlog);
 
-	/* Open the database log for log_write_low */
+	/* Open the database log for log_reserve_low */
 	mtr->start_lsn = log_reserve_and_open(data_size);
 
 	if (mtr->log_mode == MTR_LOG_ALL) {
 
-		block = mlog;
-
-		while (block != NULL) {
-			log_write_low(dyn_block_get_data(block),
-				      dyn_block_get_used(block));
-			block = dyn_array_get_next_block(mlog, block);
-		}
+		offset = log_reserve_low(data_size);
 	} else {
 		ut_ad(mtr->log_mode == MTR_LOG_NONE);
 		/* Do nothing */
@@ -233,19 +230,42 @@ mtr_log_reserve_and_write(
 
 	mtr->end_lsn = log_close();
 
-func_exit:
-	log_flush_order_mutex_enter();
-
-	/* It is now safe to release the log mutex because the
-	flush_order mutex will ensure that we are the first one
-	to insert into the flush list. */
+	/* Only the reservation of the space is done while holding the
+	log mutex. The log records are copied after releasing it,
+	concurrently with the other mini-transactions. */
 	log_release();
 
+	if (mtr->log_mode == MTR_LOG_ALL) {
+#ifdef UNIV_LOG_DEBUG
+		ulint	start_offset	= offset;
+#endif /* UNIV_LOG_DEBUG */
+
+		block = mlog;
+
+		while (block != NULL) {
+			offset = log_write_reserved(
+				offset, dyn_block_get_data(block),
+				dyn_block_get_used(block));
+			block = dyn_array_get_next_block(mlog, block);
+		}
+
+#ifdef UNIV_LOG_DEBUG
+		log_check_log_recs(log_sys->buf + start_offset,
+				   offset - start_offset, mtr->start_lsn);
+#endif /* UNIV_LOG_DEBUG */
+	}
+
+func_exit:
+	/* Wait until the mini-transactions that reserved log before
+	this one have added their pages to the flush list, so that we
+	are the first one to insert into the flush list. */
+	log_flush_order_wait(mtr->start_lsn);
+
 	if (mtr->modifications) {
 		mtr_memo_note_modifications(mtr);
 	}
 
-	log_flush_order_mutex_exit();
+	log_flush_order_close(mtr->end_lsn);
 }
 #endif /* !UNIV_HOTBACKUP */
 
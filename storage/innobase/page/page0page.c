@@ -512,7 +512,8 @@ page_create_zip(
 	page = page_create_low(block, TRUE);
 	mach_write_to_2(page + PAGE_HEADER + PAGE_LEVEL, level);
 
-	if (UNIV_UNLIKELY(!page_zip_compress(page_zip, page, index, mtr))) {
+	if (UNIV_UNLIKELY(!page_zip_compress(page_zip, page, index,
+					     page_zip_level, mtr))) {
 		/* The compression of a newly created page
 		should always succeed. */
 		ut_error;
@@ -659,7 +660,8 @@ page_copy_rec_list_end(
 		mtr_set_log_mode(mtr, log_mode);
 
 		if (UNIV_UNLIKELY
-		    (!page_zip_compress(new_page_zip, new_page, index, mtr))) {
+		    (!page_zip_compress(new_page_zip, new_page, index,
+					page_zip_level, mtr))) {
 			/* Before trying to reorganize the page,
 			store the number of preceding records on the page. */
 			ulint	ret_pos
@@ -785,7 +787,8 @@ page_copy_rec_list_start(
 				goto zip_reorganize;);
 
 		if (UNIV_UNLIKELY
-		    (!page_zip_compress(new_page_zip, new_page, index, mtr))) {
+		    (!page_zip_compress(new_page_zip, new_page, index,
+					page_zip_level, mtr))) {
 			ulint	ret_pos;
 #ifndef DBUG_OFF
 zip_reorganize:
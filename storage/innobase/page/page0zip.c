@@ -36,6 +36,9 @@ Created June 2005 by Marko Makela
 #include "btr0cur.h"
 #include "page0types.h"
 #include "log0recv.h"
+#include "srv0srv.h"
+#include "ut0crc32.h"
+#include "ut0rbt.h"
 #include "zlib.h"
 #ifndef UNIV_HOTBACKUP
 # include "buf0lru.h"
@@ -50,6 +53,184 @@ Created June 2005 by Marko Makela
 #ifndef UNIV_HOTBACKUP
 /** Statistics on compression, indexed by page_zip_des_t::ssize - 1 */
 UNIV_INTERN page_zip_stat_t page_zip_stat[PAGE_ZIP_NUM_SSIZE - 1];
+/** Statistics on compression of each index, a tree of
+page_zip_stat_per_index_t ordered by index id, collected while
+srv_cmp_per_index_enabled is set; protected by
+page_zip_stat_per_index_mutex */
+static ib_rbt_t*	page_zip_stat_per_index;
+/** Mutex protecting page_zip_stat_per_index */
+static mutex_t		page_zip_stat_per_index_mutex;
+# ifdef UNIV_PFS_MUTEX
+/* Key to register the mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	page_zip_stat_per_index_mutex_key;
+# endif /* UNIV_PFS_MUTEX */
+#endif /* !UNIV_HOTBACKUP */
+
+/** zlib compression level of compressed pages (innodb_compression_level) */
+UNIV_INTERN uint	page_zip_level = DEFAULT_COMPRESSION_LEVEL;
+
+#ifndef UNIV_HOTBACKUP
+/**********************************************************************//**
+Compares the index ids of two page_zip_stat_per_index_t.
+@return	negative, 0 or positive if p1 is less than, equal to or greater
+than p2 */
+static
+int
+page_zip_stat_per_index_cmp(
+/*========================*/
+	const void*	p1,	/*!< in: page_zip_stat_per_index_t or index_id_t */
+	const void*	p2)	/*!< in: page_zip_stat_per_index_t */
+{
+	/* index_id is the first field of page_zip_stat_per_index_t */
+	index_id_t	id1 = *(const index_id_t*) p1;
+	index_id_t	id2 = *(const index_id_t*) p2;
+
+	return(id1 < id2 ? -1 : id1 > id2);
+}
+
+/**********************************************************************//**
+Creates the per-index compression statistics. */
+UNIV_INTERN
+void
+page_zip_stat_per_index_init(void)
+/*==============================*/
+{
+	mutex_create(page_zip_stat_per_index_mutex_key,
+		     &page_zip_stat_per_index_mutex, SYNC_ANY_LATCH);
+
+	page_zip_stat_per_index = rbt_create(
+		sizeof(page_zip_stat_per_index_t),
+		page_zip_stat_per_index_cmp);
+}
+
+/**********************************************************************//**
+Frees the per-index compression statistics. The mutex has been freed
+in sync_close(). */
+UNIV_INTERN
+void
+page_zip_stat_per_index_free(void)
+/*==============================*/
+{
+	rbt_free(page_zip_stat_per_index);
+	page_zip_stat_per_index = NULL;
+}
+
+/**********************************************************************//**
+Forgets the per-index compression statistics of all indexes. */
+UNIV_INTERN
+void
+page_zip_stat_per_index_reset(void)
+/*===============================*/
+{
+	mutex_enter(&page_zip_stat_per_index_mutex);
+	rbt_clear(page_zip_stat_per_index);
+	mutex_exit(&page_zip_stat_per_index_mutex);
+}
+
+/**********************************************************************//**
+Copies the per-index compression statistics, ordered by index id.
+@return	array of *n_stats elements, allocated from heap */
+UNIV_INTERN
+page_zip_stat_per_index_t*
+page_zip_stat_per_index_copy(
+/*=========================*/
+	mem_heap_t*	heap,		/*!< in: memory heap for the copy */
+	ibool		reset,		/*!< in: TRUE=reset the statistics */
+	ulint*		n_stats)	/*!< out: number of indexes */
+{
+	page_zip_stat_per_index_t*	stats;
+	const ib_rbt_node_t*		node;
+	ulint				i	= 0;
+
+	mutex_enter(&page_zip_stat_per_index_mutex);
+
+	*n_stats = rbt_size(page_zip_stat_per_index);
+
+	stats = mem_heap_alloc(heap, (1 + *n_stats) * sizeof *stats);
+
+	for (node = rbt_first(page_zip_stat_per_index);
+	     node != NULL;
+	     node = rbt_next(page_zip_stat_per_index, node)) {
+
+		stats[i++] = *rbt_value(page_zip_stat_per_index_t, node);
+	}
+
+	ut_ad(i == *n_stats);
+
+	if (reset) {
+		rbt_clear(page_zip_stat_per_index);
+	}
+
+	mutex_exit(&page_zip_stat_per_index_mutex);
+
+	return(stats);
+}
+
+/**********************************************************************//**
+Looks up the compression statistics of an index, adding them if the
+index has none yet.
+@return	compression statistics of the index */
+static
+page_zip_stat_t*
+page_zip_stat_per_index_get(
+/*========================*/
+	index_id_t	index_id)	/*!< in: index id */
+{
+	ib_rbt_bound_t	parent;
+
+	ut_ad(mutex_own(&page_zip_stat_per_index_mutex));
+
+	if (rbt_search(page_zip_stat_per_index, &parent, &index_id)) {
+		page_zip_stat_per_index_t	stat;
+
+		memset(&stat, 0, sizeof stat);
+		stat.index_id = index_id;
+
+		parent.last = rbt_add_node(
+			page_zip_stat_per_index, &parent, &stat);
+	}
+
+	return(&rbt_value(page_zip_stat_per_index_t, parent.last)->stat);
+}
+
+/**********************************************************************//**
+Accounts a page compression to the statistics of its index. */
+static
+void
+page_zip_stat_per_index_compressed(
+/*===============================*/
+	index_id_t	index_id,	/*!< in: index id */
+	ibool		ok,		/*!< in: TRUE if the compression
+					succeeded */
+	ullint		usec)		/*!< in: duration in microseconds */
+{
+	page_zip_stat_t*	stat;
+
+	mutex_enter(&page_zip_stat_per_index_mutex);
+	stat = page_zip_stat_per_index_get(index_id);
+	stat->compressed++;
+	stat->compressed_ok += ok;
+	stat->compressed_usec += usec;
+	mutex_exit(&page_zip_stat_per_index_mutex);
+}
+
+/**********************************************************************//**
+Accounts a page decompression to the statistics of its index. */
+static
+void
+page_zip_stat_per_index_decompressed(
+/*=================================*/
+	index_id_t	index_id,	/*!< in: index id */
+	ullint		usec)		/*!< in: duration in microseconds */
+{
+	page_zip_stat_t*	stat;
+
+	mutex_enter(&page_zip_stat_per_index_mutex);
+	stat = page_zip_stat_per_index_get(index_id);
+	stat->decompressed++;
+	stat->decompressed_usec += usec;
+	mutex_exit(&page_zip_stat_per_index_mutex);
+}
 #endif /* !UNIV_HOTBACKUP */
 
 /* Please refer to ../include/page0zip.ic for a description of the
@@ -307,7 +488,7 @@ page_zip_dir_get(
 #ifndef UNIV_HOTBACKUP
 /**********************************************************************//**
 Write a log record of compressing an index page. */
-static
+UNIV_INTERN
 void
 page_zip_compress_write_log(
 /*========================*/
@@ -1173,6 +1354,7 @@ page_zip_compress(
 				m_start, m_end, m_nonempty */
 	const page_t*	page,	/*!< in: uncompressed page */
 	dict_index_t*	index,	/*!< in: index of the B-tree node */
+	ulint		level,	/*!< in: zlib compression level */
 	mtr_t*		mtr)	/*!< in: mini-transaction, or NULL */
 {
 	z_stream	c_stream;
@@ -1282,7 +1464,7 @@ page_zip_compress(
 	/* Compress the data payload. */
 	page_zip_set_alloc(&c_stream, heap);
 
-	err = deflateInit2(&c_stream, Z_DEFAULT_COMPRESSION,
+	err = deflateInit2(&c_stream, (int) level,
 			   Z_DEFLATED, UNIV_PAGE_SIZE_SHIFT,
 			   MAX_MEM_LEVEL, Z_DEFAULT_STRATEGY);
 	ut_a(err == Z_OK);
@@ -1395,8 +1577,17 @@ err_exit:
 		}
 #endif /* PAGE_ZIP_COMPRESS_DBG */
 #ifndef UNIV_HOTBACKUP
-		page_zip_stat[page_zip->ssize - 1].compressed_usec
-			+= ut_time_us(NULL) - usec;
+		usec = ut_time_us(NULL) - usec;
+		page_zip_stat[page_zip->ssize - 1].compressed_usec += usec;
+
+		if (srv_cmp_per_index_enabled) {
+			page_zip_stat_per_index_compressed(
+				index->id, FALSE, usec);
+		}
+
+		if (page_is_leaf(page)) {
+			dict_index_zip_failure(index);
+		}
 #endif /* !UNIV_HOTBACKUP */
 		return(FALSE);
 	}
@@ -1459,8 +1650,17 @@ err_exit:
 	{
 		page_zip_stat_t*	zip_stat
 			= &page_zip_stat[page_zip->ssize - 1];
+		usec = ut_time_us(NULL) - usec;
 		zip_stat->compressed_ok++;
-		zip_stat->compressed_usec += ut_time_us(NULL) - usec;
+		zip_stat->compressed_usec += usec;
+	}
+
+	if (srv_cmp_per_index_enabled) {
+		page_zip_stat_per_index_compressed(index->id, TRUE, usec);
+	}
+
+	if (page_is_leaf(page)) {
+		dict_index_zip_success(index);
 	}
 #endif /* !UNIV_HOTBACKUP */
 
@@ -3092,8 +3292,14 @@ err_exit:
 	{
 		page_zip_stat_t*	zip_stat
 			= &page_zip_stat[page_zip->ssize - 1];
+		usec = ut_time_us(NULL) - usec;
 		zip_stat->decompressed++;
-		zip_stat->decompressed_usec += ut_time_us(NULL) - usec;
+		zip_stat->decompressed_usec += usec;
+	}
+
+	if (srv_cmp_per_index_enabled) {
+		page_zip_stat_per_index_decompressed(
+			btr_page_get_index_id(page), usec);
 	}
 #endif /* !UNIV_HOTBACKUP */
 
@@ -4587,7 +4793,8 @@ page_zip_reorganize(
 	/* Restore logging. */
 	mtr_set_log_mode(mtr, log_mode);
 
-	if (UNIV_UNLIKELY(!page_zip_compress(page_zip, page, index, mtr))) {
+	if (UNIV_UNLIKELY(!page_zip_compress(page_zip, page, index,
+					     page_zip_level, mtr))) {
 
 #ifndef UNIV_HOTBACKUP
 		buf_block_free(temp_block);
@@ -4767,21 +4974,109 @@ ulint
 page_zip_calc_checksum(
 /*===================*/
 	const void*	data,	/*!< in: compressed page */
-	ulint		size)	/*!< in: size of compressed page */
+	ulint		size,	/*!< in: size of compressed page */
+	ulint		algo)	/*!< in: srv_checksum_algorithm_t */
 {
 	/* Exclude FIL_PAGE_SPACE_OR_CHKSUM, FIL_PAGE_LSN,
 	and FIL_PAGE_FILE_FLUSH_LSN from the checksum. */
 
 	const Bytef*	s	= data;
 	uLong		adler;
+	ib_uint32_t	crc32;
 
 	ut_ad(size > FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
 
-	adler = adler32(0L, s + FIL_PAGE_OFFSET,
-			FIL_PAGE_LSN - FIL_PAGE_OFFSET);
-	adler = adler32(adler, s + FIL_PAGE_TYPE, 2);
-	adler = adler32(adler, s + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
-			size - FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
+	switch ((srv_checksum_algorithm_t) algo) {
+	case SRV_CHECKSUM_ALGORITHM_CRC32:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+		crc32 = ut_crc32(s + FIL_PAGE_OFFSET,
+				 FIL_PAGE_LSN - FIL_PAGE_OFFSET)
+			^ ut_crc32(s + FIL_PAGE_TYPE, 2)
+			^ ut_crc32(s + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
+				   size - FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
+
+		return((ulint) crc32);
+	case SRV_CHECKSUM_ALGORITHM_INNODB:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_INNODB:
+		adler = adler32(0L, s + FIL_PAGE_OFFSET,
+				FIL_PAGE_LSN - FIL_PAGE_OFFSET);
+		adler = adler32(adler, s + FIL_PAGE_TYPE, 2);
+		adler = adler32(adler, s + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID,
+				size - FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
+
+		return((ulint) adler);
+	case SRV_CHECKSUM_ALGORITHM_NONE:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_NONE:
+		return(BUF_NO_CHECKSUM_MAGIC);
+	/* no default so the compiler will emit a warning if new enum
+	is added and not handled here */
+	}
+
+	ut_error;
+	return(0);
+}
+
+/**********************************************************************//**
+Verify a compressed page's checksum. Unless innodb_checksum_algorithm
+is one of the strict variants, a checksum written by any of the
+algorithms is accepted.
+@return	TRUE if the stored checksum is valid */
+UNIV_INTERN
+ibool
+page_zip_verify_checksum(
+/*=====================*/
+	const void*	data,	/*!< in: compressed page */
+	ulint		size)	/*!< in: size of compressed page */
+{
+	ib_uint32_t	stored;
+	ib_uint32_t	calc;
+	ib_uint32_t	crc32 = 0;
+	ib_uint32_t	innodb = 0;
+
+	stored = (ib_uint32_t) mach_read_from_4(
+		(const byte*) data + FIL_PAGE_SPACE_OR_CHKSUM);
 
-	return((ulint) adler);
+	/* Check if the stored checksum is BUF_NO_CHECKSUM_MAGIC; it is
+	accepted unless one of the strict crc32/innodb settings is in use. */
+	if (stored == BUF_NO_CHECKSUM_MAGIC) {
+		return(srv_checksum_algorithm
+		       != SRV_CHECKSUM_ALGORITHM_STRICT_CRC32
+		       && srv_checksum_algorithm
+		       != SRV_CHECKSUM_ALGORITHM_STRICT_INNODB);
+	}
+
+	if (srv_checksum_algorithm == SRV_CHECKSUM_ALGORITHM_STRICT_NONE) {
+		return(FALSE);
+	}
+
+	calc = (ib_uint32_t) page_zip_calc_checksum(
+		data, size, srv_checksum_algorithm);
+
+	if (stored == calc) {
+		return(TRUE);
+	}
+
+	switch ((srv_checksum_algorithm_t) srv_checksum_algorithm) {
+	case SRV_CHECKSUM_ALGORITHM_STRICT_CRC32:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_INNODB:
+	case SRV_CHECKSUM_ALGORITHM_STRICT_NONE:
+		return(FALSE);
+	case SRV_CHECKSUM_ALGORITHM_CRC32:
+		innodb = (ib_uint32_t) page_zip_calc_checksum(
+			data, size, SRV_CHECKSUM_ALGORITHM_INNODB);
+		return(stored == innodb);
+	case SRV_CHECKSUM_ALGORITHM_INNODB:
+		crc32 = (ib_uint32_t) page_zip_calc_checksum(
+			data, size, SRV_CHECKSUM_ALGORITHM_CRC32);
+		return(stored == crc32);
+	case SRV_CHECKSUM_ALGORITHM_NONE:
+		crc32 = (ib_uint32_t) page_zip_calc_checksum(
+			data, size, SRV_CHECKSUM_ALGORITHM_CRC32);
+		innodb = (ib_uint32_t) page_zip_calc_checksum(
+			data, size, SRV_CHECKSUM_ALGORITHM_INNODB);
+		return(stored == crc32 || stored == innodb);
+	}
+
+	ut_error;
+	return(FALSE);
 }
@@ -179,12 +179,17 @@ read_view_oldest_copy_or_open_new(
 	ulint		n;
 	ulint		i;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(&trx_sys->mutex));
+
+	mutex_enter(&trx_sys->read_view_mutex);
 
 	old_view = UT_LIST_GET_LAST(trx_sys->view_list);
 
 	if (old_view == NULL) {
 
+		/* No view can be opened while we hold trx_sys->mutex */
+		mutex_exit(&trx_sys->read_view_mutex);
+
 		return(read_view_open_now(cr_trx_id, heap));
 	}
 
@@ -238,6 +243,8 @@ read_view_oldest_copy_or_open_new(
 
 	UT_LIST_ADD_LAST(view_list, trx_sys->view_list, view_copy);
 
+	mutex_exit(&trx_sys->read_view_mutex);
+
 	return(view_copy);
 }
 
@@ -258,7 +265,7 @@ read_view_open_now(
 	trx_t*		trx;
 	ulint		n;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(&trx_sys->mutex));
 
 	view = read_view_create_low(UT_LIST_GET_LEN(trx_sys->trx_list), heap);
 
@@ -309,23 +316,26 @@ read_view_open_now(
 		view->up_limit_id = view->low_limit_id;
 	}
 
-
+	mutex_enter(&trx_sys->read_view_mutex);
 	UT_LIST_ADD_FIRST(view_list, trx_sys->view_list, view);
+	mutex_exit(&trx_sys->read_view_mutex);
 
 	return(view);
 }
 
 /*********************************************************************//**
-Closes a read view. */
+Closes a read view. The caller does not need to hold the kernel mutex. */
 UNIV_INTERN
 void
 read_view_close(
 /*============*/
 	read_view_t*	view)	/*!< in: read view */
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	mutex_enter(&trx_sys->read_view_mutex);
 
 	UT_LIST_REMOVE(view_list, trx_sys->view_list, view);
+
+	mutex_exit(&trx_sys->read_view_mutex);
 }
 
 /*********************************************************************//**
@@ -339,16 +349,20 @@ read_view_close_for_mysql(
 {
 	ut_a(trx->global_read_view);
 
-	mutex_enter(&kernel_mutex);
+	/* The kernel mutex is not needed here: the InnoDB Monitor reads
+	trx->read_view of other transactions while holding
+	trx_sys->read_view_mutex. */
+
+	mutex_enter(&trx_sys->read_view_mutex);
 
-	read_view_close(trx->global_read_view);
+	UT_LIST_REMOVE(view_list, trx_sys->view_list, trx->global_read_view);
 
 	mem_heap_empty(trx->global_read_view_heap);
 
 	trx->read_view = NULL;
 	trx->global_read_view = NULL;
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->read_view_mutex);
 }
 
 /*********************************************************************//**
@@ -421,7 +435,7 @@ read_cursor_view_create_for_mysql(
 	curview->n_mysql_tables_in_use = cr_trx->n_mysql_tables_in_use;
 	cr_trx->n_mysql_tables_in_use = 0;
 
-	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->mutex);
 
 	curview->read_view = read_view_create_low(
 		UT_LIST_GET_LEN(trx_sys->trx_list), curview->heap);
@@ -474,9 +488,11 @@ read_cursor_view_create_for_mysql(
 		view->up_limit_id = view->low_limit_id;
 	}
 
+	mutex_enter(&trx_sys->read_view_mutex);
 	UT_LIST_ADD_FIRST(view_list, trx_sys->view_list, view);
+	mutex_exit(&trx_sys->read_view_mutex);
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->mutex);
 
 	return(curview);
 }
@@ -499,12 +515,12 @@ read_cursor_view_close_for_mysql(
 	belong to this transaction */
 	trx->n_mysql_tables_in_use += curview->n_mysql_tables_in_use;
 
-	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->read_view_mutex);
 
-	read_view_close(curview->read_view);
+	UT_LIST_REMOVE(view_list, trx_sys->view_list, curview->read_view);
 	trx->read_view = trx->global_read_view;
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->read_view_mutex);
 
 	mem_heap_free(curview->heap);
 }
@@ -522,7 +538,7 @@ read_cursor_set_for_mysql(
 {
 	ut_a(trx);
 
-	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->read_view_mutex);
 
 	if (UNIV_LIKELY(curview != NULL)) {
 		trx->read_view = curview->read_view;
@@ -530,5 +546,5 @@ read_cursor_set_for_mysql(
 		trx->read_view = trx->global_read_view;
 	}
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->read_view_mutex);
 }
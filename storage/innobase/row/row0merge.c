@@ -35,6 +35,7 @@ Completed by Sunny Bains and Marko Makela
 #include "dict0boot.h"
 #include "dict0crea.h"
 #include "dict0load.h"
+#include "dict0stats.h"
 #include "btr0btr.h"
 #include "mach0data.h"
 #include "trx0rseg.h"
@@ -56,6 +57,9 @@ Completed by Sunny Bains and Marko Makela
 #include "log0log.h"
 #include "ut0sort.h"
 #include "handler0alter.h"
+#include "btr0bulk.h"
+#include "os0thread.h"
+#include "srv0srv.h"
 
 /* Ignore posix_fadvise() on those platforms where it does not exist */
 #if defined __WIN__
@@ -132,6 +136,81 @@ struct merge_file_struct {
 /** Information about temporary files used in merge sort */
 typedef struct merge_file_struct merge_file_t;
 
+/** State of row_merge_build_indexes() that is shared by the threads
+that sort and load the indexes */
+struct row_merge_build_struct {
+	trx_t*		trx;		/*!< transaction */
+	dict_table_t*	old_table;	/*!< table where rows are read from */
+	dict_table_t*	new_table;	/*!< table where indexes are created */
+	dict_index_t**	indexes;	/*!< indexes to be created */
+	merge_file_t*	files;		/*!< files containing the index
+					entries of each index */
+	ulint		n_indexes;	/*!< size of indexes[] */
+	ulint		n_merge_threads;/*!< number of threads that execute
+					a merge pass of an index */
+	struct TABLE*	table;		/*!< MySQL table, for reporting
+					erroneous key value */
+	mutex_t		mutex;		/*!< protects the fields below,
+					and table->record[0] */
+	ulint		next_index;	/*!< next index to be examined by
+					row_merge_build_thread_run() */
+	ulint		error;		/*!< DB_SUCCESS, or the first error */
+	ulint		error_key_num;	/*!< the index that caused error */
+};
+
+/** State of row_merge_build_indexes() that is shared by the threads
+that sort and load the indexes */
+typedef struct row_merge_build_struct row_merge_build_t;
+
+/** A job of a merge pass: merge two runs of the input file, or copy
+one, to a run of the output file */
+struct row_merge_job_struct {
+	ulint		foffs0;		/*!< first block of the first
+					input run */
+	ulint		foffs1;		/*!< first block of the second
+					input run, or ULINT_UNDEFINED
+					if the first run is copied */
+	ulint		ofs;		/*!< first block of the output run */
+};
+
+/** A job of a merge pass */
+typedef struct row_merge_job_struct row_merge_job_t;
+
+/** A merge pass, whose jobs are executed by one or more threads */
+struct row_merge_pass_struct {
+	trx_t*			trx;	/*!< transaction */
+	const dict_index_t*	index;	/*!< index being created */
+	const merge_file_t*	file;	/*!< input file */
+	int			fd;	/*!< output file */
+	row_merge_build_t*	build;	/*!< for reporting errors */
+	const row_merge_job_t*	jobs;	/*!< the jobs */
+	ulint			n_jobs;	/*!< number of jobs */
+	mutex_t			mutex;	/*!< protects the fields below */
+	ulint			next_job;/*!< the next job to execute */
+	ib_uint64_t		n_rec;	/*!< number of records written */
+	ulint			error;	/*!< DB_SUCCESS, or the first error */
+};
+
+/** A merge pass */
+typedef struct row_merge_pass_struct row_merge_pass_t;
+
+/** A thread that helps another one, and sets an event when it exits */
+struct row_merge_helper_struct {
+	void*		arg;		/*!< row_merge_pass_t or
+					row_merge_build_t */
+	os_event_t	done;		/*!< set when the thread no longer
+					accesses arg */
+};
+
+/** A thread that helps another one */
+typedef struct row_merge_helper_struct row_merge_helper_t;
+
+#ifdef UNIV_PFS_MUTEX
+/* Key to register the mutexes of the merge sort threads with
+performance schema */
+UNIV_INTERN mysql_pfs_key_t	row_merge_mutex_key;
+#endif /* UNIV_PFS_MUTEX */
+
 #ifdef UNIV_DEBUG
 /******************************************************//**
 Display a merge tuple. */
@@ -1411,6 +1490,44 @@ func_exit:
 	return(err);
 }
 
+/*************************************************************//**
+Records the first error of row_merge_build_indexes(), and the index that
+caused it. A duplicate key is converted to table->record[0] for the error
+message. Only the first error is recorded, because the threads that build
+the indexes share table->record[0]. */
+static
+void
+row_merge_build_error(
+/*==================*/
+	row_merge_build_t*	build,	/*!< in/out: index build */
+	const dict_index_t*	index,	/*!< in: index that caused the error */
+	ulint			error,	/*!< in: error code */
+	const mrec_t*		mrec,	/*!< in: duplicate key, or NULL */
+	const ulint*		offsets)/*!< in: offsets of mrec, or NULL */
+{
+	ulint	i;
+
+	ut_ad(error != DB_SUCCESS);
+
+	for (i = 0; build->indexes[i] != index; i++) {
+		ut_ad(i + 1 < build->n_indexes);
+	}
+
+	mutex_enter(&build->mutex);
+
+	if (build->error == DB_SUCCESS) {
+		build->error = error;
+		build->error_key_num = i;
+
+		if (mrec) {
+			innobase_rec_to_mysql(build->table, mrec,
+					      index, offsets);
+		}
+	}
+
+	mutex_exit(&build->mutex);
+}
+
 /** Write a record via buffer 2 and read the next record to buffer N.
 @param N	number of the buffer (0 or 1)
 @param AT_END	statement to execute at end of input */
@@ -1450,8 +1567,8 @@ row_merge_blocks(
 	ulint*			foffs1,	/*!< in/out: offset of second
 					source list in the file */
 	merge_file_t*		of,	/*!< in/out: output file */
-	struct TABLE*		table)	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_build_t*	build)	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
 {
 	mem_heap_t*	heap;	/*!< memory heap for offsets0, offsets1 */
@@ -1511,8 +1628,9 @@ corrupt:
 		case 0:
 			if (UNIV_UNLIKELY
 			    (dict_index_is_unique(index) && !null_eq)) {
-				innobase_rec_to_mysql(table, mrec0,
-						      index, offsets0);
+				row_merge_build_error(build, index,
+						      DB_DUPLICATE_KEY,
+						      mrec0, offsets0);
 				mem_heap_free(heap);
 				return(DB_DUPLICATE_KEY);
 			}
@@ -1621,8 +1739,185 @@ done0:
 	       != NULL);
 }
 
+/*************************************************************//**
+Executes a job of a merge pass.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull))
+ulint
+row_merge_job(
+/*==========*/
+	row_merge_pass_t*	pass,	/*!< in: merge pass */
+	const row_merge_job_t*	job,	/*!< in: job */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	ib_uint64_t*		n_rec)	/*!< out: number of records written */
+{
+	ulint		foffs0	= job->foffs0;
+	ulint		foffs1	= job->foffs1;
+	ulint		error	= DB_SUCCESS;
+	merge_file_t	of;
+
+	of.fd = pass->fd;
+	of.offset = job->ofs;
+	of.n_rec = 0;
+
+	if (foffs1 == ULINT_UNDEFINED) {
+		if (!row_merge_blocks_copy(pass->index, pass->file, block,
+					   &foffs0, &of)) {
+			error = DB_CORRUPTION;
+		}
+	} else {
+		error = row_merge_blocks(pass->index, pass->file, block,
+					 &foffs0, &foffs1, &of, pass->build);
+	}
+
+	*n_rec = of.n_rec;
+
+	return(error);
+}
+
+/*************************************************************//**
+Executes the jobs of a merge pass until all of them have been started,
+or until a job fails. */
+static __attribute__((nonnull))
+void
+row_merge_pass_run(
+/*===============*/
+	row_merge_pass_t*	pass,	/*!< in/out: merge pass */
+	row_merge_block_t*	block)	/*!< in/out: 3 buffers */
+{
+	for (;;) {
+		const row_merge_job_t*	job;
+		ib_uint64_t		n_rec	= 0;
+		ulint			error;
+
+		mutex_enter(&pass->mutex);
+
+		if (pass->error != DB_SUCCESS
+		    || pass->next_job == pass->n_jobs) {
+
+			mutex_exit(&pass->mutex);
+			break;
+		}
+
+		job = &pass->jobs[pass->next_job++];
+
+		mutex_exit(&pass->mutex);
+
+		if (UNIV_UNLIKELY(trx_is_interrupted(pass->trx))) {
+			error = DB_INTERRUPTED;
+		} else {
+			error = row_merge_job(pass, job, block, &n_rec);
+		}
+
+		mutex_enter(&pass->mutex);
+
+		pass->n_rec += n_rec;
+
+		if (error != DB_SUCCESS && pass->error == DB_SUCCESS) {
+			pass->error = error;
+		}
+
+		mutex_exit(&pass->mutex);
+	}
+}
+
+/*************************************************************//**
+A thread that helps in executing the jobs of a merge pass. If the merge
+buffers cannot be allocated, the thread exits and leaves the jobs to
+the other threads.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+row_merge_pass_thread(
+/*==================*/
+	void*	arg)	/*!< in: row_merge_helper_t */
+{
+	row_merge_helper_t*	helper	= arg;
+	row_merge_block_t*	block;
+	ulint			block_size = 3 * sizeof *block;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	block = os_mem_alloc_large(&block_size);
+
+	if (block) {
+		row_merge_pass_run(helper->arg, block);
+		os_mem_free_large(block, block_size);
+	}
+
+	os_event_set(helper->done);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*************************************************************//**
+Starts helper threads, and waits for them to exit after the calling
+thread has done its part of the work. */
+static __attribute__((nonnull))
+void
+row_merge_run_with_helpers(
+/*=======================*/
+	os_thread_ret_t	(*helper_func)(void*),
+				/*!< in: function of the helper threads */
+	void		(*run)(void*, row_merge_block_t*, int*),
+				/*!< in: function of the calling thread */
+	void*		arg,	/*!< in/out: work shared by the threads */
+	ulint		n_helpers,/*!< in: number of helper threads */
+	row_merge_block_t* block,/*!< in/out: buffers of the calling thread */
+	int*		tmpfd)	/*!< in/out: temporary file of the
+				calling thread */
+{
+	row_merge_helper_t*	helpers;
+	ulint			i;
+
+	helpers = mem_alloc(n_helpers * sizeof *helpers);
+
+	for (i = 0; i < n_helpers; i++) {
+		helpers[i].arg = arg;
+		helpers[i].done = os_event_create(NULL);
+
+		os_thread_create(helper_func, &helpers[i], NULL);
+	}
+
+	run(arg, block, tmpfd);
+
+	for (i = 0; i < n_helpers; i++) {
+		os_event_wait(helpers[i].done);
+		os_event_free(helpers[i].done);
+	}
+
+	mem_free(helpers);
+}
+
+/*************************************************************//**
+Calls row_merge_pass_run() for row_merge_run_with_helpers(). */
+static
+void
+row_merge_pass_run_func(
+/*====================*/
+	void*			arg,	/*!< in/out: row_merge_pass_t */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd __attribute__((unused)))
+					/*!< in: unused */
+{
+	row_merge_pass_run(arg, block);
+}
+
 /*************************************************************//**
 Merge disk files.
+
+Each pass merges run i of the first half of the input file with run i
+of the second half, and copies a possible last run. The output run of
+each job starts where its input runs would start if the runs of each
+pair were adjacent, so that the jobs are independent of each other and
+can be executed by n_threads threads in parallel. An output run is never
+longer than its input runs; the unused blocks are never read.
 @return	DB_SUCCESS or error code */
 static __attribute__((nonnull))
 ulint
@@ -1634,118 +1929,113 @@ row_merge(
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
 	int*			tmpfd,	/*!< in/out: temporary file handle */
-	struct TABLE*		table,	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_build_t*	build,	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
 	ulint*			num_run,/*!< in/out: Number of runs remain
 					to be merged */
-	ulint*			run_offset) /*!< in/out: Array contains the
+	ulint*			run_offset,/*!< in/out: Array contains the
 					first offset number for each merge
 					run */
+	ulint			n_threads)/*!< in: maximum number of threads
+					that execute the pass */
 {
-	ulint		foffs0;	/*!< first input offset */
-	ulint		foffs1;	/*!< second input offset */
-	ulint		error;	/*!< error code */
-	merge_file_t	of;	/*!< output file */
-	const ulint	ihalf	= run_offset[*num_run / 2];
-				/*!< half the input file */
-	ulint		n_run	= 0;
-				/*!< num of runs generated from this merge */
-
+	const ulint	half	= *num_run / 2;
+				/*!< number of runs in the first half */
+	row_merge_pass_t pass;	/*!< the merge pass */
+	row_merge_job_t* jobs;	/*!< jobs of the pass */
+	ulint		n_jobs	= *num_run - half;
+				/*!< number of runs generated from
+				this merge */
+	ulint		ofs	= 0;
+	ulint		i;
 
 	UNIV_MEM_ASSERT_W(block[0], 3 * sizeof block[0]);
 
-	ut_ad(ihalf < file->offset);
-
-	of.fd = *tmpfd;
-	of.offset = 0;
-	of.n_rec = 0;
+	ut_ad(half > 0);
+	ut_ad(run_offset[half] < file->offset);
 
 #ifdef POSIX_FADV_SEQUENTIAL
 	/* The input file will be read sequentially, starting from the
-	beginning and the middle.  In Linux, the POSIX_FADV_SEQUENTIAL
+	beginning of each run.  In Linux, the POSIX_FADV_SEQUENTIAL
 	affects the entire file.  Each block will be read exactly once. */
 	posix_fadvise(file->fd, 0, 0,
 		      POSIX_FADV_SEQUENTIAL | POSIX_FADV_NOREUSE);
 #endif /* POSIX_FADV_SEQUENTIAL */
 
-	/* Merge blocks to the output file. */
-	foffs0 = 0;
-	foffs1 = ihalf;
+	jobs = mem_alloc(n_jobs * sizeof *jobs);
 
-	UNIV_MEM_INVALID(run_offset, *num_run * sizeof *run_offset);
+	for (i = 0; i < n_jobs; i++) {
+		/* The runs to be merged or copied */
+		ulint	r0 = i < half ? i : half + i;
+		ulint	r1 = half + i;
 
-	for (; foffs0 < ihalf && foffs1 < file->offset; foffs0++, foffs1++) {
+		jobs[i].foffs0 = run_offset[r0];
+		jobs[i].ofs = ofs;
 
-		if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
-			return(DB_INTERRUPTED);
-		}
-
-		/* Remember the offset number for this run */
-		run_offset[n_run++] = of.offset;
+		ofs += (r0 + 1 < *num_run ? run_offset[r0 + 1] : file->offset)
+			- run_offset[r0];
 
-		error = row_merge_blocks(index, file, block,
-					 &foffs0, &foffs1, &of, table);
+		if (i < half) {
+			jobs[i].foffs1 = run_offset[r1];
 
-		if (error != DB_SUCCESS) {
-			return(error);
+			ofs += (r1 + 1 < *num_run
+				? run_offset[r1 + 1] : file->offset)
+				- run_offset[r1];
+		} else {
+			jobs[i].foffs1 = ULINT_UNDEFINED;
 		}
-
 	}
 
-	/* Copy the last blocks, if there are any. */
+	ut_ad(ofs == file->offset);
 
-	while (foffs0 < ihalf) {
-		if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
-			return(DB_INTERRUPTED);
-		}
+	pass.trx = trx;
+	pass.index = index;
+	pass.file = file;
+	pass.fd = *tmpfd;
+	pass.build = build;
+	pass.jobs = jobs;
+	pass.n_jobs = n_jobs;
+	pass.next_job = 0;
+	pass.n_rec = 0;
+	pass.error = DB_SUCCESS;
 
-		/* Remember the offset number for this run */
-		run_offset[n_run++] = of.offset;
+	mutex_create(row_merge_mutex_key, &pass.mutex, SYNC_NO_ORDER_CHECK);
 
-		if (!row_merge_blocks_copy(index, file, block, &foffs0, &of)) {
-			return(DB_CORRUPTION);
-		}
-	}
+	row_merge_run_with_helpers(row_merge_pass_thread,
+				   row_merge_pass_run_func, &pass,
+				   ut_min(n_threads, n_jobs) - 1,
+				   block, tmpfd);
 
-	ut_ad(foffs0 == ihalf);
-
-	while (foffs1 < file->offset) {
-		if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
-			return(DB_INTERRUPTED);
-		}
+	mutex_free(&pass.mutex);
 
-		/* Remember the offset number for this run */
-		run_offset[n_run++] = of.offset;
-
-		if (!row_merge_blocks_copy(index, file, block, &foffs1, &of)) {
-			return(DB_CORRUPTION);
-		}
+	if (pass.error == DB_SUCCESS && pass.n_rec != file->n_rec) {
+		pass.error = DB_CORRUPTION;
 	}
 
-	ut_ad(foffs1 == file->offset);
-
-	if (UNIV_UNLIKELY(of.n_rec != file->n_rec)) {
-		return(DB_CORRUPTION);
+	if (pass.error != DB_SUCCESS) {
+		mem_free(jobs);
+		return(pass.error);
 	}
 
-	ut_ad(n_run <= *num_run);
-
-	*num_run = n_run;
-
 	/* Each run can contain one or more offsets. As merge goes on,
 	the number of runs (to merge) will reduce until we have one
 	single run. So the number of runs will always be smaller than
 	the number of offsets in file */
-	ut_ad((*num_run) <= file->offset);
+	for (i = 0; i < n_jobs; i++) {
+		run_offset[i] = jobs[i].ofs;
+	}
+
+	mem_free(jobs);
 
-	/* The number of offsets in output file is always equal or
-	smaller than input file */
-	ut_ad(of.offset <= file->offset);
+	*num_run = n_jobs;
 
-	/* Swap file descriptors for the next pass. */
+	ut_ad((*num_run) <= file->offset);
+
+	/* Swap file descriptors for the next pass. The output file
+	has the same size as the input file. */
 	*tmpfd = file->fd;
-	*file = of;
+	file->fd = pass.fd;
 
 	UNIV_MEM_INVALID(block[0], 3 * sizeof block[0]);
 
@@ -1765,14 +2055,16 @@ row_merge_sort(
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
 	int*			tmpfd,	/*!< in/out: temporary file handle */
-	struct TABLE*		table)	/*!< in/out: MySQL table, for
-					reporting erroneous key value
+	row_merge_build_t*	build,	/*!< in/out: for reporting
+					erroneous key value
 					if applicable */
+	ulint			n_threads)/*!< in: maximum number of threads
+					that execute a merge pass */
 {
-	ulint	half = file->offset / 2;
 	ulint	num_runs;
 	ulint*	run_offset;
 	ulint	error = DB_SUCCESS;
+	ulint	i;
 
 	/* Record the number of merge runs we need to perform */
 	num_runs = file->offset;
@@ -1785,9 +2077,10 @@ row_merge_sort(
 	/* "run_offset" records each run's first offset number */
 	run_offset = (ulint*) mem_alloc(file->offset * sizeof(ulint));
 
-	/* This tells row_merge() where to start for the first round
-	of merge. */
-	run_offset[half] = half;
+	/* Initially, each block is a run of its own. */
+	for (i = 0; i < num_runs; i++) {
+		run_offset[i] = i;
+	}
 
 	/* The file should always contain at least one byte (the end
 	of file marker).  Thus, it must be at least one block. */
@@ -1796,7 +2089,7 @@ row_merge_sort(
 	/* Merge the runs until we have one big run */
 	do {
 		error = row_merge(trx, index, file, block, tmpfd,
-				  table, &num_runs, run_offset);
+				  build, &num_runs, run_offset, n_threads);
 
 		UNIV_MEM_ASSERT_RW(run_offset, num_runs * sizeof *run_offset);
 
@@ -1976,6 +2269,100 @@ err_exit:
 	return(error);
 }
 
+/********************************************************************//**
+Read sorted file containing index data tuples and load them to an empty
+index with btr_bulk_insert(), which builds the B-tree bottom-up and fills
+the pages to innodb_fill_factor percent.
+@return	DB_SUCCESS or error number */
+static
+ulint
+row_merge_load_index_tuples(
+/*========================*/
+	trx_t*			trx,	/*!< in: transaction */
+	dict_index_t*		index,	/*!< in: index,
+					btr_bulk_is_supported() */
+	int			fd,	/*!< in: file descriptor */
+	row_merge_block_t*	block)	/*!< in/out: file buffer */
+{
+	const byte*		b;
+	btr_bulk_t*		bulk;
+	mem_heap_t*		tuple_heap;
+	mem_heap_t*		heap;
+	mrec_buf_t*		buf;
+	ulint			error = DB_SUCCESS;
+	ulint			foffs = 0;
+	ulint			prev_foffs = 0;
+	ulint*			offsets;
+
+	ut_ad(btr_bulk_is_supported(index));
+
+	{
+		ulint i	= 1 + REC_OFFS_HEADER_SIZE
+			+ dict_index_get_n_fields(index);
+		heap = mem_heap_create(sizeof *buf + i * sizeof *offsets);
+		offsets = mem_heap_alloc(heap, i * sizeof *offsets);
+		offsets[0] = i;
+		offsets[1] = dict_index_get_n_fields(index);
+	}
+
+	buf = mem_heap_alloc(heap, sizeof *buf);
+	tuple_heap = mem_heap_create(1000);
+
+	bulk = btr_bulk_create(index, trx->id, srv_fill_factor);
+
+	b = *block;
+
+	if (!row_merge_read(fd, foffs, block)) {
+		error = DB_CORRUPTION;
+	} else {
+		for (;;) {
+			const mrec_t*	mrec;
+			dtuple_t*	dtuple;
+			ulint		n_ext;
+
+			b = row_merge_read_rec(block, buf, b, index,
+					       fd, &foffs, &mrec, offsets);
+			if (UNIV_UNLIKELY(!b)) {
+				/* End of list, or I/O error */
+				if (mrec) {
+					error = DB_CORRUPTION;
+				}
+				break;
+			}
+
+			if (foffs != prev_foffs) {
+				prev_foffs = foffs;
+
+				if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
+					error = DB_INTERRUPTED;
+					break;
+				}
+			}
+
+			dtuple = row_rec_to_index_entry_low(
+				mrec, index, offsets, &n_ext, tuple_heap);
+
+			ut_ad(!n_ext);
+			ut_ad(dtuple_validate(dtuple));
+
+			error = btr_bulk_insert(bulk, dtuple);
+
+			mem_heap_empty(tuple_heap);
+
+			if (error != DB_SUCCESS) {
+				break;
+			}
+		}
+	}
+
+	error = btr_bulk_finish(bulk, error);
+
+	mem_heap_free(tuple_heap);
+	mem_heap_free(heap);
+
+	return(error);
+}
+
 /*********************************************************************//**
 Sets an exclusive lock on a table, for the duration of creating indexes.
 @return	error code or DB_SUCCESS */
@@ -2110,6 +2497,8 @@ row_merge_drop_index(
 		ut_print_timestamp(stderr);
 		fprintf(stderr, " InnoDB: Error: row_merge_drop_index failed "
 			"with error code: %lu.\n", (ulint) err);
+	} else {
+		dict_stats_delete_index_stats(index, trx);
 	}
 
 	/* Replace this index with another equivalent index for all
@@ -2688,6 +3077,174 @@ row_merge_drop_table(
 	return(row_drop_table_for_mysql(table->name, trx, FALSE));
 }
 
+/*********************************************************************//**
+Sorts the index entries of an index of row_merge_build_indexes() and
+inserts them to the index.
+@return	DB_SUCCESS or error code */
+static __attribute__((nonnull))
+ulint
+row_merge_build_index(
+/*==================*/
+	row_merge_build_t*	build,	/*!< in/out: index build */
+	ulint			i,	/*!< in: index number */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd)	/*!< in/out: temporary file handle */
+{
+	dict_index_t*	index	= build->indexes[i];
+	merge_file_t*	file	= &build->files[i];
+	ulint		error;
+
+	error = row_merge_sort(build->trx, index, file, block, tmpfd,
+			       build, build->n_merge_threads);
+
+	if (error != DB_SUCCESS) {
+		/* Do not insert anything. */
+	} else if (btr_bulk_is_supported(index)) {
+		error = row_merge_load_index_tuples(
+			build->trx, index, file->fd, block);
+	} else {
+		error = row_merge_insert_index_tuples(
+			build->trx, index, build->new_table,
+			dict_table_zip_size(build->old_table),
+			file->fd, block);
+	}
+
+	/* Close the temporary file to free up space. */
+	row_merge_file_destroy(file);
+
+	if (error != DB_SUCCESS) {
+		row_merge_build_error(build, index, error, NULL, NULL);
+	}
+
+	return(error);
+}
+
+/*********************************************************************//**
+Sorts and loads the indexes of row_merge_build_indexes() that are loaded
+with btr_bulk_insert(), until all of them have been started or an index
+build fails. The other indexes use the transaction, and they are built
+by the thread that called row_merge_build_indexes(). */
+static
+void
+row_merge_build_thread_run(
+/*=======================*/
+	void*			arg,	/*!< in/out: row_merge_build_t */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd)	/*!< in/out: temporary file handle */
+{
+	row_merge_build_t*	build = arg;
+
+	for (;;) {
+		ulint	i;
+
+		mutex_enter(&build->mutex);
+
+		while (build->next_index < build->n_indexes
+		       && !btr_bulk_is_supported(
+			       build->indexes[build->next_index])) {
+
+			build->next_index++;
+		}
+
+		if (build->error != DB_SUCCESS
+		    || build->next_index == build->n_indexes) {
+
+			mutex_exit(&build->mutex);
+			break;
+		}
+
+		i = build->next_index++;
+
+		mutex_exit(&build->mutex);
+
+		if (row_merge_build_index(build, i, block, tmpfd)
+		    != DB_SUCCESS) {
+
+			break;
+		}
+	}
+}
+
+/*********************************************************************//**
+Builds the indexes of row_merge_build_indexes() that are inserted to with
+row_ins_index_entry(), and then helps the threads that build the other
+indexes. */
+static
+void
+row_merge_build_run(
+/*================*/
+	void*			arg,	/*!< in/out: row_merge_build_t */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd)	/*!< in/out: temporary file handle */
+{
+	row_merge_build_t*	build = arg;
+	ulint			i;
+
+	for (i = 0; i < build->n_indexes; i++) {
+		ulint	error;
+
+		if (btr_bulk_is_supported(build->indexes[i])) {
+			continue;
+		}
+
+		mutex_enter(&build->mutex);
+		error = build->error;
+		mutex_exit(&build->mutex);
+
+		if (error != DB_SUCCESS
+		    || row_merge_build_index(build, i, block, tmpfd)
+		    != DB_SUCCESS) {
+
+			return;
+		}
+	}
+
+	row_merge_build_thread_run(build, block, tmpfd);
+}
+
+/*********************************************************************//**
+A thread that sorts and loads indexes of row_merge_build_indexes()
+in parallel with the calling thread. If the merge buffers or the
+temporary file cannot be allocated, the thread exits and leaves the
+indexes to the other threads.
+@return	a dummy parameter */
+static
+os_thread_ret_t
+row_merge_build_thread(
+/*===================*/
+	void*	arg)	/*!< in: row_merge_helper_t */
+{
+	row_merge_helper_t*	helper	= arg;
+	row_merge_block_t*	block;
+	ulint			block_size = 3 * sizeof *block;
+	int			tmpfd;
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(row_merge_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	block = os_mem_alloc_large(&block_size);
+	tmpfd = row_merge_file_create_low();
+
+	if (block && tmpfd >= 0) {
+		row_merge_build_thread_run(helper->arg, block, &tmpfd);
+	}
+
+	row_merge_file_destroy_low(tmpfd);
+
+	if (block) {
+		os_mem_free_large(block, block_size);
+	}
+
+	os_event_set(helper->done);
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
 /*********************************************************************//**
 Build indexes on a table by reading a clustered index,
 creating a temporary file containing index entries, merge sorting
@@ -2715,6 +3272,9 @@ row_merge_build_indexes(
 	ulint			i;
 	ulint			error;
 	int			tmpfd = -1;
+	row_merge_build_t	build;
+	ulint			n_bulk = 0;
+	ulint			n_threads;
 
 	ut_ad(trx);
 	ut_ad(old_table);
@@ -2773,26 +3333,45 @@ row_merge_build_indexes(
 	}
 
 	/* Now we have files containing index entries ready for
-	sorting and inserting. */
+	sorting and inserting.  The indexes that are loaded with
+	btr_bulk_insert() are sorted and loaded by up to
+	innodb_merge_threads threads in parallel, and the remaining
+	threads execute the merge passes of each index in parallel.
+	The other indexes are inserted to with row_ins_index_entry(),
+	which uses the transaction; this thread builds them. */
 
 	for (i = 0; i < n_indexes; i++) {
-		error = row_merge_sort(trx, indexes[i], &merge_files[i],
-				       block, &tmpfd, table);
-
-		if (error == DB_SUCCESS) {
-			error = row_merge_insert_index_tuples(
-				trx, indexes[i], new_table,
-				dict_table_zip_size(old_table),
-				merge_files[i].fd, block);
+		if (btr_bulk_is_supported(indexes[i])) {
+			n_bulk++;
 		}
+	}
 
-		/* Close the temporary file to free up space. */
-		row_merge_file_destroy(&merge_files[i]);
+	n_threads = ut_max(ut_min(srv_merge_threads, n_bulk), 1);
 
-		if (error != DB_SUCCESS) {
-			trx->error_key_num = i;
-			goto func_exit;
-		}
+	build.trx = trx;
+	build.old_table = old_table;
+	build.new_table = new_table;
+	build.indexes = indexes;
+	build.files = merge_files;
+	build.n_indexes = n_indexes;
+	build.n_merge_threads = ut_max(srv_merge_threads / n_threads, 1);
+	build.table = table;
+	build.next_index = 0;
+	build.error = DB_SUCCESS;
+	build.error_key_num = 0;
+
+	mutex_create(row_merge_mutex_key, &build.mutex, SYNC_NO_ORDER_CHECK);
+
+	row_merge_run_with_helpers(row_merge_build_thread,
+				   row_merge_build_run, &build,
+				   n_threads - 1, block, &tmpfd);
+
+	mutex_free(&build.mutex);
+
+	error = build.error;
+
+	if (error != DB_SUCCESS) {
+		trx->error_key_num = build.error_key_num;
 	}
 
 func_exit:
@@ -40,6 +40,7 @@ Created 9/17/2000 Heikki Tuuri
 #include "dict0dict.h"
 #include "dict0crea.h"
 #include "dict0load.h"
+#include "dict0stats.h"
 #include "dict0boot.h"
 #include "trx0roll.h"
 #include "trx0purge.h"
@@ -153,6 +154,62 @@ row_mysql_prebuilt_free_blob_heap(
 	prebuilt->blob_heap = NULL;
 }
 
+/*******************************************************************//**
+Checks the magic numbers around a row buffer of the fetch cache and
+frees the buffer. */
+static
+void
+row_prebuilt_free_fetch_buf(
+/*========================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	ulint		i)		/*!< in: index in fetch_cache */
+{
+	if ((ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
+		     (prebuilt->fetch_cache[i]) - 4))
+	    || (ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
+			(prebuilt->fetch_cache[i])
+			+ prebuilt->mysql_row_len))) {
+		fputs("InnoDB: Error: trying to free"
+		      " a corrupt fetch buffer.\n", stderr);
+
+		mem_analyze_corruption(prebuilt->fetch_cache[i]);
+
+		ut_error;
+	}
+
+	mem_free((prebuilt->fetch_cache[i]) - 4);
+	prebuilt->fetch_cache[i] = NULL;
+}
+
+/*******************************************************************//**
+Shrinks the fetch cache of prebuilt back to MYSQL_FETCH_CACHE_SIZE row
+buffers after a large scan has grown it, and discards the rows that
+are still cached for the cursor. Must only be called when the cursor
+will not be continued, e.g. at the end of a statement. */
+UNIV_INTERN
+void
+row_mysql_prebuilt_shrink_fetch_cache(
+/*==================================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct of a
+					ha_innobase:: table handle */
+{
+	ulint	i;
+
+	for (i = MYSQL_FETCH_CACHE_SIZE;
+	     i < prebuilt->fetch_cache_alloc; i++) {
+
+		row_prebuilt_free_fetch_buf(prebuilt, i);
+	}
+
+	if (prebuilt->fetch_cache_alloc > MYSQL_FETCH_CACHE_SIZE) {
+		prebuilt->fetch_cache_alloc = MYSQL_FETCH_CACHE_SIZE;
+	}
+
+	prebuilt->n_fetch_cached = 0;
+	prebuilt->fetch_cache_first = 0;
+	prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+}
+
 /*******************************************************************//**
 Stores a >= 5.0.3 format true VARCHAR length to dest, in the MySQL row
 format.
@@ -760,6 +817,8 @@ row_create_prebuilt(
 
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+
 	return(prebuilt);
 }
 
@@ -822,25 +881,13 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-		if (prebuilt->fetch_cache[i] != NULL) {
-
-			if ((ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
-				     (prebuilt->fetch_cache[i]) - 4))
-			    || (ROW_PREBUILT_FETCH_MAGIC_N != mach_read_from_4(
-					(prebuilt->fetch_cache[i])
-					+ prebuilt->mysql_row_len))) {
-				fputs("InnoDB: Error: trying to free"
-				      " a corrupt fetch buffer.\n", stderr);
+	for (i = 0; i < prebuilt->fetch_cache_alloc; i++) {
 
-				mem_analyze_corruption(
-					prebuilt->fetch_cache[i]);
-
-				ut_error;
-			}
+		row_prebuilt_free_fetch_buf(prebuilt, i);
+	}
 
-			mem_free((prebuilt->fetch_cache[i]) - 4);
-		}
+	if (prebuilt->fetch_cache != NULL) {
+		mem_free(prebuilt->fetch_cache);
 	}
 
 	dict_table_decrement_handle_count(prebuilt->table, dict_locked);
@@ -962,6 +1009,20 @@ row_update_statistics_if_needed(
 
 	table->stat_modified_counter = counter + 1;
 
+	if (srv_stats_persistent) {
+		/* Persistent statistics are not recalculated on metadata
+		commands, so recalculate them when 10% of the rows have
+		changed, or when rows are added to an empty table, as when
+		ALTER TABLE copies the rows to a new table. Leave the
+		sampling and the saving of the statistics to the
+		dict_stats thread. */
+		if ((ib_int64_t) counter >= table->stat_n_rows / 10) {
+			dict_stats_enqueue(table);
+		}
+
+		return;
+	}
+
 	if (DICT_TABLE_CHANGED_TOO_MUCH(table)) {
 
 		dict_update_statistics(
@@ -982,11 +1043,11 @@ row_unlock_table_autoinc_for_mysql(
 	trx_t*	trx)	/*!< in/out: transaction */
 {
 	if (lock_trx_holds_autoinc_locks(trx)) {
-		mutex_enter(&kernel_mutex);
+		lock_mutex_enter_kernel();
 
 		lock_release_autoinc_locks(trx);
 
-		mutex_exit(&kernel_mutex);
+		lock_mutex_exit_kernel();
 	}
 }
 
@@ -3051,6 +3112,12 @@ next_rec:
 		FALSE, /* update even if stats are initialized */
 		FALSE /* update even if not changed too much */);
 
+	if (srv_stats_persistent) {
+		/* Replace the saved statistics of the table, which
+		this thread cannot do while it holds dict_sys->mutex. */
+		dict_stats_enqueue(table);
+	}
+
 	trx_commit_for_mysql(trx);
 
 funct_exit:
@@ -3398,6 +3465,12 @@ check_next_foreign:
 
 	case DB_SUCCESS:
 
+		for (index = dict_table_get_first_index(table);
+		     index != NULL;
+		     index = dict_table_get_next_index(index)) {
+			dict_stats_delete_index_stats(index, trx);
+		}
+
 		heap = mem_heap_create(200);
 
 		/* Clone the name, in case it has been allocated
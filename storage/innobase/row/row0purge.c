@@ -76,6 +76,9 @@ row_purge_node_create(
 
 	node->heap = mem_heap_create(256);
 
+	node->undo_recs = NULL;
+	node->next_undo_rec = 0;
+
 	return(node);
 }
 
@@ -739,9 +742,9 @@ err_exit:
 }
 
 /***********************************************************//**
-Fetches an undo log record and does the purge for the recorded operation.
-If none left, or the current purge completed, returns the control to the
-parent node, which is always a query thread node. */
+Takes the next undo log record handed to the node and does the purge for
+the recorded operation. If none left, returns the control to the parent
+node, which is always a query thread node. */
 static __attribute__((nonnull))
 void
 row_purge(
@@ -750,14 +753,12 @@ row_purge(
 	que_thr_t*	thr)	/*!< in: query thread */
 {
 	ibool		updated_extern;
+	trx_purge_rec_t* purge_rec;
 
 	ut_ad(node);
 	ut_ad(thr);
 
-	node->undo_rec = trx_purge_fetch_next_rec(&node->roll_ptr,
-						  &node->reservation,
-						  node->heap);
-	if (!node->undo_rec) {
+	if (node->next_undo_rec >= ib_vector_size(node->undo_recs)) {
 		/* Purge completed for this query thread */
 
 		thr->run_node = que_node_get_parent(node);
@@ -765,6 +766,11 @@ row_purge(
 		return;
 	}
 
+	purge_rec = ib_vector_get(node->undo_recs, node->next_undo_rec++);
+
+	node->undo_rec = purge_rec->undo_rec;
+	node->roll_ptr = purge_rec->roll_ptr;
+
 	if (node->undo_rec != &trx_purge_dummy_rec
 	    && row_purge_parse_undo_rec(node, &updated_extern, thr)) {
 		node->found_clust = FALSE;
@@ -789,7 +795,6 @@ row_purge(
 	}
 
 	/* Do some cleanup */
-	trx_purge_rec_release(node->reservation);
 	mem_heap_empty(node->heap);
 
 	thr->run_node = node;
@@ -72,6 +72,10 @@ to que_run_threads: this is to allow canceling runaway queries */
 
 #define SEL_COST_LIMIT	100
 
+/* Number of leaf pages that an ascending scan in row_search_for_mysql()
+must visit before it starts the logical read-ahead */
+#define SEL_READ_AHEAD_START	4
+
 /* Flags for search shortcut */
 #define SEL_FOUND	0
 #define	SEL_EXHAUSTED	1
@@ -1225,7 +1229,7 @@ row_sel_try_search_shortcut(
 	ut_ad(plan->unique_search);
 	ut_ad(!plan->must_get_clust);
 #ifdef UNIV_SYNC_DEBUG
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
+	ut_ad(rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED));
 #endif /* UNIV_SYNC_DEBUG */
 
 	row_sel_open_pcur(plan, TRUE, mtr);
@@ -1318,6 +1322,7 @@ row_sel(
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
 	ibool		search_latch_locked;
+	rw_lock_t*	search_latch	= NULL;
 	ibool		consistent_read;
 
 	/* The following flag becomes TRUE when we are doing a
@@ -1395,11 +1400,23 @@ table_loop:
 	if (consistent_read && plan->unique_search && !plan->pcur_is_open
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
+		rw_lock_t*	latch = btr_search_get_latch(plan->index);
+
+		if (search_latch_locked && search_latch != latch) {
+			/* The index of this plan belongs to another
+			adaptive hash index partition */
+
+			rw_lock_s_unlock(search_latch);
+
+			search_latch_locked = FALSE;
+		}
+
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_lock(latch);
 
+			search_latch = latch;
 			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_WAIT_EX) {
+		} else if (rw_lock_get_writer(latch) == RW_LOCK_WAIT_EX) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1408,8 +1425,8 @@ table_loop:
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
+			rw_lock_s_lock(latch);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan, &mtr);
@@ -1432,7 +1449,7 @@ table_loop:
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 
 		search_latch_locked = FALSE;
 	}
@@ -2008,7 +2025,7 @@ lock_wait_or_error:
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 	}
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
@@ -3266,6 +3283,78 @@ row_sel_pop_cached_row_for_mysql(
 	}
 }
 
+/********************************************************************//**
+Allocates row buffers in the fetch cache up to prebuilt->fetch_cache_size. */
+static
+void
+row_sel_extend_fetch_cache(
+/*=======================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	byte**	cache;
+	byte*	buf;
+	ulint	i;
+
+	ut_ad(prebuilt->fetch_cache_alloc < prebuilt->fetch_cache_size);
+
+	cache = mem_alloc(prebuilt->fetch_cache_size * sizeof *cache);
+
+	if (prebuilt->fetch_cache != NULL) {
+		memcpy(cache, prebuilt->fetch_cache,
+		       prebuilt->fetch_cache_alloc * sizeof *cache);
+		mem_free(prebuilt->fetch_cache);
+	}
+
+	prebuilt->fetch_cache = cache;
+
+	for (i = prebuilt->fetch_cache_alloc;
+	     i < prebuilt->fetch_cache_size; i++) {
+
+		/* A user has reported memory corruption in these
+		buffers in Linux. Put magic numbers there to help
+		to track a possible bug. */
+
+		buf = mem_alloc(prebuilt->mysql_row_len + 8);
+
+		cache[i] = buf + 4;
+
+		mach_write_to_4(buf, ROW_PREBUILT_FETCH_MAGIC_N);
+		mach_write_to_4(buf + 4 + prebuilt->mysql_row_len,
+				ROW_PREBUILT_FETCH_MAGIC_N);
+	}
+
+	prebuilt->fetch_cache_alloc = prebuilt->fetch_cache_size;
+}
+
+/********************************************************************//**
+Doubles the number of rows to fetch in the next batch of a large scan,
+up to MYSQL_FETCH_CACHE_MAX_SIZE rows and MYSQL_FETCH_CACHE_MAX_BYTES
+bytes of row buffers. A long scan then re-positions its cursor and
+re-latches the index page only once per batch, while a short one does
+not fetch many rows that it will not return. */
+UNIV_INLINE
+void
+row_sel_grow_fetch_cache(
+/*=====================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	max_size;
+
+	if (!prebuilt->large_scan) {
+
+		return;
+	}
+
+	max_size = ut_min(MYSQL_FETCH_CACHE_MAX_SIZE,
+			  MYSQL_FETCH_CACHE_MAX_BYTES
+			  / (prebuilt->mysql_row_len + 8));
+
+	if (prebuilt->fetch_cache_size < max_size) {
+		prebuilt->fetch_cache_size = ut_min(
+			2 * prebuilt->fetch_cache_size, max_size);
+	}
+}
+
 /********************************************************************//**
 Pushes a row for MySQL to the fetch cache.
 @return TRUE on success, FALSE if the record contains incomplete BLOBs */
@@ -3283,31 +3372,13 @@ row_sel_push_cache_row_for_mysql(
 					prebuilt->index */
 	const ulint*	offsets)	/*!< in: rec_get_offsets(rec) */
 {
-	byte*	buf;
-	ulint	i;
-
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 	ut_ad(rec_offs_validate(rec, NULL, offsets));
 	ut_ad(!rec_get_deleted_flag(rec, rec_offs_comp(offsets)));
 	ut_a(!prebuilt->templ_contains_blob);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
-
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-
-			/* A user has reported memory corruption in these
-			buffers in Linux. Put magic numbers there to help
-			to track a possible bug. */
-
-			buf = mem_alloc(prebuilt->mysql_row_len + 8);
-
-			prebuilt->fetch_cache[i] = buf + 4;
-
-			mach_write_to_4(buf, ROW_PREBUILT_FETCH_MAGIC_N);
-			mach_write_to_4(buf + 4 + prebuilt->mysql_row_len,
-					ROW_PREBUILT_FETCH_MAGIC_N);
-		}
+	if (prebuilt->n_fetch_cached == prebuilt->fetch_cache_alloc) {
+		row_sel_extend_fetch_cache(prebuilt);
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
@@ -3399,6 +3470,112 @@ row_sel_try_search_shortcut_for_mysql(
 	return(SEL_FOUND);
 }
 
+/*********************************************************************//**
+Checks the index condition that MySQL pushed down to the secondary index
+being scanned. The columns of the index record that are in the template
+are stored in the MySQL record buffer before the condition is evaluated,
+so that a record that does not match is skipped before the clustered
+index record is looked up.
+@return ICP_NO_MATCH, ICP_MATCH, or ICP_OUT_OF_RANGE */
+static
+enum icp_result
+row_search_idx_cond_check(
+/*======================*/
+	byte*			mysql_rec,	/*!< out: the columns of
+						the index in MySQL format */
+	row_prebuilt_t*		prebuilt,	/*!< in/out: prebuilt struct
+						for the table handle */
+	const rec_t*		rec,		/*!< in: InnoDB record */
+	const ulint*		offsets)	/*!< in: rec_get_offsets() */
+{
+	ulint	i;
+
+	ut_ad(rec_offs_validate(rec, prebuilt->index, offsets));
+
+	if (!prebuilt->idx_cond) {
+		return(ICP_MATCH);
+	}
+
+	for (i = 0; i < prebuilt->n_template; i++) {
+		const mysql_row_templ_t*templ = prebuilt->mysql_template + i;
+		const byte*		data;
+		ulint			len;
+
+		if (templ->icp_rec_field_no == ULINT_UNDEFINED) {
+			continue;
+		}
+
+		/* Secondary index records do not contain externally
+		stored columns. */
+		ut_ad(!rec_offs_nth_extern(offsets, templ->icp_rec_field_no));
+
+		data = rec_get_nth_field(rec, offsets,
+					 templ->icp_rec_field_no, &len);
+
+		if (len != UNIV_SQL_NULL) {
+			row_sel_field_store_in_mysql_format(
+				mysql_rec + templ->mysql_col_offset,
+				templ, data, len);
+
+			if (templ->mysql_null_bit_mask) {
+				mysql_rec[templ->mysql_null_byte_offset]
+					&= ~(byte) templ->mysql_null_bit_mask;
+			}
+		} else {
+			mysql_rec[templ->mysql_null_byte_offset]
+				|= (byte) templ->mysql_null_bit_mask;
+			memcpy(mysql_rec + templ->mysql_col_offset,
+			       (const byte*) prebuilt->default_rec
+			       + templ->mysql_col_offset,
+			       templ->mysql_col_len);
+		}
+	}
+
+	switch (innobase_index_cond(prebuilt->idx_cond)) {
+	case ICP_NO_MATCH:
+		return(ICP_NO_MATCH);
+	case ICP_MATCH:
+		return(ICP_MATCH);
+	case ICP_OUT_OF_RANGE:
+	case ICP_ERROR:
+		break;
+	}
+
+	return(ICP_OUT_OF_RANGE);
+}
+
+/********************************************************************//**
+Issues the logical read-ahead of the leaf pages that a long ascending
+scan of row_search_for_mysql() is going to visit next. The next
+read-ahead is issued when the scan has consumed half of the pages. */
+static
+void
+row_sel_read_ahead_logical(
+/*=======================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	dict_index_t*	index,		/*!< in: index being scanned */
+	const btr_pcur_t* pcur)		/*!< in: persistent cursor whose
+					position is stored */
+{
+	ulint		n_pages;
+	mem_heap_t*	heap;
+	dtuple_t*	tuple;
+
+	n_pages = ut_min(srv_read_ahead_logical_pages,
+			 BTR_CUR_READ_AHEAD_MAX);
+
+	heap = mem_heap_create(256);
+
+	tuple = dict_index_build_data_tuple(index, pcur->old_rec,
+					    pcur->old_n_fields, heap);
+
+	btr_cur_read_ahead_leaves(index, tuple, n_pages);
+
+	mem_heap_free(heap);
+
+	prebuilt->ra_next = prebuilt->ra_n_pages + ut_max(n_pages / 2, 1);
+}
+
 /********************************************************************//**
 Searches for rows in the database. This is used in the interface to
 MySQL. This function opens a cursor, and also implements fetch next
@@ -3547,16 +3724,16 @@ row_search_for_mysql(
 	/* PHASE 0: Release a possible s-latch we are holding on the
 	adaptive hash index latch if there is someone waiting behind */
 
-	if (UNIV_UNLIKELY(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_NOT_LOCKED)
-	    && trx->has_search_latch) {
+	if (trx->has_search_latch
+	    && UNIV_UNLIKELY(rw_lock_get_writer(trx->search_latch)
+			     != RW_LOCK_NOT_LOCKED)) {
 
 		/* There is an x-latch request on the adaptive hash index:
 		release the s-latch to reduce starvation and wait for
 		BTR_SEA_TIMEOUT rounds before trying to keep it again over
 		calls from MySQL */
 
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
+		trx_search_latch_release_if_reserved(trx);
 
 		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 	}
@@ -3576,6 +3753,11 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
+
+		prebuilt->ra_page_no = FIL_NULL;
+		prebuilt->ra_n_pages = 0;
+		prebuilt->ra_next = SEL_READ_AHEAD_START;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3600,6 +3782,7 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_size = MYSQL_FETCH_CACHE_SIZE;
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_pop_cached_row_for_mysql(buf, prebuilt);
@@ -3612,7 +3795,8 @@ row_search_for_mysql(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_size) {
 
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -3709,9 +3893,19 @@ row_search_for_mysql(
 			hash index semaphore! */
 
 #ifndef UNIV_SEARCH_DEBUG
+			rw_lock_t*	latch = btr_search_get_latch(index);
+
+			if (trx->has_search_latch
+			    && trx->search_latch != latch) {
+				/* We hold the latch of another adaptive
+				hash index partition */
+				trx_search_latch_release_if_reserved(trx);
+			}
+
 			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
+				rw_lock_s_lock(latch);
 				trx->has_search_latch = TRUE;
+				trx->search_latch = latch;
 			}
 #endif
 			switch (row_sel_try_search_shortcut_for_mysql(
@@ -3772,8 +3966,8 @@ release_search_latch_if_needed:
 
 					trx->search_latch_timeout--;
 
-					rw_lock_s_unlock(&btr_search_latch);
-					trx->has_search_latch = FALSE;
+					trx_search_latch_release_if_reserved(
+						trx);
 				}
 
 				/* NOTE that we do NOT store the cursor
@@ -3795,10 +3989,7 @@ release_search_latch_if_needed:
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-	}
+	trx_search_latch_release_if_reserved(trx);
 
 	ut_ad(prebuilt->sql_stat_start || trx->conc_state == TRX_ACTIVE);
 	ut_ad(trx->conc_state == TRX_NOT_STARTED
@@ -4302,9 +4493,9 @@ no_gap_lock:
 				goto lock_wait_or_error;
 			}
 
-			mutex_enter(&kernel_mutex);
+			lock_mutex_enter_kernel();
 			if (trx->was_chosen_as_deadlock_victim) {
-				mutex_exit(&kernel_mutex);
+				lock_mutex_exit_kernel();
 				err = DB_DEADLOCK;
 
 				goto lock_wait_or_error;
@@ -4313,7 +4504,7 @@ no_gap_lock:
 				lock_cancel_waiting_and_release(
 					trx->wait_lock);
 			} else {
-				mutex_exit(&kernel_mutex);
+				lock_mutex_exit_kernel();
 
 				/* The lock was granted while we were
 				searching for the last committed version.
@@ -4325,7 +4516,7 @@ no_gap_lock:
 				err = DB_SUCCESS;
 				break;
 			}
-			mutex_exit(&kernel_mutex);
+			lock_mutex_exit_kernel();
 
 			if (old_vers == NULL) {
 				/* The row was not yet committed */
@@ -4393,7 +4584,21 @@ no_gap_lock:
 
 			if (!lock_sec_rec_cons_read_sees(
 				    rec, trx->read_view)) {
-				goto requires_clust_rec;
+				/* We should look at the clustered index.
+				However, as this is a non-locking read,
+				we can skip the clustered index lookup if
+				the condition does not match the secondary
+				index entry. */
+				switch (row_search_idx_cond_check(
+						buf, prebuilt, rec, offsets)) {
+				case ICP_NO_MATCH:
+					goto next_rec;
+				case ICP_OUT_OF_RANGE:
+					err = DB_RECORD_NOT_FOUND;
+					goto idx_cond_failed;
+				default:
+					goto requires_clust_rec;
+				}
 			}
 		}
 	}
@@ -4440,6 +4645,20 @@ no_gap_lock:
 		goto next_rec;
 	}
 
+	/* Check if the record matches the index condition. */
+	switch (row_search_idx_cond_check(buf, prebuilt, rec, offsets)) {
+	case ICP_NO_MATCH:
+		if (did_semi_consistent_read) {
+			row_unlock_for_mysql(prebuilt, TRUE);
+		}
+		goto next_rec;
+	case ICP_OUT_OF_RANGE:
+		err = DB_RECORD_NOT_FOUND;
+		goto idx_cond_failed;
+	default:
+		break;
+	}
+
 	/* Get the clustered index record if needed, if we did not do the
 	search using the clustered index. */
 
@@ -4554,7 +4773,9 @@ requires_clust_rec:
 			level, not here. */
 			ut_a(trx->isolation_level == TRX_ISO_READ_UNCOMMITTED);
 		} else if (prebuilt->n_fetch_cached
-			   == MYSQL_FETCH_CACHE_SIZE) {
+			   == prebuilt->fetch_cache_size) {
+
+			row_sel_grow_fetch_cache(prebuilt);
 
 			goto got_row;
 		}
@@ -4614,6 +4835,9 @@ requires_clust_rec:
 	/* From this point on, 'offsets' are invalid. */
 
 got_row:
+	err = DB_SUCCESS;
+
+idx_cond_failed:
 	/* We have an optimization to save CPU time: if this is a consistent
 	read on a unique condition on the clustered index, then we do not
 	store the pcur position, because any fetch next or prev will anyway
@@ -4630,8 +4854,6 @@ got_row:
 		btr_pcur_store_position(pcur, &mtr);
 	}
 
-	err = DB_SUCCESS;
-
 	goto normal_return;
 
 next_rec:
@@ -4777,8 +4999,27 @@ normal_return:
 	/*-------------------------------------------------------------*/
 	que_thr_stop_for_mysql_no_error(thr, trx);
 
+	if (moves_up && err == DB_SUCCESS && srv_read_ahead_logical_pages
+	    && !unique_search) {
+		ulint	page_no = buf_block_get_page_no(
+			btr_pcur_get_block(pcur));
+
+		if (page_no != prebuilt->ra_page_no) {
+			prebuilt->ra_page_no = page_no;
+			prebuilt->ra_n_pages++;
+		}
+	}
+
 	mtr_commit(&mtr);
 
+	if (prebuilt->ra_n_pages >= prebuilt->ra_next
+	    && srv_read_ahead_logical_pages
+	    && pcur->old_stored == BTR_PCUR_OLD_STORED
+	    && pcur->old_rec != NULL) {
+
+		row_sel_read_ahead_logical(prebuilt, index, pcur);
+	}
+
 	if (prebuilt->n_fetch_cached > 0) {
 		row_sel_pop_cached_row_for_mysql(buf, prebuilt);
 
@@ -4865,8 +5106,10 @@ row_search_check_if_query_cache_permitted(
 		if (trx->isolation_level >= TRX_ISO_REPEATABLE_READ
 		    && !trx->read_view) {
 
+			mutex_enter(&trx_sys->mutex);
 			trx->read_view = read_view_open_now(
 				trx->id, trx->global_read_view_heap);
+			mutex_exit(&trx_sys->mutex);
 			trx->global_read_view = trx->read_view;
 		}
 	}
@@ -48,8 +48,8 @@ Created 2/6/1997 Heikki Tuuri
 
 /*****************************************************************//**
 Finds out if an active transaction has inserted or modified a secondary
-index record. NOTE: the kernel mutex is temporarily released in this
-function!
+index record. NOTE: the kernel mutex and lock_sys->latch are temporarily
+released in this function!
 @return NULL if committed, else the active transaction */
 UNIV_INTERN
 trx_t*
@@ -77,12 +77,12 @@ row_vers_impl_x_locked_off_kernel(
 	mtr_t		mtr;
 	ulint		comp;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(lock_mutex_own());
 #ifdef UNIV_SYNC_DEBUG
 	ut_ad(!rw_lock_own(&(purge_sys->latch), RW_LOCK_SHARED));
 #endif /* UNIV_SYNC_DEBUG */
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 
 	mtr_start(&mtr);
 
@@ -107,7 +107,7 @@ row_vers_impl_x_locked_off_kernel(
 		a rollback we always undo the modifications to secondary index
 		records before the clustered index record. */
 
-		mutex_enter(&kernel_mutex);
+		lock_mutex_enter_kernel();
 		mtr_commit(&mtr);
 
 		return(NULL);
@@ -120,7 +120,7 @@ row_vers_impl_x_locked_off_kernel(
 
 	mtr_s_lock(&(purge_sys->latch), &mtr);
 
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	trx = NULL;
 	if (!trx_is_active(trx_id)) {
@@ -160,7 +160,7 @@ row_vers_impl_x_locked_off_kernel(
 		row_ext_t*	ext;
 		trx_id_t	prev_trx_id;
 
-		mutex_exit(&kernel_mutex);
+		lock_mutex_exit_kernel();
 
 		/* While we retrieve an earlier version of clust_rec, we
 		release the kernel mutex, because it may take time to access
@@ -180,7 +180,7 @@ row_vers_impl_x_locked_off_kernel(
 		mem_heap_free(heap2); /* free version and clust_offsets */
 
 		if (prev_version == NULL) {
-			mutex_enter(&kernel_mutex);
+			lock_mutex_enter_kernel();
 
 			if (!trx_is_active(trx_id)) {
 				/* Transaction no longer active: no
@@ -221,7 +221,7 @@ row_vers_impl_x_locked_off_kernel(
 		prev_version should be NULL. */
 		ut_a(entry);
 
-		mutex_enter(&kernel_mutex);
+		lock_mutex_enter_kernel();
 
 		if (!trx_is_active(trx_id)) {
 			/* Transaction no longer active: no implicit x-lock */
@@ -665,7 +665,7 @@ row_vers_build_for_semi_consistent_read(
 			rec_trx_id = version_trx_id;
 		}
 
-		mutex_enter(&kernel_mutex);
+		mutex_enter(&trx_sys->mutex);
 		version_trx = trx_get_on_id(version_trx_id);
 		if (version_trx
 		    && (version_trx->conc_state == TRX_COMMITTED_IN_MEMORY
@@ -673,7 +673,7 @@ row_vers_build_for_semi_consistent_read(
 
 			version_trx = NULL;
 		}
-		mutex_exit(&kernel_mutex);
+		mutex_exit(&trx_sys->mutex);
 
 		if (!version_trx) {
 
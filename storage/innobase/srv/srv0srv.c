@@ -86,6 +86,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "trx0i_s.h"
 #include "os0sync.h" /* for HAVE_ATOMIC_BUILTINS */
 #include "read0read.h"
+#include "page0zip.h"
 #include "mysql/plugin.h"
 #include "mysql/service_thd_wait.h"
 
@@ -215,10 +216,19 @@ UNIV_INTERN ulint       srv_buf_pool_instances  = 1;
 UNIV_INTERN ulint	srv_buf_pool_old_size;
 /* current size in kilobytes */
 UNIV_INTERN ulint	srv_buf_pool_curr_size	= 0;
+/* name of the buffer pool dump file, relative to srv_data_home */
+UNIV_INTERN char*	srv_buf_dump_filename;
+/* dump the buffer pool at shutdown */
+UNIV_INTERN my_bool	srv_buffer_pool_dump_at_shutdown = FALSE;
+/* load the buffer pool at startup */
+UNIV_INTERN my_bool	srv_buffer_pool_load_at_startup = FALSE;
 /* size in bytes */
 UNIV_INTERN ulint	srv_mem_pool_size	= ULINT_MAX;
 UNIV_INTERN ulint	srv_lock_table_size	= ULINT_MAX;
 
+/* number of adaptive hash index partitions */
+UNIV_INTERN ulint	srv_adaptive_hash_index_parts	= 1;
+
 /* This parameter is deprecated. Use srv_n_io_[read|write]_threads
 instead. */
 UNIV_INTERN ulint	srv_n_file_io_threads	= ULINT_MAX;
@@ -231,6 +241,10 @@ UNIV_INTERN my_bool	srv_random_read_ahead	= FALSE;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 UNIV_INTERN ulong	srv_read_ahead_threshold	= 56;
+/* Number of leaf pages that an ascending index scan reads ahead by
+following the node pointers of the parent level; 0 disables this
+logical read-ahead. */
+UNIV_INTERN ulong	srv_read_ahead_logical_pages	= 0;
 
 #ifdef UNIV_LOG_ARCHIVE
 UNIV_INTERN ibool		srv_log_archive_on	= FALSE;
@@ -320,6 +334,16 @@ UNIV_INTERN ulint srv_buf_pool_wait_free = 0;
 pool to the disk */
 UNIV_INTERN ulint srv_buf_pool_flushed = 0;
 
+/* number of pages written from the buffer pool, by the reason for
+the flush */
+UNIV_INTERN ulint srv_buf_pool_flushed_lru = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_lru_foreground = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_adaptive = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_max_dirty = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_async = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_sync = 0;
+UNIV_INTERN ulint srv_buf_pool_flushed_background = 0;
+
 /** Number of buffer pool reads that led to the
 reading of a disk page */
 UNIV_INTERN ulint srv_buf_pool_reads = 0;
@@ -349,7 +373,7 @@ concurrency check. */
 UNIV_INTERN ulong	srv_thread_concurrency	= 0;
 
 /* this mutex protects srv_conc data structures */
-UNIV_INTERN os_fast_mutex_t	srv_conc_mutex;
+UNIV_INTERN mutex_t	srv_conc_mutex;
 /* number of transactions that have declared_to_be_inside_innodb set.
 It used to be a non-error for this value to drop below zero temporarily.
 This is no longer true. We'll, however, keep the lint datatype to add
@@ -400,11 +424,37 @@ UNIV_INTERN ibool	srv_innodb_status	= FALSE;
 this many index pages */
 UNIV_INTERN unsigned long long	srv_stats_sample_pages = 8;
 
+/* Keep the index statistics in SYS_STATS, so that they are loaded
+instead of recalculated when a table is opened, innodb_stats_persistent */
+UNIV_INTERN my_bool	srv_stats_persistent = FALSE;
+
+/* When calculating statistics that are kept in SYS_STATS, sample this
+many index pages, innodb_stats_persistent_sample_pages */
+UNIV_INTERN unsigned long long	srv_stats_persistent_sample_pages = 20;
+
+/* Collect the compression statistics of each index for
+INFORMATION_SCHEMA.INNODB_CMP_PER_INDEX, innodb_cmp_per_index_enabled */
+UNIV_INTERN my_bool	srv_cmp_per_index_enabled = FALSE;
+
 UNIV_INTERN ibool	srv_use_doublewrite_buf	= TRUE;
+/* If set, the doublewrite buffer is kept in this file, relative to
+srv_data_home, with separate areas for each buffer pool instance and
+flush type, instead of the system tablespace, innodb_doublewrite_file */
+UNIV_INTERN char*	srv_doublewrite_file	= NULL;
 UNIV_INTERN ibool	srv_use_checksums = TRUE;
+/* The algorithm used for the page checksums, one of
+srv_checksum_algorithm_t */
+UNIV_INTERN ulong	srv_checksum_algorithm = SRV_CHECKSUM_ALGORITHM_INNODB;
 
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
+/* Number of threads that sort and load the indexes of a fast index
+creation, innodb_merge_threads */
+UNIV_INTERN ulong	srv_merge_threads		= 4;
+/* Percentage of each page that a bulk load of an index fills,
+innodb_fill_factor */
+UNIV_INTERN ulong	srv_fill_factor			= 100;
+
 /*-------------------------------------------*/
 UNIV_INTERN ulong	srv_n_spin_wait_rounds	= 30;
 UNIV_INTERN ulong	srv_n_free_tickets_to_enter = 500;
@@ -463,6 +513,8 @@ UNIV_INTERN mutex_t	srv_monitor_file_mutex;
 #ifdef UNIV_PFS_MUTEX
 /* Key to register kernel_mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	kernel_mutex_key;
+/* Key to register srv_conc_mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	srv_conc_mutex_key;
 /* Key to register srv_innodb_monitor_mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	srv_innodb_monitor_mutex_key;
 /* Key to register srv_monitor_file_mutex with performance schema */
@@ -512,13 +564,6 @@ thread ensures that we flush the log files at least once per
 second. */
 static time_t	srv_last_log_flush_time;
 
-/* The master thread performs various tasks based on the current
-state of IO activity and the level of IO utilization is past
-intervals. Following macros define thresholds for these conditions. */
-#define SRV_PEND_IO_THRESHOLD	(PCT_IO(3))
-#define SRV_RECENT_IO_ACTIVITY	(PCT_IO(5))
-#define SRV_PAST_IO_ACTIVITY	(PCT_IO(200))
-
 /*
 	IMPLEMENTATION OF THE SERVER MAIN PROGRAM
 	=========================================
@@ -1070,7 +1115,7 @@ srv_init(void)
 
 	/* Init the server concurrency restriction data structures */
 
-	os_fast_mutex_init(&srv_conc_mutex);
+	mutex_create(srv_conc_mutex_key, &srv_conc_mutex, SYNC_SRV_CONC);
 
 	UT_LIST_INIT(srv_conc_queue);
 
@@ -1085,6 +1130,8 @@ srv_init(void)
 
 	/* Initialize some INFORMATION SCHEMA internal structures */
 	trx_i_s_cache_init(trx_i_s_cache);
+
+	page_zip_stat_per_index_init();
 }
 
 /*********************************************************************//**
@@ -1094,7 +1141,6 @@ void
 srv_free(void)
 /*==========*/
 {
-	os_fast_mutex_free(&srv_conc_mutex);
 	mem_free(srv_conc_slots);
 	srv_conc_slots = NULL;
 
@@ -1108,6 +1154,8 @@ srv_free(void)
 	srv_mysql_table = NULL;
 
 	trx_i_s_cache_free(trx_i_s_cache);
+
+	page_zip_stat_per_index_free();
 }
 
 /*********************************************************************//**
@@ -1168,7 +1216,7 @@ srv_conc_enter_innodb(
 		return;
 	}
 
-	os_fast_mutex_lock(&srv_conc_mutex);
+	mutex_enter(&srv_conc_mutex);
 retry:
 	if (trx->declared_to_be_inside_innodb) {
 		ut_print_timestamp(stderr);
@@ -1177,7 +1225,7 @@ retry:
 		      "InnoDB: it already is declared.\n", stderr);
 		trx_print(stderr, trx, 0);
 		putc('\n', stderr);
-		os_fast_mutex_unlock(&srv_conc_mutex);
+		mutex_exit(&srv_conc_mutex);
 
 		return;
 	}
@@ -1190,7 +1238,7 @@ retry:
 		trx->declared_to_be_inside_innodb = TRUE;
 		trx->n_tickets_to_enter_innodb = SRV_FREE_TICKETS_TO_ENTER;
 
-		os_fast_mutex_unlock(&srv_conc_mutex);
+		mutex_exit(&srv_conc_mutex);
 
 		return;
 	}
@@ -1206,7 +1254,7 @@ retry:
 
 		srv_conc_n_waiting_threads++;
 
-		os_fast_mutex_unlock(&srv_conc_mutex);
+		mutex_exit(&srv_conc_mutex);
 
 		trx->op_info = "sleeping before joining InnoDB queue";
 
@@ -1221,7 +1269,7 @@ retry:
 
 		trx->op_info = "";
 
-		os_fast_mutex_lock(&srv_conc_mutex);
+		mutex_enter(&srv_conc_mutex);
 
 		srv_conc_n_waiting_threads--;
 
@@ -1247,7 +1295,7 @@ retry:
 		trx->declared_to_be_inside_innodb = TRUE;
 		trx->n_tickets_to_enter_innodb = 0;
 
-		os_fast_mutex_unlock(&srv_conc_mutex);
+		mutex_exit(&srv_conc_mutex);
 
 		return;
 	}
@@ -1267,7 +1315,7 @@ retry:
 
 	srv_conc_n_waiting_threads++;
 
-	os_fast_mutex_unlock(&srv_conc_mutex);
+	mutex_exit(&srv_conc_mutex);
 
 	/* Go to wait for the event; when a thread leaves InnoDB it will
 	release this thread */
@@ -1284,7 +1332,7 @@ retry:
 
 	trx->op_info = "";
 
-	os_fast_mutex_lock(&srv_conc_mutex);
+	mutex_enter(&srv_conc_mutex);
 
 	srv_conc_n_waiting_threads--;
 
@@ -1298,7 +1346,7 @@ retry:
 	trx->declared_to_be_inside_innodb = TRUE;
 	trx->n_tickets_to_enter_innodb = SRV_FREE_TICKETS_TO_ENTER;
 
-	os_fast_mutex_unlock(&srv_conc_mutex);
+	mutex_exit(&srv_conc_mutex);
 }
 
 /*********************************************************************//**
@@ -1322,13 +1370,13 @@ srv_conc_force_enter_innodb(
 
 	ut_ad(srv_conc_n_threads >= 0);
 
-	os_fast_mutex_lock(&srv_conc_mutex);
+	mutex_enter(&srv_conc_mutex);
 
 	srv_conc_n_threads++;
 	trx->declared_to_be_inside_innodb = TRUE;
 	trx->n_tickets_to_enter_innodb = 1;
 
-	os_fast_mutex_unlock(&srv_conc_mutex);
+	mutex_exit(&srv_conc_mutex);
 }
 
 /*********************************************************************//**
@@ -1354,7 +1402,7 @@ srv_conc_force_exit_innodb(
 		return;
 	}
 
-	os_fast_mutex_lock(&srv_conc_mutex);
+	mutex_enter(&srv_conc_mutex);
 
 	ut_ad(srv_conc_n_threads > 0);
 	srv_conc_n_threads--;
@@ -1381,7 +1429,7 @@ srv_conc_force_exit_innodb(
 		}
 	}
 
-	os_fast_mutex_unlock(&srv_conc_mutex);
+	mutex_exit(&srv_conc_mutex);
 
 	if (slot != NULL) {
 		os_event_set(slot->event);
@@ -1834,6 +1882,7 @@ srv_printf_innodb_monitor(
 	double	time_elapsed;
 	time_t	current_time;
 	ulint	n_reserved;
+	ulint	i;
 	ibool	ret;
 
 	mutex_enter(&srv_innodb_monitor_mutex);
@@ -1919,7 +1968,9 @@ srv_printf_innodb_monitor(
 	      "-------------------------------------\n", file);
 	ibuf_print(file);
 
-	ha_print_info(file, btr_search_sys->hash_index);
+	for (i = 0; i < btr_search_n_parts; i++) {
+		ha_print_info(file, btr_search_sys->hash_index[i]);
+	}
 
 	fprintf(file,
 		"%.2f hash searches/s, %.2f non-hash searches/s\n",
@@ -2022,6 +2073,7 @@ srv_export_innodb_status(void)
 	ulint			LRU_len;
 	ulint			free_len;
 	ulint			flush_list_len;
+	ulint			i;
 
 	buf_get_total_stat(&stat);
 	buf_get_total_list_len(&LRU_len, &free_len, &flush_list_len);
@@ -2046,6 +2098,20 @@ srv_export_innodb_status(void)
 		= srv_buf_pool_write_requests;
 	export_vars.innodb_buffer_pool_wait_free = srv_buf_pool_wait_free;
 	export_vars.innodb_buffer_pool_pages_flushed = srv_buf_pool_flushed;
+	export_vars.innodb_buffer_pool_pages_flushed_lru
+		= srv_buf_pool_flushed_lru;
+	export_vars.innodb_buffer_pool_pages_flushed_lru_foreground
+		= srv_buf_pool_flushed_lru_foreground;
+	export_vars.innodb_buffer_pool_pages_flushed_adaptive
+		= srv_buf_pool_flushed_adaptive;
+	export_vars.innodb_buffer_pool_pages_flushed_max_dirty
+		= srv_buf_pool_flushed_max_dirty;
+	export_vars.innodb_buffer_pool_pages_flushed_async
+		= srv_buf_pool_flushed_async;
+	export_vars.innodb_buffer_pool_pages_flushed_sync
+		= srv_buf_pool_flushed_sync;
+	export_vars.innodb_buffer_pool_pages_flushed_background
+		= srv_buf_pool_flushed_background;
 	export_vars.innodb_buffer_pool_reads = srv_buf_pool_reads;
 	export_vars.innodb_buffer_pool_read_ahead_rnd
 		= stat.n_ra_pages_read_rnd;
@@ -2053,6 +2119,12 @@ srv_export_innodb_status(void)
 		= stat.n_ra_pages_read;
 	export_vars.innodb_buffer_pool_read_ahead_evicted
 		= stat.n_ra_pages_evicted;
+	export_vars.innodb_buffer_pool_read_ahead_logical
+		= stat.n_ra_pages_read_logical;
+	export_vars.innodb_buffer_pool_read_ahead_logical_used
+		= stat.n_ra_pages_logical_used;
+	export_vars.innodb_buffer_pool_read_ahead_logical_evicted
+		= stat.n_ra_pages_logical_evicted;
 	export_vars.innodb_buffer_pool_pages_data = LRU_len;
 	export_vars.innodb_buffer_pool_bytes_data =
 		buf_pools_list_size.LRU_bytes
@@ -2102,9 +2174,28 @@ srv_export_innodb_status(void)
 	export_vars.innodb_rows_read = srv_n_rows_read;
 	export_vars.innodb_rows_inserted = srv_n_rows_inserted;
 	export_vars.innodb_rows_updated = srv_n_rows_updated;
+	export_vars.innodb_history_list_length = trx_sys->rseg_history_len;
+	export_vars.innodb_purge_lag_per_sec = purge_sys->lag_per_sec;
+	export_vars.innodb_purge_undo_records_per_sec
+		= purge_sys->recs_per_sec;
 	export_vars.innodb_rows_deleted = srv_n_rows_deleted;
 	export_vars.innodb_truncated_status_writes = srv_truncated_status_writes;
 
+	export_vars.innodb_kernel_mutex_os_waits = kernel_mutex.count_os_wait;
+	export_vars.innodb_lock_sys_latch_os_waits
+		= lock_sys->latch.count_os_wait;
+	export_vars.innodb_lock_rec_mutex_os_waits = 0;
+	for (i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		export_vars.innodb_lock_rec_mutex_os_waits
+			+= lock_sys->rec_mutexes[i].count_os_wait;
+	}
+	export_vars.innodb_trx_sys_mutex_os_waits
+		= trx_sys->mutex.count_os_wait;
+	export_vars.innodb_read_view_mutex_os_waits
+		= trx_sys->read_view_mutex.count_os_wait;
+	export_vars.innodb_srv_conc_mutex_os_waits
+		= srv_conc_mutex.count_os_wait;
+
 #ifdef UNIV_DEBUG
 	{
 		trx_id_t	done_trx_no;
@@ -2335,7 +2426,7 @@ loop:
 
 	srv_lock_timeout_active = TRUE;
 
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	some_waits = FALSE;
 
@@ -2380,7 +2471,7 @@ loop:
 
 	os_event_reset(srv_lock_timeout_thread_event);
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 
 	if (srv_shutdown_state >= SRV_SHUTDOWN_CLEANUP) {
 		goto exit_func;
@@ -2482,6 +2573,9 @@ loop:
 	/* Update the statistics collected for flush rate policy. */
 	buf_flush_stat_update();
 
+	/* Update the purge rate and purge lag. */
+	trx_purge_stat_update();
+
 	/* In case mutex_exit is not a memory barrier, it is
 	theoretically possible some threads are left waiting though
 	the semaphore is already released. Wake up those threads: */
@@ -2761,7 +2855,6 @@ srv_master_thread(
 	ulint		n_tables_to_drop;
 	ulint		n_ios;
 	ulint		n_ios_old;
-	ulint		n_ios_very_old;
 	ulint		n_pend_ios;
 	ulint		next_itr_time;
 	ulint		i;
@@ -2796,9 +2889,6 @@ loop:
 
 	srv_main_thread_op_info = "reserving kernel mutex";
 
-	buf_get_total_stat(&buf_stat);
-	n_ios_very_old = log_sys->n_log_ios + buf_stat.n_pages_read
-		+ buf_stat.n_pages_written;
 	mutex_enter(&kernel_mutex);
 
 	/* Store the user activity counter at the start of this loop */
@@ -2896,7 +2986,8 @@ loop:
 		n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
 			+ buf_stat.n_pages_written;
 		if (n_pend_ios < SRV_PEND_IO_THRESHOLD
-		    && (n_ios - n_ios_old < SRV_RECENT_IO_ACTIVITY)) {
+		    && (n_ios - n_ios_old < SRV_RECENT_IO_ACTIVITY)
+		    && !ibuf_merge_thread_active) {
 			srv_main_thread_op_info = "doing insert buffer merge";
 			ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
 
@@ -2904,34 +2995,8 @@ loop:
 			srv_sync_log_buffer_in_background();
 		}
 
-		if (UNIV_UNLIKELY(buf_get_modified_ratio_pct()
-				  > srv_max_buf_pool_modified_pct)) {
-
-			/* Try to keep the number of modified pages in the
-			buffer pool under the limit wished by the user */
-
-			srv_main_thread_op_info =
-				"flushing buffer pool pages";
-			n_pages_flushed = buf_flush_list(
-				PCT_IO(100), IB_ULONGLONG_MAX);
-
-		} else if (srv_adaptive_flushing) {
-
-			/* Try to keep the rate of flushing of dirty
-			pages such that redo log generation does not
-			produce bursts of IO at checkpoint time. */
-			ulint n_flush = buf_flush_get_desired_flush_rate();
-
-			if (n_flush) {
-				srv_main_thread_op_info =
-					"flushing buffer pool pages";
-				n_flush = ut_min(PCT_IO(100), n_flush);
-				n_pages_flushed =
-					buf_flush_list(
-						n_flush,
-						IB_ULONGLONG_MAX);
-			}
-		}
+		/* Dirty pages are flushed by the page cleaner thread,
+		see buf_flush_page_cleaner_thread() */
 
 		if (srv_activity_count == old_activity_count) {
 
@@ -2950,40 +3015,20 @@ loop:
 	seconds */
 	mem_validate_all_blocks();
 #endif
-	/* If i/os during the 10 second period were less than 200% of
-	capacity, we assume that there is free disk i/o capacity
-	available, and it makes sense to flush srv_io_capacity pages.
-
-	Note that this is done regardless of the fraction of dirty
-	pages relative to the max requested by the user. The one second
-	loop above requests writes for that case. The writes done here
-	are not required, and may be disabled. */
-
-	buf_get_total_stat(&buf_stat);
-	n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
-	n_ios = log_sys->n_log_ios + buf_stat.n_pages_read
-		+ buf_stat.n_pages_written;
-
 	srv_main_10_second_loops++;
-	if (n_pend_ios < SRV_PEND_IO_THRESHOLD
-	    && (n_ios - n_ios_very_old < SRV_PAST_IO_ACTIVITY)) {
 
-		srv_main_thread_op_info = "flushing buffer pool pages";
-		buf_flush_list(PCT_IO(100), IB_ULONGLONG_MAX);
+	/* We run a batch of insert buffer merge every 10 seconds,
+	even if the server were active, unless the ibuf merge thread
+	does that, see ibuf_merge_thread() */
+
+	if (!ibuf_merge_thread_active) {
+		srv_main_thread_op_info = "doing insert buffer merge";
+		ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
 
 		/* Flush logs if needed */
 		srv_sync_log_buffer_in_background();
 	}
 
-	/* We run a batch of insert buffer merge every 10 seconds,
-	even if the server were active */
-
-	srv_main_thread_op_info = "doing insert buffer merge";
-	ibuf_contract_for_n_pages(FALSE, PCT_IO(5));
-
-	/* Flush logs if needed */
-	srv_sync_log_buffer_in_background();
-
 	if (srv_n_purge_threads == 0) {
 		srv_main_thread_op_info = "master purging";
 
@@ -2995,27 +3040,6 @@ loop:
 		}
 	}
 
-	srv_main_thread_op_info = "flushing buffer pool pages";
-
-	/* Flush a few oldest pages to make a new checkpoint younger */
-
-	if (buf_get_modified_ratio_pct() > 70) {
-
-		/* If there are lots of modified pages in the buffer pool
-		(> 70 %), we assume we can afford reserving the disk(s) for
-		the time it requires to flush 100 pages */
-
-		n_pages_flushed = buf_flush_list(
-			PCT_IO(100), IB_ULONGLONG_MAX);
-	} else {
-		/* Otherwise, we only flush a small number of pages so that
-		we do not unnecessarily use much disk i/o capacity from
-		other work */
-
-		n_pages_flushed = buf_flush_list(
-			  PCT_IO(10), IB_ULONGLONG_MAX);
-	}
-
 	srv_main_thread_op_info = "making checkpoint";
 
 	/* Make a new checkpoint about once in 10 seconds */
@@ -3081,6 +3105,13 @@ background_loop:
 
 	if (srv_fast_shutdown && srv_shutdown_state > 0) {
 		n_bytes_merged = 0;
+	} else if (ibuf_merge_thread_active
+		   && srv_shutdown_state == SRV_SHUTDOWN_NONE) {
+		/* The ibuf merge thread merges at full
+		innodb_io_capacity when the server is idle. It exits
+		at shutdown, and a slow shutdown completes the merge
+		here. */
+		n_bytes_merged = 0;
 	} else {
 		/* This should do an amount of IO similar to the number of
 		dirty pages that will be flushed in the call to
@@ -3105,6 +3136,8 @@ flush_loop:
 	if (srv_fast_shutdown < 2 || srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 		n_pages_flushed = buf_flush_list(
 			  PCT_IO(100), IB_ULONGLONG_MAX);
+
+		srv_buf_pool_flushed_background += n_pages_flushed;
 	} else {
 		/* In the fastest shutdown we do not flush the buffer pool
 		to data files: we set n_pages_flushed to 0 artificially. */
@@ -3248,7 +3281,7 @@ srv_purge_thread(
 	ulint		n_total_purged = ULINT_UNDEFINED;
 
 	my_thread_init();
-	ut_a(srv_n_purge_threads == 1);
+	ut_a(srv_n_purge_threads > 0);
 
 #ifdef UNIV_PFS_THREAD
 	pfs_register_thread(srv_purge_thread_key);
@@ -3318,6 +3351,8 @@ srv_purge_thread(
 		srv_sync_log_buffer_in_background();
 	}
 
+	trx_purge_stop_workers();
+
 	mutex_enter(&kernel_mutex);
 
 	/* Decrement the active count. */
@@ -3341,6 +3376,42 @@ srv_purge_thread(
 	OS_THREAD_DUMMY_RETURN;	/* Not reached, avoid compiler warning */
 }
 
+/*********************************************************************//**
+Purge worker thread: purges the parts of the purge batches that
+srv_purge_thread() hands to it.
+@return	a dummy parameter */
+UNIV_INTERN
+os_thread_ret_t
+srv_purge_worker_thread(
+/*====================*/
+	void*	arg)	/*!< in: trx_purge_worker_t of this thread */
+{
+	trx_purge_worker_t*	worker = arg;
+
+	my_thread_init();
+
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(srv_purge_worker_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+#ifdef UNIV_DEBUG_THREAD_CREATION
+	fprintf(stderr, "InnoDB: Purge worker thread running, id %lu\n",
+		os_thread_pf(os_thread_get_curr_id()));
+#endif /* UNIV_DEBUG_THREAD_CREATION */
+
+	while (trx_purge_worker_wait_and_run(worker)) {
+		/* Empty */
+	}
+
+	my_thread_end();
+
+	/* We count the number of threads in os_thread_exit(). A created
+	thread should always use that to exit and not use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;	/* Not reached, avoid compiler warning */
+}
+
 /**********************************************************************//**
 Enqueues a task to server task queue and releases a worker thread, if there
 is a suspended one. */
@@ -62,6 +62,8 @@ Created 2/16/1996 Heikki Tuuri
 #include "ibuf0ibuf.h"
 #include "srv0start.h"
 #include "srv0srv.h"
+#include "ut0crc32.h"
+#include "buf0dump.h"
 #ifndef UNIV_HOTBACKUP
 # include "os0proc.h"
 # include "sync0sync.h"
@@ -79,6 +81,7 @@ Created 2/16/1996 Heikki Tuuri
 # include "btr0sea.h"
 # include "rem0cmp.h"
 # include "dict0crea.h"
+# include "dict0stats.h"
 # include "row0ins.h"
 # include "row0sel.h"
 # include "row0upd.h"
@@ -122,7 +125,7 @@ static os_file_t	files[1000];
 /** io_handler_thread parameters for thread identification */
 static ulint		n[SRV_MAX_N_IO_THREADS + 6];
 /** io_handler_thread identifiers */
-static os_thread_id_t	thread_ids[SRV_MAX_N_IO_THREADS + 6];
+static os_thread_id_t	thread_ids[SRV_MAX_N_IO_THREADS + 7];
 
 /** We use this mutex to test the return value of pthread_mutex_trylock
    on successful locking. HP-UX does NOT return 0, though Linux et al do. */
@@ -144,6 +147,13 @@ UNIV_INTERN mysql_pfs_key_t	srv_error_monitor_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_monitor_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_master_thread_key;
 UNIV_INTERN mysql_pfs_key_t	srv_purge_thread_key;
+UNIV_INTERN mysql_pfs_key_t	srv_purge_worker_thread_key;
+UNIV_INTERN mysql_pfs_key_t	buf_page_cleaner_thread_key;
+UNIV_INTERN mysql_pfs_key_t	buf_dump_thread_key;
+UNIV_INTERN mysql_pfs_key_t	recv_apply_thread_key;
+UNIV_INTERN mysql_pfs_key_t	row_merge_thread_key;
+UNIV_INTERN mysql_pfs_key_t	dict_stats_thread_key;
+UNIV_INTERN mysql_pfs_key_t	ibuf_merge_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 /*********************************************************************//**
@@ -497,12 +507,6 @@ io_handler_thread(
 }
 #endif /* !UNIV_HOTBACKUP */
 
-#ifdef __WIN__
-#define SRV_PATH_SEPARATOR	'\\'
-#else
-#define SRV_PATH_SEPARATOR	'/'
-#endif
-
 /*********************************************************************//**
 Normalizes a directory path for Windows: converts slashes to backslashes. */
 UNIV_INTERN
@@ -1164,6 +1168,13 @@ innobase_start_or_create_for_mysql(void)
 	fputs(" InnoDB: and extra copying\n", stderr);
 #endif /* UNIV_ZIP_COPY */
 
+	ut_crc32_init();
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, " InnoDB: Using %s to compute crc32 checksums\n",
+		ut_crc32_sse42_enabled
+		? "CPU crc32 instructions" : "software crc32");
+
 	/* Since InnoDB does not currently clean up all its internal data
 	structures in MySQL Embedded Server Library server_end(), we
 	print an error message if someone tries to start up InnoDB a
@@ -1859,6 +1870,14 @@ innobase_start_or_create_for_mysql(void)
 	os_thread_create(&srv_monitor_thread, NULL,
 			 thread_ids + 4 + SRV_MAX_N_IO_THREADS);
 
+	/* Create the thread which flushes dirty pages */
+	os_thread_create(&buf_flush_page_cleaner_thread, NULL,
+			 thread_ids + 5 + SRV_MAX_N_IO_THREADS);
+
+	/* Create the thread which loads and dumps the buffer pool */
+	os_thread_create(&buf_dump_thread, NULL,
+			 thread_ids + 6 + SRV_MAX_N_IO_THREADS);
+
 	srv_is_being_started = FALSE;
 
 	err = dict_create_or_check_foreign_constraint_tables();
@@ -1867,26 +1886,45 @@ innobase_start_or_create_for_mysql(void)
 		return((int)DB_ERROR);
 	}
 
+	err = dict_create_or_check_stats_table();
+
+	if (err != DB_SUCCESS) {
+		return((int)DB_ERROR);
+	}
+
+	/* Create the thread which recalculates the persistent index
+	statistics */
+	os_thread_create(&dict_stats_thread, NULL, NULL);
+
+	/* Create the thread which merges the insert buffer to the
+	pages with the most buffered changes */
+	if (srv_force_recovery < SRV_FORCE_NO_IBUF_MERGE) {
+		os_thread_create(&ibuf_merge_thread, NULL, NULL);
+	}
+
 	/* Create the master thread which does purge and other utility
 	operations */
 
 	os_thread_create(&srv_master_thread, NULL, thread_ids
 			 + (1 + SRV_MAX_N_IO_THREADS));
 
-	/* Currently we allow only a single purge thread. */
-	ut_a(srv_n_purge_threads == 0 || srv_n_purge_threads == 1);
-
-	/* If the user has requested a separate purge thread then
-	start the purge thread. */
-	if (srv_n_purge_threads == 1) {
+	/* If the user has requested separate purge threads then start
+	the purge coordinator thread, and the worker threads that share
+	the purge batches with it. */
+	if (srv_n_purge_threads > 0) {
 		os_thread_create(&srv_purge_thread, NULL, NULL);
+
+		for (i = 1; i < srv_n_purge_threads; i++) {
+			os_thread_create(&srv_purge_worker_thread,
+					 &purge_sys->workers[i], NULL);
+		}
 	}
 
 	/* Wait for the purge and master thread to startup. */
 
 	while (srv_shutdown_state == SRV_SHUTDOWN_NONE) {
 		if (srv_thread_has_reserved_slot(SRV_MASTER) == ULINT_UNDEFINED
-		    || (srv_n_purge_threads == 1
+		    || (srv_n_purge_threads > 0
 			&& srv_thread_has_reserved_slot(SRV_WORKER)
 			== ULINT_UNDEFINED)) {
 
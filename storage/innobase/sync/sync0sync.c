@@ -1068,7 +1068,7 @@ sync_thread_levels_nonempty_gen(
 
 /******************************************************************//**
 Checks if the level array for the current thread is empty,
-except for the btr_search_latch.
+except for an adaptive hash index latch.
 @return	a latch, or NULL if empty except the exceptions specified below */
 UNIV_INTERN
 void*
@@ -1076,7 +1076,8 @@ sync_thread_levels_nonempty_trx(
 /*============================*/
 	ibool	has_search_latch)
 				/*!< in: TRUE if and only if the thread
-				is supposed to hold btr_search_latch */
+				is supposed to hold an adaptive hash
+				index latch */
 {
 	ulint		i;
 	sync_arr_t*	arr;
@@ -1217,9 +1218,12 @@ sync_thread_add_level(
 	case SYNC_ANY_LATCH:
 	case SYNC_FILE_FORMAT_TAG:
 	case SYNC_DOUBLEWRITE:
-	case SYNC_SEARCH_SYS:
 	case SYNC_TRX_LOCK_HEAP:
 	case SYNC_KERNEL:
+	case SYNC_LOCK_SYS:
+	case SYNC_TRX_SYS:
+	case SYNC_READ_VIEW:
+	case SYNC_SRV_CONC:
 	case SYNC_IBUF_BITMAP_MUTEX:
 	case SYNC_RSEG:
 	case SYNC_TRX_UNDO:
@@ -1240,6 +1244,7 @@ sync_thread_add_level(
 		break;
 	case SYNC_BUF_FLUSH_LIST:
 	case SYNC_BUF_POOL:
+	case SYNC_SEARCH_SYS:
 		/* We can have multiple mutexes of this type therefore we
 		can only check whether the greater than condition holds. */
 		if (!sync_thread_levels_g(array, level-1, TRUE)) {
@@ -1260,12 +1265,10 @@ sync_thread_add_level(
 		}
 		break;
 	case SYNC_REC_LOCK:
-		if (sync_thread_levels_contain(array, SYNC_KERNEL)) {
-			ut_a(sync_thread_levels_g(array, SYNC_REC_LOCK - 1,
-						  TRUE));
-		} else {
-			ut_a(sync_thread_levels_g(array, SYNC_REC_LOCK, TRUE));
-		}
+		/* The record lock hash cell mutexes are only reserved
+		under an S-latch on lock_sys->latch, one at a time. */
+		ut_a(sync_thread_levels_contain(array, SYNC_LOCK_SYS));
+		ut_a(sync_thread_levels_g(array, SYNC_REC_LOCK, TRUE));
 		break;
 	case SYNC_IBUF_BITMAP:
 		/* Either the thread must own the master mutex to all
@@ -195,29 +195,73 @@ this query graph.
 @return	own: the query graph */
 static
 que_t*
-trx_purge_graph_build(void)
-/*=======================*/
+trx_purge_graph_build(
+/*==================*/
+	trx_t*		trx,	/*!< in: purge transaction */
+	purge_node_t**	node)	/*!< out: the purge node of the graph */
 {
 	mem_heap_t*	heap;
 	que_fork_t*	fork;
 	que_thr_t*	thr;
-	/*	que_thr_t*	thr2; */
 
 	heap = mem_heap_create(512);
 	fork = que_fork_create(NULL, NULL, QUE_FORK_PURGE, heap);
-	fork->trx = purge_sys->trx;
+	fork->trx = trx;
 
 	thr = que_thr_create(fork, heap);
 
-	thr->child = row_purge_node_create(thr, heap);
-
-	/*	thr2 = que_thr_create(fork, fork, heap);
+	*node = row_purge_node_create(thr, heap);
 
-	thr2->child = row_purge_node_create(fork, thr2, heap);	 */
+	thr->child = *node;
 
 	return(fork);
 }
 
+/********************************************************************//**
+Creates a purge worker with its own session, transaction and query graph.
+The calling thread must own the kernel mutex. */
+static
+void
+trx_purge_worker_create(
+/*====================*/
+	trx_purge_worker_t*	worker)	/*!< out: purge worker */
+{
+	trx_t*	trx;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	worker->sess = sess_open();
+
+	trx = worker->sess->trx;
+
+	trx->is_purge = 1;
+
+	ut_a(trx_start_low(trx, ULINT_UNDEFINED));
+
+	worker->query = trx_purge_graph_build(trx, &worker->node);
+
+	worker->event = os_event_create(NULL);
+	worker->done_event = os_event_create(NULL);
+}
+
+/********************************************************************//**
+Frees a purge worker. */
+static
+void
+trx_purge_worker_free(
+/*==================*/
+	trx_purge_worker_t*	worker)	/*!< in, own: purge worker */
+{
+	que_graph_free(worker->query);
+
+	ut_a(worker->sess->trx->is_purge);
+	worker->sess->trx->conc_state = TRX_NOT_STARTED;
+	sess_close(worker->sess);
+
+	os_event_free(worker->event);
+	os_event_free(worker->done_event);
+}
+
 /********************************************************************//**
 Creates the global purge system control structure and inits the history
 mutex. */
@@ -227,6 +271,8 @@ trx_purge_sys_create(
 /*=================*/
 	ib_bh_t*	ib_bh)	/*!< in, own: UNDO log min binary heap */
 {
+	ulint	i;
+
 	ut_ad(mutex_own(&kernel_mutex));
 
 	purge_sys = mem_zalloc(sizeof(trx_purge_t));
@@ -253,18 +299,29 @@ trx_purge_sys_create(
 
 	purge_sys->arr = trx_undo_arr_create();
 
-	purge_sys->sess = sess_open();
+	purge_sys->n_workers = ut_max(srv_n_purge_threads, 1);
+
+	purge_sys->workers = mem_zalloc(
+		purge_sys->n_workers * sizeof *purge_sys->workers);
+
+	for (i = 0; i < purge_sys->n_workers; i++) {
+		trx_purge_worker_create(&purge_sys->workers[i]);
+	}
+
+	purge_sys->sess = purge_sys->workers[0].sess;
 
 	purge_sys->trx = purge_sys->sess->trx;
 
-	purge_sys->trx->is_purge = 1;
+	purge_sys->query = purge_sys->workers[0].query;
 
-	ut_a(trx_start_low(purge_sys->trx, ULINT_UNDEFINED));
+	purge_sys->rec_heap = mem_heap_create(1024);
 
-	purge_sys->query = trx_purge_graph_build();
+	mutex_enter(&trx_sys->mutex);
 
 	purge_sys->view = read_view_oldest_copy_or_open_new(0,
 							    purge_sys->heap);
+
+	mutex_exit(&trx_sys->mutex);
 }
 
 /************************************************************************
@@ -274,24 +331,26 @@ void
 trx_purge_sys_close(void)
 /*======================*/
 {
+	ulint	i;
+
 	ut_ad(!mutex_own(&kernel_mutex));
 
-	que_graph_free(purge_sys->query);
+	for (i = 0; i < purge_sys->n_workers; i++) {
+		trx_purge_worker_free(&purge_sys->workers[i]);
+	}
+
+	mem_free(purge_sys->workers);
+	purge_sys->workers = NULL;
 
-	ut_a(purge_sys->sess->trx->is_purge);
-	purge_sys->sess->trx->conc_state = TRX_NOT_STARTED;
-	sess_close(purge_sys->sess);
 	purge_sys->sess = NULL;
+	purge_sys->trx = NULL;
+	purge_sys->query = NULL;
 
-	if (purge_sys->view != NULL) {
-		/* Because acquiring the kernel mutex is a pre-condition
-		of read_view_close(). We don't really need it here. */
-		mutex_enter(&kernel_mutex);
+	mem_heap_free(purge_sys->rec_heap);
 
+	if (purge_sys->view != NULL) {
 		read_view_close(purge_sys->view);
 		purge_sys->view = NULL;
-
-		mutex_exit(&kernel_mutex);
 	}
 
 	trx_undo_arr_free(purge_sys->arr);
@@ -1044,10 +1103,10 @@ trx_purge_get_next_rec(
 
 /********************************************************************//**
 Fetches the next undo log record from the history list to purge. It must be
-released with the corresponding release function.
+released with trx_purge_arr_remove_info().
 @return copy of an undo log record or pointer to trx_purge_dummy_rec,
 if the whole undo log can skipped in purge; NULL if none left */
-UNIV_INTERN
+static
 trx_undo_rec_t*
 trx_purge_fetch_next_rec(
 /*=====================*/
@@ -1060,7 +1119,6 @@ trx_purge_fetch_next_rec(
 
 
 	if (purge_sys->state == TRX_STOP_PURGE) {
-		trx_purge_truncate_if_arr_empty();
 
 		return(NULL);
 	} else if (!purge_sys->next_stored) {
@@ -1069,8 +1127,6 @@ trx_purge_fetch_next_rec(
 		if (!purge_sys->next_stored) {
 			purge_sys->state = TRX_STOP_PURGE;
 
-			trx_purge_truncate_if_arr_empty();
-
 			if (srv_print_thread_releases) {
 				fprintf(stderr,
 					"Purge: No logs left in the"
@@ -1086,14 +1142,10 @@ trx_purge_fetch_next_rec(
 
 		purge_sys->state = TRX_STOP_PURGE;
 
-		trx_purge_truncate_if_arr_empty();
-
 		return(NULL);
 	} else if (purge_sys->purge_trx_no >= purge_sys->view->low_limit_no) {
 		purge_sys->state = TRX_STOP_PURGE;
 
-		trx_purge_truncate_if_arr_empty();
-
 		return(NULL);
 	}
 
@@ -1121,18 +1173,102 @@ trx_purge_fetch_next_rec(
 }
 
 /*******************************************************************//**
-Releases a reserved purge undo record. */
-UNIV_INTERN
-void
-trx_purge_rec_release(
+Fetches the undo log records of a purge batch, and hands each of them to
+the purge worker of its table. Only the first record of the batch keeps
+its cell in the purge array: the history cannot be truncated past it
+before the whole batch has been purged.
+@return	number of undo log records fetched */
+static
+ulint
+trx_purge_fetch_batch(
 /*==================*/
-	trx_undo_inf_t*	cell)	/*!< in: storage cell */
+	trx_undo_inf_t** cell)	/*!< out: storage cell for the first record
+				of the batch in the purge array, or NULL if
+				no records were fetched */
 {
-	trx_purge_arr_remove_info(cell);
+	ulint	i;
+	ulint	n_recs = 0;
+
+	*cell = NULL;
+
+	mem_heap_empty(purge_sys->rec_heap);
+
+	for (i = 0; i < purge_sys->n_workers; i++) {
+		purge_node_t*	node = purge_sys->workers[i].node;
+
+		node->undo_recs = ib_vector_create(purge_sys->rec_heap, 64);
+		node->next_undo_rec = 0;
+	}
+
+	for (;;) {
+		trx_purge_rec_t*	rec;
+		trx_undo_inf_t*		rec_cell;
+		ulint			type;
+		ulint			cmpl_info;
+		ibool			updated_extern;
+		undo_no_t		undo_no;
+		table_id_t		table_id;
+		purge_node_t*		node;
+
+		rec = mem_heap_alloc(purge_sys->rec_heap, sizeof *rec);
+
+		rec->undo_rec = trx_purge_fetch_next_rec(
+			&rec->roll_ptr, &rec_cell, purge_sys->rec_heap);
+
+		if (rec->undo_rec == NULL) {
+
+			break;
+		}
+
+		if (n_recs++ == 0) {
+			*cell = rec_cell;
+		} else {
+			trx_purge_arr_remove_info(rec_cell);
+		}
+
+		if (rec->undo_rec == &trx_purge_dummy_rec) {
+			/* The whole undo log can be skipped */
+
+			continue;
+		}
+
+		trx_undo_rec_get_pars(rec->undo_rec, &type, &cmpl_info,
+				      &updated_extern, &undo_no, &table_id);
+
+		node = purge_sys->workers[
+			(ulint) (table_id % purge_sys->n_workers)].node;
+
+		ib_vector_push(node->undo_recs, rec);
+	}
+
+	return(n_recs);
 }
 
 /*******************************************************************//**
-This function runs a purge batch.
+Runs the purge query graph of a worker on the records handed to it. */
+static
+void
+trx_purge_worker_run(
+/*=================*/
+	trx_purge_worker_t*	worker)	/*!< in: purge worker */
+{
+	que_thr_t*	thr;
+
+	mutex_enter(&kernel_mutex);
+
+	thr = que_fork_start_command(worker->query);
+
+	ut_ad(thr);
+
+	mutex_exit(&kernel_mutex);
+
+	que_run_threads(thr);
+}
+
+/*******************************************************************//**
+This function runs a purge batch. The undo log records of the batch are
+split by table among the purge workers, the first of which is run by the
+calling thread.
 @return	number of undo log pages handled in the batch */
 UNIV_INTERN
 ulint
@@ -1141,14 +1277,16 @@ trx_purge(
 	ulint	limit)		/*!< in: the maximum number of records to
 				purge in one batch */
 {
-	que_thr_t*	thr;
+	ulint		i;
+	ulint		n_recs;
+	trx_undo_inf_t*	cell;
 	ulint		old_pages_handled;
 
 	ut_a(purge_sys->trx->n_active_thrs == 0);
 
 	rw_lock_x_lock(&purge_sys->latch);
 
-	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->mutex);
 
 	/* Close and free the old purge view */
 
@@ -1183,7 +1321,7 @@ trx_purge(
 	purge_sys->view = read_view_oldest_copy_or_open_new(
 		0, purge_sys->heap);
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->mutex);
 
 	rw_lock_x_unlock(&(purge_sys->latch));
 
@@ -1199,21 +1337,47 @@ trx_purge(
 
 	old_pages_handled = purge_sys->n_pages_handled;
 
+	n_recs = trx_purge_fetch_batch(&cell);
 
-	mutex_enter(&kernel_mutex);
+	if (srv_print_thread_releases) {
 
-	thr = que_fork_start_command(purge_sys->query);
+		fprintf(stderr, "Starting purge of %lu records\n",
+			(ulong) n_recs);
+	}
 
-	ut_ad(thr);
+	/* Hand the parts of the batch to the worker threads, and purge
+	the first part in this thread */
 
-	mutex_exit(&kernel_mutex);
+	for (i = 1; i < purge_sys->n_workers; i++) {
+		trx_purge_worker_t*	worker = &purge_sys->workers[i];
 
-	if (srv_print_thread_releases) {
+		if (ib_vector_is_empty(worker->node->undo_recs)) {
+
+			continue;
+		}
 
-		fputs("Starting purge\n", stderr);
+		os_event_reset(worker->done_event);
+		os_event_set(worker->event);
 	}
 
-	que_run_threads(thr);
+	trx_purge_worker_run(&purge_sys->workers[0]);
+
+	for (i = 1; i < purge_sys->n_workers; i++) {
+		trx_purge_worker_t*	worker = &purge_sys->workers[i];
+
+		if (!ib_vector_is_empty(worker->node->undo_recs)) {
+
+			os_event_wait(worker->done_event);
+		}
+	}
+
+	if (cell != NULL) {
+		trx_purge_arr_remove_info(cell);
+	}
+
+	trx_purge_truncate_if_arr_empty();
+
+	purge_sys->n_recs_purged += n_recs;
 
 	if (srv_print_thread_releases) {
 
@@ -1225,6 +1389,76 @@ trx_purge(
 	return((ulint) (purge_sys->n_pages_handled - old_pages_handled));
 }
 
+/*******************************************************************//**
+Waits for the purge coordinator to hand a part of a purge batch to the
+worker, and purges it.
+@return	FALSE if the worker should exit */
+UNIV_INTERN
+ibool
+trx_purge_worker_wait_and_run(
+/*==========================*/
+	trx_purge_worker_t*	worker)	/*!< in: purge worker */
+{
+	ut_ad(worker != &purge_sys->workers[0]);
+
+	os_event_wait(worker->event);
+	os_event_reset(worker->event);
+
+	if (purge_sys->workers_exit) {
+		os_event_set(worker->done_event);
+
+		return(FALSE);
+	}
+
+	trx_purge_worker_run(worker);
+
+	os_event_set(worker->done_event);
+
+	return(TRUE);
+}
+
+/*******************************************************************//**
+Tells the purge worker threads to exit, and waits until they have seen
+it. Called by the purge coordinator thread when it exits. */
+UNIV_INTERN
+void
+trx_purge_stop_workers(void)
+/*========================*/
+{
+	ulint	i;
+
+	purge_sys->workers_exit = TRUE;
+
+	for (i = 1; i < purge_sys->n_workers; i++) {
+		trx_purge_worker_t*	worker = &purge_sys->workers[i];
+
+		os_event_reset(worker->done_event);
+		os_event_set(worker->event);
+		os_event_wait(worker->done_event);
+	}
+}
+
+/*******************************************************************//**
+Samples the history list length and the number of purged undo log
+records, to compute the purge rate and the purge lag. Called once per
+second by srv_error_monitor_thread(). */
+UNIV_INTERN
+void
+trx_purge_stat_update(void)
+/*=======================*/
+{
+	ulint	history_len	= trx_sys->rseg_history_len;
+	ulint	n_recs_purged	= purge_sys->n_recs_purged;
+
+	purge_sys->recs_per_sec = n_recs_purged
+		- purge_sys->stat_n_recs_purged;
+	purge_sys->lag_per_sec = (lint) history_len
+		- (lint) purge_sys->stat_history_len;
+
+	purge_sys->stat_n_recs_purged = n_recs_purged;
+	purge_sys->stat_history_len = history_len;
+}
+
 /******************************************************************//**
 Prints information of the purge system to stderr. */
 UNIV_INTERN
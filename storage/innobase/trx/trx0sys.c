@@ -43,6 +43,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "log0recv.h"
 #include "os0file.h"
 #include "read0read.h"
+#include "ut0rbt.h"
 
 /** The file format tag structure with id and name. */
 struct file_format_struct {
@@ -132,6 +133,8 @@ static const ulint	FILE_FORMAT_NAME_N
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	trx_doublewrite_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	file_format_max_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	read_view_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_sys_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
 
 #ifndef UNIV_HOTBACKUP
@@ -175,6 +178,64 @@ trx_doublewrite_page_inside(
 	return(FALSE);
 }
 
+/****************************************************************//**
+Opens innodb_doublewrite_file, or creates it if it does not exist. An
+existing file is not resized here, because it may contain pages that
+crash recovery has to restore. */
+static
+void
+trx_doublewrite_file_open(void)
+/*===========================*/
+{
+	ulint	dirnamelen = strlen(srv_data_home);
+	ulint	size;
+	ibool	success;
+	char*	name;
+
+	size = dirnamelen + strlen(srv_doublewrite_file) + 2;
+	name = mem_alloc(size);
+
+	/* Add a path separator if needed. */
+	if (dirnamelen && srv_data_home[dirnamelen - 1] != SRV_PATH_SEPARATOR
+	    && srv_data_home[dirnamelen - 1] != '/') {
+		ut_snprintf(name, size, "%s%c%s", srv_data_home,
+			    SRV_PATH_SEPARATOR, srv_doublewrite_file);
+	} else {
+		ut_snprintf(name, size, "%s%s", srv_data_home,
+			    srv_doublewrite_file);
+	}
+
+	srv_normalize_path_for_win(name);
+
+	trx_doublewrite->file = os_file_create(
+		innodb_file_data_key, name, OS_FILE_CREATE,
+		OS_FILE_NORMAL, OS_DATA_FILE, &success);
+
+	if (success) {
+		ulint	n_bytes = trx_doublewrite->n_areas
+			* TRX_DOUBLEWRITE_AREA_SIZE * UNIV_PAGE_SIZE;
+
+		fprintf(stderr,
+			"InnoDB: Creating the doublewrite file %s\n", name);
+
+		success = os_file_set_size(name, trx_doublewrite->file,
+					   n_bytes, 0);
+	} else {
+		trx_doublewrite->file = os_file_create(
+			innodb_file_data_key, name, OS_FILE_OPEN,
+			OS_FILE_NORMAL, OS_DATA_FILE, &success);
+	}
+
+	if (!success) {
+		fprintf(stderr,
+			"InnoDB: Error: cannot create or open"
+			" the doublewrite file %s\n", name);
+		ut_error;
+	}
+
+	trx_doublewrite->file_name = name;
+}
+
 /****************************************************************//**
 Creates or initialializes the doublewrite buffer at a database start. */
 static
@@ -184,7 +245,9 @@ trx_doublewrite_init(
 	byte*	doublewrite)	/*!< in: pointer to the doublewrite buf
 				header on trx sys page */
 {
-	trx_doublewrite = mem_alloc(sizeof(trx_doublewrite_t));
+	ulint	i;
+
+	trx_doublewrite = mem_zalloc(sizeof(trx_doublewrite_t));
 
 	/* Since we now start to use the doublewrite buffer, no need to call
 	fsync() after every write to a data file */
@@ -192,22 +255,42 @@ trx_doublewrite_init(
 	os_do_not_call_flush_at_each_write = TRUE;
 #endif /* UNIV_DO_FLUSH */
 
-	mutex_create(trx_doublewrite_mutex_key,
-		     &trx_doublewrite->mutex, SYNC_DOUBLEWRITE);
-
-	trx_doublewrite->first_free = 0;
-
 	trx_doublewrite->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	trx_doublewrite->block2 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
-	trx_doublewrite->write_buf_unaligned = ut_malloc(
-		(1 + 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) * UNIV_PAGE_SIZE);
 
-	trx_doublewrite->write_buf = ut_align(
-		trx_doublewrite->write_buf_unaligned, UNIV_PAGE_SIZE);
-	trx_doublewrite->buf_block_arr = mem_alloc(
-		2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * sizeof(void*));
+	if (srv_doublewrite_file && *srv_doublewrite_file) {
+		/* One area for the LRU and one for the flush list
+		flushing of each buffer pool instance */
+		trx_doublewrite->n_areas = 2 * srv_buf_pool_instances;
+
+		trx_doublewrite_file_open();
+	} else {
+		trx_doublewrite->n_areas = 1;
+	}
+
+	trx_doublewrite->areas = mem_zalloc(
+		trx_doublewrite->n_areas * sizeof(trx_doublewrite_area_t));
+
+	for (i = 0; i < trx_doublewrite->n_areas; i++) {
+		trx_doublewrite_area_t*	area = &trx_doublewrite->areas[i];
+
+		mutex_create(trx_doublewrite_mutex_key,
+			     &area->mutex, SYNC_DOUBLEWRITE);
+
+		area->first_free = 0;
+		area->offset = (ib_uint64_t) i
+			* TRX_DOUBLEWRITE_AREA_SIZE * UNIV_PAGE_SIZE;
+
+		area->write_buf_unaligned = ut_malloc(
+			(1 + TRX_DOUBLEWRITE_AREA_SIZE) * UNIV_PAGE_SIZE);
+
+		area->write_buf = ut_align(
+			area->write_buf_unaligned, UNIV_PAGE_SIZE);
+		area->buf_block_arr = mem_alloc(
+			TRX_DOUBLEWRITE_AREA_SIZE * sizeof(void*));
+	}
 }
 
 /****************************************************************//**
@@ -411,6 +494,287 @@ start_again:
 	}
 }
 
+/****************************************************************//**
+Restores a page in a data file from its copy in the doublewrite buffer
+or file, if the page in the data file is corrupt, that is, if the write
+of the page was interrupted by a crash. */
+static
+void
+trx_doublewrite_restore_page(
+/*=========================*/
+	ulint		space_id,	/*!< in: tablespace of the page */
+	ulint		page_no,	/*!< in: page number */
+	const byte*	page,		/*!< in: copy of the page in the
+					doublewrite buffer */
+	byte*		read_buf,	/*!< in/out: buffer for reading the
+					page from the data file */
+	ulint		i)		/*!< in: position of the copy in the
+					doublewrite buffer */
+{
+	ulint	zip_size;
+
+	if (!fil_tablespace_exists_in_mem(space_id)) {
+		/* Maybe we have dropped the single-table tablespace
+		and this page once belonged to it: do nothing */
+
+		return;
+	}
+
+	if (!fil_check_adress_in_tablespace(space_id, page_no)) {
+		fprintf(stderr,
+			"InnoDB: Warning: a page in the"
+			" doublewrite buffer is not within space\n"
+			"InnoDB: bounds; space id %lu"
+			" page number %lu, page %lu in"
+			" doublewrite buf.\n",
+			(ulong) space_id, (ulong) page_no, (ulong) i);
+
+		return;
+	}
+
+	if (space_id == TRX_SYS_SPACE
+	    && trx_doublewrite_page_inside(page_no)) {
+
+		/* It is an unwritten doublewrite buffer page:
+		do nothing */
+		return;
+	}
+
+	zip_size = fil_space_get_zip_size(space_id);
+
+	/* Read in the actual page from the file */
+	fil_io(OS_FILE_READ, TRUE, space_id, zip_size,
+	       page_no, 0,
+	       zip_size ? zip_size : UNIV_PAGE_SIZE,
+	       read_buf, NULL);
+
+	/* Check if the page is corrupt */
+
+	if (UNIV_LIKELY(!buf_page_is_corrupted(TRUE, read_buf, zip_size))) {
+
+		return;
+	}
+
+	fprintf(stderr,
+		"InnoDB: Warning: database page"
+		" corruption or a failed\n"
+		"InnoDB: file read of"
+		" space %lu page %lu.\n"
+		"InnoDB: Trying to recover it from"
+		" the doublewrite buffer.\n",
+		(ulong) space_id, (ulong) page_no);
+
+	if (buf_page_is_corrupted(TRUE, page, zip_size)) {
+		fprintf(stderr,
+			"InnoDB: Dump of the page:\n");
+		buf_page_print(
+			read_buf, zip_size,
+			BUF_PAGE_PRINT_NO_CRASH);
+		fprintf(stderr,
+			"InnoDB: Dump of"
+			" corresponding page"
+			" in doublewrite buffer:\n");
+		buf_page_print(
+			page, zip_size,
+			BUF_PAGE_PRINT_NO_CRASH);
+
+		fprintf(stderr,
+			"InnoDB: Also the page in the"
+			" doublewrite buffer"
+			" is corrupt.\n"
+			"InnoDB: Cannot continue"
+			" operation.\n"
+			"InnoDB: You can try to"
+			" recover the database"
+			" with the my.cnf\n"
+			"InnoDB: option:\n"
+			"InnoDB:"
+			" innodb_force_recovery=6\n");
+		ut_error;
+	}
+
+	/* Write the good page from the
+	doublewrite buffer to the intended
+	position */
+
+	fil_io(OS_FILE_WRITE, TRUE, space_id,
+	       zip_size, page_no, 0,
+	       zip_size ? zip_size : UNIV_PAGE_SIZE,
+	       (void*) page, NULL);
+
+	fprintf(stderr,
+		"InnoDB: Recovered the page from"
+		" the doublewrite buffer.\n");
+}
+
+/** The copy of a page in innodb_doublewrite_file that is used to
+restore the page, see trx_doublewrite_file_restore_pages() */
+typedef struct trx_doublewrite_copy_struct	trx_doublewrite_copy_t;
+
+/** The copy of a page in innodb_doublewrite_file */
+struct trx_doublewrite_copy_struct {
+	ulint		space_id;	/*!< tablespace of the page */
+	ulint		page_no;	/*!< page number */
+	ib_uint64_t	lsn;		/*!< FIL_PAGE_LSN of the copy */
+	ulint		slot;		/*!< position of the copy in the
+					file, in pages */
+	ibool		valid;		/*!< TRUE if the copy is not
+					corrupt */
+};
+
+/****************************************************************//**
+Compares the pages of two trx_doublewrite_copy_t.
+@return	negative, 0 or positive if p1 is less than, equal to or greater
+than p2 */
+static
+int
+trx_doublewrite_copy_cmp(
+/*=====================*/
+	const void*	p1,	/*!< in: trx_doublewrite_copy_t */
+	const void*	p2)	/*!< in: trx_doublewrite_copy_t */
+{
+	const trx_doublewrite_copy_t*	c1 = p1;
+	const trx_doublewrite_copy_t*	c2 = p2;
+
+	if (c1->space_id != c2->space_id) {
+
+		return(c1->space_id < c2->space_id ? -1 : 1);
+	}
+
+	return(c1->page_no < c2->page_no ? -1 : c1->page_no > c2->page_no);
+}
+
+/****************************************************************//**
+Reads pages from innodb_doublewrite_file. */
+static
+void
+trx_doublewrite_file_read(
+/*======================*/
+	byte*		buf,	/*!< out: the pages */
+	ib_uint64_t	offset,	/*!< in: file offset of the first page */
+	ulint		n_pages)/*!< in: number of pages */
+{
+	if (!os_file_read(trx_doublewrite->file, buf,
+			  (ulint) (offset & 0xFFFFFFFFUL),
+			  (ulint) (offset >> 32),
+			  n_pages * UNIV_PAGE_SIZE)) {
+		fprintf(stderr,
+			"InnoDB: Error: cannot read"
+			" the doublewrite file %s\n",
+			trx_doublewrite->file_name);
+		ut_error;
+	}
+}
+
+/****************************************************************//**
+Restores the pages whose writes were interrupted by a crash from their
+copies in innodb_doublewrite_file. All areas of the file are read, also
+if the number of buffer pool instances has changed since the crash.
+
+The slots of the file are not reset after the pages were written to
+the data files, so a page can have copies of different ages in several
+areas. Only a page that is corrupt in its data file is restored, from
+its newest copy that is not corrupt. A page that was written completely
+is left alone: redo applies the changes that its copy may have on top
+of it. */
+static
+void
+trx_doublewrite_file_restore_pages(
+/*===============================*/
+	byte*	read_buf)	/*!< in/out: buffer for reading a page
+				from a data file */
+{
+	byte*			buf = trx_doublewrite->areas[0].write_buf;
+	ib_rbt_t*		copies;
+	const ib_rbt_node_t*	node;
+	ib_int64_t		size;
+	ib_uint64_t		offset;
+	ulint			i = 0;
+
+	copies = rbt_create(sizeof(trx_doublewrite_copy_t),
+			    trx_doublewrite_copy_cmp);
+
+	size = os_file_get_size_as_iblonglong(trx_doublewrite->file);
+
+	/* Find the newest valid copy of each page */
+
+	for (offset = 0; offset + UNIV_PAGE_SIZE <= (ib_uint64_t) size;) {
+		ulint	len;
+		ulint	j;
+
+		len = (ulint) ut_min(
+			(ib_uint64_t) TRX_DOUBLEWRITE_AREA_SIZE,
+			((ib_uint64_t) size - offset) / UNIV_PAGE_SIZE);
+
+		trx_doublewrite_file_read(buf, offset, len);
+
+		for (j = 0; j < len; j++, i++) {
+			const byte*		page = buf + j * UNIV_PAGE_SIZE;
+			trx_doublewrite_copy_t	copy;
+			trx_doublewrite_copy_t*	best;
+			ib_rbt_bound_t		parent;
+			ulint			zip_size;
+
+			copy.lsn = mach_read_from_8(page + FIL_PAGE_LSN);
+
+			if (copy.lsn == 0) {
+				/* The slot has never been written */
+				continue;
+			}
+
+			copy.space_id = mach_read_from_4(
+				page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
+			copy.page_no = mach_read_from_4(
+				page + FIL_PAGE_OFFSET);
+			copy.slot = i;
+
+			zip_size = fil_space_get_zip_size(copy.space_id);
+
+			if (zip_size == ULINT_UNDEFINED) {
+				/* The tablespace has been dropped */
+				continue;
+			}
+
+			copy.valid = !buf_page_is_corrupted(
+				TRUE, page, zip_size);
+
+			if (!rbt_search(copies, &parent, &copy)) {
+				best = rbt_value(trx_doublewrite_copy_t,
+						 parent.last);
+
+				if (copy.valid > best->valid
+				    || (copy.valid == best->valid
+					&& copy.lsn > best->lsn)) {
+
+					*best = copy;
+				}
+			} else {
+				rbt_add_node(copies, &parent, &copy);
+			}
+		}
+
+		offset += len * UNIV_PAGE_SIZE;
+	}
+
+	/* Restore the pages that are corrupt in the data files */
+
+	for (node = rbt_first(copies);
+	     node != NULL;
+	     node = rbt_next(copies, node)) {
+
+		const trx_doublewrite_copy_t*	copy
+			= rbt_value(trx_doublewrite_copy_t, node);
+
+		trx_doublewrite_file_read(
+			buf, (ib_uint64_t) copy->slot * UNIV_PAGE_SIZE, 1);
+
+		trx_doublewrite_restore_page(copy->space_id, copy->page_no,
+					     buf, read_buf, copy->slot);
+	}
+
+	rbt_free(copies);
+}
+
 /****************************************************************//**
 At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
@@ -457,7 +821,9 @@ trx_sys_doublewrite_init_or_restore_pages(
 		block1 = trx_doublewrite->block1;
 		block2 = trx_doublewrite->block2;
 
-		buf = trx_doublewrite->write_buf;
+		/* The doublewrite buffer in the system tablespace fits
+		in the write buffer of one area. */
+		buf = trx_doublewrite->areas[0].write_buf;
 	} else {
 		goto leave_func;
 	}
@@ -523,106 +889,18 @@ trx_sys_doublewrite_init_or_restore_pages(
 				page + FIL_PAGE_ARCH_LOG_NO_OR_SPACE_ID);
 		}
 
-		if (!restore_corrupt_pages) {
-			/* The database was shut down gracefully: no need to
-			restore pages */
-
-		} else if (!fil_tablespace_exists_in_mem(space_id)) {
-			/* Maybe we have dropped the single-table tablespace
-			and this page once belonged to it: do nothing */
-
-		} else if (!fil_check_adress_in_tablespace(space_id,
-							   page_no)) {
-			fprintf(stderr,
-				"InnoDB: Warning: a page in the"
-				" doublewrite buffer is not within space\n"
-				"InnoDB: bounds; space id %lu"
-				" page number %lu, page %lu in"
-				" doublewrite buf.\n",
-				(ulong) space_id, (ulong) page_no, (ulong) i);
-
-		} else if (space_id == TRX_SYS_SPACE
-			   && ((page_no >= block1
-				&& page_no
-				< block1 + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-			       || (page_no >= block2
-				   && page_no
-				   < (block2
-				      + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)))) {
-
-			/* It is an unwritten doublewrite buffer page:
-			do nothing */
-		} else {
-			ulint	zip_size = fil_space_get_zip_size(space_id);
-
-			/* Read in the actual page from the file */
-			fil_io(OS_FILE_READ, TRUE, space_id, zip_size,
-			       page_no, 0,
-			       zip_size ? zip_size : UNIV_PAGE_SIZE,
-			       read_buf, NULL);
-
-			/* Check if the page is corrupt */
-
-			if (UNIV_UNLIKELY
-			    (buf_page_is_corrupted(
-				    TRUE, read_buf, zip_size))) {
-
-				fprintf(stderr,
-					"InnoDB: Warning: database page"
-					" corruption or a failed\n"
-					"InnoDB: file read of"
-					" space %lu page %lu.\n"
-					"InnoDB: Trying to recover it from"
-					" the doublewrite buffer.\n",
-					(ulong) space_id, (ulong) page_no);
-
-				if (buf_page_is_corrupted(
-					    TRUE, page, zip_size)) {
-					fprintf(stderr,
-						"InnoDB: Dump of the page:\n");
-					buf_page_print(
-						read_buf, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-					fprintf(stderr,
-						"InnoDB: Dump of"
-						" corresponding page"
-						" in doublewrite buffer:\n");
-					buf_page_print(
-						page, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-
-					fprintf(stderr,
-						"InnoDB: Also the page in the"
-						" doublewrite buffer"
-						" is corrupt.\n"
-						"InnoDB: Cannot continue"
-						" operation.\n"
-						"InnoDB: You can try to"
-						" recover the database"
-						" with the my.cnf\n"
-						"InnoDB: option:\n"
-						"InnoDB:"
-						" innodb_force_recovery=6\n");
-					ut_error;
-				}
-
-				/* Write the good page from the
-				doublewrite buffer to the intended
-				position */
-
-				fil_io(OS_FILE_WRITE, TRUE, space_id,
-				       zip_size, page_no, 0,
-				       zip_size ? zip_size : UNIV_PAGE_SIZE,
-				       page, NULL);
-				fprintf(stderr,
-					"InnoDB: Recovered the page from"
-					" the doublewrite buffer.\n");
-			}
+		if (restore_corrupt_pages) {
+			trx_doublewrite_restore_page(space_id, page_no, page,
+						     read_buf, i);
 		}
 
 		page += UNIV_PAGE_SIZE;
 	}
 
+	if (restore_corrupt_pages && trx_doublewrite->file_name) {
+		trx_doublewrite_file_restore_pages(read_buf);
+	}
+
 	fil_flush_file_spaces(FIL_TABLESPACE);
 
 leave_func:
@@ -640,7 +918,7 @@ trx_in_trx_list(
 {
 	trx_t*	trx;
 
-	ut_ad(mutex_own(&(kernel_mutex)));
+	ut_ad(trx_sys_list_own());
 
 	trx = UT_LIST_GET_FIRST(trx_sys->trx_list);
 
@@ -667,7 +945,7 @@ trx_sys_flush_max_trx_id(void)
 	trx_sysf_t*	sys_header;
 	mtr_t		mtr;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(trx_sys_list_x_own());
 
 	mtr_start(&mtr);
 
@@ -1005,6 +1283,8 @@ trx_sys_init_at_db_start(void)
 
 	trx_sys = mem_zalloc(sizeof(*trx_sys));
 
+	mutex_create(trx_sys_mutex_key, &trx_sys->mutex, SYNC_TRX_SYS);
+
 	sys_header = trx_sysf_get(&mtr);
 
 	trx_rseg_list_and_array_init(sys_header, ib_bh, &mtr);
@@ -1059,6 +1339,8 @@ trx_sys_init_at_db_start(void)
 			(ullint) trx_sys->max_trx_id);
 	}
 
+	mutex_create(read_view_mutex_key,
+		     &trx_sys->read_view_mutex, SYNC_READ_VIEW);
 	UT_LIST_INIT(trx_sys->view_list);
 
 	/* Transfer ownership to purge. */
@@ -1624,6 +1906,7 @@ trx_sys_close(void)
 	trx_t*		trx;
 	trx_rseg_t*	rseg;
 	read_view_t*	view;
+	ulint		i;
 
 	ut_ad(trx_sys != NULL);
 	ut_ad(srv_shutdown_state == SRV_SHUTDOWN_EXIT_THREADS);
@@ -1648,13 +1931,22 @@ trx_sys_close(void)
 
 	/* Free the double write data structures. */
 	ut_a(trx_doublewrite != NULL);
-	ut_free(trx_doublewrite->write_buf_unaligned);
-	trx_doublewrite->write_buf_unaligned = NULL;
 
-	mem_free(trx_doublewrite->buf_block_arr);
-	trx_doublewrite->buf_block_arr = NULL;
+	for (i = 0; i < trx_doublewrite->n_areas; i++) {
+		trx_doublewrite_area_t*	area = &trx_doublewrite->areas[i];
+
+		ut_free(area->write_buf_unaligned);
+		mem_free(area->buf_block_arr);
+		mutex_free(&area->mutex);
+	}
+
+	mem_free(trx_doublewrite->areas);
+
+	if (trx_doublewrite->file_name) {
+		os_file_close(trx_doublewrite->file);
+		mem_free(trx_doublewrite->file_name);
+	}
 
-	mutex_free(&trx_doublewrite->mutex);
 	mem_free(trx_doublewrite);
 	trx_doublewrite = NULL;
 
@@ -1694,6 +1986,8 @@ trx_sys_close(void)
 	ut_a(UT_LIST_GET_LEN(trx_sys->view_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->mysql_trx_list) == 0);
 
+	mutex_free(&trx_sys->read_view_mutex);
+	mutex_free(&trx_sys->mutex);
 	mem_free(trx_sys);
 
 	trx_sys = NULL;
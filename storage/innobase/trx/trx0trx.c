@@ -110,7 +110,7 @@ trx_create(
 	trx->conc_state = TRX_NOT_STARTED;
 
 	trx->is_registered = 0;
-	trx->owns_prepare_mutex = 0;
+	trx->active_commit_ordered = 0;
 
 	trx->start_time = ut_time();
 
@@ -175,6 +175,7 @@ trx_create(
 
 	trx->dict_operation_lock_mode = 0;
 	trx->has_search_latch = FALSE;
+	trx->search_latch = NULL;
 	trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 
 	trx->declared_to_be_inside_innodb = FALSE;
@@ -248,9 +249,10 @@ trx_search_latch_release_if_reserved(
 	trx_t*	   trx) /*!< in: transaction */
 {
 	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(trx->search_latch);
 
 		trx->has_search_latch = FALSE;
+		trx->search_latch = NULL;
 	}
 }
 
@@ -358,7 +360,9 @@ trx_free_prepared(
 	the shutdown stage and because a transaction cannot become
 	PREPARED while holding locks, it is safe to release the locks
 	held by PREPARED transactions here at shutdown.*/
+	rw_lock_x_lock(&lock_sys->latch);
 	lock_release_off_kernel(trx);
+	rw_lock_x_unlock(&lock_sys->latch);
 
 	trx_undo_free_prepared(trx);
 
@@ -389,7 +393,9 @@ trx_free_prepared(
 	ut_a(ib_vector_is_empty(trx->autoinc_locks));
 	ib_vector_free(trx->autoinc_locks);
 
+	mutex_enter(&trx_sys->mutex);
 	UT_LIST_REMOVE(trx_list, trx_sys->trx_list, trx);
+	mutex_exit(&trx_sys->mutex);
 
 	mem_free(trx);
 }
@@ -443,7 +449,7 @@ trx_list_insert_ordered(
 {
 	trx_t*	trx2;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(trx_sys_list_x_own());
 
 	trx2 = UT_LIST_GET_FIRST(trx_sys->trx_list);
 
@@ -486,6 +492,9 @@ trx_lists_init_at_db_start(void)
 	trx_t*		trx;
 
 	ut_ad(mutex_own(&kernel_mutex));
+
+	mutex_enter(&trx_sys->mutex);
+
 	UT_LIST_INIT(trx_sys->trx_list);
 
 	/* Look from the rollback segments if there exist undo logs for
@@ -655,6 +664,8 @@ trx_lists_init_at_db_start(void)
 
 		rseg = UT_LIST_GET_NEXT(rseg_list, rseg);
 	}
+
+	mutex_exit(&trx_sys->mutex);
 }
 
 /******************************************************************//**
@@ -712,6 +723,11 @@ trx_start_low(
 
 	rseg = trx_assign_rseg(srv_rollback_segments);
 
+	trx->rseg = rseg;
+	trx->start_time = time(NULL);
+
+	mutex_enter(&trx_sys->mutex);
+
 	trx->id = trx_sys_get_new_trx_id();
 
 	/* The initial value for trx->no: IB_ULONGLONG_MAX is used in
@@ -719,13 +735,12 @@ trx_start_low(
 
 	trx->no = IB_ULONGLONG_MAX;
 
-	trx->rseg = rseg;
-
 	trx->conc_state = TRX_ACTIVE;
-	trx->start_time = time(NULL);
 
 	UT_LIST_ADD_FIRST(trx_list, trx_sys->trx_list, trx);
 
+	mutex_exit(&trx_sys->mutex);
+
 	return(TRUE);
 }
 
@@ -775,9 +790,12 @@ trx_serialisation_number_get(
 	ut_ad(mutex_own(&rseg->mutex));
 
 	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->mutex);
 
 	trx->no = trx_sys_get_new_trx_id();
 
+	mutex_exit(&trx_sys->mutex);
+
 	/* If the rollack segment is not empty then the
 	new trx_t::no can't be less than any trx_t::no
 	already in the rollback segment. User threads only
@@ -936,6 +954,8 @@ trx_commit_off_kernel(
 	ut_ad(trx->conc_state == TRX_ACTIVE || trx->conc_state == TRX_PREPARED);
 	ut_ad(mutex_own(&kernel_mutex));
 
+	mutex_enter(&trx_sys->mutex);
+
 	if (UNIV_UNLIKELY(trx->conc_state == TRX_PREPARED)) {
 		ut_a(trx_n_prepared > 0);
 		trx_n_prepared--;
@@ -959,6 +979,8 @@ trx_commit_off_kernel(
 	trx->conc_state = TRX_COMMITTED_IN_MEMORY;
 	/*--------------------------------------*/
 
+	mutex_exit(&trx_sys->mutex);
+
 	/* If we release kernel_mutex below and we are still doing
 	recovery i.e.: back ground rollback thread is still active
 	then there is a chance that the rollback thread may see
@@ -973,7 +995,9 @@ trx_commit_off_kernel(
 
 	trx->is_recovered = FALSE;
 
+	rw_lock_x_lock(&lock_sys->latch);
 	lock_release_off_kernel(trx);
+	rw_lock_x_unlock(&lock_sys->latch);
 
 	if (trx->global_read_view) {
 		read_view_close(trx->global_read_view);
@@ -1012,13 +1036,13 @@ trx_commit_off_kernel(
 		there are > 2 users in the database. Then at least 2 users can
 		gather behind one doing the physical log write to disk.
 
-		If we are calling trx_commit() under prepare_commit_mutex, we
+		If we are calling trx_commit() in binlog commit order, we
 		will delay possible log write and flush to a separate function
-		trx_commit_complete_for_mysql(), which is only called when the
-		thread has released the mutex. This is to make the
-		group commit algorithm to work. Otherwise, the prepare_commit
-		mutex would serialize all commits and prevent a group of
-		transactions from gathering. */
+		trx_commit_complete_for_mysql(), which is called by each
+		committing thread after the ordered part of the commit. This
+		is to make the group commit algorithm to work. Otherwise, the
+		commit order would serialize all log flushes and prevent a
+		group of transactions from gathering. */
 
 		if (trx->flush_log_later) {
 			/* Do nothing yet */
@@ -1056,7 +1080,6 @@ trx_commit_off_kernel(
 	/* Free all savepoints */
 	trx_roll_free_all_savepoints(trx);
 
-	trx->conc_state = TRX_NOT_STARTED;
 	trx->rseg = NULL;
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
@@ -1064,7 +1087,10 @@ trx_commit_off_kernel(
 	ut_ad(UT_LIST_GET_LEN(trx->wait_thrs) == 0);
 	ut_ad(UT_LIST_GET_LEN(trx->trx_locks) == 0);
 
+	mutex_enter(&trx_sys->mutex);
+	trx->conc_state = TRX_NOT_STARTED;
 	UT_LIST_REMOVE(trx_list, trx_sys->trx_list, trx);
+	mutex_exit(&trx_sys->mutex);
 
 	trx->error_state = DB_SUCCESS;
 }
@@ -1084,12 +1110,14 @@ trx_cleanup_at_db_startup(
 		trx_undo_insert_cleanup(trx);
 	}
 
-	trx->conc_state = TRX_NOT_STARTED;
 	trx->rseg = NULL;
 	trx->undo_no = 0;
 	trx->last_sql_stat_start.least_undo_no = 0;
 
+	mutex_enter(&trx_sys->mutex);
+	trx->conc_state = TRX_NOT_STARTED;
 	UT_LIST_REMOVE(trx_list, trx_sys->trx_list, trx);
+	mutex_exit(&trx_sys->mutex);
 }
 
 /********************************************************************//**
@@ -1109,7 +1137,7 @@ trx_assign_read_view(
 		return(trx->read_view);
 	}
 
-	mutex_enter(&kernel_mutex);
+	mutex_enter(&trx_sys->mutex);
 
 	if (!trx->read_view) {
 		trx->read_view = read_view_open_now(
@@ -1117,7 +1145,7 @@ trx_assign_read_view(
 		trx->global_read_view = trx->read_view;
 	}
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(&trx_sys->mutex);
 
 	return(trx->read_view);
 }
@@ -1758,7 +1786,8 @@ trx_mark_sql_stat_end(
 
 /**********************************************************************//**
 Prints info about a transaction to the given file. The caller must own the
-kernel mutex. */
+kernel mutex, and lock_sys->latch in exclusive mode if trx is not its own
+transaction, see lock_mutex_enter_kernel(). */
 UNIV_INTERN
 void
 trx_print(
@@ -1966,8 +1995,10 @@ trx_prepare_off_kernel(
 	ut_ad(mutex_own(&kernel_mutex));
 
 	/*--------------------------------------*/
+	mutex_enter(&trx_sys->mutex);
 	trx->conc_state = TRX_PREPARED;
 	trx_n_prepared++;
+	mutex_exit(&trx_sys->mutex);
 	/*--------------------------------------*/
 
 	if (lsn) {
@@ -0,0 +1,221 @@
+/*****************************************************************************
+
+Copyright (c) 2026, Oracle and/or its affiliates. All Rights Reserved.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/***************************************************************//**
+@file ut/ut0crc32.c
+CRC32C implementation, using the SSE4.2 crc32 instruction when the CPU
+has it and a slicing-by-8 table lookup otherwise.
+
+The software implementation is based on the slicing-by-8 algorithm
+described in "A Systematic Approach to Building High Performance,
+Software-based, CRC Generators" by Michael E. Kounavis and Frank L.
+Berry, Intel Research and Development.
+
+*******************************************************/
+
+#include "univ.i"
+#include "ut0crc32.h"
+
+/** Pointer to the CRC32C implementation chosen by ut_crc32_init() */
+UNIV_INTERN ib_ut_crc32_t	ut_crc32;
+
+/** TRUE if ut_crc32() uses the SSE4.2 crc32 instruction */
+UNIV_INTERN ibool		ut_crc32_sse42_enabled = FALSE;
+
+/** The reversed CRC32C polynomial */
+#define UT_CRC32_POLY	0x82F63B78UL
+
+/** Slicing-by-8 lookup tables */
+static ib_uint32_t	ut_crc32_slice8_table[8][256];
+
+/* The crc32 instruction is only used with GCC on x86-64, where it can
+be issued with inline assembly without special compiler options. */
+#if defined(__GNUC__) && defined(__x86_64__)
+# define UT_CRC32_HAVE_SSE42
+
+/********************************************************************//**
+Fetches CPU info.
+@return	ecx register of the CPUID leaf 1 */
+static
+ib_uint32_t
+ut_cpuid_features_ecx(void)
+/*=======================*/
+{
+	ib_uint32_t	eax;
+	ib_uint32_t	ebx;
+	ib_uint32_t	ecx;
+	ib_uint32_t	edx;
+
+	asm("cpuid"
+	    : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+	    : "a" (0));
+
+	if (eax < 1) {
+		/* CPUID leaf 1 is not supported */
+		return(0);
+	}
+
+	asm("cpuid"
+	    : "=a" (eax), "=b" (ebx), "=c" (ecx), "=d" (edx)
+	    : "a" (1));
+
+	return(ecx);
+}
+
+/********************************************************************//**
+Calculates CRC32C using the SSE4.2 crc32 instruction.
+@return	CRC32C */
+static
+ib_uint32_t
+ut_crc32_sse42(
+/*===========*/
+	const byte*	buf,	/*!< in: data */
+	ulint		len)	/*!< in: data length in bytes */
+{
+	ib_uint64_t	crc = 0xFFFFFFFFUL;
+	ib_uint32_t	crc32;
+
+	while (len > 0 && ((ulint) buf & 7)) {
+		crc32 = (ib_uint32_t) crc;
+		asm("crc32b %1, %0" : "+r" (crc32) : "rm" (*buf));
+		crc = crc32;
+		buf++;
+		len--;
+	}
+
+	while (len >= 8) {
+		asm("crc32q %1, %0"
+		    : "+r" (crc) : "rm" (*(const ib_uint64_t*) buf));
+		buf += 8;
+		len -= 8;
+	}
+
+	crc32 = (ib_uint32_t) crc;
+
+	while (len > 0) {
+		asm("crc32b %1, %0" : "+r" (crc32) : "rm" (*buf));
+		buf++;
+		len--;
+	}
+
+	return(~crc32);
+}
+#endif /* __GNUC__ && __x86_64__ */
+
+/********************************************************************//**
+Initializes the slicing-by-8 lookup tables. */
+static
+void
+ut_crc32_slice8_table_init(void)
+/*============================*/
+{
+	ulint		i;
+	ulint		j;
+	ib_uint32_t	c;
+
+	for (i = 0; i < 256; i++) {
+		c = (ib_uint32_t) i;
+
+		for (j = 0; j < 8; j++) {
+			c = (c & 1) ? (UT_CRC32_POLY ^ (c >> 1)) : (c >> 1);
+		}
+
+		ut_crc32_slice8_table[0][i] = c;
+	}
+
+	for (i = 0; i < 256; i++) {
+		c = ut_crc32_slice8_table[0][i];
+
+		for (j = 1; j < 8; j++) {
+			c = ut_crc32_slice8_table[0][c & 0xFF] ^ (c >> 8);
+			ut_crc32_slice8_table[j][i] = c;
+		}
+	}
+}
+
+/********************************************************************//**
+Calculates CRC32C with the slicing-by-8 table lookup, without using any
+special CPU instructions. This is what ut_crc32() uses when the CPU does
+not have the SSE4.2 crc32 instruction.
+@return	CRC32C */
+UNIV_INTERN
+ib_uint32_t
+ut_crc32_slice8(
+/*============*/
+	const byte*	buf,	/*!< in: data */
+	ulint		len)	/*!< in: data length in bytes */
+{
+	const ib_uint32_t	(*t)[256] = ut_crc32_slice8_table;
+	ib_uint32_t		crc = 0xFFFFFFFFUL;
+
+	/* The bytes are combined explicitly in little-endian order, so
+	that the result does not depend on the byte order of the CPU. */
+
+	while (len >= 8) {
+		crc ^= (ib_uint32_t) buf[0]
+			| ((ib_uint32_t) buf[1] << 8)
+			| ((ib_uint32_t) buf[2] << 16)
+			| ((ib_uint32_t) buf[3] << 24);
+
+		crc = t[7][crc & 0xFF]
+			^ t[6][(crc >> 8) & 0xFF]
+			^ t[5][(crc >> 16) & 0xFF]
+			^ t[4][crc >> 24]
+			^ t[3][buf[4]]
+			^ t[2][buf[5]]
+			^ t[1][buf[6]]
+			^ t[0][buf[7]];
+
+		buf += 8;
+		len -= 8;
+	}
+
+	while (len > 0) {
+		crc = t[0][(crc ^ *buf) & 0xFF] ^ (crc >> 8);
+		buf++;
+		len--;
+	}
+
+	return(~crc);
+}
+
+/********************************************************************//**
+Initializes the data structures used by ut_crc32(), and chooses the
+implementation. Must be called once before ut_crc32() is used. */
+UNIV_INTERN
+void
+ut_crc32_init(void)
+/*===============*/
+{
+	/* The tables are always initialized, so that ut_crc32_slice8()
+	can be called directly, for example to compare it with the crc32
+	instruction. */
+	ut_crc32_slice8_table_init();
+
+#ifdef UT_CRC32_HAVE_SSE42
+	/* Bit 20 of ecx of CPUID leaf 1 tells if SSE4.2 is supported */
+	if (ut_cpuid_features_ecx() & (1UL << 20)) {
+		ut_crc32_sse42_enabled = TRUE;
+		ut_crc32 = ut_crc32_sse42;
+
+		return;
+	}
+#endif /* UT_CRC32_HAVE_SSE42 */
+
+	ut_crc32 = ut_crc32_slice8;
+}
@@ -1626,6 +1626,23 @@ int ha_myisam::delete_row(const uchar *buf)
   return mi_delete(file,buf);
 }
 
+int ha_myisam::index_init(uint idx, bool sorted)
+{
+  active_index=idx;
+  if (pushed_idx_cond && pushed_idx_cond_keyno == idx)
+    mi_set_index_cond_func(file, handler_index_cond_check, this);
+  return 0;
+}
+
+
+int ha_myisam::index_end()
+{
+  active_index=MAX_KEY;
+  mi_set_index_cond_func(file, NULL, 0);
+  return 0;
+}
+
+
 int ha_myisam::index_read_map(uchar *buf, const uchar *key,
                               key_part_map keypart_map,
                               enum ha_rkey_function find_flag)
@@ -1645,7 +1662,13 @@ int ha_myisam::index_read_idx_map(uchar *buf, uint index, const uchar *key,
 {
   MYSQL_INDEX_READ_ROW_START(table_share->db.str, table_share->table_name.str);
   ha_statistic_increment(&SSV::ha_read_key_count);
+  /* The pushed index condition is only checked by index scans */
+  if (pushed_idx_cond)
+    mi_set_index_cond_func(file, NULL, 0);
   int error=mi_rkey(file, buf, index, key, keypart_map, find_flag);
+  if (pushed_idx_cond && inited == INDEX &&
+      active_index == pushed_idx_cond_keyno)
+    mi_set_index_cond_func(file, handler_index_cond_check, this);
   table->status=error ? STATUS_NOT_FOUND: 0;
   MYSQL_INDEX_READ_ROW_DONE(error);
   return error;
@@ -1849,6 +1872,32 @@ int ha_myisam::reset(void)
   return mi_reset(file);
 }
 
+
+/*
+  Push an index condition down to MyISAM
+
+  The condition is checked by mi_rkey(), mi_rnext(), mi_rprev() and
+  mi_rnext_same() on the columns of the key before the row is read from
+  the data file. Keys with BLOB parts store only a prefix of the value,
+  so a condition on them cannot be checked.
+*/
+
+Item *ha_myisam::idx_cond_push(uint keyno_arg, Item* idx_cond_arg)
+{
+  const KEY *key= &table_share->key_info[keyno_arg];
+  for (uint k= 0; k < key->key_parts; k++)
+  {
+    if (key->key_part[k].key_part_flag & HA_BLOB_PART)
+      return idx_cond_arg;
+  }
+
+  pushed_idx_cond_keyno= keyno_arg;
+  pushed_idx_cond= idx_cond_arg;
+  if (inited == INDEX && active_index == pushed_idx_cond_keyno)
+    mi_set_index_cond_func(file, handler_index_cond_check, this);
+  return NULL;
+}
+
 /* To be used with WRITE_CACHE and EXTRA_CACHE */
 
 int ha_myisam::extra_opt(enum ha_extra_function operation, ulong cache_size)
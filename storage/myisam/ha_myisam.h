@@ -57,9 +57,12 @@ class ha_myisam: public handler
   ulonglong table_flags() const { return int_table_flags; }
   ulong index_flags(uint inx, uint part, bool all_parts) const
   {
-    return ((table_share->key_info[inx].algorithm == HA_KEY_ALG_FULLTEXT) ?
-            0 : HA_READ_NEXT | HA_READ_PREV | HA_READ_RANGE |
-            HA_READ_ORDER | HA_KEYREAD_ONLY);
+    if (table_share->key_info[inx].algorithm == HA_KEY_ALG_FULLTEXT)
+      return 0;
+    return (HA_READ_NEXT | HA_READ_PREV | HA_READ_RANGE |
+            HA_READ_ORDER | HA_KEYREAD_ONLY |
+            (table_share->key_info[inx].algorithm == HA_KEY_ALG_RTREE ?
+             0 : HA_DO_INDEX_COND_PUSHDOWN));
   }
   uint max_supported_keys()          const { return MI_MAX_KEY; }
   uint max_supported_key_length()    const { return MI_MAX_KEY_LENGTH; }
@@ -71,6 +74,8 @@ class ha_myisam: public handler
   int write_row(uchar * buf);
   int update_row(const uchar * old_data, uchar * new_data);
   int delete_row(const uchar * buf);
+  int index_init(uint idx, bool sorted);
+  int index_end();
   int index_read_map(uchar *buf, const uchar *key, key_part_map keypart_map,
                      enum ha_rkey_function find_flag);
   int index_read_idx_map(uchar *buf, uint index, const uchar *key,
@@ -105,6 +110,7 @@ class ha_myisam: public handler
   int extra(enum ha_extra_function operation);
   int extra_opt(enum ha_extra_function operation, ulong cache_size);
   int reset(void);
+  Item *idx_cond_push(uint keyno, Item* idx_cond);
   int external_lock(THD *thd, int lock_type);
   int delete_all_rows(void);
   int truncate();
@@ -410,6 +410,24 @@ static void mi_extra_keyflag(MI_INFO *info, enum ha_extra_function function)
 }
 
 
+/*
+  Set the function that checks the condition pushed to index scans
+
+  SYNOPSIS
+    mi_set_index_cond_func()
+    info		MyISAM handler
+    func		Function to call for each key, or NULL
+    func_arg		Argument of func
+*/
+
+void mi_set_index_cond_func(MI_INFO *info, index_cond_func_t func,
+                            void *func_arg)
+{
+  info->index_cond_func= func;
+  info->index_cond_func_arg= func_arg;
+}
+
+
 int mi_reset(MI_INFO *info)
 {
   int error= 0;
@@ -436,6 +454,7 @@ int mi_reset(MI_INFO *info)
 #endif
   info->opt_flag&= ~(KEY_READ_USED | REMEMBER_OLD_POS);
   info->quick_mode=0;
+  info->index_cond_func= NULL;
   info->lastinx= 0;			/* Use first index as def */
   info->last_search_keypage= info->lastpos= HA_OFFSET_ERROR;
   info->page_changed= 1;
@@ -31,8 +31,6 @@
               set_if_smaller(char_length,length);                           \
             } while(0)
 
-static int _mi_put_key_in_record(MI_INFO *info,uint keynr,uchar *record);
-
 /*
   Make a intern key from a record
 
@@ -323,8 +321,8 @@ uint _mi_pack_key(register MI_INFO *info, uint keynr, uchar *key, uchar *old,
    1   error
 */
 
-static int _mi_put_key_in_record(register MI_INFO *info, uint keynr,
-				 uchar *record)
+int _mi_put_key_in_record(register MI_INFO *info, uint keynr,
+                          uchar *record)
 {
   reg2 uchar *key;
   uchar *pos,*key_end;
@@ -485,6 +483,46 @@ int _mi_read_key_record(MI_INFO *info, my_off_t filepos, uchar *buf)
 }
 
 
+/*
+  Check the condition pushed to the index scan on the last read key
+
+  SYNOPSIS
+    mi_check_index_cond()
+    info		MyISAM handler
+    keynr		Index we are scanning
+    record		Record buffer; the columns of the key are stored here
+
+    Last read key is in info->lastkey
+
+  RETURN
+    ICP_NO_MATCH        Condition is false, skip the key
+    ICP_MATCH           Condition is true, read the row
+    ICP_OUT_OF_RANGE    End of range scan, my_errno is HA_ERR_END_OF_FILE
+    ICP_ERROR           Crashed key, my_errno is HA_ERR_CRASHED
+*/
+
+enum icp_result mi_check_index_cond(register MI_INFO *info, uint keynr,
+                                    uchar *record)
+{
+  enum icp_result res;
+  if (_mi_put_key_in_record(info, keynr, record))
+  {
+    mi_print_error(info->s, HA_ERR_CRASHED);
+    info->lastpos= HA_OFFSET_ERROR;             /* No active record */
+    my_errno= HA_ERR_CRASHED;
+    return ICP_ERROR;
+  }
+  if ((res= info->index_cond_func(info->index_cond_func_arg)) ==
+      ICP_OUT_OF_RANGE)
+  {
+    /* We got beyond the end of scanned range */
+    info->lastpos= HA_OFFSET_ERROR;             /* No active record */
+    my_errno= HA_ERR_END_OF_FILE;
+  }
+  return res;
+}
+
+
 /*
   Retrieve auto_increment info
 
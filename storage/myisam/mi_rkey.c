@@ -154,6 +154,37 @@ int mi_rkey(MI_INFO *info, uchar *buf, int inx, const uchar *key,
           } while (info->lastpos >= info->state->data_file_length);
         }
       }
+      /* Skip the keys that do not match the pushed index condition */
+      if (info->index_cond_func && buf)
+      {
+        while (info->lastpos != HA_OFFSET_ERROR)
+        {
+          uint not_used[2];
+          if (info->lastpos < info->state->data_file_length)
+          {
+            enum icp_result res= mi_check_index_cond(info, inx, buf);
+            if (res == ICP_MATCH)
+              break;
+            if (res == ICP_OUT_OF_RANGE)
+              my_errno= HA_ERR_KEY_NOT_FOUND;
+            if (res != ICP_NO_MATCH)
+              break;
+          }
+          if (_mi_search_next(info, keyinfo, info->lastkey,
+                              info->lastkey_length,
+                              myisam_readnext_vec[search_flag],
+                              info->s->state.key_root[inx]))
+            break;
+          if (search_flag == HA_READ_KEY_EXACT &&
+              ha_key_cmp(keyinfo->seg, key_buff, info->lastkey,
+                         use_key_length, SEARCH_FIND, not_used))
+          {
+            my_errno= HA_ERR_KEY_NOT_FOUND;
+            info->lastpos= HA_OFFSET_ERROR;
+            break;
+          }
+        }
+      }
     }
   }
   if (share->concurrent_insert)
@@ -30,6 +30,7 @@ int mi_rnext_same(MI_INFO *info, uchar *buf)
   int error;
   uint inx,not_used[2];
   MI_KEYDEF *keyinfo;
+  enum icp_result res= ICP_MATCH;
   DBUG_ENTER("mi_rnext_same");
 
   if ((int) (inx=info->lastinx) < 0 || info->lastpos == HA_OFFSET_ERROR)
@@ -76,10 +77,17 @@ int mi_rnext_same(MI_INFO *info, uchar *buf)
           info->lastpos= HA_OFFSET_ERROR;
           break;
         }
-        /* Skip rows that are inserted by other threads since we got a lock */
-        if (info->lastpos < info->state->data_file_length)
+        /*
+          Skip rows that are inserted by other threads since we got a lock,
+          and rows that do not match the pushed index condition
+        */
+        if (info->lastpos < info->state->data_file_length &&
+            (!info->index_cond_func || !buf ||
+             (res= mi_check_index_cond(info, inx, buf)) != ICP_NO_MATCH))
           break;
       }
+      if (!error && res != ICP_MATCH)
+        error= 1;                       /* my_errno is already set */
   }
   if (info->s->concurrent_insert)
     mysql_rwlock_unlock(&info->s->key_root_lock[inx]);
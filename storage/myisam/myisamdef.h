@@ -250,6 +250,8 @@ struct st_myisam_info {
   uint32 int_keytree_version;		/*  -""-  */
   int (*read_record)(struct st_myisam_info*, my_off_t, uchar*);
   invalidator_by_filename invalidator;  /* query cache invalidator */
+  index_cond_func_t index_cond_func;    /* Index condition function */
+  void *index_cond_func_arg;            /* parameter for the func */
   ulong this_unique;			/* uniq filenumber or thread */
   ulong last_unique;			/* last unique number */
   ulong this_loop;			/* counter for this open */
@@ -596,6 +598,9 @@ extern uint _mi_pack_key(register MI_INFO *info, uint keynr, uchar *key,
                          uchar *old, key_part_map keypart_map,
                          HA_KEYSEG **last_used_keyseg);
 extern int _mi_read_key_record(MI_INFO *info,my_off_t filepos,uchar *buf);
+extern int _mi_put_key_in_record(MI_INFO *info, uint keynr, uchar *record);
+extern enum icp_result mi_check_index_cond(MI_INFO *info, uint keynr,
+                                           uchar *record);
 extern int _mi_read_cache(IO_CACHE *info,uchar *buff,my_off_t pos,
 			  uint length,int re_read_if_possibly);
 extern ulonglong retrieve_auto_increment(MI_INFO *info,const uchar *record);
@@ -0,0 +1,126 @@
+/* Copyright (c) 2026, Oracle and/or its affiliates. All rights reserved.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Checks the InnoDB CRC32C implementations against known values, and
+   reports how many 16k pages per second each of the page checksum
+   algorithms (innodb_checksum_algorithm) can process.
+*/
+
+#include "univ.i"
+#include "ut0crc32.h"
+#include "ut0rnd.h"
+
+#include <my_sys.h>
+#include <tap.h>
+
+/** Number of pages checksummed by each benchmark */
+#define BENCH_PAGES	20000
+
+static byte	page[UNIV_PAGE_SIZE];
+
+/** The innodb algorithm, as in buf_calc_page_new_checksum() */
+static ulint
+innodb_checksum(const byte* buf, ulint len)
+{
+  const byte*	end= buf + len;
+  ulint		fold= 0;
+
+  while (buf < end)
+    fold= ut_fold_ulint_pair(fold, (ulint) *buf++);
+
+  return(fold & 0xFFFFFFFFUL);
+}
+
+static ulint
+crc32_checksum(const byte* buf, ulint len)
+{
+  return(ut_crc32(buf, len));
+}
+
+static ulint
+crc32_sw_checksum(const byte* buf, ulint len)
+{
+  return(ut_crc32_slice8(buf, len));
+}
+
+static ulint
+none_checksum(const byte* buf __attribute__((unused)),
+              ulint len __attribute__((unused)))
+{
+  return(0xDEADBEEFUL);
+}
+
+static void
+bench(const char* name, ulint (*checksum)(const byte*, ulint))
+{
+  ulonglong	start, usecs;
+  ulint		sum= 0;
+  ulint		i;
+
+  start= my_micro_time();
+  for (i= 0; i < BENCH_PAGES; i++)
+  {
+    page[0]= (byte) i;
+    sum+= checksum(page, UNIV_PAGE_SIZE);
+  }
+  usecs= my_micro_time() - start;
+  if (usecs == 0)
+    usecs= 1;
+
+  diag("%-10s %10lu pages/s (%lx)", name,
+       (ulong) (BENCH_PAGES * 1000000ULL / usecs), (ulong) sum);
+}
+
+int main(int argc __attribute__((unused)), char **argv)
+{
+  static const char	check[]= "123456789";
+  ulint			i;
+  ibool			same= TRUE;
+
+  MY_INIT(argv[0]);
+  plan(4);
+
+  ut_crc32_init();
+
+  ok(ut_crc32((const byte*) check, 9) == 0xE3069283UL,
+     "ut_crc32 check value");
+  ok(ut_crc32_slice8((const byte*) check, 9) == 0xE3069283UL,
+     "ut_crc32_slice8 check value");
+
+  for (i= 0; i < sizeof page; i++)
+    page[i]= (byte) rand();
+
+  /* Unaligned starts and odd lengths, as used for page checksums */
+  for (i= 0; i < 64; i++)
+  {
+    if (ut_crc32(page + i, sizeof page - 2 * i)
+        != ut_crc32_slice8(page + i, sizeof page - 2 * i))
+      same= FALSE;
+  }
+  ok(same, "ut_crc32 and ut_crc32_slice8 agree");
+  ok(ut_crc32(page, 0) == 0, "empty buffer");
+
+  diag("ut_crc32 uses %s",
+       ut_crc32_sse42_enabled ? "the SSE4.2 crc32 instruction"
+                              : "slicing-by-8");
+  bench("innodb", innodb_checksum);
+  bench("crc32 sw", crc32_sw_checksum);
+  if (ut_crc32_sse42_enabled)
+    bench("crc32 hw", crc32_checksum);
+  bench("none", none_checksum);
+
+  my_end(0);
+  return exit_status();
+}